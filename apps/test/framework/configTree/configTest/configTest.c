@@ -316,6 +316,128 @@ static void DeleteTest()
 
 
 
+static void ReadVersionTest()
+{
+    LE_INFO("---- Read Version Test -------------------------------------------------------------");
+
+    static char pathBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    snprintf(pathBuffer, LE_CFG_STR_LEN_BYTES, "%s/readVersionTest/", TestRootDir);
+
+    static char valuePathBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    snprintf(valuePathBuffer, LE_CFG_STR_LEN_BYTES, "%s/readVersionTest/valueA", TestRootDir);
+
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn(pathBuffer);
+
+    le_cfg_SetString(iterRef, "valueA", "oldValue");
+    le_cfg_SetString(iterRef, "valueB", "oldValue");
+
+    le_cfg_CommitTxn(iterRef);
+
+    // Commits made while a read transaction is open don't wait for it, and don't change what it
+    // reads.
+    le_cfg_IteratorRef_t readIterRef = le_cfg_CreateReadTxn(pathBuffer);
+
+    iterRef = le_cfg_CreateWriteTxn(pathBuffer);
+
+    le_cfg_SetString(iterRef, "valueA", "newValue");
+    le_cfg_DeleteNode(iterRef, "valueB");
+    le_cfg_SetString(iterRef, "valueC", "newValue");
+
+    le_cfg_CommitTxn(iterRef);
+
+    TestValue(readIterRef, "valueA", "oldValue");
+    TestValue(readIterRef, "valueB", "oldValue");
+    LE_TEST(le_cfg_NodeExists(readIterRef, "valueC") == false);
+
+    le_cfg_QuickSetString(valuePathBuffer, "quickValue");
+
+    TestValue(readIterRef, "valueA", "oldValue");
+    LE_TEST(le_cfg_GoToFirstChild(readIterRef) == LE_OK);
+    TestValue(readIterRef, "", "oldValue");
+    LE_TEST(le_cfg_GoToNextSibling(readIterRef) == LE_OK);
+    TestValue(readIterRef, "", "oldValue");
+    LE_TEST(le_cfg_GoToNextSibling(readIterRef) == LE_NOT_FOUND);
+
+    // New read transactions see the committed changes.
+    iterRef = le_cfg_CreateReadTxn(pathBuffer);
+
+    TestValue(iterRef, "valueA", "quickValue");
+    LE_TEST(le_cfg_NodeExists(iterRef, "valueB") == false);
+    TestValue(iterRef, "valueC", "newValue");
+
+    le_cfg_CancelTxn(iterRef);
+    le_cfg_CancelTxn(readIterRef);
+}
+
+
+
+
+// Path of the value written by the quick set threads of QuickSetOrderTest().
+static char QuickSetPath[LE_CFG_STR_LEN_BYTES] = "";
+
+
+static void* QuickSetThread
+(
+    void* contextPtr
+)
+{
+    le_cfg_ConnectService();
+    le_cfg_QuickSetInt(QuickSetPath, (int32_t)(intptr_t)contextPtr);
+    le_cfg_DisconnectService();
+
+    return NULL;
+}
+
+
+static le_thread_Ref_t StartQuickSet
+(
+    int32_t value
+)
+{
+    le_thread_Ref_t threadRef = le_thread_Create("QuickSet",
+                                                 QuickSetThread,
+                                                 (void*)(intptr_t)value);
+
+    le_thread_SetJoinable(threadRef);
+    le_thread_Start(threadRef);
+
+    return threadRef;
+}
+
+
+
+
+static void QuickSetOrderTest()
+{
+    LE_INFO("---- Quick Set Order Test ----------------------------------------------------------");
+
+    static char pathBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    snprintf(pathBuffer, LE_CFG_STR_LEN_BYTES, "%s/quickSetOrderTest/", TestRootDir);
+    snprintf(QuickSetPath, LE_CFG_STR_LEN_BYTES, "%s/quickSetOrderTest/value", TestRootDir);
+
+    // Hold the tree with a write transaction so that the first quick set has to wait for it.  If a
+    // group commit window is configured, it closes while the first write waits, so the second
+    // write is queued in the next window.  The second write must still win.
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn(pathBuffer);
+
+    le_thread_Ref_t firstRef = StartQuickSet(1);
+    usleep(300000);
+
+    le_thread_Ref_t secondRef = StartQuickSet(2);
+    usleep(50000);
+
+    le_cfg_SetString(iterRef, "valueA", "txnValue");
+    le_cfg_CommitTxn(iterRef);
+
+    le_thread_Join(firstRef, NULL);
+    le_thread_Join(secondRef, NULL);
+
+    LE_TEST(le_cfg_QuickGetInt(QuickSetPath, 0) == 2);
+}
+
+
+
+
 static void StringSizeTest()
 {
     le_result_t result;
@@ -558,6 +680,97 @@ static void TestImportExport()
 
 
 
+static void TestImportExportSnapshot()
+{
+    LE_INFO("---- Import Export Snapshot Function Test ------------------------------------------");
+
+    static const char testData[] =
+        {
+            "{ "
+                "\"aBoolValue\" !t "
+                "\"aStringValue\" \"Something \\\"wicked\\\" this way comes!\" "
+                "\"anEmptyValue\" ~ "
+                "\"anIntVal\" [1024] "
+                "\"aFloatVal\" (10.24) "
+                "\"nestedValues\" "
+                "{ "
+                    "\"aBoolValue\" !f "
+                    "\"aStringValue\" \"Something \\\"wicked\\\" this way comes!\" "
+                    "\"moreNestedValues\" "
+                    "{ "
+                        "\"anIntVal\" [-1] "
+                    "} "
+                    "\"anIntVal\" [1024] "
+                "} "
+            "} "
+        };
+
+    static char pathBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    snprintf(pathBuffer, LE_CFG_STR_LEN_BYTES, "/%s/importExportSnapshot", TestRootDir);
+
+    static char copyPathBuffer[LE_CFG_STR_LEN_BYTES] = "";
+    snprintf(copyPathBuffer, LE_CFG_STR_LEN_BYTES, "/%s/importExportSnapshotCopy", TestRootDir);
+
+    char nameTemplate[NAMETEMPLATESIZE] = "";
+    sprintf(nameTemplate, "./%s_testSnapshotData.cfg", TestRootDir);
+
+    char filePath[PATH_MAX] = "";
+    realpath(nameTemplate, filePath);
+
+    sprintf(nameTemplate, "./%s_testSnapshot.snap", TestRootDir);
+
+    char snapshotPath[PATH_MAX] = "";
+    realpath(nameTemplate, snapshotPath);
+
+    WriteConfigData(filePath, testData);
+
+    // Convert the text to a snapshot, then the snapshot back to text.
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn("");
+
+    LE_TEST(le_cfgAdmin_ImportTree(iterRef, filePath, pathBuffer) == LE_OK);
+    LE_TEST(le_cfgAdmin_ExportTreeSnapshot(iterRef, snapshotPath, pathBuffer) == LE_OK);
+    LE_TEST(le_cfgAdmin_ImportTree(iterRef, snapshotPath, copyPathBuffer) == LE_OK);
+    LE_TEST(le_cfgAdmin_ExportTree(iterRef, filePath, copyPathBuffer) == LE_OK);
+
+    le_cfg_CommitTxn(iterRef);
+
+    CompareFile(filePath, testData);
+
+    // Same again, but from the committed tree.
+    iterRef = le_cfg_CreateReadTxn("");
+
+    LE_TEST(le_cfgAdmin_ExportTreeSnapshot(iterRef, snapshotPath, copyPathBuffer) == LE_OK);
+
+    le_cfg_CancelTxn(iterRef);
+
+    iterRef = le_cfg_CreateWriteTxn("");
+
+    LE_TEST(le_cfgAdmin_ImportTree(iterRef, snapshotPath, copyPathBuffer) == LE_OK);
+    LE_TEST(le_cfgAdmin_ExportTree(iterRef, filePath, copyPathBuffer) == LE_OK);
+
+    le_cfg_CommitTxn(iterRef);
+
+    CompareFile(filePath, testData);
+
+    // A truncated snapshot must be refused, and leave the tree as it was.
+    LE_TEST(truncate(snapshotPath, 64) == 0);
+
+    iterRef = le_cfg_CreateWriteTxn("");
+
+    LE_TEST(le_cfgAdmin_ImportTree(iterRef, snapshotPath, copyPathBuffer) == LE_FORMAT_ERROR);
+
+    le_cfg_CancelTxn(iterRef);
+
+    snprintf(pathBuffer, LE_CFG_STR_LEN_BYTES, "%s/nestedValues/moreNestedValues/anIntVal",
+             copyPathBuffer);
+    LE_TEST(le_cfg_QuickGetInt(pathBuffer, 0) == -1);
+
+    unlink(filePath);
+    unlink(snapshotPath);
+}
+
+
+
 static void TestImportLargeString()
 {
     LE_INFO("---- Import Large String Test ---------------------------------------------------");
@@ -985,8 +1198,11 @@ COMPONENT_INIT
     QuickFunctionTest();
     TestImportLargeString();
     DeleteTest();
+    ReadVersionTest();
+    QuickSetOrderTest();
     StringSizeTest();
     TestImportExport();
+    TestImportExportSnapshot();
     MultiTreeTest();
     ExistAndEmptyTest();
     ListTreeTest();
@@ -21,6 +21,8 @@ size_t le_hashmap_HashCustom(const void* keyPtr);
 bool le_hashmap_EqualsCustom(const void* firstPtr, const void* secondPtr);
 bool itHandler(const void* keyPtr, const void* valuePtr, void* contextPtr);
 void TestIterRemove(le_hashmap_Ref_t map);
+void TestCompactMap(void);
+void TestResize(void);
 
 typedef struct Key Key_t;
 struct Key {
@@ -66,6 +68,23 @@ COMPONENT_INIT
     TestLongIntHashMap(map6);
     TestNewIter();
     TestIterRemove(map1);
+    TestResize();
+
+    LE_INFO("***  Creating compact hash maps required for tests. ***");
+    le_hashmap_Ref_t cmap1 = le_hashmap_CreateCompact("CMap1", 200, &le_hashmap_HashUInt32, &le_hashmap_EqualsUInt32);
+    le_hashmap_Ref_t cmap2 = le_hashmap_CreateCompact("CMap2", 10, &le_hashmap_HashString, &le_hashmap_EqualsString);
+    le_hashmap_Ref_t cmap3 = le_hashmap_CreateCompact("CMap3", 200, &le_hashmap_HashCustom, &le_hashmap_EqualsCustom);
+    le_hashmap_Ref_t cmap4 = le_hashmap_CreateCompact("CMap4", 1, &le_hashmap_HashUInt32, &le_hashmap_EqualsUInt32);
+    le_hashmap_Ref_t cmap5 = le_hashmap_CreateCompact("CMap5", 0, &le_hashmap_HashVoidPointer, &le_hashmap_EqualsVoidPointer);
+
+    LE_TEST(cmap1 && cmap2 && cmap3 && cmap4 && cmap5);
+
+    TestStringHashMap(cmap2);
+    TestCustomHashMap(cmap3);
+    TestTinyMap(cmap4);
+    TestPointerMap(cmap5);
+    TestIterRemove(cmap1);
+    TestCompactMap();
 
     LE_INFO("==== Hashmap Tests PASSED ====\n");
 
@@ -135,7 +154,7 @@ void TestIntHashMap(le_hashmap_Ref_t map)
         le_hashmap_GetValue(mapIt);
     }
     LE_INFO("Iterator count = %d", itercnt);
-    LE_TEST(itercnt == -1);
+    LE_TEST(itercnt == 0);
 
     // Cleanup the map again to allow it to be reused
     le_hashmap_RemoveAll(map);
@@ -528,3 +547,213 @@ void TestLongIntHashMap(le_hashmap_Ref_t map)
     mapIt = le_hashmap_GetIterator(map);
     LE_TEST(le_hashmap_NextNode(mapIt) == LE_NOT_FOUND);
 }
+
+void TestCompactMap(void)
+{
+    static uint32_t iKeys[1000];
+    static uint32_t iVals[1000];
+    uint32_t* keyPtr;
+    uint32_t* valuePtr;
+    uint32_t lastKey;
+    int itercnt = 0;
+    int j = 0;
+
+    LE_INFO("*** Running compact hashmap tests ***");
+
+    // Start small so that the map has to grow several times.
+    le_hashmap_Ref_t map = le_hashmap_CreateCompact("CMap6", 4, &le_hashmap_HashUInt32,
+                                                    &le_hashmap_EqualsUInt32);
+
+    for (j=0; j<1000; j++) {
+        iKeys[j] = j * 2;
+        iVals[j] = j * 4;
+        LE_ASSERT(le_hashmap_Put(map, &iKeys[j], &iVals[j]) == NULL);
+    }
+    LE_TEST(le_hashmap_Size(map) == 1000);
+
+    bool allFound = true;
+    for (j=0; j<1000; j++) {
+        uint32_t key = j * 2;
+        if ((le_hashmap_Get(map, &key) != &iVals[j]) ||
+            (le_hashmap_GetStoredKey(map, &key) != &iKeys[j]))
+        {
+            allFound = false;
+        }
+    }
+    LE_TEST(allFound);
+
+    // Replacing a value returns the old one and doesn't add an entry.
+    LE_TEST((le_hashmap_Put(map, &iKeys[10], &iVals[11]) == &iVals[10]) &&
+            (le_hashmap_Size(map) == 1000));
+    le_hashmap_Put(map, &iKeys[10], &iVals[10]);
+
+    for (j=0; j<1000; j+=2) {
+        LE_ASSERT(le_hashmap_Remove(map, &iKeys[j]) == &iVals[j]);
+    }
+    LE_TEST(le_hashmap_Size(map) == 500);
+    LE_TEST(!le_hashmap_ContainsKey(map, &iKeys[0]) && le_hashmap_ContainsKey(map, &iKeys[1]));
+    LE_TEST(le_hashmap_Remove(map, &iKeys[0]) == NULL);
+    LE_INFO("Collision count = %zu", le_hashmap_CountCollisions(map));
+
+    // Iteration visits the entries in insertion order, both ways.
+    bool inOrder = true;
+    lastKey = 0;
+    le_hashmap_It_Ref_t mapIt = le_hashmap_GetIterator(map);
+    LE_TEST(le_hashmap_GetKey(mapIt) == NULL);
+    while (le_hashmap_NextNode(mapIt) == LE_OK)
+    {
+        keyPtr = (uint32_t*)le_hashmap_GetKey(mapIt);
+        if ((itercnt > 0) && (*keyPtr <= lastKey))
+        {
+            inOrder = false;
+        }
+        lastKey = *keyPtr;
+        itercnt++;
+    }
+    LE_TEST(itercnt == 500 && inOrder);
+    while (le_hashmap_PrevNode(mapIt) == LE_OK)
+    {
+        keyPtr = (uint32_t*)le_hashmap_GetKey(mapIt);
+        if (*keyPtr > lastKey)
+        {
+            inOrder = false;
+        }
+        lastKey = *keyPtr;
+        itercnt--;
+    }
+    LE_TEST(itercnt == 0 && inOrder);
+
+    // Remove entries and add new ones while iterating over a full map.  The first new entry makes
+    // the map compact its entry array and the following ones make it grow, which must not disturb
+    // the iteration.
+    le_hashmap_Ref_t smallMap = le_hashmap_CreateCompact("CMap7", 6, &le_hashmap_HashUInt32,
+                                                         &le_hashmap_EqualsUInt32);
+    for (j=0; j<6; j++) {
+        le_hashmap_Put(smallMap, &iKeys[j], &iVals[j]);
+    }
+    uint32_t visited[32];
+    itercnt = 0;
+    mapIt = le_hashmap_GetIterator(smallMap);
+    while ((le_hashmap_NextNode(mapIt) == LE_OK) && (itercnt < 32))
+    {
+        keyPtr = (uint32_t*)le_hashmap_GetKey(mapIt);
+        LE_ASSERT(keyPtr != NULL);
+        visited[itercnt++] = *keyPtr;
+        if (keyPtr == &iKeys[0])
+        {
+            le_hashmap_Remove(smallMap, &iKeys[1]);
+            le_hashmap_Remove(smallMap, keyPtr);
+            LE_ASSERT(le_hashmap_GetKey(mapIt) == NULL);
+            le_hashmap_Put(smallMap, &iKeys[6], &iVals[6]);
+        }
+        else if (keyPtr == &iKeys[6])
+        {
+            for (j=7; j<20; j++) {
+                le_hashmap_Put(smallMap, &iKeys[j], &iVals[j]);
+            }
+        }
+    }
+    bool sequenceOk = (itercnt == 19) && (visited[0] == iKeys[0]);
+    for (j=1; j<itercnt; j++) {
+        if (visited[j] != iKeys[j + 1]) {
+            sequenceOk = false;
+        }
+    }
+    LE_INFO("Iterator count = %d", itercnt);
+    LE_TEST(sequenceOk && (le_hashmap_Size(smallMap) == 18));
+
+    // Walk the map with the node functions.
+    itercnt = 1;
+    LE_TEST(le_hashmap_GetFirstNode(map, (void**)&keyPtr, (void**)&valuePtr) == LE_OK);
+    while (le_hashmap_GetNodeAfter(map, keyPtr, (void**)&keyPtr, (void**)&valuePtr) == LE_OK)
+    {
+        LE_ASSERT(*valuePtr == (*keyPtr * 2));
+        itercnt++;
+    }
+    LE_TEST(itercnt == 500);
+
+    le_hashmap_RemoveAll(map);
+    LE_TEST(le_hashmap_isEmpty(map));
+    mapIt = le_hashmap_GetIterator(map);
+    LE_TEST(le_hashmap_NextNode(mapIt) == LE_NOT_FOUND);
+}
+
+void TestResize(void)
+{
+    static uint32_t iKeys[10000];
+    static uint32_t iVals[10000];
+    uint32_t* keyPtr;
+    int itercnt = 0;
+    int j = 0;
+
+    LE_INFO("*** Running hashmap resize tests ***");
+
+    // Start small so that the map has to grow several times.
+    le_hashmap_Ref_t map = le_hashmap_Create("Map7", 4, &le_hashmap_HashUInt32,
+                                             &le_hashmap_EqualsUInt32);
+
+    // Every entry must stay reachable while the buckets are being moved.
+    bool allFound = true;
+    for (j=0; j<10000; j++) {
+        iKeys[j] = j * 2;
+        iVals[j] = j * 4;
+        LE_ASSERT(le_hashmap_Put(map, &iKeys[j], &iVals[j]) == NULL);
+        if ((le_hashmap_Get(map, &iKeys[j / 2]) != &iVals[j / 2]) ||
+            (le_hashmap_Get(map, &iKeys[j]) != &iVals[j]))
+        {
+            allFound = false;
+        }
+    }
+    LE_TEST(allFound && (le_hashmap_Size(map) == 10000));
+    LE_INFO("Collision count = %zu", le_hashmap_CountCollisions(map));
+    LE_TEST(le_hashmap_CountCollisions(map) < 10000 / 2);
+
+    // Adding entries while iterating makes the map grow again, which must not disturb the
+    // iteration: every entry is visited once, in insertion order.
+    le_hashmap_RemoveAll(map);
+    for (j=0; j<100; j++) {
+        le_hashmap_Put(map, &iKeys[j], &iVals[j]);
+    }
+    bool inOrder = true;
+    le_hashmap_It_Ref_t mapIt = le_hashmap_GetIterator(map);
+    while (le_hashmap_NextNode(mapIt) == LE_OK)
+    {
+        keyPtr = (uint32_t*)le_hashmap_GetKey(mapIt);
+        if (keyPtr != &iKeys[itercnt])
+        {
+            inOrder = false;
+        }
+        if (itercnt == 50)
+        {
+            for (j=100; j<5000; j++) {
+                le_hashmap_Put(map, &iKeys[j], &iVals[j]);
+            }
+        }
+        itercnt++;
+    }
+    LE_INFO("Iterator count = %d", itercnt);
+    LE_TEST(inOrder && (itercnt == 5000));
+
+    // Removing entries shrinks the map back.  All remaining ones must stay reachable.
+    for (j=0; j<5000; j++) {
+        if (j % 100 != 0) {
+            LE_ASSERT(le_hashmap_Remove(map, &iKeys[j]) == &iVals[j]);
+        }
+    }
+    allFound = (le_hashmap_Size(map) == 50);
+    for (j=0; j<5000; j++) {
+        if (le_hashmap_ContainsKey(map, &iKeys[j]) != (j % 100 == 0)) {
+            allFound = false;
+        }
+    }
+    LE_TEST(allFound);
+
+    itercnt = 1;
+    LE_TEST(le_hashmap_GetFirstNode(map, (void**)&keyPtr, NULL) == LE_OK && keyPtr == &iKeys[0]);
+    while (le_hashmap_GetNodeAfter(map, keyPtr, (void**)&keyPtr, NULL) == LE_OK)
+    {
+        LE_ASSERT(keyPtr == &iKeys[itercnt * 100]);
+        itercnt++;
+    }
+    LE_TEST(itercnt == 50);
+}
@@ -120,6 +120,428 @@ static void TestString(void)
     CheckString("", 512, 12, true); // Empty
 }
 
+/** Simple arrays **/
+
+static void CheckSimpleArray
+(
+    size_t arrayCount,          ///< Number of elements to pack
+    size_t arrayMaxCount,       ///< Max number of elements
+    bool expectedRes            ///< Expected result
+)
+{
+    int32_t array[BUFFER_SZ / sizeof(int32_t)];
+    uint8_t elementBuffer[BUFFER_SZ];
+    uint8_t simpleBuffer[BUFFER_SZ];
+    uint8_t* elementPtr = elementBuffer;
+    uint8_t* simplePtr = simpleBuffer;
+    size_t elementSz = sizeof(elementBuffer);
+    size_t simpleSz = sizeof(simpleBuffer);
+    bool elementRes;
+    bool simpleRes;
+    size_t i;
+
+    printf("int32[%zd] max[%zd]:\n", arrayCount, arrayMaxCount);
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(array); i++)
+    {
+        array[i] = (int32_t)(i * 0x01010101) - 7;
+    }
+
+    ResetBuffer(elementBuffer, sizeof(elementBuffer));
+    ResetBuffer(simpleBuffer, sizeof(simpleBuffer));
+
+    // Pack both ways
+    LE_PACK_PACKARRAY(&elementPtr, &elementSz, array, arrayCount, arrayMaxCount,
+                      le_pack_PackInt32, &elementRes);
+    LE_PACK_PACKSIMPLEARRAY(&simplePtr, &simpleSz, array, arrayCount, arrayMaxCount,
+                            &simpleRes);
+
+    LE_TEST(expectedRes == elementRes);
+    LE_TEST(expectedRes == simpleRes);
+    if(!expectedRes)
+    {
+        printf("   [passed]\n");
+        return;
+    }
+
+    // Both must give the same result
+    LE_TEST(simplePtr - simpleBuffer == elementPtr - elementBuffer);
+    LE_TEST(simpleSz == elementSz);
+    LE_TEST(0 == memcmp(simpleBuffer, elementBuffer, sizeof(simpleBuffer)));
+
+    // Unpack
+    int32_t valueOut[BUFFER_SZ / sizeof(int32_t)];
+    size_t countOut = 0;
+    simplePtr = simpleBuffer;
+    simpleSz = sizeof(simpleBuffer);
+    LE_PACK_UNPACKSIMPLEARRAY(&simplePtr, &simpleSz, valueOut, &countOut, arrayMaxCount,
+                              &simpleRes);
+
+    LE_TEST(simpleRes);
+    LE_TEST(countOut == arrayCount);
+    LE_TEST(0 == memcmp(array, valueOut, arrayCount * sizeof(array[0])));
+    LE_TEST(simpleSz == elementSz);
+
+    printf("   [passed]\n");
+}
+
+static void TestSimpleArray(void)
+{
+    printf("=> simple array\n");
+
+    CheckSimpleArray(0, 10, true);  // Empty
+    CheckSimpleArray(5, 10, true);
+    CheckSimpleArray(10, 10, true);
+    CheckSimpleArray(11, 10, false);
+    CheckSimpleArray(10, 300, false); // Buffer too short for max count
+}
+
+/** Block **/
+
+typedef struct
+{
+    uint32_t a;
+    int16_t b;
+    uint8_t c;
+    char d;
+    double e;
+}
+SimpleStruct_t;
+
+static void TestBlock(void)
+{
+    SimpleStruct_t value = { 0x12345678, -2, 0xAB, 'x', 1.5 };
+    uint8_t memberBuffer[BUFFER_SZ];
+    uint8_t blockBuffer[BUFFER_SZ];
+    uint8_t* memberPtr = memberBuffer;
+    uint8_t* blockPtr = blockBuffer;
+    size_t memberSz = sizeof(memberBuffer);
+    size_t blockSz = sizeof(blockBuffer);
+
+    printf("=> block\n");
+
+    ResetBuffer(memberBuffer, sizeof(memberBuffer));
+    ResetBuffer(blockBuffer, sizeof(blockBuffer));
+
+    // A structure without padding is packed the same way member by member and as a block.
+    LE_TEST(sizeof(value) == 16);
+    LE_TEST(le_pack_PackUint32(&memberPtr, &memberSz, value.a));
+    LE_TEST(le_pack_PackInt16(&memberPtr, &memberSz, value.b));
+    LE_TEST(le_pack_PackUint8(&memberPtr, &memberSz, value.c));
+    LE_TEST(le_pack_PackChar(&memberPtr, &memberSz, value.d));
+    LE_TEST(le_pack_PackDouble(&memberPtr, &memberSz, value.e));
+    LE_TEST(le_pack_PackBlock(&blockPtr, &blockSz, &value, sizeof(value)));
+
+    LE_TEST(blockSz == memberSz);
+    LE_TEST(0 == memcmp(memberBuffer, blockBuffer, sizeof(blockBuffer)));
+
+    SimpleStruct_t valueOut;
+    blockPtr = blockBuffer;
+    blockSz = sizeof(blockBuffer);
+    LE_TEST(le_pack_UnpackBlock(&blockPtr, &blockSz, &valueOut, sizeof(valueOut)));
+    LE_TEST(0 == memcmp(&value, &valueOut, sizeof(value)));
+
+    // Not enough space
+    blockPtr = blockBuffer;
+    blockSz = sizeof(value) - 1;
+    LE_TEST(!le_pack_PackBlock(&blockPtr, &blockSz, &value, sizeof(value)));
+    LE_TEST(!le_pack_UnpackBlock(&blockPtr, &blockSz, &valueOut, sizeof(valueOut)));
+    LE_TEST(blockPtr == blockBuffer);
+}
+
+/** Compact integers **/
+
+static void CheckVarUint
+(
+    uint64_t value,             ///< Value to pack
+    size_t expectedSize         ///< Expected number of bytes packed
+)
+{
+    uint8_t buffer[BUFFER_SZ];
+    uint8_t* bufferPtr = buffer;
+    size_t bufferSz = sizeof(buffer);
+    uint64_t valueOut = 0;
+
+    printf("varuint %" PRIu64 ":\n", value);
+
+    ResetBuffer(buffer, sizeof(buffer));
+
+    LE_TEST(le_pack_PackVarUint(&bufferPtr, &bufferSz, value));
+    LE_TEST(bufferPtr - buffer == (ssize_t)expectedSize);
+    LE_TEST(bufferSz == sizeof(buffer) - expectedSize);
+    LE_TEST(bufferPtr[0] == CHECK_CHAR);
+
+    // One byte short
+    bufferPtr = buffer;
+    bufferSz = expectedSize - 1;
+    LE_TEST(!le_pack_PackVarUint(&bufferPtr, &bufferSz, value));
+    LE_TEST(!le_pack_UnpackVarUint(&bufferPtr, &bufferSz, UINT64_MAX, &valueOut));
+    LE_TEST(bufferPtr == buffer);
+    LE_TEST(bufferSz == expectedSize - 1);
+
+    bufferPtr = buffer;
+    bufferSz = sizeof(buffer);
+    LE_TEST(le_pack_UnpackVarUint(&bufferPtr, &bufferSz, UINT64_MAX, &valueOut));
+    LE_TEST(valueOut == value);
+    LE_TEST(bufferPtr - buffer == (ssize_t)expectedSize);
+
+    // Above the maximum value
+    if (value > 0)
+    {
+        bufferPtr = buffer;
+        bufferSz = sizeof(buffer);
+        LE_TEST(!le_pack_UnpackVarUint(&bufferPtr, &bufferSz, value - 1, &valueOut));
+        LE_TEST(bufferPtr == buffer);
+    }
+}
+
+static void CheckVarInt
+(
+    int64_t value,              ///< Value to pack
+    size_t expectedSize         ///< Expected number of bytes packed
+)
+{
+    uint8_t buffer[BUFFER_SZ];
+    uint8_t* bufferPtr = buffer;
+    size_t bufferSz = sizeof(buffer);
+    int64_t valueOut = 0;
+
+    printf("varint %" PRId64 ":\n", value);
+
+    LE_TEST(le_pack_PackVarInt(&bufferPtr, &bufferSz, value));
+    LE_TEST(bufferPtr - buffer == (ssize_t)expectedSize);
+
+    bufferPtr = buffer;
+    bufferSz = sizeof(buffer);
+    LE_TEST(le_pack_UnpackVarInt(&bufferPtr, &bufferSz, 64, &valueOut));
+    LE_TEST(valueOut == value);
+}
+
+static void TestCompactInteger(void)
+{
+    uint8_t buffer[BUFFER_SZ];
+    uint8_t* bufferPtr = buffer;
+    size_t bufferSz = sizeof(buffer);
+
+    printf("=> compact integer\n");
+
+    CheckVarUint(0, 1);
+    CheckVarUint(0x7F, 1);
+    CheckVarUint(0x80, 2);
+    CheckVarUint(0x3FFF, 2);
+    CheckVarUint(0x4000, 3);
+    CheckVarUint(UINT32_MAX, 5);
+    CheckVarUint(UINT64_MAX, LE_PACK_VARINT_MAX_BYTES);
+
+    // Small negative values stay short
+    CheckVarInt(0, 1);
+    CheckVarInt(-1, 1);
+    CheckVarInt(63, 1);
+    CheckVarInt(-64, 1);
+    CheckVarInt(64, 2);
+    CheckVarInt(INT64_MAX, LE_PACK_VARINT_MAX_BYTES);
+    CheckVarInt(INT64_MIN, LE_PACK_VARINT_MAX_BYTES);
+
+    // Typed values must fit their type
+    int16_t int16Out = 0;
+    uint16_t uint16Out = 0;
+    int32_t int32Out = 0;
+    uint32_t uint32Out = 0;
+    LE_TEST(le_pack_PackCompactInt32(&bufferPtr, &bufferSz, INT16_MIN));
+    LE_TEST(le_pack_PackCompactInt32(&bufferPtr, &bufferSz, INT16_MAX + 1));
+    LE_TEST(le_pack_PackCompactUint32(&bufferPtr, &bufferSz, UINT16_MAX + 1));
+    LE_TEST(le_pack_PackCompactInt32(&bufferPtr, &bufferSz, INT32_MIN));
+    bufferPtr = buffer;
+    bufferSz = sizeof(buffer);
+    LE_TEST(le_pack_UnpackCompactInt16(&bufferPtr, &bufferSz, &int16Out));
+    LE_TEST(int16Out == INT16_MIN);
+    LE_TEST(!le_pack_UnpackCompactInt16(&bufferPtr, &bufferSz, &int16Out));
+    LE_TEST(le_pack_UnpackCompactInt32(&bufferPtr, &bufferSz, &int32Out));
+    LE_TEST(int32Out == INT16_MAX + 1);
+    LE_TEST(!le_pack_UnpackCompactUint16(&bufferPtr, &bufferSz, &uint16Out));
+    LE_TEST(le_pack_UnpackCompactUint32(&bufferPtr, &bufferSz, &uint32Out));
+    LE_TEST(uint32Out == UINT16_MAX + 1);
+    LE_TEST(le_pack_UnpackCompactInt32(&bufferPtr, &bufferSz, &int32Out));
+    LE_TEST(int32Out == INT32_MIN);
+
+    // Malformed varints: no last byte, or a last byte with more than the top bit of 64 bits
+    uint64_t valueOut;
+    memset(buffer, 0xFF, LE_PACK_VARINT_MAX_BYTES + 1);
+    bufferPtr = buffer;
+    bufferSz = LE_PACK_VARINT_MAX_BYTES + 1;
+    LE_TEST(!le_pack_UnpackVarUint(&bufferPtr, &bufferSz, UINT64_MAX, &valueOut));
+    buffer[LE_PACK_VARINT_MAX_BYTES - 1] = 0x02;
+    LE_TEST(!le_pack_UnpackVarUint(&bufferPtr, &bufferSz, UINT64_MAX, &valueOut));
+    LE_TEST(bufferPtr == buffer);
+}
+
+/** Compact string **/
+
+static void CheckCompactString
+(
+    const char* stringPtr,      ///< Test string
+    size_t reportedBufferSz,    ///< Buffer size reported to unpack
+    uint32_t maxStringCount,    ///< Max string size
+    bool expectedRes            ///< Expected result
+)
+{
+    uint8_t buffer[BUFFER_SZ];
+    uint8_t* bufferPtr = buffer;
+    size_t bufferSz = sizeof(buffer);
+    size_t stringLen = strnlen(stringPtr, BUFFER_SZ);
+
+    ResetBuffer(bufferPtr, bufferSz);
+
+    printf("compact '%s' - [%zd] buffer[%zd] maxString[%d]:\n",
+           stringPtr,
+           stringLen,
+           reportedBufferSz,
+           maxStringCount);
+
+    // Pack
+    LE_TEST(expectedRes == le_pack_PackCompactString(&bufferPtr,
+                                                     &bufferSz,
+                                                     stringPtr,
+                                                     maxStringCount));
+    if(!expectedRes)
+    {
+        LE_TEST(bufferPtr == buffer);
+        printf("   [passed]\n");
+        return;
+    }
+
+    // Only the string itself and a one byte length are packed
+    LE_TEST(bufferPtr - buffer == (ssize_t)stringLen + 1);
+    LE_TEST(bufferPtr[0] == CHECK_CHAR);
+
+    // Unpack
+    char valueOut[BUFFER_SZ];
+    bufferPtr = buffer;
+    bufferSz = sizeof(buffer);
+    LE_TEST(le_pack_UnpackCompactString(&bufferPtr,
+                                        &bufferSz,
+                                        valueOut,
+                                        reportedBufferSz,
+                                        maxStringCount));
+    LE_TEST(0 == memcmp(stringPtr, valueOut, stringLen));
+    LE_TEST(valueOut[stringLen] == '\0');
+    LE_TEST(bufferPtr - buffer == (ssize_t)stringLen + 1);
+
+    // Output buffer too small for the string and its terminator
+    bufferPtr = buffer;
+    bufferSz = sizeof(buffer);
+    LE_TEST(!le_pack_UnpackCompactString(&bufferPtr,
+                                         &bufferSz,
+                                         valueOut,
+                                         stringLen,
+                                         maxStringCount));
+    LE_TEST(bufferPtr == buffer);
+
+    // Truncated message
+    bufferSz = stringLen;
+    LE_TEST(!le_pack_UnpackCompactString(&bufferPtr,
+                                         &bufferSz,
+                                         valueOut,
+                                         reportedBufferSz,
+                                         maxStringCount));
+    LE_TEST(bufferPtr == buffer);
+
+    printf("   [passed]\n");
+}
+
+static void TestCompactString(void)
+{
+    printf("=> compact string\n");
+
+    CheckCompactString("normal", 512, 128, true);
+    CheckCompactString("buffertooshort", 512, 10, false);
+    CheckCompactString("bufferexactlen", 512, 14, true);
+    CheckCompactString("", 512, 12, true); // Empty
+}
+
+/** Compact arrays **/
+
+static void CheckCompactArray
+(
+    size_t arrayCount,          ///< Number of elements to pack
+    size_t arrayMaxCount,       ///< Max number of elements
+    bool expectedRes            ///< Expected result
+)
+{
+    int32_t array[BUFFER_SZ / sizeof(int32_t)];
+    uint8_t bytes[BUFFER_SZ / sizeof(int32_t)];
+    uint8_t buffer[BUFFER_SZ];
+    uint8_t* bufferPtr = buffer;
+    size_t bufferSz = sizeof(buffer);
+    bool res;
+    size_t i;
+
+    printf("compact int32[%zd] uint8[%zd] max[%zd]:\n", arrayCount, arrayCount, arrayMaxCount);
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(array); i++)
+    {
+        array[i] = (int32_t)i - 7;
+        bytes[i] = (uint8_t)i;
+    }
+
+    ResetBuffer(buffer, sizeof(buffer));
+
+    LE_PACK_PACKCOMPACTARRAY(&bufferPtr, &bufferSz, array, arrayCount, arrayMaxCount,
+                             le_pack_PackCompactInt32, &res);
+    LE_TEST(expectedRes == res);
+    if (!expectedRes)
+    {
+        printf("   [passed]\n");
+        return;
+    }
+    LE_PACK_PACKCOMPACTSIMPLEARRAY(&bufferPtr, &bufferSz, bytes, arrayCount, arrayMaxCount,
+                                   &res);
+    LE_TEST(res);
+
+    // Values from -7 to 56 take one byte each
+    LE_TEST(bufferPtr - buffer == (ssize_t)(2 * (arrayCount + 1)));
+
+    int32_t arrayOut[BUFFER_SZ / sizeof(int32_t)];
+    uint8_t bytesOut[BUFFER_SZ / sizeof(int32_t)];
+    size_t arrayCountOut = 0;
+    size_t bytesCountOut = 0;
+    bufferPtr = buffer;
+    bufferSz = sizeof(buffer);
+    LE_PACK_UNPACKCOMPACTARRAY(&bufferPtr, &bufferSz, arrayOut, &arrayCountOut, arrayMaxCount,
+                               le_pack_UnpackCompactInt32, &res);
+    LE_TEST(res);
+    LE_PACK_UNPACKCOMPACTSIMPLEARRAY(&bufferPtr, &bufferSz, bytesOut, &bytesCountOut,
+                                     arrayMaxCount, &res);
+    LE_TEST(res);
+    LE_TEST(arrayCountOut == arrayCount);
+    LE_TEST(bytesCountOut == arrayCount);
+    LE_TEST(0 == memcmp(array, arrayOut, arrayCount * sizeof(array[0])));
+    LE_TEST(0 == memcmp(bytes, bytesOut, arrayCount * sizeof(bytes[0])));
+
+    // A count above the maximum is rejected
+    if (arrayCount > 0)
+    {
+        bufferPtr = buffer;
+        bufferSz = sizeof(buffer);
+        LE_PACK_UNPACKCOMPACTARRAY(&bufferPtr, &bufferSz, arrayOut, &arrayCountOut,
+                                   arrayCount - 1, le_pack_UnpackCompactInt32, &res);
+        LE_TEST(!res);
+    }
+
+    printf("   [passed]\n");
+}
+
+static void TestCompactArray(void)
+{
+    printf("=> compact array\n");
+
+    CheckCompactArray(0, 10, true);  // Empty
+    CheckCompactArray(5, 10, true);
+    CheckCompactArray(10, 10, true);
+    CheckCompactArray(11, 10, false);
+    CheckCompactArray(60, 300, true); // Sized to content, not to the max count
+}
+
 COMPONENT_INIT
 {
     printf("======== le_pack Test Started ========\n");
@@ -129,6 +551,11 @@ COMPONENT_INIT
 
     TestUint8();
     TestString();
+    TestSimpleArray();
+    TestBlock();
+    TestCompactInteger();
+    TestCompactString();
+    TestCompactArray();
 
     printf("======== le_pack Test Complete ========\n");
     printf("\n");
@@ -0,0 +1,116 @@
+/*
+ * Client using the asynchronous variants of the API functions.  Several requests are sent before
+ * any of the responses are handled, so they are all in flight on the same session.
+ */
+
+
+#include "legato.h"
+#include "asyncClient_interface.h"
+#include "le_print.h"
+
+#define BUFFERSIZE 1000
+
+// Number of allParameters requests sent at once.
+#define NUM_REQUESTS 4
+
+// Number of responses received so far.
+static int ResponseCount = 0;
+
+
+static void AllParametersResponse
+(
+    uint32_t b,
+    const uint32_t* outputPtr,
+    size_t outputSize,
+    const char* response,
+    const char* more,
+    void* contextPtr
+)
+{
+    int requestIndex = (int)(intptr_t)contextPtr;
+
+    LE_PRINT_VALUE("%i", requestIndex);
+    LE_PRINT_VALUE("%u", b);
+    LE_PRINT_ARRAY("%u", outputSize, outputPtr);
+    LE_PRINT_VALUE("%s", response);
+    LE_PRINT_VALUE("%s", more);
+
+    // Responses come back in the order the requests were sent.
+    LE_FATAL_IF(requestIndex != ResponseCount,
+                "Response %d arrived in place of response %d", requestIndex, ResponseCount);
+    LE_FATAL_IF(b != COMMON_TWO, "Unexpected output value %u", b);
+
+    ResponseCount++;
+}
+
+
+static void FileTestResponse
+(
+    int dataOut,
+    void* contextPtr
+)
+{
+    char buffer[BUFFERSIZE];
+    ssize_t numRead;
+
+    LE_PRINT_VALUE("%i", dataOut);
+    LE_FATAL_IF(dataOut < 0, "No file descriptor received");
+
+    // Read and print out whatever is read from the server fd
+    numRead = read(dataOut, buffer, sizeof(buffer) - 1);
+    if (-1 == numRead)
+    {
+        LE_INFO("Read error: %s", strerror(errno));
+    }
+    else
+    {
+        buffer[numRead] = '\0';
+        LE_PRINT_VALUE("%zd", numRead);
+        LE_PRINT_VALUE("%s", buffer);
+    }
+    close(dataOut);
+
+    ResponseCount++;
+}
+
+
+static void TriggerTestAResponse
+(
+    void* contextPtr
+)
+{
+    LE_FATAL_IF(ResponseCount != NUM_REQUESTS + 1,
+                "Only %d responses before the last one", ResponseCount);
+
+    LE_INFO("All asynchronous responses received");
+    exit(EXIT_SUCCESS);
+}
+
+
+COMPONENT_INIT
+{
+    uint32_t data[] = {1, 2, 3, 4};
+    int i;
+
+    asyncClient_ConnectService();
+
+    for (i = 0; i < NUM_REQUESTS; i++)
+    {
+        asyncClient_allParameters_Async(COMMON_TWO,
+                                        data,
+                                        i + 1,
+                                        "input string",
+                                        AllParametersResponse,
+                                        (void*)(intptr_t)i);
+    }
+
+    // Open a file known to exist.  The request closes it once it has been sent.
+    int fdToServer = open("/usr/include/stdio.h", O_RDONLY);
+    LE_PRINT_VALUE("%i", fdToServer);
+    asyncClient_FileTest_Async(fdToServer, FileTestResponse, NULL);
+
+    // The response to this one is the last to arrive.
+    asyncClient_TriggerTestA_Async(TriggerTestAResponse, NULL);
+
+    LE_INFO("%d requests sent", NUM_REQUESTS + 2);
+}
@@ -12,6 +12,7 @@
 #include "legato.h"
 #include "interfaces.h"
 #include "watchdogChain.h"
+#include "wdogHeartbeat.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -75,6 +76,29 @@ static volatile uint32_t WatchdogCount = 0;
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t WatchdogPool;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Process heartbeat, used to kick the process watchdog without sending a message.  NULL if the
+ * process doesn't have one (yet).
+ */
+//--------------------------------------------------------------------------------------------------
+static wdogHeartbeat_Slot_t* HeartbeatPtr = NULL;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set if the process couldn't get a heartbeat, so there's no point asking again on every kick.
+ * The process then only kicks through messages.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsHeartbeatUnavailable = false;
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mutex protecting the process heartbeat, which can be kicked from any thread on the chain.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mutex_Ref_t HeartbeatMutex;
+
 //--------------------------------------------------------------------------------------------------
 /**
  *  Definition of watchdog. Container for managing the timer for every task monitored in
@@ -127,6 +151,57 @@ static void CheckEventLoopHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Kick the process watchdog, through the process heartbeat if the watchdog service supports it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void KickProcessWatchdog
+(
+    void
+)
+{
+    le_mutex_Lock(HeartbeatMutex);
+
+    if ((HeartbeatPtr == NULL) && !IsHeartbeatUnavailable)
+    {
+        int heartbeatFd;
+        le_result_t result = le_wdog_GetHeartbeat(&heartbeatFd);
+
+        if (result == LE_OK)
+        {
+            HeartbeatPtr = wdogHeartbeat_Map(heartbeatFd);
+        }
+
+        // None of the failures go away by asking again: the service doesn't support heartbeats,
+        // already gave this process one, or couldn't create it.
+        if (HeartbeatPtr == NULL)
+        {
+            LE_DEBUG("No heartbeat (%s), kicking through messages.", LE_RESULT_TXT(result));
+            IsHeartbeatUnavailable = true;
+        }
+    }
+
+    if (HeartbeatPtr != NULL)
+    {
+        if (wdogHeartbeat_Kick(HeartbeatPtr))
+        {
+            le_mutex_Unlock(HeartbeatMutex);
+            return;
+        }
+
+        // The watchdog service stopped watching the heartbeat.  Kicking through a message
+        // gets the process watched again, and the next kick gets a new heartbeat.
+        wdogHeartbeat_Unmap(HeartbeatPtr);
+        HeartbeatPtr = NULL;
+    }
+
+    le_mutex_Unlock(HeartbeatMutex);
+
+    le_wdog_Kick();
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Check if the watchdog chain is all kicked, and if so kick the process watchdog.
@@ -150,7 +225,7 @@ void CheckChain
             TRACE("Watchdog chain is all kicked, kick watchdog.");
         }
 
-        le_wdog_Kick();
+        KickProcessWatchdog();
         __sync_and_and_fetch(&WatchdogChain, ((uint64_t)-(INT64_C(1) << MAX_WATCHDOGS)));
     }
 }
@@ -341,4 +416,5 @@ COMPONENT_INIT
     TraceRef = le_log_GetTraceRef("wdog");
 
     WatchdogPool = le_mem_CreatePool("WatchdogChainPool", sizeof(WatchdogObj_t));
+    HeartbeatMutex = le_mutex_CreateNonRecursive("WatchdogChainHeartbeat");
 }
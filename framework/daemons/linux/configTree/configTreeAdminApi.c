@@ -146,6 +146,59 @@ void le_cfgAdmin_ImportTree
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Write a node given from nodePath and it's children to the file given by filePath, using the
+ *  given writer.
+ *
+ *  @return LE_OK if the node was written, LE_IO_ERROR if the file couldn't be opened, LE_FAULT if
+ *          it couldn't be written.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ExportNode
+(
+    ni_IteratorRef_t iteratorRef,                 ///< [IN] Iterator being used for the export.
+    const char* filePathPtr,                      ///< [IN] Export the tree data to the this file.
+    const char* nodePathPtr,                      ///< [IN] The node to export, relative to the
+                                                  ///<      iterator.
+    le_result_t (*writeFunc)(tdb_NodeRef_t, int)  ///< [IN] Writes the node to the file.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_DEBUG("Opening file '%s'.", filePathPtr);
+
+    int fid = -1;
+
+    do
+    {
+        fid = open(filePathPtr, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    }
+    while ((fid == -1) && (errno == EINTR));
+
+    if (fid == -1)
+    {
+        LE_ERROR("File '%s' could not be opened.", filePathPtr);
+        return LE_IO_ERROR;
+    }
+
+
+    LE_DEBUG("Exporting config data.");
+
+    le_result_t result = LE_OK;
+
+    if (writeFunc(ni_GetNode(iteratorRef, nodePathPtr), fid) != LE_OK)
+    {
+        result = LE_FAULT;
+    }
+
+    close(fid);
+
+    return result;
+}
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  Take a node given from nodePath and stream it and it's children to the file given by filePath.
@@ -185,37 +238,58 @@ void le_cfgAdmin_ExportTree
         return;
     }
 
-    LE_DEBUG("Opening file '%s'.", filePathPtr);
-
-    int fid = -1;
+    le_cfgAdmin_ExportTreeRespond(commandRef,
+                                  ExportNode(iteratorRef,
+                                             filePathPtr,
+                                             nodePathPtr,
+                                             tdb_WriteTreeNode));
+}
 
-    do
-    {
-        fid = open(filePathPtr, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
-    }
-    while ((fid == -1) && (errno == EINTR));
 
-    if (fid == -1)
-    {
-        LE_ERROR("File '%s' could not be opened.", filePathPtr);
-        le_cfgAdmin_ExportTreeRespond(commandRef, LE_IO_ERROR);
 
-        return;
-    }
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Take a node given from nodePath and write it and it's children to the file given by filePath,
+ *  as a binary snapshot.  Snapshots can be imported with le_cfgAdmin_ImportTree(), like files in
+ *  the text format.
+ *
+ *  \b Responds \b With:
+ *
+ *  Responds with one of the following values:
+ *
+ *          - LE_OK            - Commit was completed successfully.
+ *          - LE_FAULT         - An I/O error occurred while writing the data.
+ */
+// -------------------------------------------------------------------------------------------------
+void le_cfgAdmin_ExportTreeSnapshot
+(
+    le_cfgAdmin_ServerCmdRef_t commandRef,  ///< [IN] Reference used to generate a reply for this
+                                            ///<      request.
+    le_cfg_IteratorRef_t externalRef,       ///< [IN] Iterator that is being used for the export.
+    const char* filePathPtr,                ///< [IN] Export the tree data to the this file.
+    const char* nodePathPtr                 ///< [IN] Where in the tree should this export happen?
+                                            ///<      Leave as an empty string to use the iterator's
+                                            ///<      current node.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_DEBUG("** Exporting a snapshot from node '%s' into file '%s', using iterator, '%p'.",
+             nodePathPtr, filePathPtr, externalRef);
 
-    LE_DEBUG("Exporting config data.");
-
-    le_result_t result = LE_OK;
+    ni_IteratorRef_t iteratorRef = GetIteratorFromRef(externalRef);
 
-    if (tdb_WriteTreeNode(ni_GetNode(iteratorRef, nodePathPtr), fid) != LE_OK)
+    if (iteratorRef == NULL)
     {
-        result = LE_FAULT;
+        le_cfgAdmin_ExportTreeSnapshotRespond(commandRef, LE_OK);
+        return;
     }
 
-    close(fid);
-
-    le_cfgAdmin_ExportTreeRespond(commandRef, result);
+    le_cfgAdmin_ExportTreeSnapshotRespond(commandRef,
+                                          ExportNode(iteratorRef,
+                                                     filePathPtr,
+                                                     nodePathPtr,
+                                                     tdb_WriteTreeSnapshot));
 }
 
 
@@ -89,6 +89,29 @@
  *  timeout then the client that owns the transaction is disconnected so that other pending
  *  transactions may continue.
  *
+ *
+ *  @section cfg_groupCommit The configTree Group Commit Window
+ *
+ *  Quick writes and transaction commits can be grouped, so that the changes of many of them are
+ *  written to storage together.  The window is configured, in milliseconds, under:
+ *
+@verbatim
+/
+  configTree/
+    groupCommitWindow<int> == 10
+@endverbatim
+ *
+ *  Quick writes are queued for up to this long, and then the queued writes are committed in the
+ *  order they came in.  Committed transactions are merged straight away.  Their changes, and those
+ *  of the grouped quick writes, are written to storage with a single sync once the window closes.
+ *  Clients only get their replies after that, so each write waits for up to this long more, in
+ *  exchange for many fewer writes to storage when many come in together.
+ *
+ *  Each quick write is still committed on its own, for the client that made it, so change handlers
+ *  are called once for each write, when the window closes.  Only the sync to storage is shared.
+ *
+ *  If this value is not set, or is 0, each write is merged and written to storage on its own.
+ *
  * <HR>
  *
  *  Copyright (C) Sierra Wireless Inc.
@@ -110,6 +133,10 @@
 static time_t TransactionTimeout = 0;
 
 
+/// Cached value for the group commit window, in milliseconds.
+static uint32_t GroupCommitWindow = 0;
+
+
 /// Path to the configTree's global configuration.
 #define GLOBAL_CONFIG_PATH "/configTree"
 
@@ -135,6 +162,10 @@ static void OnGlobalConfigChanged
                                                      GLOBAL_CONFIG_PATH);
 
     TransactionTimeout = ni_GetNodeValueInt(iteratorRef, "transactionTimeout", 30);
+
+    int32_t groupCommitWindow = ni_GetNodeValueInt(iteratorRef, "groupCommitWindow", 0);
+    GroupCommitWindow = (groupCommitWindow > 0) ? groupCommitWindow : 0;
+
     ni_Release(iteratorRef);
 }
 
@@ -312,3 +343,22 @@ time_t ic_GetTransactionTimeout
 {
     return TransactionTimeout;
 }
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Read the current group commit window from the configtree's internal data.
+ *
+ *  @return The window in milliseconds, or 0 if writes aren't grouped.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t ic_GetGroupCommitWindow
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return GroupCommitWindow;
+}
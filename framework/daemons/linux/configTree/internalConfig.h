@@ -63,4 +63,19 @@ time_t ic_GetTransactionTimeout
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Read the current group commit window from the configtree's internal data.
+ *
+ *  @return The window in milliseconds, or 0 if writes aren't grouped.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t ic_GetGroupCommitWindow
+(
+    void
+);
+
+
+
+
 #endif
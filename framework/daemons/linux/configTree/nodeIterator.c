@@ -379,7 +379,52 @@ ni_IteratorRef_t ni_InternalRefFromExternalRef
 
 //--------------------------------------------------------------------------------------------------
 /**
- *  Commit the changes introduced by an iterator to the config tree.
+ *  Move the read iterators on a tree onto a version of its current state, so that a change can be
+ *  merged into the tree without changing what they read.  The version shares the tree's nodes until
+ *  they're changed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MoveReadersToVersion
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree a change is about to be merged into.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    tdb_TreeRef_t versionRef = tdb_NewTreeVersion(treeRef);
+    le_ref_IterRef_t refIterator = le_ref_GetIterator(IteratorRefMap);
+
+    while (le_ref_NextNode(refIterator) == LE_OK)
+    {
+        ni_IteratorRef_t iteratorRef = (ni_IteratorRef_t)le_ref_GetValue(refIterator);
+
+        if (   (iteratorRef != NULL)
+            && (iteratorRef->type == NI_READ)
+            && (iteratorRef->treeRef == treeRef))
+        {
+            tdb_UnregisterIterator(treeRef, iteratorRef);
+
+            iteratorRef->treeRef = versionRef;
+            iteratorRef->currentNodeRef = tdb_GetNode(tdb_GetRootNode(versionRef),
+                                                      iteratorRef->pathIterRef);
+
+            tdb_RegisterIterator(versionRef, iteratorRef);
+        }
+    }
+
+    // Frees the version if there weren't any iterators to move onto it after all.
+    tdb_ReleaseTree(versionRef);
+
+    LE_DEBUG("Moved the read iterators on tree '%s' onto a version of it.",
+             tdb_GetTreeName(treeRef));
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Commit the changes introduced by an iterator to the config tree.  Read iterators on the tree
+ *  keep on reading the tree as it was before the commit.
  */
 //--------------------------------------------------------------------------------------------------
 void ni_Commit
@@ -390,6 +435,12 @@ void ni_Commit
 {
     if (iteratorRef->type == NI_WRITE)
     {
+        if (tdb_HasActiveReaders(iteratorRef->treeRef))
+        {
+            // Look up the original tree, the iterator's own tree is a shadow of it.
+            MoveReadersToVersion(tdb_GetTree(tdb_GetTreeName(iteratorRef->treeRef)));
+        }
+
         tdb_MergeTree(iteratorRef->treeRef);
     }
 }
@@ -445,11 +496,8 @@ void ni_Release
  *  Close an iterator object and invalidate it's external safe reference.  (If there is one.)  Once
  *  done, this iterator is no longer accessable from outside of the process.
  *
- *  An iterator is closed with out releasing in the case where you have an open write iterator on a
- *  tree with open reads.  The iterator is closed, but it's data is not yet mergable into the tree.
- *
- *  So, the iterator is marked as closed and it's external ref is invalidated so no more work can be
- *  done with that iterator.
+ *  A write iterator is closed before it's committed and released, so the iterator is marked as
+ *  closed and it's external ref is invalidated so no more work can be done with that iterator.
  */
 //--------------------------------------------------------------------------------------------------
 void ni_Close
@@ -117,7 +117,8 @@ ni_IteratorRef_t ni_InternalRefFromExternalRef
 
 //--------------------------------------------------------------------------------------------------
 /**
- *  Commit the changes introduced by an iterator to the config tree.
+ *  Commit the changes introduced by an iterator to the config tree.  Read iterators on the tree
+ *  keep on reading the tree as it was before the commit.
  */
 //--------------------------------------------------------------------------------------------------
 void ni_Commit
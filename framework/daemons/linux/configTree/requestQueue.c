@@ -10,6 +10,10 @@
  *  This module also takes care of handling call backs to the user so that they can know their
  *  request has been completed.
  *
+ *  If a group commit window is configured, quick writes are queued until the window closes, and
+ *  then each is committed in turn.  The changes of those writes, and of any transactions committed
+ *  in the window, are then synced to storage together before any of them are replied to.
+ *
  *  Copyright (C) Sierra Wireless Inc.
  *
  */
@@ -21,6 +25,7 @@
 #include "treeUser.h"
 #include "nodeIterator.h"
 #include "requestQueue.h"
+#include "internalConfig.h"
 
 
 
@@ -30,6 +35,15 @@ static le_mem_PoolRef_t RequestPool = NULL;
 
 #define CFG_REQUEST_POOL "configTree.requestPool"
 
+// Quick writes waiting for the group commit window to close before they're merged.
+static le_sls_List_t PendingWriteList = LE_SLS_LIST_INIT;
+
+// Merged writes and commits waiting for their changes to be synced before they're replied to.
+static le_sls_List_t SyncWaitList = LE_SLS_LIST_INIT;
+
+// Timer that closes the group commit window.
+static le_timer_Ref_t GroupCommitTimerRef = NULL;
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  Request structure, if the user's request on the DB can't be handled right away it is stored in
@@ -55,12 +69,6 @@ typedef struct UpdateRequest
         }
         createTxn;                               ///< Create new transaction info.
 
-        struct
-        {
-            ni_IteratorRef_t iteratorRef;        ///< Ptr to the iterator to commit.
-        }
-        commitTxn;
-
         struct
         {
             ni_IteratorRef_t iteratorRef;        ///< Ptr to the iterator to commit.
@@ -181,7 +189,7 @@ static void QueueRequest
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Queue a create transaction request.
+ *  Queue a create write transaction request.  (Read transactions are never queued.)
  */
 // -------------------------------------------------------------------------------------------------
 static void QueueCreateTxnRequest
@@ -190,13 +198,15 @@ static void QueueCreateTxnRequest
     tdb_TreeRef_t treeRef,             ///< [IN] The tree we're working on.
     le_msg_SessionRef_t sessionRef,    ///< [IN] The user session this request occured on.
     le_cfg_ServerCmdRef_t commandRef,  ///< [IN] Context for this request.
-    ni_IteratorType_t iteratorType,    ///< [IN] The kind of iterator to create.
     const char* basePathPtr            ///< [IN] The initial path for the iterator.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    RequestType_t type = iteratorType == NI_READ ? RQ_CREATE_READ_TXN : RQ_CREATE_WRITE_TXN;
-    UpdateRequest_t* requestPtr = NewRequestBlock(type, userRef, treeRef, sessionRef, commandRef);
+    UpdateRequest_t* requestPtr = NewRequestBlock(RQ_CREATE_WRITE_TXN,
+                                                  userRef,
+                                                  treeRef,
+                                                  sessionRef,
+                                                  commandRef);
 
     LE_ASSERT(le_utf8_Copy(requestPtr->data.createTxn.pathPtr,
                            basePathPtr,
@@ -242,6 +252,299 @@ static void QueueDeleteTxnRequest
 
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Check to see if the given tree is open for quick writes.
+ *
+ *  @return True if a quick write can safely be performed.  False if not.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CanQuickSet
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree to check.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // If there is an active writer on the tree then a quick write should be defered.  Active
+    // readers don't matter, they keep on reading the tree as it was before the write.
+    return (tdb_GetActiveWriteIter(treeRef) == NULL);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Apply a queued quick write to a tree, through a write iterator.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ApplyWriteRequest
+(
+    ni_IteratorRef_t iteratorRef,  ///< [IN] Write iterator on the request's tree.
+    UpdateRequest_t* requestPtr    ///< [IN] The write to apply.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const char* pathPtr = requestPtr->data.writeReq.pathPtr;
+
+    switch (requestPtr->type)
+    {
+        case RQ_DELETE_NODE:
+            ni_DeleteNode(iteratorRef, pathPtr);
+            break;
+
+        case RQ_SET_EMPTY:
+            ni_SetEmpty(iteratorRef, pathPtr);
+            break;
+
+        case RQ_SET_STRING:
+        case RQ_SET_BINARY:
+            ni_SetNodeValueString(iteratorRef, pathPtr, requestPtr->data.writeReq.value.AsStringPtr);
+            break;
+
+        case RQ_SET_INT:
+            ni_SetNodeValueInt(iteratorRef, pathPtr, requestPtr->data.writeReq.value.AsInt);
+            break;
+
+        case RQ_SET_FLOAT:
+            ni_SetNodeValueFloat(iteratorRef, pathPtr, requestPtr->data.writeReq.value.AsFloat);
+            break;
+
+        case RQ_SET_BOOL:
+            ni_SetNodeValueBool(iteratorRef, pathPtr, requestPtr->data.writeReq.value.AsBool);
+            break;
+
+        default:
+            LE_FATAL("Unexpected request type: %d", requestPtr->type);
+    }
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Reply to a write or commit whose changes have been synced.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RespondToWriteRequest
+(
+    UpdateRequest_t* requestPtr  ///< [IN] The request to reply to.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    switch (requestPtr->type)
+    {
+        case RQ_COMMIT_WRITE_TXN:
+            le_cfg_CommitTxnRespond(requestPtr->commandRef);
+            break;
+
+        case RQ_DELETE_NODE:
+            le_cfg_QuickDeleteNodeRespond(requestPtr->commandRef);
+            break;
+
+        case RQ_SET_EMPTY:
+            le_cfg_QuickSetEmptyRespond(requestPtr->commandRef);
+            break;
+
+        case RQ_SET_STRING:
+            le_cfg_QuickSetStringRespond(requestPtr->commandRef);
+            break;
+
+        case RQ_SET_BINARY:
+            le_cfg_QuickSetBinaryRespond(requestPtr->commandRef);
+            break;
+
+        case RQ_SET_INT:
+            le_cfg_QuickSetIntRespond(requestPtr->commandRef);
+            break;
+
+        case RQ_SET_FLOAT:
+            le_cfg_QuickSetFloatRespond(requestPtr->commandRef);
+            break;
+
+        case RQ_SET_BOOL:
+            le_cfg_QuickSetBoolRespond(requestPtr->commandRef);
+            break;
+
+        default:
+            LE_FATAL("Unexpected request type: %d", requestPtr->type);
+    }
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Commit a queued quick write in its own transaction, for the user that requested it.  If the
+ *  tree's sync is deferred, the write is only merged in memory for now.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CommitWriteRequest
+(
+    UpdateRequest_t* requestPtr  ///< [IN] The write to commit.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ni_IteratorRef_t iteratorRef = ni_CreateIterator(requestPtr->sessionRef,
+                                                     requestPtr->userRef,
+                                                     requestPtr->treeRef,
+                                                     NI_WRITE,
+                                                     NULL);
+
+    ApplyWriteRequest(iteratorRef, requestPtr);
+    ni_Commit(iteratorRef);
+    ni_Release(iteratorRef);
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Merge the quick writes queued in the group commit window.  Each write is committed on its own,
+ *  so change handlers are called for each of them as they would be without the window.  Writes to
+ *  a tree that's busy are queued on the tree, behind the requests already waiting for it, so that
+ *  they are still handled in the order they came in.
+ *
+ *  The merged writes then wait for the window to close to be synced and replied to.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MergePendingWrites
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_sls_List_t list = PendingWriteList;
+    PendingWriteList = LE_SLS_LIST_INIT;
+
+    le_sls_Link_t* linkPtr = le_sls_Pop(&list);
+
+    while (linkPtr != NULL)
+    {
+        UpdateRequest_t* requestPtr = CONTAINER_OF(linkPtr, UpdateRequest_t, link);
+        tdb_TreeRef_t treeRef = requestPtr->treeRef;
+
+        if (   (CanQuickSet(treeRef) == false)
+            || (le_sls_IsEmpty(tdb_GetRequestQueue(treeRef)) == false))
+        {
+            // The write leaves this window.  It's committed when it's taken off of the tree's
+            // queue, and synced with the window open then.  The tree is only synced once the rest
+            // of this window is done with it.
+            QueueRequest(tdb_GetRequestQueue(treeRef), requestPtr);
+            tdb_SyncTree(treeRef);
+        }
+        else
+        {
+            CommitWriteRequest(requestPtr);
+            QueueRequest(&SyncWaitList, requestPtr);
+        }
+
+        linkPtr = le_sls_Pop(&list);
+    }
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Called when the group commit window closes.  Merge the queued quick writes, then sync the
+ *  changes made in the window and reply to the clients that made them, in the order they came in.
+ *  Each tree is synced once, when the last of its requests in the window ends its deferral, and no
+ *  one is replied to before all the trees are synced.
+ */
+//--------------------------------------------------------------------------------------------------
+static void OnGroupCommit
+(
+    le_timer_Ref_t timerRef  ///< [IN] The timer that expired.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    MergePendingWrites();
+
+    le_sls_List_t list = SyncWaitList;
+    SyncWaitList = LE_SLS_LIST_INIT;
+
+    le_sls_Link_t* linkPtr = le_sls_Peek(&list);
+
+    while (linkPtr != NULL)
+    {
+        UpdateRequest_t* requestPtr = CONTAINER_OF(linkPtr, UpdateRequest_t, link);
+
+        tdb_SyncTree(requestPtr->treeRef);
+        linkPtr = le_sls_PeekNext(&list, linkPtr);
+    }
+
+    linkPtr = le_sls_Pop(&list);
+
+    while (linkPtr != NULL)
+    {
+        UpdateRequest_t* requestPtr = CONTAINER_OF(linkPtr, UpdateRequest_t, link);
+
+        RespondToWriteRequest(requestPtr);
+
+        ReleaseRequestBlock(requestPtr);
+        linkPtr = le_sls_Pop(&list);
+    }
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Add a request to the group commit window, opening the window if it isn't already.  The sync of
+ *  the request's tree is deferred until the window closes.
+ */
+//--------------------------------------------------------------------------------------------------
+static void QueueGroupRequest
+(
+    le_sls_List_t* listPtr,      ///< [IN] PendingWriteList or SyncWaitList.
+    UpdateRequest_t* requestPtr  ///< [IN] The request to queue.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    tdb_DeferSync(requestPtr->treeRef);
+    QueueRequest(listPtr, requestPtr);
+
+    if (le_timer_IsRunning(GroupCommitTimerRef) == false)
+    {
+        LE_ASSERT(le_timer_SetMsInterval(GroupCommitTimerRef, ic_GetGroupCommitWindow()) == LE_OK);
+        LE_ASSERT(le_timer_Start(GroupCommitTimerRef) == LE_OK);
+    }
+}
+
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ *  Queue a quick write that can't be handled right away.  If a group commit window is configured,
+ *  it's queued in the window, otherwise it's queued on its tree.
+ */
+//--------------------------------------------------------------------------------------------------
+static void QueueWriteRequest
+(
+    UpdateRequest_t* requestPtr  ///< [IN] The write to queue.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (ic_GetGroupCommitWindow() > 0)
+    {
+        QueueGroupRequest(&PendingWriteList, requestPtr);
+    }
+    else
+    {
+        QueueRequest(tdb_GetRequestQueue(requestPtr->treeRef), requestPtr);
+    }
+}
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  Process all of the queued requests.
@@ -269,6 +572,7 @@ static void ProcessRequestQueue
     while (linkPtr != NULL)
     {
         UpdateRequest_t* requestPtr = CONTAINER_OF(linkPtr, UpdateRequest_t, link);
+        bool isKept = false;
 
         // If this request belongs to a session that's been closed,
         if (   (ignoreSessionRef != NULL)
@@ -280,6 +584,21 @@ static void ProcessRequestQueue
                      tu_GetUserName(requestPtr->userRef),
                      tdb_GetTreeName(requestPtr->treeRef));
         }
+        else if (   (requestPtr->type >= RQ_DELETE_NODE)
+                 && (ic_GetGroupCommitWindow() > 0))
+        {
+            // A quick write that waited on its tree must not be queued in the group commit window
+            // behind writes that came in after it.  So it's committed now, and only its sync and
+            // reply wait for the window to close.
+            LE_DEBUG("Committing deferred quick write for user %u (%s) on tree '%s'.",
+                     tu_GetUserId(requestPtr->userRef),
+                     tu_GetUserName(requestPtr->userRef),
+                     tdb_GetTreeName(requestPtr->treeRef));
+
+            QueueGroupRequest(&SyncWaitList, requestPtr);
+            CommitWriteRequest(requestPtr);
+            isKept = true;
+        }
         else
         {
             LE_DEBUG("** Process request block <%p>.", requestPtr);
@@ -292,35 +611,16 @@ static void ProcessRequestQueue
                              tu_GetUserName(requestPtr->userRef),
                              tdb_GetTreeName(requestPtr->treeRef));
 
-                    rq_HandleCreateTxnRequest(requestPtr->userRef,
-                                              requestPtr->treeRef,
-                                              requestPtr->sessionRef,
-                                              requestPtr->commandRef,
-                                              NI_WRITE,
-                                              requestPtr->data.createTxn.pathPtr);
-                    break;
-
-                case RQ_COMMIT_WRITE_TXN:
-                    LE_DEBUG("Committing deferred write txn for user %u (%s) on tree '%s'.",
-                             tu_GetUserId(requestPtr->userRef),
-                             tu_GetUserName(requestPtr->userRef),
-                             tdb_GetTreeName(requestPtr->treeRef));
-
-                    rq_HandleCommitTxnRequest(requestPtr->commandRef,
-                                              requestPtr->data.commitTxn.iteratorRef);
-                    break;
-
-               case RQ_CREATE_READ_TXN:
-                    LE_DEBUG("Starting deferred read txn for user %u (%s) on tree '%s'.",
-                             tu_GetUserId(requestPtr->userRef),
-                             tu_GetUserName(requestPtr->userRef),
-                             tdb_GetTreeName(requestPtr->treeRef));
+                    // The requests behind the transaction go back on the tree's queue to wait for
+                    // it, so quick writes merged when it starts are queued behind them.
+                    *listPtr = list;
+                    list = LE_SLS_LIST_INIT;
 
                     rq_HandleCreateTxnRequest(requestPtr->userRef,
                                               requestPtr->treeRef,
                                               requestPtr->sessionRef,
                                               requestPtr->commandRef,
-                                              NI_READ,
+                                              NI_WRITE,
                                               requestPtr->data.createTxn.pathPtr);
                     break;
 
@@ -418,40 +718,20 @@ static void ProcessRequestQueue
                                           requestPtr->data.writeReq.value.AsBool);
                     break;
 
+                // Commits are never queued on a tree, they're only grouped until they're synced.
+                case RQ_COMMIT_WRITE_TXN:
                 case RQ_INVALID:
                     LE_FATAL("Invalid request block used.");
             }
         }
 
-        ReleaseRequestBlock(requestPtr);
-        linkPtr = le_sls_Pop(&list);
-    }
-}
-
-
-
+        if (isKept == false)
+        {
+            ReleaseRequestBlock(requestPtr);
+        }
 
-//--------------------------------------------------------------------------------------------------
-/**
- *  Check to see if the given tree is open for quick writes.
- *
- *  @return True if a quick write can safely be performed.  False if not.
- */
-//--------------------------------------------------------------------------------------------------
-static bool CanQuickSet
-(
-    tdb_TreeRef_t treeRef  ///< [IN] The tree to check.
-)
-//--------------------------------------------------------------------------------------------------
-{
-    // If there are active readers or writers on the tree then a quick write should be defered.
-    if (   (tdb_HasActiveReaders(treeRef) == false)
-        && (tdb_GetActiveWriteIter(treeRef) == NULL))
-    {
-        return true;
+        linkPtr = le_sls_Pop(&list);
     }
-
-    return false;
 }
 
 
@@ -499,6 +779,10 @@ void rq_Init
     LE_DEBUG("** Initialize Request Queue subsystem.");
 
     RequestPool = le_mem_CreatePool(CFG_REQUEST_POOL, sizeof(UpdateRequest_t));
+
+    GroupCommitTimerRef = le_timer_Create("Group Commit Timer");
+    LE_ASSERT(le_timer_SetHandler(GroupCommitTimerRef, OnGroupCommit) == LE_OK);
+    LE_ASSERT(le_timer_SetWakeup(GroupCommitTimerRef, false) == LE_OK);
 }
 
 
@@ -544,18 +828,18 @@ void rq_HandleCreateTxnRequest
 )
 //--------------------------------------------------------------------------------------------------
 {
-    ni_IteratorRef_t writeIteratorRef = tdb_GetActiveWriteIter(treeRef);
-
-    if (   (iterType == NI_READ)
-        && (writeIteratorRef != NULL)
-        && (ni_IsClosed(writeIteratorRef)))
+    // Quick writes queued before a write transaction is started are merged before it, so that they
+    // are not applied on top of the transaction's changes.
+    if (iterType == NI_WRITE)
     {
-        QueueCreateTxnRequest(userRef, treeRef, sessionRef, commandRef, iterType, pathPtr);
+        MergePendingWrites();
     }
-    else if (   (iterType == NI_WRITE)
-             && (writeIteratorRef != NULL))
+
+    // Read transactions never wait, they read the last committed state of the tree.
+    if (   (iterType == NI_WRITE)
+        && (tdb_GetActiveWriteIter(treeRef) != NULL))
     {
-        QueueCreateTxnRequest(userRef, treeRef, sessionRef, commandRef, iterType, pathPtr);
+        QueueCreateTxnRequest(userRef, treeRef, sessionRef, commandRef, pathPtr);
     }
     else
     {
@@ -598,31 +882,40 @@ void rq_HandleCommitTxnRequest
 {
     if (ni_IsWriteable(iteratorRef) == false)
     {
-        // Kill the iterator but do not try to comit it.
+        // Kill the iterator but do not try to comit it.  Nothing waits for read iterators, so
+        // there's no backlog to process.
         ni_Release(iteratorRef);
 
         le_cfg_CommitTxnRespond(commandRef);
-        ProcessRequestQueue(tdb_GetRequestQueue(ni_GetTree(iteratorRef)), NULL);
     }
-    else if (tdb_HasActiveReaders(ni_GetTree(iteratorRef)) == false)
+    else
     {
+        // Look up the original tree, the iterator's shadow tree goes away with it.
+        tdb_TreeRef_t treeRef = tdb_GetTree(tdb_GetTreeName(ni_GetTree(iteratorRef)));
+        bool isGrouped = (ic_GetGroupCommitWindow() > 0);
+
+        // If commits are grouped, the changes are merged now but only synced, and replied to, once
+        // the group commit window closes.
+        if (isGrouped)
+        {
+            QueueGroupRequest(&SyncWaitList,
+                              NewRequestBlock(RQ_COMMIT_WRITE_TXN,
+                                              ni_GetUser(iteratorRef),
+                                              treeRef,
+                                              ni_GetSession(iteratorRef),
+                                              commandRef));
+        }
+
         ni_Close(iteratorRef);
         ni_Commit(iteratorRef);
         ni_Release(iteratorRef);
 
-        le_cfg_CommitTxnRespond(commandRef);
-        ProcessRequestQueue(tdb_GetRequestQueue(ni_GetTree(iteratorRef)), NULL);
-    }
-    else
-    {
-        UpdateRequest_t* requestPtr = NewRequestBlock(RQ_COMMIT_WRITE_TXN,
-                                                      ni_GetUser(iteratorRef),
-                                                      ni_GetTree(iteratorRef),
-                                                      ni_GetSession(iteratorRef),
-                                                      commandRef);
+        if (isGrouped == false)
+        {
+            le_cfg_CommitTxnRespond(commandRef);
+        }
 
-        requestPtr->data.commitTxn.iteratorRef = iteratorRef;
-        QueueRequest(tdb_GetRequestQueue(ni_GetTree(iteratorRef)), requestPtr);
+        ProcessRequestQueue(tdb_GetRequestQueue(treeRef), NULL);
     }
 }
 
@@ -641,6 +934,11 @@ void rq_HandleCancelTxnRequest
 )
 //--------------------------------------------------------------------------------------------------
 {
+    // Only a write iterator can be holding up the tree's request backlog.  A read iterator's tree
+    // may be a version of the tree that goes away with the iterator.
+    bool isWriteable = ni_IsWriteable(iteratorRef);
+    le_sls_List_t* queuePtr = tdb_GetRequestQueue(ni_GetTree(iteratorRef));
+
     // Kill the iterator but do not try to comit it.
     ni_Release(iteratorRef);
 
@@ -653,7 +951,10 @@ void rq_HandleCancelTxnRequest
     }
 
     // Try to handle the tree's request backlog.  (If any.)
-    ProcessRequestQueue(tdb_GetRequestQueue(ni_GetTree(iteratorRef)), NULL);
+    if (isWriteable)
+    {
+        ProcessRequestQueue(queuePtr, NULL);
+    }
 }
 
 
@@ -675,7 +976,8 @@ void rq_HandleQuickDeleteNode
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (CanQuickSet(treeRef) == false)
+    if (   (CanQuickSet(treeRef) == false)
+        || (ic_GetGroupCommitWindow() > 0))
     {
         UpdateRequest_t* requestPtr = NewRequestBlock(RQ_DELETE_NODE,
                                                       userRef,
@@ -688,7 +990,7 @@ void rq_HandleQuickDeleteNode
                                sizeof(requestPtr->data.writeReq.pathPtr),
                                NULL) == LE_OK);
 
-        QueueRequest(tdb_GetRequestQueue(treeRef), requestPtr);
+        QueueWriteRequest(requestPtr);
     }
     else
     {
@@ -725,7 +1027,8 @@ void rq_HandleQuickSetEmpty
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (CanQuickSet(treeRef) == false)
+    if (   (CanQuickSet(treeRef) == false)
+        || (ic_GetGroupCommitWindow() > 0))
     {
         UpdateRequest_t* requestPtr = NewRequestBlock(RQ_SET_EMPTY,
                                                       userRef,
@@ -738,7 +1041,7 @@ void rq_HandleQuickSetEmpty
                                sizeof(requestPtr->data.writeReq.pathPtr),
                                NULL) == LE_OK);
 
-        QueueRequest(tdb_GetRequestQueue(treeRef), requestPtr);
+        QueueWriteRequest(requestPtr);
     }
     else
     {
@@ -822,7 +1125,8 @@ void rq_HandleQuickSetData
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (CanQuickSet(treeRef) == false)
+    if (   (CanQuickSet(treeRef) == false)
+        || (ic_GetGroupCommitWindow() > 0))
     {
         UpdateRequest_t* requestPtr = NewRequestBlock(
                                         reqType,
@@ -842,7 +1146,7 @@ void rq_HandleQuickSetData
                                NULL) == LE_OK);
 
 
-        QueueRequest(tdb_GetRequestQueue(treeRef), requestPtr);
+        QueueWriteRequest(requestPtr);
     }
     else
     {
@@ -1007,7 +1311,8 @@ void rq_HandleQuickSetInt
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (CanQuickSet(treeRef) == false)
+    if (   (CanQuickSet(treeRef) == false)
+        || (ic_GetGroupCommitWindow() > 0))
     {
         UpdateRequest_t* requestPtr = NewRequestBlock(RQ_SET_INT,
                                                       userRef,
@@ -1022,7 +1327,7 @@ void rq_HandleQuickSetInt
 
         requestPtr->data.writeReq.value.AsInt = value;
 
-        QueueRequest(tdb_GetRequestQueue(treeRef), requestPtr);
+        QueueWriteRequest(requestPtr);
     }
     else
     {
@@ -1090,7 +1395,8 @@ void rq_HandleQuickSetFloat
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (CanQuickSet(treeRef) == false)
+    if (   (CanQuickSet(treeRef) == false)
+        || (ic_GetGroupCommitWindow() > 0))
     {
         UpdateRequest_t* requestPtr = NewRequestBlock(RQ_SET_FLOAT,
                                                       userRef,
@@ -1105,7 +1411,7 @@ void rq_HandleQuickSetFloat
 
         requestPtr->data.writeReq.value.AsFloat = value;
 
-        QueueRequest(tdb_GetRequestQueue(treeRef), requestPtr);
+        QueueWriteRequest(requestPtr);
     }
     else
     {
@@ -1173,7 +1479,8 @@ void rq_HandleQuickSetBool
 )
 //--------------------------------------------------------------------------------------------------
 {
-    if (CanQuickSet(treeRef) == false)
+    if (   (CanQuickSet(treeRef) == false)
+        || (ic_GetGroupCommitWindow() > 0))
     {
         UpdateRequest_t* requestPtr = NewRequestBlock(RQ_SET_BOOL,
                                                       userRef,
@@ -1188,7 +1495,7 @@ void rq_HandleQuickSetBool
 
         requestPtr->data.writeReq.value.AsBool = value;
 
-        QueueRequest(tdb_GetRequestQueue(treeRef), requestPtr);
+        QueueWriteRequest(requestPtr);
     }
     else
     {
@@ -27,9 +27,9 @@ typedef enum
 
     RQ_CREATE_WRITE_TXN,
     RQ_COMMIT_WRITE_TXN,
-    RQ_CREATE_READ_TXN,
     RQ_DELETE_TXN,
 
+    // Quick writes, RQ_DELETE_NODE to the end.
     RQ_DELETE_NODE,
     RQ_SET_EMPTY,
     RQ_SET_STRING,
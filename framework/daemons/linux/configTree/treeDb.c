@@ -42,9 +42,8 @@
  *  incremented.  When it ends, the count is decremented.
  *
  *  When client requests are received that cannot be processed immediately, because of the state
- *  of the tree the request is for (e.g., if a write transaction commit request is received while
- *  there are read transactions in progress on the tree), then the request is queued onto the tree's
- *  Request Queue.
+ *  of the tree the request is for (e.g., if a write transaction is requested while another one is
+ *  in progress on the tree), then the request is queued onto the tree's Request Queue.
  *
  *  <b>Shadow Trees:</b>
  *
@@ -68,7 +67,58 @@
  *  Shadow Trees don't have handlers, request queues, write iterator references or read iterator
  *  counts.
  *
- *  <b>Event Handler Registration:</b>
+ *  <b>Tree Versions:</b>
+ *
+ *  Read transactions don't hold up commits.  When a change is about to be merged into a tree that
+ *  has read iterators on it, the read iterators are moved onto a "Tree Version" of it.  They carry
+ *  on reading the state the tree was in when they were created, while read transactions created
+ *  after the commit see the new state.  A tree version isn't in the Tree Collection, and is never
+ *  changed.  It's freed once the last of its read iterators is released.
+ *
+ *  A tree version starts out as a copy of the tree's root node, which shares the tree's children.
+ *  A stem that shares children copies them from its source node when they're first looked at, and
+ *  the copies of stems share their own children in turn.  Before each later change is merged into
+ *  the tree, the shadow tree is walked to find the nodes the merge will change, and the tree's
+ *  versions copy the children of those nodes' parents, so that they keep the old names and values.
+ *  Nodes that the merge will delete or clear are copied along with all of their children.  So only
+ *  the paths from the root to the changed nodes are copied, and untouched subtrees stay shared.
+ *  Children that are still in a snapshot aren't copied, the copy reads them from the snapshot too.
+ *
+ *  <b>Child Indexes:</b>
+ *
+ *  Children are looked up by name when following a path, and searching a stem's child list gets
+ *  slow once a stem has many children.  So when a lookup has to go through CHILD_INDEX_THRESHOLD
+ *  children or more, the stem gets a Child Index: a hash table of its children by name hash.  From
+ *  then on, children are added to, removed from and moved within the index as they're created,
+ *  released and renamed, in both original and shadow trees.  The index grows as the stem gains
+ *  children, and is dropped when the stem loses all of its children.
+ *
+ *  <b>Journals:</b>
+ *
+ *  Each tree is stored in a revision file, which holds the whole tree, and a journal, which holds
+ *  the changes committed since that revision file was written.  A commit appends a record of the
+ *  nodes it set and deleted to the journal, instead of writing the whole tree again.  Each record
+ *  starts with its size and CRC, so that a record torn by a power failure is found and dropped when
+ *  the tree is loaded and the journal is replayed on top of the revision file.
+ *
+ *  Once a journal grows as big as its revision file, it is compacted in the background: the tree
+ *  is written to the next revision file, and the old revision file and its journal are deleted.
+ *  Commits that can't be journaled are written the same way straight away.
+ *
+ *  The request queue can defer the sync of a tree, so that the records of several commits are held
+ *  in memory and written to the journal together, with one sync.  Each request in a group defers
+ *  the sync once and ends its deferral with tdb_SyncTree(), and the records are written when the
+ *  last deferral ends.
+ *
+ *  <b>Snapshots:</b>
+ *
+ *  Revision files can also be written as snapshots, when LE_CONFIG_CONFIGTREE_BINARY_SNAPSHOTS is
+ *  set.  A snapshot holds an array of node records, in breadth first order, and a table of the
+ *  names and values they use.  Instead of being parsed, it is mapped into memory and checked, and
+ *  each stem's children are only read out of it the first time they're needed.  The snapshot is
+ *  unmapped once the children of all of its stems have been read, or dropped.  Files in either
+ *  format can be loaded or imported, whichever format the revision files are written in.
+ *
  *
  *  The config tree allows clients to register callbacks to be notified if certian sections of a
  *  configuration tree is modified.
@@ -125,6 +175,8 @@
  */
 // -------------------------------------------------------------------------------------------------
 
+#include <sys/mman.h>
+#include <sys/uio.h>
 #include "legato.h"
 #include "limit.h"
 #include "interfaces.h"
@@ -148,6 +200,46 @@
 
 
 
+/// Number of children a lookup has to go through before the stem's children get indexed.
+#define CHILD_INDEX_THRESHOLD 16
+
+/// Number of buckets in the smallest child index.  Must be a power of 2.
+#define CHILD_INDEX_MIN_BUCKETS 32
+
+/// Each child index size class has this many times more buckets than the one before it.
+#define CHILD_INDEX_GROWTH 8
+
+/// Number of child index size classes.  The largest one has 16384 buckets.
+#define CHILD_INDEX_SIZE_CLASSES 4
+
+
+
+/// Extension added to a revision file's name to get the name of its journal.
+#define JOURNAL_EXTENSION ".journal"
+
+/// Journals aren't compacted until they're at least this big, in bytes.
+#define JOURNAL_MIN_COMPACT_SIZE 16384
+
+/// How long after a commit a journal that has grown too big gets compacted, in milliseconds.
+#define JOURNAL_COMPACT_DELAY 2000
+
+/// Size of a journal record header, "#<size> <crc>\n", with the size and CRC in 8 hex digits.
+#define JOURNAL_HEADER_SIZE 19
+
+
+
+/// First bytes of a snapshot file.  A tree file in the text format can't start with them.
+#define SNAPSHOT_MAGIC "LECFGSNP"
+
+/// Size of the snapshot magic, in bytes.
+#define SNAPSHOT_MAGIC_BYTES 8
+
+/// Version of the snapshot format.  Snapshots are written in the byte order of the device, so a
+/// snapshot from a device of the other byte order doesn't have a version that's understood either.
+#define SNAPSHOT_VERSION 1
+
+
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -235,14 +327,34 @@ typedef enum
     NODE_FLAGS_UNSET = 0x0,  ///< No flags have been set.
     NODE_IS_SHADOW   = 0x1,  ///< The node is a shadow for a node in another tree.
     NODE_IS_MODIFIED = 0x2,  ///< This node has been modified.
-    NODE_IS_DELETED  = 0x4   ///< This node has been marked as deleted, the actual deletion will
+    NODE_IS_DELETED  = 0x4,  ///< This node has been marked as deleted, the actual deletion will
                              ///<   take place later.
+    NODE_IS_SHARING  = 0x8   ///< This stem is in a tree version, and its children are yet to be
+                             ///<   copied from its source node.
 }
 NodeFlags_t;
 
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Index of a stem's children by name hash.  Children that land in the same bucket are chained
+ *  through their nextInBucketRef.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef struct ChildIndex
+{
+    size_t sizeClass;                ///< Size class, which is also the pool the index is from.
+    size_t bucketCount;              ///< Number of buckets, always a power of 2.
+    size_t childCount;               ///< Number of children in the index.
+    struct Node* buckets[];          ///< Chains of children, by name hash.
+}
+ChildIndex_t;
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  The Node object structure.
@@ -273,6 +385,20 @@ typedef struct Node
         le_dls_List_t children;      ///< The linked list of children belonging to this node.
     }
     info;                            ///< The actual inforation that this node stores.
+
+    ChildIndex_t* childIndexPtr;     ///< Index of this stem's children, or NULL if the stem
+                                     ///<   doesn't have one.
+
+    struct Node* nextInBucketRef;    ///< Next node in the same bucket of the parent's child index.
+    struct Node** bucketLinkPtr;     ///< What points to this node in the parent's child index, or
+                                     ///<   NULL if the node isn't in an index.
+
+    struct Snapshot* snapshotPtr;    ///< Snapshot this stem's children are yet to be read from, or
+                                     ///<   NULL if they have been read.
+    uint32_t snapshotIndex;          ///< Index of this stem's record in that snapshot.
+
+    struct Node* sourceRef;          ///< For a node in a tree version, the node it was copied from,
+                                     ///<   or NULL once that node may be released.
 }
 Node_t;
 
@@ -293,6 +419,14 @@ typedef struct Tree
     struct Tree* originalTreeRef;         ///< If non-NULL then this points back to the original
                                           ///<   tree this one is shadowing.
 
+    bool isVersion;                       ///< If true, this is a copy of an earlier version of a
+                                          ///<   tree, kept for the read iterators that were on the
+                                          ///<   tree when a change was merged into it.
+    struct Tree* sourceTreeRef;           ///< For a tree version, the tree it still shares nodes
+                                          ///<   with, or NULL if it doesn't share any.
+    le_dls_Link_t versionLink;            ///< Link in that tree's list of versions.
+    le_dls_List_t versionList;            ///< Versions that share nodes with this tree.
+
     char name[MAX_TREE_NAME_BYTES];       ///< The name of this tree.
 
     int revisionId;                       ///< The current revision,
@@ -309,12 +443,108 @@ typedef struct Tree
 
     le_sls_List_t requestList;            ///< Each tree maintains it's own list of pending
                                           ///<   requests.
+
+    size_t revisionSize;                  ///< Size of the current revision file, in bytes.
+    size_t journalSize;                   ///< Size of the current revision's journal, in bytes.
+    le_timer_Ref_t compactTimerRef;       ///< Timer to compact the journal, NULL until needed.
+
+    size_t syncDeferCount;                ///< While non-zero, journal records are held in memory
+                                          ///<   until the matching tdb_SyncTree() calls.
+    char* pendingPtr;                     ///< Journal records waiting to be written, or NULL.
+    size_t pendingSize;                   ///< Size of the records waiting to be written, in bytes.
+
+    size_t commitCount;                   ///< Number of commits written since the tree was loaded.
+    size_t bytesWritten;                  ///< Bytes written for those commits, in journal records
+                                          ///<   and revision files.
 }
 Tree_t;
 
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Header at the start of a snapshot file.  It's followed by the node records, then by the string
+ *  table.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef struct
+{
+    char magic[SNAPSHOT_MAGIC_BYTES];  ///< SNAPSHOT_MAGIC, without a terminating NULL.
+    uint32_t version;                  ///< SNAPSHOT_VERSION.
+    uint32_t recordCount;              ///< Number of node records.  The first one is the root.
+    uint32_t stringsSize;              ///< Size of the string table, in bytes.
+}
+SnapshotHeader_t;
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  A node record of a snapshot.  Records are in breadth first order, so the children of a stem are
+ *  held in consecutive records.  Names and values are NULL terminated strings in the string table.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t type;        ///< The type of the node, a le_cfg_nodeType_t.
+    uint32_t nameOffset;  ///< Offset of the node's name in the string table.
+    uint32_t first;       ///< For a stem, the index of the record of its first child.  For a value,
+                          ///<   the offset of the value in the string table.
+    uint32_t count;       ///< For a stem, the number of children.  For a value, its length.
+}
+SnapshotRecord_t;
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  A snapshot file mapped into memory.  Each stem whose children are yet to be read from the
+ *  snapshot holds a reference to it, and it's unmapped once the last one has been read.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef struct Snapshot
+{
+    void* mapPtr;                        ///< Where the file is mapped.
+    size_t mapSize;                      ///< Size of the mapping, in bytes.
+    const SnapshotRecord_t* recordsPtr;  ///< The node records.
+    uint32_t recordCount;                ///< Number of node records.
+    const char* stringsPtr;              ///< The string table.
+    uint32_t stringsSize;                ///< Size of the string table, in bytes.
+}
+Snapshot_t;
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  A snapshot being written.  The records are built in memory, and the nodes they're for are kept
+ *  alongside them until their children have been added.
+ */
+// -------------------------------------------------------------------------------------------------
+typedef struct
+{
+    tdb_NodeRef_t* nodesPtr;        ///< The node of each record.
+    SnapshotRecord_t* recordsPtr;   ///< The records.
+    size_t recordCount;             ///< Number of records.
+    size_t recordCapacity;          ///< Number of records there's room for.
+
+    char* stringsPtr;               ///< The string table.
+    size_t stringsSize;             ///< Size of the string table, in bytes.
+    size_t stringsCapacity;         ///< Size of the memory allocated for the string table.
+
+    uint32_t* slotsPtr;             ///< Hash table of the strings in the string table.
+    size_t slotCount;               ///< Number of slots in the hash table, a power of 2.
+    size_t stringCount;             ///< Number of strings in the hash table.
+}
+SnapshotWriter_t;
+
+
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Types of lexical tokens that can be found in configuration data files.
@@ -388,6 +618,24 @@ static le_mem_PoolRef_t RegistrationPool = NULL;
 /// Name of the registration pool.
 #define CFG_REGISTRATION_POOL_NAME "RegistrationPool"
 
+/// Pool for the mapped snapshots.
+static le_mem_PoolRef_t SnapshotPool = NULL;
+
+/// Name of the snapshot pool.
+#define CFG_SNAPSHOT_POOL_NAME "SnapshotPool"
+
+/// Pools for the child indexes, one per size class.
+static le_mem_PoolRef_t ChildIndexPools[CHILD_INDEX_SIZE_CLASSES];
+
+/// Names of the child index pools.
+static const char* ChildIndexPoolNames[CHILD_INDEX_SIZE_CLASSES] =
+{
+    "childIndexPool32",
+    "childIndexPool256",
+    "childIndexPool2048",
+    "childIndexPool16384"
+};
+
 /// Name of the binary data pool.
 #define CFG_BINARY_DATA_POOL_NAME "BinaryDataPool"
 
@@ -556,30 +804,16 @@ static void ClearDeletedFlag
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Allocate a new node and fill out it's default information.
- *
- *  @return The newly created node.
+ *  Is this tree version stem still sharing the children of its source node?
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t NewNode
+static bool IsSharing
 (
-    void
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to read.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Create a new blank node.
-    tdb_NodeRef_t newNodeRef = le_mem_ForceAlloc(NodePoolRef);
-
-    newNodeRef->parentRef = NULL;
-    newNodeRef->type = LE_CFG_TYPE_EMPTY;
-    ClearFlags(newNodeRef);
-    newNodeRef->shadowRef = NULL;
-    newNodeRef->nameRef = NULL;
-    newNodeRef->nameHash = 0;
-    newNodeRef->siblingList = LE_DLS_LINK_INIT;
-    memset(&newNodeRef->info, 0, sizeof(newNodeRef->info));
-
-    return newNodeRef;
+    return (nodeRef->flags & NODE_IS_SHARING) != 0;
 }
 
 
@@ -587,63 +821,72 @@ static tdb_NodeRef_t NewNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  The node destructor function.  This will take care of freeing a node's string values and any
- *  children it may have.  Called automaticly by the memory system when a node is released.
+ *  Put a node into the right bucket of a child index.
  */
 // -------------------------------------------------------------------------------------------------
-static void NodeDestructor
+static void InsertIntoBucket
 (
-    void* objectPtr  ///< [IN] The generic object to free.
+    ChildIndex_t* indexPtr,  ///< [IN] The index to update.
+    tdb_NodeRef_t childRef   ///< [IN] The child node to add.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    tdb_NodeRef_t nodeRef = (tdb_NodeRef_t)objectPtr;
+    tdb_NodeRef_t* bucketPtr =
+        &indexPtr->buckets[tdb_GetNodeNameHash(childRef) & (indexPtr->bucketCount - 1)];
 
-    if (nodeRef->nameRef)
+    childRef->nextInBucketRef = *bucketPtr;
+    childRef->bucketLinkPtr = bucketPtr;
+
+    if (*bucketPtr != NULL)
     {
-        dstr_Release(nodeRef->nameRef);
+        (*bucketPtr)->bucketLinkPtr = &childRef->nextInBucketRef;
     }
 
-    switch (nodeRef->type)
-    {
-        case LE_CFG_TYPE_EMPTY:
-        case LE_CFG_TYPE_DOESNT_EXIST:
-            // Nothing to do here.
-            break;
+    *bucketPtr = childRef;
+}
 
-        case LE_CFG_TYPE_STRING:
-        case LE_CFG_TYPE_BOOL:
-        case LE_CFG_TYPE_INT:
-        case LE_CFG_TYPE_FLOAT:
-            if (nodeRef->info.valueRef)
-            {
-                dstr_Release(nodeRef->info.valueRef);
-            }
-            break;
 
-        case LE_CFG_TYPE_STEM:
-            {
-                tdb_NodeRef_t childRef = tdb_GetFirstChildNode(nodeRef);
 
-                while (childRef != NULL)
-                {
-                    tdb_NodeRef_t nextChildRef = tdb_GetNextSiblingNode(childRef);
 
-                    le_mem_Release(childRef);
-                    childRef = nextChildRef;
-                }
-            }
-            break;
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Allocate a child index of a given size class, and put all of a stem's children into it.
+ *
+ *  @return The new index.
+ */
+// -------------------------------------------------------------------------------------------------
+static ChildIndex_t* NewChildIndex
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] The stem to index the children of.
+    size_t sizeClass        ///< [IN] The size class of the new index.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    ChildIndex_t* indexPtr = le_mem_ForceAlloc(ChildIndexPools[sizeClass]);
+    size_t bucketCount = CHILD_INDEX_MIN_BUCKETS;
+    size_t i;
+
+    for (i = 0; i < sizeClass; i++)
+    {
+        bucketCount *= CHILD_INDEX_GROWTH;
     }
 
-    if (nodeRef->parentRef != NULL)
+    indexPtr->sizeClass = sizeClass;
+    indexPtr->bucketCount = bucketCount;
+    indexPtr->childCount = 0;
+    memset(indexPtr->buckets, 0, bucketCount * sizeof(indexPtr->buckets[0]));
+
+    le_dls_Link_t* linkPtr = le_dls_Peek(&nodeRef->info.children);
+
+    while (linkPtr != NULL)
     {
-        LE_ASSERT(nodeRef->parentRef->type == LE_CFG_TYPE_STEM);
-        LE_ASSERT(le_dls_IsEmpty(&nodeRef->parentRef->info.children) == false);
-        LE_ASSERT(le_dls_IsInList(&nodeRef->parentRef->info.children, &nodeRef->siblingList));
+        InsertIntoBucket(indexPtr, CONTAINER_OF(linkPtr, Node_t, siblingList));
+        indexPtr->childCount++;
 
-        le_dls_Remove(&nodeRef->parentRef->info.children, &nodeRef->siblingList);
+        linkPtr = le_dls_PeekNext(&nodeRef->info.children, linkPtr);
     }
+
+    return indexPtr;
 }
 
 
@@ -651,40 +894,24 @@ static void NodeDestructor
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Allocate a new node from our pool, and turn it into a shadow of an existing node.
- *
- *  @return A new node that shadows the existing node.
+ *  Index the children of a stem by name hash, replacing its current index if it has one.
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t NewShadowNode
+static void IndexChildren
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The node to shadow.
+    tdb_NodeRef_t nodeRef,  ///< [IN] The stem to index the children of.
+    size_t sizeClass        ///< [IN] The size class of the index.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Allocate a new blank node.
-    tdb_NodeRef_t newShadowRef = NewNode();
+    ChildIndex_t* oldIndexPtr = nodeRef->childIndexPtr;
 
-    // Turn it into a shadow of the original node.  It's possible for nodeRef to be NULL.  We could
-    // be creating a shadow node for which no original exists.  Which is the case when creating a
-    // new path that didn't exist in the original tree.
-    if (nodeRef != NULL)
-    {
-        newShadowRef->type = nodeRef->type;
-        newShadowRef->flags = nodeRef->flags;
-        newShadowRef->shadowRef = nodeRef;
+    nodeRef->childIndexPtr = NewChildIndex(nodeRef, sizeClass);
 
-        // Now, if the parent node, (if there is a parent node,) is marked as deleted, then do the
-        // same with this new node.
-        if (   (nodeRef->parentRef != NULL)
-            && (IsDeleted(nodeRef->parentRef)))
-        {
-            SetDeletedFlag(newShadowRef);
-        }
+    if (oldIndexPtr != NULL)
+    {
+        le_mem_Release(oldIndexPtr);
     }
-
-    SetShadowFlag(newShadowRef);
-    return newShadowRef;
 }
 
 
@@ -692,48 +919,34 @@ static tdb_NodeRef_t NewShadowNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Create a new node and insert it into the given node's children collection.
- *
- *  @return The newly create node, already inserted into the supplied node's child collection.
+ *  Add a child to its parent's child index, if the parent has one.  The index is moved to the next
+ *  size class once it has more children than buckets.
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t NewChildNode
+static void IndexChild
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The node to be given with a new child.
+    tdb_NodeRef_t childRef  ///< [IN] The child node to add.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // If the node is currently empty, then turn it into a stem.
-    if (nodeRef->type == LE_CFG_TYPE_EMPTY)
+    tdb_NodeRef_t parentRef = childRef->parentRef;
+
+    if (   (parentRef == NULL)
+        || (parentRef->childIndexPtr == NULL))
     {
-        nodeRef->type = LE_CFG_TYPE_STEM;
+        return;
     }
 
-    LE_ASSERT(nodeRef->type == LE_CFG_TYPE_STEM);
-
-    // Create a new node.  Then set it's parent to the given node
-    tdb_NodeRef_t newRef = NewNode();
-
-    newRef->parentRef = nodeRef;
-    newRef->type = LE_CFG_TYPE_EMPTY;
+    ChildIndex_t* indexPtr = parentRef->childIndexPtr;
 
-    // Get the new node to inheret the parent's shadow and deletion flags.
-    if (IsShadow(nodeRef))
-    {
-        SetShadowFlag(newRef);
-        SetDeletedFlag(newRef);
-    }
+    InsertIntoBucket(indexPtr, childRef);
+    indexPtr->childCount++;
 
-    if (IsDeleted(nodeRef))
+    if (   (indexPtr->childCount > indexPtr->bucketCount)
+        && (indexPtr->sizeClass + 1 < CHILD_INDEX_SIZE_CLASSES))
     {
-        SetDeletedFlag(newRef);
+        IndexChildren(parentRef, indexPtr->sizeClass + 1);
     }
-
-    // Now make sure to add the new child node to the end of the parents collection.
-    le_dls_Queue(&nodeRef->info.children, &newRef->siblingList);
-
-    // Finally return the newly created node to the caller.
-    return newRef;
 }
 
 
@@ -741,58 +954,42 @@ static tdb_NodeRef_t NewChildNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Called to shadow a node's collection of children.
+ *  Remove a child from its parent's child index, if it's in one.  The index is dropped once it's
+ *  empty.
  */
 // -------------------------------------------------------------------------------------------------
-static void ShadowChildren
+static void UnindexChild
 (
-    tdb_NodeRef_t shadowParentRef  ///< [IN] The node we're shadowing the children of.
+    tdb_NodeRef_t childRef  ///< [IN] The child node to remove.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // If the parent node isn't a stem then there isn't much else to do here.
-    if (shadowParentRef->type != LE_CFG_TYPE_STEM)
+    if (childRef->bucketLinkPtr == NULL)
     {
         return;
     }
 
-    // Does this node have any children currently?  If yes, then we don't need to do anything else.
-    if (le_dls_IsEmpty(&shadowParentRef->info.children) == false)
-    {
-        return;
-    }
+    *childRef->bucketLinkPtr = childRef->nextInBucketRef;
 
-    // Has this node been modified?  If so, then the shadow children may have been cleared from
-    // this collection.
-    if (IsModified(shadowParentRef) == true)
+    if (childRef->nextInBucketRef != NULL)
     {
-        return;
+        childRef->nextInBucketRef->bucketLinkPtr = childRef->bucketLinkPtr;
     }
 
-    // This node has no shadow children.  So what we do now is check the original node... Does it
-    // have any children?  If it does, we simply recreate the whole collection now.  (We do not
-    // recurse into the grandchildren though.)  Doing this now makes life simpler, instead of doing
-    // this piecemeal and possibly out of order.
-    tdb_NodeRef_t originalRef = shadowParentRef->shadowRef;
-
-    if (   (originalRef == NULL)
-        || (originalRef->type != LE_CFG_TYPE_STEM))
-    {
-        return;
-    }
+    childRef->nextInBucketRef = NULL;
+    childRef->bucketLinkPtr = NULL;
 
-    // Simply iterate through the original collection and add a new shadow child to our own
-    // collection.
-    tdb_NodeRef_t originalChildRef = tdb_GetFirstChildNode(originalRef);
+    tdb_NodeRef_t parentRef = childRef->parentRef;
 
-    while (originalChildRef != NULL)
-    {
-        tdb_NodeRef_t newShadowRef = NewShadowNode(originalChildRef);
-        newShadowRef->parentRef = shadowParentRef;
+    LE_ASSERT(parentRef != NULL);
+    LE_ASSERT(parentRef->childIndexPtr != NULL);
 
-        le_dls_Queue(&shadowParentRef->info.children, &newShadowRef->siblingList);
+    parentRef->childIndexPtr->childCount--;
 
-        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
+    if (parentRef->childIndexPtr->childCount == 0)
+    {
+        le_mem_Release(parentRef->childIndexPtr);
+        parentRef->childIndexPtr = NULL;
     }
 }
 
@@ -801,24 +998,18 @@ static void ShadowChildren
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Search up through a node tree until we find the root node.
+ *  Add a node to the end of a stem's child list, and to its child index if it has one.
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t GetRootParentNode
+static void AddChild
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] Find the greatest grand parent of this node.
+    tdb_NodeRef_t nodeRef,  ///< [IN] The stem to add the child to.
+    tdb_NodeRef_t childRef  ///< [IN] The new child node.  Its parentRef must already be set.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    tdb_NodeRef_t parentRef = NULL;
-
-    while (nodeRef != NULL)
-    {
-        parentRef = nodeRef;
-        nodeRef = tdb_GetNodeParent(nodeRef);
-    }
-
-    return parentRef;
+    le_dls_Queue(&nodeRef->info.children, &childRef->siblingList);
+    IndexChild(childRef);
 }
 
 
@@ -826,62 +1017,85 @@ static tdb_NodeRef_t GetRootParentNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Called to look for a named child in a given node's child collection.
+ *  Allocate a new node and fill out it's default information.
  *
- *  @return Reference to the found child node, or NULL if a node was not found.
+ *  @return The newly created node.
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t GetNamedChild
+static tdb_NodeRef_t NewNode
 (
-    tdb_NodeRef_t nodeRef,  ///< [IN] The node to search.
-    const char* nameRef     ///< [IN] The name we're searching for.
+    void
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Is this one of the "special" names?
-    if (strcmp(nameRef, ".") == 0)
-    {
-        return nodeRef;
-    }
+    // Create a new blank node.
+    tdb_NodeRef_t newNodeRef = le_mem_ForceAlloc(NodePoolRef);
 
-    if (strcmp(nameRef, "..") == 0)
-    {
-        return nodeRef->parentRef;
-    }
+    newNodeRef->parentRef = NULL;
+    newNodeRef->type = LE_CFG_TYPE_EMPTY;
+    ClearFlags(newNodeRef);
+    newNodeRef->shadowRef = NULL;
+    newNodeRef->nameRef = NULL;
+    newNodeRef->nameHash = 0;
+    newNodeRef->siblingList = LE_DLS_LINK_INIT;
+    memset(&newNodeRef->info, 0, sizeof(newNodeRef->info));
+    newNodeRef->childIndexPtr = NULL;
+    newNodeRef->nextInBucketRef = NULL;
+    newNodeRef->bucketLinkPtr = NULL;
+    newNodeRef->snapshotPtr = NULL;
+    newNodeRef->snapshotIndex = 0;
+    newNodeRef->sourceRef = NULL;
 
-    // If the current node isn't a stem, then this node can't have any children.
-    if (nodeRef->type != LE_CFG_TYPE_STEM)
-    {
-        return NULL;
-    }
+    return newNodeRef;
+}
 
-    // Search the child list for a node with the given name.
-    tdb_NodeRef_t currentRef = tdb_GetFirstChildNode(nodeRef);
-    char currentNameRef[LE_CFG_NAME_LEN_BYTES] = "";
-    size_t stringHash = le_hashmap_HashString(nameRef);
-    size_t nodeHash;
 
-    while (currentRef != NULL)
-    {
-        nodeHash = tdb_GetNodeNameHash(currentRef);
 
-        // if the hash doesn't match, the name is different. If the hash matches, there is
-        // a small possibility of collision, and the string comparison is required.
-        if (stringHash == nodeHash)
-        {
-            tdb_GetNodeName(currentRef, currentNameRef, sizeof(currentNameRef));
 
-            if (strncmp(currentNameRef, nameRef, sizeof(currentNameRef)) == 0)
-            {
-                return currentRef;
-            }
-        }
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Give a node the contents of a snapshot record.  A stem keeps a reference to the snapshot, and
+ *  its children are only read when they're first needed.  The node must be empty.
+ */
+// -------------------------------------------------------------------------------------------------
+static void ReadSnapshotNode
+(
+    tdb_NodeRef_t nodeRef,    ///< [IN] The node to fill out.
+    Snapshot_t* snapshotPtr,  ///< [IN] The snapshot to read from.
+    uint32_t index            ///< [IN] Index of the node's record.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    const SnapshotRecord_t* recordPtr = &snapshotPtr->recordsPtr[index];
 
-        currentRef = tdb_GetNextSiblingNode(currentRef);
+    switch (recordPtr->type)
+    {
+        case LE_CFG_TYPE_EMPTY:
+            break;
+
+        case LE_CFG_TYPE_STEM:
+            nodeRef->type = LE_CFG_TYPE_STEM;
+            nodeRef->info.children = LE_DLS_LIST_INIT;
+            nodeRef->snapshotPtr = snapshotPtr;
+            nodeRef->snapshotIndex = index;
+            le_mem_AddRef(snapshotPtr);
+            break;
+
+        default:
+            nodeRef->type = recordPtr->type;
+            nodeRef->info.valueRef = dstr_NewFromCstr(snapshotPtr->stringsPtr + recordPtr->first);
+            break;
     }
 
-    // Looks like there was no node to return.
-    return NULL;
+    // Like nodes read from a text file, nodes read into a shadow tree have to be merged.
+    if (IsShadow(nodeRef) == false)
+    {
+        ClearModifiedFlag(nodeRef);
+    }
+    else
+    {
+        SetModifiedFlag(nodeRef);
+    }
 }
 
 
@@ -889,73 +1103,71 @@ static tdb_NodeRef_t GetNamedChild
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Called to create a named child in a nodes child collection.  However, this function will only
- *  create nodes on shadow trees.
- *
- *  @return Reference to newly created child node, or NULL if it can not be created.
+ *  If a stem's children are yet to be read from a snapshot, read them now.  Their own children are
+ *  left in the snapshot until they're needed.
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t CreateNamedChild
+static void ReadSnapshotChildren
 (
-    tdb_NodeRef_t nodeRef,  ///< [IN] The node to search.
-    const char* nameRef     ///< [IN] The name we're searching for.
+    tdb_NodeRef_t nodeRef  ///< [IN] The stem to read the children of.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    tdb_NodeRef_t childRef = NULL;
+    Snapshot_t* snapshotPtr = nodeRef->snapshotPtr;
 
-    if (IsShadow(nodeRef) == true)
+    if (snapshotPtr == NULL)
     {
-        // If the node isn't a stem, then convert it into an empty one now.
-        if (   (nodeRef->type != LE_CFG_TYPE_STEM)
-            && (nodeRef->type != LE_CFG_TYPE_EMPTY))
-        {
-            tdb_SetEmpty(nodeRef);
-            nodeRef->type = LE_CFG_TYPE_STEM;
-            nodeRef->info.children = LE_DLS_LIST_INIT;
-        }
+        return;
+    }
 
-        // Create the node, and set it's deleted flag as it hasn't been used for anything yet.
-        childRef = NewChildNode(nodeRef);
-        SetDeletedFlag(childRef);
+    const SnapshotRecord_t* recordPtr = &snapshotPtr->recordsPtr[nodeRef->snapshotIndex];
+    uint32_t i;
 
-        // Set the name of the new node, if that fails then the user had given us a bad name for the
-        // new node.  So in that case free the node and return NULL.
-        if (tdb_SetNodeName(childRef, nameRef) != LE_OK)
+    nodeRef->snapshotPtr = NULL;
+
+    for (i = 0; i < recordPtr->count; i++)
+    {
+        const char* namePtr =
+            snapshotPtr->stringsPtr + snapshotPtr->recordsPtr[recordPtr->first + i].nameOffset;
+        tdb_NodeRef_t childRef = NewNode();
+
+        childRef->parentRef = nodeRef;
+        childRef->nameRef = dstr_NewFromCstr(namePtr);
+        childRef->nameHash = le_hashmap_HashString(namePtr);
+
+        if (IsShadow(nodeRef))
         {
-            le_mem_Release(childRef);
-            childRef = NULL;
+            SetShadowFlag(childRef);
         }
+
+        // The stem can't have a child index yet, as its children have never been looked up.
+        le_dls_Queue(&nodeRef->info.children, &childRef->siblingList);
+
+        ReadSnapshotNode(childRef, snapshotPtr, recordPtr->first + i);
     }
 
-    return childRef;
+    le_mem_Release(snapshotPtr);
 }
 
 
+
+
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check the given node type and see if it should have a string value.
- *
- *  @return True if the given node could hold a string value.  False if not.
+ *  Drop the snapshot a stem's children were yet to be read from, if there is one.
  */
 // -------------------------------------------------------------------------------------------------
-static bool IsStringType
+static void DropSnapshot
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The node to read.
+    tdb_NodeRef_t nodeRef  ///< [IN] The stem being cleared.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    le_cfg_nodeType_t type = tdb_GetNodeType(nodeRef);
-
-    if (   (type == LE_CFG_TYPE_STRING)
-        || (type == LE_CFG_TYPE_BOOL)
-        || (type == LE_CFG_TYPE_INT)
-        || (type == LE_CFG_TYPE_FLOAT))
+    if (nodeRef->snapshotPtr != NULL)
     {
-        return true;
+        le_mem_Release(nodeRef->snapshotPtr);
+        nodeRef->snapshotPtr = NULL;
     }
-
-    return false;
 }
 
 
@@ -963,33 +1175,72 @@ static bool IsStringType
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  This function will copy a string value from an original tree node into a node that has shadowed
- *  it.
+ *  The node destructor function.  This will take care of freeing a node's string values and any
+ *  children it may have.  Called automaticly by the memory system when a node is released.
  */
 // -------------------------------------------------------------------------------------------------
-static void PropagateValue
+static void NodeDestructor
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The node ref to update.
+    void* objectPtr  ///< [IN] The generic object to free.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // If the node doesn't even have a ref to an original node, then there's nothing left to do
-    // here.
-    tdb_NodeRef_t shadowRef = nodeRef->shadowRef;
+    tdb_NodeRef_t nodeRef = (tdb_NodeRef_t)objectPtr;
 
-    if (shadowRef == NULL)
+    if (nodeRef->nameRef)
     {
-        return;
+        dstr_Release(nodeRef->nameRef);
     }
 
-    // Ok, figure out the type for this node.  If it has a value, and the original
-    if (   (IsStringType(nodeRef) == true)
-        && (IsStringType(shadowRef) == true)
-        && (nodeRef->info.valueRef == NULL)
-        && (shadowRef->info.valueRef != NULL))
+    switch (nodeRef->type)
     {
-        // Looks like the value hasn't been propagated or changed yet.  So, do so now.
-        nodeRef->info.valueRef = dstr_NewFromDstr(shadowRef->info.valueRef);
+        case LE_CFG_TYPE_EMPTY:
+        case LE_CFG_TYPE_DOESNT_EXIST:
+            // Nothing to do here.
+            break;
+
+        case LE_CFG_TYPE_STRING:
+        case LE_CFG_TYPE_BOOL:
+        case LE_CFG_TYPE_INT:
+        case LE_CFG_TYPE_FLOAT:
+            if (nodeRef->info.valueRef)
+            {
+                dstr_Release(nodeRef->info.valueRef);
+            }
+            break;
+
+        case LE_CFG_TYPE_STEM:
+            {
+                // Children still in a snapshot don't have to be read just to be released.
+                DropSnapshot(nodeRef);
+
+                tdb_NodeRef_t childRef = tdb_GetFirstChildNode(nodeRef);
+
+                while (childRef != NULL)
+                {
+                    tdb_NodeRef_t nextChildRef = tdb_GetNextSiblingNode(childRef);
+
+                    le_mem_Release(childRef);
+                    childRef = nextChildRef;
+                }
+            }
+            break;
+    }
+
+    if (nodeRef->parentRef != NULL)
+    {
+        LE_ASSERT(nodeRef->parentRef->type == LE_CFG_TYPE_STEM);
+        LE_ASSERT(le_dls_IsEmpty(&nodeRef->parentRef->info.children) == false);
+        LE_ASSERT(le_dls_IsInList(&nodeRef->parentRef->info.children, &nodeRef->siblingList));
+
+        UnindexChild(nodeRef);
+        le_dls_Remove(&nodeRef->parentRef->info.children, &nodeRef->siblingList);
+    }
+
+    // Releasing the last child normally drops the child index, but make sure it can't leak.
+    if (nodeRef->childIndexPtr != NULL)
+    {
+        le_mem_Release(nodeRef->childIndexPtr);
     }
 }
 
@@ -998,117 +1249,92 @@ static void PropagateValue
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Merge a shadow node with the original it represents.
+ *  Allocate a new node from our pool, and turn it into a shadow of an existing node.
+ *
+ *  @return A new node that shadows the existing node.
  */
 // -------------------------------------------------------------------------------------------------
-static void MergeNode
+static tdb_NodeRef_t NewShadowNode
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The shadow node to merge.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to shadow.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    LE_ASSERT(nodeRef != NULL);
+    // Allocate a new blank node.
+    tdb_NodeRef_t newShadowRef = NewNode();
 
-    // If this shadow node for some reason doesn't have a ref check for an original version of it in
-    // the original tree.  This shadow node may have been destroyed and re-created loosing this
-    // link.
-    if (nodeRef->shadowRef == NULL)
+    // Turn it into a shadow of the original node.  It's possible for nodeRef to be NULL.  We could
+    // be creating a shadow node for which no original exists.  Which is the case when creating a
+    // new path that didn't exist in the original tree.
+    if (nodeRef != NULL)
     {
-        tdb_NodeRef_t shadowedParentRef = tdb_GetNodeParent(nodeRef)->shadowRef;
+        newShadowRef->type = nodeRef->type;
+        newShadowRef->flags = nodeRef->flags;
+        newShadowRef->shadowRef = nodeRef;
 
-        if (shadowedParentRef != NULL)
+        // Now, if the parent node, (if there is a parent node,) is marked as deleted, then do the
+        // same with this new node.
+        if (   (nodeRef->parentRef != NULL)
+            && (IsDeleted(nodeRef->parentRef)))
         {
-            char name[LE_CFG_NAME_LEN_BYTES] = "";
-
-            tdb_GetNodeName(nodeRef, name, sizeof(name));
-            nodeRef->shadowRef = GetNamedChild(shadowedParentRef, name);
+            SetDeletedFlag(newShadowRef);
         }
     }
 
-    // If this node has been marked as deleted, then simply drop the original node and move on.
-    if (IsDeleted(nodeRef))
-    {
-        if (   (nodeRef->shadowRef != NULL)
-            && (tdb_GetNodeParent(nodeRef->shadowRef) != NULL))
-        {
-            le_mem_Release(nodeRef->shadowRef);
-        }
-        else
-        {
-            // We delete every node but the root node.  Since this is the root node, we just need
-            // to clear it out.
-            tdb_SetEmpty(nodeRef->shadowRef);
-        }
-
-        return;
-    }
-
-    // If the original node doesn't exist, create it now.
-    tdb_NodeRef_t originalRef = nodeRef->shadowRef;
+    SetShadowFlag(newShadowRef);
+    return newShadowRef;
+}
 
-    if (originalRef == NULL)
-    {
-        LE_ASSERT(nodeRef->parentRef != NULL);
-        LE_ASSERT(nodeRef->parentRef->shadowRef != NULL);
 
-        nodeRef->shadowRef = originalRef = NewChildNode(nodeRef->parentRef->shadowRef);
-    }
 
-    ClearModifiedFlag(originalRef);
 
-    // If the name has been changed, then copy it over now.
-    if (dstr_IsNullOrEmpty(nodeRef->nameRef) == false)
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Create a new node and insert it into the given node's children collection.
+ *
+ *  @return The newly create node, already inserted into the supplied node's child collection.
+ */
+// -------------------------------------------------------------------------------------------------
+static tdb_NodeRef_t NewChildNode
+(
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to be given with a new child.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // If the node is currently empty, then turn it into a stem.
+    if (nodeRef->type == LE_CFG_TYPE_EMPTY)
     {
-        if (originalRef->nameRef != NULL)
-        {
-            dstr_Copy(originalRef->nameRef, nodeRef->nameRef);
-        }
-        else
-        {
-            originalRef->nameRef = dstr_NewFromDstr(nodeRef->nameRef);
-        }
-        originalRef->nameHash = nodeRef->nameHash;
+        nodeRef->type = LE_CFG_TYPE_STEM;
     }
 
-    // Check the types of the original and the shadow nodes.  If the new node has been cleared,
-    // then clear out the original node.  If the types have changed, then clear out the original so
-    // that we can properly populate it again.
-    le_cfg_nodeType_t nodeType = tdb_GetNodeType(nodeRef);
+    LE_ASSERT(nodeRef->type == LE_CFG_TYPE_STEM);
 
-    if (   (nodeType == LE_CFG_TYPE_EMPTY)
-        || (nodeType != originalRef->type))
+    // The new node goes after the children that are still in a snapshot.
+    ReadSnapshotChildren(nodeRef);
+
+    // Create a new node.  Then set it's parent to the given node
+    tdb_NodeRef_t newRef = NewNode();
+
+    newRef->parentRef = nodeRef;
+    newRef->type = LE_CFG_TYPE_EMPTY;
+
+    // Get the new node to inheret the parent's shadow and deletion flags.
+    if (IsShadow(nodeRef))
     {
-        tdb_SetEmpty(originalRef);
+        SetShadowFlag(newRef);
+        SetDeletedFlag(newRef);
     }
 
-    // Ok, we know that the node hasn't been deleted.  Check to see if it's considered empty and
-    // that it isn't a stem.  If not, then copy over the string value.
-    if (   (nodeType != LE_CFG_TYPE_EMPTY)
-        && (nodeType != LE_CFG_TYPE_STEM))
+    if (IsDeleted(nodeRef))
     {
-        if (nodeRef->info.valueRef != NULL)
-        {
-            if (originalRef->info.valueRef != NULL)
-            {
-                dstr_Copy(originalRef->info.valueRef, nodeRef->info.valueRef);
-            }
-            else
-            {
-                originalRef->info.valueRef = dstr_NewFromDstr(nodeRef->info.valueRef);
-            }
-
-            // Propigate over the type as that may have changed, like going from an int value to a
-            // bool value.
-
-            originalRef->type = nodeRef->type;
-        }
+        SetDeletedFlag(newRef);
     }
 
-    // Now at this point, if both the original and the shadow node are stems, we'll let the function
-    // InternalMergeTree take care of the children, (if any.)
+    // Now make sure to add the new child node to the end of the parents collection.
+    AddChild(nodeRef, newRef);
 
-    // If the original has been cleared out, we can still just rely on InternalMergeTree to
-    // propigate over the new nodes.
+    // Finally return the newly created node to the caller.
+    return newRef;
 }
 
 
@@ -1116,77 +1342,119 @@ static void MergeNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Called to fire any callbacks registered on the given node path.  If nothing is registered on the
- *  given path, nothing happens.
+ *  Called to shadow a node's collection of children.
  */
 // -------------------------------------------------------------------------------------------------
-static void TriggerCallbacks
+static void ShadowChildren
 (
-    le_pathIter_Ref_t pathRef  ///< [IN] The path to search for callback registrations.
+    tdb_NodeRef_t shadowParentRef  ///< [IN] The node we're shadowing the children of.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Read the path out of the buffer.
-    char pathBuffer[CFG_MAX_PATH_SIZE] = { 0 };
-    if (le_pathIter_GetPath(pathRef, pathBuffer, sizeof(pathBuffer)) != LE_OK)
+    // If the parent node isn't a stem then there isn't much else to do here.
+    if (shadowParentRef->type != LE_CFG_TYPE_STEM)
     {
-        LE_ERROR("Callback path buffer overflow.");
         return;
     }
 
-    // Try to find a registration object for this path.  If one is found, flag it for calling once
-    // the merge is complete.
-    Registration_t* foundRegistrationPtr = le_hashmap_Get(HandlerRegistrationMap, pathBuffer);
+    // Does this node have any children currently?  If yes, then we don't need to do anything else.
+    if (le_dls_IsEmpty(&shadowParentRef->info.children) == false)
+    {
+        return;
+    }
 
-    if (foundRegistrationPtr != NULL)
+    // Has this node been modified?  If so, then the shadow children may have been cleared from
+    // this collection.
+    if (IsModified(shadowParentRef) == true)
     {
-        foundRegistrationPtr->triggered = true;
+        return;
     }
-}
 
+    // This node has no shadow children.  So what we do now is check the original node... Does it
+    // have any children?  If it does, we simply recreate the whole collection now.  (We do not
+    // recurse into the grandchildren though.)  Doing this now makes life simpler, instead of doing
+    // this piecemeal and possibly out of order.
+    tdb_NodeRef_t originalRef = shadowParentRef->shadowRef;
+
+    if (   (originalRef == NULL)
+        || (originalRef->type != LE_CFG_TYPE_STEM))
+    {
+        return;
+    }
+
+    // Simply iterate through the original collection and add a new shadow child to our own
+    // collection.
+    tdb_NodeRef_t originalChildRef = tdb_GetFirstChildNode(originalRef);
+
+    while (originalChildRef != NULL)
+    {
+        tdb_NodeRef_t newShadowRef = NewShadowNode(originalChildRef);
+        newShadowRef->parentRef = shadowParentRef;
+
+        AddChild(shadowParentRef, newShadowRef);
+
+        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
+    }
+}
 
 
 
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Go through all of the registered event callbacks, and fire the call backs for each of the
- *  registrations that has been makred as triggered.
+ *  Make a copy of a node for a tree version.  If the node is a stem, the copy shares its children,
+ *  or the snapshot they're still in.
  *
- *  Once this is done, the triggered flag is cleared for next time.
+ *  @return The new copy of the node, without a parent.
  */
 // -------------------------------------------------------------------------------------------------
-static void FireTriggeredCallbacks
+static tdb_NodeRef_t NewVersionNode
 (
-    void
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to copy.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Go through the registration map.
-    le_hashmap_It_Ref_t handlerIterRef = le_hashmap_GetIterator(HandlerRegistrationMap);
+    tdb_NodeRef_t copyRef = NewNode();
 
-    while (le_hashmap_NextNode(handlerIterRef) == LE_OK)
+    copyRef->type = nodeRef->type;
+    copyRef->nameHash = nodeRef->nameHash;
+    copyRef->sourceRef = nodeRef;
+
+    if (nodeRef->nameRef != NULL)
     {
-        // For each registration, check to see if it was triggered.
-        Registration_t* registrationPtr = (Registration_t*)le_hashmap_GetValue(handlerIterRef);
+        copyRef->nameRef = dstr_NewFromDstr(nodeRef->nameRef);
+    }
 
-        if (registrationPtr->triggered)
-        {
-            // This registration has been triggered, so call all of the handlers attached to it.
-            le_dls_Link_t* linkPtr = le_dls_Peek(&registrationPtr->handlerList);
+    switch (nodeRef->type)
+    {
+        case LE_CFG_TYPE_EMPTY:
+        case LE_CFG_TYPE_DOESNT_EXIST:
+            break;
 
-            while (linkPtr != NULL)
-            {
-                Handler_t* handlerObjectPtr = CONTAINER_OF(linkPtr, Handler_t, link);
+        case LE_CFG_TYPE_STEM:
+            copyRef->info.children = LE_DLS_LIST_INIT;
 
-                handlerObjectPtr->handlerPtr(handlerObjectPtr->contextPtr);
-                linkPtr = le_dls_PeekNext(&registrationPtr->handlerList, linkPtr);
+            if (nodeRef->snapshotPtr != NULL)
+            {
+                copyRef->snapshotPtr = nodeRef->snapshotPtr;
+                copyRef->snapshotIndex = nodeRef->snapshotIndex;
+                le_mem_AddRef(copyRef->snapshotPtr);
+            }
+            else
+            {
+                copyRef->flags |= NODE_IS_SHARING;
             }
+            break;
 
-            // Now that that's done, clear the triggered flag.
-            registrationPtr->triggered = false;
-        }
+        default:
+            if (nodeRef->info.valueRef != NULL)
+            {
+                copyRef->info.valueRef = dstr_NewFromDstr(nodeRef->info.valueRef);
+            }
+            break;
     }
+
+    return copyRef;
 }
 
 
@@ -1194,39 +1462,35 @@ static void FireTriggeredCallbacks
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check the given node to see if it was renamed.
- *
- *  @return True if the node was renamed within this transaction.  False if not.
+ *  If a tree version stem still shares the children of its source node, copy them now.  Their own
+ *  children are shared until they're needed.
  */
 // -------------------------------------------------------------------------------------------------
-static bool WasRenamed
+static void CopyVersionChildren
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] Check this node to see if it was renamed in this transaction.
+    tdb_NodeRef_t nodeRef  ///< [IN] The stem to copy the children of.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    if (IsModified(nodeRef) == false)
+    if (IsSharing(nodeRef) == false)
     {
-        // The node wasn't even modified, so it can not have been renamed.
-        return false;
+        return;
     }
 
-    if (nodeRef->shadowRef == NULL)
-    {
-        // If the node doesn't have a shadow reference, then most likely this is a new node and not
-        // a rename of an existing one.
-        return false;
-    }
+    nodeRef->flags &= ~NODE_IS_SHARING;
 
-    if (nodeRef->nameRef == NULL)
+    tdb_NodeRef_t sourceChildRef = tdb_GetFirstChildNode(nodeRef->sourceRef);
+
+    while (sourceChildRef != NULL)
     {
-        // The shadow node does not have a local copy of a name, so it can not have been renamed.
-        // It must have been modified for other reasons.
-        return false;
-    }
+        tdb_NodeRef_t childRef = NewVersionNode(sourceChildRef);
 
-    // Looks like the node has a new name.
-    return true;
+        // The stem can't have a child index yet, as its children have never been looked up.
+        childRef->parentRef = nodeRef;
+        le_dls_Queue(&nodeRef->info.children, &childRef->siblingList);
+
+        sourceChildRef = tdb_GetNextSiblingNode(sourceChildRef);
+    }
 }
 
 
@@ -1234,26 +1498,31 @@ static bool WasRenamed
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check the original non-shadow node to see if it will need to be cleared during the merge.
- *
- *  @return True if the merge will clear out the original value.  False if not.
+ *  Copy everything a tree version node still shares with its source node, so that the source node
+ *  and its children can be changed or released.
  */
 // -------------------------------------------------------------------------------------------------
-static bool OriginalToBeCleared
+static void CopyVersionTree
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] The shadow node to check.
+    tdb_NodeRef_t nodeRef  ///< [IN] The tree version node to copy the children of.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    le_cfg_nodeType_t nodeType = tdb_GetNodeType(nodeRef);
-
-    if (   (nodeType == LE_CFG_TYPE_EMPTY)
-        || (nodeType != tdb_GetNodeType(nodeRef->shadowRef)))
+    if (nodeRef->type == LE_CFG_TYPE_STEM)
     {
-        return true;
+        CopyVersionChildren(nodeRef);
+
+        // Children still in a snapshot don't share anything, and don't have to be read.
+        le_dls_Link_t* linkPtr = le_dls_Peek(&nodeRef->info.children);
+
+        while (linkPtr != NULL)
+        {
+            CopyVersionTree(CONTAINER_OF(linkPtr, Node_t, siblingList));
+            linkPtr = le_dls_PeekNext(&nodeRef->info.children, linkPtr);
+        }
     }
 
-    return false;
+    nodeRef->sourceRef = NULL;
 }
 
 
@@ -1261,27 +1530,24 @@ static bool OriginalToBeCleared
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Append the name of a node onto the end of a path object.
+ *  Search up through a node tree until we find the root node.
  */
 // -------------------------------------------------------------------------------------------------
-static void AppendNodeName
+static tdb_NodeRef_t GetRootParentNode
 (
-    le_pathIter_Ref_t pathRef,  ///< [IN] The path we're appending to.
-    tdb_NodeRef_t nodeRef       ///< [IN] The node we're appending.
+    tdb_NodeRef_t nodeRef  ///< [IN] Find the greatest grand parent of this node.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    char nodeName[LE_CFG_NAME_LEN_BYTES] = "";
+    tdb_NodeRef_t parentRef = NULL;
 
-    LE_ASSERT(tdb_GetNodeName(nodeRef, nodeName, sizeof(nodeName)) == LE_OK);
-    le_result_t result = le_pathIter_Append(pathRef, nodeName);
+    while (nodeRef != NULL)
+    {
+        parentRef = nodeRef;
+        nodeRef = tdb_GetNodeParent(nodeRef);
+    }
 
-    LE_WARN_IF(result != LE_OK,
-               "Could not append node '%s' onto the update callback tracking path.  "
-               "Reason: %d, '%s'.",
-               nodeName,
-               result,
-               LE_RESULT_TXT(result));
+    return parentRef;
 }
 
 
@@ -1289,45 +1555,94 @@ static void AppendNodeName
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Create a new config path for the tree name given.
+ *  Called to look for a named child in a given node's child collection.
  *
- *  @return A new config path, rooted on the given tree.
+ *  @return Reference to the found child node, or NULL if a node was not found.
  */
 // -------------------------------------------------------------------------------------------------
-static le_pathIter_Ref_t CreateBasePath
+static tdb_NodeRef_t GetNamedChild
 (
-    const char* treeNamePtr  ///< [IN] The tree name to use for the new path object.
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node to search.
+    const char* nameRef     ///< [IN] The name we're searching for.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    char basePath[CFG_MAX_PATH_SIZE] = { 0 };
+    // Is this one of the "special" names?
+    if (strcmp(nameRef, ".") == 0)
+    {
+        return nodeRef;
+    }
 
-    snprintf(basePath, sizeof(basePath), "%s:/", treeNamePtr);
-    return le_pathIter_CreateForUnix(basePath);
-}
+    if (strcmp(nameRef, "..") == 0)
+    {
+        return nodeRef->parentRef;
+    }
 
+    // If the current node isn't a stem, then this node can't have any children.
+    if (nodeRef->type != LE_CFG_TYPE_STEM)
+    {
+        return NULL;
+    }
 
+    char currentNameRef[LE_CFG_NAME_LEN_BYTES] = "";
+    size_t stringHash = le_hashmap_HashString(nameRef);
+    size_t nodeHash;
 
+    // If the children are indexed, only search the bucket the name hashes to.
+    if (nodeRef->childIndexPtr != NULL)
+    {
+        ChildIndex_t* indexPtr = nodeRef->childIndexPtr;
+        tdb_NodeRef_t currentRef = indexPtr->buckets[stringHash & (indexPtr->bucketCount - 1)];
 
-// -------------------------------------------------------------------------------------------------
-/**
- *  Generate a config path to the given node.
- */
-// -------------------------------------------------------------------------------------------------
-static void GeneratePath
-(
-    le_pathIter_Ref_t pathRef,  ///< [IN] The path object we're updating.
-    tdb_NodeRef_t nodeRef       ///< [IN] The node we're creating a path for.
-)
-// -------------------------------------------------------------------------------------------------
-{
-    if (nodeRef == NULL)
+        while (currentRef != NULL)
+        {
+            if (stringHash == tdb_GetNodeNameHash(currentRef))
+            {
+                tdb_GetNodeName(currentRef, currentNameRef, sizeof(currentNameRef));
+
+                if (strncmp(currentNameRef, nameRef, sizeof(currentNameRef)) == 0)
+                {
+                    return currentRef;
+                }
+            }
+
+            currentRef = currentRef->nextInBucketRef;
+        }
+
+        return NULL;
+    }
+
+    // Search the child list for a node with the given name.
+    tdb_NodeRef_t currentRef = tdb_GetFirstChildNode(nodeRef);
+    size_t childCount = 0;
+
+    while (currentRef != NULL)
     {
-        return;
+        nodeHash = tdb_GetNodeNameHash(currentRef);
+
+        // if the hash doesn't match, the name is different. If the hash matches, there is
+        // a small possibility of collision, and the string comparison is required.
+        if (stringHash == nodeHash)
+        {
+            tdb_GetNodeName(currentRef, currentNameRef, sizeof(currentNameRef));
+
+            if (strncmp(currentNameRef, nameRef, sizeof(currentNameRef)) == 0)
+            {
+                break;
+            }
+        }
+
+        currentRef = tdb_GetNextSiblingNode(currentRef);
+        childCount++;
     }
 
-    GeneratePath(pathRef, nodeRef->parentRef);
-    AppendNodeName(pathRef, nodeRef);
+    // That was a long search, so index the children for next time.
+    if (childCount >= CHILD_INDEX_THRESHOLD)
+    {
+        IndexChildren(nodeRef, 0);
+    }
+
+    return currentRef;
 }
 
 
@@ -1335,118 +1650,107 @@ static void GeneratePath
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Trigger callbacks for this node and all of it's children.
+ *  Called to create a named child in a nodes child collection.  However, this function will only
+ *  create nodes on shadow trees.
+ *
+ *  @return Reference to newly created child node, or NULL if it can not be created.
  */
 // -------------------------------------------------------------------------------------------------
-static void FireAllChildren
+static tdb_NodeRef_t CreateNamedChild
 (
-    le_pathIter_Ref_t pathRef,  ///< [IN] Path to the parent of the current node.
-    tdb_NodeRef_t nodeRef       ///< [IN] Node and any children to merge.
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node to search.
+    const char* nameRef     ///< [IN] The name we're searching for.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Add this node to the path we're using to find registered callbacks.
-    AppendNodeName(pathRef, nodeRef);
+    tdb_NodeRef_t childRef = NULL;
 
-    // If the node is a stem then traverse it's children and try to trigger callbacks for them.  If
-    // there are no callbacks registered for those nodes, then nothing will happen.
-    if (nodeRef->type == LE_CFG_TYPE_STEM)
+    if (IsShadow(nodeRef) == true)
     {
-        tdb_NodeRef_t childRef = tdb_GetFirstChildNode(nodeRef);
+        // If the node isn't a stem, then convert it into an empty one now.
+        if (   (nodeRef->type != LE_CFG_TYPE_STEM)
+            && (nodeRef->type != LE_CFG_TYPE_EMPTY))
+        {
+            tdb_SetEmpty(nodeRef);
+            nodeRef->type = LE_CFG_TYPE_STEM;
+            nodeRef->info.children = LE_DLS_LIST_INIT;
+        }
 
-        while (childRef != NULL)
+        // Create the node, and set it's deleted flag as it hasn't been used for anything yet.
+        childRef = NewChildNode(nodeRef);
+        SetDeletedFlag(childRef);
+
+        // Set the name of the new node, if that fails then the user had given us a bad name for the
+        // new node.  So in that case free the node and return NULL.
+        if (tdb_SetNodeName(childRef, nameRef) != LE_OK)
         {
-            FireAllChildren(pathRef, childRef);
-            childRef = tdb_GetNextSiblingNode(childRef);
+            le_mem_Release(childRef);
+            childRef = NULL;
         }
     }
 
-    // Like with the children, try to do the same for this node.  Then remove this node from the
-    // tracking path.
-    TriggerCallbacks(pathRef);
-    le_pathIter_Truncate(pathRef);
+    return childRef;
 }
 
 
-
-
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check a given shadow node and the original node it's shadowing.  If the original has children
- *  that will be lost because of a merge, then we need to fire callbacks for those nodes that are
- *  about to go away.
- *
- *  The algorithm employed by this function is as follows:
- *
- *      1. Check the original node for the given shadow node.  If it exists and is a stem node,
- *         mark all of the children as deleted.  (This is done with the expectation that the
- *         original tree does not have nodes with the deleted flag set.)
- *
- *      2. Go through the shadow collection, and any shadow children that have links to the original
- *         nodes, clear the deleted flag.  These nodes are still considered "live."
+ *  Check the given node type and see if it should have a string value.
  *
- *      3. Travers the original children one more time.  For any node that is still marked as
- *         deleted we queue up an event handler.  As this node has been removed from the colection
- *         and will be removed as part of the final merge.  The delete flag is also cleared at this
- *         step to ensure that there are no external side effects.
+ *  @return True if the given node could hold a string value.  False if not.
  */
 // -------------------------------------------------------------------------------------------------
-static void FireLostChildren
+static bool IsStringType
 (
-    le_pathIter_Ref_t pathRef,   ///< [IN] Path to the parent of the current node.
-    tdb_NodeRef_t shadowNodeRef  ///< [IN] Node and any children to merge.
+    tdb_NodeRef_t nodeRef  ///< [IN] The node to read.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Is the original a stem?  If no, then done.
-    tdb_NodeRef_t originalRef = shadowNodeRef->shadowRef;
+    le_cfg_nodeType_t type = tdb_GetNodeType(nodeRef);
 
-    if (originalRef->type != LE_CFG_TYPE_STEM)
+    if (   (type == LE_CFG_TYPE_STRING)
+        || (type == LE_CFG_TYPE_BOOL)
+        || (type == LE_CFG_TYPE_INT)
+        || (type == LE_CFG_TYPE_FLOAT))
     {
-        return;
+        return true;
     }
 
-    // Mark all originals deleted.
-    tdb_NodeRef_t originalChildRef = tdb_GetFirstChildNode(originalRef);
+    return false;
+}
 
-    while (originalChildRef != NULL)
-    {
-        // Children in the original tree shouldn't currently be marked as deleted.
-        LE_ASSERT(IsDeleted(originalChildRef) == false);
 
-        SetDeletedFlag(originalChildRef);
-        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
-    }
 
-    // Follow through all of the shadow links and unmark deletions.
-    if (shadowNodeRef->type == LE_CFG_TYPE_STEM)
-    {
-        tdb_NodeRef_t shadowChildRef = tdb_GetFirstChildNode(shadowNodeRef);
 
-        while (shadowChildRef != NULL)
-        {
-            if (shadowChildRef->shadowRef != NULL)
-            {
-                ClearDeletedFlag(shadowChildRef->shadowRef);
-            }
+// -------------------------------------------------------------------------------------------------
+/**
+ *  This function will copy a string value from an original tree node into a node that has shadowed
+ *  it.
+ */
+// -------------------------------------------------------------------------------------------------
+static void PropagateValue
+(
+    tdb_NodeRef_t nodeRef  ///< [IN] The node ref to update.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // If the node doesn't even have a ref to an original node, then there's nothing left to do
+    // here.
+    tdb_NodeRef_t shadowRef = nodeRef->shadowRef;
 
-            shadowChildRef = tdb_GetNextSiblingNode(shadowChildRef);
-        }
+    if (shadowRef == NULL)
+    {
+        return;
     }
 
-    // Fire on all original nodes still marked.  But also take care to clear the deleted flags here
-    // in order to leave everything as it was.
-    originalChildRef = tdb_GetFirstChildNode(originalRef);
-
-    while (originalChildRef != NULL)
+    // Ok, figure out the type for this node.  If it has a value, and the original
+    if (   (IsStringType(nodeRef) == true)
+        && (IsStringType(shadowRef) == true)
+        && (nodeRef->info.valueRef == NULL)
+        && (shadowRef->info.valueRef != NULL))
     {
-        if (IsDeleted(originalChildRef) == true)
-        {
-            FireAllChildren(pathRef, originalChildRef);
-            ClearDeletedFlag(originalChildRef);
-        }
-
-        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
+        // Looks like the value hasn't been propagated or changed yet.  So, do so now.
+        nodeRef->info.valueRef = dstr_NewFromDstr(shadowRef->info.valueRef);
     }
 }
 
@@ -1455,125 +1759,123 @@ static void FireLostChildren
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Recursive function to merge a collection of shadow nodes with the original tree.
- *
- *  @return True if the given node or any if it's children have been modified.  False if not.
+ *  Merge a shadow node with the original it represents.
  */
 // -------------------------------------------------------------------------------------------------
-static bool InternalMergeTree
+static void MergeNode
 (
-    const char* treeNamePtr,    ///< [IN] The name of the tree we're merging.
-    le_pathIter_Ref_t pathRef,  ///< [IN] Path to the parent of hte current node.
-    tdb_NodeRef_t nodeRef,      ///< [IN] Node and any children to merge.
-    bool forceFire              ///< [IN] Should update handlers be fired for this node and all it's
-                                ///<      children, regardless of wether or not this node has been
-                                ///<      directly modified?
+    tdb_NodeRef_t nodeRef  ///< [IN] The shadow node to merge.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    bool isModified = IsModified(nodeRef);
-    bool renamed = WasRenamed(nodeRef);
-
-    // If this node was renamed, then all children also need to be triggered as well.
-    forceFire = renamed || forceFire;
+    LE_ASSERT(nodeRef != NULL);
 
-    // If this node has been renamed, marked as deleted or set empty, then all of the children need
-    // notifications fired on the original nodes.
-    if (   (renamed == true)
-        || (IsDeleted(nodeRef) == true)
-        || (OriginalToBeCleared(nodeRef) == true))
+    // If this shadow node for some reason doesn't have a ref check for an original version of it in
+    // the original tree.  This shadow node may have been destroyed and re-created loosing this
+    // link.
+    if (nodeRef->shadowRef == NULL)
     {
-        le_pathIter_Ref_t originalPathRef = CreateBasePath(treeNamePtr);
+        tdb_NodeRef_t shadowedParentRef = tdb_GetNodeParent(nodeRef)->shadowRef;
 
-        if (nodeRef->shadowRef != NULL)
+        if (shadowedParentRef != NULL)
         {
-            GeneratePath(originalPathRef, nodeRef->shadowRef->parentRef);
-            FireAllChildren(originalPathRef, nodeRef->shadowRef);
-        }
+            char name[LE_CFG_NAME_LEN_BYTES] = "";
 
-        le_pathIter_Delete(originalPathRef);
+            tdb_GetNodeName(nodeRef, name, sizeof(name));
+            nodeRef->shadowRef = GetNamedChild(shadowedParentRef, name);
+        }
     }
-    else if (   (isModified == true)
-             && (nodeRef->type == LE_CFG_TYPE_STEM))
-    {
-        le_pathIter_Ref_t originalPathRef = CreateBasePath(treeNamePtr);
-
-        GeneratePath(originalPathRef, nodeRef->shadowRef);
-        FireLostChildren(originalPathRef, nodeRef);
 
-        le_pathIter_Delete(originalPathRef);
+    // If this node has been marked as deleted, then simply drop the original node and move on.
+    if (IsDeleted(nodeRef))
+    {
+        if (   (nodeRef->shadowRef != NULL)
+            && (tdb_GetNodeParent(nodeRef->shadowRef) != NULL))
+        {
+            le_mem_Release(nodeRef->shadowRef);
+        }
+        else
+        {
+            // We delete every node but the root node.  Since this is the root node, we just need
+            // to clear it out.
+            tdb_SetEmpty(nodeRef->shadowRef);
+        }
+
+        return;
     }
 
-    AppendNodeName(pathRef, nodeRef);
+    // If the original node doesn't exist, create it now.
+    tdb_NodeRef_t originalRef = nodeRef->shadowRef;
 
-    // IF this node is modified, mearge it.  If this node is a stem, then merge it's children.  Keep
-    // track of whether any of those children have been modified as well.
-    if (isModified)
+    if (originalRef == NULL)
     {
-        MergeNode(nodeRef);
+        LE_ASSERT(nodeRef->parentRef != NULL);
+        LE_ASSERT(nodeRef->parentRef->shadowRef != NULL);
+
+        nodeRef->shadowRef = originalRef = NewChildNode(nodeRef->parentRef->shadowRef);
     }
 
-    if (   (nodeRef->type == LE_CFG_TYPE_STEM)
-        && (IsDeleted(nodeRef) == false))
+    ClearModifiedFlag(originalRef);
+
+    // If the name has been changed, then copy it over now.  The node moves to another bucket of its
+    // parent's child index.
+    if (dstr_IsNullOrEmpty(nodeRef->nameRef) == false)
     {
-        nodeRef = tdb_GetFirstChildNode(nodeRef);
+        UnindexChild(originalRef);
 
-        while (nodeRef != NULL)
+        if (originalRef->nameRef != NULL)
         {
-            tdb_NodeRef_t nextNodeRef = tdb_GetNextSiblingNode(nodeRef);
-
-            isModified = InternalMergeTree(treeNamePtr, pathRef, nodeRef, forceFire) || isModified;
-            nodeRef = nextNodeRef;
+            dstr_Copy(originalRef->nameRef, nodeRef->nameRef);
         }
-    }
+        else
+        {
+            originalRef->nameRef = dstr_NewFromDstr(nodeRef->nameRef);
+        }
+        originalRef->nameHash = nodeRef->nameHash;
 
-    // If this node, or any of it's children have been modified.  Try to fire any callbacks that may
-    // be registered.
-    if (isModified || forceFire)
-    {
-        TriggerCallbacks(pathRef);
+        IndexChild(originalRef);
     }
 
-    // Now remove this node from the tracking path and let our caller know if any modifications have
-    // happened at this level or lower.
-    if (le_pathIter_GoToEnd(pathRef) == LE_OK)
+    // Check the types of the original and the shadow nodes.  If the new node has been cleared,
+    // then clear out the original node.  If the types have changed, then clear out the original so
+    // that we can properly populate it again.
+    le_cfg_nodeType_t nodeType = tdb_GetNodeType(nodeRef);
+
+    if (   (nodeType == LE_CFG_TYPE_EMPTY)
+        || (nodeType != originalRef->type))
     {
-        le_pathIter_Truncate(pathRef);
+        tdb_SetEmpty(originalRef);
+        ClearModifiedFlag(originalRef);
     }
 
-    return isModified;
-}
-
-
-
+    // Ok, we know that the node hasn't been deleted.  Check to see if it's considered empty and
+    // that it isn't a stem.  If not, then copy over the string value.
+    if (   (nodeType != LE_CFG_TYPE_EMPTY)
+        && (nodeType != LE_CFG_TYPE_STEM))
+    {
+        if (nodeRef->info.valueRef != NULL)
+        {
+            if (originalRef->info.valueRef != NULL)
+            {
+                dstr_Copy(originalRef->info.valueRef, nodeRef->info.valueRef);
+            }
+            else
+            {
+                originalRef->info.valueRef = dstr_NewFromDstr(nodeRef->info.valueRef);
+            }
 
-// -------------------------------------------------------------------------------------------------
-/**
- *  Create a new tree object and set it to default values.
- *
- *  @return A ref to the newly created tree object.
- */
-// -------------------------------------------------------------------------------------------------
-tdb_TreeRef_t NewTree
-(
-    const char* treeNameRef,   ///< [IN] The name of the new tree.
-    tdb_NodeRef_t rootNodeRef  ///< [IN] The root node of this new tree.
-)
-// -------------------------------------------------------------------------------------------------
-{
-    tdb_TreeRef_t treeRef = le_mem_ForceAlloc(TreePoolRef);
+            // Propigate over the type as that may have changed, like going from an int value to a
+            // bool value.
 
-    LE_ASSERT(le_utf8_Copy(treeRef->name, treeNameRef, MAX_TREE_NAME_BYTES, NULL) == LE_OK);
+            originalRef->type = nodeRef->type;
+        }
+    }
 
-    treeRef->isDeletePending = false;
-    treeRef->originalTreeRef = NULL;
-    treeRef->revisionId = 0;
-    treeRef->rootNodeRef = (rootNodeRef != NULL) ? rootNodeRef : NewNode();
-    treeRef->activeReadCount = 0;
-    treeRef->activeWriteIterRef = NULL;
-    treeRef->requestList = LE_SLS_LIST_INIT;
+    // Now at this point, if both the original and the shadow node are stems, we'll let the function
+    // InternalMergeTree take care of the children, (if any.)
 
-    return treeRef;
+    // If the original has been cleared out, we can still just rely on InternalMergeTree to
+    // propigate over the new nodes.
 }
 
 
@@ -1581,66 +1883,76 @@ tdb_TreeRef_t NewTree
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Destructor called when a tree object is to be freed from memory.
+ *  Called to fire any callbacks registered on the given node path.  If nothing is registered on the
+ *  given path, nothing happens.
  */
 // -------------------------------------------------------------------------------------------------
-static void TreeDestructor
+static void TriggerCallbacks
 (
-    void* objectPtr  ///< The memory object to destruct.
+    le_pathIter_Ref_t pathRef  ///< [IN] The path to search for callback registrations.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    tdb_TreeRef_t treeRef = (tdb_TreeRef_t)objectPtr;
+    // Read the path out of the buffer.
+    char pathBuffer[CFG_MAX_PATH_SIZE] = { 0 };
+    if (le_pathIter_GetPath(pathRef, pathBuffer, sizeof(pathBuffer)) != LE_OK)
+    {
+        LE_ERROR("Callback path buffer overflow.");
+        return;
+    }
 
-    // Kill the root node.
-    le_mem_Release(treeRef->rootNodeRef);
-    treeRef->rootNodeRef = NULL;
+    // Try to find a registration object for this path.  If one is found, flag it for calling once
+    // the merge is complete.
+    Registration_t* foundRegistrationPtr = le_hashmap_Get(HandlerRegistrationMap, pathBuffer);
 
-    // Sanity check, is the tree actually ready to clean up?
-    LE_ASSERT(treeRef->activeReadCount == 0);
-    LE_ASSERT(treeRef->activeWriteIterRef == NULL);
-    LE_ASSERT(le_sls_IsEmpty(&treeRef->requestList) == true);
+    if (foundRegistrationPtr != NULL)
+    {
+        foundRegistrationPtr->triggered = true;
+    }
 }
 
 
 
 
+
 // -------------------------------------------------------------------------------------------------
 /**
- *  Create a path to a tree file with the given revision id.
+ *  Go through all of the registered event callbacks, and fire the call backs for each of the
+ *  registrations that has been makred as triggered.
  *
- *  @return A stringBuffer backed string containing the full path to the tree file.
+ *  Once this is done, the triggered flag is cleared for next time.
  */
 // -------------------------------------------------------------------------------------------------
-static void GetTreePath
+static void FireTriggeredCallbacks
 (
-    const char* treeNameRef,  ///< [IN] The name of the tree we're generating a name for.
-    int revisionId,           ///< [IN] Generate a name based on the tree revision.
-    char* pathBuffer,         ///< [IN] Buffer to hold the new path.
-    size_t pathSize           ///< [IN] Size of the path buffer.
+    void
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // paper    --> rock       1 -> 2
-    // rock     --> scissors   2 -> 3
-    // scissors --> paper      3 -> 1
+    // Go through the registration map.
+    le_hashmap_It_Ref_t handlerIterRef = le_hashmap_GetIterator(HandlerRegistrationMap);
 
-    static const char* revNames[] = { "paper", "rock", "scissors" };
-    int printSize;
+    while (le_hashmap_NextNode(handlerIterRef) == LE_OK)
+    {
+        // For each registration, check to see if it was triggered.
+        Registration_t* registrationPtr = (Registration_t*)le_hashmap_GetValue(handlerIterRef);
 
-    LE_ASSERT((revisionId >= 1) && (revisionId <= 3));
+        if (registrationPtr->triggered)
+        {
+            // This registration has been triggered, so call all of the handlers attached to it.
+            le_dls_Link_t* linkPtr = le_dls_Peek(&registrationPtr->handlerList);
 
-    printSize = snprintf(pathBuffer,
-                         pathSize,
-                         "%s/%s.%s",
-                         CFG_TREE_PATH,
-                         treeNameRef,
-                         revNames[revisionId - 1]);
+            while (linkPtr != NULL)
+            {
+                Handler_t* handlerObjectPtr = CONTAINER_OF(linkPtr, Handler_t, link);
 
-    if (printSize >= pathSize)
-    {
-       LE_ERROR("Unable to store config tree path in buffer");
-       pathBuffer[0] = '\0';
+                handlerObjectPtr->handlerPtr(handlerObjectPtr->contextPtr);
+                linkPtr = le_dls_PeekNext(&registrationPtr->handlerList, linkPtr);
+            }
+
+            // Now that that's done, clear the triggered flag.
+            registrationPtr->triggered = false;
+        }
     }
 }
 
@@ -1649,56 +1961,38 @@ static void GetTreePath
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Check to see if a configTree file at the given revision already exists in the filesystem.
- *
- *  @note If the tree file exists, but is empty, then it is invalid and will be deleted.
+ *  Check the given node to see if it was renamed.
  *
- *  @return True if the named file exists, false otherwise.
+ *  @return True if the node was renamed within this transaction.  False if not.
  */
 // -------------------------------------------------------------------------------------------------
-static bool TreeFileExists
+static bool WasRenamed
 (
-    const char* treeNameRef,  ///< [IN] Name of the tree to check.
-    int revisionId            ///< [IN] The revision of the tree to check against.
+    tdb_NodeRef_t nodeRef  ///< [IN] Check this node to see if it was renamed in this transaction.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    char fullPath[LE_CFG_STR_LEN_BYTES] = "";
-    GetTreePath(treeNameRef, revisionId, fullPath, sizeof(fullPath));
-
-    // Make sure this part was successful.
-    if (fullPath[0] == '\0')
+    if (IsModified(nodeRef) == false)
     {
+        // The node wasn't even modified, so it can not have been renamed.
         return false;
     }
 
-    // stat() the file to see if it exists and get its size.
-    struct stat s;
-    if (stat(fullPath, &s) == -1)
+    if (nodeRef->shadowRef == NULL)
     {
-        LE_DEBUG("Can't stat file '%s' (%m).", fullPath);
+        // If the node doesn't have a shadow reference, then most likely this is a new node and not
+        // a rename of an existing one.
         return false;
     }
 
-    // Make sure it's a regular file.
-    if (!S_ISREG(s.st_mode))
-    {
-        LE_FATAL("Object at '%s' is not a regular file.", fullPath);
-    }
-
-    // If it's zero size, delete it and report that it doesn't exist.
-    if (s.st_size == 0)
+    if (nodeRef->nameRef == NULL)
     {
-        if (unlink(fullPath) == -1)
-        {
-            LE_FATAL("Failed to unlink empty file '%s' (%m).", fullPath);
-        }
-
+        // The shadow node does not have a local copy of a name, so it can not have been renamed.
+        // It must have been modified for other reasons.
         return false;
     }
 
-    // NOTE: The Config Tree generally runs as root, so permissions should be irrelevant.
-
+    // Looks like the node has a new name.
     return true;
 }
 
@@ -1707,52 +2001,26 @@ static bool TreeFileExists
 
 // -------------------------------------------------------------------------------------------------
 /**
- * Check the filesystem and get the current "valid" version of the file and update the tree object
- * with that version number.
+ *  Check the original non-shadow node to see if it will need to be cleared during the merge.
  *
- * If there are two files for a given tree, we use the older one.  The idea being, if there are
- * two versions of the same file in the filesystem then there was a system failure during a save
- * operation.  So we abandon the newer (probably incomplete) file and go with the older file;
- * unless the size of the older file is zero, which can happen if deletion of that file is
- * interrupted.
+ *  @return True if the merge will clear out the original value.  False if not.
  */
 // -------------------------------------------------------------------------------------------------
-static void UpdateRevision
+static bool OriginalToBeCleared
 (
-    tdb_TreeRef_t treeRef  ///< [IN] Update the revision for this tree object.
+    tdb_NodeRef_t nodeRef  ///< [IN] The shadow node to check.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    int newRevision = 0;
+    le_cfg_nodeType_t nodeType = tdb_GetNodeType(nodeRef);
 
-    if (TreeFileExists(treeRef->name, 1))
-    {
-        if (TreeFileExists(treeRef->name, 3))
-        {
-            newRevision = 3;
-        }
-        else
-        {
-            newRevision = 1;
-        }
-    }
-    else if (TreeFileExists(treeRef->name, 3))
-    {
-        if (TreeFileExists(treeRef->name, 2))
-        {
-            newRevision = 2;
-        }
-        else
-        {
-            newRevision = 3;
-        }
-    }
-    else if (TreeFileExists(treeRef->name, 2))
+    if (   (nodeType == LE_CFG_TYPE_EMPTY)
+        || (nodeType != tdb_GetNodeType(nodeRef->shadowRef)))
     {
-        newRevision = 2;
+        return true;
     }
 
-    treeRef->revisionId = newRevision;
+    return false;
 }
 
 
@@ -1760,19 +2028,27 @@ static void UpdateRevision
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Peek into the input stream one character ahead.
+ *  Append the name of a node onto the end of a path object.
  */
 // -------------------------------------------------------------------------------------------------
-static signed char PeekChar
+static void AppendNodeName
 (
-    FILE* filePtr  ///< [IN] The file stream to peek into.
+    le_pathIter_Ref_t pathRef,  ///< [IN] The path we're appending to.
+    tdb_NodeRef_t nodeRef       ///< [IN] The node we're appending.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    char next = fgetc(filePtr);
-    ungetc(next, filePtr);
+    char nodeName[LE_CFG_NAME_LEN_BYTES] = "";
 
-    return next;
+    LE_ASSERT(tdb_GetNodeName(nodeRef, nodeName, sizeof(nodeName)) == LE_OK);
+    le_result_t result = le_pathIter_Append(pathRef, nodeName);
+
+    LE_WARN_IF(result != LE_OK,
+               "Could not append node '%s' onto the update callback tracking path.  "
+               "Reason: %d, '%s'.",
+               nodeName,
+               result,
+               LE_RESULT_TXT(result));
 }
 
 
@@ -1780,104 +2056,82 @@ static signed char PeekChar
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Skip any whitespace encountered in the input stream.  Stop skipping once we hit a valid token.
+ *  Create a new config path for the tree name given.
  *
- *  @return LE_OK if the whitespace is skiped and there is still more file to read.
- *          LE_OUT_OF_RANGE if the end of the file is hit.
+ *  @return A new config path, rooted on the given tree.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t SkipWhiteSpace
+static le_pathIter_Ref_t CreateBasePath
 (
-    FILE* filePtr  ///< [IN] The file stream to seek through.
+    const char* treeNamePtr  ///< [IN] The tree name to use for the new path object.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    bool done = false;
-    bool isEof = false;
-
-    while (done == false)
-    {
-        switch (PeekChar(filePtr))
-        {
-            case '\n':
-            case '\r':
-            case '\t':
-            case ' ':
-                // Eat the character.
-                fgetc(filePtr);
-                break;
+    char basePath[CFG_MAX_PATH_SIZE] = { 0 };
 
-            case EOF:
-                done = true;
-                isEof = true;
-                break;
+    snprintf(basePath, sizeof(basePath), "%s:/", treeNamePtr);
+    return le_pathIter_CreateForUnix(basePath);
+}
 
-            default:
-                done = true;
-                break;
-        }
-    }
 
-    return isEof == true ? LE_OUT_OF_RANGE : LE_OK;
-}
 
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Skip to the next occurence of the given character.
- *
- *  @return LE_OK if the character is found.
- *          LE_OUT_OF_RANGE if the end of the file is hit.
+ *  Generate a config path to the given node.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t SkipToNextChar
+static void GeneratePath
 (
-    FILE* filePtr,          ///< [IN] The file stream to seek through.
-    signed char nextChar    ///< [IN]  The character we're searching for.
+    le_pathIter_Ref_t pathRef,  ///< [IN] The path object we're updating.
+    tdb_NodeRef_t nodeRef       ///< [IN] The node we're creating a path for.
 )
+// -------------------------------------------------------------------------------------------------
 {
-    signed char next;
-
-    while ((next = fgetc(filePtr)) != nextChar)
+    if (nodeRef == NULL)
     {
-        if (next == EOF)
-        {
-            return LE_OUT_OF_RANGE;
-        }
+        return;
     }
 
-    return LE_OK;
+    GeneratePath(pathRef, nodeRef->parentRef);
+    AppendNodeName(pathRef, nodeRef);
 }
 
 
+
+
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read a boolean literal from the input file.
- *
- *  @return LE_OK if the literal could be read.
- *          LE_FORMAT_ERROR if the literal could not be read.
+ *  Trigger callbacks for this node and all of it's children.
  */
 // -------------------------------------------------------------------------------------------------
-static bool ReadBoolToken
+static void FireAllChildren
 (
-    FILE* filePtr,     ///< [IN]  The file we're reading from.
-    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+    le_pathIter_Ref_t pathRef,  ///< [IN] Path to the parent of the current node.
+    tdb_NodeRef_t nodeRef       ///< [IN] Node and any children to merge.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    signed char next = fgetc(filePtr);
+    // Add this node to the path we're using to find registered callbacks.
+    AppendNodeName(pathRef, nodeRef);
 
-    if (   (next == 't')
-        || (next == 'f'))
+    // If the node is a stem then traverse it's children and try to trigger callbacks for them.  If
+    // there are no callbacks registered for those nodes, then nothing will happen.
+    if (nodeRef->type == LE_CFG_TYPE_STEM)
     {
-        stringPtr[0] = next;
-        stringPtr[1] = 0;
+        tdb_NodeRef_t childRef = tdb_GetFirstChildNode(nodeRef);
 
-        return LE_OK;
+        while (childRef != NULL)
+        {
+            FireAllChildren(pathRef, childRef);
+            childRef = tdb_GetNextSiblingNode(childRef);
+        }
     }
 
-    return LE_FORMAT_ERROR;
+    // Like with the children, try to do the same for this node.  Then remove this node from the
+    // tracking path.
+    TriggerCallbacks(pathRef);
+    le_pathIter_Truncate(pathRef);
 }
 
 
@@ -1885,75 +2139,82 @@ static bool ReadBoolToken
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read a textual literal from the input file, the read is terminated successfuly if the terminal
- *  character is found.
+ *  Check a given shadow node and the original node it's shadowing.  If the original has children
+ *  that will be lost because of a merge, then we need to fire callbacks for those nodes that are
+ *  about to go away.
  *
- *  @return LE_OK if the string is read from the file.
- *          LE_FORMAT_ERROR if the text fails to be read from the file.
- *          LE_OVERFLOW if the text doesn't fit in provided buffer (truncated).
+ *  The algorithm employed by this function is as follows:
+ *
+ *      1. Check the original node for the given shadow node.  If it exists and is a stem node,
+ *         mark all of the children as deleted.  (This is done with the expectation that the
+ *         original tree does not have nodes with the deleted flag set.)
+ *
+ *      2. Go through the shadow collection, and any shadow children that have links to the original
+ *         nodes, clear the deleted flag.  These nodes are still considered "live."
+ *
+ *      3. Travers the original children one more time.  For any node that is still marked as
+ *         deleted we queue up an event handler.  As this node has been removed from the colection
+ *         and will be removed as part of the final merge.  The delete flag is also cleared at this
+ *         step to ensure that there are no external side effects.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t ReadTextLiteral
+static void FireLostChildren
 (
-    FILE* filePtr,        ///< [IN]  The file we're reading from.
-    char* stringPtr,      ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize,    ///< [IN]  How big is the supplied string buffer?
-    signed char terminal  ///< [IN]  The terminal character we're searching for.
+    le_pathIter_Ref_t pathRef,   ///< [IN] Path to the parent of the current node.
+    tdb_NodeRef_t shadowNodeRef  ///< [IN] Node and any children to merge.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    signed char next;
-    size_t count = 0;
+    // Is the original a stem?  If no, then done.
+    tdb_NodeRef_t originalRef = shadowNodeRef->shadowRef;
 
-    char* oldPtr = stringPtr;
+    if (originalRef->type != LE_CFG_TYPE_STEM)
+    {
+        return;
+    }
 
-    while ((next = fgetc(filePtr)) != terminal)
+    // Mark all originals deleted.
+    tdb_NodeRef_t originalChildRef = tdb_GetFirstChildNode(originalRef);
+
+    while (originalChildRef != NULL)
     {
-        if (next == EOF)
-        {
-            LE_ERROR("Missing end specifier, ']' in int value.");
-            return LE_FORMAT_ERROR;
-        }
+        // Children in the original tree shouldn't currently be marked as deleted.
+        LE_ASSERT(IsDeleted(originalChildRef) == false);
 
-        if (next == '\\')
-        {
-            next = fgetc(filePtr);
+        SetDeletedFlag(originalChildRef);
+        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
+    }
 
-            if (next == EOF)
-            {
-                LE_ERROR("Unexpected EOF after finding \\ character.");
-                return LE_FORMAT_ERROR;
-            }
-        }
+    // Follow through all of the shadow links and unmark deletions.
+    if (shadowNodeRef->type == LE_CFG_TYPE_STEM)
+    {
+        tdb_NodeRef_t shadowChildRef = tdb_GetFirstChildNode(shadowNodeRef);
 
-        if (count >= (stringSize - 1))
+        while (shadowChildRef != NULL)
         {
-            // truncate the string to the buffer size
-            *stringPtr = 0;
-
-            LE_ERROR("String literal is too large, truncated (%zd/%zd)",
-                     strlen(oldPtr),
-                     stringSize);
-            // move the file pointer to the terminal character (e.g. closing quote)
-            if (LE_OK == SkipToNextChar(filePtr, terminal))
-            {
-                return LE_OVERFLOW;
-            }
-            else
+            if (shadowChildRef->shadowRef != NULL)
             {
-                return LE_FORMAT_ERROR;
+                ClearDeletedFlag(shadowChildRef->shadowRef);
             }
-        }
-
-        *stringPtr = next;
 
-        ++stringPtr;
-        ++count;
+            shadowChildRef = tdb_GetNextSiblingNode(shadowChildRef);
+        }
     }
 
-    *stringPtr = 0;
+    // Fire on all original nodes still marked.  But also take care to clear the deleted flags here
+    // in order to leave everything as it was.
+    originalChildRef = tdb_GetFirstChildNode(originalRef);
 
-    return LE_OK;
+    while (originalChildRef != NULL)
+    {
+        if (IsDeleted(originalChildRef) == true)
+        {
+            FireAllChildren(pathRef, originalChildRef);
+            ClearDeletedFlag(originalChildRef);
+        }
+
+        originalChildRef = tdb_GetNextSiblingNode(originalChildRef);
+    }
 }
 
 
@@ -1961,80 +2222,72 @@ static le_result_t ReadTextLiteral
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read an integer token string from the file.
- *
- *  @return LE_OK if the string is read from the file.
- *          LE_FORMAT_ERROR if the text fails to be read from the file.
- *          LE_OVERFLOW if the text doesn't fit in provided buffer (truncated).
+ *  A node of an original tree on the way down a shadow tree, and the tree version node that is its
+ *  copy, which is only looked up if it has to be copied.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t ReadIntToken
-(
-    FILE* filePtr,     ///< [IN]  The file we're reading from.
-    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
-)
-// -------------------------------------------------------------------------------------------------
+typedef struct VersionPath
 {
-    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, ']');
-
-    // TODO: Validate the int string.
-
-    return result;
+    struct VersionPath* parentPtr;  ///< The entry for the parent node, or NULL for the root.
+    tdb_NodeRef_t originalRef;      ///< The node of the original tree.
+    tdb_NodeRef_t versionRef;       ///< Its copy in the tree version, or NULL if there isn't one.
+    bool isFound;                   ///< Has versionRef been looked up yet?
 }
+VersionPath_t;
 
 
 
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read a floating point token string from the file.
+ *  Get the copy of an original tree node in a tree version.  The copy's parent copies its children
+ *  from the original tree, if it hasn't yet.
  *
- *  @return LE_OK if the string is read from the file.
- *          LE_FORMAT_ERROR if the text fails to be read from the file.
- *          LE_OVERFLOW if the text doesn't fit in provided buffer (truncated).
+ *  @return The copy, or NULL if the version has none: the node was created after the version, or
+ *          the version has already copied all of it.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t ReadFloatToken
+static tdb_NodeRef_t GetVersionNode
 (
-    FILE* filePtr,     ///< [IN]  The file we're reading from.
-    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+    VersionPath_t* pathPtr  ///< [IN] The original node to look up.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, ')');
+    if (pathPtr->isFound)
+    {
+        return pathPtr->versionRef;
+    }
 
-    // TODO: Validate the float string.
+    pathPtr->isFound = true;
 
-    return result;
-}
+    tdb_NodeRef_t parentRef = GetVersionNode(pathPtr->parentPtr);
 
+    if (   (parentRef == NULL)
+        || (parentRef->type != LE_CFG_TYPE_STEM))
+    {
+        return NULL;
+    }
 
+    CopyVersionChildren(parentRef);
 
+    // The copies were named after the original nodes when they were made, but the originals may
+    // have been renamed since.  So they're matched by source, not by name.
+    le_dls_Link_t* linkPtr = le_dls_Peek(&parentRef->info.children);
 
-// -------------------------------------------------------------------------------------------------
-/**
- *  Read a string from the config tree file.
- *
- *  @return LE_OK if the string is read from the file.
- *          LE_FORMAT_ERROR if the text fails to be read from the file.
- *          LE_OVERFLOW if the text doesn't fit in provided buffer (truncated).
- */
-// -------------------------------------------------------------------------------------------------
-static le_result_t ReadStringToken
-(
-    FILE* filePtr,     ///< [IN]  The file we're reading from.
-    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
-)
-// -------------------------------------------------------------------------------------------------
-{
-    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, '"');
+    while (linkPtr != NULL)
+    {
+        tdb_NodeRef_t childRef = CONTAINER_OF(linkPtr, Node_t, siblingList);
 
-    // TODO: Validate the literal string.
+        if (childRef->sourceRef == pathPtr->originalRef)
+        {
+            pathPtr->versionRef = childRef;
+            break;
+        }
 
-    return result;
+        linkPtr = le_dls_PeekNext(&parentRef->info.children, linkPtr);
+    }
+
+    return pathPtr->versionRef;
 }
 
 
@@ -2042,69 +2295,95 @@ static le_result_t ReadStringToken
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read a token from the input stream.
+ *  Before a shadow node is merged, make the tree version copy what the merge will change.  The
+ *  parent of each changed original node copies its children, and so keeps the old name and value of
+ *  the node.  An original node that will be deleted or cleared is copied along with its children.
  *
- *  @return LE_OK if a token could be read.  LE_OUT_OF_RANGE if the end of the stream is reached
- *          before a token could be finished.
+ *  This follows the same steps as InternalMergeTree() and MergeNode(), without changing anything.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t ReadToken
+static void CopyChangedVersionNodes
 (
-    FILE* filePtr,         ///< [IN]  The file we're reading from.
-    char* stringPtr,       ///< [OUT] String buffer to hold the token we've read.
-    size_t stringSize,     ///< [IN]  How big is the supplied string buffer?
-    TokenType_t* typePtr   ///< [OUT] The type of token read from the file.
+    VersionPath_t* pathPtr,  ///< [IN] The original node, and its copy in the tree version.
+    tdb_NodeRef_t nodeRef    ///< [IN] The shadow node of the original node.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    *stringPtr = 0;
+    tdb_NodeRef_t originalRef = pathPtr->originalRef;
+    bool isModified = IsModified(nodeRef);
+    bool isCleared = false;
 
-    if (SkipWhiteSpace(filePtr) != LE_OK)
+    if (isModified)
     {
-        return LE_OUT_OF_RANGE;
-    }
+        le_cfg_nodeType_t nodeType = tdb_GetNodeType(nodeRef);
 
-    signed char next;
+        isCleared = (nodeType == LE_CFG_TYPE_EMPTY) || (nodeType != originalRef->type);
+    }
 
-    while ((next = fgetc(filePtr)) != EOF)
+    if (   (IsDeleted(nodeRef))
+        || (isCleared))
     {
-        switch (next)
+        tdb_NodeRef_t versionRef = GetVersionNode(pathPtr);
+
+        if (versionRef != NULL)
         {
-            case '~':
-                *typePtr = TT_EMPTY_VALUE;
-                return LE_OK;
+            CopyVersionTree(versionRef);
+        }
 
-            case '!':
-                *typePtr = TT_BOOL_VALUE;
-                return ReadBoolToken(filePtr, stringPtr, stringSize);
+        return;
+    }
 
-            case '[':
-                *typePtr = TT_INT_VALUE;
-                return ReadIntToken(filePtr, stringPtr, stringSize);
+    if (   (isModified)
+        && (pathPtr->parentPtr != NULL))
+    {
+        GetVersionNode(pathPtr);
+    }
 
-            case '(':
-                *typePtr = TT_FLOAT_VALUE;
-                return ReadFloatToken(filePtr, stringPtr, stringSize);
+    if (nodeRef->type != LE_CFG_TYPE_STEM)
+    {
+        return;
+    }
 
-            case '\"':
-                *typePtr = TT_STRING_VALUE;
-                return ReadStringToken(filePtr, stringPtr, stringSize);
+    // Only go through the children that were shadowed, the others aren't changed.
+    le_dls_Link_t* linkPtr = le_dls_Peek(&nodeRef->info.children);
 
-            case '{':
-                *typePtr = TT_OPEN_GROUP;
-                return LE_OK;
+    while (linkPtr != NULL)
+    {
+        tdb_NodeRef_t childRef = CONTAINER_OF(linkPtr, Node_t, siblingList);
+        tdb_NodeRef_t originalChildRef = childRef->shadowRef;
 
-            case '}':
-                *typePtr = TT_CLOSE_GROUP;
-                return LE_OK;
+        if (IsModified(childRef))
+        {
+            if (originalChildRef == NULL)
+            {
+                char name[LE_CFG_NAME_LEN_BYTES] = "";
 
-            default:
-                LE_ERROR("Unexpected character in input stream.");
-                return LE_FORMAT_ERROR;
+                tdb_GetNodeName(childRef, name, sizeof(name));
+                originalChildRef = GetNamedChild(originalRef, name);
+            }
+
+            // A new child is about to be added to the original node.
+            if (   (originalChildRef == NULL)
+                && (IsDeleted(childRef) == false))
+            {
+                tdb_NodeRef_t versionRef = GetVersionNode(pathPtr);
+
+                if (versionRef != NULL)
+                {
+                    CopyVersionChildren(versionRef);
+                }
+            }
         }
-    }
 
-    return LE_OUT_OF_RANGE;
+        if (originalChildRef != NULL)
+        {
+            VersionPath_t childPath = { pathPtr, originalChildRef, NULL, false };
+
+            CopyChangedVersionNodes(&childPath, childRef);
+        }
+
+        linkPtr = le_dls_PeekNext(&nodeRef->info.children, linkPtr);
+    }
 }
 
 
@@ -2112,83 +2391,106 @@ static le_result_t ReadToken
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Write data to the output stream.  This function will record any faults to the system log.
+ *  Recursive function to merge a collection of shadow nodes with the original tree.
  *
- *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ *  @return True if the given node or any if it's children have been modified.  False if not.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t WriteFile
+static bool InternalMergeTree
 (
-    FILE* filePtr,        ///< [IN] The file being written to.
-    const void* dataPtr,  ///< [IN] The data being written to the file.
-    size_t dataSize       ///< [IN] The amount of data being written.
+    const char* treeNamePtr,    ///< [IN] The name of the tree we're merging.
+    le_pathIter_Ref_t pathRef,  ///< [IN] Path to the parent of hte current node.
+    tdb_NodeRef_t nodeRef,      ///< [IN] Node and any children to merge.
+    bool forceFire              ///< [IN] Should update handlers be fired for this node and all it's
+                                ///<      children, regardless of wether or not this node has been
+                                ///<      directly modified?
 )
 // -------------------------------------------------------------------------------------------------
 {
-    ssize_t written = fwrite(dataPtr, 1, dataSize, filePtr);
+    bool isModified = IsModified(nodeRef);
+    bool renamed = WasRenamed(nodeRef);
 
-    if (ferror(filePtr) != 0)
-    {
-        LE_EMERG("Failed to write to config tree file.");
-        return LE_IO_ERROR;
-    }
+    // If this node was renamed, then all children also need to be triggered as well.
+    forceFire = renamed || forceFire;
 
-    if (written < dataSize)
+    // If this node has been renamed, marked as deleted or set empty, then all of the children need
+    // notifications fired on the original nodes.  Only modified nodes can have been set empty, and
+    // checking the type of an unmodified stem would shadow all of its children.
+    if (   (renamed == true)
+        || (IsDeleted(nodeRef) == true)
+        || (   (isModified == true)
+            && (OriginalToBeCleared(nodeRef) == true)))
     {
-        LE_EMERG("Data truncated while writing to configuration file.");
-        return LE_IO_ERROR;
-    }
+        le_pathIter_Ref_t originalPathRef = CreateBasePath(treeNamePtr);
 
-    return LE_OK;
-}
+        if (nodeRef->shadowRef != NULL)
+        {
+            GeneratePath(originalPathRef, nodeRef->shadowRef->parentRef);
+            FireAllChildren(originalPathRef, nodeRef->shadowRef);
+        }
 
+        le_pathIter_Delete(originalPathRef);
+    }
+    else if (   (isModified == true)
+             && (nodeRef->type == LE_CFG_TYPE_STEM))
+    {
+        le_pathIter_Ref_t originalPathRef = CreateBasePath(treeNamePtr);
 
+        GeneratePath(originalPathRef, nodeRef->shadowRef);
+        FireLostChildren(originalPathRef, nodeRef);
 
-// -------------------------------------------------------------------------------------------------
-/**
- *  Write a string token to the output stream.  This function will write the string and escape all
- *  control characters as it does so.
- *
- *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
- */
-// -------------------------------------------------------------------------------------------------
-static le_result_t WriteStringValue
-(
-    FILE* filePtr,         ///< [IN] The file to write to.
-    char startChar,        ///< [IN] The delimiter to use.
-    char endChar,          ///< [IN] The closing delimiter to use.
-    const char* stringPtr  ///< [IN] The actual string to write.
-)
-// -------------------------------------------------------------------------------------------------
-{
-    le_result_t result = LE_OK;
+        le_pathIter_Delete(originalPathRef);
+    }
 
-    result = WriteFile(filePtr, &startChar, 1);
+    AppendNodeName(pathRef, nodeRef);
 
-    while (   (*stringPtr != 0)
-           && (result == LE_OK))
+    // IF this node is modified, mearge it.  If this node is a stem, then merge it's children.  Keep
+    // track of whether any of those children have been modified as well.
+    if (isModified)
     {
-        if (   (*stringPtr == '\"')
-            || (*stringPtr == '\\'))
+        MergeNode(nodeRef);
+    }
+
+    if (   (nodeRef->type == LE_CFG_TYPE_STEM)
+        && (IsDeleted(nodeRef) == false))
+    {
+        // Children that were never shadowed haven't changed.  So unless callbacks have to be fired
+        // for all of them, only go through the ones that were, instead of shadowing the rest now.
+        if (forceFire)
         {
-            result = WriteFile(filePtr, "\\", 1);
+            nodeRef = tdb_GetFirstChildNode(nodeRef);
+        }
+        else
+        {
+            le_dls_Link_t* linkPtr = le_dls_Peek(&nodeRef->info.children);
+
+            nodeRef = (linkPtr != NULL) ? CONTAINER_OF(linkPtr, Node_t, siblingList) : NULL;
         }
 
-        if (result == LE_OK)
+        while (nodeRef != NULL)
         {
-            result = WriteFile(filePtr, stringPtr, 1);
+            tdb_NodeRef_t nextNodeRef = tdb_GetNextSiblingNode(nodeRef);
+
+            isModified = InternalMergeTree(treeNamePtr, pathRef, nodeRef, forceFire) || isModified;
+            nodeRef = nextNodeRef;
         }
+    }
 
-        stringPtr++;
+    // If this node, or any of it's children have been modified.  Try to fire any callbacks that may
+    // be registered.
+    if (isModified || forceFire)
+    {
+        TriggerCallbacks(pathRef);
     }
 
-    if (result == LE_OK)
+    // Now remove this node from the tracking path and let our caller know if any modifications have
+    // happened at this level or lower.
+    if (le_pathIter_GoToEnd(pathRef) == LE_OK)
     {
-        char strBuffer[2] = { endChar, ' ' };
-        result = WriteFile(filePtr, strBuffer, sizeof(strBuffer));
+        le_pathIter_Truncate(pathRef);
     }
 
-    return result;
+    return isModified;
 }
 
 
@@ -2196,154 +2498,164 @@ static le_result_t WriteStringValue
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read a node value from the given file.  If the value is a collection, then read in those nodes
- *  too.
+ *  Create a new tree object and set it to default values.
  *
- *  @return LE_OK if the read is successful.
- *          LE_FORMAT_ERROR if parse errors are encountered.
- *          LE_NOT_FOUND if the end of file is reached.
+ *  @return A ref to the newly created tree object.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t InternalReadNode
+tdb_TreeRef_t NewTree
 (
-    tdb_NodeRef_t nodeRef,  ///< [IN] The node we're reading a value for.
-    FILE* filePtr,          ///< [IN] The file we're reading the value from.
-    size_t pathLen          ///< [IN] The length of the path including nodeRef.
+    const char* treeNameRef,   ///< [IN] The name of the new tree.
+    tdb_NodeRef_t rootNodeRef  ///< [IN] The root node of this new tree.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    char* stringBuffer = le_mem_ForceAlloc(EncodedStringPool);
-    size_t stringBufferSize = TDB_MAX_ENCODED_SIZE;
-    le_result_t result = LE_OK;
+    tdb_TreeRef_t treeRef = le_mem_ForceAlloc(TreePoolRef);
 
-    TokenType_t tokenType;
+    LE_ASSERT(le_utf8_Copy(treeRef->name, treeNameRef, MAX_TREE_NAME_BYTES, NULL) == LE_OK);
 
-    // Try to read this node's value.
-    result = ReadToken(filePtr, stringBuffer, stringBufferSize, &tokenType);
-    if ((result != LE_OK) && (result != LE_OVERFLOW))
-    {
-        LE_ERROR("Unexpected EOF or bad token in file.");
-        result = LE_FORMAT_ERROR;
-        goto cleanup;
-    }
-    // if result is OVERFLOW (i.e. string is truncated), we still should be able
-    // to proceed with parsing the rest of the file.
-    result = LE_OK;
+    treeRef->isDeletePending = false;
+    treeRef->originalTreeRef = NULL;
+    treeRef->isVersion = false;
+    treeRef->sourceTreeRef = NULL;
+    treeRef->versionLink = LE_DLS_LINK_INIT;
+    treeRef->versionList = LE_DLS_LIST_INIT;
+    treeRef->revisionId = 0;
+    treeRef->rootNodeRef = (rootNodeRef != NULL) ? rootNodeRef : NewNode();
+    treeRef->activeReadCount = 0;
+    treeRef->activeWriteIterRef = NULL;
+    treeRef->requestList = LE_SLS_LIST_INIT;
+    treeRef->revisionSize = 0;
+    treeRef->journalSize = 0;
+    treeRef->compactTimerRef = NULL;
+    treeRef->syncDeferCount = 0;
+    treeRef->pendingPtr = NULL;
+    treeRef->pendingSize = 0;
+    treeRef->commitCount = 0;
+    treeRef->bytesWritten = 0;
 
-    tdb_SetEmpty(nodeRef);
+    return treeRef;
+}
 
-    switch (tokenType)
-    {
-        case TT_BOOL_VALUE:
-            tdb_SetValueAsString(nodeRef, stringBuffer);
-            nodeRef->type = LE_CFG_TYPE_BOOL;
-            break;
 
-        case TT_INT_VALUE:
-            tdb_SetValueAsString(nodeRef, stringBuffer);
-            nodeRef->type = LE_CFG_TYPE_INT;
-            break;
 
-        case TT_FLOAT_VALUE:
-            tdb_SetValueAsString(nodeRef, stringBuffer);
-            nodeRef->type = LE_CFG_TYPE_FLOAT;
-            break;
 
-        case TT_STRING_VALUE:
-            tdb_SetValueAsString(nodeRef, stringBuffer);
-            break;
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Destructor called when a tree object is to be freed from memory.
+ */
+// -------------------------------------------------------------------------------------------------
+static void TreeDestructor
+(
+    void* objectPtr  ///< The memory object to destruct.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    tdb_TreeRef_t treeRef = (tdb_TreeRef_t)objectPtr;
 
-        case TT_EMPTY_VALUE:
-            // The node has already been cleared, so there's nothing left to do but make sure that
-            // the node exists.
-            ClearDeletedFlag(nodeRef);
-            break;
+    // The versions of this tree have to copy what they still share with it first.
+    le_dls_Link_t* linkPtr;
 
-        case TT_OPEN_GROUP:
-            while (tokenType != TT_CLOSE_GROUP)
-            {
-                if (ReadToken(filePtr, stringBuffer, stringBufferSize, &tokenType) != LE_OK)
-                {
-                    LE_ERROR("Unexpected EOF or bad token in file while looking for '}'.");
-                    result = LE_FORMAT_ERROR;
-                    goto cleanup;
-                }
+    while ((linkPtr = le_dls_Pop(&treeRef->versionList)) != NULL)
+    {
+        tdb_TreeRef_t versionRef = CONTAINER_OF(linkPtr, Tree_t, versionLink);
 
-                if (tokenType == TT_STRING_VALUE)
-                {
-                    size_t strLen = le_utf8_NumBytes(stringBuffer);
-                    size_t newPathLen = pathLen + 1 + strLen;
+        CopyVersionTree(versionRef->rootNodeRef);
+        versionRef->sourceTreeRef = NULL;
+    }
 
-                    if (newPathLen > LE_CFG_STR_LEN)
-                    {
-                        LE_ERROR("New path length for node '%s' is too long.  %zu of %zu bytes.",
-                                 stringBuffer,
-                                 strLen,
-                                 (size_t)LE_CFG_STR_LEN);
+    if (treeRef->sourceTreeRef != NULL)
+    {
+        le_dls_Remove(&treeRef->sourceTreeRef->versionList, &treeRef->versionLink);
+        treeRef->sourceTreeRef = NULL;
+    }
 
-                        result = LE_FORMAT_ERROR;
-                        goto cleanup;
-                    }
+    // Kill the root node.
+    le_mem_Release(treeRef->rootNodeRef);
+    treeRef->rootNodeRef = NULL;
 
-                    tdb_NodeRef_t childRef = GetNamedChild(nodeRef, stringBuffer);
+    if (treeRef->compactTimerRef != NULL)
+    {
+        le_timer_Delete(treeRef->compactTimerRef);
+        treeRef->compactTimerRef = NULL;
+    }
 
-                    if (childRef == NULL)
-                    {
-                        childRef = NewChildNode(nodeRef);
+    free(treeRef->pendingPtr);
+    treeRef->pendingPtr = NULL;
 
-                        if (tdb_SetNodeName(childRef, stringBuffer) != LE_OK)
-                        {
-                            LE_ERROR("Bad node name, '%s'.", stringBuffer);
-                            result = LE_FORMAT_ERROR;
-                            goto cleanup;
-                        }
+    // Sanity check, is the tree actually ready to clean up?
+    LE_ASSERT(treeRef->activeReadCount == 0);
+    LE_ASSERT(treeRef->activeWriteIterRef == NULL);
+    LE_ASSERT(le_sls_IsEmpty(&treeRef->requestList) == true);
+}
 
-                        LE_DEBUG("New node, %s", stringBuffer);
-                    }
 
-                    tdb_EnsureExists(childRef);
 
-                    result = InternalReadNode(childRef, filePtr, newPathLen);
 
-                    if (result != LE_OK)
-                    {
-                        goto cleanup;
-                    }
-                }
-                else if (tokenType == TT_CLOSE_GROUP)
-                {
-                    break;
-                }
-                else
-                {
-                    LE_ERROR("Unexpected token in found while looking for '}'.");
-                    result = LE_FORMAT_ERROR;
-                    goto cleanup;
-                }
-            }
-            break;
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Create a path to a tree file with the given revision id.
+ *
+ *  @return A stringBuffer backed string containing the full path to the tree file.
+ */
+// -------------------------------------------------------------------------------------------------
+static void GetTreePath
+(
+    const char* treeNameRef,  ///< [IN] The name of the tree we're generating a name for.
+    int revisionId,           ///< [IN] Generate a name based on the tree revision.
+    char* pathBuffer,         ///< [IN] Buffer to hold the new path.
+    size_t pathSize           ///< [IN] Size of the path buffer.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // paper    --> rock       1 -> 2
+    // rock     --> scissors   2 -> 3
+    // scissors --> paper      3 -> 1
 
-        case TT_CLOSE_GROUP:
-        default:
-            LE_ERROR("Unexpected token found.");
-            result = LE_FORMAT_ERROR;
-            goto cleanup;
-    }
+    static const char* revNames[] = { "paper", "rock", "scissors" };
+    int printSize;
 
-    if (IsShadow(nodeRef) == false)
-    {
-        ClearModifiedFlag(nodeRef);
-    }
-    else
+    LE_ASSERT((revisionId >= 1) && (revisionId <= 3));
+
+    printSize = snprintf(pathBuffer,
+                         pathSize,
+                         "%s/%s.%s",
+                         CFG_TREE_PATH,
+                         treeNameRef,
+                         revNames[revisionId - 1]);
+
+    if (printSize >= pathSize)
     {
-        SetModifiedFlag(nodeRef);
+       LE_ERROR("Unable to store config tree path in buffer");
+       pathBuffer[0] = '\0';
     }
+}
 
-    tdb_EnsureExists(nodeRef);
 
-cleanup:
-    le_mem_Release(stringBuffer);
-    return result;
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Create a path to the journal of the tree file with the given revision id.
+ */
+// -------------------------------------------------------------------------------------------------
+static void GetJournalPath
+(
+    const char* treeNameRef,  ///< [IN] The name of the tree we're generating a name for.
+    int revisionId,           ///< [IN] The revision of the tree file the journal goes with.
+    char* pathBuffer,         ///< [IN] Buffer to hold the new path.
+    size_t pathSize           ///< [IN] Size of the path buffer.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    GetTreePath(treeNameRef, revisionId, pathBuffer, pathSize);
+
+    if (   (pathBuffer[0] != '\0')
+        && (le_utf8_Append(pathBuffer, JOURNAL_EXTENSION, pathSize, NULL) != LE_OK))
+    {
+       LE_ERROR("Unable to store config tree journal path in buffer");
+       pathBuffer[0] = '\0';
+    }
 }
 
 
@@ -2351,89 +2663,1998 @@ cleanup:
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Serialize a tree node and it's children to a file in the filesystem.
+ *  Check to see if a configTree file at the given revision already exists in the filesystem.
  *
- *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ *  @note If the tree file exists, but is empty, then it is invalid and will be deleted.
+ *
+ *  @return True if the named file exists, false otherwise.
  */
 // -------------------------------------------------------------------------------------------------
-static le_result_t InternalWriteNode
+static bool TreeFileExists
 (
-    tdb_NodeRef_t nodeRef,  ///< [IN] The node being written.
-    FILE* filePtr           ///< [IN] The file being written to.
+    const char* treeNameRef,  ///< [IN] Name of the tree to check.
+    int revisionId            ///< [IN] The revision of the tree to check against.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // If there is no node to write, or if the node is marked as having been deleted...  Then write
-    // a blank node.
-    if (   (nodeRef == NULL)
-        || (IsDeleted(nodeRef) == true))
+    char fullPath[LE_CFG_STR_LEN_BYTES] = "";
+    GetTreePath(treeNameRef, revisionId, fullPath, sizeof(fullPath));
+
+    // Make sure this part was successful.
+    if (fullPath[0] == '\0')
     {
-        return WriteFile(filePtr, "~ ", 2);
+        return false;
     }
 
-    // Get the node's value as a string.
-    char* stringBuffer = le_mem_ForceAlloc(EncodedStringPool);
-    size_t stringBufferSize = TDB_MAX_ENCODED_SIZE;
-    le_result_t result = LE_OK;
+    // stat() the file to see if it exists and get its size.
+    struct stat s;
+    if (stat(fullPath, &s) == -1)
+    {
+        LE_DEBUG("Can't stat file '%s' (%m).", fullPath);
+        return false;
+    }
 
-    tdb_GetValueAsString(nodeRef, stringBuffer, stringBufferSize, "");
+    // Make sure it's a regular file.
+    if (!S_ISREG(s.st_mode))
+    {
+        LE_FATAL("Object at '%s' is not a regular file.", fullPath);
+    }
 
-    // Now, depending on the type of node, write out any required format information.
-    switch (nodeRef->type)
+    // If it's zero size, delete it and report that it doesn't exist.
+    if (s.st_size == 0)
     {
-        case LE_CFG_TYPE_EMPTY:
-        case LE_CFG_TYPE_DOESNT_EXIST:
-            result = WriteFile(filePtr, "~ ", 2);
-            break;
+        if (unlink(fullPath) == -1)
+        {
+            LE_FATAL("Failed to unlink empty file '%s' (%m).", fullPath);
+        }
 
-        case LE_CFG_TYPE_BOOL:
-            {
-                const char boolBuffer[3] = { '!', stringBuffer[0], ' ' };
-                result = WriteFile(filePtr, boolBuffer, sizeof(boolBuffer));
-            }
-            break;
+        return false;
+    }
 
-        case LE_CFG_TYPE_STRING:
-            result = WriteStringValue(filePtr, '\"', '\"', stringBuffer);
-            break;
+    // NOTE: The Config Tree generally runs as root, so permissions should be irrelevant.
 
-        case LE_CFG_TYPE_INT:
-            result = WriteStringValue(filePtr, '[', ']', stringBuffer);
-            break;
+    return true;
+}
 
-        case LE_CFG_TYPE_FLOAT:
-            result = WriteStringValue(filePtr, '(', ')', stringBuffer);
-            break;
 
-        // Looks like this node is a collection, so write out it's child nodes now.
-        case LE_CFG_TYPE_STEM:
-            if ((result = WriteFile(filePtr, "{ ", 2)) == LE_OK)
-            {
-                tdb_NodeRef_t childRef = tdb_GetFirstActiveChildNode(nodeRef);
 
-                while (   (childRef != NULL)
-                       && (result == LE_OK))
-                {
-                    tdb_GetNodeName(childRef, stringBuffer, stringBufferSize);
-                    result = WriteStringValue(filePtr, '\"', '\"', stringBuffer);
 
-                    if (result == LE_OK)
-                    {
-                        result = InternalWriteNode(childRef, filePtr);
-                    }
+// -------------------------------------------------------------------------------------------------
+/**
+ * Check the filesystem and get the current "valid" version of the file and update the tree object
+ * with that version number.
+ *
+ * If there are two files for a given tree, we use the older one.  The idea being, if there are
+ * two versions of the same file in the filesystem then there was a system failure during a save
+ * operation.  So we abandon the newer (probably incomplete) file and go with the older file;
+ * unless the size of the older file is zero, which can happen if deletion of that file is
+ * interrupted.
+ */
+// -------------------------------------------------------------------------------------------------
+static void UpdateRevision
+(
+    tdb_TreeRef_t treeRef  ///< [IN] Update the revision for this tree object.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    int newRevision = 0;
 
-                    childRef = tdb_GetNextActiveSiblingNode(childRef);
-                }
+    if (TreeFileExists(treeRef->name, 1))
+    {
+        if (TreeFileExists(treeRef->name, 3))
+        {
+            newRevision = 3;
+        }
+        else
+        {
+            newRevision = 1;
+        }
+    }
+    else if (TreeFileExists(treeRef->name, 3))
+    {
+        if (TreeFileExists(treeRef->name, 2))
+        {
+            newRevision = 2;
+        }
+        else
+        {
+            newRevision = 3;
+        }
+    }
+    else if (TreeFileExists(treeRef->name, 2))
+    {
+        newRevision = 2;
+    }
 
-                if (result == LE_OK)
-                {
-                    result = WriteFile(filePtr, "} ", 2);
-                }
+    treeRef->revisionId = newRevision;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Peek into the input stream one character ahead.
+ */
+// -------------------------------------------------------------------------------------------------
+static signed char PeekChar
+(
+    FILE* filePtr  ///< [IN] The file stream to peek into.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    char next = fgetc(filePtr);
+    ungetc(next, filePtr);
+
+    return next;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Skip any whitespace encountered in the input stream.  Stop skipping once we hit a valid token.
+ *
+ *  @return LE_OK if the whitespace is skiped and there is still more file to read.
+ *          LE_OUT_OF_RANGE if the end of the file is hit.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t SkipWhiteSpace
+(
+    FILE* filePtr  ///< [IN] The file stream to seek through.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    bool done = false;
+    bool isEof = false;
+
+    while (done == false)
+    {
+        switch (PeekChar(filePtr))
+        {
+            case '\n':
+            case '\r':
+            case '\t':
+            case ' ':
+                // Eat the character.
+                fgetc(filePtr);
+                break;
+
+            case EOF:
+                done = true;
+                isEof = true;
+                break;
+
+            default:
+                done = true;
+                break;
+        }
+    }
+
+    return isEof == true ? LE_OUT_OF_RANGE : LE_OK;
+}
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Skip to the next occurence of the given character.
+ *
+ *  @return LE_OK if the character is found.
+ *          LE_OUT_OF_RANGE if the end of the file is hit.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t SkipToNextChar
+(
+    FILE* filePtr,          ///< [IN] The file stream to seek through.
+    signed char nextChar    ///< [IN]  The character we're searching for.
+)
+{
+    signed char next;
+
+    while ((next = fgetc(filePtr)) != nextChar)
+    {
+        if (next == EOF)
+        {
+            return LE_OUT_OF_RANGE;
+        }
+    }
+
+    return LE_OK;
+}
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a boolean literal from the input file.
+ *
+ *  @return LE_OK if the literal could be read.
+ *          LE_FORMAT_ERROR if the literal could not be read.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool ReadBoolToken
+(
+    FILE* filePtr,     ///< [IN]  The file we're reading from.
+    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+)
+// -------------------------------------------------------------------------------------------------
+{
+    signed char next = fgetc(filePtr);
+
+    if (   (next == 't')
+        || (next == 'f'))
+    {
+        stringPtr[0] = next;
+        stringPtr[1] = 0;
+
+        return LE_OK;
+    }
+
+    return LE_FORMAT_ERROR;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a textual literal from the input file, the read is terminated successfuly if the terminal
+ *  character is found.
+ *
+ *  @return LE_OK if the string is read from the file.
+ *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ *          LE_OVERFLOW if the text doesn't fit in provided buffer (truncated).
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReadTextLiteral
+(
+    FILE* filePtr,        ///< [IN]  The file we're reading from.
+    char* stringPtr,      ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize,    ///< [IN]  How big is the supplied string buffer?
+    signed char terminal  ///< [IN]  The terminal character we're searching for.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    signed char next;
+    size_t count = 0;
+
+    char* oldPtr = stringPtr;
+
+    while ((next = fgetc(filePtr)) != terminal)
+    {
+        if (next == EOF)
+        {
+            LE_ERROR("Missing end specifier, ']' in int value.");
+            return LE_FORMAT_ERROR;
+        }
+
+        if (next == '\\')
+        {
+            next = fgetc(filePtr);
+
+            if (next == EOF)
+            {
+                LE_ERROR("Unexpected EOF after finding \\ character.");
+                return LE_FORMAT_ERROR;
             }
-            break;
+        }
+
+        if (count >= (stringSize - 1))
+        {
+            // truncate the string to the buffer size
+            *stringPtr = 0;
+
+            LE_ERROR("String literal is too large, truncated (%zd/%zd)",
+                     strlen(oldPtr),
+                     stringSize);
+            // move the file pointer to the terminal character (e.g. closing quote)
+            if (LE_OK == SkipToNextChar(filePtr, terminal))
+            {
+                return LE_OVERFLOW;
+            }
+            else
+            {
+                return LE_FORMAT_ERROR;
+            }
+        }
+
+        *stringPtr = next;
+
+        ++stringPtr;
+        ++count;
+    }
+
+    *stringPtr = 0;
+
+    return LE_OK;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read an integer token string from the file.
+ *
+ *  @return LE_OK if the string is read from the file.
+ *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ *          LE_OVERFLOW if the text doesn't fit in provided buffer (truncated).
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReadIntToken
+(
+    FILE* filePtr,     ///< [IN]  The file we're reading from.
+    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, ']');
+
+    // TODO: Validate the int string.
+
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a floating point token string from the file.
+ *
+ *  @return LE_OK if the string is read from the file.
+ *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ *          LE_OVERFLOW if the text doesn't fit in provided buffer (truncated).
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReadFloatToken
+(
+    FILE* filePtr,     ///< [IN]  The file we're reading from.
+    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, ')');
+
+    // TODO: Validate the float string.
+
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a string from the config tree file.
+ *
+ *  @return LE_OK if the string is read from the file.
+ *          LE_FORMAT_ERROR if the text fails to be read from the file.
+ *          LE_OVERFLOW if the text doesn't fit in provided buffer (truncated).
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReadStringToken
+(
+    FILE* filePtr,     ///< [IN]  The file we're reading from.
+    char* stringPtr,   ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize  ///< [IN]  How big is the supplied string buffer?
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_result_t result = ReadTextLiteral(filePtr, stringPtr, stringSize, '"');
+
+    // TODO: Validate the literal string.
+
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a token from the input stream.
+ *
+ *  @return LE_OK if a token could be read.  LE_OUT_OF_RANGE if the end of the stream is reached
+ *          before a token could be finished.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReadToken
+(
+    FILE* filePtr,         ///< [IN]  The file we're reading from.
+    char* stringPtr,       ///< [OUT] String buffer to hold the token we've read.
+    size_t stringSize,     ///< [IN]  How big is the supplied string buffer?
+    TokenType_t* typePtr   ///< [OUT] The type of token read from the file.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    *stringPtr = 0;
+
+    if (SkipWhiteSpace(filePtr) != LE_OK)
+    {
+        return LE_OUT_OF_RANGE;
+    }
+
+    signed char next;
+
+    while ((next = fgetc(filePtr)) != EOF)
+    {
+        switch (next)
+        {
+            case '~':
+                *typePtr = TT_EMPTY_VALUE;
+                return LE_OK;
+
+            case '!':
+                *typePtr = TT_BOOL_VALUE;
+                return ReadBoolToken(filePtr, stringPtr, stringSize);
+
+            case '[':
+                *typePtr = TT_INT_VALUE;
+                return ReadIntToken(filePtr, stringPtr, stringSize);
+
+            case '(':
+                *typePtr = TT_FLOAT_VALUE;
+                return ReadFloatToken(filePtr, stringPtr, stringSize);
+
+            case '\"':
+                *typePtr = TT_STRING_VALUE;
+                return ReadStringToken(filePtr, stringPtr, stringSize);
+
+            case '{':
+                *typePtr = TT_OPEN_GROUP;
+                return LE_OK;
+
+            case '}':
+                *typePtr = TT_CLOSE_GROUP;
+                return LE_OK;
+
+            default:
+                LE_ERROR("Unexpected character in input stream.");
+                return LE_FORMAT_ERROR;
+        }
+    }
+
+    return LE_OUT_OF_RANGE;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Write data to the output stream.  This function will record any faults to the system log.
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t WriteFile
+(
+    FILE* filePtr,        ///< [IN] The file being written to.
+    const void* dataPtr,  ///< [IN] The data being written to the file.
+    size_t dataSize       ///< [IN] The amount of data being written.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    ssize_t written = fwrite(dataPtr, 1, dataSize, filePtr);
+
+    if (ferror(filePtr) != 0)
+    {
+        LE_EMERG("Failed to write to config tree file.");
+        return LE_IO_ERROR;
+    }
+
+    if (written < dataSize)
+    {
+        LE_EMERG("Data truncated while writing to configuration file.");
+        return LE_IO_ERROR;
+    }
+
+    return LE_OK;
+}
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Write a string token to the output stream.  This function will write the string and escape all
+ *  control characters as it does so.
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t WriteStringValue
+(
+    FILE* filePtr,         ///< [IN] The file to write to.
+    char startChar,        ///< [IN] The delimiter to use.
+    char endChar,          ///< [IN] The closing delimiter to use.
+    const char* stringPtr  ///< [IN] The actual string to write.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    le_result_t result = LE_OK;
+
+    result = WriteFile(filePtr, &startChar, 1);
+
+    while (   (*stringPtr != 0)
+           && (result == LE_OK))
+    {
+        if (   (*stringPtr == '\"')
+            || (*stringPtr == '\\'))
+        {
+            result = WriteFile(filePtr, "\\", 1);
+        }
+
+        if (result == LE_OK)
+        {
+            result = WriteFile(filePtr, stringPtr, 1);
+        }
+
+        stringPtr++;
+    }
+
+    if (result == LE_OK)
+    {
+        char strBuffer[2] = { endChar, ' ' };
+        result = WriteFile(filePtr, strBuffer, sizeof(strBuffer));
+    }
+
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a node value from the given file.  If the value is a collection, then read in those nodes
+ *  too.
+ *
+ *  @return LE_OK if the read is successful.
+ *          LE_FORMAT_ERROR if parse errors are encountered.
+ *          LE_NOT_FOUND if the end of file is reached.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t InternalReadNode
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node we're reading a value for.
+    FILE* filePtr,          ///< [IN] The file we're reading the value from.
+    size_t pathLen          ///< [IN] The length of the path including nodeRef.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    char* stringBuffer = le_mem_ForceAlloc(EncodedStringPool);
+    size_t stringBufferSize = TDB_MAX_ENCODED_SIZE;
+    le_result_t result = LE_OK;
+
+    TokenType_t tokenType;
+
+    // Try to read this node's value.
+    result = ReadToken(filePtr, stringBuffer, stringBufferSize, &tokenType);
+    if ((result != LE_OK) && (result != LE_OVERFLOW))
+    {
+        LE_ERROR("Unexpected EOF or bad token in file.");
+        result = LE_FORMAT_ERROR;
+        goto cleanup;
+    }
+    // if result is OVERFLOW (i.e. string is truncated), we still should be able
+    // to proceed with parsing the rest of the file.
+    result = LE_OK;
+
+    tdb_SetEmpty(nodeRef);
+
+    switch (tokenType)
+    {
+        case TT_BOOL_VALUE:
+            tdb_SetValueAsString(nodeRef, stringBuffer);
+            nodeRef->type = LE_CFG_TYPE_BOOL;
+            break;
+
+        case TT_INT_VALUE:
+            tdb_SetValueAsString(nodeRef, stringBuffer);
+            nodeRef->type = LE_CFG_TYPE_INT;
+            break;
+
+        case TT_FLOAT_VALUE:
+            tdb_SetValueAsString(nodeRef, stringBuffer);
+            nodeRef->type = LE_CFG_TYPE_FLOAT;
+            break;
+
+        case TT_STRING_VALUE:
+            tdb_SetValueAsString(nodeRef, stringBuffer);
+            break;
+
+        case TT_EMPTY_VALUE:
+            // The node has already been cleared, so there's nothing left to do but make sure that
+            // the node exists.
+            ClearDeletedFlag(nodeRef);
+            break;
+
+        case TT_OPEN_GROUP:
+            while (tokenType != TT_CLOSE_GROUP)
+            {
+                if (ReadToken(filePtr, stringBuffer, stringBufferSize, &tokenType) != LE_OK)
+                {
+                    LE_ERROR("Unexpected EOF or bad token in file while looking for '}'.");
+                    result = LE_FORMAT_ERROR;
+                    goto cleanup;
+                }
+
+                if (tokenType == TT_STRING_VALUE)
+                {
+                    size_t strLen = le_utf8_NumBytes(stringBuffer);
+                    size_t newPathLen = pathLen + 1 + strLen;
+
+                    if (newPathLen > LE_CFG_STR_LEN)
+                    {
+                        LE_ERROR("New path length for node '%s' is too long.  %zu of %zu bytes.",
+                                 stringBuffer,
+                                 strLen,
+                                 (size_t)LE_CFG_STR_LEN);
+
+                        result = LE_FORMAT_ERROR;
+                        goto cleanup;
+                    }
+
+                    tdb_NodeRef_t childRef = GetNamedChild(nodeRef, stringBuffer);
+
+                    if (childRef == NULL)
+                    {
+                        childRef = NewChildNode(nodeRef);
+
+                        if (tdb_SetNodeName(childRef, stringBuffer) != LE_OK)
+                        {
+                            LE_ERROR("Bad node name, '%s'.", stringBuffer);
+                            result = LE_FORMAT_ERROR;
+                            goto cleanup;
+                        }
+
+                        LE_DEBUG("New node, %s", stringBuffer);
+                    }
+
+                    tdb_EnsureExists(childRef);
+
+                    result = InternalReadNode(childRef, filePtr, newPathLen);
+
+                    if (result != LE_OK)
+                    {
+                        goto cleanup;
+                    }
+                }
+                else if (tokenType == TT_CLOSE_GROUP)
+                {
+                    break;
+                }
+                else
+                {
+                    LE_ERROR("Unexpected token in found while looking for '}'.");
+                    result = LE_FORMAT_ERROR;
+                    goto cleanup;
+                }
+            }
+            break;
+
+        case TT_CLOSE_GROUP:
+        default:
+            LE_ERROR("Unexpected token found.");
+            result = LE_FORMAT_ERROR;
+            goto cleanup;
+    }
+
+    if (IsShadow(nodeRef) == false)
+    {
+        ClearModifiedFlag(nodeRef);
+    }
+    else
+    {
+        SetModifiedFlag(nodeRef);
+    }
+
+    tdb_EnsureExists(nodeRef);
+
+cleanup:
+    le_mem_Release(stringBuffer);
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Serialize a tree node and it's children to a file in the filesystem.
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t InternalWriteNode
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node being written.
+    FILE* filePtr           ///< [IN] The file being written to.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // If there is no node to write, or if the node is marked as having been deleted...  Then write
+    // a blank node.
+    if (   (nodeRef == NULL)
+        || (IsDeleted(nodeRef) == true))
+    {
+        return WriteFile(filePtr, "~ ", 2);
+    }
+
+    // Get the node's value as a string.
+    char* stringBuffer = le_mem_ForceAlloc(EncodedStringPool);
+    size_t stringBufferSize = TDB_MAX_ENCODED_SIZE;
+    le_result_t result = LE_OK;
+
+    tdb_GetValueAsString(nodeRef, stringBuffer, stringBufferSize, "");
+
+    // Now, depending on the type of node, write out any required format information.
+    switch (nodeRef->type)
+    {
+        case LE_CFG_TYPE_EMPTY:
+        case LE_CFG_TYPE_DOESNT_EXIST:
+            result = WriteFile(filePtr, "~ ", 2);
+            break;
+
+        case LE_CFG_TYPE_BOOL:
+            {
+                const char boolBuffer[3] = { '!', stringBuffer[0], ' ' };
+                result = WriteFile(filePtr, boolBuffer, sizeof(boolBuffer));
+            }
+            break;
+
+        case LE_CFG_TYPE_STRING:
+            result = WriteStringValue(filePtr, '\"', '\"', stringBuffer);
+            break;
+
+        case LE_CFG_TYPE_INT:
+            result = WriteStringValue(filePtr, '[', ']', stringBuffer);
+            break;
+
+        case LE_CFG_TYPE_FLOAT:
+            result = WriteStringValue(filePtr, '(', ')', stringBuffer);
+            break;
+
+        // Looks like this node is a collection, so write out it's child nodes now.
+        case LE_CFG_TYPE_STEM:
+            if ((result = WriteFile(filePtr, "{ ", 2)) == LE_OK)
+            {
+                tdb_NodeRef_t childRef = tdb_GetFirstActiveChildNode(nodeRef);
+
+                while (   (childRef != NULL)
+                       && (result == LE_OK))
+                {
+                    tdb_GetNodeName(childRef, stringBuffer, stringBufferSize);
+                    result = WriteStringValue(filePtr, '\"', '\"', stringBuffer);
+
+                    if (result == LE_OK)
+                    {
+                        result = InternalWriteNode(childRef, filePtr);
+                    }
+
+                    childRef = tdb_GetNextActiveSiblingNode(childRef);
+                }
+
+                if (result == LE_OK)
+                {
+                    result = WriteFile(filePtr, "} ", 2);
+                }
+            }
+            break;
+    }
+
+    le_mem_Release(stringBuffer);
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Calculate the number of bytes required to store a node path, including seperators and a trailing
+ *  NULL.
+ *
+ *  @return The amount of bytes required to store the whole path string.
+ */
+// -------------------------------------------------------------------------------------------------
+static size_t ComputePathLength
+(
+    tdb_NodeRef_t nodeRef  ///< [IN] Compute a path for this node.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    size_t pathLen = 0;
+    char nodeName[LE_CFG_NAME_LEN_BYTES] = "";
+
+    while (nodeRef != NULL)
+    {
+        LE_ASSERT(tdb_GetNodeName(nodeRef, nodeName, sizeof(nodeName)) == LE_OK);
+
+        // Add this path segment's length to our running total, along with the required path
+        // seperator.
+        pathLen += 1 + le_utf8_NumBytes(nodeName);
+        nodeRef = tdb_GetNodeParent(nodeRef);
+    }
+
+    // Don't forget to include a spot for the trailing NULL.
+    return pathLen + 1;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Unmap a snapshot once no stem is left to read children from it.  Called automatically by the
+ *  memory system when a snapshot is released.
+ */
+// -------------------------------------------------------------------------------------------------
+static void SnapshotDestructor
+(
+    void* objectPtr  ///< [IN] The snapshot being freed.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    Snapshot_t* snapshotPtr = (Snapshot_t*)objectPtr;
+
+    if (munmap(snapshotPtr->mapPtr, snapshotPtr->mapSize) == -1)
+    {
+        LE_ERROR("Could not unmap configuration snapshot (%m).");
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Check if a file holds a snapshot rather than a tree in the text format.
+ *
+ *  @return True if the file starts with the snapshot magic.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool IsSnapshotFile
+(
+    int descriptor  ///< [IN] The file to check.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    char magic[SNAPSHOT_MAGIC_BYTES];
+    ssize_t readSize;
+
+    // Streams that can't be read from the start, like pipes, can only hold text.
+    do
+    {
+        readSize = pread(descriptor, magic, sizeof(magic), 0);
+    }
+    while (   (readSize == -1)
+           && (errno == EINTR));
+
+    return    (readSize == sizeof(magic))
+           && (memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) == 0);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Check the records of a snapshot, so that its nodes can be read later on without checking them
+ *  again.  Each record but the root's has to be the child of an earlier stem, and each stem's
+ *  children have to follow the children of the stems before it.  Names have to be valid node
+ *  names, and paths can't get longer than they can in the text format.
+ *
+ *  @return True if the snapshot is valid.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool CheckSnapshot
+(
+    const Snapshot_t* snapshotPtr,  ///< [IN] The snapshot to check.
+    size_t pathLen                  ///< [IN] Length of the path of the node being read into.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    const char* stringsPtr = snapshotPtr->stringsPtr;
+    uint32_t stringsSize = snapshotPtr->stringsSize;
+
+    // Every string in the table is terminated, so the last byte of the table has to be a NULL.
+    if (   (stringsSize == 0)
+        || (stringsPtr[stringsSize - 1] != '\0'))
+    {
+        LE_ERROR("Bad snapshot string table.");
+        return false;
+    }
+
+    size_t* pathLensPtr = malloc(snapshotPtr->recordCount * sizeof(size_t));
+    LE_ASSERT(pathLensPtr != NULL);
+
+    uint32_t nextChild = 1;
+    uint32_t i;
+    bool isValid = true;
+
+    pathLensPtr[0] = pathLen;
+
+    for (i = 0; (i < snapshotPtr->recordCount) && (isValid == true); i++)
+    {
+        const SnapshotRecord_t* recordPtr = &snapshotPtr->recordsPtr[i];
+
+        if (i > 0)
+        {
+            const char* namePtr = stringsPtr + recordPtr->nameOffset;
+            size_t nameLen = 0;
+
+            isValid =    (i < nextChild)
+                      && (recordPtr->nameOffset < stringsSize)
+                      && ((nameLen = strlen(namePtr)) > 0)
+                      && (nameLen <= LE_CFG_NAME_LEN)
+                      && (strcmp(namePtr, ".") != 0)
+                      && (strcmp(namePtr, "..") != 0)
+                      && (strpbrk(namePtr, "/:") == NULL);
+
+            if (isValid == true)
+            {
+                pathLensPtr[i] += nameLen;
+
+                if (pathLensPtr[i] > LE_CFG_STR_LEN)
+                {
+                    LE_ERROR("Path of snapshot node '%s' is too long.", namePtr);
+                    isValid = false;
+                }
+            }
+        }
+
+        if (isValid == false)
+        {
+            break;
+        }
+
+        switch (recordPtr->type)
+        {
+            case LE_CFG_TYPE_EMPTY:
+                break;
+
+            case LE_CFG_TYPE_STEM:
+                isValid =    (recordPtr->first == nextChild)
+                          && ((uint64_t)recordPtr->first + recordPtr->count
+                                                                   <= snapshotPtr->recordCount);
+
+                if (isValid == true)
+                {
+                    uint32_t childIndex;
+
+                    for (childIndex = recordPtr->first;
+                         childIndex < recordPtr->first + recordPtr->count;
+                         childIndex++)
+                    {
+                        pathLensPtr[childIndex] = pathLensPtr[i] + 1;
+                    }
+
+                    nextChild += recordPtr->count;
+                }
+                break;
+
+            case LE_CFG_TYPE_STRING:
+            case LE_CFG_TYPE_BOOL:
+            case LE_CFG_TYPE_INT:
+            case LE_CFG_TYPE_FLOAT:
+                isValid =    ((uint64_t)recordPtr->first + recordPtr->count < stringsSize)
+                          && (recordPtr->count < TDB_MAX_ENCODED_SIZE)
+                          && (memchr(stringsPtr + recordPtr->first, '\0', recordPtr->count) == NULL)
+                          && (stringsPtr[recordPtr->first + recordPtr->count] == '\0');
+                break;
+
+            default:
+                isValid = false;
+                break;
+        }
+    }
+
+    if (isValid == false)
+    {
+        LE_ERROR("Bad snapshot record %" PRIu32 ".", i);
+    }
+    else if (nextChild != snapshotPtr->recordCount)
+    {
+        LE_ERROR("Snapshot has records that aren't part of the tree.");
+        isValid = false;
+    }
+
+    free(pathLensPtr);
+    return isValid;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Map a snapshot file into memory and check it.
+ *
+ *  @return The snapshot, or NULL if the file couldn't be mapped or isn't a valid snapshot.
+ */
+// -------------------------------------------------------------------------------------------------
+static Snapshot_t* MapSnapshot
+(
+    int descriptor,  ///< [IN] The snapshot file.
+    size_t pathLen   ///< [IN] Length of the path of the node being read into.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    struct stat fileStat;
+
+    if (fstat(descriptor, &fileStat) == -1)
+    {
+        LE_ERROR("Could not stat configuration snapshot (%m).");
+        return NULL;
+    }
+
+    if (fileStat.st_size < (off_t)sizeof(SnapshotHeader_t))
+    {
+        LE_ERROR("Configuration snapshot is truncated.");
+        return NULL;
+    }
+
+    void* mapPtr = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+    if (mapPtr == MAP_FAILED)
+    {
+        LE_ERROR("Could not map configuration snapshot (%m).");
+        return NULL;
+    }
+
+    Snapshot_t* snapshotPtr = le_mem_ForceAlloc(SnapshotPool);
+    const SnapshotHeader_t* headerPtr = mapPtr;
+
+    snapshotPtr->mapPtr = mapPtr;
+    snapshotPtr->mapSize = fileStat.st_size;
+
+    if (headerPtr->version != SNAPSHOT_VERSION)
+    {
+        LE_ERROR("Unsupported configuration snapshot version, %" PRIu32 ".", headerPtr->version);
+        le_mem_Release(snapshotPtr);
+        return NULL;
+    }
+
+    if (   (headerPtr->recordCount == 0)
+        || (  sizeof(SnapshotHeader_t)
+            + ((uint64_t)headerPtr->recordCount * sizeof(SnapshotRecord_t))
+            + headerPtr->stringsSize != (uint64_t)fileStat.st_size))
+    {
+        LE_ERROR("Configuration snapshot size doesn't match its header.");
+        le_mem_Release(snapshotPtr);
+        return NULL;
+    }
+
+    snapshotPtr->recordsPtr = (const SnapshotRecord_t*)(headerPtr + 1);
+    snapshotPtr->recordCount = headerPtr->recordCount;
+    snapshotPtr->stringsPtr = (const char*)(snapshotPtr->recordsPtr + headerPtr->recordCount);
+    snapshotPtr->stringsSize = headerPtr->stringsSize;
+
+    if (CheckSnapshot(snapshotPtr, pathLen) == false)
+    {
+        le_mem_Release(snapshotPtr);
+        return NULL;
+    }
+
+    return snapshotPtr;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read all of the nodes under a stem out of the snapshot it was read from.
+ */
+// -------------------------------------------------------------------------------------------------
+static void ReadSnapshotTree
+(
+    tdb_NodeRef_t nodeRef  ///< [IN] The stem to read.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (nodeRef->type != LE_CFG_TYPE_STEM)
+    {
+        return;
+    }
+
+    tdb_NodeRef_t childRef = tdb_GetFirstChildNode(nodeRef);
+
+    while (childRef != NULL)
+    {
+        ReadSnapshotTree(childRef);
+        childRef = tdb_GetNextSiblingNode(childRef);
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read a node from a snapshot file.  The node's children are read as they're needed, while the
+ *  snapshot stays mapped.  Except in shadow trees, where the nodes are all read straight away: they
+ *  will all be merged anyway, and the file being imported may not stay the same.
+ *
+ *  @return True if the read is successful, or false if not.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool ReadSnapshot
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node to read into.  It must be empty.
+    int descriptor          ///< [IN] The snapshot file.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    size_t pathLen = ComputePathLength(nodeRef);
+
+    if (pathLen >= LE_CFG_STR_LEN)
+    {
+        return false;
+    }
+
+    Snapshot_t* snapshotPtr = MapSnapshot(descriptor, pathLen);
+
+    if (snapshotPtr == NULL)
+    {
+        return false;
+    }
+
+    ReadSnapshotNode(nodeRef, snapshotPtr, 0);
+
+    if (IsShadow(nodeRef))
+    {
+        ReadSnapshotTree(nodeRef);
+    }
+
+    le_mem_Release(snapshotPtr);
+    return true;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Add a string to the string table of a snapshot being written.  Strings that are already in the
+ *  table, like the names of nodes that each stem of a collection has, are only stored once.
+ *
+ *  @return Offset of the string in the table.
+ */
+// -------------------------------------------------------------------------------------------------
+static uint32_t AddSnapshotString
+(
+    SnapshotWriter_t* writerPtr,  ///< [IN] The snapshot being written.
+    const char* stringPtr         ///< [IN] The string to add.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    size_t stringSize = strlen(stringPtr) + 1;
+    size_t slot;
+
+    // Keep the table of slots at most half full.
+    if ((writerPtr->stringCount + 1) * 2 > writerPtr->slotCount)
+    {
+        size_t slotCount = (writerPtr->slotCount == 0) ? 1024 : writerPtr->slotCount * 2;
+        uint32_t* slotsPtr = calloc(slotCount, sizeof(uint32_t));
+        size_t i;
+
+        LE_ASSERT(slotsPtr != NULL);
+
+        for (i = 0; i < writerPtr->slotCount; i++)
+        {
+            if (writerPtr->slotsPtr[i] != 0)
+            {
+                slot = le_hashmap_HashString(writerPtr->stringsPtr + writerPtr->slotsPtr[i] - 1);
+
+                while (slotsPtr[slot & (slotCount - 1)] != 0)
+                {
+                    slot++;
+                }
+
+                slotsPtr[slot & (slotCount - 1)] = writerPtr->slotsPtr[i];
+            }
+        }
+
+        free(writerPtr->slotsPtr);
+        writerPtr->slotsPtr = slotsPtr;
+        writerPtr->slotCount = slotCount;
+    }
+
+    // Slots hold the offset of their string plus 1, so that 0 is a free slot.
+    for (slot = le_hashmap_HashString(stringPtr);
+         writerPtr->slotsPtr[slot & (writerPtr->slotCount - 1)] != 0;
+         slot++)
+    {
+        uint32_t offset = writerPtr->slotsPtr[slot & (writerPtr->slotCount - 1)] - 1;
+
+        if (strcmp(writerPtr->stringsPtr + offset, stringPtr) == 0)
+        {
+            return offset;
+        }
+    }
+
+    if (writerPtr->stringsSize + stringSize > writerPtr->stringsCapacity)
+    {
+        size_t capacity = (writerPtr->stringsCapacity == 0) ? 4096 : writerPtr->stringsCapacity;
+
+        while (writerPtr->stringsSize + stringSize > capacity)
+        {
+            capacity *= 2;
+        }
+
+        writerPtr->stringsPtr = realloc(writerPtr->stringsPtr, capacity);
+        LE_ASSERT(writerPtr->stringsPtr != NULL);
+        writerPtr->stringsCapacity = capacity;
+    }
+
+    uint32_t offset = writerPtr->stringsSize;
+
+    memcpy(writerPtr->stringsPtr + offset, stringPtr, stringSize);
+    writerPtr->stringsSize += stringSize;
+    writerPtr->slotsPtr[slot & (writerPtr->slotCount - 1)] = offset + 1;
+    writerPtr->stringCount++;
+
+    return offset;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Add a node to the records of a snapshot being written.  The rest of the record is filled out
+ *  when its turn comes, so that the node's children are added after the nodes before it.
+ */
+// -------------------------------------------------------------------------------------------------
+static void AddSnapshotRecord
+(
+    SnapshotWriter_t* writerPtr,  ///< [IN] The snapshot being written.
+    tdb_NodeRef_t nodeRef,        ///< [IN] The node to add.
+    uint32_t nameOffset           ///< [IN] Offset of the node's name in the string table.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (writerPtr->recordCount == writerPtr->recordCapacity)
+    {
+        size_t capacity = (writerPtr->recordCapacity == 0) ? 256 : writerPtr->recordCapacity * 2;
+
+        writerPtr->nodesPtr = realloc(writerPtr->nodesPtr, capacity * sizeof(tdb_NodeRef_t));
+        writerPtr->recordsPtr = realloc(writerPtr->recordsPtr,
+                                        capacity * sizeof(SnapshotRecord_t));
+        LE_ASSERT(   (writerPtr->nodesPtr != NULL)
+                  && (writerPtr->recordsPtr != NULL));
+
+        writerPtr->recordCapacity = capacity;
+    }
+
+    SnapshotRecord_t* recordPtr = &writerPtr->recordsPtr[writerPtr->recordCount];
+
+    recordPtr->type = LE_CFG_TYPE_EMPTY;
+    recordPtr->nameOffset = nameOffset;
+    recordPtr->first = 0;
+    recordPtr->count = 0;
+
+    writerPtr->nodesPtr[writerPtr->recordCount] = nodeRef;
+    writerPtr->recordCount++;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Bump up the version id of this tree.
+ */
+// -------------------------------------------------------------------------------------------------
+static void IncrementRevision
+(
+    tdb_TreeRef_t treeRef  ///< [IN] Increment the revision of this tree.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    treeRef->revisionId++;
+
+    if (treeRef->revisionId > 3)
+    {
+        treeRef->revisionId = 1;
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Delete the journal of a tree file, if there is one.
+ */
+// -------------------------------------------------------------------------------------------------
+static void DeleteJournal
+(
+    const char* treeNameRef,  ///< [IN] Name of the tree.
+    int revisionId            ///< [IN] The revision of the tree file the journal goes with.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    char journalPath[LE_CFG_STR_LEN_BYTES] = "";
+    GetJournalPath(treeNameRef, revisionId, journalPath, sizeof(journalPath));
+
+    if (   (journalPath[0] != '\0')
+        && (unlink(journalPath) == -1)
+        && (errno != ENOENT))
+    {
+        LE_ERROR("Journal delete failure, '%s', reason '%m'.", journalPath);
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Read and check a journal record header.
+ *
+ *  @return LE_OK if a valid header was read.
+ *          LE_OUT_OF_RANGE if the end of the file was hit.
+ *          LE_FORMAT_ERROR if the header is malformed.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReadJournalHeader
+(
+    FILE* filePtr,        ///< [IN]  The journal being read.
+    size_t* recordSizePtr, ///< [OUT] Size of the record following the header.
+    uint32_t* crcPtr      ///< [OUT] CRC32 of the record following the header.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    char header[JOURNAL_HEADER_SIZE + 1] = "";
+
+    if (fread(header, 1, JOURNAL_HEADER_SIZE, filePtr) != JOURNAL_HEADER_SIZE)
+    {
+        return LE_OUT_OF_RANGE;
+    }
+
+    if (   (header[0] != '#')
+        || (header[JOURNAL_HEADER_SIZE - 1] != '\n')
+        || (sscanf(header, "#%8zx %8" SCNx32, recordSizePtr, crcPtr) != 2))
+    {
+        return LE_FORMAT_ERROR;
+    }
+
+    return LE_OK;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Check the records of a journal.  Reading stops at the first record that is incomplete or fails
+ *  its CRC check, as that's where the daemon or the system went down while the record was being
+ *  written.
+ *
+ *  @return The size of the journal up to the end of the last valid record.
+ */
+// -------------------------------------------------------------------------------------------------
+static size_t CheckJournal
+(
+    FILE* filePtr  ///< [IN] The journal to check.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    char buffer[512];
+    size_t validSize = 0;
+    size_t recordSize;
+    uint32_t crc;
+
+    while (ReadJournalHeader(filePtr, &recordSize, &crc) == LE_OK)
+    {
+        uint32_t recordCrc = LE_CRC_START_CRC32;
+        size_t remaining = recordSize;
+
+        while (remaining > 0)
+        {
+            size_t readSize = fread(buffer,
+                                    1,
+                                    (remaining < sizeof(buffer)) ? remaining : sizeof(buffer),
+                                    filePtr);
+
+            if (readSize == 0)
+            {
+                break;
+            }
+
+            recordCrc = le_crc_Crc32((uint8_t*)buffer, readSize, recordCrc);
+            remaining -= readSize;
+        }
+
+        if (   (remaining != 0)
+            || (recordCrc != crc))
+        {
+            break;
+        }
+
+        validSize += JOURNAL_HEADER_SIZE + recordSize;
+    }
+
+    return validSize;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Traverse the given path in an original tree and create nodes as needed, the way the merge
+ *  created them when the journaled change was committed.
+ *
+ *  @return The found or newly created node at the end of the given path, or NULL if the path is
+ *          bad.
+ */
+// -------------------------------------------------------------------------------------------------
+static tdb_NodeRef_t CreateJournalNodePath
+(
+    tdb_NodeRef_t rootRef,         ///< [IN] The root node of the tree.
+    le_pathIter_Ref_t nodePathRef  ///< [IN] The path we're creating within the tree.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    tdb_NodeRef_t currentRef = rootRef;
+    char nameRef[LE_CFG_NAME_LEN_BYTES] = "";
+
+    le_result_t result = le_pathIter_GoToStart(nodePathRef);
+
+    while (result == LE_OK)
+    {
+        if (le_pathIter_GetCurrentNode(nodePathRef, nameRef, sizeof(nameRef)) != LE_OK)
+        {
+            return NULL;
+        }
+
+        tdb_NodeRef_t childRef = GetNamedChild(currentRef, nameRef);
+
+        if (childRef == NULL)
+        {
+            // A value node gets cleared before children are added to it.
+            if (currentRef->type != LE_CFG_TYPE_STEM)
+            {
+                tdb_SetEmpty(currentRef);
+                ClearModifiedFlag(currentRef);
+            }
+
+            childRef = NewChildNode(currentRef);
+
+            if (tdb_SetNodeName(childRef, nameRef) != LE_OK)
+            {
+                le_mem_Release(childRef);
+                return NULL;
+            }
+
+            ClearModifiedFlag(childRef);
+        }
+
+        currentRef = childRef;
+        result = le_pathIter_GoToNext(nodePathRef);
+    }
+
+    return currentRef;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Apply the changes recorded in a journal to a tree.  The journal must have already been checked
+ *  with CheckJournal().
+ *
+ *  A record is a series of changes, each one either a node set to a new value or a node deleted:
+ *
+ *  @verbatim
+    = "/path/to/node" <value>
+    - "/path/to/node"
+    @endverbatim
+ *
+ *  The values are written the same way as in tree files.
+ *
+ *  @return LE_OK if the changes were applied, LE_FORMAT_ERROR if the journal couldn't be parsed.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ApplyJournal
+(
+    tdb_TreeRef_t treeRef,  ///< [IN] The tree to apply the changes to.
+    FILE* filePtr,          ///< [IN] The journal to read the changes from.
+    size_t journalSize      ///< [IN] Size of the valid part of the journal.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    char* stringBuffer = le_mem_ForceAlloc(EncodedStringPool);
+    le_result_t result = LE_OK;
+
+    while (   (result == LE_OK)
+           && (SkipWhiteSpace(filePtr) == LE_OK)
+           && (ftell(filePtr) < (long)journalSize))
+    {
+        signed char operation = fgetc(filePtr);
+        TokenType_t tokenType;
+
+        // Skip over record headers, they've been checked already.
+        if (operation == '#')
+        {
+            if (fseek(filePtr, JOURNAL_HEADER_SIZE - 1, SEEK_CUR) != 0)
+            {
+                result = LE_FORMAT_ERROR;
+            }
+            continue;
+        }
+
+        if (   (   (operation != '=')
+                && (operation != '-'))
+            || (ReadToken(filePtr, stringBuffer, TDB_MAX_ENCODED_SIZE, &tokenType) != LE_OK)
+            || (tokenType != TT_STRING_VALUE))
+        {
+            LE_ERROR("Unexpected token in journal.");
+            result = LE_FORMAT_ERROR;
+            break;
+        }
+
+        le_pathIter_Ref_t pathRef = le_pathIter_CreateForUnix(stringBuffer);
+
+        if (operation == '=')
+        {
+            tdb_NodeRef_t nodeRef = CreateJournalNodePath(treeRef->rootNodeRef, pathRef);
+
+            if (nodeRef == NULL)
+            {
+                LE_ERROR("Bad node path in journal, '%s'.", stringBuffer);
+                result = LE_FORMAT_ERROR;
+            }
+            else
+            {
+                result = InternalReadNode(nodeRef, filePtr, ComputePathLength(nodeRef));
+            }
+        }
+        else
+        {
+            tdb_NodeRef_t nodeRef = tdb_GetNode(treeRef->rootNodeRef, pathRef);
+
+            // As in a merge, deleting the root node just clears it out.
+            if (nodeRef == treeRef->rootNodeRef)
+            {
+                tdb_SetEmpty(nodeRef);
+                ClearModifiedFlag(nodeRef);
+            }
+            else if (nodeRef != NULL)
+            {
+                le_mem_Release(nodeRef);
+            }
+        }
+
+        le_pathIter_Delete(pathRef);
+    }
+
+    le_mem_Release(stringBuffer);
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Replay the journal of a tree's current revision on top of the tree loaded from the revision
+ *  file.  Any incomplete record at the end of the journal is cut off, so that new records can be
+ *  appended after the valid ones.
+ *
+ *  @return LE_OK if the journal was replayed or there isn't one, LE_FORMAT_ERROR if the journal
+ *          couldn't be parsed.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t ReplayJournal
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree to replay the journal of.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    char journalPath[LE_CFG_STR_LEN_BYTES] = "";
+    GetJournalPath(treeRef->name, treeRef->revisionId, journalPath, sizeof(journalPath));
+
+    FILE* filePtr = fopen(journalPath, "r");
+
+    if (filePtr == NULL)
+    {
+        LE_ERROR_IF(errno != ENOENT, "Could not open journal: %s, reason: %m", journalPath);
+        return LE_OK;
+    }
+
+    size_t journalSize = CheckJournal(filePtr);
+    long fileSize = ftell(filePtr);
+
+    if (fileSize > (long)journalSize)
+    {
+        LE_WARN("Dropping %ld bytes of incomplete records from journal '%s'.",
+                fileSize - (long)journalSize,
+                journalPath);
+
+        LE_ERROR_IF(truncate(journalPath, journalSize) == -1,
+                    "Could not truncate journal: %s, reason: %m",
+                    journalPath);
+    }
+
+    rewind(filePtr);
+    le_result_t result = ApplyJournal(treeRef, filePtr, journalSize);
+
+    fclose(filePtr);
+
+    LE_DEBUG("** Replayed %zu bytes of journal from '%s'.", journalSize, journalPath);
+    treeRef->journalSize = journalSize;
+
+    return result;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Attempt to load a configuration tree from a config file.  This function will look for the latest
+ *  valid version of the config file and load that one.
+ */
+// -------------------------------------------------------------------------------------------------
+static void LoadTree
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree object to load from the filesystem.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // If we don't know the revision then hunt it out from the filesystem.
+    if (treeRef->revisionId == 0)
+    {
+        UpdateRevision(treeRef);
+    }
+
+    // If this tree has no root, create it now.
+    if (treeRef->rootNodeRef == NULL)
+    {
+        treeRef->rootNodeRef = NewNode();
+    }
+
+    // Ok, if we found a valid revision of the tree in the fs, try to load it now.
+    if (treeRef->revisionId != 0)
+    {
+        char pathPtr[LE_CFG_STR_LEN_BYTES] = "";
+        GetTreePath(treeRef->name, treeRef->revisionId, pathPtr, sizeof(pathPtr));
+
+        LE_DEBUG("** Loading configuration tree from '%s'.", pathPtr);
+
+        int fileRef = -1;
+
+        do
+        {
+            fileRef = open(pathPtr, O_RDONLY);
+        }
+        while ((fileRef == -1) && (errno == EINTR));
+
+        tdb_EnsureExists(treeRef->rootNodeRef);
+
+        if (fileRef == -1)
+        {
+            LE_ERROR("Could not open configuration tree file: %s, reason: %s",
+                     pathPtr,
+                     strerror(errno));
+        }
+        else
+        {
+            struct stat fileStat;
+            le_clk_Time_t startTime = le_clk_GetRelativeTime();
+            bool isSnapshot = IsSnapshotFile(fileRef);
+
+            if (fstat(fileRef, &fileStat) == 0)
+            {
+                treeRef->revisionSize = fileStat.st_size;
+            }
+
+            if (tdb_ReadTreeNode(treeRef->rootNodeRef, fileRef) == false)
+            {
+                LE_ERROR("Could not parse configuration tree file: %s.", pathPtr);
+                le_mem_Release(treeRef->rootNodeRef);
+                treeRef->rootNodeRef = NewNode();
+            }
+            else if (ReplayJournal(treeRef) != LE_OK)
+            {
+                // The tree is left with the changes that could be replayed.  The next commit will
+                // write the whole tree.
+                LE_ERROR("Could not replay journal of configuration tree file: %s.", pathPtr);
+                treeRef->revisionSize = 0;
+            }
+            else
+            {
+                // Nodes of a snapshot are mostly read after this, as they're first used.
+                le_clk_Time_t loadTime = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+                LE_INFO("Loaded tree '%s' from %zu byte %s in %" PRIu64 " us.",
+                        treeRef->name,
+                        treeRef->revisionSize,
+                        isSnapshot ? "snapshot" : "file",
+                        ((uint64_t)loadTime.sec * 1000000) + loadTime.usec);
+            }
+
+            close(fileRef);
+        }
+    }
+
+    // Journals of other revisions are left over from compactions that were interrupted.
+    for (int id = 1; id <= 3; id++)
+    {
+        if (id != treeRef->revisionId)
+        {
+            DeleteJournal(treeRef->name, id);
+        }
+    }
+}
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Removes the handler object from the given registration object.  This function will also free the
+ *  memory that the handler object had used.
+ */
+// -------------------------------------------------------------------------------------------------
+static void RemoveHandler
+(
+    Registration_t* registrationPtr,  ///< [IN] The registration object to remove the link from.
+    Handler_t* handlerPtr             ///< [IN] The handler object we're removing.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // Kill the ref, and remove the object from the registration list.
+    le_ref_DeleteRef(HandlerSafeRefMap, handlerPtr->safeRef);
+    le_dls_Remove(&registrationPtr->handlerList, &handlerPtr->link);
+
+    // Clear out the link data, just to be safe.
+    handlerPtr->link = LE_DLS_LINK_INIT;
+    handlerPtr->sessionRef = NULL;
+    handlerPtr->registrationPtr = NULL;
+    handlerPtr->safeRef = NULL;
+
+    // Finally kill the object.
+    le_mem_Release(handlerPtr);
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  This function is called by the hash map ForEach function, which is invoked when a session closed
+ *  event occurs.
+ *
+ *  This function takes care of cleaning out orphaned event handlers from the registration objects
+ *  currently stored in the registration hash map.  If a given registration handler is no longer
+ *  required then the object itself is queued for deletion.  It is queued and not deleted in place
+ *  because the hash map does not support deleting objects in the middle of an iteration.
+ *
+ *  @return True.  This function always returns true to indicate that iteration should continue
+ *          until the end of the hash map.
+ */
+// -------------------------------------------------------------------------------------------------
+static bool OnHandlerRegistrationCleanup
+(
+    const void* keyPtr,    ///< [IN] The key used by this hash entry.
+    const void* valuePtr,  ///< [IN] The registration object.
+    void* contextPtr       ///< [IN] Context info including the ref for the session that closed.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // Convert our pointers into something useable.
+    Registration_t* registrationPtr = (Registration_t*)valuePtr;
+    CleanUpContext_t* cleanUpContextPtr = (CleanUpContext_t*)contextPtr;
+
+    // Go through this registration object's list of update handlers and check to see if they were
+    // registered on the target session.  If so, free them from the list.
+    le_dls_Link_t* linkPtr = le_dls_Peek(&registrationPtr->handlerList);
+
+    while (linkPtr != NULL)
+    {
+        Handler_t* handlerObjectPtr = CONTAINER_OF(linkPtr, Handler_t, link);
+        linkPtr = le_dls_PeekNext(&registrationPtr->handlerList, linkPtr);
+
+        if (handlerObjectPtr->sessionRef == cleanUpContextPtr->sessionRef)
+        {
+            RemoveHandler(registrationPtr, handlerObjectPtr);
+        }
+    }
+
+    // Now, check to see if there are any handlers left in this object.  If the registration object
+    // is empty, then queue it for deletion.
+    if (le_dls_IsEmpty(&registrationPtr->handlerList))
+    {
+        registrationPtr->link = LE_SLS_LINK_INIT;
+        le_sls_Queue(&cleanUpContextPtr->deleteQueue, &registrationPtr->link);
+    }
+
+    // We want to continue iterating through the collection.
+    return true;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Call this function to delete a tree file from the filesystem.
+ */
+// -------------------------------------------------------------------------------------------------
+static void DeleteTreeFile
+(
+    const char* filePathPtr  ///< Path to the tree file in question.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_DEBUG("** Deleting tree file, '%s'.", filePathPtr);
+
+    if (unlink(filePathPtr) != 0)
+    {
+        LE_ERROR("File delete failure, '%s', reason '%m'.", filePathPtr);
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Find the root node represented by the path ref.
+ *
+ *  If the path is an absolute path, then the base node for the reference is the root node of the
+ *  tree in question.
+ *
+ *  If the path is a relative path, then the base node of the request is the node given.
+ *
+ *  @return A reference to the base node of the operation.
+ */
+// -------------------------------------------------------------------------------------------------
+static tdb_NodeRef_t GetPathBaseNodeRef
+(
+    tdb_NodeRef_t nodeRef,         ///< [IN] The base node to start from.
+    le_pathIter_Ref_t nodePathRef  ///< [IN] The path we're searching for in the tree.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // If the path is absolute and the node we were given is NOT the root node of it's tree, find
+    // the root node of the tree.  Otherwise just return the node reference we were given.
+    if (   (le_pathIter_IsAbsolute(nodePathRef))
+        && (nodeRef->parentRef != NULL))
+    {
+        nodeRef = GetRootParentNode(nodeRef);
+    }
+
+    return nodeRef;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Create a new C style file pointer from the POSIX file descriptor.
+ *
+ *  @return A file pointer that may be read or written if successful.  A null pointer otherwise.
+ */
+// -------------------------------------------------------------------------------------------------
+static FILE* OpenFilePtr
+(
+    int descriptor,   ///< [IN] The POSIX file descriptor to create a file pointer from.
+    const char* mode  ///< [IN] The mode to open the file pointer in.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    // Duplicate the file descriptor, this is because we later use a C library file pointer for the
+    // parsing routines.  When the file pointer is closed it also closes the underlying descriptor,
+    // which may not be what the caller wants or expects.
+    int newDescriptor = -1;
+
+    do
+    {
+        newDescriptor = dup(descriptor);
+    }
+    while (   (newDescriptor == -1)
+           && (errno == EINTR));
+
+    if (newDescriptor == -1)
+    {
+        LE_ERROR("Could not duplicate file descriptor, reason: %s", strerror(errno));
+        return NULL;
+    }
+
+    // Attempt to open the file pointer from the descriptor.
+    FILE* filePtr = fdopen(newDescriptor, mode);
+
+    if (filePtr == NULL)
+    {
+        // The open failed, so clean up the dangling descriptor.
+        int oldErrno = errno;
+
+        close(newDescriptor);
+
+        LE_ERROR("Could not access the input stream for tree import, reason: %s",
+                 strerror(oldErrno));
+    }
+
+    // Return the file pointer we have now.  Note, it may be NULL at this point.
+    return filePtr;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Close the file pointer and flush any data left unwritten.
+ */
+// -------------------------------------------------------------------------------------------------
+static void CloseFilePtr
+(
+    FILE* filePtr  ///< The file pointer to close.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    if (fclose(filePtr) == EOF)
+    {
+        LE_ERROR("Could not properly close file, reason: %s", strerror(errno));
+    }
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Get the absolute path of a node within its tree.
+ *
+ *  @return LE_OK if the path fit in the buffer, LE_OVERFLOW if not.
+ */
+// -------------------------------------------------------------------------------------------------
+static le_result_t GetNodePath
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] The node to get the path of.
+    char* pathPtr,          ///< [OUT] Buffer to hold the path.
+    size_t pathSize         ///< [IN] Size of the path buffer.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    tdb_NodeRef_t parentRef = tdb_GetNodeParent(nodeRef);
+
+    if (parentRef == NULL)
+    {
+        return le_utf8_Copy(pathPtr, "/", pathSize, NULL);
+    }
+
+    char nodeName[LE_CFG_NAME_LEN_BYTES] = "";
+    le_result_t result = GetNodePath(parentRef, pathPtr, pathSize);
+
+    if (   (result == LE_OK)
+        && (tdb_GetNodeParent(parentRef) != NULL))
+    {
+        result = le_utf8_Append(pathPtr, "/", pathSize, NULL);
+    }
+
+    if (result == LE_OK)
+    {
+        result = tdb_GetNodeName(nodeRef, nodeName, sizeof(nodeName));
+    }
+
+    if (result == LE_OK)
+    {
+        result = le_utf8_Append(pathPtr, nodeName, pathSize, NULL);
     }
 
-    le_mem_Release(stringBuffer);
     return result;
 }
 
@@ -2442,33 +4663,34 @@ static le_result_t InternalWriteNode
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Calculate the number of bytes required to store a node path, including seperators and a trailing
- *  NULL.
+ *  Write a change of a node to a journal record.
  *
- *  @return The amount of bytes required to store the whole path string.
+ *  @return LE_OK if the write succeeded, LE_OVERFLOW if the node's path is too long, or
+ *          LE_IO_ERROR if the write failed.
  */
 // -------------------------------------------------------------------------------------------------
-static size_t ComputePathLength
+static le_result_t WriteJournalChange
 (
-    tdb_NodeRef_t nodeRef  ///< [IN] Compute a path for this node.
+    FILE* filePtr,          ///< [IN] The record being written.
+    const char* operation,  ///< [IN] "= " for a node set to a new value, "- " for a deleted node.
+    tdb_NodeRef_t nodeRef   ///< [IN] The node that was changed.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    size_t pathLen = 0;
-    char nodeName[LE_CFG_NAME_LEN_BYTES] = "";
+    char path[LE_CFG_STR_LEN_BYTES] = "";
+    le_result_t result = GetNodePath(nodeRef, path, sizeof(path));
 
-    while (nodeRef != NULL)
+    if (result == LE_OK)
     {
-        LE_ASSERT(tdb_GetNodeName(nodeRef, nodeName, sizeof(nodeName)) == LE_OK);
+        result = WriteFile(filePtr, operation, 2);
+    }
 
-        // Add this path segment's length to our running total, along with the required path
-        // seperator.
-        pathLen += 1 + le_utf8_NumBytes(nodeName);
-        nodeRef = tdb_GetNodeParent(nodeRef);
+    if (result == LE_OK)
+    {
+        result = WriteStringValue(filePtr, '\"', '\"', path);
     }
 
-    // Don't forget to include a spot for the trailing NULL.
-    return pathLen + 1;
+    return result;
 }
 
 
@@ -2476,21 +4698,49 @@ static size_t ComputePathLength
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Bump up the version id of this tree.
+ *  Write the nodes a merge is about to delete to a journal record.  This has to be done before the
+ *  merge, while the original nodes are still around to name the shadow nodes.
+ *
+ *  @return LE_OK if the write succeeded, LE_UNSUPPORTED if a node was renamed, or an error from
+ *          WriteJournalChange().
  */
 // -------------------------------------------------------------------------------------------------
-static void IncrementRevision
+static le_result_t JournalDeletions
 (
-    tdb_TreeRef_t treeRef  ///< [IN] Increment the revision of this tree.
+    FILE* filePtr,         ///< [IN] The record being written.
+    tdb_NodeRef_t nodeRef  ///< [IN] The shadow node to check, along with its children.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    treeRef->revisionId++;
+    // A rename would have to be journaled as the whole sub-tree of the node.  It's simpler to just
+    // write the whole tree.
+    if (WasRenamed(nodeRef))
+    {
+        return LE_UNSUPPORTED;
+    }
 
-    if (treeRef->revisionId > 3)
+    if (IsDeleted(nodeRef))
     {
-        treeRef->revisionId = 1;
+        return WriteJournalChange(filePtr, "- ", nodeRef);
+    }
+
+    le_result_t result = LE_OK;
+
+    // Only go through the shadow children that exist already, there can't be any deletions in the
+    // rest of the tree.
+    if (nodeRef->type == LE_CFG_TYPE_STEM)
+    {
+        le_dls_Link_t* linkPtr = le_dls_Peek(&nodeRef->info.children);
+
+        while (   (linkPtr != NULL)
+               && (result == LE_OK))
+        {
+            result = JournalDeletions(filePtr, CONTAINER_OF(linkPtr, Node_t, siblingList));
+            linkPtr = le_dls_PeekNext(&nodeRef->info.children, linkPtr);
+        }
     }
+
+    return result;
 }
 
 
@@ -2498,93 +4748,57 @@ static void IncrementRevision
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Attempt to load a configuration tree from a config file.  This function will look for the latest
- *  valid version of the config file and load that one.
+ *  Write the nodes a merge has set to a journal record.  The values are taken from the original
+ *  nodes, so that the journal holds what the merge actually did.  Stems that were kept aren't
+ *  written, as they didn't change; their children are written as needed.
+ *
+ *  @return LE_OK if the write succeeded, or an error from WriteJournalChange().
  */
 // -------------------------------------------------------------------------------------------------
-static void LoadTree
+static le_result_t JournalChanges
 (
-    tdb_TreeRef_t treeRef  ///< [IN] The tree object to load from the filesystem.
+    FILE* filePtr,         ///< [IN] The record being written.
+    tdb_NodeRef_t nodeRef  ///< [IN] The merged shadow node, along with its children.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // If we don't know the revision then hunt it out from the filesystem.
-    if (treeRef->revisionId == 0)
-    {
-        UpdateRevision(treeRef);
-    }
+    le_result_t result = LE_OK;
 
-    // If this tree has no root, create it now.
-    if (treeRef->rootNodeRef == NULL)
+    if (IsDeleted(nodeRef))
     {
-        treeRef->rootNodeRef = NewNode();
+        return LE_OK;
     }
 
-    // Ok, if we found a valid revision of the tree in the fs, try to load it now.
-    if (treeRef->revisionId != 0)
+    if (IsModified(nodeRef))
     {
-        char pathPtr[LE_CFG_STR_LEN_BYTES] = "";
-        GetTreePath(treeRef->name, treeRef->revisionId, pathPtr, sizeof(pathPtr));
-
-        LE_DEBUG("** Loading configuration tree from '%s'.", pathPtr);
+        tdb_NodeRef_t originalRef = nodeRef->shadowRef;
 
-        int fileRef = -1;
+        LE_ASSERT(originalRef != NULL);
 
-        do
+        if (originalRef->type != LE_CFG_TYPE_STEM)
         {
-            fileRef = open(pathPtr, O_RDONLY);
-        }
-        while ((fileRef == -1) && (errno == EINTR));
+            result = WriteJournalChange(filePtr, "= ", originalRef);
 
-        tdb_EnsureExists(treeRef->rootNodeRef);
-
-        if (fileRef == -1)
-        {
-            LE_ERROR("Could not open configuration tree file: %s, reason: %s",
-                     pathPtr,
-                     strerror(errno));
-        }
-        else
-        {
-            if (tdb_ReadTreeNode(treeRef->rootNodeRef, fileRef) == false)
+            if (result == LE_OK)
             {
-                LE_ERROR("Could not parse configuration tree file: %s.", pathPtr);
-                le_mem_Release(treeRef->rootNodeRef);
-                treeRef->rootNodeRef = NewNode();
+                result = InternalWriteNode(originalRef, filePtr);
             }
-
-            close(fileRef);
         }
     }
-}
-
 
+    if (nodeRef->type == LE_CFG_TYPE_STEM)
+    {
+        le_dls_Link_t* linkPtr = le_dls_Peek(&nodeRef->info.children);
 
-// -------------------------------------------------------------------------------------------------
-/**
- *  Removes the handler object from the given registration object.  This function will also free the
- *  memory that the handler object had used.
- */
-// -------------------------------------------------------------------------------------------------
-static void RemoveHandler
-(
-    Registration_t* registrationPtr,  ///< [IN] The registration object to remove the link from.
-    Handler_t* handlerPtr             ///< [IN] The handler object we're removing.
-)
-// -------------------------------------------------------------------------------------------------
-{
-    // Kill the ref, and remove the object from the registration list.
-    le_ref_DeleteRef(HandlerSafeRefMap, handlerPtr->safeRef);
-    le_dls_Remove(&registrationPtr->handlerList, &handlerPtr->link);
-
-    // Clear out the link data, just to be safe.
-    handlerPtr->link = LE_DLS_LINK_INIT;
-    handlerPtr->sessionRef = NULL;
-    handlerPtr->registrationPtr = NULL;
-    handlerPtr->safeRef = NULL;
+        while (   (linkPtr != NULL)
+               && (result == LE_OK))
+        {
+            result = JournalChanges(filePtr, CONTAINER_OF(linkPtr, Node_t, siblingList));
+            linkPtr = le_dls_PeekNext(&nodeRef->info.children, linkPtr);
+        }
+    }
 
-    // Finally kill the object.
-    le_mem_Release(handlerPtr);
+    return result;
 }
 
 
@@ -2592,55 +4806,83 @@ static void RemoveHandler
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  This function is called by the hash map ForEach function, which is invoked when a session closed
- *  event occurs.
- *
- *  This function takes care of cleaning out orphaned event handlers from the registration objects
- *  currently stored in the registration hash map.  If a given registration handler is no longer
- *  required then the object itself is queued for deletion.  It is queued and not deleted in place
- *  because the hash map does not support deleting objects in the middle of an iteration.
+ *  Write framed records to the end of the journal of a tree's current revision.
  *
- *  @return True.  This function always returns true to indicate that iteration should continue
- *          until the end of the hash map.
+ *  @return LE_OK if the records were written and synced to storage.
+ *          LE_NOT_PERMITTED if the file system is read only.
+ *          LE_IO_ERROR if the records couldn't be written.
  */
 // -------------------------------------------------------------------------------------------------
-static bool OnHandlerRegistrationCleanup
+static le_result_t WriteJournal
 (
-    const void* keyPtr,    ///< [IN] The key used by this hash entry.
-    const void* valuePtr,  ///< [IN] The registration object.
-    void* contextPtr       ///< [IN] Context info including the ref for the session that closed.
+    tdb_TreeRef_t treeRef,          ///< [IN] The tree the changes were committed to.
+    const struct iovec* vectorPtr,  ///< [IN] The records.
+    int vectorCount                 ///< [IN] Number of entries in the vector.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Convert our pointers into something useable.
-    Registration_t* registrationPtr = (Registration_t*)valuePtr;
-    CleanUpContext_t* cleanUpContextPtr = (CleanUpContext_t*)contextPtr;
+    char journalPath[LE_CFG_STR_LEN_BYTES] = "";
+    size_t size = 0;
+    int i;
 
-    // Go through this registration object's list of update handlers and check to see if they were
-    // registered on the target session.  If so, free them from the list.
-    le_dls_Link_t* linkPtr = le_dls_Peek(&registrationPtr->handlerList);
+    GetJournalPath(treeRef->name, treeRef->revisionId, journalPath, sizeof(journalPath));
 
-    while (linkPtr != NULL)
+    for (i = 0; i < vectorCount; i++)
     {
-        Handler_t* handlerObjectPtr = CONTAINER_OF(linkPtr, Handler_t, link);
-        linkPtr = le_dls_PeekNext(&registrationPtr->handlerList, linkPtr);
+        size += vectorPtr[i].iov_len;
+    }
 
-        if (handlerObjectPtr->sessionRef == cleanUpContextPtr->sessionRef)
+    int fileRef = -1;
+
+    do
+    {
+        fileRef = open(journalPath, O_WRONLY | O_CREAT | O_APPEND, S_IRUSR | S_IWUSR);
+    }
+    while (   (fileRef == -1)
+           && (errno == EINTR));
+
+    if (fileRef == -1)
+    {
+        if (errno == EROFS)
         {
-            RemoveHandler(registrationPtr, handlerObjectPtr);
+            return LE_NOT_PERMITTED;
         }
+
+        LE_ERROR("Failed to open journal '%s' (%m).", journalPath);
+        return LE_IO_ERROR;
     }
 
-    // Now, check to see if there are any handlers left in this object.  If the registration object
-    // is empty, then queue it for deletion.
-    if (le_dls_IsEmpty(&registrationPtr->handlerList))
+    ssize_t written;
+
+    do
     {
-        registrationPtr->link = LE_SLS_LINK_INIT;
-        le_sls_Queue(&cleanUpContextPtr->deleteQueue, &registrationPtr->link);
+        written = writev(fileRef, vectorPtr, vectorCount);
     }
+    while (   (written == -1)
+           && (errno == EINTR));
 
-    // We want to continue iterating through the collection.
-    return true;
+    le_result_t result = LE_OK;
+
+    if (   (written != (ssize_t)size)
+        || (fdatasync(fileRef) == -1))
+    {
+        LE_ERROR("Failed to write to journal '%s' (%m).", journalPath);
+
+        // Don't leave a partial record behind for the next one to be appended to.
+        LE_ERROR_IF(ftruncate(fileRef, treeRef->journalSize) == -1,
+                    "Could not truncate journal '%s' (%m).",
+                    journalPath);
+
+        result = LE_IO_ERROR;
+    }
+    else
+    {
+        treeRef->journalSize += written;
+    }
+
+    LE_ERROR_IF(close(fileRef) == -1, "An error occurred while closing the journal: %m");
+
+    return result;
 }
 
 
@@ -2648,21 +4890,52 @@ static bool OnHandlerRegistrationCleanup
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Call this function to delete a tree file from the filesystem.
+ *  Append a record to the journal of a tree's current revision.  If the tree's sync is deferred,
+ *  the record is held in memory until the deferral ends.
+ *
+ *  @return LE_OK if the record was written and synced to storage, or held.
+ *          LE_NOT_PERMITTED if the file system is read only.
+ *          LE_IO_ERROR if the record couldn't be written.
  */
 // -------------------------------------------------------------------------------------------------
-static void DeleteTreeFile
+static le_result_t AppendJournal
 (
-    const char* filePathPtr  ///< Path to the tree file in question.
+    tdb_TreeRef_t treeRef,  ///< [IN] The tree the changes were committed to.
+    char* recordPtr,        ///< [IN] The changes.
+    size_t recordSize       ///< [IN] Size of the changes, in bytes.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    LE_DEBUG("** Deleting tree file, '%s'.", filePathPtr);
+    char header[JOURNAL_HEADER_SIZE + 1] = "";
 
-    if (unlink(filePathPtr) != 0)
+    snprintf(header,
+             sizeof(header),
+             "#%08" PRIx32 " %08" PRIx32 "\n",
+             (uint32_t)recordSize,
+             le_crc_Crc32((uint8_t*)recordPtr, recordSize, LE_CRC_START_CRC32));
+
+    if (treeRef->syncDeferCount > 0)
     {
-        LE_ERROR("File delete failure, '%s', reason '%m'.", filePathPtr);
+        char* pendingPtr = realloc(treeRef->pendingPtr,
+                                   treeRef->pendingSize + JOURNAL_HEADER_SIZE + recordSize);
+        LE_ASSERT(pendingPtr != NULL);
+
+        memcpy(pendingPtr + treeRef->pendingSize, header, JOURNAL_HEADER_SIZE);
+        memcpy(pendingPtr + treeRef->pendingSize + JOURNAL_HEADER_SIZE, recordPtr, recordSize);
+
+        treeRef->pendingPtr = pendingPtr;
+        treeRef->pendingSize += JOURNAL_HEADER_SIZE + recordSize;
+
+        return LE_OK;
     }
+
+    struct iovec vector[2] =
+    {
+        { .iov_base = header, .iov_len = JOURNAL_HEADER_SIZE },
+        { .iov_base = recordPtr, .iov_len = recordSize }
+    };
+
+    return WriteJournal(treeRef, vector, NUM_ARRAY_MEMBERS(vector));
 }
 
 
@@ -2670,32 +4943,116 @@ static void DeleteTreeFile
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Find the root node represented by the path ref.
- *
- *  If the path is an absolute path, then the base node for the reference is the root node of the
- *  tree in question.
- *
- *  If the path is a relative path, then the base node of the request is the node given.
+ *  Write a tree to its next revision file.  Once the file is synced to storage, the previous
+ *  revision file and its journal are deleted.
  *
- *  @return A reference to the base node of the operation.
+ *  @return LE_OK if the tree was written.
+ *          LE_NOT_PERMITTED if the file system is read only.
+ *          LE_IO_ERROR if the tree couldn't be written.
  */
 // -------------------------------------------------------------------------------------------------
-static tdb_NodeRef_t GetPathBaseNodeRef
+static le_result_t WriteTreeFile
 (
-    tdb_NodeRef_t nodeRef,         ///< [IN] The base node to start from.
-    le_pathIter_Ref_t nodePathRef  ///< [IN] The path we're searching for in the tree.
+    tdb_TreeRef_t treeRef  ///< [IN] The tree to write.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // If the path is absolute and the node we were given is NOT the root node of it's tree, find
-    // the root node of the tree.  Otherwise just return the node reference we were given.
-    if (   (le_pathIter_IsAbsolute(nodePathRef))
-        && (nodeRef->parentRef != NULL))
+    // Increment revision of the tree and open a tree file for writing.  Make sure there's no
+    // journal left over for the new revision.
+    int oldId = treeRef->revisionId;
+
+    IncrementRevision(treeRef);
+    DeleteJournal(treeRef->name, treeRef->revisionId);
+
+    char filePath[LE_CFG_STR_LEN_BYTES] = "";
+    GetTreePath(treeRef->name, treeRef->revisionId, filePath, sizeof(filePath));
+
+    LE_DEBUG("Serializing the tree to '%s'.", filePath);
+
+    int fileRef = -1;
+
+    do
+    {
+        fileRef = open(filePath, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    }
+    while (   (fileRef == -1)
+           && (errno == EINTR));
+
+    if ((-1 == fileRef) && (EROFS == errno))
+    {
+        // In case we are R/O for the config tree, we discard the update to flash
+        treeRef->revisionId = oldId;
+        return LE_NOT_PERMITTED;
+    }
+
+    if (fileRef == -1)
+    {
+        LE_EMERG("Failed to open config file '%s' (%m).", filePath);
+        treeRef->revisionId = oldId;
+        return LE_IO_ERROR;
+    }
+
+    // We have a tree file to write to, so stream the new tree to it then close the output file.
+#if LE_CONFIG_CONFIGTREE_BINARY_SNAPSHOTS
+    le_result_t writeResult = tdb_WriteTreeSnapshot(treeRef->rootNodeRef, fileRef);
+#else
+    le_result_t writeResult = tdb_WriteTreeNode(treeRef->rootNodeRef, fileRef);
+#endif
+    struct stat fileStat;
+
+    if (   (writeResult == LE_OK)
+        && (   (fsync(fileRef) == -1)
+            || (fstat(fileRef, &fileStat) == -1)))
+    {
+        LE_EMERG("Failed to sync config file '%s' (%m).", filePath);
+        writeResult = LE_IO_ERROR;
+    }
+
+    int retVal = -1;
+
+    retVal = close(fileRef);
+
+    LE_EMERG_IF(retVal == -1, "An error occurred while closing the tree file: %s", strerror(errno));
+
+    // Finally remove the old version of the tree file and its journal, if there is one.  The file
+    // goes first: if it were left behind on its own, it would be loaded without its journal.
+    if (writeResult == LE_OK)
+    {
+        if (   (oldId != 0)
+            && (TreeFileExists(treeRef->name, oldId)))
+        {
+            GetTreePath(treeRef->name, oldId, filePath, sizeof(filePath));
+            DeleteTreeFile(filePath);
+        }
+
+        if (oldId != 0)
+        {
+            DeleteJournal(treeRef->name, oldId);
+        }
+
+        treeRef->revisionSize = fileStat.st_size;
+        treeRef->journalSize = 0;
+        treeRef->bytesWritten += fileStat.st_size;
+
+        // Any journal records still held are in the new revision file too.
+        free(treeRef->pendingPtr);
+        treeRef->pendingPtr = NULL;
+        treeRef->pendingSize = 0;
+
+        if (treeRef->compactTimerRef != NULL)
+        {
+            le_timer_Stop(treeRef->compactTimerRef);
+        }
+    }
+    else
     {
-        nodeRef = GetRootParentNode(nodeRef);
+        // The write failed, delete the new file we attempted to create.
+        LE_EMERG("The attempt to write to the config tree file, '%s,' failed.", filePath);
+        DeleteTreeFile(filePath);
+        treeRef->revisionId = oldId;
     }
 
-    return nodeRef;
+    return writeResult;
 }
 
 
@@ -2703,52 +5060,26 @@ static tdb_NodeRef_t GetPathBaseNodeRef
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Create a new C style file pointer from the POSIX file descriptor.
- *
- *  @return A file pointer that may be read or written if successful.  A null pointer otherwise.
+ *  Timer handler to compact a tree's journal into a new revision file.
  */
 // -------------------------------------------------------------------------------------------------
-static FILE* OpenFilePtr
+static void OnCompactJournal
 (
-    int descriptor,   ///< [IN] The POSIX file descriptor to create a file pointer from.
-    const char* mode  ///< [IN] The mode to open the file pointer in.
+    le_timer_Ref_t timerRef  ///< [IN] The timer that expired.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    // Duplicate the file descriptor, this is because we later use a C library file pointer for the
-    // parsing routines.  When the file pointer is closed it also closes the underlying descriptor,
-    // which may not be what the caller wants or expects.
-    int newDescriptor = -1;
-
-    do
-    {
-        newDescriptor = dup(descriptor);
-    }
-    while (   (newDescriptor == -1)
-           && (errno == EINTR));
-
-    if (newDescriptor == -1)
-    {
-        LE_ERROR("Could not duplicate file descriptor, reason: %s", strerror(errno));
-        return NULL;
-    }
-
-    // Attempt to open the file pointer from the descriptor.
-    FILE* filePtr = fdopen(newDescriptor, mode);
-
-    if (filePtr == NULL)
-    {
-        // The open failed, so clean up the dangling descriptor.
-        int oldErrno = errno;
-
-        close(newDescriptor);
+    tdb_TreeRef_t treeRef = le_timer_GetContextPtr(timerRef);
 
-        LE_ERROR("Could not access the input stream for tree import, reason: %s",
-                 strerror(oldErrno));
-    }
+    LE_INFO("Compacting %zu byte journal of tree '%s'.  %zu commits have written %zu bytes, "
+            "%zu bytes per commit.",
+            treeRef->journalSize,
+            treeRef->name,
+            treeRef->commitCount,
+            treeRef->bytesWritten,
+            treeRef->bytesWritten / ((treeRef->commitCount > 0) ? treeRef->commitCount : 1));
 
-    // Return the file pointer we have now.  Note, it may be NULL at this point.
-    return filePtr;
+    WriteTreeFile(treeRef);
 }
 
 
@@ -2756,18 +5087,34 @@ static FILE* OpenFilePtr
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Close the file pointer and flush any data left unwritten.
+ *  Start the compaction timer of a tree if its journal has grown as big as its revision file.
  */
 // -------------------------------------------------------------------------------------------------
-static void CloseFilePtr
+static void ScheduleCompaction
 (
-    FILE* filePtr  ///< The file pointer to close.
+    tdb_TreeRef_t treeRef  ///< [IN] The tree to check.
 )
 // -------------------------------------------------------------------------------------------------
 {
-    if (fclose(filePtr) == EOF)
+    if (   (treeRef->journalSize < JOURNAL_MIN_COMPACT_SIZE)
+        || (treeRef->journalSize < treeRef->revisionSize))
     {
-        LE_ERROR("Could not properly close file, reason: %s", strerror(errno));
+        return;
+    }
+
+    if (treeRef->compactTimerRef == NULL)
+    {
+        treeRef->compactTimerRef = le_timer_Create("Journal Compaction Timer");
+
+        LE_ASSERT(le_timer_SetMsInterval(treeRef->compactTimerRef, JOURNAL_COMPACT_DELAY) == LE_OK);
+        LE_ASSERT(le_timer_SetHandler(treeRef->compactTimerRef, OnCompactJournal) == LE_OK);
+        LE_ASSERT(le_timer_SetContextPtr(treeRef->compactTimerRef, treeRef) == LE_OK);
+        LE_ASSERT(le_timer_SetWakeup(treeRef->compactTimerRef, false) == LE_OK);
+    }
+
+    if (le_timer_IsRunning(treeRef->compactTimerRef) == false)
+    {
+        LE_ASSERT(le_timer_Start(treeRef->compactTimerRef) == LE_OK);
     }
 }
 
@@ -2820,6 +5167,20 @@ void tdb_Init
     HandlerPool = le_mem_CreatePool(CFG_HANDLER_POOL_NAME, sizeof(Handler_t));
     RegistrationPool = le_mem_CreatePool(CFG_REGISTRATION_POOL_NAME, sizeof(Registration_t));
 
+    size_t bucketCount = CHILD_INDEX_MIN_BUCKETS;
+    size_t sizeClass;
+
+    for (sizeClass = 0; sizeClass < CHILD_INDEX_SIZE_CLASSES; sizeClass++)
+    {
+        ChildIndexPools[sizeClass] = le_mem_CreatePool(ChildIndexPoolNames[sizeClass],
+                                                       sizeof(ChildIndex_t) +
+                                                       (bucketCount * sizeof(tdb_NodeRef_t)));
+        bucketCount *= CHILD_INDEX_GROWTH;
+    }
+
+    SnapshotPool = le_mem_CreatePool(CFG_SNAPSHOT_POOL_NAME, sizeof(Snapshot_t));
+    le_mem_SetDestructor(SnapshotPool, SnapshotDestructor);
+
     BinaryDataPool = le_mem_CreatePool(CFG_BINARY_DATA_POOL_NAME, LE_CFG_BINARY_LEN);
     EncodedStringPool = le_mem_CreatePool(CFG_ENCODED_STRING_POOL_NAME, TDB_MAX_ENCODED_SIZE);
 
@@ -2866,8 +5227,9 @@ tdb_TreeRef_t tdb_GetTree
 /**
  *  Called to delete the given tree both from memory and from the filesystem.
  *
- *  If the given tree has active iterators on it, then it will only be marked for deletion.  After
- *  all of the iterators close, the tree will be removed from the system automatically.
+ *  If the given tree has active iterators on it, or its sync is deferred, then it will only be
+ *  marked for deletion.  After all of the iterators close and the sync happens, the tree will be
+ *  removed from the system automatically.
  */
 // -------------------------------------------------------------------------------------------------
 void tdb_DeleteTree
@@ -2880,7 +5242,8 @@ void tdb_DeleteTree
     // tree for deletion for now.
     if (   (tdb_GetActiveWriteIter(treeRef) == NULL)
         && (tdb_HasActiveReaders(treeRef) == 0)
-        && (le_sls_IsEmpty(&treeRef->requestList)))
+        && (le_sls_IsEmpty(&treeRef->requestList))
+        && (treeRef->syncDeferCount == 0))
     {
         // Looks like there's no one on the tree, so delete any tree files that may exist.  Then
         // kill the tree itself.
@@ -2895,6 +5258,8 @@ void tdb_DeleteTree
 
                 DeleteTreeFile(filePathPtr);
             }
+
+            DeleteJournal(treeRef->name, id);
         }
 
         LE_ASSERT(le_hashmap_Remove(TreeCollectionRef, treeRef->name) == treeRef);
@@ -2955,6 +5320,36 @@ tdb_TreeRef_t tdb_ShadowTree
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Make a tree version of the current state of a tree, for the read iterators on the tree to be
+ *  moved onto before a change is merged into it.  The version shares the tree's nodes until they're
+ *  changed.  It is freed by tdb_ReleaseTree() once it has no read iterators left, so at least one
+ *  must be moved onto it, or it must be released.
+ *
+ *  @return Pointer to the new tree version.
+ */
+// -------------------------------------------------------------------------------------------------
+tdb_TreeRef_t tdb_NewTreeVersion
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree to copy.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(treeRef->originalTreeRef == NULL);
+    LE_ASSERT(treeRef->isVersion == false);
+
+    tdb_TreeRef_t versionRef = NewTree(treeRef->name, NewVersionNode(treeRef->rootNodeRef));
+    versionRef->isVersion = true;
+    versionRef->sourceTreeRef = treeRef;
+    le_dls_Queue(&treeRef->versionList, &versionRef->versionLink);
+
+    return versionRef;
+}
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  Called to create a new tree that shadows an existing one.
@@ -3157,8 +5552,9 @@ le_sls_List_t* tdb_GetRequestQueue
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Merge a shadow tree into the original tree it was created from.  Once the change is merged the
- *  updated tree is serialized to the filesystem.
+ *  Merge a shadow tree into the original tree it was created from.  Once the change is merged it
+ *  is appended to the tree's journal, or the updated tree is serialized to the filesystem.  If the
+ *  tree's sync is deferred, the journal record is held until the deferral ends.
  */
 // -------------------------------------------------------------------------------------------------
 void tdb_MergeTree
@@ -3167,74 +5563,191 @@ void tdb_MergeTree
 )
 // -------------------------------------------------------------------------------------------------
 {
+    tdb_TreeRef_t originalTreeRef = shadowTreeRef->originalTreeRef;
+
+    // Start a journal record of the changes.  Deletions have to be recorded before the merge.  If
+    // the tree hasn't been written yet, there's no revision file for a journal to go with.
+    char* recordPtr = NULL;
+    size_t recordSize = 0;
+    FILE* recordFilePtr = open_memstream(&recordPtr, &recordSize);
+
+    LE_ASSERT(recordFilePtr != NULL);
+
+    bool canJournal =    (originalTreeRef->revisionId != 0)
+                      && (JournalDeletions(recordFilePtr, shadowTreeRef->rootNodeRef) == LE_OK);
+
+    // Make the tree's versions copy the nodes that are about to change.
+    le_dls_Link_t* linkPtr = le_dls_Peek(&originalTreeRef->versionList);
+
+    while (linkPtr != NULL)
+    {
+        tdb_TreeRef_t versionRef = CONTAINER_OF(linkPtr, Tree_t, versionLink);
+        VersionPath_t rootPath =
+            { NULL, originalTreeRef->rootNodeRef, versionRef->rootNodeRef, true };
+
+        CopyChangedVersionNodes(&rootPath, shadowTreeRef->rootNodeRef);
+        linkPtr = le_dls_PeekNext(&originalTreeRef->versionList, linkPtr);
+    }
+
     // Get our shadow tree's root node and merge it's changes into the real tree.  Create a path
     // iterator to track the merge and allow for update handlers to be called.
     tdb_NodeRef_t nodeRef = shadowTreeRef->rootNodeRef;
-    le_pathIter_Ref_t pathRef = CreateBasePath(shadowTreeRef->originalTreeRef->name);
+    le_pathIter_Ref_t pathRef = CreateBasePath(originalTreeRef->name);
 
-    InternalMergeTree(shadowTreeRef->originalTreeRef->name, pathRef, nodeRef, false);
+    InternalMergeTree(originalTreeRef->name, pathRef, nodeRef, false);
     le_pathIter_Delete(pathRef);
 
     // Now, go through and call the triggered callbacks.
     FireTriggeredCallbacks();
 
-    // Now increment revision of the tree and open a tree file for writing.
-    tdb_TreeRef_t originalTreeRef = shadowTreeRef->originalTreeRef;
-    int oldId = originalTreeRef->revisionId;
+    // Finish the record, and append it to the journal.  Unless the record would be as big as the
+    // whole tree, or can't be written, in which case the whole tree is written instead.
+    canJournal = canJournal && (JournalChanges(recordFilePtr, nodeRef) == LE_OK);
 
-    IncrementRevision(originalTreeRef);
+    LE_ASSERT(fclose(recordFilePtr) == 0);
 
-    char filePath[LE_CFG_STR_LEN_BYTES] = "";
-    GetTreePath(originalTreeRef->name, originalTreeRef->revisionId, filePath, sizeof(filePath));
+    size_t oldBytesWritten = originalTreeRef->bytesWritten;
+    le_result_t result = LE_UNSUPPORTED;
 
-    LE_DEBUG("Changes merged, now attempting to serialize the tree to '%s'.", filePath);
+    if (canJournal && (recordSize == 0))
+    {
+        LE_DEBUG("Nothing changed in tree '%s'.", originalTreeRef->name);
+        free(recordPtr);
+        return;
+    }
 
-    int fileRef = -1;
+    if (   canJournal
+        && (recordSize < originalTreeRef->revisionSize))
+    {
+        result = AppendJournal(originalTreeRef, recordPtr, recordSize);
 
-    do
+        if (result == LE_OK)
+        {
+            originalTreeRef->bytesWritten += JOURNAL_HEADER_SIZE + recordSize;
+
+            if (originalTreeRef->syncDeferCount == 0)
+            {
+                ScheduleCompaction(originalTreeRef);
+            }
+        }
+    }
+
+    free(recordPtr);
+
+    if (   (result == LE_UNSUPPORTED)
+        || (result == LE_IO_ERROR))
     {
-        fileRef = open(filePath, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+        result = WriteTreeFile(originalTreeRef);
     }
-    while (   (fileRef == -1)
-           && (errno == EINTR));
 
-    if ((-1 == fileRef) && (EROFS == errno))
+    if (result == LE_NOT_PERMITTED)
     {
-        // In case we are R/O for the config tree, we discard the update to flash
+        // In case we are R/O for the config tree, we discard the update to flash.
         return;
     }
 
-    if (fileRef == -1)
+    if (result != LE_OK)
     {
-        LE_EMERG("Failed to open config file '%s' (%m).", filePath);
         LE_EMERG("Changes have been merged in memory, however they could not be committed to the "
                  "filesystem!!");
         return;
     }
 
-    // We have a tree file to write to, so stream the new tree to it then close the output file.
-    le_result_t writeResult = tdb_WriteTreeNode(originalTreeRef->rootNodeRef, fileRef);
-    int retVal = -1;
+    originalTreeRef->commitCount++;
 
-    retVal = close(fileRef);
+    LE_DEBUG("Commit to tree '%s' wrote %zu bytes.",
+             originalTreeRef->name,
+             originalTreeRef->bytesWritten - oldBytesWritten);
+}
 
-    LE_EMERG_IF(retVal == -1, "An error occurred while closing the tree file: %s", strerror(errno));
 
-    // Finally remove the old version of the tree file, if there is one.
-    if (writeResult == LE_OK)
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Hold the journal records of the commits to a tree in memory, until every call to this function
+ *  has been matched by a call to tdb_SyncTree(), so that the changes of several commits can be
+ *  written to storage with a single sync.  The tree isn't deleted while its sync is deferred.
+ */
+// -------------------------------------------------------------------------------------------------
+void tdb_DeferSync
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree to defer the sync of.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(treeRef != NULL);
+
+    if (treeRef->originalTreeRef != NULL)
     {
-        if (   (oldId != 0)
-            && (TreeFileExists(originalTreeRef->name, oldId)))
+        treeRef = treeRef->originalTreeRef;
+    }
+
+    treeRef->syncDeferCount++;
+}
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  End one deferral of a tree's sync.  When the last one ends, the journal records held since the
+ *  first tdb_DeferSync() call are written to storage, and each commit is written as it is merged
+ *  again.  If the tree was deleted in the meantime, it is deleted then, and the tree reference
+ *  must not be used after this call.
+ */
+// -------------------------------------------------------------------------------------------------
+void tdb_SyncTree
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree to sync.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    LE_ASSERT(treeRef != NULL);
+
+    if (treeRef->originalTreeRef != NULL)
+    {
+        treeRef = treeRef->originalTreeRef;
+    }
+
+    LE_ASSERT(treeRef->syncDeferCount > 0);
+    treeRef->syncDeferCount--;
+
+    if (treeRef->syncDeferCount > 0)
+    {
+        return;
+    }
+
+    if (treeRef->pendingSize > 0)
+    {
+        struct iovec vector = { .iov_base = treeRef->pendingPtr,
+                                .iov_len = treeRef->pendingSize };
+        le_result_t result = WriteJournal(treeRef, &vector, 1);
+
+        free(treeRef->pendingPtr);
+        treeRef->pendingPtr = NULL;
+        treeRef->pendingSize = 0;
+
+        if (result == LE_IO_ERROR)
         {
-            GetTreePath(originalTreeRef->name, oldId, filePath, sizeof(filePath));
-            DeleteTreeFile(filePath);
+            result = WriteTreeFile(treeRef);
+        }
+
+        if (result == LE_OK)
+        {
+            ScheduleCompaction(treeRef);
+        }
+        else if (result != LE_NOT_PERMITTED)
+        {
+            LE_EMERG("Changes have been merged in memory, however they could not be committed to "
+                     "the filesystem!!");
         }
     }
-    else
+
+    // A deletion requested while the sync was deferred was put off until now.
+    if (treeRef->isDeletePending)
     {
-        // The write failed, delete the new file we attempted to create.
-        LE_EMERG("The attempt to write to the config tree file, '%s,' failed.", filePath);
-        DeleteTreeFile(filePath);
+        tdb_DeleteTree(treeRef);
     }
 }
 
@@ -3243,7 +5756,8 @@ void tdb_MergeTree
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Call this to realease a tree.
+ *  Call this to realease a tree.  Shadow trees are freed, and so are tree versions once they have
+ *  no read iterators left.
  */
 // -------------------------------------------------------------------------------------------------
 void tdb_ReleaseTree
@@ -3254,7 +5768,9 @@ void tdb_ReleaseTree
 {
     LE_ASSERT(treeRef != NULL);
 
-    if (treeRef->originalTreeRef != NULL)
+    if (   (treeRef->originalTreeRef != NULL)
+        || (   (treeRef->isVersion)
+            && (treeRef->activeReadCount == 0)))
     {
         le_mem_Release(treeRef);
     }
@@ -3290,6 +5806,11 @@ bool tdb_ReadTreeNode
     tdb_SetEmpty(nodeRef);
     tdb_EnsureExists(nodeRef);
 
+    if (IsSnapshotFile(descriptor))
+    {
+        return ReadSnapshot(nodeRef, descriptor);
+    }
+
     // Convert to a C style file pointer.
     FILE* filePtr = OpenFilePtr(descriptor, "r");
 
@@ -3367,6 +5888,119 @@ le_result_t tdb_WriteTreeNode
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Write a tree node and its children to a file as a snapshot.
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+// -------------------------------------------------------------------------------------------------
+le_result_t tdb_WriteTreeSnapshot
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] Write the contents of this node to a file descriptor.
+    int descriptor          ///< [IN] The file descriptor to write to.
+)
+// -------------------------------------------------------------------------------------------------
+{
+    SnapshotWriter_t writer;
+    char* stringBuffer = le_mem_ForceAlloc(EncodedStringPool);
+    size_t i;
+
+    memset(&writer, 0, sizeof(writer));
+
+    // The root record doesn't have a name.
+    AddSnapshotRecord(&writer, nodeRef, AddSnapshotString(&writer, ""));
+
+    // Records are added breadth first, so each stem's children end up next to each other.
+    for (i = 0; i < writer.recordCount; i++)
+    {
+        tdb_NodeRef_t currentRef = writer.nodesPtr[i];
+        le_cfg_nodeType_t type = tdb_GetNodeType(currentRef);
+        uint32_t first = 0;
+        uint32_t count = 0;
+
+        switch (type)
+        {
+            case LE_CFG_TYPE_EMPTY:
+            case LE_CFG_TYPE_DOESNT_EXIST:
+                type = LE_CFG_TYPE_EMPTY;
+                break;
+
+            case LE_CFG_TYPE_STEM:
+                {
+                    tdb_NodeRef_t childRef = tdb_GetFirstActiveChildNode(currentRef);
+
+                    first = writer.recordCount;
+
+                    while (childRef != NULL)
+                    {
+                        tdb_GetNodeName(childRef, stringBuffer, TDB_MAX_ENCODED_SIZE);
+                        AddSnapshotRecord(&writer,
+                                          childRef,
+                                          AddSnapshotString(&writer, stringBuffer));
+
+                        childRef = tdb_GetNextActiveSiblingNode(childRef);
+                    }
+
+                    count = writer.recordCount - first;
+                }
+                break;
+
+            default:
+                tdb_GetValueAsString(currentRef, stringBuffer, TDB_MAX_ENCODED_SIZE, "");
+                first = AddSnapshotString(&writer, stringBuffer);
+                count = strlen(stringBuffer);
+                break;
+        }
+
+        writer.recordsPtr[i].type = type;
+        writer.recordsPtr[i].first = first;
+        writer.recordsPtr[i].count = count;
+    }
+
+    SnapshotHeader_t header =
+    {
+        .version = SNAPSHOT_VERSION,
+        .recordCount = writer.recordCount,
+        .stringsSize = writer.stringsSize
+    };
+
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+
+    le_result_t result = LE_IO_ERROR;
+    FILE* filePtr = OpenFilePtr(descriptor, "w");
+
+    if (filePtr != NULL)
+    {
+        result = WriteFile(filePtr, &header, sizeof(header));
+
+        if (result == LE_OK)
+        {
+            result = WriteFile(filePtr,
+                               writer.recordsPtr,
+                               writer.recordCount * sizeof(SnapshotRecord_t));
+        }
+
+        if (result == LE_OK)
+        {
+            result = WriteFile(filePtr, writer.stringsPtr, writer.stringsSize);
+        }
+
+        CloseFilePtr(filePtr);
+    }
+
+    free(writer.nodesPtr);
+    free(writer.recordsPtr);
+    free(writer.stringsPtr);
+    free(writer.slotsPtr);
+    le_mem_Release(stringBuffer);
+
+    return result;
+}
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  Given a base node and a path, find another node in the tree.
@@ -3619,6 +6253,10 @@ le_result_t tdb_SetNodeName
         return LE_OVERFLOW;
     }
 
+    // The node moves to another bucket of its parent's child index.  Take it out while its old name
+    // can still be hashed.
+    UnindexChild(nodeRef);
+
     // Copy over the new name.  Note that we don't care if this node is a shadow node.  Coping over
     // the name is taken care of as part of the merge process.
     if (nodeRef->nameRef == NULL)
@@ -3631,6 +6269,8 @@ le_result_t tdb_SetNodeName
     }
     nodeRef->nameHash = le_hashmap_HashString(stringPtr);
 
+    IndexChild(nodeRef);
+
     // If this is a shadow node and this is the change that modified it, then try to get it's
     // children now.  This is done so that later when this node is merged the merge code doesn't end
     // up thinking that the child nodes where removed.
@@ -3756,6 +6396,8 @@ void tdb_SetEmpty
     // If this is a stem node, then go through and clear out the children.
     if (nodeRef->type == LE_CFG_TYPE_STEM)
     {
+        DropSnapshot(nodeRef);
+
         tdb_NodeRef_t childRef = tdb_GetFirstChildNode(nodeRef);
 
         while (childRef != NULL)
@@ -3865,6 +6507,9 @@ tdb_NodeRef_t tdb_GetFirstChildNode
 {
     LE_ASSERT(nodeRef != NULL);
 
+    ReadSnapshotChildren(nodeRef);
+    CopyVersionChildren(nodeRef);
+
     // Is this the type of node that has children?
     if (   (   (nodeRef->type != LE_CFG_TYPE_STEM)
             || (le_dls_IsEmpty(&nodeRef->info.children) == true))
@@ -85,8 +85,9 @@ tdb_TreeRef_t tdb_GetTree
 /**
  *  Called to delete the given tree both from memory and from the filesystem.
  *
- *  If the given tree has active iterators on it, then it will only be marked for deletion.  After
- *  all of the iterators close, the tree will be removed from the system automatically.
+ *  If the given tree has active iterators on it, or its sync is deferred, then it will only be
+ *  marked for deletion.  After all of the iterators close and the sync happens, the tree will be
+ *  removed from the system automatically.
  */
 // -------------------------------------------------------------------------------------------------
 void tdb_DeleteTree
@@ -127,6 +128,24 @@ tdb_TreeRef_t tdb_ShadowTree
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Make a tree version of the current state of a tree, for the read iterators on the tree to be
+ *  moved onto before a change is merged into it.  The version shares the tree's nodes until they're
+ *  changed.  It is freed by tdb_ReleaseTree() once it has no read iterators left, so at least one
+ *  must be moved onto it, or it must be released.
+ *
+ *  @return Pointer to the new tree version.
+ */
+// -------------------------------------------------------------------------------------------------
+tdb_TreeRef_t tdb_NewTreeVersion
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree to copy.
+);
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  Called to create a new tree that shadows an existing one.
@@ -234,7 +253,8 @@ le_sls_List_t* tdb_GetRequestQueue
 // -------------------------------------------------------------------------------------------------
 /**
  *  Merge a shadow tree into the original tree it was created from.  Once the change is merged the
- *  updated tree is serialized to the filesystem.
+ *  updated tree is serialized to the filesystem, unless the tree's sync has been deferred by
+ *  tdb_DeferSync().
  */
 // -------------------------------------------------------------------------------------------------
 void tdb_MergeTree
@@ -247,7 +267,39 @@ void tdb_MergeTree
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Call this to realease a tree.
+ *  Hold the journal records of the commits to a tree in memory, until every call to this function
+ *  has been matched by a call to tdb_SyncTree(), so that the changes of several commits can be
+ *  written to storage with a single sync.  The tree isn't deleted while its sync is deferred.
+ */
+// -------------------------------------------------------------------------------------------------
+void tdb_DeferSync
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree to defer the sync of.
+);
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  End one deferral of a tree's sync.  When the last one ends, the journal records held since the
+ *  first tdb_DeferSync() call are written to storage, and each commit is written as it is merged
+ *  again.  If the tree was deleted in the meantime, it is deleted then, and the tree reference
+ *  must not be used after this call.
+ */
+// -------------------------------------------------------------------------------------------------
+void tdb_SyncTree
+(
+    tdb_TreeRef_t treeRef  ///< [IN] The tree to sync.
+);
+
+
+
+
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Call this to realease a tree.  Shadow trees are freed, and so are tree versions once they have
+ *  no read iterators left.
  */
 // -------------------------------------------------------------------------------------------------
 void tdb_ReleaseTree
@@ -260,7 +312,8 @@ void tdb_ReleaseTree
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Read a configuration tree node's contents from the file system.
+ *  Read a configuration tree node's contents from the file system.  The file can be in the text
+ *  format or be a snapshot written by tdb_WriteTreeSnapshot().
  *
  *  @note On exit the descriptor's file pointer will be at EOF.  If the function fails, then the
  *        file pointer will be somewhere in the middle of the file.
@@ -293,6 +346,24 @@ le_result_t tdb_WriteTreeNode
 
 
 
+// -------------------------------------------------------------------------------------------------
+/**
+ *  Write a tree node and its children to a file as a snapshot: a compact binary format, with an
+ *  array of node records and a table of the names and values, that can be mapped into memory and
+ *  read as the nodes are used.
+ *
+ *  @return LE_OK if the write succeeded, LE_IO_ERROR if the write failed.
+ */
+// -------------------------------------------------------------------------------------------------
+le_result_t tdb_WriteTreeSnapshot
+(
+    tdb_NodeRef_t nodeRef,  ///< [IN] Write the contents of this node to a file descriptor.
+    int descriptor          ///< [IN] The file descriptor to write to.
+);
+
+
+
+
 // -------------------------------------------------------------------------------------------------
 /**
  *  Given a base node and a path, find another node in the tree.
@@ -59,6 +59,9 @@
  * running process that belongs to an IPC session reference when the IPC system reports that
  * a session closed.  This is how the Log Control Daemon finds out that a client process died.
  *
+ * Flush policies apply to whole processes rather than to log sessions, so they are kept in the
+ * Process Name and Running Process objects.
+ *
  * Copyright (C) Sierra Wireless Inc.
  */
 
@@ -165,6 +168,7 @@ typedef struct
     char    name[LIMIT_MAX_PROCESS_NAME_BYTES]; ///< The process name.
     le_dls_List_t   componentNameList;          ///< List of component names with settings.
     le_dls_List_t   runningProcessesList;       ///< List of running processes with this name.
+    log_FlushPolicy_t flushPolicy;              ///< The flush policy setting, or -1 if not set.
 }
 ProcessName_t;
 
@@ -223,6 +227,7 @@ typedef struct
     pid_t               pid;            ///< The process ID.
     le_msg_SessionRef_t ipcSessionRef;  ///< Reference to the IPC session connected to this process.
     le_dls_List_t       logSessionList; ///< List of log sessions in this process.
+    log_FlushPolicy_t   flushPolicy;    ///< The process's flush policy, or -1 if not set.
 /* TODO: Implement shared memory.
     void*               sharedMemAddr;  ///< Address of base of memory region shared with
                                         ///  this process.
@@ -624,6 +629,7 @@ static ProcessName_t* CreateProcessName
 
     objPtr->componentNameList = LE_DLS_LIST_INIT;
     objPtr->runningProcessesList = LE_DLS_LIST_INIT;
+    objPtr->flushPolicy = (log_FlushPolicy_t)-1;
 
     le_hashmap_Put(ProcessNameMapRef, objPtr->name, objPtr);
 
@@ -724,6 +730,7 @@ static RunningProcess_t* CreateRunningProcess
     RunningProcess_t* objPtr = le_mem_ForceAlloc(RunningProcessPoolRef);
 
     objPtr->logSessionList = LE_DLS_LIST_INIT;
+    objPtr->flushPolicy = (log_FlushPolicy_t)-1;
 
     le_dls_Queue(&procNameObjPtr->runningProcessesList, &objPtr->link);
     objPtr->procNameObjPtr = procNameObjPtr;
@@ -1309,6 +1316,59 @@ static void UpdateProcCompSettings
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends a client an update to its flush policy, if it's not -1 (default).
+ **/
+//--------------------------------------------------------------------------------------------------
+static void UpdateClientFlushPolicy
+(
+    RunningProcess_t* runningProcObjPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (runningProcObjPtr->flushPolicy != (log_FlushPolicy_t)-1)
+    {
+        le_msg_MessageRef_t msgRef = le_msg_CreateMsg(runningProcObjPtr->ipcSessionRef);
+
+        snprintf(le_msg_GetPayloadPtr(msgRef),
+                 le_msg_GetMaxPayloadSize(msgRef),
+                 "%c*/%s",
+                 LOG_CMD_SET_FLUSH_POLICY,
+                 log_FlushPolicyToStr(runningProcObjPtr->flushPolicy));
+
+        le_msg_Send(msgRef);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Applies the flush policy set for a new running process's name to it.  If none is set for that
+ * name, the flush policy set for the wild card process is used.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateProcFlushPolicy
+(
+    RunningProcess_t* runningProcObjPtr
+)
+{
+    ProcessName_t* procNameObjPtr = runningProcObjPtr->procNameObjPtr;
+
+    if (procNameObjPtr->flushPolicy == (log_FlushPolicy_t)-1)
+    {
+        procNameObjPtr = FindProcessName("*");
+    }
+
+    if (procNameObjPtr != NULL)
+    {
+        runningProcObjPtr->flushPolicy = procNameObjPtr->flushPolicy;
+
+        UpdateClientFlushPolicy(runningProcObjPtr);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Adds the process/component to our registry if it is not already there.
@@ -1394,6 +1454,7 @@ static void RegComponent
 
         // Add the running process and the active log session to our structures.
         runningProcObjPtr = CreateRunningProcess(procNameObjPtr, pid, ipcSessionRef);
+        UpdateProcFlushPolicy(runningProcObjPtr);
         logSessionPtr = CreateLogSession(runningProcObjPtr, componentName);
 
         UpdateProcCompSettings(runningProcObjPtr, logSessionPtr, NULL, componentName);
@@ -1434,6 +1495,7 @@ static void RegComponent
         {
             // Add the running process to our structures.
             runningProcObjPtr = CreateRunningProcess(procNameObjPtr, pid, ipcSessionRef);
+            UpdateProcFlushPolicy(runningProcObjPtr);
         }
 
         // Create a log session object in the running process's list of log sessions.
@@ -1506,10 +1568,11 @@ static void ClientIpcSessionClosed
     // Delete the Running Process object.
     le_mem_Release(runningProcObjPtr);
 
-    // If the Process Name object now has no other running processes and no component names
+    // If the Process Name object now has no other running processes and no settings
     // associated with it, forget it.
     if (   le_dls_IsEmpty(&procNameObjPtr->runningProcessesList)
-        && le_dls_IsEmpty(&procNameObjPtr->componentNameList) )
+        && le_dls_IsEmpty(&procNameObjPtr->componentNameList)
+        && (procNameObjPtr->flushPolicy == (log_FlushPolicy_t)-1) )
     {
         DeleteProcessName(procNameObjPtr);
     }
@@ -2186,6 +2249,120 @@ static void SetTrace
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the flush policy for all running processes that share a Process Name object.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void SetFlushPolicyForRunningProcesses
+(
+    const ProcessName_t* procNameObjPtr,
+    log_FlushPolicy_t policy
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&procNameObjPtr->runningProcessesList);
+    while (linkPtr != NULL)
+    {
+        RunningProcess_t* runningProcObjPtr = CONTAINER_OF(linkPtr, RunningProcess_t, link);
+
+        runningProcObjPtr->flushPolicy = policy;
+        UpdateClientFlushPolicy(runningProcObjPtr);
+
+        linkPtr = le_dls_PeekNext(&procNameObjPtr->runningProcessesList, linkPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the flush policy for a given process.  Like the log level, it's kept for future processes
+ * if the process is identified by name, and applies to all processes if the name is "*".
+ **/
+//--------------------------------------------------------------------------------------------------
+static void SetFlushPolicy
+(
+    const char* processName,
+    const char* policyStr,
+    le_msg_SessionRef_t toolIpcSessionRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    char message[128];
+
+    log_FlushPolicy_t policy = log_StrToFlushPolicy(policyStr);
+
+    if (policy == (log_FlushPolicy_t)-1)
+    {
+        snprintf(message, sizeof(message), "***ERROR: Invalid flush policy '%s'.", policyStr);
+        LE_WARN("%s", message);
+        SendToLogTool(toolIpcSessionRef, message);
+        return;
+    }
+
+    // If a PID was used to specify that the policy applies to a specific running process,
+    pid_t pid = StringToPid(processName);
+    if (pid > 0)
+    {
+        RunningProcess_t* runningProcObjPtr = FindProcessByPid(pid);
+        if (runningProcObjPtr == NULL)
+        {
+            snprintf(message, sizeof(message), "***ERROR: PID %d not found.", pid);
+            LE_WARN("%s", message);
+            SendToLogTool(toolIpcSessionRef, message);
+            return;
+        }
+
+        runningProcObjPtr->flushPolicy = policy;
+        UpdateClientFlushPolicy(runningProcObjPtr);
+    }
+    // If the process name is "*",
+    else if (strcmp(processName, "*") == 0)
+    {
+        // Set it for the wild card process, which will be used for processes that start later,
+        // and override it for all the process names that we know of.
+        ProcessName_t* wildProcPtr = FindProcessName("*");
+        if (wildProcPtr == NULL)
+        {
+            wildProcPtr = CreateProcessName("*");
+        }
+        wildProcPtr->flushPolicy = policy;
+
+        le_hashmap_It_Ref_t iteratorRef = le_hashmap_GetIterator(ProcessNameMapRef);
+        while (le_hashmap_NextNode(iteratorRef) == LE_OK)
+        {
+            ProcessName_t* procNameObjPtr = le_hashmap_GetValue(iteratorRef);
+
+            if (procNameObjPtr->flushPolicy != (log_FlushPolicy_t)-1)
+            {
+                procNameObjPtr->flushPolicy = policy;
+            }
+
+            SetFlushPolicyForRunningProcesses(procNameObjPtr, policy);
+        }
+    }
+    else
+    {
+        // This setting applies to processes sharing a specific name.
+        ProcessName_t* procNameObjPtr = FindProcessName(processName);
+        if (procNameObjPtr == NULL)
+        {
+            procNameObjPtr = CreateProcessName(processName);
+        }
+        procNameObjPtr->flushPolicy = policy;
+
+        SetFlushPolicyForRunningProcesses(procNameObjPtr, policy);
+    }
+
+    snprintf(message,
+             sizeof(message),
+             "Set flush policy for '%s' to '%s'.",
+             processName,
+             policyStr);
+    SendToLogTool(toolIpcSessionRef, message);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sends a message to the log tool containing a printable, null-terminated, UTF-8 string
@@ -2203,7 +2380,18 @@ static void SendProcessNameToLogTool
 
     char* payloadPtr = le_msg_GetPayloadPtr(msgRef);
 
-    snprintf(payloadPtr, le_msg_GetMaxPayloadSize(msgRef), "%s", procNameObjPtr->name);
+    if (procNameObjPtr->flushPolicy != (log_FlushPolicy_t)-1)
+    {
+        snprintf(payloadPtr,
+                 le_msg_GetMaxPayloadSize(msgRef),
+                 "%s (flush %s)",
+                 procNameObjPtr->name,
+                 log_FlushPolicyToStr(procNameObjPtr->flushPolicy));
+    }
+    else
+    {
+        snprintf(payloadPtr, le_msg_GetMaxPayloadSize(msgRef), "%s", procNameObjPtr->name);
+    }
 
     le_msg_Send(msgRef);
 }
@@ -2339,10 +2527,21 @@ static void SendRunningProcessInfoToLogTool
 
     char* payloadPtr = le_msg_GetPayloadPtr(msgRef);
 
-    snprintf(payloadPtr,
-             le_msg_GetMaxPayloadSize(msgRef),
-             "  pid %d",
-             runningProcObjPtr->pid);
+    if (runningProcObjPtr->flushPolicy != (log_FlushPolicy_t)-1)
+    {
+        snprintf(payloadPtr,
+                 le_msg_GetMaxPayloadSize(msgRef),
+                 "  pid %d (flush %s)",
+                 runningProcObjPtr->pid,
+                 log_FlushPolicyToStr(runningProcObjPtr->flushPolicy));
+    }
+    else
+    {
+        snprintf(payloadPtr,
+                 le_msg_GetMaxPayloadSize(msgRef),
+                 "  pid %d",
+                 runningProcObjPtr->pid);
+    }
 
     le_msg_Send(msgRef);
 
@@ -2439,6 +2638,7 @@ static void ForgetProcess
     if (!le_dls_IsEmpty(&procNameObjPtr->runningProcessesList))
     {
         DeleteAllComponentNamesForProcessName(procNameObjPtr);
+        procNameObjPtr->flushPolicy = (log_FlushPolicy_t)-1;
         snprintf(message,
                  sizeof(message),
                  "Persistent settings for future processes named '%s' have been reset.",
@@ -2494,6 +2694,7 @@ static void ClientMsgReceiveHandler
             case LOG_CMD_SET_LEVEL:
             case LOG_CMD_ENABLE_TRACE:
             case LOG_CMD_DISABLE_TRACE:
+            case LOG_CMD_SET_FLUSH_POLICY:
             case LOG_CMD_LIST_COMPONENTS:
             case LOG_CMD_FORGET_PROCESS:
 
@@ -2565,6 +2766,12 @@ static void ControlToolMsgReceiveHandler
 
                 break;
 
+            case LOG_CMD_SET_FLUSH_POLICY:
+
+                SetFlushPolicy(processName, commandDataPtr, ipcSessionRef);
+
+                break;
+
             case LOG_CMD_REG_COMPONENT:
 
                 LE_ERROR("Unexpected command '%c' from log control tool.", command);
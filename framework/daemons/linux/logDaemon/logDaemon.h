@@ -86,6 +86,9 @@
 #define LOG_CMD_SET_LEVEL               'l' // CommandData = level string (see below)
 #define LOG_CMD_ENABLE_TRACE            'e' // CommandData = keyword string
 #define LOG_CMD_DISABLE_TRACE           'd' // CommandData = keyword string
+#define LOG_CMD_SET_FLUSH_POLICY        'f' // CommandData = flush policy string (see below)
+                                            // Applies to whole processes, so the ComponentName
+                                            // is always "*".
 
 
 //--------------------------------------------------------------------------------------------------
@@ -117,6 +120,15 @@
 #define LOG_SET_LEVEL_DEBUG_STR "DEBUG"
 
 
+// ===================================================================
+//  FLUSH POLICIES (CommandData part of SET_FLUSH_POLICY commands)
+// ===================================================================
+
+#define LOG_FLUSH_POLICY_SYNC_STR   "SYNC"
+#define LOG_FLUSH_POLICY_ASYNC_STR  "ASYNC"
+#define LOG_FLUSH_POLICY_DEFERRED_STR "DEFERRED"
+
+
 // =========================================================================
 //  LOG OUTPUT LOCATION NAMES (CommandData part of SET_OUTPUT_LOC commands)
 // =========================================================================
@@ -70,7 +70,7 @@ User List ------> User --+---> Name               |        |        |
 @endverbatim
  *
  * The User object represents a single user account.  It has a unique ID which is used as the key
- * to find it in the User List.  Each User also has
+ * to find it in the User Map.  Each User also has
  *  - list of bindings from a client-side interface name to a server's user name and service name.
  *  - list of services that it offers, and
  *  - list of client connections that are waiting for a binding to be created for them.
@@ -98,26 +98,36 @@ User List ------> User --+---> Name               |        |        |
  * Each Binding object and Connection object holds a reference count on a User object.  A User
  * object will be deleted when all associated Binding objects and Connection objects are deleted.
  *
+ * The lists are walked to list things for the 'sdir' tool, but lookups go through hash maps that
+ * are kept in sync with them, so that opening a session or advertising a service doesn't have to
+ * search every user's lists:
+ *  - the User Map finds User objects by user ID,
+ *  - the Binding Map finds Binding objects by client user ID and client interface name,
+ *  - the Service Map finds the Server Connection that serves a service, by server user ID and
+ *    service name, and
+ *  - the Binding Target Map finds the Binding Target object of a service, by server user ID and
+ *    service name.  A Binding Target exists while bindings point to its service, and keeps the
+ *    list of those bindings.
+ *
  *
  * @section sd_theoryOfOperation Theory of Operation
  *
  * When a client connects and makes a request to open a service, the client's UID is looked up in
- * the User List.  The client User's Binding List is searched for the interface name provided by
- * the client.  If a matching Binding object is not found, the Client Connection object is added
- * to the User object's Unbound Clients List.  If a matching Binding object is found, it will
- * specify the server User object and service name.  The server's User's Service List will be
- * searched for a matching Server Connection object.  If no matching Server Connection can be
- * found, the Client Connection is added to the Binding object's Waiting Clients List.
- *
- * When a server connects and advertises a service, the server UID is looked-up in the User List.
- * The service name is then searched for in the Service List for that User.  If a Server Connection
- * object is not found for that service name on that User, the new one is is added to the list.
- * Otherwise, the new server connection is dropped.
- *
- * When a new Server Connection is added to a Service List, all users' Binding Lists are
- * searched for matching bindings, and if any that match have non-empty Waiting Clients Lists,
- * all those Client Connections are removed from those lists and dispatched to the new Server
- * Connection.
+ * the User Map.  The client's UID and the interface name provided by the client are looked up in
+ * the Binding Map.  If a matching Binding object is not found, the Client Connection object is
+ * added to the User object's Unbound Clients List.  If a matching Binding object is found, it will
+ * specify the server User object and service name, and point to the Server Connection serving
+ * that service, if any.  If there is none, the Client Connection is added to the Binding object's
+ * Waiting Clients List.
+ *
+ * When a server connects and advertises a service, the server UID is looked-up in the User Map.
+ * The server UID and service name are then looked up in the Service Map.  If a Server Connection
+ * object is not found for that service name on that User, the new one is is added to the map and
+ * to the User's Service List.  Otherwise, the new server connection is dropped.
+ *
+ * When a new Server Connection is added to the Service Map, the bindings on the service's Binding
+ * Target are pointed at it, and if any of them have non-empty Waiting Clients Lists, all those
+ * Client Connections are removed from those lists and dispatched to the new Server Connection.
  *
  * When a Binding is added, it is added to the client's User object's Binding List.  That user's
  * Unbound Clients List will then be checked for matches to the new binding, and if any are found,
@@ -220,6 +230,20 @@ User List ------> User --+---> Name               |        |        |
 #define MAX_CONNECT_REQUEST_BACKLOG 100
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Key of the Binding Map, the Service Map and the Binding Target Map: a user ID and an interface
+ * name.  The name points into the object that the key belongs to.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uid_t       uid;    ///< Unix user ID.
+    const char* name;   ///< Interface name.
+}
+InterfaceKey_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Represents a user.  Objects of this type are allocated from the User Pool and are kept on the
@@ -250,6 +274,12 @@ static le_mem_PoolRef_t UserPoolRef;
 static le_dls_List_t UserList = LE_DLS_LIST_INIT;
 
 
+//--------------------------------------------------------------------------------------------------
+/// Map of User objects, keyed by user ID.
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t UserMapRef;
+
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -265,6 +295,7 @@ typedef struct
     User_t*                     userPtr;        ///< Pointer to the User object for the client uid.
     pid_t                       pid;            ///< Process ID of client process.
     svcdir_InterfaceDetails_t   interface;      ///< IPC interface details.
+    InterfaceKey_t              serviceKey;     ///< Key in the Service Map (once advertised).
 }
 ServerConnection_t;
 
@@ -275,6 +306,41 @@ ServerConnection_t;
 static le_mem_PoolRef_t ServerConnectionPoolRef;
 
 
+//--------------------------------------------------------------------------------------------------
+/// Map of the Server Connections that serve services, keyed by server user ID and service name.
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t ServiceMapRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Represents a service that bindings point to, whether or not a server is offering it.  Keeps the
+ * list of those bindings, so that they can be found when a server advertises the service or goes
+ * away.  Objects of this type are allocated from the Binding Target Pool and are kept in the
+ * Binding Target Map while bindings point to them.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    InterfaceKey_t  key;            ///< Key in the Binding Target Map (server uid, service name).
+    char            serviceName[LIMIT_MAX_IPC_INTERFACE_NAME_BYTES]; ///< Service name.
+    le_dls_List_t   bindingList;    ///< List of Bindings that point to this service.
+}
+BindingTarget_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/// Pool from which Binding Target objects are allocated.
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t BindingTargetPoolRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/// Map of Binding Target objects, keyed by server user ID and service name.
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t BindingTargetMapRef;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Represents a binding from a user's client interface to a service.  Objects of this type are
@@ -290,6 +356,9 @@ typedef struct
     char                serverInterfaceName[LIMIT_MAX_IPC_INTERFACE_NAME_BYTES];///< Service name
     ServerConnection_t* serverConnectionPtr;///< Ptr to Server Connection (NULL if service unavail.)
     le_dls_List_t       waitingClientsList; ///< List of Client Connections waiting for the service.
+    InterfaceKey_t      clientKey;          ///< Key in the Binding Map (client uid, client i/f name).
+    BindingTarget_t*    targetPtr;          ///< Ptr to the Binding Target of the service.
+    le_dls_Link_t       targetLink;         ///< Used to link into the Binding Target's Binding List.
 }
 Binding_t;
 
@@ -300,6 +369,12 @@ Binding_t;
 static le_mem_PoolRef_t BindingPoolRef;
 
 
+//--------------------------------------------------------------------------------------------------
+/// Map of Binding objects, keyed by client user ID and client interface name.
+//--------------------------------------------------------------------------------------------------
+static le_hashmap_Ref_t BindingMapRef;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Enumeration of the different states that a client connection can be in.
@@ -370,6 +445,43 @@ static le_fdMonitor_Ref_t ServerSocketMonitorRef;
 // =======================================
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Key hash function for the maps keyed by user ID and interface name.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t ComputeInterfaceKeyHash
+(
+    const void* keyPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const InterfaceKey_t* interfaceKeyPtr = keyPtr;
+
+    return (le_hashmap_HashString(interfaceKeyPtr->name) * 31) + interfaceKeyPtr->uid;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Key equality comparison function for the maps keyed by user ID and interface name.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool AreInterfaceKeysTheSame
+(
+    const void* firstKeyPtr,
+    const void* secondKeyPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const InterfaceKey_t* firstInterfaceKeyPtr = firstKeyPtr;
+    const InterfaceKey_t* secondInterfaceKeyPtr = secondKeyPtr;
+
+    return (   (firstInterfaceKeyPtr->uid == secondInterfaceKeyPtr->uid)
+            && le_hashmap_EqualsString(firstInterfaceKeyPtr->name, secondInterfaceKeyPtr->name) );
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Creates a User object for a given Unix user ID.
@@ -399,8 +511,9 @@ static User_t* CreateUser
     userPtr->serviceList = LE_DLS_LIST_INIT;
     userPtr->unboundClientsList = LE_DLS_LIST_INIT;
 
-    // Add it to the User List.
+    // Add it to the User List and the User Map.
     le_dls_Queue(&UserList, &userPtr->link);
+    le_hashmap_Put(UserMapRef, &userPtr->uid, userPtr);
 
     return userPtr;
 }
@@ -408,7 +521,7 @@ static User_t* CreateUser
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Searches the User List for a particular Unix user ID.  If found, increments the reference count
+ * Looks up a particular Unix user ID in the User Map.  If found, increments the reference count
  * on that object.  If not found, creates a new User object.
  *
  * @return Pointer to the User object.
@@ -420,19 +533,12 @@ static User_t* GetUser
 )
 //--------------------------------------------------------------------------------------------------
 {
-    le_dls_Link_t* linkPtr = le_dls_Peek(&UserList);
+    User_t* userPtr = le_hashmap_Get(UserMapRef, &uid);
 
-    while (linkPtr != NULL)
+    if (userPtr != NULL)
     {
-        User_t* userPtr = CONTAINER_OF(linkPtr, User_t, link);
-
-        if (userPtr->uid == uid)
-        {
-            le_mem_AddRef(userPtr);
-            return userPtr;
-        }
-
-        linkPtr = le_dls_PeekNext(&UserList, linkPtr);
+        le_mem_AddRef(userPtr);
+        return userPtr;
     }
 
     return CreateUser(uid);
@@ -453,14 +559,16 @@ static void UserDestructor
 {
     User_t* userPtr = objPtr;
 
-    // Remove the User object from the User List.
+    // Remove the User object from the User List and the User Map.
     le_dls_Remove(&UserList, &userPtr->link);
+    le_hashmap_Remove(UserMapRef, &userPtr->uid);
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Searches a (client) User's Binding List for a particular client-side interface name.
+ * Looks up a (client) User's binding for a particular client-side interface name in the Binding
+ * Map.
  *
  * @return Pointer to the Binding object or NULL if not found.
  **/
@@ -472,21 +580,44 @@ static Binding_t* FindBinding
 )
 //--------------------------------------------------------------------------------------------------
 {
-    le_dls_Link_t* linkPtr = le_dls_Peek(&userPtr->bindingList);
+    InterfaceKey_t key = { .uid = userPtr->uid, .name = interfaceName };
 
-    while (linkPtr != NULL)
+    return le_hashmap_Get(BindingMapRef, &key);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the Binding Target object of a service, creating it if there isn't one yet.
+ *
+ * @return Pointer to the Binding Target object.
+ **/
+//--------------------------------------------------------------------------------------------------
+static BindingTarget_t* GetBindingTarget
+(
+    uid_t serverUserId,             ///< [in] Server's user ID.
+    const char* serviceName         ///< [in] Service name.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    InterfaceKey_t key = { .uid = serverUserId, .name = serviceName };
+
+    BindingTarget_t* targetPtr = le_hashmap_Get(BindingTargetMapRef, &key);
+
+    if (targetPtr == NULL)
     {
-        Binding_t* bindingPtr = CONTAINER_OF(linkPtr, Binding_t, link);
+        targetPtr = le_mem_ForceAlloc(BindingTargetPoolRef);
 
-        if (strcmp(bindingPtr->clientInterfaceName, interfaceName) == 0)
-        {
-            return bindingPtr;
-        }
+        // Note: we know the service name is a valid length.
+        le_utf8_Copy(targetPtr->serviceName, serviceName, sizeof(targetPtr->serviceName), NULL);
+        targetPtr->key.uid = serverUserId;
+        targetPtr->key.name = targetPtr->serviceName;
+        targetPtr->bindingList = LE_DLS_LIST_INIT;
 
-        linkPtr = le_dls_PeekNext(&userPtr->bindingList, linkPtr);
+        le_hashmap_Put(BindingTargetMapRef, &targetPtr->key, targetPtr);
     }
 
-    return NULL;
+    return targetPtr;
 }
 
 
@@ -597,7 +728,7 @@ static le_result_t ReceiveMessage
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Searches a User's Service List for a particular service name.
+ * Looks up a User's service with a particular service name in the Service Map.
  *
  * @return Pointer to the Server Connection object for the matching service.
  **/
@@ -609,21 +740,9 @@ static ServerConnection_t* FindService
 )
 //--------------------------------------------------------------------------------------------------
 {
-    le_dls_Link_t* linkPtr = le_dls_Peek(&userPtr->serviceList);
-
-    while (linkPtr != NULL)
-    {
-        ServerConnection_t* serverConnectionPtr = CONTAINER_OF(linkPtr, ServerConnection_t, link);
-
-        if (strcmp(serverConnectionPtr->interface.interfaceName, serviceName) == 0)
-        {
-            return serverConnectionPtr;
-        }
-
-        linkPtr = le_dls_PeekNext(&userPtr->serviceList, linkPtr);
-    }
+    InterfaceKey_t key = { .uid = userPtr->uid, .name = serviceName };
 
-    return NULL;
+    return le_hashmap_Get(ServiceMapRef, &key);
 }
 
 
@@ -917,8 +1036,16 @@ static void CreateBinding
     bindingPtr->serverConnectionPtr = NULL;
     bindingPtr->waitingClientsList = LE_DLS_LIST_INIT;
 
-    // Add the Binding to the client User's Binding List.
+    // Add the Binding to the client User's Binding List and the Binding Map.
     le_dls_Queue(&bindingPtr->clientUserPtr->bindingList, &bindingPtr->link);
+    bindingPtr->clientKey.uid = clientUserPtr->uid;
+    bindingPtr->clientKey.name = bindingPtr->clientInterfaceName;
+    le_hashmap_Put(BindingMapRef, &bindingPtr->clientKey, bindingPtr);
+
+    // Add the Binding to its service's Binding Target.
+    bindingPtr->targetPtr = GetBindingTarget(serverUserPtr->uid, serverInterfaceName);
+    bindingPtr->targetLink = LE_DLS_LINK_INIT;
+    le_dls_Queue(&bindingPtr->targetPtr->bindingList, &bindingPtr->targetLink);
 
     // Look for a server serving the binding's destination service.
     bindingPtr->serverConnectionPtr = FindService(bindingPtr->serverUserPtr, serverInterfaceName);
@@ -1001,51 +1128,43 @@ static void ResolveBindingsToServer
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // For each user,
-    le_dls_Link_t* userLinkPtr = le_dls_Peek(&UserList);
+    // Find the bindings that point at the new server's service, if any.
+    BindingTarget_t* targetPtr = le_hashmap_Get(BindingTargetMapRef, &connectionPtr->serviceKey);
 
-    while (userLinkPtr != NULL)
+    if (targetPtr == NULL)
     {
-        User_t* userPtr = CONTAINER_OF(userLinkPtr, User_t, link);
+        return;
+    }
 
-        // For each of the user's bindings,
-        le_dls_Link_t* bindingLinkPtr = le_dls_Peek(&userPtr->bindingList);
-        while (bindingLinkPtr != NULL)
-        {
-            Binding_t* bindingPtr = CONTAINER_OF(bindingLinkPtr, Binding_t, link);
+    // For each of the bindings,
+    le_dls_Link_t* bindingLinkPtr = le_dls_Peek(&targetPtr->bindingList);
+    while (bindingLinkPtr != NULL)
+    {
+        Binding_t* bindingPtr = CONTAINER_OF(bindingLinkPtr, Binding_t, targetLink);
 
-            // If the binding is pointing at the new server's service,
-            if (   (connectionPtr->userPtr == bindingPtr->serverUserPtr)
-                && (0 == strcmp(connectionPtr->interface.interfaceName,
-                                bindingPtr->serverInterfaceName))  )
-            {
-                bindingPtr->serverConnectionPtr = connectionPtr;
+        bindingPtr->serverConnectionPtr = connectionPtr;
 
-                // While there's still a client connection on the Waiting Clients List, get
-                // a pointer to the first one, without removing it from the list, then try
-                // to dispatch that client to the server.
-                le_dls_Link_t* clientLinkPtr;
-                while (NULL != (clientLinkPtr = le_dls_Peek(&bindingPtr->waitingClientsList)))
-                {
-                    ClientConnection_t* clientConnectionPtr = CONTAINER_OF(clientLinkPtr,
-                                                                           ClientConnection_t,
-                                                                           link);
-                    if (DispatchToServer(clientConnectionPtr, connectionPtr) == LE_CLOSED)
-                    {
-                        // Server went down.  Client was left on the Waiting Clients List.
-                        // Server Connection destructor was run and it disconnected itself
-                        // from the Binding object.
-                        return;
-                    }
-                    // NOTE: If the server didn't go down, then the Client Connection has been
-                    // deleted and its destructor removed it from the Waiting Clients List.
-                }
+        // While there's still a client connection on the Waiting Clients List, get
+        // a pointer to the first one, without removing it from the list, then try
+        // to dispatch that client to the server.
+        le_dls_Link_t* clientLinkPtr;
+        while (NULL != (clientLinkPtr = le_dls_Peek(&bindingPtr->waitingClientsList)))
+        {
+            ClientConnection_t* clientConnectionPtr = CONTAINER_OF(clientLinkPtr,
+                                                                   ClientConnection_t,
+                                                                   link);
+            if (DispatchToServer(clientConnectionPtr, connectionPtr) == LE_CLOSED)
+            {
+                // Server went down.  Client was left on the Waiting Clients List.
+                // Server Connection destructor was run and it disconnected itself
+                // from the Binding objects.
+                return;
             }
-
-            bindingLinkPtr = le_dls_PeekNext(&userPtr->bindingList, bindingLinkPtr);
+            // NOTE: If the server didn't go down, then the Client Connection has been
+            // deleted and its destructor removed it from the Waiting Clients List.
         }
 
-        userLinkPtr = le_dls_PeekNext(&UserList, userLinkPtr);
+        bindingLinkPtr = le_dls_PeekNext(&targetPtr->bindingList, bindingLinkPtr);
     }
 }
 
@@ -1079,8 +1198,11 @@ static void ProcessAdvertisementFromServer
     // connection to the service list.
     else
     {
-        // Add the object to the User's Service List.
+        // Add the object to the User's Service List and the Service Map.
         le_dls_Queue(&connectionPtr->userPtr->serviceList, &connectionPtr->link);
+        connectionPtr->serviceKey.uid = connectionPtr->userPtr->uid;
+        connectionPtr->serviceKey.name = connectionPtr->interface.interfaceName;
+        le_hashmap_Put(ServiceMapRef, &connectionPtr->serviceKey, connectionPtr);
 
         LE_DEBUG("Server (uid %u '%s', pid %d) now serving service '%s' (%s).",
                  connectionPtr->userPtr->uid,
@@ -1641,31 +1763,30 @@ static void ServerConnectionDestructor
 {
     ServerConnection_t* connectionPtr = objPtr;
 
-    // Disassociate the Server Connection object from all Binding objects that refer to it...
+    // Only a connection that is in the Service Map can have bindings pointing at it.
+    // NOTE: If the connection is rejected because of a bad or duplicate advertisement,
+    //       then the connection will not have made it into the Service Map.
+    bool isServing = (   (connectionPtr->interface.interfaceName[0] != '\0')
+                      && (FindService(connectionPtr->userPtr,
+                                      connectionPtr->interface.interfaceName) == connectionPtr) );
 
-    // For each user,
-    le_dls_Link_t* userLinkPtr = le_dls_Peek(&UserList);
-
-    while (userLinkPtr != NULL)
+    if (isServing)
     {
-        User_t* userPtr = CONTAINER_OF(userLinkPtr, User_t, link);
-
-        // For each of the user's bindings,
-        le_dls_Link_t* bindingLinkPtr = le_dls_Peek(&userPtr->bindingList);
-        while (bindingLinkPtr != NULL)
+        // Disassociate the Server Connection object from all Binding objects that refer to it.
+        BindingTarget_t* targetPtr = le_hashmap_Get(BindingTargetMapRef,
+                                                    &connectionPtr->serviceKey);
+        if (targetPtr != NULL)
         {
-            Binding_t* bindingPtr = CONTAINER_OF(bindingLinkPtr, Binding_t, link);
-
-            // If the binding is associated with the deleted server connection,
-            if (connectionPtr == bindingPtr->serverConnectionPtr)
+            le_dls_Link_t* bindingLinkPtr = le_dls_Peek(&targetPtr->bindingList);
+            while (bindingLinkPtr != NULL)
             {
+                Binding_t* bindingPtr = CONTAINER_OF(bindingLinkPtr, Binding_t, targetLink);
+
                 bindingPtr->serverConnectionPtr = NULL;
-            }
 
-            bindingLinkPtr = le_dls_PeekNext(&userPtr->bindingList, bindingLinkPtr);
+                bindingLinkPtr = le_dls_PeekNext(&targetPtr->bindingList, bindingLinkPtr);
+            }
         }
-
-        userLinkPtr = le_dls_PeekNext(&UserList, userLinkPtr);
     }
 
     if (connectionPtr->interface.interfaceName[0] == '\0')
@@ -1684,11 +1805,11 @@ static void ServerConnectionDestructor
                  connectionPtr->interface.interfaceName,
                  connectionPtr->interface.protocolId);
 
-        // Remove the Server Connection from the User's Service List, if it has been added.
-        // NOTE: If the connection is rejected because of a bad or duplicate advertisement,
-        //       then the connection will not have made it into the user's list of services.
-        if (le_dls_IsInList(&connectionPtr->userPtr->serviceList, &connectionPtr->link))
+        // Remove the Server Connection from the User's Service List and the Service Map, if it
+        // has been added.
+        if (isServing)
         {
+            le_hashmap_Remove(ServiceMapRef, &connectionPtr->serviceKey);
             le_dls_Remove(&connectionPtr->userPtr->serviceList, &connectionPtr->link);
         }
     }
@@ -1780,8 +1901,22 @@ static void BindingDestructor
 {
     Binding_t* bindingPtr = objPtr;
 
-    // Remove the Binding object from the User's Binding List.
+    // Remove the Binding object from the User's Binding List and the Binding Map.
     le_dls_Remove(&bindingPtr->clientUserPtr->bindingList, &bindingPtr->link);
+    le_hashmap_Remove(BindingMapRef, &bindingPtr->clientKey);
+
+    // Remove it from its service's Binding Target, and delete the Binding Target if no other
+    // bindings point to the service.
+    BindingTarget_t* targetPtr = bindingPtr->targetPtr;
+
+    le_dls_Remove(&targetPtr->bindingList, &bindingPtr->targetLink);
+    bindingPtr->targetPtr = NULL;
+
+    if (le_dls_IsEmpty(&targetPtr->bindingList))
+    {
+        le_hashmap_Remove(BindingTargetMapRef, &targetPtr->key);
+        le_mem_Release(targetPtr);
+    }
 
     // While the list of waiting clients is not empty, pop one off and process it.
     le_dls_Link_t* linkPtr;
@@ -2566,6 +2701,7 @@ COMPONENT_INIT
     ServerConnectionPoolRef = le_mem_CreatePool("Server Connection", sizeof(ServerConnection_t));
     UserPoolRef = le_mem_CreatePool("User", sizeof(User_t));
     BindingPoolRef = le_mem_CreatePool("Binding", sizeof(Binding_t));
+    BindingTargetPoolRef = le_mem_CreatePool("Binding Target", sizeof(BindingTarget_t));
 
     /// Expand the pools to their expected maximum sizes.
     /// @todo Make this configurable.
@@ -2573,6 +2709,22 @@ COMPONENT_INIT
     le_mem_ExpandPool(ServerConnectionPoolRef, 30);
     le_mem_ExpandPool(UserPoolRef, 30);
     le_mem_ExpandPool(BindingPoolRef, 30);
+    le_mem_ExpandPool(BindingTargetPoolRef, 30);
+
+    // Create the maps used to look things up.  They grow as needed.
+    UserMapRef = le_hashmap_Create("Users", 31, le_hashmap_HashUInt32, le_hashmap_EqualsUInt32);
+    ServiceMapRef = le_hashmap_Create("Services",
+                                      31,
+                                      ComputeInterfaceKeyHash,
+                                      AreInterfaceKeysTheSame);
+    BindingMapRef = le_hashmap_Create("Bindings",
+                                      31,
+                                      ComputeInterfaceKeyHash,
+                                      AreInterfaceKeysTheSame);
+    BindingTargetMapRef = le_hashmap_Create("Binding Targets",
+                                            31,
+                                            ComputeInterfaceKeyHash,
+                                            AreInterfaceKeysTheSame);
 
     // Register destructor functions.
     le_mem_SetDestructor(ClientConnectionPoolRef, ClientConnectionDestructor);
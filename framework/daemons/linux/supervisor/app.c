@@ -30,6 +30,12 @@
  * The working area is not cleaned up by the Supervisor, rather it is left to the installer to
  * clean up.
  *
+ * Finding out which links to create means reading many config nodes and walking the app's lib, bin
+ * and bundled directories.  So the links created the first time a version of an app is started are
+ * recorded in a sandbox manifest under SANDBOX_MANIFEST_DIR, along with the app's install hash.
+ * The next time the app is started with the same install hash, for instance after a fault or a
+ * reboot, the links are created straight from its manifest.
+ *
  * @todo Implement support for dynamic files.
  *
  * The application objects instantiated by this class contains a list of process object containers
@@ -61,6 +67,7 @@
 #include "file.h"
 #include "ima.h"
 #include "kernelModules.h"
+#include "installer.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -170,6 +177,27 @@
 #define CFG_NODE_RESOURCES                               "resources:/"
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Directory that holds the apps' sandbox manifests, one file per app named after the app.
+ *
+ * The first line of a manifest is the app's install hash.  Each of the following lines is a link
+ * to create in the app's working area: a link type, the source path and the destination path,
+ * separated by tabs.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SANDBOX_MANIFEST_DIR                            CURRENT_SYSTEM_PATH "/sandboxManifests"
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sandbox manifest link types.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MANIFEST_FILE_LINK                              'f'
+#define MANIFEST_DIR_LINK                               'd'
+
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -354,6 +382,11 @@ typedef struct app_Ref
     le_sls_List_t   additionalLinks;    // List of additional links that are temporarily added to
                                         // the app.
     le_sls_List_t   reqModuleName;      // List of required kernel module names
+    bool            modulesLoaded;      // true if the kernel modules were loaded ahead of start.
+    bool            moduleLoadFailed;   // true if loading the kernel modules failed.
+    bool            sandboxSetUp;       // true if the sandbox was set up ahead of start.
+    le_result_t     sandboxResult;      // Result of setting up the sandbox ahead of start.
+    FILE*           manifestFilePtr;    // Sandbox manifest being recorded, or NULL.
 }
 App_t;
 
@@ -1774,6 +1807,26 @@ static le_result_t GetAbsDestPath
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Records a link in the sandbox manifest being recorded for an app, if any.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RecordLink
+(
+    app_Ref_t appRef,                   ///< [IN] Application reference.
+    char linkType,                      ///< [IN] MANIFEST_FILE_LINK or MANIFEST_DIR_LINK.
+    const char* srcPtr,                 ///< [IN] Source path.
+    const char* destPtr                 ///< [IN] Destination path.
+)
+{
+    if (appRef->manifestFilePtr != NULL)
+    {
+        fprintf(appRef->manifestFilePtr, "%c\t%s\t%s\n", linkType, srcPtr, destPtr);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Creates all intermediate directories along the path.
@@ -2025,6 +2078,7 @@ static le_result_t CreateFileLink
             LE_ERROR("Couldn't set SMACK label to '*' for %s", srcPtr);
             goto failure;
         }
+        RecordLink(appRef, MANIFEST_FILE_LINK, srcPtr, destPtr);
         return LE_OK;
     }
 
@@ -2032,6 +2086,7 @@ static le_result_t CreateFileLink
     if (DoesLinkExist(appRef, srcStat, destPath))
     {
         LE_INFO("Skipping file link '%s' to '%s': Already exists", srcPtr, destPath);
+        RecordLink(appRef, MANIFEST_FILE_LINK, srcPtr, destPtr);
         return LE_OK;
     }
 
@@ -2103,6 +2158,7 @@ static le_result_t CreateFileLink
 
     LE_INFO("Created file link '%s' to '%s'.", srcPtr, destPath);
 
+    RecordLink(appRef, MANIFEST_FILE_LINK, srcPtr, destPtr);
     return LE_OK;
 
 failure:
@@ -2164,7 +2220,9 @@ static le_result_t RecursivelyCreateLinks
         }
         else
         {
-            ftsPtr = fts_open(pathArrayPtr, FTS_PHYSICAL | FTS_NOSTAT, NULL);
+            // Sandboxes are set up on several threads at once (see app_SetupSandbox()), so fts must
+            // not change the process's working directory.  FTS_LOGICAL implies FTS_NOCHDIR.
+            ftsPtr = fts_open(pathArrayPtr, FTS_PHYSICAL | FTS_NOSTAT | FTS_NOCHDIR, NULL);
         }
     }
     while ( (ftsPtr == NULL) && (errno == EINTR) );
@@ -2638,6 +2696,44 @@ static le_result_t CreateRequiredFileLinks
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a link to one of the app's required directories.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CreateRequiredDirLink
+(
+    app_Ref_t appRef,                   ///< [IN] Application reference.
+    const char* appDirLabelPtr,         ///< [IN] SMACK label to use for created directories.
+    const char* srcPtr,                 ///< [IN] Source path.
+    const char* destPtr                 ///< [IN] Destination path.
+)
+{
+    if (CreateDirLink(appRef, appDirLabelPtr, srcPtr, destPtr) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    // Treat /dev/shm differently.  These are shared memory expected to be shared between
+    // other apps but also other userland processes.  So export the entire directory.
+    if (le_path_IsEquivalent("/dev/shm", srcPtr, "/") ||
+             le_path_IsSubpath("/dev/shm", srcPtr, "/"))
+    {
+        if (smack_SetLabel(srcPtr, "*") != LE_OK)
+        {
+            return LE_FAULT;
+        }
+    }
+
+    RecordLink(appRef, MANIFEST_DIR_LINK, srcPtr, destPtr);
+    return LE_OK;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Create links to the app's required directories, files and devices.
@@ -2681,26 +2777,10 @@ static le_result_t CreateRequiredLinks
                 return LE_FAULT;
             }
 
-            // Treat /dev/shm differently.  These are shared memory expected to be shared between
-            // other apps but also other userland processes.  So export the entire directory.
-            if (le_path_IsEquivalent("/dev/shm", srcPath, "/") ||
-                     le_path_IsSubpath("/dev/shm", srcPath, "/"))
+            if (CreateRequiredDirLink(appRef, appDirLabelPtr, srcPath, destPath) != LE_OK)
             {
-                if ((CreateDirLink(appRef, appDirLabelPtr, srcPath, destPath) != LE_OK) ||
-                    (smack_SetLabel(srcPath, "*") != LE_OK))
-                {
-                    le_cfg_CancelTxn(appCfg);
-                    return LE_FAULT;
-                }
-
-            }
-            else
-            {
-                if (CreateDirLink(appRef, appDirLabelPtr, srcPath, destPath) != LE_OK)
-                {
-                    le_cfg_CancelTxn(appCfg);
-                    return LE_FAULT;
-                }
+                le_cfg_CancelTxn(appCfg);
+                return LE_FAULT;
             }
         }
         while (le_cfg_GoToNextSibling(appCfg) == LE_OK);
@@ -2733,6 +2813,303 @@ static le_result_t CreateRequiredLinks
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the time elapsed since a given time, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetElapsedMs
+(
+    le_clk_Time_t startTime             ///< [IN] Start of the time span.
+)
+{
+    le_clk_Time_t diffTime = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    return (diffTime.sec * 1000.0) + (diffTime.usec / 1000.0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates all the links in the app's working area: default links for sandboxed apps, links to the
+ * app's lib and bin files, to its read only bundled files and to its required files.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t CreateAppAreaLinks
+(
+    app_Ref_t appRef,                   ///< [IN] The application reference.
+    const char* appDirLabelPtr          ///< [IN] SMACK label to use for created directories.
+)
+{
+    if (appRef->sandboxed)
+    {
+        // Create default links.
+        if (CreateDefaultLinks(appRef, appDirLabelPtr) != LE_OK)
+        {
+            return LE_FAULT;
+        }
+    }
+
+    // Create links to the app's lib and bin directories.
+    if (CreateLibBinLinks(appRef, appDirLabelPtr) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    // Create links to bundled files.
+    if (CreateBundledLinks(appRef, appDirLabelPtr) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    // Create links to required files.
+    if (CreateRequiredLinks(appRef, appDirLabelPtr) != LE_OK)
+    {
+        return LE_FAULT;
+    }
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the install hash of an app, which changes whenever the app is updated.
+ *
+ * @return
+ *      true if the app has an install hash and sandbox manifests are enabled.
+ *      false otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool GetInstallHash
+(
+    app_Ref_t appRef,                   ///< [IN] The application reference.
+    char hashBuffer[LIMIT_MD5_STR_BYTES] ///< [OUT] Buffer to hold the install hash.
+)
+{
+#if LE_CONFIG_SUPERV_SANDBOX_MANIFESTS
+    // The app's install directory is a symlink to a directory named after its hash, unless the
+    // app was installed some other way.
+    struct stat installDirStat;
+
+    if (   (lstat(appRef->installDirPath, &installDirStat) != 0)
+        || (!S_ISLNK(installDirStat.st_mode)) )
+    {
+        return false;
+    }
+
+    installer_GetAppHashFromSymlink(appRef->installDirPath, hashBuffer);
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the path of an app's sandbox manifest.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetManifestPath
+(
+    app_Ref_t appRef,                   ///< [IN] The application reference.
+    char* bufPtr,                       ///< [OUT] Buffer to store the path.
+    size_t bufSize                      ///< [IN] Size of the buffer.
+)
+{
+    bufPtr[0] = '\0';
+    LE_FATAL_IF(le_path_Concat("/", bufPtr, bufSize, SANDBOX_MANIFEST_DIR, appRef->name, NULL)
+                    != LE_OK,
+                "Sandbox manifest path for app '%s' is too long.", appRef->name);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates the links in the app's working area listed in its sandbox manifest, if the manifest was
+ * recorded for the app's current install hash.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_NOT_FOUND if there is no manifest for the app's current install hash.
+ *      LE_FAULT if the manifest is corrupted or a link could not be created.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReplaySandboxManifest
+(
+    app_Ref_t appRef,                   ///< [IN] The application reference.
+    const char* appDirLabelPtr,         ///< [IN] SMACK label to use for created directories.
+    const char* hashPtr                 ///< [IN] The app's install hash.
+)
+{
+    char manifestPath[LIMIT_MAX_PATH_BYTES];
+    GetManifestPath(appRef, manifestPath, sizeof(manifestPath));
+
+    FILE* manifestFilePtr = fopen(manifestPath, "r");
+
+    if (manifestFilePtr == NULL)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    le_result_t result = LE_OK;
+    char line[2 * LIMIT_MAX_PATH_BYTES + 4] = "";
+
+    // Check that the manifest was recorded for this version of the app.
+    if (fgets(line, sizeof(line), manifestFilePtr) != NULL)
+    {
+        line[strcspn(line, "\n")] = '\0';
+    }
+
+    if (feof(manifestFilePtr) || ferror(manifestFilePtr) || (strcmp(line, hashPtr) != 0))
+    {
+        result = LE_NOT_FOUND;
+        goto done;
+    }
+
+    while (fgets(line, sizeof(line), manifestFilePtr) != NULL)
+    {
+        size_t lineLen = strlen(line);
+        char* srcPtr = line + 2;
+        char* destPtr = strchr(srcPtr, '\t');
+
+        if (   (lineLen < 6)
+            || (line[lineLen - 1] != '\n')
+            || (line[1] != '\t')
+            || (destPtr == NULL) )
+        {
+            LE_ERROR("Sandbox manifest '%s' is corrupted.", manifestPath);
+            result = LE_FAULT;
+            goto done;
+        }
+
+        line[lineLen - 1] = '\0';
+        *destPtr = '\0';
+        destPtr++;
+
+        if (line[0] == MANIFEST_DIR_LINK)
+        {
+            result = CreateRequiredDirLink(appRef, appDirLabelPtr, srcPtr, destPtr);
+        }
+        else if (line[0] == MANIFEST_FILE_LINK)
+        {
+            result = CreateFileLink(appRef, appDirLabelPtr, srcPtr, destPtr);
+        }
+        else
+        {
+            LE_ERROR("Sandbox manifest '%s' is corrupted.", manifestPath);
+            result = LE_FAULT;
+        }
+
+        if (result != LE_OK)
+        {
+            goto done;
+        }
+    }
+
+    if (ferror(manifestFilePtr))
+    {
+        LE_ERROR("Could not read sandbox manifest '%s'.  %m", manifestPath);
+        result = LE_FAULT;
+    }
+
+done:
+    fclose(manifestFilePtr);
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts recording the sandbox manifest of an app.  The links created until EndSandboxManifest()
+ * is called are recorded in it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartSandboxManifest
+(
+    app_Ref_t appRef,                   ///< [IN] The application reference.
+    const char* hashPtr                 ///< [IN] The app's install hash.
+)
+{
+    char manifestPath[LIMIT_MAX_PATH_BYTES];
+    GetManifestPath(appRef, manifestPath, sizeof(manifestPath));
+
+    // Remove any out of date manifest first, in case the new one can't be recorded.
+    if ((unlink(manifestPath) != 0) && (errno != ENOENT))
+    {
+        LE_WARN("Could not delete sandbox manifest '%s'.  %m", manifestPath);
+    }
+
+    if (le_dir_MakePath(SANDBOX_MANIFEST_DIR, S_IRWXU) != LE_OK)
+    {
+        return;
+    }
+
+    LE_ASSERT(le_utf8_Append(manifestPath, ".new", sizeof(manifestPath), NULL) == LE_OK);
+
+    appRef->manifestFilePtr = fopen(manifestPath, "w");
+
+    if (appRef->manifestFilePtr == NULL)
+    {
+        LE_WARN("Could not create sandbox manifest '%s'.  %m", manifestPath);
+        return;
+    }
+
+    fprintf(appRef->manifestFilePtr, "%s\n", hashPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stops recording the sandbox manifest of an app, and keeps it if all the links were recorded.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EndSandboxManifest
+(
+    app_Ref_t appRef,                   ///< [IN] The application reference.
+    bool isComplete                     ///< [IN] true if all the links were created.
+)
+{
+    if (appRef->manifestFilePtr == NULL)
+    {
+        return;
+    }
+
+    char manifestPath[LIMIT_MAX_PATH_BYTES];
+    char newManifestPath[LIMIT_MAX_PATH_BYTES];
+    GetManifestPath(appRef, manifestPath, sizeof(manifestPath));
+    LE_ASSERT(snprintf(newManifestPath, sizeof(newManifestPath), "%s.new", manifestPath)
+              < sizeof(newManifestPath));
+
+    bool isWritten = !ferror(appRef->manifestFilePtr);
+
+    if (fclose(appRef->manifestFilePtr) != 0)
+    {
+        isWritten = false;
+    }
+    appRef->manifestFilePtr = NULL;
+
+    if (isComplete && isWritten && (rename(newManifestPath, manifestPath) == 0))
+    {
+        return;
+    }
+
+    if (isComplete)
+    {
+        LE_WARN("Could not save sandbox manifest '%s'.", manifestPath);
+    }
+
+    unlink(newManifestPath);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sets up the application execution area in the file system.  For a sandboxed app this will be the
@@ -2773,32 +3150,48 @@ static le_result_t SetupAppArea
             }
         }
 
-        // Create default links.
-        if (CreateDefaultLinks(appRef, appDirLabel) != LE_OK)
-        {
-            return LE_FAULT;
-        }
     }
 
-    // Create links to the app's lib and bin directories.
-    if (CreateLibBinLinks(appRef, appDirLabel) != LE_OK)
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+    char hash[LIMIT_MD5_STR_BYTES] = "";
+    bool hasHash = GetInstallHash(appRef, hash);
+
+    // Create the links from the app's sandbox manifest if it is up to date.
+    if (hasHash)
     {
-        return LE_FAULT;
+        le_result_t result = ReplaySandboxManifest(appRef, appDirLabel, hash);
+
+        if (result == LE_OK)
+        {
+            LE_INFO("Created links for app '%s' from its sandbox manifest in %.1f ms.",
+                    appRef->name, GetElapsedMs(startTime));
+            return LE_OK;
+        }
+
+        if (result == LE_FAULT)
+        {
+            LE_WARN("Could not replay sandbox manifest of app '%s'.  Recording it again.",
+                    appRef->name);
+        }
+
+        StartSandboxManifest(appRef, hash);
     }
 
-    // Create links to bundled files.
-    if (CreateBundledLinks(appRef, appDirLabel) != LE_OK)
+    // Otherwise create them from the app's configuration, and record them.
+    le_result_t result = CreateAppAreaLinks(appRef, appDirLabel);
+
+    if (hasHash)
     {
-        return LE_FAULT;
+        EndSandboxManifest(appRef, (result == LE_OK));
     }
 
-    // Create links to required files.
-    if (CreateRequiredLinks(appRef, appDirLabel) != LE_OK)
+    if (result == LE_OK)
     {
-        return LE_FAULT;
+        LE_INFO("Created links for app '%s' from its configuration in %.1f ms.",
+                appRef->name, GetElapsedMs(startTime));
     }
 
-    return LE_OK;
+    return result;
 }
 
 
@@ -3203,6 +3596,11 @@ app_Ref_t app_Create
     appPtr->additionalLinks = LE_SLS_LIST_INIT;
     appPtr->state = APP_STATE_STOPPED;
     appPtr->killTimer = NULL;
+    appPtr->modulesLoaded = false;
+    appPtr->moduleLoadFailed = false;
+    appPtr->sandboxSetUp = false;
+    appPtr->sandboxResult = LE_OK;
+    appPtr->manifestFilePtr = NULL;
 
     LE_INFO("Creating app '%s'", appPtr->name);
 
@@ -3419,8 +3817,6 @@ le_result_t app_Start
 {
     LE_INFO("Starting app '%s'", appRef->name);
 
-    bool moduleLoadFailed = false;
-
     if (appRef->state == APP_STATE_RUNNING)
     {
         LE_ERROR("Application '%s' is already running.", appRef->name);
@@ -3435,42 +3831,25 @@ le_result_t app_Start
         return LE_FAULT;
     }
 
-    // Install the required kernel modules
-    if (GetKernelModules(appRef) != LE_OK)
+    // Install the required kernel modules, unless that was done ahead of time.
+    if (!appRef->modulesLoaded)
     {
-        LE_ERROR("Error in installing dependent kernel modules for app '%s'", appRef->name);
-        moduleLoadFailed = true;
+        app_LoadKernelModules(appRef);
     }
 
+    bool moduleLoadFailed = appRef->moduleLoadFailed;
+    appRef->modulesLoaded = false;
+
     appRef->state = APP_STATE_RUNNING;
 
-    // Set SMACK rules for this app.
-    // Setup the runtime area in the file system.
-    if ( (SetSmackRules(appRef) != LE_OK) ||
-         (SetupAppArea(appRef) != LE_OK) )
-    {
-        LE_ERROR("Failed to set Smack rules or set up app area.");
-        return LE_FAULT;
-    }
+    // Set up the SMACK rules and the runtime area, unless that was done ahead of time.
+    le_result_t sandboxResult = appRef->sandboxSetUp ? appRef->sandboxResult
+                                                     : app_SetupSandbox(appRef);
+    appRef->sandboxSetUp = false;
 
-    // Create /tmp for sandboxed apps and link in /tmp files.
-    if (appRef->sandboxed)
+    if (sandboxResult != LE_OK)
     {
-        // Get the SMACK label for the folders we create.
-        char appDirLabel[LIMIT_MAX_SMACK_LABEL_BYTES];
-        smack_GetAppAccessLabel(app_GetName(appRef), S_IRWXU, appDirLabel, sizeof(appDirLabel));
-
-        // Create the app's /tmp for sandboxed apps.
-        if (CreateTmpFs(appRef, appDirLabel) != LE_OK)
-        {
-            return LE_FAULT;
-        }
-
-        // Create default links.
-        if (CreateDefaultTmpLinks(appRef, appDirLabel) != LE_OK)
-        {
-            return LE_FAULT;
-        }
+        return LE_FAULT;
     }
 
     // Start all the processes in the application.
@@ -3530,6 +3909,91 @@ le_result_t app_Start
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Loads the kernel modules required by an application ahead of app_Start(), so that its sandbox
+ * can be set up with app_SetupSandbox() before the application is started.
+ *
+ * @note Must be called from the Supervisor's main thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void app_LoadKernelModules
+(
+    app_Ref_t appRef                    ///< [IN] Reference to the application.
+)
+{
+    appRef->moduleLoadFailed = false;
+
+    if (GetKernelModules(appRef) != LE_OK)
+    {
+        LE_ERROR("Error in installing dependent kernel modules for app '%s'", appRef->name);
+        appRef->moduleLoadFailed = true;
+    }
+
+    appRef->modulesLoaded = true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets up an application's SMACK rules and runtime area ahead of app_Start(), so that it can be
+ * done for several applications at once.  The application's kernel modules must have been loaded
+ * with app_LoadKernelModules() first.
+ *
+ * @note Can be called from any thread that is connected to the le_cfg service, as long as no other
+ *       thread uses the same application at the same time.  SetSmackRules(), SetupAppArea() (with
+ *       its sandbox manifest replay and recording), CreateTmpFs() and CreateDefaultTmpLinks() only
+ *       use the application's own state, stack buffers, thread-safe memory pools and reentrant
+ *       calls (getmntent_r(), one open() and write() per SMACK rule), and never change the
+ *       working directory (the link walks use FTS_NOCHDIR).
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.  app_Start() will then fail too.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t app_SetupSandbox
+(
+    app_Ref_t appRef                    ///< [IN] Reference to the application.
+)
+{
+    appRef->sandboxSetUp = true;
+    appRef->sandboxResult = LE_FAULT;
+
+    // Set SMACK rules for this app.
+    // Setup the runtime area in the file system.
+    if ( (SetSmackRules(appRef) != LE_OK) ||
+         (SetupAppArea(appRef) != LE_OK) )
+    {
+        LE_ERROR("Failed to set Smack rules or set up app area.");
+        return LE_FAULT;
+    }
+
+    // Create /tmp for sandboxed apps and link in /tmp files.
+    if (appRef->sandboxed)
+    {
+        // Get the SMACK label for the folders we create.
+        char appDirLabel[LIMIT_MAX_SMACK_LABEL_BYTES];
+        smack_GetAppAccessLabel(app_GetName(appRef), S_IRWXU, appDirLabel, sizeof(appDirLabel));
+
+        // Create the app's /tmp for sandboxed apps.
+        if (CreateTmpFs(appRef, appDirLabel) != LE_OK)
+        {
+            return LE_FAULT;
+        }
+
+        // Create default links.
+        if (CreateDefaultTmpLinks(appRef, appDirLabel) != LE_OK)
+        {
+            return LE_FAULT;
+        }
+    }
+
+    appRef->sandboxResult = LE_OK;
+    return LE_OK;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Stops an application.  This is an asynchronous function call that returns immediately but
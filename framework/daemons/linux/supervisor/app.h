@@ -171,6 +171,40 @@ le_result_t app_Start
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Loads the kernel modules required by an application ahead of app_Start(), so that its sandbox
+ * can be set up with app_SetupSandbox() before the application is started.
+ *
+ * @note Must be called from the Supervisor's main thread.
+ */
+//--------------------------------------------------------------------------------------------------
+void app_LoadKernelModules
+(
+    app_Ref_t appRef                    ///< [IN] Reference to the application.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets up an application's SMACK rules and runtime area ahead of app_Start(), so that it can be
+ * done for several applications at once.  The application's kernel modules must have been loaded
+ * with app_LoadKernelModules() first.
+ *
+ * @note Can be called from any thread that is connected to the le_cfg service, as long as no other
+ *       thread uses the same application at the same time.
+ *
+ * @return
+ *      LE_OK if successful.
+ *      LE_FAULT if there was an error.  app_Start() will then fail too.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t app_SetupSandbox
+(
+    app_Ref_t appRef                    ///< [IN] Reference to the application.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Stops an application.  This is an asynchronous function call that returns immediately but
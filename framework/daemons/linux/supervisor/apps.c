@@ -14,6 +14,13 @@
  * An app can be started by either an le_appCtrl_Start() IPC call or automatically on start-up
  * using the apps_AutoStart() API.
  *
+ * On start-up, the sandboxes of all the apps to start (their SMACK rules and runtime areas in the
+ * file system) are set up at once by a pool of threads.  Once they are all set up, the apps'
+ * processes are started from the main thread, servers before their clients: an app is only started
+ * once all the auto-started apps that its bindings point to have been started, unless the bindings
+ * form a loop.  Processes are not forked while the other threads are running, because a child
+ * could inherit a lock held by one of them.  A timeline of the start-up is logged when it is done.
+ *
  * When an app's container is created, a new app container object is created which contains a
  * list link, an app stop handler reference and the app object (which is also instantiated).  After
  * the app container object is created, it is placed on the list of inactive apps, waiting to be
@@ -250,6 +257,64 @@ static le_mem_PoolRef_t AppProcContainerPool;
 //--------------------------------------------------------------------------------------------------
 static le_ref_MapRef_t AppProcMap;
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * App being started by apps_AutoStart().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t       link;           ///< Link in the list of apps being auto-started.
+    le_dls_Link_t       setupLink;      ///< Link in the queue of sandboxes to set up.
+    AppContainer_t*     containerPtr;   ///< The app container.
+    le_sls_List_t       serverList;     ///< Auto-started apps that this app's bindings point to.
+    bool                isStarted;      ///< true once the app's processes have been started.
+    le_clk_Time_t       setupStartTime; ///< When the app's sandbox started being set up.
+    le_clk_Time_t       setupEndTime;   ///< When the app's sandbox was set up.
+    le_clk_Time_t       startTime;      ///< When the app's processes started being started.
+    le_clk_Time_t       startEndTime;   ///< When the app's processes were started.
+}
+AutoStartApp_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pool for auto-started apps.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t AutoStartAppPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server of an auto-started app: another auto-started app that one of its bindings points to.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_sls_Link_t       link;           ///< Link in the app's list of servers.
+    AutoStartApp_t*     serverPtr;      ///< The server app.
+}
+AutoStartServer_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Memory pool for the servers of auto-started apps.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t AutoStartServerPool;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue of auto-started apps whose sandbox has yet to be set up, shared by the sandbox setup
+ * threads.  Protected by SetupQueueMutex.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t SetupQueue = LE_DLS_LIST_INIT;
+static le_mutex_Ref_t SetupQueueMutex;
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Timeout value for waiting processes to exit for an app.
@@ -1262,6 +1327,346 @@ static void ProcBlockHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the time between two times, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetMs
+(
+    le_clk_Time_t fromTime,             ///< [IN] Start of the time span.
+    le_clk_Time_t toTime                ///< [IN] End of the time span.
+)
+{
+    le_clk_Time_t diffTime = le_clk_Sub(toTime, fromTime);
+
+    return (diffTime.sec * 1000.0) + (diffTime.usec / 1000.0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds an app in a list of auto-started apps.
+ *
+ * @return
+ *      Pointer to the auto-started app, or NULL if the app is not in the list.
+ */
+//--------------------------------------------------------------------------------------------------
+static AutoStartApp_t* FindAutoStartApp
+(
+    le_dls_List_t* appListPtr,          ///< [IN] List of auto-started apps.
+    const char* appNamePtr              ///< [IN] Name of the app.
+)
+{
+    le_dls_Link_t* appLinkPtr = le_dls_Peek(appListPtr);
+
+    while (appLinkPtr != NULL)
+    {
+        AutoStartApp_t* appPtr = CONTAINER_OF(appLinkPtr, AutoStartApp_t, link);
+
+        if (strcmp(app_GetName(appPtr->containerPtr->appRef), appNamePtr) == 0)
+        {
+            return appPtr;
+        }
+
+        appLinkPtr = le_dls_PeekNext(appListPtr, appLinkPtr);
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Builds the list of servers of an auto-started app from its bindings.  Only the other apps that
+ * are being auto-started are counted.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetAutoStartServers
+(
+    le_dls_List_t* appListPtr,          ///< [IN] List of auto-started apps.
+    AutoStartApp_t* appPtr              ///< [IN] App to get the servers of.
+)
+{
+    le_cfg_IteratorRef_t bindCfg = le_cfg_CreateReadTxn(app_GetConfigPath(
+                                                                appPtr->containerPtr->appRef));
+    le_cfg_GoToNode(bindCfg, "bindings");
+
+    if (le_cfg_GoToFirstChild(bindCfg) == LE_OK)
+    {
+        do
+        {
+            char serverName[LIMIT_MAX_APP_NAME_BYTES];
+
+            if (le_cfg_GetString(bindCfg, "app", serverName, sizeof(serverName), "") != LE_OK)
+            {
+                continue;
+            }
+
+            AutoStartApp_t* serverPtr = FindAutoStartApp(appListPtr, serverName);
+
+            if ((serverPtr != NULL) && (serverPtr != appPtr))
+            {
+                AutoStartServer_t* serverNodePtr = le_mem_ForceAlloc(AutoStartServerPool);
+
+                serverNodePtr->link = LE_SLS_LINK_INIT;
+                serverNodePtr->serverPtr = serverPtr;
+                le_sls_Queue(&appPtr->serverList, &serverNodePtr->link);
+            }
+        }
+        while (le_cfg_GoToNextSibling(bindCfg) == LE_OK);
+    }
+
+    le_cfg_CancelTxn(bindCfg);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets up the sandboxes in the setup queue until the queue is empty.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetUpQueuedSandboxes
+(
+    void
+)
+{
+    for (;;)
+    {
+        le_mutex_Lock(SetupQueueMutex);
+        le_dls_Link_t* setupLinkPtr = le_dls_Pop(&SetupQueue);
+        le_mutex_Unlock(SetupQueueMutex);
+
+        if (setupLinkPtr == NULL)
+        {
+            return;
+        }
+
+        AutoStartApp_t* appPtr = CONTAINER_OF(setupLinkPtr, AutoStartApp_t, setupLink);
+
+        appPtr->setupStartTime = le_clk_GetRelativeTime();
+        app_SetupSandbox(appPtr->containerPtr->appRef);
+        appPtr->setupEndTime = le_clk_GetRelativeTime();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main function of the sandbox setup threads.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* SandboxSetupThreadMain
+(
+    void* contextPtr                    ///< [IN] Not used.
+)
+{
+    le_cfg_ConnectService();
+
+    SetUpQueuedSandboxes();
+
+    le_cfg_DisconnectService();
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets up the sandboxes of all the auto-started apps, using up to
+ * LE_CONFIG_SUPERV_APP_START_THREADS threads including the calling (main) thread.  Returns when
+ * they are all set up and the other threads have exited.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetUpSandboxes
+(
+    le_dls_List_t* appListPtr,          ///< [IN] List of auto-started apps.
+    size_t numApps                      ///< [IN] Number of apps in the list.
+)
+{
+    le_thread_Ref_t threads[LE_CONFIG_SUPERV_APP_START_THREADS];
+    size_t numThreads = 0;
+    size_t i;
+
+    // The kernel modules are loaded first, from the main thread, as the sandboxes may need the
+    // device files that they create.
+    le_dls_Link_t* appLinkPtr = le_dls_Peek(appListPtr);
+
+    while (appLinkPtr != NULL)
+    {
+        AutoStartApp_t* appPtr = CONTAINER_OF(appLinkPtr, AutoStartApp_t, link);
+
+        app_LoadKernelModules(appPtr->containerPtr->appRef);
+        le_dls_Queue(&SetupQueue, &appPtr->setupLink);
+
+        appLinkPtr = le_dls_PeekNext(appListPtr, appLinkPtr);
+    }
+
+    while ((numThreads < LE_CONFIG_SUPERV_APP_START_THREADS - 1) && (numThreads < numApps - 1))
+    {
+        char threadName[LIMIT_MAX_THREAD_NAME_BYTES];
+
+        snprintf(threadName, sizeof(threadName), "AppSetup%zu", numThreads);
+
+        threads[numThreads] = le_thread_Create(threadName, SandboxSetupThreadMain, NULL);
+        le_thread_SetJoinable(threads[numThreads]);
+        le_thread_Start(threads[numThreads]);
+
+        numThreads++;
+    }
+
+    SetUpQueuedSandboxes();
+
+    for (i = 0; i < numThreads; i++)
+    {
+        le_thread_Join(threads[i], NULL);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks if all the servers of an auto-started app have been started.
+ *
+ * @return
+ *      true if they have all been started.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool AreServersStarted
+(
+    AutoStartApp_t* appPtr              ///< [IN] Auto-started app.
+)
+{
+    le_sls_Link_t* serverLinkPtr = le_sls_Peek(&appPtr->serverList);
+
+    while (serverLinkPtr != NULL)
+    {
+        AutoStartServer_t* serverNodePtr = CONTAINER_OF(serverLinkPtr, AutoStartServer_t, link);
+
+        if (!serverNodePtr->serverPtr->isStarted)
+        {
+            return false;
+        }
+
+        serverLinkPtr = le_sls_PeekNext(&appPtr->serverList, serverLinkPtr);
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts the processes of an auto-started app whose sandbox has been set up.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartAutoStartApp
+(
+    AutoStartApp_t* appPtr              ///< [IN] Auto-started app.
+)
+{
+    appPtr->startTime = le_clk_GetRelativeTime();
+
+    // No need to check the return code because there is nothing we can do about errors.
+    StartApp(appPtr->containerPtr);
+
+    appPtr->startEndTime = le_clk_GetRelativeTime();
+    appPtr->isStarted = true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts the processes of all the auto-started apps, each app after the apps that its bindings
+ * point to.  Apps whose bindings form a loop are started in the order they are listed in.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartInDependencyOrder
+(
+    le_dls_List_t* appListPtr,          ///< [IN] List of auto-started apps.
+    size_t numApps                      ///< [IN] Number of apps in the list.
+)
+{
+    size_t numStarted = 0;
+
+    while (numStarted < numApps)
+    {
+        AutoStartApp_t* firstWaitingAppPtr = NULL;
+        size_t prevNumStarted = numStarted;
+        le_dls_Link_t* appLinkPtr = le_dls_Peek(appListPtr);
+
+        while (appLinkPtr != NULL)
+        {
+            AutoStartApp_t* appPtr = CONTAINER_OF(appLinkPtr, AutoStartApp_t, link);
+
+            if (!appPtr->isStarted)
+            {
+                if (AreServersStarted(appPtr))
+                {
+                    StartAutoStartApp(appPtr);
+                    numStarted++;
+                }
+                else if (firstWaitingAppPtr == NULL)
+                {
+                    firstWaitingAppPtr = appPtr;
+                }
+            }
+
+            appLinkPtr = le_dls_PeekNext(appListPtr, appLinkPtr);
+        }
+
+        if ((numStarted == prevNumStarted) && (firstWaitingAppPtr != NULL))
+        {
+            LE_WARN("Bindings of app '%s' form a loop.  Starting it before its servers.",
+                    app_GetName(firstWaitingAppPtr->containerPtr->appRef));
+
+            StartAutoStartApp(firstWaitingAppPtr);
+            numStarted++;
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Logs the timeline of the auto-start, and deletes the auto-started app objects.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EndAutoStart
+(
+    le_dls_List_t* appListPtr,          ///< [IN] List of auto-started apps.
+    size_t numApps,                     ///< [IN] Number of apps in the list.
+    le_clk_Time_t beginTime             ///< [IN] When the auto-start began.
+)
+{
+    LE_INFO("Auto-started %zu apps in %.1f ms.",
+            numApps, GetMs(beginTime, le_clk_GetRelativeTime()));
+
+    le_dls_Link_t* appLinkPtr;
+
+    while ((appLinkPtr = le_dls_Pop(appListPtr)) != NULL)
+    {
+        AutoStartApp_t* appPtr = CONTAINER_OF(appLinkPtr, AutoStartApp_t, link);
+
+        LE_INFO("App '%s': sandbox set up at %.1f ms (%.1f ms), started at %.1f ms (%.1f ms).",
+                app_GetName(appPtr->containerPtr->appRef),
+                GetMs(beginTime, appPtr->setupStartTime),
+                GetMs(appPtr->setupStartTime, appPtr->setupEndTime),
+                GetMs(beginTime, appPtr->startTime),
+                GetMs(appPtr->startTime, appPtr->startEndTime));
+
+        le_sls_Link_t* serverLinkPtr;
+
+        while ((serverLinkPtr = le_sls_Pop(&appPtr->serverList)) != NULL)
+        {
+            le_mem_Release(CONTAINER_OF(serverLinkPtr, AutoStartServer_t, link));
+        }
+
+        le_mem_Release(appPtr);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize the applications system.
@@ -1277,6 +1682,10 @@ void apps_Init
     // Create memory pools.
     AppContainerPool = le_mem_CreatePool("appContainers", sizeof(AppContainer_t));
     AppProcContainerPool = le_mem_CreatePool("appProcContainers", sizeof(AppProcContainer_t));
+    AutoStartAppPool = le_mem_CreatePool("autoStartApps", sizeof(AutoStartApp_t));
+    AutoStartServerPool = le_mem_CreatePool("autoStartServers", sizeof(AutoStartServer_t));
+
+    SetupQueueMutex = le_mutex_CreateNonRecursive("appSetupQueue");
 
     AppProcMap = le_ref_CreateMap("AppProcs", 5);
     AppMap = le_ref_CreateMap("App", 5);
@@ -1375,6 +1784,10 @@ void apps_AutoStart
     void
 )
 {
+    le_clk_Time_t beginTime = le_clk_GetRelativeTime();
+    le_dls_List_t appList = LE_DLS_LIST_INIT;
+    size_t numApps = 0;
+
     // Read the list of applications from the config tree.
     le_cfg_IteratorRef_t appCfg = le_cfg_CreateReadTxn(CFG_NODE_APPS_LIST);
 
@@ -1403,15 +1816,58 @@ void apps_AutoStart
             }
             else
             {
-                // Launch the application now.  No need to check the return code because there is
-                // nothing we can do about errors.
-                LaunchApp(appName);
+                // Create the app now, and start it once all the sandboxes are set up.  No need to
+                // check the return code because there is nothing we can do about errors.
+                AppContainer_t* appContainerPtr;
+
+                if (CreateApp(appName, &appContainerPtr) != LE_OK)
+                {
+                    // Error already logged.
+                }
+                else if (appContainerPtr->isActive)
+                {
+                    LE_ERROR("Application '%s' is already running.", appName);
+                }
+                else
+                {
+                    AutoStartApp_t* appPtr = le_mem_ForceAlloc(AutoStartAppPool);
+
+                    appPtr->link = LE_DLS_LINK_INIT;
+                    appPtr->setupLink = LE_DLS_LINK_INIT;
+                    appPtr->containerPtr = appContainerPtr;
+                    appPtr->serverList = LE_SLS_LIST_INIT;
+                    appPtr->isStarted = false;
+
+                    le_dls_Queue(&appList, &appPtr->link);
+                    numApps++;
+                }
             }
         }
     }
     while (le_cfg_GoToNextSibling(appCfg) == LE_OK);
 
     le_cfg_CancelTxn(appCfg);
+
+    if (numApps == 0)
+    {
+        return;
+    }
+
+    // Find out which apps have to be started before which.
+    le_dls_Link_t* appLinkPtr = le_dls_Peek(&appList);
+
+    while (appLinkPtr != NULL)
+    {
+        GetAutoStartServers(&appList, CONTAINER_OF(appLinkPtr, AutoStartApp_t, link));
+
+        appLinkPtr = le_dls_PeekNext(&appList, appLinkPtr);
+    }
+
+    SetUpSandboxes(&appList, numApps);
+
+    StartInDependencyOrder(&appList, numApps);
+
+    EndAutoStart(&appList, numApps, beginTime);
 }
 
 
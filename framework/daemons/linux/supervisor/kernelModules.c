@@ -112,6 +112,16 @@ typedef struct
                                                              // traversing to detect cycle
     bool               recurStack;                           // Track recursion stack while
                                                              // traversing to detect cycle
+    bool               isStartupModule;                      // is loaded at start-up or not
+    bool               isStartupOptional;                    // is optional for every module that
+                                                             // needs it at start-up
+    uint32_t           pendingDepCount;                      // Number of required modules still
+                                                             // to be loaded at start-up
+    le_dls_Link_t      startupLink;                          // link object for start-up list
+    le_dls_Link_t      readyLink;                            // link object for start-up ready list
+    double             loadStartMs;                          // When loading began, in ms after
+                                                             // start-up loading began
+    double             loadMs;                               // Time taken to load, in ms
 }
 KModuleObj_t;
 
@@ -145,6 +155,27 @@ static le_dls_List_t ModuleAlphaOrderList = LE_DLS_LIST_INIT;
 static le_sls_List_t CyclicDependencyList = LE_SLS_LIST_INIT;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * State of the loading of the modules at start-up.  Modules are loaded as soon as all the modules
+ * they require are, by a pool of threads.
+ */
+//--------------------------------------------------------------------------------------------------
+static struct {
+    le_mutex_Ref_t      mutex;             // protects the rest of the start-up load state
+    le_sem_Ref_t        readySem;          // posted for each ready module and to stop the threads
+    le_dls_List_t       moduleList;        // modules to load at start-up (startupLink)
+    le_dls_List_t       readyList;         // modules ready to be loaded (readyLink)
+    size_t              numLeft;           // number of modules not loaded yet
+    size_t              numLoading;        // number of modules being loaded
+    size_t              numLoaded;         // number of modules installed
+    size_t              numThreads;        // number of threads loading modules
+    bool                isFailed;          // true if a module that isn't optional failed to load
+    bool                isDone;            // true when the threads must stop
+    le_clk_Time_t       beginTime;         // when loading began
+} StartupLoad = {NULL, NULL, LE_DLS_LIST_INIT, LE_DLS_LIST_INIT};
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Free list of module parameters starting from argv[2]
@@ -755,6 +786,8 @@ static void ModuleInsert(char *modName)
     m->isCyclicDependency = false;
     m->visited = false;
     m->recurStack = false;
+    m->startupLink = LE_DLS_LINK_INIT;
+    m->readyLink = LE_DLS_LINK_INIT;
 
     ModuleGetLoad(m);            /* Read load from configTree */
     ModuleGetIsOptional(m);      /* Read if the module is optional from configTree */
@@ -848,6 +881,89 @@ static le_result_t TraverseDependencyInsert
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * insmod a kernel module whose required modules are already installed.
+ *
+ * @return
+ *      LE_OK if the module was installed, or failed to install but is optional.
+ *      LE_FAULT if the module failed to install and isn't optional.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t LoadModule(KModuleObj_t *mod)
+{
+    le_result_t result;
+    ModuleLoadStatus_t loadStatusProcMod;
+    char *scriptargv[3];
+
+    /* If install script is provided, execute the script otherwise execute insmod */
+    if (strcmp(mod->installScript, "") != 0)
+    {
+        scriptargv[0] =  mod->installScript;
+        scriptargv[1] =  mod->path;
+        scriptargv[2] =  NULL;
+
+        result = ExecuteCommand(scriptargv, 2);
+        if (result != LE_OK)
+        {
+            LE_CRIT("Install script '%s' execution failed", mod->installScript);
+
+            if (mod->isOptional)
+            {
+                return LE_OK;
+            }
+            return result;
+        }
+
+        /* Read module load status from /proc/modules */
+        loadStatusProcMod =  CheckProcModules(mod->name);
+        if (loadStatusProcMod != STATUS_INSTALLED)
+        {
+            LE_INFO("Module '%s' not in 'Live' state, wait for 10 seconds.", mod->name);
+            sleep(10);
+
+            /* If the module is not in live state, wait for 10 seconds to see if the
+             * module recovers to live state, otherwise restart the system.
+             */
+            if (loadStatusProcMod != STATUS_INSTALLED)
+            {
+                if (mod->isOptional)
+                {
+                    LE_INFO(
+                        "Module '%s' not in 'Live' state and is optional. "
+                        "Skip restarting system.",
+                        mod->name);
+                    return LE_OK;
+                }
+
+                LE_CRIT("Module '%s' not in 'Live' state. Restart system ...", mod->name);
+                return LE_FAULT;
+            }
+        }
+    }
+    else
+    {
+        mod->argv[0] = INSMOD_COMMAND;
+        result = ExecuteCommand(mod->argv, mod->argc);
+        if (result != LE_OK)
+        {
+            if (mod->isOptional)
+            {
+                LE_INFO("Ignoring failure. "
+                         "Module '%s' failed to load and is an optional module.", mod->name);
+                return LE_OK;
+            }
+            return result;
+        }
+    }
+
+    mod->moduleLoadStatus = STATUS_INSTALLED;
+    LE_INFO("New kernel module '%s'", mod->name);
+
+    return LE_OK;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * insmod the kernel module
@@ -860,9 +976,6 @@ static le_result_t InstallEachKernelModule(KModuleObj_t *m, bool enableUseCount)
     /* The ordered list of required kernel modules to install */
     le_dls_List_t ModuleInsertList = LE_DLS_LIST_INIT;
 
-    ModuleLoadStatus_t loadStatusProcMod;
-    char *scriptargv[3];
-
     result = TraverseDependencyInsert(&ModuleInsertList, m, enableUseCount);
     if (result != LE_OK)
     {
@@ -887,69 +1000,11 @@ static le_result_t InstallEachKernelModule(KModuleObj_t *m, bool enableUseCount)
 
         if (mod->moduleLoadStatus != STATUS_INSTALLED)
         {
-            /* If install script is provided, execute the script otherwise execute insmod */
-            if (strcmp(mod->installScript, "") != 0)
-            {
-                scriptargv[0] =  mod->installScript;
-                scriptargv[1] =  mod->path;
-                scriptargv[2] =  NULL;
-
-                result = ExecuteCommand(scriptargv, 2);
-                if (result != LE_OK)
-                {
-                    LE_CRIT("Install script '%s' execution failed", mod->installScript);
-
-                    if (mod->isOptional)
-                    {
-                        continue;
-                    }
-                    return result;
-                }
-
-                /* Read module load status from /proc/modules */
-                loadStatusProcMod =  CheckProcModules(mod->name);
-                if (loadStatusProcMod != STATUS_INSTALLED)
-                {
-                    LE_INFO("Module '%s' not in 'Live' state, wait for 10 seconds.", mod->name);
-                    sleep(10);
-
-                    /* If the module is not in live state, wait for 10 seconds to see if the
-                     * module recovers to live state, otherwise restart the system.
-                     */
-                    if (loadStatusProcMod != STATUS_INSTALLED)
-                    {
-                        if (mod->isOptional)
-                        {
-                            LE_INFO(
-                                "Module '%s' not in 'Live' state and is optional. "
-                                "Skip restarting system.",
-                                mod->name);
-                            continue;
-                        }
-
-                        LE_CRIT("Module '%s' not in 'Live' state. Restart system ...", mod->name);
-                        return LE_FAULT;
-                    }
-                }
-            }
-            else
+            result = LoadModule(mod);
+            if (result != LE_OK)
             {
-                mod->argv[0] = INSMOD_COMMAND;
-                result = ExecuteCommand(mod->argv, mod->argc);
-                if (result != LE_OK)
-                {
-                    if (mod->isOptional)
-                    {
-                        LE_INFO("Ignoring failure. "
-                                 "Module '%s' failed to load and is an optional module.", mod->name);
-                        continue;
-                    }
-                    return result;
-                }
+                return result;
             }
-
-            mod->moduleLoadStatus = STATUS_INSTALLED;
-            LE_INFO("New kernel module '%s'", mod->name);
         }
     }
     return LE_OK;
@@ -1039,6 +1094,299 @@ static void setIsRequiredModule()
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time elapsed since start-up loading began, in milliseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetStartupLoadMs(void)
+{
+    le_clk_Time_t diffTime = le_clk_Sub(le_clk_GetRelativeTime(), StartupLoad.beginTime);
+
+    return (diffTime.sec * 1000.0) + (diffTime.usec / 1000.0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add the modules in a module's dependency list to the modules to load at start-up.
+ *
+ * A module is only treated as optional if it is optional for every module that needs it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddStartupModules(le_dls_List_t *moduleInsertListPtr)
+{
+    le_dls_Link_t *listLink;
+
+    while ((listLink = le_dls_Pop(moduleInsertListPtr)) != NULL)
+    {
+        KModuleObj_t *mod = CONTAINER_OF(listLink, KModuleObj_t, dependencyLink);
+
+        if (mod->isStartupModule)
+        {
+            mod->isStartupOptional = mod->isStartupOptional && mod->isOptional;
+        }
+        else
+        {
+            mod->isStartupModule = true;
+            mod->isStartupOptional = mod->isOptional;
+            le_dls_Queue(&StartupLoad.moduleList, &(mod->startupLink));
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue a start-up module to be loaded by the next free thread.  Must be called with the start-up
+ * load mutex locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static void QueueStartupModule(KModuleObj_t *mod)
+{
+    le_dls_Queue(&StartupLoad.readyList, &(mod->readyLink));
+    le_sem_Post(StartupLoad.readySem);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Record that a start-up module has been loaded (or has failed to load), and queue the modules
+ * that were only waiting for it.  Must be called with the start-up load mutex locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FinishStartupModule(KModuleObj_t *doneModPtr, le_result_t result)
+{
+    le_dls_Link_t *linkPtr;
+    le_sls_Link_t *modNameLinkPtr;
+    size_t i;
+
+    StartupLoad.numLoading--;
+    StartupLoad.numLeft--;
+
+    if (doneModPtr->moduleLoadStatus == STATUS_INSTALLED)
+    {
+        StartupLoad.numLoaded++;
+    }
+
+    if (result != LE_OK)
+    {
+        StartupLoad.isFailed = true;
+    }
+    else
+    {
+        linkPtr = le_dls_Peek(&StartupLoad.moduleList);
+        while (linkPtr != NULL)
+        {
+            KModuleObj_t *mod = CONTAINER_OF(linkPtr, KModuleObj_t, startupLink);
+
+            modNameLinkPtr = le_sls_Peek(&(mod->reqModuleName));
+            while ((modNameLinkPtr != NULL) && (mod->pendingDepCount > 0))
+            {
+                ModNameNode_t *modNameNodePtr = CONTAINER_OF(modNameLinkPtr, ModNameNode_t, link);
+
+                if (strcmp(modNameNodePtr->modName, doneModPtr->name) == 0)
+                {
+                    mod->pendingDepCount--;
+                    if (mod->pendingDepCount == 0)
+                    {
+                        QueueStartupModule(mod);
+                    }
+                }
+
+                modNameLinkPtr = le_sls_PeekNext(&(mod->reqModuleName), modNameLinkPtr);
+            }
+
+            linkPtr = le_dls_PeekNext(&StartupLoad.moduleList, linkPtr);
+        }
+    }
+
+    /* Stop the threads once everything is loaded, or once a failure has drained the loads in
+     * progress. */
+    if ((StartupLoad.numLeft == 0) || (StartupLoad.isFailed && (StartupLoad.numLoading == 0)))
+    {
+        StartupLoad.isDone = true;
+        for (i = 0; i < StartupLoad.numThreads; i++)
+        {
+            le_sem_Post(StartupLoad.readySem);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load start-up modules as they become ready, until there are none left to load.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunStartupLoads(void)
+{
+    le_dls_Link_t *linkPtr;
+    le_result_t result;
+
+    for (;;)
+    {
+        le_sem_Wait(StartupLoad.readySem);
+
+        le_mutex_Lock(StartupLoad.mutex);
+
+        if (StartupLoad.isDone)
+        {
+            le_mutex_Unlock(StartupLoad.mutex);
+            return;
+        }
+
+        /* After a failure, drop the ready modules and just wait for the loads in progress. */
+        linkPtr = le_dls_Pop(&StartupLoad.readyList);
+        if ((linkPtr == NULL) || StartupLoad.isFailed)
+        {
+            le_mutex_Unlock(StartupLoad.mutex);
+            continue;
+        }
+
+        StartupLoad.numLoading++;
+
+        le_mutex_Unlock(StartupLoad.mutex);
+
+        KModuleObj_t *mod = CONTAINER_OF(linkPtr, KModuleObj_t, readyLink);
+
+        mod->loadStartMs = GetStartupLoadMs();
+        result = LoadModule(mod);
+        mod->loadMs = GetStartupLoadMs() - mod->loadStartMs;
+
+        LE_INFO("Kernel module '%s' load took %.1f ms, starting %.1f ms into start-up loading.",
+                mod->name, mod->loadMs, mod->loadStartMs);
+
+        le_mutex_Lock(StartupLoad.mutex);
+        FinishStartupModule(mod, result);
+        le_mutex_Unlock(StartupLoad.mutex);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start-up module loading thread main function.
+ */
+//--------------------------------------------------------------------------------------------------
+static void *StartupLoadThreadMain(void *contextPtr)
+{
+    RunStartupLoads();
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Load the start-up modules, each as soon as all of the modules it requires are loaded, using up
+ * to LE_CONFIG_SUPERV_KMODULE_LOAD_THREADS threads (including the calling thread).
+ *
+ * @return
+ *      LE_OK if all the modules were loaded, or failed to load but are optional.
+ *      LE_FAULT if a module that isn't optional failed to load.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t LoadStartupModules(void)
+{
+    le_thread_Ref_t threads[LE_CONFIG_SUPERV_KMODULE_LOAD_THREADS];
+    le_dls_Link_t *linkPtr;
+    le_sls_Link_t *modNameLinkPtr;
+    double totalLoadMs = 0;
+    size_t numToLoad = 0;
+    size_t i;
+
+    StartupLoad.mutex = le_mutex_CreateNonRecursive("KModuleStartupLoad");
+    StartupLoad.readySem = le_sem_Create("KModuleStartupReady", 0);
+    StartupLoad.numLoading = 0;
+    StartupLoad.numLoaded = 0;
+    StartupLoad.isFailed = false;
+    StartupLoad.isDone = false;
+    StartupLoad.beginTime = le_clk_GetRelativeTime();
+
+    /* Count the required modules each module is waiting for, and queue the ones that are ready. */
+    linkPtr = le_dls_Peek(&StartupLoad.moduleList);
+    while (linkPtr != NULL)
+    {
+        KModuleObj_t *mod = CONTAINER_OF(linkPtr, KModuleObj_t, startupLink);
+
+        if (mod->moduleLoadStatus != STATUS_INSTALLED)
+        {
+            mod->isOptional = mod->isStartupOptional;
+            mod->pendingDepCount = 0;
+
+            modNameLinkPtr = le_sls_Peek(&(mod->reqModuleName));
+            while (modNameLinkPtr != NULL)
+            {
+                ModNameNode_t *modNameNodePtr = CONTAINER_OF(modNameLinkPtr, ModNameNode_t, link);
+                KModuleObj_t *reqModPtr = le_hashmap_Get(KModuleHandler.moduleTable,
+                                                         modNameNodePtr->modName);
+
+                if ((reqModPtr != NULL) && (reqModPtr->moduleLoadStatus != STATUS_INSTALLED))
+                {
+                    mod->pendingDepCount++;
+                }
+
+                modNameLinkPtr = le_sls_PeekNext(&(mod->reqModuleName), modNameLinkPtr);
+            }
+
+            if (mod->pendingDepCount == 0)
+            {
+                QueueStartupModule(mod);
+            }
+
+            numToLoad++;
+        }
+
+        linkPtr = le_dls_PeekNext(&StartupLoad.moduleList, linkPtr);
+    }
+
+    StartupLoad.numLeft = numToLoad;
+    StartupLoad.numThreads = LE_CONFIG_SUPERV_KMODULE_LOAD_THREADS;
+    if (StartupLoad.numThreads > numToLoad)
+    {
+        StartupLoad.numThreads = numToLoad;
+    }
+
+    if (numToLoad > 0)
+    {
+        /* The calling thread is one of the loading threads. */
+        for (i = 1; i < StartupLoad.numThreads; i++)
+        {
+            threads[i] = le_thread_Create("KModuleLoad", StartupLoadThreadMain, NULL);
+            le_thread_SetJoinable(threads[i]);
+            le_thread_Start(threads[i]);
+        }
+
+        RunStartupLoads();
+
+        for (i = 1; i < StartupLoad.numThreads; i++)
+        {
+            le_thread_Join(threads[i], NULL);
+        }
+    }
+
+    linkPtr = le_dls_Peek(&StartupLoad.moduleList);
+    while (linkPtr != NULL)
+    {
+        KModuleObj_t *mod = CONTAINER_OF(linkPtr, KModuleObj_t, startupLink);
+
+        totalLoadMs += mod->loadMs;
+
+        linkPtr = le_dls_PeekNext(&StartupLoad.moduleList, linkPtr);
+    }
+
+    LE_INFO("Loaded %zu of %zu kernel modules in %.1f ms using %zu threads (%.1f ms of loading).",
+            StartupLoad.numLoaded, numToLoad, GetStartupLoadMs(), StartupLoad.numThreads,
+            totalLoadMs);
+
+    le_sem_Delete(StartupLoad.readySem);
+    le_mutex_Delete(StartupLoad.mutex);
+
+    return (StartupLoad.isFailed ? LE_FAULT : LE_OK);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Iterate through the module table and install kernel module
@@ -1049,6 +1397,7 @@ static void installModules()
     KModuleObj_t *modPtr;
     le_result_t result;
     le_dls_Link_t* linkPtr;
+    le_dls_List_t moduleInsertList;
 
     /* Traverse linked list in alphabetical order of module name and traverse dependencies. */
     linkPtr = le_dls_Peek(&ModuleAlphaOrderList);
@@ -1068,16 +1417,41 @@ static void installModules()
             continue;
         }
 
-        result = InstallEachKernelModule(modPtr, true);
+        moduleInsertList = LE_DLS_LIST_INIT;
+        result = TraverseDependencyInsert(&moduleInsertList, modPtr, true);
         if (result != LE_OK)
         {
+            while (le_dls_Pop(&moduleInsertList) != NULL)
+            {
+            }
+
+            /* If the module is marked optional, ignore fault, otherwise take fault action. */
+            if (modPtr->isOptional)
+            {
+                LE_WARN("Traversing module '%s' dependencies failed, ignore as module is optional",
+                        modPtr->name);
+                linkPtr = le_dls_PeekNext(&ModuleAlphaOrderList, linkPtr);
+                continue;
+            }
+
+            LE_ERROR("Traversing module '%s' dependencies failed, fault action will be taken",
+                     modPtr->name);
             LE_ERROR("Error in installing module %s. Restarting system ...", modPtr->name);
             framework_Reboot();
-            break;
+            return;
         }
 
+        AddStartupModules(&moduleInsertList);
+
         linkPtr = le_dls_PeekNext(&ModuleAlphaOrderList, linkPtr);
     }
+
+    /* Independent modules are loaded in parallel, each one after the modules it requires. */
+    if (LoadStartupModules() != LE_OK)
+    {
+        LE_ERROR("Error in installing kernel modules. Restarting system ...");
+        framework_Reboot();
+    }
 }
 
 
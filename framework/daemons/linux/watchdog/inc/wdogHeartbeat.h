@@ -0,0 +1,106 @@
+/**
+ * @file wdogHeartbeat.h
+ *
+ * Shared memory heartbeats for the watchdog service.
+ *
+ * A process gets its heartbeat from le_wdog_GetHeartbeat() and maps it with wdogHeartbeat_Map().
+ * From then on wdogHeartbeat_Kick() kicks the process' watchdog by updating the heartbeat, and
+ * the watchdog daemon picks the kicks up when it scans the heartbeats, instead of receiving a
+ * message for every kick.
+ *
+ * If the watchdog daemon stops watching the process (for instance because one of the process'
+ * sessions to it closed), wdogHeartbeat_Kick() returns false.  The process must then unmap the
+ * heartbeat with wdogHeartbeat_Unmap() and go back to le_wdog_Kick(), which gets the process
+ * watched again.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LEGATO_WDOG_HEARTBEAT_INCLUDE_GUARD
+#define LEGATO_WDOG_HEARTBEAT_INCLUDE_GUARD
+
+#include <sys/mman.h>
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Heartbeat shared between a process and the watchdog daemon.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t count;         ///< Incremented by the process on every kick.
+    uint32_t isWatched;     ///< Non-zero while the watchdog daemon watches the heartbeat.
+    uint64_t kickTimeUs;    ///< Relative time of the last kick, in microseconds.
+}
+wdogHeartbeat_Slot_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Map a heartbeat.
+ *
+ * @return The heartbeat, or NULL if it could not be mapped.
+ *
+ * @note Closes the fd.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline wdogHeartbeat_Slot_t* wdogHeartbeat_Map
+(
+    int fd                  ///< [IN] Shared memory fd from le_wdog_GetHeartbeat().
+)
+{
+    void* mapPtr = mmap(NULL, sizeof(wdogHeartbeat_Slot_t), PROT_READ | PROT_WRITE, MAP_SHARED,
+                        fd, 0);
+
+    close(fd);
+
+    return (mapPtr == MAP_FAILED) ? NULL : mapPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unmap a heartbeat.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void wdogHeartbeat_Unmap
+(
+    wdogHeartbeat_Slot_t* slotPtr   ///< [IN] Heartbeat to unmap.
+)
+{
+    munmap(slotPtr, sizeof(wdogHeartbeat_Slot_t));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Kick the watchdog through a heartbeat.
+ *
+ * @return true if the kick was recorded, false if the watchdog daemon no longer watches the
+ *         heartbeat.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool wdogHeartbeat_Kick
+(
+    wdogHeartbeat_Slot_t* slotPtr   ///< [IN] Heartbeat of the process.
+)
+{
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+
+    if (!__atomic_load_n(&slotPtr->isWatched, __ATOMIC_ACQUIRE))
+    {
+        return false;
+    }
+
+    // The count is published after the time, so whoever sees the new count sees the new time.
+    __atomic_store_n(&slotPtr->kickTimeUs,
+                     ((uint64_t)now.sec * 1000000) + now.usec,
+                     __ATOMIC_RELAXED);
+    __atomic_add_fetch(&slotPtr->count, 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+
+#endif // LEGATO_WDOG_HEARTBEAT_INCLUDE_GUARD
@@ -87,6 +87,14 @@
  * LE_WDOG_TIMEOUT_NOW could be used in development to see how the app responds to a timeout
  * situation though it could also be abused as a way to restart the app for some reason.
  *
+ * A process can also get a shared memory heartbeat with le_wdog_GetHeartbeat() and kick it with
+ * wdogHeartbeat_Kick(), which just updates a count and kick time in the heartbeat.  No message
+ * is sent and the process' timer is not restarted.  Instead, one periodic timer scans all the
+ * heartbeats and starts the timers of the processes that kicked while their timer was stopped,
+ * and when a running timer expires it checks the process' heartbeat first: if the process kicked
+ * since the timer was started, the timer is started again to expire one timeout after the last
+ * kick.  Kick() and Timeout() messages take precedence over heartbeat kicks that came before them.
+ *
  * If a watchdog was set to never time out and the process that created it ends without changing the
  * timeout value, either by le_wdog_Kick() or le_wdog_Timeout() then the wdog will not be freed. To
  * prevent a pileup of dead dogs the system periodically searches for watchdogs whose processes have
@@ -108,6 +116,7 @@
 #include "user.h"
 #include "fileDescriptor.h"
 #include "pa_wdog.h"
+#include "wdogHeartbeat.h"
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -240,6 +249,11 @@ typedef struct
                                         ///< beyond it's maximum period by being treated as a
                                         ///< non-mandatory watchdog.
     le_timer_Ref_t timer;               ///< The timer this watchdog uses
+    wdogHeartbeat_Slot_t* heartbeatPtr; ///< The process' shared memory heartbeat, or NULL
+    uint32_t heartbeatCount;            ///< Heartbeat count when last seen
+    le_clk_Time_t heartbeatTime;        ///< Time of the last heartbeat kick seen
+    bool isHeartbeatKicked;             ///< Heartbeat kicked since the timer was last started
+    le_dls_Link_t heartbeatLink;        ///< Link in the list of watchdogs with a heartbeat
 }
 WatchdogObj_t;
 
@@ -287,6 +301,37 @@ static le_hashmap_Ref_t MandatoryWatchdogRefs;  ///< The container used to track
 
 static le_timer_Ref_t DefaultExternalWdogTimer; ///< Default external wdog timer
 
+static le_dls_List_t HeartbeatList = LE_DLS_LIST_INIT; ///< Watchdogs with a heartbeat
+static le_timer_Ref_t HeartbeatScanTimer;       ///< Timer for scanning the heartbeats
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Stop watching a watchdog's heartbeat, if it has one.  The process sees that its heartbeat is no
+ * longer watched on its next kick, and goes back to kicking through messages.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DetachHeartbeat
+(
+    WatchdogObj_t* dogPtr   ///< The watchdog
+)
+{
+    if (dogPtr->heartbeatPtr == NULL)
+    {
+        return;
+    }
+
+    __atomic_store_n(&dogPtr->heartbeatPtr->isWatched, 0, __ATOMIC_RELEASE);
+    wdogHeartbeat_Unmap(dogPtr->heartbeatPtr);
+    dogPtr->heartbeatPtr = NULL;
+    dogPtr->isHeartbeatKicked = false;
+
+    le_dls_Remove(&HeartbeatList, &(dogPtr->heartbeatLink));
+    if (le_dls_IsEmpty(&HeartbeatList))
+    {
+        le_timer_Stop(HeartbeatScanTimer);
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Remove the watchdog from our container, free the timer it contains and then free the storage
@@ -303,6 +348,7 @@ static void DeleteWatchdog
     {
         // All good. The dog was in the hash
         LE_DEBUG("Cleaning up watchdog resources for %d", deadDogPtr->procId);
+        DetachHeartbeat(deadDogPtr);
         // Give the watchdog one more kick if it hasn't had one, then release it.
         // This allows mandatory watchdogs (which still exist in the MandatoryWatchdogRefs
         // one more kick to restart before they're considered expired.
@@ -464,6 +510,123 @@ static le_result_t GetAppNameFromPid
     return le_utf8_Copy(appName, (token + 1), appNameNumElements, NULL);
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Construct le_clk_Time_t object that will give an interval of the provided number
+ *  of milliseconds.
+ *
+ *      @return the constructed le_clk_Time_t
+ */
+//--------------------------------------------------------------------------------------------------
+static le_clk_Time_t MakeTimerInterval
+(
+    uint64_t milliseconds
+)
+{
+    le_clk_Time_t interval;
+
+    interval.sec = milliseconds / 1000;
+    interval.usec = (milliseconds - (interval.sec * 1000)) * 1000;
+
+    return interval;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check a watchdog's heartbeat for kicks that haven't been seen yet.
+ *
+ * @return true if the process kicked its heartbeat since it was last checked.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CheckHeartbeat
+(
+    WatchdogObj_t* dogPtr   ///< The watchdog, which must have a heartbeat
+)
+{
+    uint32_t count = __atomic_load_n(&dogPtr->heartbeatPtr->count, __ATOMIC_ACQUIRE);
+
+    if (count == dogPtr->heartbeatCount)
+    {
+        return false;
+    }
+
+    uint64_t kickTimeUs = __atomic_load_n(&dogPtr->heartbeatPtr->kickTimeUs, __ATOMIC_RELAXED);
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+    le_clk_Time_t kickTime = { .sec = kickTimeUs / 1000000, .usec = kickTimeUs % 1000000 };
+
+    // Don't let a process kick into the future.
+    if (le_clk_GreaterThan(kickTime, now))
+    {
+        kickTime = now;
+    }
+
+    dogPtr->heartbeatCount = count;
+    dogPtr->heartbeatTime = kickTime;
+    dogPtr->isHeartbeatKicked = true;
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a watchdog's timer with its kick timeout, counted from the last heartbeat kick.  Does
+ * nothing if the watchdog never times out.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartHeartbeatTimer
+(
+    WatchdogObj_t* dogPtr   ///< The watchdog, which must have a heartbeat
+)
+{
+    le_clk_Time_t expiryTime = le_clk_Add(dogPtr->heartbeatTime, dogPtr->kickTimeoutInterval);
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+    le_clk_Time_t interval = { 0, 0 };
+
+    dogPtr->isHeartbeatKicked = false;
+
+    if (le_clk_Equal(dogPtr->kickTimeoutInterval, MakeTimerInterval(LE_WDOG_TIMEOUT_NEVER)))
+    {
+        return;
+    }
+
+    if (le_clk_GreaterThan(expiryTime, now))
+    {
+        interval = le_clk_Sub(expiryTime, now);
+    }
+
+    le_timer_Stop(dogPtr->timer);
+    LE_ASSERT(LE_OK == le_timer_SetInterval(dogPtr->timer, interval));
+    le_timer_Start(dogPtr->timer);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Scan all the heartbeats, and start the timers of the processes that kicked while their timer
+ * was stopped.  Running timers are left alone; they check the heartbeat when they expire.
+ */
+//--------------------------------------------------------------------------------------------------
+static void HeartbeatScanHandler
+(
+    le_timer_Ref_t timerRef ///< [IN] The heartbeat scan timer
+)
+{
+    le_dls_Link_t* linkPtr = le_dls_Peek(&HeartbeatList);
+
+    while (linkPtr != NULL)
+    {
+        WatchdogObj_t* dogPtr = CONTAINER_OF(linkPtr, WatchdogObj_t, heartbeatLink);
+
+        CheckHeartbeat(dogPtr);
+
+        if (dogPtr->isHeartbeatKicked && !le_timer_IsRunning(dogPtr->timer))
+        {
+            StartHeartbeatTimer(dogPtr);
+        }
+
+        linkPtr = le_dls_PeekNext(&HeartbeatList, linkPtr);
+    }
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * The handler for all time outs. No registered application wants to see us get here.
@@ -479,6 +642,19 @@ static void WatchdogHandleExpiry
 )
 {
     WatchdogObj_t* watchDogPtr = le_timer_GetContextPtr(timerRef);
+
+    // If the process kicked its heartbeat since the timer started, it hasn't timed out yet.
+    if (watchDogPtr->heartbeatPtr != NULL)
+    {
+        CheckHeartbeat(watchDogPtr);
+
+        if (watchDogPtr->isHeartbeatKicked)
+        {
+            StartHeartbeatTimer(watchDogPtr);
+            return;
+        }
+    }
+
     if (watchDogPtr->procId == NO_PROC)
     {
         // Mandatory watchdog expired without the process restarting.  Restart Legato.
@@ -525,27 +701,6 @@ static void WatchdogHandleExpiry
     }
 }
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Construct le_clk_Time_t object that will give an interval of the provided number
- *  of milliseconds.
- *
- *      @return the constructed le_clk_Time_t
- */
-//--------------------------------------------------------------------------------------------------
-static le_clk_Time_t MakeTimerInterval
-(
-    uint64_t milliseconds
-)
-{
-    le_clk_Time_t interval;
-
-    interval.sec = milliseconds / 1000;
-    interval.usec = (milliseconds - (interval.sec * 1000)) * 1000;
-
-    return interval;
-}
-
 //--------------------------------------------------------------------------------------------------
 /**
  * Check a regular watchdog is running.
@@ -825,6 +980,9 @@ static void InitNewWatchdog
     newDogPtr->procId = clientPid;
     newDogPtr->kickTimeoutInterval = kickTimeoutInterval;
     newDogPtr->maxKickTimeoutInterval = maxKickTimeoutInterval;
+    newDogPtr->heartbeatPtr = NULL;
+    newDogPtr->isHeartbeatKicked = false;
+    newDogPtr->heartbeatLink = LE_DLS_LINK_INIT;
 
     if (le_clk_GreaterThan(newDogPtr->kickTimeoutInterval, newDogPtr->maxKickTimeoutInterval))
     {
@@ -979,6 +1137,8 @@ static void CleanupWdog
 {
     WatchdogObj_t* deadDogPtr = objectPtr;
 
+    DetachHeartbeat(deadDogPtr);
+
     // If this watchdog has a timer, delete it.
     if (deadDogPtr->timer)
     {
@@ -1037,6 +1197,13 @@ static void ResetClientWatchdog
     WatchdogObj_t* watchDogPtr = GetClientWatchdogPtr();
     if (watchDogPtr != NULL)
     {
+        // This kick supersedes the heartbeat kicks the process made before sending it.
+        if (watchDogPtr->heartbeatPtr != NULL)
+        {
+            CheckHeartbeat(watchDogPtr);
+            watchDogPtr->isHeartbeatKicked = false;
+        }
+
         le_timer_Stop(watchDogPtr->timer);
         if (timeout == TIMEOUT_KICK)
         {
@@ -1208,6 +1375,97 @@ le_result_t le_wdog_GetMaxWatchdogTimeout
     return LE_NOT_FOUND;
 }
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a shared memory heartbeat for this process.
+ *
+ * @return
+ *      - LE_OK            The heartbeat is returned
+ *      - LE_DUPLICATE     The process already has a heartbeat
+ *      - LE_UNSUPPORTED   The watchdog service does not support heartbeats
+ *      - LE_NOT_FOUND     The process could not be identified
+ *      - LE_FAULT         The heartbeat could not be created
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_wdog_GetHeartbeat
+(
+    int* heartbeatFdPtr
+        ///< [OUT] Shared memory holding the process' heartbeat
+)
+{
+    if (heartbeatFdPtr == NULL)
+    {
+        LE_KILL_CLIENT("heartbeatFdPtr is NULL.");
+        return LE_FAULT;
+    }
+
+    *heartbeatFdPtr = -1;
+
+#if LE_CONFIG_WDOG_HEARTBEAT
+    WatchdogObj_t* watchDogPtr = GetClientWatchdogPtr();
+    if (watchDogPtr == NULL)
+    {
+        return LE_NOT_FOUND;
+    }
+
+    if (watchDogPtr->heartbeatPtr != NULL)
+    {
+        return LE_DUPLICATE;
+    }
+
+    int fd = memfd_create("wdogHeartbeat", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0)
+    {
+        LE_ERROR("memfd_create() failed for process %d heartbeat. %m", watchDogPtr->procId);
+        return LE_FAULT;
+    }
+
+    // Seal the size, so that the process can't make our accesses fault by truncating it.
+    if ((ftruncate(fd, sizeof(wdogHeartbeat_Slot_t)) != 0)
+        || (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0))
+    {
+        LE_ERROR("Failed to size process %d heartbeat. %m", watchDogPtr->procId);
+        fd_Close(fd);
+        return LE_FAULT;
+    }
+
+    // Keep our own fd open for the client, the mapping doesn't need it.
+    int clientFd = dup(fd);
+    wdogHeartbeat_Slot_t* heartbeatPtr = wdogHeartbeat_Map(fd);
+    if ((heartbeatPtr == NULL) || (clientFd < 0))
+    {
+        LE_ERROR("Failed to map process %d heartbeat. %m", watchDogPtr->procId);
+        if (heartbeatPtr != NULL)
+        {
+            wdogHeartbeat_Unmap(heartbeatPtr);
+        }
+        if (clientFd >= 0)
+        {
+            fd_Close(clientFd);
+        }
+        return LE_FAULT;
+    }
+
+    heartbeatPtr->isWatched = 1;
+    watchDogPtr->heartbeatPtr = heartbeatPtr;
+    watchDogPtr->heartbeatCount = 0;
+    watchDogPtr->isHeartbeatKicked = false;
+
+    if (le_dls_IsEmpty(&HeartbeatList))
+    {
+        le_timer_Start(HeartbeatScanTimer);
+    }
+    le_dls_Queue(&HeartbeatList, &(watchDogPtr->heartbeatLink));
+
+    LE_DEBUG("Process %d kicks through a heartbeat", watchDogPtr->procId);
+
+    *heartbeatFdPtr = clientFd;
+    return LE_OK;
+#else
+    return LE_UNSUPPORTED;
+#endif
+}
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Signal to the supervisor that we are set up and ready
@@ -1528,5 +1786,12 @@ COMPONENT_INIT
     le_timer_Start(DefaultExternalWdogTimer);
     pa_wdog_Init();
 
+    // The heartbeat scan timer runs while any process has a heartbeat.
+    HeartbeatScanTimer = le_timer_Create("HeartbeatScanTimer");
+    le_timer_SetMsInterval(HeartbeatScanTimer, LE_CONFIG_WDOG_HEARTBEAT_SCAN_MS);
+    le_timer_SetHandler(HeartbeatScanTimer, HeartbeatScanHandler);
+    le_timer_SetRepeat(HeartbeatScanTimer, 0);
+    le_timer_SetWakeup(HeartbeatScanTimer, false);
+
     LE_INFO("The watchdog service is ready");
 }
@@ -175,6 +175,36 @@
  * }
  * @endcode
  *
+ * @section c_event_urgentFunctions Urgent Functions and the Report Budget
+ *
+ * Functions queued using @c le_event_QueueFunctionUrgent() or
+ * @c le_event_QueueFunctionToThreadUrgent() go onto a separate Urgent Queue, which the Event Loop
+ * empties before it takes anything from the normal Event Queue.  In threads that have a report
+ * budget (see below), file descriptor handlers (see @ref c_fdMonitor) are dispatched the same way,
+ * so that a backlog of queued functions or event reports doesn't hold them up.  Use this
+ * sparingly: urgent functions that keep queueing more urgent functions will hold up everything
+ * else.
+ *
+ * Each time its thread wakes up, the Event Loop processes the queued functions and event reports
+ * that were queued at that time, up to the thread's <b> report budget </b>, before it checks for
+ * file descriptor events again.  The default budget is set by the @c EVENT_REPORT_BUDGET build
+ * configuration option (0 meaning no limit), and a thread can change its own budget by calling
+ * @c le_event_SetReportBudget().  A smaller budget reduces the latency of file descriptor events
+ * and timers under a heavy load, at the cost of more system calls.
+ *
+ * @code
+ * static void* WorkerThreadMain
+ * (
+ *     void* contextPtr
+ * )
+ * {
+ *     // Don't let bursts of queued work delay the sockets monitored by this thread.
+ *     le_event_SetReportBudget(64);
+ *
+ *     le_event_RunLoop();
+ * }
+ * @endcode
+ *
  * @section c_event_publishSubscribe Publish-Subscribe Events
  *
  * In the publish-subscribe pattern, someone publishes information and if anyone cares about
@@ -809,6 +839,53 @@ void le_event_QueueFunctionToThread
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue a function onto the calling thread's Urgent Queue.  It will be called by the calling
+ * thread's Event Loop before anything that is on the thread's normal Event Queue.
+ *
+ * See @ref c_event_urgentFunctions.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_event_QueueFunctionUrgent
+(
+    le_event_DeferredFunc_t func,       ///< [in] Function to be called later.
+    void*                   param1Ptr,  ///< [in] Value to be passed to the function when called.
+    void*                   param2Ptr   ///< [in] Value to be passed to the function when called.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue a function onto a specific thread's Urgent Queue.  It will be called by that thread's
+ * Event Loop before anything that is on the thread's normal Event Queue.
+ *
+ * See @ref c_event_urgentFunctions.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_event_QueueFunctionToThreadUrgent
+(
+    le_thread_Ref_t         thread,     ///< [in] Thread to queue the function to.
+    le_event_DeferredFunc_t func,       ///< [in] The function.
+    void*                   param1Ptr,  ///< [in] Value to be passed to the function when called.
+    void*                   param2Ptr   ///< [in] Value to be passed to the function when called.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the maximum number of queued functions and event reports that the calling thread's Event
+ * Loop processes each time it wakes up, before it checks for file descriptor events again.
+ *
+ * See @ref c_event_urgentFunctions.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_event_SetReportBudget
+(
+    size_t maxReports   ///< [in] Maximum number of reports per wake-up, or 0 for no maximum.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Runs the event loop for the calling thread.
@@ -15,13 +15,28 @@
  * type of key that you intend to store. It's unwise to mix types in a single table because
  * implementation of the table has no way to detect this behaviour.
  *
- * Choose the initial size should carefully as the index size remains fixed. The best
- * choice for the initial size is a prime number slightly larger than the
- * maximum expected capacity. If a too small size is chosen, there will be an
- * increase in collisions that degrade performance over time.
+ * The capacity passed at creation should be the number of key-value pairs the map is
+ * expected to hold most of the time.  The map grows automatically when it holds more than
+ * that, and shrinks back (never below its initial size) when most of its key-value pairs
+ * have been removed.  Resizing is incremental: the key-value pairs are moved to the new
+ * index a few at a time by later calls to @c le_hashmap_Put() and @c le_hashmap_Remove(),
+ * so no single call stalls the caller, even for a large map.
+ *
+ * The load of every map in a process, and how many times it has been resized, can be
+ * checked with the @c inspect @c hashmaps command.
  *
  * All hashmaps have names for diagnostic purposes.
  *
+ * @subsection c_hashmap_compact Compact hashmaps
+ *
+ * Use @c le_hashmap_CreateCompact() instead of @c le_hashmap_Create() to create a map that uses
+ * open addressing.  A compact map keeps its keys, values and hashes in contiguous arrays instead
+ * of allocating a separate entry for each key-value pair, and grows automatically as key-value
+ * pairs are added.  This makes it faster and smaller than a chained map for large or
+ * heavily-used tables.
+ *
+ * Compact maps are used through the same functions as chained maps.
+ *
  * @section c_hashmap_insert Adding key-value pairs
  *
  * Key-value pairs are added using le_hashmap_Put(). For example:
@@ -101,8 +116,8 @@
  *
  * Alternatively, the calling function can control the iteration by first
  * calling @c le_hashmap_GetIterator(). This returns an iterator that is ready
- * to return each key/value pair in the map in the order in which they are
- * stored. The iterator is controlled by calling @c le_hashmap_NextNode(), and must
+ * to return each key/value pair in the map in the order in which they were
+ * first added. The iterator is controlled by calling @c le_hashmap_NextNode(), and must
  * be called before accessing any elements. You can then retrieve pointers to
  * the key and value by using le_hashmap_GetKey() and le_hashmap_GetValue().
  *
@@ -110,9 +125,8 @@
  * will simply re-initialize the current iterator
  *
  * It is possible to add and remove items during this style of iteration.  When
- * adding items during an iteration it is not guaranteed that the newly added item
- * will be iterated over.  It's very possible that the newly added item is added in
- * an earlier location than the iterator is curently pointed at.
+ * adding items during an iteration, the newly added items are visited after the
+ * ones that were already in the map, even if the map is resized.
  *
  * When removing items during an iteration you also have to keep in mind that the
  * iterator's current item may be the one removed.  If this is the case,
@@ -241,7 +255,7 @@ typedef bool (*le_hashmap_ForEachHandler_t)
  * Create a HashMap.
  *
  * If you create a hashmap with a smaller capacity than you actually use, then
- * the map will continue to work, but performance will degrade the more you put in the map.
+ * the map grows as needed, which costs a little extra time while it is being resized.
  *
  * @return  Returns a reference to the map.
  *
@@ -256,6 +270,24 @@ le_hashmap_Ref_t le_hashmap_Create
     le_hashmap_EqualsFunc_t    equalsFunc        ///< [in] Equality function
 );
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a compact HashMap.  A compact map uses open addressing and grows automatically, so the
+ * capacity is only the number of key-value pairs it can hold before it first has to grow.
+ *
+ * @return  Returns a reference to the map.
+ *
+ * @note Terminates the process on failure, so no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_hashmap_Ref_t le_hashmap_CreateCompact
+(
+    const char*                nameStr,          ///< [in] Name of the HashMap
+    size_t                     capacity,         ///< [in] Initial capacity of the hashmap
+    le_hashmap_HashFunc_t      hashFunc,         ///< [in] Hash function
+    le_hashmap_EqualsFunc_t    equalsFunc        ///< [in] Equality function
+);
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Add a key-value pair to a HashMap. If the key already exists in the map, the previous value
@@ -412,8 +444,8 @@ le_hashmap_It_Ref_t le_hashmap_GetIterator
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Moves the iterator to the next key/value pair in the map. Order is dependent
- * on the hash algorithm and the order of inserts, and is not sorted at all.
+ * Moves the iterator to the next key/value pair in the map. Key/value pairs are
+ * visited in the order in which they were first added to the map.
  *
  * @return  Returns LE_OK unless you go past the end of the map, then returns LE_NOT_FOUND.
  *
@@ -426,8 +458,8 @@ le_result_t le_hashmap_NextNode
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Moves the iterator to the previous key/value pair in the map. Order is dependent
- * on the hash algorithm and the order of inserts, and is not sorted at all.
+ * Moves the iterator to the previous key/value pair in the map. Key/value pairs are
+ * visited in the reverse of the order in which they were first added to the map.
  *
  * @return  Returns LE_OK unless you go past the beginning of the map, then returns LE_NOT_FOUND.
  *
@@ -36,6 +36,16 @@
  *
  * @warning Be sure to stop parsing before closing the file descriptor.
  *
+ * If the file descriptor refers to a regular file, the parser reads it in chunks and seeks back
+ * over anything it read past the end of the document.  Other file descriptors (pipes, sockets,
+ * etc.) are read one byte at a time.  Either way, anything that follows the document can still
+ * be read from the file descriptor after parsing stops.
+ *
+ * A document that is already in memory can be parsed using le_json_ParseBuffer() instead.
+ * It parses the whole document before returning, calling the event and error handlers the same
+ * way as le_json_Parse() would, and cleans up after itself.  Handlers can still stop the parsing
+ * early by calling le_json_Cleanup() (see le_json_GetSession()).
+ *
  *  @section c_json_events Event Handling
  *
  * As parsing progresses and the parser finds things inside the JSON document, the parser calls
@@ -222,6 +232,29 @@ le_json_ParsingSessionRef_t le_json_Parse
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a JSON document held in a memory buffer.
+ *
+ * The whole document is parsed before this function returns, so all the event and error handler
+ * calls for it happen inside this function.  If the buffer ends before the document does, the
+ * error handler is called with LE_JSON_READ_ERROR.  Anything in the buffer after the end of the
+ * document is ignored.
+ *
+ * Handlers can call le_json_Cleanup() to stop parsing early.  The session is cleaned up
+ * automatically when this function returns, whether le_json_Cleanup() was called or not.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_json_ParseBuffer
+(
+    const char* bufferPtr,  ///< Buffer holding the JSON document.
+    size_t bufferSize,      ///< Number of bytes in the buffer.
+    le_json_EventHandler_t  eventHandler,   ///< Function to call when normal parsing events happen.
+    le_json_ErrorHandler_t  errorHandler,   ///< Function to call when errors happen.
+    void* opaquePtr   ///< Opaque pointer to be fetched by handlers using le_json_GetOpaquePtr().
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Stops parsing and cleans up memory allocated by the parser.
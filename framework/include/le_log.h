@@ -236,6 +236,12 @@ $ log stoptrace foo myProc/myComp
  *
  * With all of the above examples "*" can be used in place of the process name or a component
  * name (or both) to mean "all processes" and/or "all components".
+ *
+ * To make all processes called "myProc" write their log messages from a background thread, so
+ * that logging doesn't block their other threads:
+ * @verbatim
+$ log flush ASYNC myProc
+@endverbatim
  *
  * @subsection c_log_control_config Log Control Configuration Settings
  *
@@ -278,6 +284,27 @@ $ export LE_LOG_LEVEL=DEBUG
  * For example,
  * @verbatim
 $ export LE_LOG_TRACE=framework/fdMonitor:framework/logControl
+@endverbatim
+ *
+ * @subsubsection c_log_control_env_flush LE_LOG_FLUSH
+ *
+ * @c LE_LOG_FLUSH can be used to set the default log flush policy of the process.  Valid values
+ * are:
+ *
+ * - @c SYNC - log messages are written to the log by the thread that logs them (default).
+ * - @c ASYNC - log messages are put on a ring buffer and written to the log by a background
+ *   thread.  Messages logged while the ring buffer is full are dropped, and the number dropped is
+ *   logged.  Critical and emergency messages are always written by the thread that logs them.
+ * - @c DEFERRED - like @c ASYNC, but the format string and the raw arguments of each message are
+ *   put on the ring buffer, and the background thread formats the message.  This takes most of
+ *   the cost of logging off the thread that logs, which helps with high-rate LE_TRACE() calls.
+ *   Strings passed for @c %s are copied, but the format string itself must stay valid (a string
+ *   literal).  Messages whose format can't be deferred (e.g., positional arguments like @c %1$d)
+ *   are formatted right away, as with @c ASYNC.
+ *
+ * For example,
+ * @verbatim
+$ export LE_LOG_FLUSH=ASYNC
 @endverbatim
  *
  * @subsection c_log_control_functions Programmatic Log Control
@@ -278,6 +278,11 @@
  * counts, etc. can all be done from multiple threads (excluding signal handlers) without having
  * to worry about corrupting the memory pools' hidden internal data structures.
  *
+ * If many threads allocate from the same pools, enabling the @ref MEM_THREAD_CACHE KConfig option
+ * lets each thread keep a few free blocks of each pool it uses, which reduces contention between
+ * the threads.  Cached blocks are still counted as free in the pool statistics, and are given back
+ * to any thread that needs them when the pool runs out of free blocks.
+ *
  * There's no magical way to prevent different threads from interferring with each other
  * if they both access the @a contents of the same object at the same time.
  *
@@ -679,6 +679,13 @@
  * From this, they obtain a protocol reference that they provide to sessions when they create
  * them.
  *
+ * By default, the whole payload buffer is sent.  If a message uses less than that, the sender
+ * can call le_msg_SetPayloadSize() before sending it, and only that many bytes go through the
+ * socket.  The receiver can get the number of bytes it received using le_msg_GetPayloadSize();
+ * the rest of its payload buffer is cleared.  A received message keeps the size it was
+ * received with, so set the size again before responding if the response could be longer than
+ * the request.
+ *
  * @section c_messagingSecurity Security
  *
  * Security is provided in the form of authentication and access control.
@@ -1332,6 +1339,34 @@ size_t le_msg_GetMaxPayloadSize
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the number of bytes of the message payload to send, starting from the beginning of the
+ * payload buffer.  By default, the whole payload buffer is sent.
+ *
+ * @note A size larger than the payload buffer is a fatal error.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_SetPayloadSize
+(
+    le_msg_MessageRef_t msgRef,     ///< [in] Reference to the message.
+    size_t              payloadSize ///< [in] Number of bytes to send.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the number of bytes of the message payload that were received, or that will be sent.
+ *
+ * @return The size, in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t le_msg_GetPayloadSize
+(
+    le_msg_MessageRef_t msgRef      ///< [in] Reference to the message.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sets the file descriptor to be sent with this message.
@@ -16,6 +16,19 @@
  *   - Packing arrays of the above types
  *   - Packing strings.
  * It also supports unpacking any of the above.
+ *
+ * Simple values (integers, chars, doubles, le_result_t and le_onoff_t) are packed as they are
+ * in memory.  So arrays of them, and structures made only of them, can be packed and unpacked
+ * with a single copy using LE_PACK_PACKSIMPLEARRAY(), LE_PACK_UNPACKSIMPLEARRAY(),
+ * le_pack_PackBlock() and le_pack_UnpackBlock().
+ *
+ * Strings and arrays always take their maximum size off the available size, so a buffer that
+ * holds the largest message of a protocol never runs out of space part way through a message.
+ *
+ * There is also a compact wire format, used by code that ifgen generates with --compact-wire.  It
+ * packs integers wider than 8 bits as varints, and strings and arrays only take the space they
+ * use.  Its functions and macros have "Compact" in their names; see le_pack_PackVarUint() for the
+ * details of the encoding.
  */
 
 #ifndef LE_PACK_H_INCLUDE_GUARD
@@ -375,29 +388,16 @@ static inline bool le_pack_PackString
         return false;
     }
 
-#if defined(__KLOCWORK__)
-    // Just like strncpy & strnlen, this function doesn't know the size of the source string,
-    // which can potentially result in a read overflow on the input buffer.
-    // Static code analyzer can report this issue, which is deliberatly ignored since this
-    // function expects NULL-terminated strings.
-    maxStringCount = strnlen(stringPtr, maxStringCount);
-#endif
-
-    // First copy in the string -- up to maxStringCount bytes, allowing enough
-    // space at the begining for a uint32.
-    for (bytesCopied = 0;
-         (bytesCopied < maxStringCount) && (stringPtr[bytesCopied] != '\0');
-         ++bytesCopied)
-    {
-        (*bufferPtr)[bytesCopied + sizeof(uint32_t)] = stringPtr[bytesCopied];
-    }
-
     // String was too long to fit in the buffer -- return false.
+    bytesCopied = strnlen(stringPtr, maxStringCount);
     if (stringPtr[bytesCopied] != '\0')
     {
         return false;
     }
 
+    // First copy in the string, allowing enough space at the begining for a uint32.
+    memcpy(*bufferPtr + sizeof(uint32_t), stringPtr, bytesCopied);
+
     // Then go back and copy string size.  No loss of precision packing into a uint32
     // because maxStringCount is a uint32 or less.
     bool packResult = le_pack_PackUint32(bufferPtr, sizePtr, bytesCopied);
@@ -476,6 +476,37 @@ static inline bool le_pack_PackArrayHeader
         }                                                               \
     } while (0)
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack an array of simple values into a buffer with a single copy, incrementing the buffer pointer
+ * and decrementing the available size.  The array is packed the same way LE_PACK_PACKARRAY() would
+ * pack it with the value type's pack function.
+ *
+ * @note Only use this for arrays of types that are packed as they are in memory: integers, chars,
+ * doubles, le_result_t and le_onoff_t.  In particular, bools, sizes and references are not.
+ *
+ * @note Always decrements available size according to the max possible size used, not actual size
+ * used.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_PACK_PACKSIMPLEARRAY(bufferPtr,                              \
+                                sizePtr,                                \
+                                arrayPtr,                               \
+                                arrayCount,                             \
+                                arrayMaxCount,                          \
+                                resultPtr)                              \
+    do {                                                                \
+        *(resultPtr) = le_pack_PackArrayHeader((bufferPtr), (sizePtr), \
+                                               (arrayPtr), sizeof((arrayPtr)[0]), \
+                                               (arrayCount), (arrayMaxCount)); \
+        if (*(resultPtr))                                               \
+        {                                                               \
+            memcpy(*(bufferPtr), (arrayPtr), sizeof((arrayPtr)[0])*(arrayCount)); \
+            *(bufferPtr) += sizeof((arrayPtr)[0])*(arrayCount);         \
+            *(sizePtr) -= sizeof((arrayPtr)[0])*(arrayMaxCount);        \
+        }                                                               \
+    } while (0)
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Pack an array of struct into a buffer, incrementing the buffer pointer and decrementing the
@@ -510,6 +541,36 @@ static inline bool le_pack_PackArrayHeader
         }                                                               \
     } while (0)
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack a block of memory into a buffer as is, incrementing the buffer pointer and decrementing the
+ * available size.
+ *
+ * This is used to pack structures made only of simple values in a single copy, when the compiler
+ * hasn't added any padding between their members.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_PackBlock
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    const void* blockPtr,
+    size_t blockSize
+)
+{
+    if (*sizePtr < blockSize)
+    {
+        return false;
+    }
+
+    memcpy(*bufferPtr, blockPtr, blockSize);
+
+    *bufferPtr = *bufferPtr + blockSize;
+    *sizePtr -= blockSize;
+
+    return true;
+}
+
 //--------------------------------------------------------------------------------------------------
 // Unpack functions
 //--------------------------------------------------------------------------------------------------
@@ -990,6 +1051,42 @@ static inline bool le_pack_UnpackArrayHeader
     } while (0)
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack an array of simple values from a buffer with a single copy, incrementing the buffer
+ * pointer and decrementing the available size.  This is the counterpart of
+ * LE_PACK_PACKSIMPLEARRAY(), with the same restrictions on the value type.
+ *
+ * @note Always decrements available size according to the max possible size used, not actual size
+ * used.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_PACK_UNPACKSIMPLEARRAY(bufferPtr,                            \
+                                  sizePtr,                              \
+                                  arrayPtr,                             \
+                                  arrayCountPtr,                        \
+                                  arrayMaxCount,                        \
+                                  resultPtr)                            \
+    do {                                                                \
+        if (!le_pack_UnpackArrayHeader((bufferPtr), (sizePtr),           \
+                                       (arrayPtr), sizeof((arrayPtr)[0]), \
+                                       (arrayCountPtr), (arrayMaxCount))) \
+        {                                                               \
+            *(resultPtr) = false;                                       \
+        }                                                               \
+        else                                                            \
+        {                                                               \
+            if (*(arrayCountPtr) > 0)                                   \
+            {                                                           \
+                memcpy((arrayPtr), *(bufferPtr), sizeof((arrayPtr)[0])*(*(arrayCountPtr))); \
+            }                                                           \
+            *(bufferPtr) += sizeof((arrayPtr)[0])*(*(arrayCountPtr));   \
+            *(sizePtr) -= sizeof((arrayPtr)[0])*(arrayMaxCount);        \
+            *(resultPtr) = true;                                        \
+        }                                                               \
+    } while (0)
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Unpack an array of struct from buffer. Since its logic is the same as that for unpacking an
@@ -1006,4 +1103,893 @@ static inline bool le_pack_UnpackArrayHeader
     LE_PACK_UNPACKARRAY((bufferPtr), (sizePtr), (arrayPtr), (arrayCountPtr), \
                         (arrayMaxCount), (unpackFunc), (resultPtr))
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack a block of memory from a buffer as is, incrementing the buffer pointer and decrementing
+ * the available size.  This is the counterpart of le_pack_PackBlock().
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_UnpackBlock
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    void* blockPtr,
+    size_t blockSize
+)
+{
+    if (*sizePtr < blockSize)
+    {
+        return false;
+    }
+
+    memcpy(blockPtr, *bufferPtr, blockSize);
+
+    *bufferPtr = *bufferPtr + blockSize;
+    *sizePtr -= blockSize;
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+// Compact wire format
+//
+// Both sides of a protocol must use the same wire format.  ifgen adds ",compact" to the
+// protocol ID of interfaces generated with --compact-wire, so a compact client can't be bound to
+// a server using the default wire format, or the other way around.
+//--------------------------------------------------------------------------------------------------
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Largest number of bytes a varint can take in the compact wire format.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_PACK_VARINT_MAX_BYTES    10
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack an unsigned integer into a buffer as a varint, incrementing the buffer pointer and
+ * decrementing the available size by the number of bytes used.
+ *
+ * In the compact wire format, integers wider than 8 bits are packed as varints: 7 bits per byte,
+ * least significant first, with the top bit set on every byte but the last.  Signed integers are
+ * zigzag encoded first (see le_pack_PackVarInt()) so that small negative values stay short.
+ * Strings and arrays are packed as a varint count followed by their contents, and only take the
+ * bytes they use off the available size.  8-bit values, bools and doubles are packed the same way
+ * as in the default wire format.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_PackVarUint
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    uint64_t value
+)
+{
+    uint8_t* ptr = *bufferPtr;
+    uint8_t* endPtr = *bufferPtr + *sizePtr;
+
+    while (value >= 0x80)
+    {
+        if (ptr == endPtr)
+        {
+            return false;
+        }
+        *ptr++ = (uint8_t)value | 0x80;
+        value >>= 7;
+    }
+
+    if (ptr == endPtr)
+    {
+        return false;
+    }
+    *ptr++ = (uint8_t)value;
+
+    *sizePtr -= ptr - *bufferPtr;
+    *bufferPtr = ptr;
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack a signed integer into a buffer as a zigzag encoded varint, incrementing the buffer pointer
+ * and decrementing the available size by the number of bytes used.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_PackVarInt
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    int64_t value
+)
+{
+    return le_pack_PackVarUint(bufferPtr, sizePtr,
+                               ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack a uint16_t into a buffer in the compact wire format.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_PackCompactUint16
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    uint16_t value
+)
+{
+    return le_pack_PackVarUint(bufferPtr, sizePtr, value);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack a uint32_t into a buffer in the compact wire format.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_PackCompactUint32
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    uint32_t value
+)
+{
+    return le_pack_PackVarUint(bufferPtr, sizePtr, value);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack a uint64_t into a buffer in the compact wire format.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_PackCompactUint64
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    uint64_t value
+)
+{
+    return le_pack_PackVarUint(bufferPtr, sizePtr, value);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack an int16_t into a buffer in the compact wire format.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_PackCompactInt16
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    int16_t value
+)
+{
+    return le_pack_PackVarInt(bufferPtr, sizePtr, value);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack an int32_t into a buffer in the compact wire format.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_PackCompactInt32
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    int32_t value
+)
+{
+    return le_pack_PackVarInt(bufferPtr, sizePtr, value);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack an int64_t into a buffer in the compact wire format.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_PackCompactInt64
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    int64_t value
+)
+{
+    return le_pack_PackVarInt(bufferPtr, sizePtr, value);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack a size_t into a buffer in the compact wire format.
+ *
+ * @note Packed sizes are limited to 2^32-1, regardless of platform
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_PackCompactSize
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    size_t value
+)
+{
+    if (value > UINT32_MAX)
+    {
+        return false;
+    }
+
+    return le_pack_PackVarUint(bufferPtr, sizePtr, value);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack a le_result_t into a buffer in the compact wire format.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_PackCompactResult
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    le_result_t value
+)
+{
+    return le_pack_PackVarInt(bufferPtr, sizePtr, value);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack a le_onoff_t into a buffer in the compact wire format.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_PackCompactOnOff
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    le_onoff_t value
+)
+{
+    return le_pack_PackVarUint(bufferPtr, sizePtr, (uint32_t)value);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack a reference into a buffer in the compact wire format.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_PackCompactReference
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    const void* ref
+)
+{
+    size_t refAsInt = (size_t)ref;
+
+    // Same checks as le_pack_PackReference().
+    if ((refAsInt <= UINT32_MAX) &&
+        ((refAsInt & 0x01) ||
+         !refAsInt))
+    {
+        return le_pack_PackVarUint(bufferPtr, sizePtr, refAsInt);
+    }
+    else
+    {
+        return false;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack a string into a buffer in the compact wire format, incrementing the buffer pointer and
+ * decrementing the available size by the number of bytes used.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_PackCompactString
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    const char *stringPtr,
+    uint32_t maxStringCount
+)
+{
+    uint8_t* startPtr = *bufferPtr;
+    size_t startSize = *sizePtr;
+    size_t length;
+
+    if (!stringPtr)
+    {
+        return false;
+    }
+
+    // String was too long -- return false.
+    length = strnlen(stringPtr, maxStringCount);
+    if (stringPtr[length] != '\0')
+    {
+        return false;
+    }
+
+    if (!le_pack_PackVarUint(bufferPtr, sizePtr, length) || (*sizePtr < length))
+    {
+        *bufferPtr = startPtr;
+        *sizePtr = startSize;
+        return false;
+    }
+
+    memcpy(*bufferPtr, stringPtr, length);
+    *bufferPtr = *bufferPtr + length;
+    *sizePtr -= length;
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack the count of an array into a buffer in the compact wire format.
+ *
+ * @note Users of this API should generally use the LE_PACK_PACKCOMPACTARRAY macro instead which
+ * also packs the array data.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_PackCompactArrayHeader
+(
+    uint8_t **bufferPtr,
+    size_t *sizePtr,
+    size_t arrayCount,
+    size_t arrayMaxCount
+)
+{
+    if (arrayCount > arrayMaxCount)
+    {
+        return false;
+    }
+
+    return le_pack_PackCompactSize(bufferPtr, sizePtr, arrayCount);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack an array into a buffer in the compact wire format.  Each element is packed with packFunc,
+ * which should be one of the compact pack functions for types that have one.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_PACK_PACKCOMPACTARRAY(bufferPtr,                             \
+                                 sizePtr,                               \
+                                 arrayPtr,                              \
+                                 arrayCount,                            \
+                                 arrayMaxCount,                         \
+                                 packFunc,                              \
+                                 resultPtr)                             \
+    do {                                                                \
+        *(resultPtr) = le_pack_PackCompactArrayHeader((bufferPtr), (sizePtr), \
+                                                      (arrayCount), (arrayMaxCount)); \
+        if (*(resultPtr))                                               \
+        {                                                               \
+            uint32_t i;                                                 \
+            for (i = 0; (i < (arrayCount)) && *(resultPtr); ++i)        \
+            {                                                           \
+                *(resultPtr) = packFunc((bufferPtr), (sizePtr), (arrayPtr)[i]); \
+            }                                                           \
+        }                                                               \
+    } while (0)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack an array of struct into a buffer in the compact wire format.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_PACK_PACKCOMPACTSTRUCTARRAY(bufferPtr,                       \
+                                       sizePtr,                         \
+                                       arrayPtr,                        \
+                                       arrayCount,                      \
+                                       arrayMaxCount,                   \
+                                       packFunc,                        \
+                                       resultPtr)                       \
+    do {                                                                \
+        *(resultPtr) = le_pack_PackCompactArrayHeader((bufferPtr), (sizePtr), \
+                                                      (arrayCount), (arrayMaxCount)); \
+        if (*(resultPtr))                                               \
+        {                                                               \
+            uint32_t i;                                                 \
+            for (i = 0; (i < (arrayCount)) && *(resultPtr); ++i)        \
+            {                                                           \
+                *(resultPtr) = packFunc((bufferPtr), (sizePtr), &((arrayPtr)[i])); \
+            }                                                           \
+        }                                                               \
+    } while (0)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack an array of values that are packed as they are in memory in the compact wire format
+ * (8-bit integers, chars and doubles) with a single copy.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_PACK_PACKCOMPACTSIMPLEARRAY(bufferPtr,                       \
+                                       sizePtr,                         \
+                                       arrayPtr,                        \
+                                       arrayCount,                      \
+                                       arrayMaxCount,                   \
+                                       resultPtr)                       \
+    do {                                                                \
+        uint8_t* startBufferPtr = *(bufferPtr);                         \
+        size_t startSize = *(sizePtr);                                  \
+        *(resultPtr) = le_pack_PackCompactArrayHeader((bufferPtr), (sizePtr), \
+                                                      (arrayCount), (arrayMaxCount)); \
+        if (*(resultPtr) && (*(sizePtr) < sizeof((arrayPtr)[0])*(arrayCount))) \
+        {                                                               \
+            *(bufferPtr) = startBufferPtr;                              \
+            *(sizePtr) = startSize;                                     \
+            *(resultPtr) = false;                                       \
+        }                                                               \
+        else if (*(resultPtr))                                          \
+        {                                                               \
+            if ((arrayCount) > 0)                                       \
+            {                                                           \
+                memcpy(*(bufferPtr), (arrayPtr), sizeof((arrayPtr)[0])*(arrayCount)); \
+            }                                                           \
+            *(bufferPtr) += sizeof((arrayPtr)[0])*(arrayCount);         \
+            *(sizePtr) -= sizeof((arrayPtr)[0])*(arrayCount);           \
+        }                                                               \
+    } while (0)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack a varint from a buffer, incrementing the buffer pointer and decrementing the available
+ * size by the number of bytes used.
+ *
+ * @return false if the buffer ends before the varint does, or if its value is above maxValue.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_UnpackVarUint
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    uint64_t maxValue,
+    uint64_t* valuePtr
+)
+{
+    uint64_t value = 0;
+    size_t i;
+
+    for (i = 0; (i < *sizePtr) && (i < LE_PACK_VARINT_MAX_BYTES); i++)
+    {
+        uint8_t byte = (*bufferPtr)[i];
+
+        value |= (uint64_t)(byte & 0x7f) << (7 * i);
+
+        if (!(byte & 0x80))
+        {
+            // The last byte of a 64-bit value only holds its top bit.
+            if (((i == LE_PACK_VARINT_MAX_BYTES - 1) && (byte > 1)) || (value > maxValue))
+            {
+                return false;
+            }
+
+            *valuePtr = value;
+            *bufferPtr = *bufferPtr + i + 1;
+            *sizePtr -= i + 1;
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack a zigzag encoded varint from a buffer, incrementing the buffer pointer and decrementing
+ * the available size by the number of bytes used.
+ *
+ * @return false if the buffer ends before the varint does, or if its value doesn't fit in
+ * valueBits bits.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_UnpackVarInt
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    unsigned int valueBits,
+    int64_t* valuePtr
+)
+{
+    uint64_t value;
+
+    if (!le_pack_UnpackVarUint(bufferPtr, sizePtr,
+                               (valueBits >= 64) ? UINT64_MAX : ((uint64_t)1 << valueBits) - 1,
+                               &value))
+    {
+        return false;
+    }
+
+    *valuePtr = (int64_t)((value >> 1) ^ (~(value & 1) + 1));
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack a uint16_t from a buffer in the compact wire format.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_UnpackCompactUint16
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    uint16_t* valuePtr
+)
+{
+    uint64_t value;
+
+    if (!le_pack_UnpackVarUint(bufferPtr, sizePtr, UINT16_MAX, &value))
+    {
+        return false;
+    }
+
+    *valuePtr = (uint16_t)value;
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack a uint32_t from a buffer in the compact wire format.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_UnpackCompactUint32
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    uint32_t* valuePtr
+)
+{
+    uint64_t value;
+
+    if (!le_pack_UnpackVarUint(bufferPtr, sizePtr, UINT32_MAX, &value))
+    {
+        return false;
+    }
+
+    *valuePtr = (uint32_t)value;
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack a uint64_t from a buffer in the compact wire format.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_UnpackCompactUint64
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    uint64_t* valuePtr
+)
+{
+    return le_pack_UnpackVarUint(bufferPtr, sizePtr, UINT64_MAX, valuePtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack an int16_t from a buffer in the compact wire format.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_UnpackCompactInt16
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    int16_t* valuePtr
+)
+{
+    int64_t value;
+
+    if (!le_pack_UnpackVarInt(bufferPtr, sizePtr, 16, &value))
+    {
+        return false;
+    }
+
+    *valuePtr = (int16_t)value;
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack an int32_t from a buffer in the compact wire format.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_UnpackCompactInt32
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    int32_t* valuePtr
+)
+{
+    int64_t value;
+
+    if (!le_pack_UnpackVarInt(bufferPtr, sizePtr, 32, &value))
+    {
+        return false;
+    }
+
+    *valuePtr = (int32_t)value;
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack an int64_t from a buffer in the compact wire format.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_UnpackCompactInt64
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    int64_t* valuePtr
+)
+{
+    return le_pack_UnpackVarInt(bufferPtr, sizePtr, 64, valuePtr);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack a size_t from a buffer in the compact wire format.
+ *
+ * @note Packed sizes are limited to 2^32-1, regardless of platform
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_UnpackCompactSize
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    size_t* valuePtr
+)
+{
+    uint64_t value;
+
+    if (!le_pack_UnpackVarUint(bufferPtr, sizePtr, UINT32_MAX, &value))
+    {
+        return false;
+    }
+
+    *valuePtr = (size_t)value;
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack a le_result_t from a buffer in the compact wire format.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_UnpackCompactResult
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    le_result_t* valuePtr
+)
+{
+    int64_t value;
+
+    if (!le_pack_UnpackVarInt(bufferPtr, sizePtr, 32, &value))
+    {
+        return false;
+    }
+
+    *valuePtr = (le_result_t)value;
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack a le_onoff_t from a buffer in the compact wire format.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_UnpackCompactOnOff
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    le_onoff_t* valuePtr
+)
+{
+    uint64_t value;
+
+    if (!le_pack_UnpackVarUint(bufferPtr, sizePtr, UINT32_MAX, &value))
+    {
+        return false;
+    }
+
+    *valuePtr = (le_onoff_t)value;
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack a reference from a buffer in the compact wire format.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_UnpackCompactReference
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    void* refPtr                ///< Pointer to the reference.  Declared as void * to allow implicit
+                                ///< conversion from pointer to reference types.
+)
+{
+    uint8_t* startPtr = *bufferPtr;
+    size_t startSize = *sizePtr;
+    uint64_t refAsInt;
+
+    if (!le_pack_UnpackVarUint(bufferPtr, sizePtr, UINT32_MAX, &refAsInt))
+    {
+        return false;
+    }
+
+    // Same checks as le_pack_UnpackReference().
+    if ((refAsInt & 0x01) ||
+        (!refAsInt))
+    {
+        // Double cast to avoid warnings.
+        *(void **)refPtr = (void *)(size_t)refAsInt;
+        return true;
+    }
+    else
+    {
+        *bufferPtr = startPtr;
+        *sizePtr = startSize;
+        return false;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack a string from a buffer in the compact wire format, incrementing the buffer pointer and
+ * decrementing the available size by the number of bytes used.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_UnpackCompactString
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    char *stringPtr,
+    uint32_t bufferSize,
+    uint32_t maxStringCount
+)
+{
+    uint8_t* startPtr = *bufferPtr;
+    size_t startSize = *sizePtr;
+    uint64_t stringSize;
+
+    if (!le_pack_UnpackVarUint(bufferPtr, sizePtr, maxStringCount, &stringSize))
+    {
+        return false;
+    }
+
+    // Only allow unpacking into no output buffer if the string is zero sized.  Otherwise the
+    // output buffer must also have room for the terminator.
+    if ((stringSize > *sizePtr) ||
+        (stringPtr ? (stringSize >= bufferSize) : (stringSize > 0)))
+    {
+        *bufferPtr = startPtr;
+        *sizePtr = startSize;
+        return false;
+    }
+
+    if (stringPtr)
+    {
+        memcpy(stringPtr, *bufferPtr, stringSize);
+        stringPtr[stringSize] = '\0';
+    }
+
+    *bufferPtr = *bufferPtr + stringSize;
+    *sizePtr -= stringSize;
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack the count of an array from a buffer in the compact wire format.
+ *
+ * @note Users of this API should generally use the LE_PACK_UNPACKCOMPACTARRAY macro instead which
+ * also unpacks the array data.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool le_pack_UnpackCompactArrayHeader
+(
+    uint8_t **bufferPtr,
+    size_t *sizePtr,
+    const void *arrayPtr,
+    size_t *arrayCountPtr,
+    size_t arrayMaxCount
+)
+{
+    uint64_t arrayCount;
+
+    if (!le_pack_UnpackVarUint(bufferPtr, sizePtr, arrayMaxCount, &arrayCount))
+    {
+        return false;
+    }
+
+    *arrayCountPtr = (size_t)arrayCount;
+
+    // Missing array pointer must match zero sized array.
+    return (arrayPtr || (arrayCount == 0));
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack an array from a buffer in the compact wire format.  Each element is unpacked with
+ * unpackFunc.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_PACK_UNPACKCOMPACTARRAY(bufferPtr,                           \
+                                   sizePtr,                             \
+                                   arrayPtr,                            \
+                                   arrayCountPtr,                       \
+                                   arrayMaxCount,                       \
+                                   unpackFunc,                          \
+                                   resultPtr)                           \
+    do {                                                                \
+        *(resultPtr) = le_pack_UnpackCompactArrayHeader((bufferPtr), (sizePtr), \
+                                                        (arrayPtr), (arrayCountPtr), \
+                                                        (arrayMaxCount)); \
+        if (*(resultPtr))                                               \
+        {                                                               \
+            uint32_t i;                                                 \
+            for (i = 0; (i < *(arrayCountPtr)) && *(resultPtr); ++i)    \
+            {                                                           \
+                *(resultPtr) = unpackFunc((bufferPtr), (sizePtr), &(arrayPtr)[i]); \
+            }                                                           \
+        }                                                               \
+    } while (0)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack an array of struct from a buffer in the compact wire format.  Since its logic is the same
+ * as that for unpacking an array, here it calls LE_PACK_UNPACKCOMPACTARRAY() to do the work.
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_PACK_UNPACKCOMPACTSTRUCTARRAY(bufferPtr,                     \
+                                         sizePtr,                       \
+                                         arrayPtr,                      \
+                                         arrayCountPtr,                 \
+                                         arrayMaxCount,                 \
+                                         unpackFunc,                    \
+                                         resultPtr)                     \
+    LE_PACK_UNPACKCOMPACTARRAY((bufferPtr), (sizePtr), (arrayPtr), (arrayCountPtr), \
+                               (arrayMaxCount), (unpackFunc), (resultPtr))
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack an array of values that are packed as they are in memory in the compact wire format with
+ * a single copy.  This is the counterpart of LE_PACK_PACKCOMPACTSIMPLEARRAY().
+ */
+//--------------------------------------------------------------------------------------------------
+#define LE_PACK_UNPACKCOMPACTSIMPLEARRAY(bufferPtr,                     \
+                                         sizePtr,                       \
+                                         arrayPtr,                      \
+                                         arrayCountPtr,                 \
+                                         arrayMaxCount,                 \
+                                         resultPtr)                     \
+    do {                                                                \
+        *(resultPtr) = le_pack_UnpackCompactArrayHeader((bufferPtr), (sizePtr), \
+                                                        (arrayPtr), (arrayCountPtr), \
+                                                        (arrayMaxCount)); \
+        if (*(resultPtr) && (*(sizePtr) < sizeof((arrayPtr)[0])*(*(arrayCountPtr)))) \
+        {                                                               \
+            *(resultPtr) = false;                                       \
+        }                                                               \
+        else if (*(resultPtr))                                          \
+        {                                                               \
+            if (*(arrayCountPtr) > 0)                                   \
+            {                                                           \
+                memcpy((arrayPtr), *(bufferPtr), sizeof((arrayPtr)[0])*(*(arrayCountPtr))); \
+            }                                                           \
+            *(bufferPtr) += sizeof((arrayPtr)[0])*(*(arrayCountPtr));   \
+            *(sizePtr) -= sizeof((arrayPtr)[0])*(*(arrayCountPtr));     \
+        }                                                               \
+    } while (0)
+
 #endif /* LE_PACK_H_INCLUDE_GUARD */
@@ -70,6 +70,18 @@
  * The number of times that a timer has expired can be retrieved by le_timer_GetExpiryCount(). This
  * count is independent of whether there is an expiry handler for the timer.
  *
+ * @section timer_tolerance Coalescing Timer Expiries
+ *
+ * By default a timer expires as soon as possible after its interval has elapsed.  Timers that do not
+ * need to be precise (e.g., periodic housekeeping) can be given a tolerance using
+ * le_timer_SetTolerance() (or le_timer_SetMsTolerance()).  The timer may then expire at any point
+ * between the end of its interval and the end of its interval plus the tolerance.  A timer never
+ * expires early.
+ *
+ * All timers of a thread that are due when the first of them must expire are handled together, so
+ * timers with overlapping tolerance windows share a single wake-up of the thread.  The default
+ * tolerance of new timers is set by the TIMER_DEFAULT_TOLERANCE_MS build option.
+ *
  * @section le_timer_thread Thread Support
  *
  * A timer should only be used by the thread that created it. It's not safe for a thread to use
@@ -110,6 +122,8 @@
  *     - le_timer_GetTimeRemaining()
  *     - le_timer_GetMsTimeRemaining()
  *     - le_timer_SetWakeup()
+ *     - le_timer_SetTolerance()
+ *     - le_timer_SetMsTolerance()
  *
  * @section timer_troubleshooting Troubleshooting
  *
@@ -331,6 +345,49 @@ le_result_t le_timer_SetWakeup
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set how late the timer is allowed to expire.
+ *
+ * The timer may expire any time between the end of its interval and the end of its interval plus
+ * the tolerance, which allows its expiry to be handled together with other timers.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_BUSY if the timer is currently running
+ *
+ * @note
+ *      If an invalid timer object is given, the process exits.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_timer_SetTolerance
+(
+    le_timer_Ref_t timerRef,     ///< [IN] Set tolerance for this timer object.
+    le_clk_Time_t tolerance      ///< [IN] Maximum expiry delay.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set how late the timer is allowed to expire, in milliseconds.
+ *
+ * See le_timer_SetTolerance().
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_BUSY if the timer is currently running
+ *
+ * @note
+ *      If an invalid timer object is given, the process exits.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_timer_SetMsTolerance
+(
+    le_timer_Ref_t timerRef,     ///< [IN] Set tolerance for this timer object.
+    uint32_t tolerance           ///< [IN] Maximum expiry delay in milliseconds.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set context pointer for the timer.
@@ -38,6 +38,23 @@ typedef enum
 event_LoopState_t;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Lock-free queue of Event Reports.  Any thread can add reports to it, but only the thread that
+ * owns it can remove them.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_sls_Link_t*      headPtr;            ///< Most recently queued report (where other threads
+                                            ///< add reports).
+    le_sls_Link_t*      tailPtr;            ///< Oldest report (where the owning thread removes
+                                            ///< reports).
+    le_sls_Link_t       stub;               ///< Placeholder that keeps the queue non-empty.
+}
+event_ReportQueue_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Event Loop's per-thread record.
@@ -51,7 +68,17 @@ event_LoopState_t;
 //--------------------------------------------------------------------------------------------------
 typedef struct
 {
-    le_sls_List_t       eventQueue;         ///< The thread's event queue.
+    event_ReportQueue_t eventQueue;         ///< The thread's Event Queue.
+    event_ReportQueue_t urgentQueue;        ///< Reports processed ahead of the Event Queue.
+    size_t              queuedCount;        ///< Number of reports queued and not yet removed,
+                                            ///< on both queues.
+    size_t              reportBudget;       ///< Max. reports processed per wake-up (0 = no max.).
+    uint64_t            wakeupCount;        ///< Number of times reports were processed.
+    uint64_t            reportCount;        ///< Number of reports processed.
+    size_t              wakeupReportCount;  ///< Reports processed since the last wake-up.
+    size_t              maxReportsPerWakeup;///< Most reports processed on a single wake-up.
+    uint64_t            budgetHitCount;     ///< Number of wake-ups that left reports queued
+                                            ///< because of the report budget.
     le_dls_List_t       handlerList;        ///< List of handlers registered with this thread.
     le_dls_List_t       fdMonitorList;      ///< List of FD Monitors created by this thread.
     int                 epollFd;            ///< epoll(7) file descriptor.
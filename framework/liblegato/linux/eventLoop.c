@@ -35,6 +35,8 @@
  *
  *      Thread ---> Per-Thread Record --+--> Event Queue --+--> Report
  *         ^                            |
+ *         |                            +--> Urgent Queue --+--> Report
+ *         |                            |
  *         |                            +--> Handler List --+---------+
  *         |                                                          |
  *         +----------------------------------------------------+     |
@@ -65,20 +67,38 @@
  * Included in the set of file descriptors that are being monitored by epoll is an eventfd
  * (see 'man eventfd') monitored in "level-triggered" mode.
  *
- * Whenever an Event Report is added to the Event Queue for a thread, the number 1 is written to
- * that thread's eventfd.  When Event Reports are popped off a thread's Event Queue, that thread's
- * eventfd is read to decrement it.  As long as the eventfd's value is greater than 0, epoll_wait()
+ * Whenever an Event Report is added to an empty Event Queue for a thread, the number 1 is written
+ * to that thread's eventfd.  When the thread starts processing its Event Queue, it reads the
+ * eventfd to reset it to zero.  As long as the eventfd's value is greater than 0, epoll_wait()
  * will return immediately, reporting that there is something to read from that fd.
  *
+ * Each thread keeps count of the Event Reports on its Event Queue.  Only the report that makes
+ * the count go from zero to one writes to the eventfd; while the count is non-zero, the thread
+ * is either already awake or its eventfd has already been written.  When the thread stops
+ * processing Event Reports while some are still queued, it writes to its own eventfd so that it
+ * comes back to them.
+ *
  * The Event Loop is an infinite loop that calls epoll_wait() and then responds to any fd events
  * that epoll_wait() reports.  If epoll_wait() reports an event on the eventfd, then an Event Report
  * is popped off the Event Queue and processed.  If epoll_wait() reports an event on any other fd,
  * FD Event Reports are created and pushed onto Event Queues according to what handlers are
- * registered for those events.  All pending Event Reports are processed until the Event Queue is
- * empty before returning to epoll_wait().  (NOTE: This choice was made to save system call
- * overhead in times of heavy load.  Unfortunately, it also means that if event handlers always add
- * new events to the queue, then epoll_wait() will never be called and therefore fd events will
- * never be detected.)
+ * registered for those events.  All the Event Reports that were pending on wake-up are processed
+ * before returning to epoll_wait(), to save system call overhead in times of heavy load.  Reports
+ * added while they are being processed wait for the next wake-up, so event handlers that keep
+ * adding new events to the queue can't stop fd events from being detected.
+ *
+ * A burst of reports can still hold up fd events for a long time, though.  So:
+ *
+ *  - Each thread also has an Urgent Queue, whose reports are processed before anything on the
+ *    Event Queue.  Functions queued using le_event_QueueFunctionUrgent() go on it, and so do
+ *    FD events detected by epoll_wait() when the thread has a report budget.
+ *  - Each thread has a report budget (LE_CONFIG_EVENT_REPORT_BUDGET, or
+ *    le_event_SetReportBudget()), which limits how many reports are processed before going back
+ *    to epoll_wait().  Whatever is left over is processed on the next wake-up, as the eventfd is
+ *    rearmed.
+ *
+ * Each thread counts its wake-ups and the reports processed on them, which the inspect tool can
+ * show, to help tune the budget.
  *
  * ----
  *
@@ -88,6 +108,11 @@
  * multithreaded race conditions.  A Mutex is provided for that purpose, and it can be locked
  * and unlocked using the functions Lock() and Unlock().
  *
+ * The exception is the Event Queue (and the Urgent Queue), which is a lock-free multiple-producer,
+ * single-consumer queue, so that other threads can add Event Reports to it without taking the
+ * Mutex (see QueueReport() and PopLink()).  Only the thread that owns an Event Queue removes
+ * reports from it.
+ *
  * ----
  *
  * Copyright (C) Sierra Wireless Inc.
@@ -466,9 +491,12 @@ static void DeleteHandler
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Write to a thread's Event File Descriptor.  This increments it by one.
+ * Write to a thread's Event File Descriptor.  This increments it by one, which wakes the thread
+ * up.
  *
- * This must be done exactly once for each Event Report pushed onto the thread's Event Queue.
+ * This must be done whenever the thread's Event Queue stops being empty (see QueueReport()), and
+ * whenever the thread stops processing its Event Queue while reports remain on it (see
+ * RearmEventFd()).
  */
 //--------------------------------------------------------------------------------------------------
 static void WriteEventFd
@@ -505,10 +533,10 @@ static void WriteEventFd
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Read a thread's Event File Descriptor.  This fetches the value of the Event FD (which is
- * the number of event reports on the Event Queue) and resets the Event FD value to zero.
+ * Read a thread's Event File Descriptor.  This fetches the value of the Event FD (the number of
+ * times it has been written since it was last read) and resets the Event FD value to zero.
  *
- * @return The number of Event Reports on the thread's Event Queue.
+ * @return The number of times the Event FD was written.
  */
 //--------------------------------------------------------------------------------------------------
 static uint64_t ReadEventFd
@@ -527,6 +555,11 @@ static uint64_t ReadEventFd
         {
             return readBuff;
         }
+        else if ((readSize == -1) && (errno == EAGAIN))
+        {
+            // The eventfd is non-blocking, and has not been written since it was last read.
+            return 0;
+        }
         else
         {
             if ((readSize == -1) && (errno != EINTR))
@@ -542,12 +575,256 @@ static uint64_t ReadEventFd
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initialize an empty Report Queue.
+ */
+//--------------------------------------------------------------------------------------------------
+static void InitReportQueue
+(
+    event_ReportQueue_t* queuePtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    queuePtr->stub = LE_SLS_LINK_INIT;
+    queuePtr->headPtr = &queuePtr->stub;
+    queuePtr->tailPtr = &queuePtr->stub;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a link to the producers' end of a Report Queue.
+ *
+ * This can be called by any number of threads at the same time, without holding the Mutex.
+ * Between the exchange of the head pointer and the update of the previous link, the new link is
+ * not yet reachable by the consumer; PopReport() copes with that.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PushLink
+(
+    event_ReportQueue_t* queuePtr,
+    le_sls_Link_t* linkPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    __atomic_store_n(&linkPtr->nextPtr, NULL, __ATOMIC_RELAXED);
+
+    le_sls_Link_t* prevLinkPtr = __atomic_exchange_n(&queuePtr->headPtr,
+                                                     linkPtr,
+                                                     __ATOMIC_ACQ_REL);
+
+    __atomic_store_n(&prevLinkPtr->nextPtr, linkPtr, __ATOMIC_RELEASE);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue an Event Report onto one of a thread's Report Queues, and wake the thread up if it doesn't
+ * already know that it has reports to process.
+ *
+ * This can be called with or without the Mutex held.
+ */
+//--------------------------------------------------------------------------------------------------
+static void QueueReport
+(
+    event_PerThreadRec_t* perThreadRecPtr,
+    event_ReportQueue_t* queuePtr,          ///< [in] The thread's Event Queue or Urgent Queue.
+    Report_t* reportPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Count the report before it is queued, so the consumer never pops a report it hasn't counted
+    // (which would wrap the count).  A report that is counted but not yet linked is simply left
+    // for the consumer's next pass.
+    size_t oldCount = __atomic_fetch_add(&perThreadRecPtr->queuedCount, 1, __ATOMIC_ACQ_REL);
+
+    PushLink(queuePtr, &reportPtr->link);
+
+    if (oldCount == 0)
+    {
+        WriteEventFd(perThreadRecPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pop an Event Report off the consumer's end of one of the calling thread's Report Queues.
+ *
+ * Must only be called by the thread that owns the queue.
+ *
+ * @return Pointer to the report's link, or NULL if the queue is empty or the next report is still
+ *         in the process of being queued by another thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_sls_Link_t* PopLink
+(
+    event_ReportQueue_t* queuePtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_sls_Link_t* tailLinkPtr = queuePtr->tailPtr;
+    le_sls_Link_t* nextLinkPtr = __atomic_load_n(&tailLinkPtr->nextPtr, __ATOMIC_ACQUIRE);
+
+    // Skip over the stub link.
+    if (tailLinkPtr == &queuePtr->stub)
+    {
+        if (nextLinkPtr == NULL)
+        {
+            return NULL;
+        }
+
+        queuePtr->tailPtr = nextLinkPtr;
+        tailLinkPtr = nextLinkPtr;
+        nextLinkPtr = __atomic_load_n(&tailLinkPtr->nextPtr, __ATOMIC_ACQUIRE);
+    }
+
+    if (nextLinkPtr != NULL)
+    {
+        queuePtr->tailPtr = nextLinkPtr;
+        return tailLinkPtr;
+    }
+
+    // The tail is the last link that can be reached.  If it isn't the head, another thread is
+    // part way through queueing a report after it.
+    if (tailLinkPtr != __atomic_load_n(&queuePtr->headPtr, __ATOMIC_ACQUIRE))
+    {
+        return NULL;
+    }
+
+    // Put the stub back behind the tail so the tail can be removed without emptying the list.
+    PushLink(queuePtr, &queuePtr->stub);
+
+    nextLinkPtr = __atomic_load_n(&tailLinkPtr->nextPtr, __ATOMIC_ACQUIRE);
+    if (nextLinkPtr != NULL)
+    {
+        queuePtr->tailPtr = nextLinkPtr;
+        return tailLinkPtr;
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pop the next Event Report to be processed by the calling thread.  Reports on the Urgent Queue
+ * are taken before those on the Event Queue.
+ *
+ * @return Pointer to the report's link, or NULL if no report is available.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_sls_Link_t* PopReport
+(
+    event_PerThreadRec_t* perThreadRecPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_sls_Link_t* linkPtr = PopLink(&perThreadRecPtr->urgentQueue);
+
+    if (linkPtr == NULL)
+    {
+        linkPtr = PopLink(&perThreadRecPtr->eventQueue);
+    }
+
+    return linkPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Work out how many Event Reports the calling thread should process on this wake-up: those that
+ * are queued now, up to the thread's report budget.
+ *
+ * @return The number of reports to process.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetReportBatchSize
+(
+    event_PerThreadRec_t* perThreadRecPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t numReports = __atomic_load_n(&perThreadRecPtr->queuedCount, __ATOMIC_ACQUIRE);
+
+    if ((perThreadRecPtr->reportBudget != 0) && (numReports > perThreadRecPtr->reportBudget))
+    {
+        numReports = perThreadRecPtr->reportBudget;
+        perThreadRecPtr->budgetHitCount++;
+    }
+
+    return numReports;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update the calling thread's wake-up statistics when it wakes up to process Event Reports.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RecordWakeup
+(
+    event_PerThreadRec_t* perThreadRecPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    perThreadRecPtr->wakeupCount++;
+    perThreadRecPtr->wakeupReportCount = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Update the calling thread's wake-up statistics after it has processed an Event Report.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RecordReport
+(
+    event_PerThreadRec_t* perThreadRecPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    perThreadRecPtr->reportCount++;
+    perThreadRecPtr->wakeupReportCount++;
+
+    if (perThreadRecPtr->wakeupReportCount > perThreadRecPtr->maxReportsPerWakeup)
+    {
+        perThreadRecPtr->maxReportsPerWakeup = perThreadRecPtr->wakeupReportCount;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Make sure the calling thread's Event Loop comes back to its Event Queue if reports are still
+ * queued on it.  Must be called whenever the thread stops processing reports.
+ *
+ * Other threads don't write to the eventfd while the queue is non-empty, so the thread has to
+ * do it itself.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RearmEventFd
+(
+    event_PerThreadRec_t* perThreadRecPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (__atomic_load_n(&perThreadRecPtr->queuedCount, __ATOMIC_ACQUIRE) > 0)
+    {
+        WriteEventFd(perThreadRecPtr);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Process one event report from the calling thread's Event Queue.
+ *
+ * @return true if a report was processed, false if none was available.
  **/
 //--------------------------------------------------------------------------------------------------
-static void ProcessOneEventReport
+static bool ProcessOneEventReport
 (
     event_PerThreadRec_t* perThreadRecPtr   ///< [in] Ptr to the calling thread's per-thread record.
 )
@@ -556,19 +833,19 @@ static void ProcessOneEventReport
     le_sls_Link_t* linkPtr;
     Report_t* reportObjPtr;
     Handler_t* handlerPtr;
+    int oldState;
 
-    int oldState = Lock();
-
-    // Pop an Event Report off the head of the Event Queue (inside a critical section).
-    linkPtr = le_sls_Pop(&perThreadRecPtr->eventQueue);
-
-    Unlock(oldState);
+    // Pop an Event Report off the head of the Event Queue.  No need to lock, because only this
+    // thread removes reports from its queue.
+    linkPtr = PopReport(perThreadRecPtr);
 
     if (linkPtr == NULL)
     {
-        return;
+        return false;
     }
 
+    __atomic_sub_fetch(&perThreadRecPtr->queuedCount, 1, __ATOMIC_ACQ_REL);
+
     // Convert the link pointer into a pointer to the Report base class.
     reportObjPtr = CONTAINER_OF(linkPtr, Report_t, link);
 
@@ -640,12 +917,16 @@ static void ProcessOneEventReport
 
     // We are done with this report.
     le_mem_Release(reportObjPtr);
+
+    RecordReport(perThreadRecPtr);
+
+    return true;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Process Event Reports from the calling thread's Event Queue until the queue is empty.
+ * Process a batch of Event Reports from the calling thread's Report Queues.
  */
 //--------------------------------------------------------------------------------------------------
 static void ProcessEventReports
@@ -654,18 +935,27 @@ static void ProcessEventReports
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Read the eventfd to fetch the number of Reports on the Event Queue and reset the count
-    // to zero.
-    uint64_t numReports = ReadEventFd(perThreadRecPtr);
-
-    // Process only those event reports that are already on the queue.  Anything reported by the
-    // event handlers will have to wait until next time ProcessEventReports() is called.
-    // This approach ensures that event handlers that re-queue events to the event
-    // queue don't cause fd events to be starved.
-    for (; numReports > 0; numReports--)
+    // Reset the eventfd to zero, then fetch the number of Reports to process.
+    ReadEventFd(perThreadRecPtr);
+    RecordWakeup(perThreadRecPtr);
+    size_t numReports = GetReportBatchSize(perThreadRecPtr);
+    size_t numProcessed = 0;
+
+    // Process only those event reports that are already on the queue, and no more than the
+    // budget.  Anything reported by the event handlers will have to wait until next time
+    // ProcessEventReports() is called.  This approach ensures that event handlers that re-queue
+    // events to the event queue don't cause fd events to be starved.
+    while (numProcessed < numReports)
     {
-        ProcessOneEventReport(perThreadRecPtr);
+        if (!ProcessOneEventReport(perThreadRecPtr))
+        {
+            // The next report is still being queued by another thread.
+            break;
+        }
+        numProcessed++;
     }
+
+    RearmEventFd(perThreadRecPtr);
 }
 
 
@@ -698,12 +988,13 @@ static void PubSubHandlerFunc
  * Queue a function onto a specific thread's Event Queue (could belong to the calling thread or
  * could belong to some other thread).
  *
- * @warning Assumes the mutex is locked and the thread is protected from cancellation.
+ * @note Doesn't need the mutex to be locked.
  */
 //--------------------------------------------------------------------------------------------------
 static void QueueFunction
 (
     event_PerThreadRec_t*   perThreadRecPtr, ///< [in] Pointer to the thread's event data record.
+    bool                    isUrgent,   ///< [in] true = queue onto the thread's Urgent Queue.
     le_event_DeferredFunc_t func,       ///< [in] The function to be called later.
     void*                   param1Ptr,  ///< [in] Value to be passed to the function when called.
     void*                   param2Ptr   ///< [in] Value to be passed to the function when called.
@@ -720,11 +1011,19 @@ static void QueueFunction
     reportPtr->param1Ptr = param1Ptr;
     reportPtr->param2Ptr = param2Ptr;
 
-    // Queue it to the Event Queue.
-    le_sls_Queue(&perThreadRecPtr->eventQueue, &reportPtr->baseClass.link);
+    // Queue it to the Event Queue, notifying the Event Loop if needed.  write() is a cancellation
+    // point, so guard against the thread being cancelled between queueing the report and writing
+    // the eventfd, which would leave the report stranded.
+    int oldState;
+    int err = pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &oldState);
+    LE_FATAL_IF(err != 0, "pthread_setcancelstate() failed (%s)", strerror(err));
+
+    QueueReport(perThreadRecPtr,
+                isUrgent ? &perThreadRecPtr->urgentQueue : &perThreadRecPtr->eventQueue,
+                &reportPtr->baseClass);
 
-    // Write to the eventfd to notify the Event Loop that there is something on the queue.
-    WriteEventFd(perThreadRecPtr);
+    err = pthread_setcancelstate(oldState, &oldState);
+    LE_FATAL_IF(err != 0, "pthread_setcancelstate() failed (%s)", strerror(err));
 }
 
 
@@ -818,7 +1117,10 @@ void event_InitThread
     event_PerThreadRec_t* recPtr = thread_GetEventRecPtr();
 
     // Initialize the various thread-specific lists and queues.
-    recPtr->eventQueue = LE_SLS_LIST_INIT;
+    InitReportQueue(&recPtr->eventQueue);
+    InitReportQueue(&recPtr->urgentQueue);
+    recPtr->queuedCount = 0;
+    recPtr->reportBudget = LE_CONFIG_EVENT_REPORT_BUDGET;
     recPtr->handlerList = LE_DLS_LIST_INIT;
     recPtr->fdMonitorList = LE_DLS_LIST_INIT;
 
@@ -829,7 +1131,8 @@ void event_InitThread
 
     // Open an eventfd for this thread.  This will be uses to signal to the epoll fd that there
     // are Event Reports on the Event Queue.
-    recPtr->eventQueueFd = eventfd(0, 0);
+    // It is non-blocking because it is also read when it might not have been written.
+    recPtr->eventQueueFd = eventfd(0, EFD_NONBLOCK);
     LE_FATAL_IF(recPtr->eventQueueFd < 0, "eventfd() failed with errno %d (%m).", errno);
 
     // Add the eventfd to the list of file descriptors to wait for using epoll_wait().
@@ -926,7 +1229,7 @@ void event_DestructThread
     fdMon_DestructThread(perThreadRecPtr);
 
     // Discard everything on the Event Queue.
-    while (NULL != (singleLinkPtr = le_sls_Pop(&perThreadRecPtr->eventQueue)))
+    while (NULL != (singleLinkPtr = PopReport(perThreadRecPtr)))
     {
         Report_t* reportPtr = CONTAINER_OF(singleLinkPtr, Report_t, link);
 
@@ -1201,11 +1504,10 @@ void le_event_Report
         reportObjPtr->handlerRef = handlerPtr->safeRef;
         memset(reportObjPtr->payload, 0, eventPtr->payloadSize);
         memcpy(reportObjPtr->payload, payloadPtr, payloadSize);
-        le_sls_Queue(&perThreadRecPtr->eventQueue, &reportObjPtr->baseClass.link);
 
-        // Increment the eventfd for the handler's thread's Event Queue.
-        // This will wake up the thread and tell it that it has something on its Event Queue.
-        WriteEventFd(perThreadRecPtr);
+        // This will wake up the handler's thread if it doesn't already know it has something on
+        // its Event Queue.
+        QueueReport(perThreadRecPtr, &perThreadRecPtr->eventQueue, &reportObjPtr->baseClass);
 
         linkPtr = le_dls_PeekNext(&eventPtr->handlerList, linkPtr);
     }
@@ -1262,11 +1564,10 @@ void le_event_ReportWithRefCounting
         reportObjPtr->handlerRef = handlerPtr->safeRef;
         reportObjPtr->payload[0] = objectPtr;
         le_mem_AddRef(objectPtr);
-        le_sls_Queue(&perThreadRecPtr->eventQueue, &reportObjPtr->baseClass.link);
 
-        // Increment the eventfd for the handler's thread's Event Queue.
-        // This will wake up the thread and tell it that it has something on its Event Queue.
-        WriteEventFd(perThreadRecPtr);
+        // This will wake up the handler's thread if it doesn't already know it has something on
+        // its Event Queue.
+        QueueReport(perThreadRecPtr, &perThreadRecPtr->eventQueue, &reportObjPtr->baseClass);
 
         linkPtr = le_dls_PeekNext(&eventPtr->handlerList, linkPtr);
     }
@@ -1346,11 +1647,7 @@ void le_event_QueueFunction
 )
 //--------------------------------------------------------------------------------------------------
 {
-    int oldState = Lock();
-
-    QueueFunction(thread_GetEventRecPtr(), func, param1Ptr, param2Ptr);
-
-    Unlock(oldState);
+    QueueFunction(thread_GetEventRecPtr(), false, func, param1Ptr, param2Ptr);
 }
 
 
@@ -1369,11 +1666,60 @@ void le_event_QueueFunctionToThread
 )
 //--------------------------------------------------------------------------------------------------
 {
-    int oldState = Lock();
+    QueueFunction(thread_GetOtherEventRecPtr(thread), false, func, param1Ptr, param2Ptr);
+}
 
-    QueueFunction(thread_GetOtherEventRecPtr(thread), func, param1Ptr, param2Ptr);
 
-    Unlock(oldState);
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue a function onto the calling thread's Urgent Queue.  It will be called by the calling
+ * thread's Event Loop before anything on its Event Queue.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_event_QueueFunctionUrgent
+(
+    le_event_DeferredFunc_t func,       ///< [in] The function to be called later.
+    void*                   param1Ptr,  ///< [in] Value to be passed to the function when called.
+    void*                   param2Ptr   ///< [in] Value to be passed to the function when called.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    QueueFunction(thread_GetEventRecPtr(), true, func, param1Ptr, param2Ptr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Queue a function onto a specific thread's Urgent Queue.  It will be called by that thread's
+ * Event Loop before anything on its Event Queue.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_event_QueueFunctionToThreadUrgent
+(
+    le_thread_Ref_t         thread,     ///< [in] The thread to queue the function to.
+    le_event_DeferredFunc_t func,       ///< [in] The function.
+    void*                   param1Ptr,  ///< [in] Value to be passed to the function when called.
+    void*                   param2Ptr   ///< [in] Value to be passed to the function when called.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    QueueFunction(thread_GetOtherEventRecPtr(thread), true, func, param1Ptr, param2Ptr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the maximum number of Event Reports that the calling thread's Event Loop processes before
+ * checking its file descriptors again.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_event_SetReportBudget
+(
+    size_t maxReports   ///< [in] Maximum number of reports per wake-up, or 0 for no maximum.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    thread_GetEventRecPtr()->reportBudget = maxReports;
 }
 
 
@@ -1486,6 +1832,39 @@ int le_event_GetFd
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Process one of the live Event Reports counted by le_event_ServiceLoop().  This function assumes
+ * the mutex is NOT locked.
+ *
+ * @return
+ *  - LE_OK if a report was processed.
+ *  - LE_WOULD_BLOCK if the next report is still being queued by another thread, in which case
+ *    the rest of the live reports are left for the eventfd to announce again.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ServiceOneEventReport
+(
+    event_PerThreadRec_t* perThreadRecPtr   ///< [in] Ptr to the calling thread's per-thread record.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (!ProcessOneEventReport(perThreadRecPtr))
+    {
+        perThreadRecPtr->liveEventCount = 0;
+        RearmEventFd(perThreadRecPtr);
+        return LE_WOULD_BLOCK;
+    }
+
+    perThreadRecPtr->liveEventCount--;
+    if (perThreadRecPtr->liveEventCount == 0)
+    {
+        RearmEventFd(perThreadRecPtr);
+    }
+    return LE_OK;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Services the calling thread's Event Loop.
@@ -1516,9 +1895,7 @@ le_result_t le_event_ServiceLoop
     // If there are still live events remaining in the queue, process a single event, then return
     if (perThreadRecPtr->liveEventCount > 0)
     {
-        perThreadRecPtr->liveEventCount--;
-        ProcessOneEventReport(perThreadRecPtr); // This function assumes the mutex is NOT locked.
-        return LE_OK;
+        return ServiceOneEventReport(perThreadRecPtr);
     }
 
     int result;
@@ -1582,17 +1959,17 @@ le_result_t le_event_ServiceLoop
     }
 
     // Read the eventfd to reset it to zero so epoll stops telling us about it until more
-    // are added.
-    perThreadRecPtr->liveEventCount = ReadEventFd(perThreadRecPtr);
+    // are added, then take note of how many reports to process before checking the fds again.
+    ReadEventFd(perThreadRecPtr);
+    RecordWakeup(perThreadRecPtr);
+    perThreadRecPtr->liveEventCount = GetReportBatchSize(perThreadRecPtr);
 
     LE_DEBUG("perThreadRecPtr->liveEventCount is" "%" PRIu64, perThreadRecPtr->liveEventCount);
 
     // If events were read, process the top event
     if (perThreadRecPtr->liveEventCount > 0)
     {
-        perThreadRecPtr->liveEventCount--;
-        ProcessOneEventReport(perThreadRecPtr);
-        return LE_OK;
+        return ServiceOneEventReport(perThreadRecPtr);
     }
     else
     {
@@ -13,6 +13,8 @@
  * When a file descriptor event is detected by the Event Loop, fdMon_Report() is called with
  * the FD Monitor Reference (a safe reference) and a bit map containing the events that were
  * detected.  fdMon_Report() queues a function call (DispatchToHandler()) to the calling thread.
+ * If the thread has a report budget, it goes on the thread's Urgent Queue, so that it is run
+ * ahead of any backlog of other queued functions.  Otherwise it goes on the Event Queue, in order.
  * When that function gets called, it does a look-up of the safe reference.  If it finds an
  * FD Monitor object matching that reference (it could have been deleted in the meantime), then
  * it calls its registered handler function for that event.
@@ -23,7 +25,7 @@
  * In some cases (e.g., with regular files), the fd doesn't support epoll().  In those cases, we
  * treat the fd as if it is always ready to be read from and written to.  If either EPOLLIN or
  * EPOLLOUT are enabled in the epoll events set for such an fd, DispatchToHandler() is immediately
- * queued to the thread's Event Queue
+ * queued to the thread's (normal) Event Queue
  *  - When the FD Monitor is created,
  *  - When DispatchToHandler() finishes running the handler function and the FD Monitor has not been
  *      deleted and still has at least one of EPOLLIN or EPOLLOUT enabled.
@@ -416,7 +418,7 @@ static void DispatchToHandler
         //       we will only end up in here if both POLLIN and POLLOUT are disabled, in which case
         //       returning now will prevent re-queuing of DispatchToHandler(), which is what we
         //       want.  When either POLLIN or POLLOUT are re-enabled, le_fdMonitor_Enable() will
-        //       call fdMon_Report() to get things going again.
+        //       queue it again to get things going.
         return;
     }
 
@@ -455,7 +457,9 @@ static void DispatchToHandler
     // when one of them is re-enabled.
     if ((fdMonitorPtr->isAlwaysReady) && (fdMonitorPtr->epollEvents & (EPOLLIN | EPOLLOUT)))
     {
-        fdMon_Report(fdMonitorPtr->safeRef, fdMonitorPtr->epollEvents & (EPOLLIN | EPOLLOUT));
+        le_event_QueueFunction(DispatchToHandler,
+                               fdMonitorPtr->safeRef,
+                               (void*)(ssize_t)(fdMonitorPtr->epollEvents & (EPOLLIN | EPOLLOUT)));
     }
 
     // Release our reference.  We don't need the Monitor object anymore.
@@ -576,7 +580,16 @@ void fdMon_Report
 )
 //--------------------------------------------------------------------------------------------------
 {
-    le_event_QueueFunction(DispatchToHandler, safeRef, (void*)(ssize_t)eventFlags);
+    // Without a report budget, every report queued at wake-up is processed before epoll_wait()
+    // is called again, so there's nothing to jump ahead of.
+    if (thread_GetEventRecPtr()->reportBudget != 0)
+    {
+        le_event_QueueFunctionUrgent(DispatchToHandler, safeRef, (void*)(ssize_t)eventFlags);
+    }
+    else
+    {
+        le_event_QueueFunction(DispatchToHandler, safeRef, (void*)(ssize_t)eventFlags);
+    }
 }
 
 
@@ -691,7 +704,9 @@ le_fdMonitor_Ref_t le_fdMonitor_Create
             uint32_t epollEvents = fdMonitorPtr->epollEvents & (EPOLLIN | EPOLLOUT);
             if (epollEvents != 0)
             {
-                fdMon_Report(fdMonitorPtr->safeRef, epollEvents);
+                le_event_QueueFunction(DispatchToHandler,
+                                       fdMonitorPtr->safeRef,
+                                       (void*)(ssize_t)epollEvents);
             }
         }
         else
@@ -770,7 +785,9 @@ void le_fdMonitor_Enable
         if ((handlerMonitorPtr == NULL) || (handlerMonitorPtr->safeRef == monitorRef))
         {
             // Queue up DispatchToHandler() for this fd.
-            fdMon_Report(monitorRef, epollEvents & (EPOLLIN | EPOLLOUT));
+            le_event_QueueFunction(DispatchToHandler,
+                                   monitorRef,
+                                   (void*)(ssize_t)(epollEvents & (EPOLLIN | EPOLLOUT)));
         }
     }
 
@@ -35,6 +35,95 @@
     }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of entries moved to the new buckets of a chained map by a single Put or Remove
+ * while the map is being resized.
+ */
+//--------------------------------------------------------------------------------------------------
+#define REHASH_STEP_ENTRIES     8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum number of old buckets visited by a single Put or Remove while a chained map is being
+ * resized.  This bounds the work done when skipping over empty buckets.
+ */
+//--------------------------------------------------------------------------------------------------
+#define REHASH_STEP_BUCKETS     32
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * List of all hashmaps, for the Inspect tool.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t MapList = LE_DLS_LIST_INIT;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A counter that increments every time a change is made to MapList.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t MapListChangeCount = 0;
+static size_t* MapListChangeCountRef = &MapListChangeCount;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pthreads fast mutex used to protect MapList, as maps can be created by any thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_mutex_t MapListMutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exposing the hashmap list; mainly for the Inspect tool.
+ */
+//--------------------------------------------------------------------------------------------------
+le_dls_List_t* hashmap_GetMapList
+(
+    void
+)
+{
+    return (&MapList);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exposing the hashmap list change counter; mainly for the Inspect tool.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t** hashmap_GetMapListChgCntRef
+(
+    void
+)
+{
+    return (&MapListChangeCountRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a newly created map to the list of all hashmaps.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddToMapList
+(
+    Hashmap_t* mapRef
+)
+{
+    mapRef->mapLink = LE_DLS_LINK_INIT;
+
+    LE_ASSERT(pthread_mutex_lock(&MapListMutex) == 0);
+    MapListChangeCount++;
+    le_dls_Queue(&MapList, &(mapRef->mapLink));
+    LE_ASSERT(pthread_mutex_unlock(&MapListMutex) == 0);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Calculate a hash. First this calls the user-supplied hash function.
@@ -79,7 +168,7 @@ static inline size_t HashKey(Hashmap_t* map, const void* key) {
 static Entry_t* CreateEntry
 (
     const void* newKeyPtr,
-    int newHash,
+    size_t newHash,
     const void* newValuePtr,
     le_mem_PoolRef_t poolRef
 )
@@ -91,6 +180,7 @@ static Entry_t* CreateEntry
     entryPtr->hash = newHash;
     entryPtr->valuePtr = newValuePtr;
     entryPtr->entryListLink = LE_DLS_LINK_INIT;
+    entryPtr->iterLink = LE_DLS_LINK_INIT;
     return entryPtr;
 }
 
@@ -140,6 +230,650 @@ static inline bool EqualKeys
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Smallest number of slots in the index of a compact map.
+ */
+//--------------------------------------------------------------------------------------------------
+#define COMPACT_MIN_SLOT_COUNT  8
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Largest number of slots in the index of a compact map.  This keeps entry positions within the
+ * range of the iterator's index and the low 32 bits of a hash enough to locate an entry's home slot.
+ */
+//--------------------------------------------------------------------------------------------------
+#define COMPACT_MAX_SLOT_COUNT  ((size_t)1 << 30)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of entries a compact map can hold for a given number of index slots (0.75 load factor).
+ */
+//--------------------------------------------------------------------------------------------------
+#define COMPACT_MAX_ENTRIES(slotCount)  ((slotCount) - ((slotCount) / 4))
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Marker stored in the key of a compact map entry that has been removed.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char RemovedKey;
+#define REMOVED_KEY_PTR ((const void*)&RemovedKey)
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks if a map uses open addressing (was created by le_hashmap_CreateCompact()).
+ *
+ * @return  Returns true for a compact map, false for a chained map
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool IsCompact(const Hashmap_t* mapRef) {
+    return (mapRef->slotsPtr != NULL);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the distance between an occupied slot of a compact map's index and the home slot of the
+ * entry it holds.
+ *
+ * @return  Returns the number of slots the entry has been displaced by
+ */
+//--------------------------------------------------------------------------------------------------
+static inline size_t SlotDistance(const Hashmap_t* mapRef, size_t slotIndex) {
+    size_t homeIndex = CalculateIndex(mapRef->bucketCount, mapRef->slotsPtr[slotIndex].hashTag);
+
+    return (slotIndex - homeIndex) & (mapRef->bucketCount - 1);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Looks up a key in the index of a compact map.
+ *
+ * @return  Returns the index of the slot referring to the key's entry, or -1 if not found
+ */
+//--------------------------------------------------------------------------------------------------
+static ssize_t CompactFindSlot
+(
+    Hashmap_t* mapRef,
+    const void* keyPtr,
+    size_t hash
+)
+{
+    size_t mask = mapRef->bucketCount - 1;
+    size_t slotIndex = CalculateIndex(mapRef->bucketCount, hash);
+    size_t distance = 0;
+    uint32_t hashTag = (uint32_t)hash;
+
+    while (true)
+    {
+        const CompactSlot_t* slotPtr = &(mapRef->slotsPtr[slotIndex]);
+
+        // The key would have displaced any entry that is closer to its own home slot, so the
+        // search can stop there.
+        if ((slotPtr->entryNum == 0) || (SlotDistance(mapRef, slotIndex) < distance))
+        {
+            return -1;
+        }
+
+        if (slotPtr->hashTag == hashTag)
+        {
+            const CompactEntry_t* entryPtr = &(mapRef->entriesPtr[slotPtr->entryNum - 1]);
+
+            if (EqualKeys(entryPtr->keyPtr, entryPtr->hash, keyPtr, hash, mapRef->equalsFuncPtr))
+            {
+                return slotIndex;
+            }
+        }
+
+        slotIndex = (slotIndex + 1) & mask;
+        distance++;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds an entry to the index of a compact map, displacing entries that are closer to their home
+ * slot than the one being inserted (Robin Hood hashing).
+ */
+//--------------------------------------------------------------------------------------------------
+static void CompactInsertSlot
+(
+    Hashmap_t* mapRef,
+    size_t entryIndex,
+    size_t hash
+)
+{
+    size_t mask = mapRef->bucketCount - 1;
+    size_t slotIndex = CalculateIndex(mapRef->bucketCount, hash);
+    size_t distance = 0;
+    CompactSlot_t slot = { .entryNum = entryIndex + 1, .hashTag = (uint32_t)hash };
+
+    while (mapRef->slotsPtr[slotIndex].entryNum != 0)
+    {
+        size_t slotDistance = SlotDistance(mapRef, slotIndex);
+
+        if (slotDistance < distance)
+        {
+            CompactSlot_t displacedSlot = mapRef->slotsPtr[slotIndex];
+
+            mapRef->slotsPtr[slotIndex] = slot;
+            slot = displacedSlot;
+            distance = slotDistance;
+        }
+
+        slotIndex = (slotIndex + 1) & mask;
+        distance++;
+    }
+
+    mapRef->slotsPtr[slotIndex] = slot;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Empties a slot in the index of a compact map, shifting the following displaced entries back
+ * towards their home slots so no tombstone is needed.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CompactRemoveSlot
+(
+    Hashmap_t* mapRef,
+    size_t slotIndex
+)
+{
+    size_t mask = mapRef->bucketCount - 1;
+    size_t nextIndex = (slotIndex + 1) & mask;
+
+    while ((mapRef->slotsPtr[nextIndex].entryNum != 0) && (SlotDistance(mapRef, nextIndex) != 0))
+    {
+        mapRef->slotsPtr[slotIndex] = mapRef->slotsPtr[nextIndex];
+        slotIndex = nextIndex;
+        nextIndex = (nextIndex + 1) & mask;
+    }
+
+    mapRef->slotsPtr[slotIndex].entryNum = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Squeezes the holes out of a compact map's entry array, resizes the map and rebuilds its index.
+ *
+ * Entries keep their relative order, and the iterator is moved along with its current entry so
+ * that an iteration in progress carries on where it was.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CompactResize
+(
+    Hashmap_t* mapRef,
+    size_t slotCount                ///< [in] New number of slots in the index.
+)
+{
+    HashmapIt_t* iteratorPtr = mapRef->iteratorPtr;
+    int32_t iteratorIndex = iteratorPtr->currentIndex;
+    size_t readIndex;
+    size_t writeIndex = 0;
+
+    for (readIndex = 0; readIndex < mapRef->entryCount; readIndex++)
+    {
+        bool isRemoved = (mapRef->entriesPtr[readIndex].keyPtr == REMOVED_KEY_PTR);
+
+        if ((int32_t)readIndex == iteratorPtr->currentIndex)
+        {
+            // If the iterator is on a hole, leave it just before the entry that followed it.
+            iteratorIndex = (int32_t)writeIndex - (isRemoved ? 1 : 0);
+        }
+
+        if (!isRemoved)
+        {
+            mapRef->entriesPtr[writeIndex++] = mapRef->entriesPtr[readIndex];
+        }
+    }
+    if (iteratorPtr->currentIndex >= (int32_t)mapRef->entryCount)
+    {
+        iteratorIndex = writeIndex;
+    }
+    iteratorPtr->currentIndex = iteratorIndex;
+    mapRef->entryCount = writeIndex;
+
+    if (slotCount != mapRef->bucketCount)
+    {
+        mapRef->entryCapacity = COMPACT_MAX_ENTRIES(slotCount);
+        mapRef->entriesPtr = realloc(mapRef->entriesPtr,
+                                     mapRef->entryCapacity * sizeof(CompactEntry_t));
+        LE_ASSERT(mapRef->entriesPtr);
+
+        free(mapRef->slotsPtr);
+        mapRef->slotsPtr = calloc(slotCount, sizeof(CompactSlot_t));
+        LE_ASSERT(mapRef->slotsPtr);
+        mapRef->bucketCount = slotCount;
+        mapRef->resizeCount++;
+    }
+    else
+    {
+        memset(mapRef->slotsPtr, 0, slotCount * sizeof(CompactSlot_t));
+    }
+
+    for (readIndex = 0; readIndex < mapRef->entryCount; readIndex++)
+    {
+        CompactInsertSlot(mapRef, readIndex, mapRef->entriesPtr[readIndex].hash);
+    }
+
+    HASHMAP_TRACE(
+        mapRef,
+        "Hashmap %s: Resized to %zu slots for %zu entries",
+        mapRef->nameStr,
+        mapRef->bucketCount,
+        mapRef->size
+    );
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds the first entry of a compact map at or after a given position that has not been removed.
+ *
+ * @return  Returns the position of the entry, or the entry count if there is none
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t CompactNextEntry
+(
+    Hashmap_t* mapRef,
+    size_t entryIndex
+)
+{
+    while ((entryIndex < mapRef->entryCount) &&
+           (mapRef->entriesPtr[entryIndex].keyPtr == REMOVED_KEY_PTR))
+    {
+        entryIndex++;
+    }
+
+    return entryIndex;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Add a key-value pair to a compact map, growing the map if it is full.
+ *
+ * @return  Returns NULL for a new entry or a pointer to the old value if it is replaced.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* CompactPut
+(
+    Hashmap_t* mapRef,
+    const void* keyPtr,
+    const void* valuePtr
+)
+{
+    size_t hash = HashKey(mapRef, keyPtr);
+    ssize_t slotIndex = CompactFindSlot(mapRef, keyPtr, hash);
+
+    if (slotIndex >= 0)
+    {
+        CompactEntry_t* entryPtr = &(mapRef->entriesPtr[mapRef->slotsPtr[slotIndex].entryNum - 1]);
+        const void* oldValue = entryPtr->valuePtr;
+
+        entryPtr->valuePtr = valuePtr;
+
+        HASHMAP_TRACE(
+            mapRef,
+            "Hashmap %s: Replaced entry. Total map size now %zu",
+            mapRef->nameStr,
+            mapRef->size
+        );
+
+        return (void*)oldValue;
+    }
+
+    if (mapRef->entryCount == mapRef->entryCapacity)
+    {
+        size_t slotCount = mapRef->bucketCount;
+
+        // Only grow if compacting the entry array would not free up a quarter of it.
+        if ((mapRef->entryCount - mapRef->size) < (mapRef->entryCapacity / 4))
+        {
+            LE_FATAL_IF(slotCount >= COMPACT_MAX_SLOT_COUNT,
+                        "Hashmap %s: Too many entries (%zu)",
+                        mapRef->nameStr,
+                        mapRef->size);
+            slotCount <<= 1;
+        }
+
+        CompactResize(mapRef, slotCount);
+    }
+
+    size_t entryIndex = mapRef->entryCount++;
+
+    mapRef->entriesPtr[entryIndex].keyPtr = keyPtr;
+    mapRef->entriesPtr[entryIndex].valuePtr = valuePtr;
+    mapRef->entriesPtr[entryIndex].hash = hash;
+    CompactInsertSlot(mapRef, entryIndex, hash);
+    mapRef->size++;
+
+    HASHMAP_TRACE(
+        mapRef,
+        "Hashmap %s: Added entry %zu. Map size now %zu",
+        mapRef->nameStr,
+        entryIndex,
+        mapRef->size
+    );
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Look up an entry in a compact map.
+ *
+ * @return  Returns a pointer to the entry, or NULL if the key is not found.
+ */
+//--------------------------------------------------------------------------------------------------
+static CompactEntry_t* CompactGet
+(
+    Hashmap_t* mapRef,
+    const void* keyPtr
+)
+{
+    ssize_t slotIndex = CompactFindSlot(mapRef, keyPtr, HashKey(mapRef, keyPtr));
+
+    if (slotIndex < 0)
+    {
+        HASHMAP_TRACE(
+            mapRef,
+            "Hashmap %s: Key not found",
+            mapRef->nameStr
+        );
+        return NULL;
+    }
+
+    return &(mapRef->entriesPtr[mapRef->slotsPtr[slotIndex].entryNum - 1]);
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Remove a value from a compact map.
+ *
+ * @return  Returns a pointer to the value or NULL if the key is not found.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* CompactRemove
+(
+    Hashmap_t* mapRef,
+    const void* keyPtr
+)
+{
+    ssize_t slotIndex = CompactFindSlot(mapRef, keyPtr, HashKey(mapRef, keyPtr));
+
+    if (slotIndex < 0)
+    {
+        HASHMAP_TRACE(
+            mapRef,
+            "Hashmap %s: Key not found",
+            mapRef->nameStr
+        );
+        return NULL;
+    }
+
+    size_t entryIndex = mapRef->slotsPtr[slotIndex].entryNum - 1;
+    CompactEntry_t* entryPtr = &(mapRef->entriesPtr[entryIndex]);
+    void* value = (void*)(entryPtr->valuePtr);
+
+    CompactRemoveSlot(mapRef, slotIndex);
+    entryPtr->keyPtr = REMOVED_KEY_PTR;
+    entryPtr->valuePtr = NULL;
+    mapRef->size--;
+
+    if (mapRef->iteratorPtr->currentIndex == (int32_t)entryIndex)
+    {
+        mapRef->iteratorPtr->isValueValid = false;
+    }
+
+    // Holes at the end of the entry array can be reused straight away.
+    while ((mapRef->entryCount > 0) &&
+           (mapRef->entriesPtr[mapRef->entryCount - 1].keyPtr == REMOVED_KEY_PTR))
+    {
+        mapRef->entryCount--;
+    }
+
+    HASHMAP_TRACE(
+        mapRef,
+        "Hashmap %s: Removing key from map",
+        mapRef->nameStr
+    );
+
+    return value;
+}
+
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates and initializes the buckets of a chained map.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AllocBuckets
+(
+    Hashmap_t* mapRef,
+    size_t bucketCount
+)
+{
+    size_t i;
+
+    mapRef->bucketCount = bucketCount;
+    mapRef->bucketsPtr = malloc(bucketCount * sizeof(le_dls_List_t));
+    LE_ASSERT(mapRef->bucketsPtr);
+    mapRef->chainLengthPtr = malloc(bucketCount * sizeof(size_t));
+    LE_ASSERT(mapRef->chainLengthPtr);
+
+    for (i = 0; i < bucketCount; i++)
+    {
+        mapRef->bucketsPtr[i] = LE_DLS_LIST_INIT;
+        mapRef->chainLengthPtr[i] = 0;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Looks up a key in one bucket of a chained map.
+ *
+ * @return  Returns the entry for the key, or NULL if not found
+ */
+//--------------------------------------------------------------------------------------------------
+static Entry_t* FindInBucket
+(
+    Hashmap_t* mapRef,
+    le_dls_List_t* listHeadPtr,
+    const void* keyPtr,
+    size_t hash
+)
+{
+    le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
+
+    while (theLinkPtr != NULL)
+    {
+        Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
+
+        if (EqualKeys(currentEntryPtr->keyPtr,
+                      currentEntryPtr->hash,
+                      keyPtr,
+                      hash,
+                      mapRef->equalsFuncPtr))
+        {
+            return currentEntryPtr;
+        }
+        theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
+    }
+
+    return NULL;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Looks up a key in a chained map.  If the map is being resized, the key's bucket in the old
+ * buckets is searched too.
+ *
+ * @return  Returns the entry for the key, or NULL if not found
+ */
+//--------------------------------------------------------------------------------------------------
+static Entry_t* FindEntry
+(
+    Hashmap_t* mapRef,
+    const void* keyPtr,
+    size_t hash,
+    le_dls_List_t** listHeadPtrPtr,     ///< [OUT] Bucket holding the entry (optional).
+    size_t** chainLengthPtrPtr          ///< [OUT] Chain length of that bucket (optional).
+)
+{
+    size_t index = CalculateIndex(mapRef->bucketCount, hash);
+    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
+    size_t* chainLengthPtr = &(mapRef->chainLengthPtr[index]);
+
+    HASHMAP_TRACE(
+        mapRef,
+        "Hashmap %s: Generated index of %zu for hash %zu",
+        mapRef->nameStr,
+        index,
+        hash
+    );
+
+    Entry_t* entryPtr = FindInBucket(mapRef, listHeadPtr, keyPtr, hash);
+
+    // Old buckets below the migration index have already been emptied.
+    if ((entryPtr == NULL) && (mapRef->oldBucketsPtr != NULL))
+    {
+        index = CalculateIndex(mapRef->oldBucketCount, hash);
+        if (index >= mapRef->migrateIndex)
+        {
+            listHeadPtr = &(mapRef->oldBucketsPtr[index]);
+            chainLengthPtr = &(mapRef->oldChainLengthPtr[index]);
+            entryPtr = FindInBucket(mapRef, listHeadPtr, keyPtr, hash);
+        }
+    }
+
+    if (entryPtr != NULL)
+    {
+        if (listHeadPtrPtr != NULL)
+        {
+            *listHeadPtrPtr = listHeadPtr;
+        }
+        if (chainLengthPtrPtr != NULL)
+        {
+            *chainLengthPtrPtr = chainLengthPtr;
+        }
+    }
+
+    return entryPtr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Moves entries of a chained map that is being resized from the old buckets to the new ones.  The
+ * old buckets are freed once they are all empty.
+ *
+ * The entries stay in the map's entry list, so moving them does not disturb iterators.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RehashStep
+(
+    Hashmap_t* mapRef,
+    size_t maxEntries,          ///< [IN] Maximum number of entries to move.
+    size_t maxBuckets           ///< [IN] Maximum number of old buckets to empty.
+)
+{
+    if (mapRef->oldBucketsPtr == NULL)
+    {
+        return;
+    }
+
+    while ((mapRef->migrateIndex < mapRef->oldBucketCount) && (maxEntries > 0) && (maxBuckets > 0))
+    {
+        le_dls_Link_t* linkPtr = le_dls_Pop(&(mapRef->oldBucketsPtr[mapRef->migrateIndex]));
+
+        if (linkPtr == NULL)
+        {
+            mapRef->migrateIndex++;
+            maxBuckets--;
+        }
+        else
+        {
+            Entry_t* entryPtr = CONTAINER_OF(linkPtr, Entry_t, entryListLink);
+            size_t index = CalculateIndex(mapRef->bucketCount, entryPtr->hash);
+
+            mapRef->oldChainLengthPtr[mapRef->migrateIndex]--;
+            le_dls_Queue(&(mapRef->bucketsPtr[index]), linkPtr);
+            mapRef->chainLengthPtr[index]++;
+            maxEntries--;
+        }
+    }
+
+    if (mapRef->migrateIndex >= mapRef->oldBucketCount)
+    {
+        free(mapRef->oldBucketsPtr);
+        free(mapRef->oldChainLengthPtr);
+        mapRef->oldBucketsPtr = NULL;
+        mapRef->oldChainLengthPtr = NULL;
+        mapRef->oldBucketCount = 0;
+        mapRef->migrateIndex = 0;
+
+        HASHMAP_TRACE(
+            mapRef,
+            "Hashmap %s: Finished resizing to %zu buckets",
+            mapRef->nameStr,
+            mapRef->bucketCount
+        );
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Starts resizing a chained map if its load factor has gone out of bounds.  The map grows when it
+ * is loaded beyond 0.75 (the load factor it is created with), and shrinks back when it is loaded
+ * below 0.125, but never below its size at creation.
+ *
+ * Only the new buckets are allocated here; the entries are then moved over a few at a time by
+ * RehashStep() as the map is modified.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ResizeIfNeeded
+(
+    Hashmap_t* mapRef
+)
+{
+    size_t bucketCount = mapRef->bucketCount;
+
+    if (mapRef->size > (bucketCount - (bucketCount / 4)))
+    {
+        bucketCount <<= 1;
+    }
+    else if ((mapRef->size < (bucketCount / 8)) &&
+             (bucketCount > mapRef->minBucketCount) &&
+             (mapRef->oldBucketsPtr == NULL))
+    {
+        bucketCount >>= 1;
+    }
+    else
+    {
+        return;
+    }
+
+    // Only one resize can be in progress at a time.
+    RehashStep(mapRef, SIZE_MAX, SIZE_MAX);
+
+    mapRef->oldBucketsPtr = mapRef->bucketsPtr;
+    mapRef->oldChainLengthPtr = mapRef->chainLengthPtr;
+    mapRef->oldBucketCount = mapRef->bucketCount;
+    mapRef->migrateIndex = 0;
+    AllocBuckets(mapRef, bucketCount);
+    mapRef->resizeCount++;
+
+    HASHMAP_TRACE(
+        mapRef,
+        "Hashmap %s: Resizing from %zu to %zu buckets for %zu entries",
+        mapRef->nameStr,
+        mapRef->oldBucketCount,
+        mapRef->bucketCount,
+        mapRef->size
+    );
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Create a HashMap
@@ -165,6 +899,15 @@ le_hashmap_Ref_t le_hashmap_Create
     LE_ASSERT(mapRef);
 
     mapRef->traceRef = NULL;
+    mapRef->slotsPtr = NULL;
+    mapRef->entriesPtr = NULL;
+    mapRef->entryCount = 0;
+    mapRef->entryCapacity = 0;
+    mapRef->oldBucketsPtr = NULL;
+    mapRef->oldChainLengthPtr = NULL;
+    mapRef->oldBucketCount = 0;
+    mapRef->migrateIndex = 0;
+    mapRef->resizeCount = 0;
 
     /**
      * 0.75 load factor. We have more buckets than expected keys as we want
@@ -174,10 +917,10 @@ le_hashmap_Ref_t le_hashmap_Create
      */
     capacity = (capacity < 3)? 3 : capacity;
     size_t minimumBucketCount = capacity * 4 / 3;
-    mapRef->bucketCount = 1;
-    while (mapRef->bucketCount <= minimumBucketCount) {
+    size_t bucketCount = 1;
+    while (bucketCount <= minimumBucketCount) {
         // Bucket count must be power of 2.
-        mapRef->bucketCount <<= 1;
+        bucketCount <<= 1;
     }
 
     /**
@@ -190,24 +933,72 @@ le_hashmap_Ref_t le_hashmap_Create
     le_utf8_Append(poolName, nameStr, sizeof(poolName), NULL);
     mapRef->entryPoolRef = le_mem_ExpandPool(le_mem_CreatePool(poolName,
                                                                sizeof(Entry_t)),
-                                                               mapRef->bucketCount / 2);
-    le_mem_SetNumObjsToForce(mapRef->entryPoolRef, mapRef->bucketCount / 8);
+                                                               bucketCount / 2);
+    le_mem_SetNumObjsToForce(mapRef->entryPoolRef, bucketCount / 8);
+
+    AllocBuckets(mapRef, bucketCount);
+    mapRef->minBucketCount = bucketCount;
+    mapRef->entryList = LE_DLS_LIST_INIT;
 
-    mapRef->bucketsPtr = malloc(mapRef->bucketCount * sizeof(le_dls_List_t));
-    LE_ASSERT(mapRef->bucketsPtr);
-    mapRef->chainLengthPtr = malloc(mapRef->bucketCount * sizeof(size_t));
-    LE_ASSERT(mapRef->chainLengthPtr);
     mapRef->iteratorPtr = malloc(sizeof(HashmapIt_t));
     LE_ASSERT(mapRef->iteratorPtr);
 
-    uint32_t i = 0;
-    for (i=0; i<mapRef->bucketCount; i++)
+    mapRef->size = 0;
+
+    mapRef->hashFuncPtr = hashFunc;
+    mapRef->equalsFuncPtr = equalsFunc;
+    mapRef->nameStr = nameStr;
+
+    memset(mapRef->iteratorPtr, 0, sizeof(HashmapIt_t));
+    mapRef->iteratorPtr->theMapPtr = mapRef;
+    mapRef->iteratorPtr->currentIndex = -1;
+    mapRef->iteratorPtr->isValueValid = true;
+
+    AddToMapList(mapRef);
+
+    return mapRef;
+}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a compact HashMap, which uses open addressing and grows as entries are added.
+ *
+ * @return  Returns a reference to the map.
+ *
+ * @note Terminates the process on failure, so no need to check the return value for errors.
+ */
+//--------------------------------------------------------------------------------------------------
+le_hashmap_Ref_t le_hashmap_CreateCompact
+(
+    const char*                nameStr,          ///< [in] Name of the HashMap
+    size_t                     capacity,         ///< [in] Expected capacity of the map
+    le_hashmap_HashFunc_t      hashFunc,         ///< [in] The hash function
+    le_hashmap_EqualsFunc_t    equalsFunc        ///< [in] The equality function
+)
+{
+    LE_ASSERT(hashFunc);
+    LE_ASSERT(equalsFunc);
+
+    // It is ok to use malloc here as we will not be destroying the map
+    le_hashmap_Ref_t mapRef = malloc(sizeof(Hashmap_t));
+    LE_ASSERT(mapRef);
+    memset(mapRef, 0, sizeof(Hashmap_t));
+
+    mapRef->bucketCount = COMPACT_MIN_SLOT_COUNT;
+    while (COMPACT_MAX_ENTRIES(mapRef->bucketCount) < capacity)
     {
-        mapRef->bucketsPtr[i] = LE_DLS_LIST_INIT;
-        mapRef->chainLengthPtr[i] = 0;
+        LE_ASSERT(mapRef->bucketCount < COMPACT_MAX_SLOT_COUNT);
+        mapRef->bucketCount <<= 1;
     }
+    mapRef->minBucketCount = mapRef->bucketCount;
 
-    mapRef->size = 0;
+    mapRef->entryCapacity = COMPACT_MAX_ENTRIES(mapRef->bucketCount);
+    mapRef->entriesPtr = malloc(mapRef->entryCapacity * sizeof(CompactEntry_t));
+    LE_ASSERT(mapRef->entriesPtr);
+    mapRef->slotsPtr = calloc(mapRef->bucketCount, sizeof(CompactSlot_t));
+    LE_ASSERT(mapRef->slotsPtr);
+    mapRef->iteratorPtr = malloc(sizeof(HashmapIt_t));
+    LE_ASSERT(mapRef->iteratorPtr);
 
     mapRef->hashFuncPtr = hashFunc;
     mapRef->equalsFuncPtr = equalsFunc;
@@ -215,8 +1006,11 @@ le_hashmap_Ref_t le_hashmap_Create
 
     memset(mapRef->iteratorPtr, 0, sizeof(HashmapIt_t));
     mapRef->iteratorPtr->theMapPtr = mapRef;
+    mapRef->iteratorPtr->currentIndex = -1;
     mapRef->iteratorPtr->isValueValid = true;
 
+    AddToMapList(mapRef);
+
     return mapRef;
 }
 
@@ -237,98 +1031,53 @@ void* le_hashmap_Put
     const void* valuePtr       ///< [in] Pointer to the value to be stored
 )
 {
-    size_t hash = HashKey(mapRef, keyPtr);
-    size_t index = CalculateIndex(mapRef->bucketCount, hash);
+    if (IsCompact(mapRef))
+    {
+        return CompactPut(mapRef, keyPtr, valuePtr);
+    }
 
-    HASHMAP_TRACE(
-        mapRef,
-        "Hashmap %s: Generated index of %zu for hash %u",
-        mapRef->nameStr,
-        index,
-        (int)hash
-    );
+    RehashStep(mapRef, REHASH_STEP_ENTRIES, REHASH_STEP_BUCKETS);
 
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
+    size_t hash = HashKey(mapRef, keyPtr);
+    Entry_t* entryPtr = FindEntry(mapRef, keyPtr, hash, NULL, NULL);
 
-    if (le_dls_NumLinks(listHeadPtr) == 0)
+    // Replace existing value if the keys match.
+    if (entryPtr != NULL)
     {
-        Entry_t* newEntryPtr = CreateEntry(keyPtr, hash, valuePtr, mapRef->entryPoolRef);
-        LE_ASSERT(newEntryPtr);
-
-        le_dls_Stack(listHeadPtr, &(newEntryPtr->entryListLink));
-        mapRef->size++;
+        const void* oldValue = entryPtr->valuePtr;
+        entryPtr->valuePtr = valuePtr;
 
         HASHMAP_TRACE(
             mapRef,
-            "Hashmap %s: Added first entry to bucket. Total map size now %zu",
+            "Hashmap %s: Replaced entry in bucket. Total map size now %zu",
             mapRef->nameStr,
             mapRef->size
         );
 
-        mapRef->chainLengthPtr[index]++;
-
-        return NULL;
+        return (void *)oldValue;
     }
-    else
-    {
-        le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
-
-        while (true) {
-            Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-
-            // Replace existing value if the keys match.
-            if (EqualKeys(currentEntryPtr->keyPtr,
-                          currentEntryPtr->hash,
-                          keyPtr,
-                          hash,
-                          mapRef->equalsFuncPtr)
-                          )
-            {
-                const void* oldValue = currentEntryPtr->valuePtr;
-                currentEntryPtr->valuePtr = valuePtr;
 
-                HASHMAP_TRACE(
-                    mapRef,
-                    "Hashmap %s: Replaced entry in bucket. Total map size now %zu",
-                    mapRef->nameStr,
-                    mapRef->size
-                );
-
-                return (void *)oldValue;
-            }
-
-            // Add a new entry if we are at the tail
-            if (le_dls_PeekNext(listHeadPtr, theLinkPtr) == NULL) {
-                Entry_t* newEntryPtr = CreateEntry(keyPtr, hash, valuePtr, mapRef->entryPoolRef);
-                LE_ASSERT(newEntryPtr);
-
-                le_dls_Queue(listHeadPtr, &(newEntryPtr->entryListLink));
-                mapRef->size++;
-
-                HASHMAP_TRACE(
-                    mapRef,
-                    "Hashmap %s: Added entry to bucket at tail. Map size now %zu",
-                    mapRef->nameStr,
-                    mapRef->size
-                );
-
-                mapRef->chainLengthPtr[index]++;
+    // New entries always go into the current buckets, even while the map is being resized.
+    size_t index = CalculateIndex(mapRef->bucketCount, hash);
 
-                HASHMAP_TRACE(
-                    mapRef,
-                    "Hashmap %s: Bucket now contains %zu entries (%zu)",
-                    mapRef->nameStr,
-                    le_dls_NumLinks(listHeadPtr),
-                    mapRef->chainLengthPtr[index]
-                );
+    entryPtr = CreateEntry(keyPtr, hash, valuePtr, mapRef->entryPoolRef);
+    le_dls_Queue(&(mapRef->bucketsPtr[index]), &(entryPtr->entryListLink));
+    le_dls_Queue(&(mapRef->entryList), &(entryPtr->iterLink));
+    mapRef->chainLengthPtr[index]++;
+    mapRef->size++;
 
-                return NULL;
-            }
+    HASHMAP_TRACE(
+        mapRef,
+        "Hashmap %s: Added entry to bucket %zu. Map size now %zu, bucket contains %zu entries",
+        mapRef->nameStr,
+        index,
+        mapRef->size,
+        mapRef->chainLengthPtr[index]
+    );
 
-            // Move to next entry.
-            theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
-        }
-    }
+    ResizeIfNeeded(mapRef);
+
+    return NULL;
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -346,43 +1095,23 @@ void* le_hashmap_Get
     const void* keyPtr         ///< [in] Pointer to the key to be retrieved
 )
 {
-    size_t hash = HashKey(mapRef, keyPtr);
-    size_t index = CalculateIndex(mapRef->bucketCount, hash);
-    HASHMAP_TRACE(
-        mapRef,
-        "Hashmap %s: Generated index of %zu for hash %zu",
-        mapRef->nameStr,
-        index,
-        hash
-    );
+    if (IsCompact(mapRef))
+    {
+        CompactEntry_t* entryPtr = CompactGet(mapRef, keyPtr);
 
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
-    HASHMAP_TRACE(
-        mapRef,
-        "Hashmap %s: Looked up list contains %zu links",
-        mapRef->nameStr,
-        le_dls_NumLinks(listHeadPtr)
-    );
+        return (entryPtr == NULL) ? NULL : (void*)(entryPtr->valuePtr);
+    }
 
-    le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
+    Entry_t* entryPtr = FindEntry(mapRef, keyPtr, HashKey(mapRef, keyPtr), NULL, NULL);
 
-    while (theLinkPtr != NULL) {
-        Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-        if (EqualKeys(currentEntryPtr->keyPtr,
-                          currentEntryPtr->hash,
-                          keyPtr,
-                          hash,
-                          mapRef->equalsFuncPtr)
-                          )
-        {
-            HASHMAP_TRACE(
-                mapRef,
-                "Hashmap %s: Returning found value for key",
-                mapRef->nameStr
-            );
-            return (void*)(currentEntryPtr->valuePtr);
-        }
-        theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
+    if (entryPtr != NULL)
+    {
+        HASHMAP_TRACE(
+            mapRef,
+            "Hashmap %s: Returning found value for key",
+            mapRef->nameStr
+        );
+        return (void*)(entryPtr->valuePtr);
     }
 
     HASHMAP_TRACE(
@@ -408,43 +1137,23 @@ void* le_hashmap_GetStoredKey
     const void* keyPtr         ///< [in] Pointer to the key to be retrieved.
 )
 {
-    size_t hash = HashKey(mapRef, keyPtr);
-    size_t index = CalculateIndex(mapRef->bucketCount, hash);
-    HASHMAP_TRACE(
-        mapRef,
-        "Hashmap %s: Generated index of %zu for hash %zu",
-        mapRef->nameStr,
-        index,
-        hash
-    );
+    if (IsCompact(mapRef))
+    {
+        CompactEntry_t* entryPtr = CompactGet(mapRef, keyPtr);
 
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
-    HASHMAP_TRACE(
-        mapRef,
-        "Hashmap %s: Looked up list contains %zu links",
-        mapRef->nameStr,
-        le_dls_NumLinks(listHeadPtr)
-    );
+        return (entryPtr == NULL) ? NULL : (void*)(entryPtr->keyPtr);
+    }
 
-    le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
+    Entry_t* entryPtr = FindEntry(mapRef, keyPtr, HashKey(mapRef, keyPtr), NULL, NULL);
 
-    while (theLinkPtr != NULL) {
-        Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-        if (EqualKeys(currentEntryPtr->keyPtr,
-                          currentEntryPtr->hash,
-                          keyPtr,
-                          hash,
-                          mapRef->equalsFuncPtr)
-                          )
-        {
-            HASHMAP_TRACE(
-                mapRef,
-                "Hashmap %s: Returning original key",
-                mapRef->nameStr
-            );
-            return (void*)(currentEntryPtr->keyPtr);
-        }
-        theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
+    if (entryPtr != NULL)
+    {
+        HASHMAP_TRACE(
+            mapRef,
+            "Hashmap %s: Returning original key",
+            mapRef->nameStr
+        );
+        return (void*)(entryPtr->keyPtr);
     }
 
     HASHMAP_TRACE(
@@ -473,58 +1182,59 @@ void* le_hashmap_Remove
    const void* keyPtr       ///< [in] Pointer to the key to be removed
 )
 {
-    int hash = HashKey(mapRef, keyPtr);
-    size_t index = CalculateIndex(mapRef->bucketCount, hash);
-
-    HASHMAP_TRACE(
-        mapRef,
-        "Hashmap %s: Generated index of %zu for hash %u",
-        mapRef->nameStr,
-        index,
-        hash
-    );
+    if (IsCompact(mapRef))
+    {
+        return CompactRemove(mapRef, keyPtr);
+    }
 
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
-    le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
+    RehashStep(mapRef, REHASH_STEP_ENTRIES, REHASH_STEP_BUCKETS);
 
-    while (theLinkPtr != NULL) {
-        Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-        if (EqualKeys(currentEntryPtr->keyPtr,
-                          currentEntryPtr->hash,
-                          keyPtr,
-                          hash,
-                          mapRef->equalsFuncPtr)
-                          )
-        {
-            if (mapRef->iteratorPtr->currentLinkPtr == theLinkPtr)
-            {
-                le_hashmap_PrevNode(mapRef->iteratorPtr);
-                mapRef->iteratorPtr->isValueValid = false;
-            }
+    le_dls_List_t* listHeadPtr;
+    size_t* chainLengthPtr;
+    Entry_t* entryPtr = FindEntry(mapRef, keyPtr, HashKey(mapRef, keyPtr),
+                                  &listHeadPtr, &chainLengthPtr);
 
-            void* value = (void*)(currentEntryPtr->valuePtr);
-            le_dls_Remove(listHeadPtr, theLinkPtr);
-            le_mem_Release( currentEntryPtr );
-            mapRef->size--;
-            mapRef->chainLengthPtr[index]--;
+    if (entryPtr == NULL)
+    {
+        HASHMAP_TRACE(
+            mapRef,
+            "Hashmap %s: Key not found",
+            mapRef->nameStr
+        );
+        return NULL;
+    }
 
-            HASHMAP_TRACE(
-                mapRef,
-                "Hashmap %s: Removing key from map",
-                mapRef->nameStr
-            );
+    HashmapIt_t* iteratorPtr = mapRef->iteratorPtr;
 
-            return value;
+    // Move the iterator back so that the next call to le_hashmap_NextNode() moves it to the entry
+    // after the removed one.
+    if (iteratorPtr->currentLinkPtr == &(entryPtr->iterLink))
+    {
+        iteratorPtr->currentLinkPtr = le_dls_PeekPrev(&(mapRef->entryList),
+                                                      &(entryPtr->iterLink));
+        if (iteratorPtr->currentLinkPtr == NULL)
+        {
+            iteratorPtr->currentIndex = -1;
         }
-        theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
+        iteratorPtr->isValueValid = false;
     }
 
+    void* value = (void*)(entryPtr->valuePtr);
+    le_dls_Remove(listHeadPtr, &(entryPtr->entryListLink));
+    le_dls_Remove(&(mapRef->entryList), &(entryPtr->iterLink));
+    le_mem_Release(entryPtr);
+    mapRef->size--;
+    (*chainLengthPtr)--;
+
     HASHMAP_TRACE(
         mapRef,
-        "Hashmap %s: Key not found",
+        "Hashmap %s: Removing key from map",
         mapRef->nameStr
     );
-    return NULL;
+
+    ResizeIfNeeded(mapRef);
+
+    return value;
 }
 
 
@@ -577,38 +1287,20 @@ bool le_hashmap_ContainsKey
     const void* keyPtr        ///< [in] Pointer to the key to be searched for
 )
 {
-    int hash = HashKey(mapRef, keyPtr);
-    size_t index = CalculateIndex(mapRef->bucketCount, hash);
-
-    HASHMAP_TRACE(
-        mapRef,
-        "Hashmap %s: Generated index of %zu for hash %u",
-        mapRef->nameStr,
-        index,
-        hash
-    );
-
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
-    le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
+    if (IsCompact(mapRef))
+    {
+        return (CompactGet(mapRef, keyPtr) != NULL);
+    }
 
-    while (theLinkPtr != NULL) {
-        Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-        if (EqualKeys(currentEntryPtr->keyPtr,
-                          currentEntryPtr->hash,
-                          keyPtr,
-                          hash,
-                          mapRef->equalsFuncPtr)
-                          )
-        {
-            HASHMAP_TRACE(
-                mapRef,
-                "Hashmap %s: Key found",
-                mapRef->nameStr
-            );
+    if (FindEntry(mapRef, keyPtr, HashKey(mapRef, keyPtr), NULL, NULL) != NULL)
+    {
+        HASHMAP_TRACE(
+            mapRef,
+            "Hashmap %s: Key found",
+            mapRef->nameStr
+        );
 
-            return true;
-        }
-        theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
+        return true;
     }
 
     HASHMAP_TRACE(
@@ -641,18 +1333,36 @@ void le_hashmap_RemoveAll
     mapRef->iteratorPtr->currentLinkPtr = NULL;
     mapRef->iteratorPtr->currentEntryPtr = NULL;
 
+    if (IsCompact(mapRef))
+    {
+        memset(mapRef->slotsPtr, 0, mapRef->bucketCount * sizeof(CompactSlot_t));
+        mapRef->entryCount = 0;
+        mapRef->size = 0;
+
+        HASHMAP_TRACE(
+           mapRef,
+           "Hashmap %s: All entries deleted from map",
+           mapRef->nameStr
+        );
+        return;
+    }
+
+    le_dls_Link_t* theLinkPtr = le_dls_Pop(&(mapRef->entryList));
+
+    while (theLinkPtr != NULL) {
+        le_mem_Release(CONTAINER_OF(theLinkPtr, Entry_t, iterLink));
+        theLinkPtr = le_dls_Pop(&(mapRef->entryList));
+    }
+
+    // Drop any resize in progress, as there is nothing left to move.
+    if (mapRef->oldBucketsPtr != NULL)
+    {
+        mapRef->migrateIndex = mapRef->oldBucketCount;
+        RehashStep(mapRef, 0, 0);
+    }
+
     uint32_t i;
     for (i = 0; i < mapRef->bucketCount; i++) {
-        le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[i]);
-        le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
-
-        while (theLinkPtr != NULL) {
-            Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-            le_dls_Link_t* linkPtrToRemove = theLinkPtr;
-            theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
-            le_dls_Remove(listHeadPtr, linkPtrToRemove);
-            le_mem_Release( currentEntryPtr );
-        }
         mapRef->bucketsPtr[i] = LE_DLS_LIST_INIT;
         mapRef->chainLengthPtr[i] = 0;
     }
@@ -682,25 +1392,33 @@ bool le_hashmap_ForEach
     void* context                            ///< [in] Pointer to a context to be supplied to the callback
 )
 {
-    uint32_t i;
-    for (i = 0; i < mapRef->bucketCount; i++) {
-        le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[i]);
-        le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
-
-        while (theLinkPtr != NULL) {
-            Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-            if (!forEachFn(currentEntryPtr->keyPtr, currentEntryPtr->valuePtr, context)) {
-                // Check to see if this is the last element, and return false if not.
-                if (le_dls_PeekNext(listHeadPtr, theLinkPtr) != NULL) { return false; }
-                uint32_t j;
-                for (j = i; j < mapRef->bucketCount; ++j)
-                {
-                    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[j]);
-                    if (le_dls_Peek(listHeadPtr)) { return false; }
-                }
-                return true;   // Despite stopping early, all elements have been examined.
+    if (IsCompact(mapRef))
+    {
+        size_t entryIndex = CompactNextEntry(mapRef, 0);
+
+        while (entryIndex < mapRef->entryCount)
+        {
+            CompactEntry_t* entryPtr = &(mapRef->entriesPtr[entryIndex]);
+
+            entryIndex = CompactNextEntry(mapRef, entryIndex + 1);
+            if (!forEachFn(entryPtr->keyPtr, entryPtr->valuePtr, context))
+            {
+                // Despite stopping early, all elements may have been examined.
+                return (entryIndex >= mapRef->entryCount);
             }
-            theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
+        }
+        return true;
+    }
+
+    le_dls_Link_t* theLinkPtr = le_dls_Peek(&(mapRef->entryList));
+
+    while (theLinkPtr != NULL) {
+        Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, iterLink);
+
+        theLinkPtr = le_dls_PeekNext(&(mapRef->entryList), theLinkPtr);
+        if (!forEachFn(currentEntryPtr->keyPtr, currentEntryPtr->valuePtr, context)) {
+            // Despite stopping early, all elements may have been examined.
+            return (theLinkPtr == NULL);
         }
     }
 
@@ -726,6 +1444,7 @@ le_hashmap_It_Ref_t le_hashmap_GetIterator
 {
     // Set the counter to -1 so that we know the iterator is at the start
     mapRef->iteratorPtr->currentIndex = -1;
+    mapRef->iteratorPtr->currentLinkPtr = NULL;
     // Mark the iterator as valid
     mapRef->iteratorPtr->isValueValid = true;
 
@@ -735,8 +1454,8 @@ le_hashmap_It_Ref_t le_hashmap_GetIterator
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Moves the iterator to the next key/value pair in the map. Order is dependent
- * on the hash algorithm and the order of inserts and is not sorted at all.
+ * Moves the iterator to the next key/value pair in the map. Key/value pairs are visited in the
+ * order in which they were added to the map.
  *
  * @return  Returns LE_OK unless you go past the end of the map, then returns LE_NOT_FOUND
  *
@@ -756,67 +1475,56 @@ le_result_t le_hashmap_NextNode
         return LE_NOT_FOUND;
     }
 
+    if (IsCompact(iteratorRef->theMapPtr))
+    {
+        Hashmap_t* mapRef = iteratorRef->theMapPtr;
+        size_t entryIndex = CompactNextEntry(mapRef, iteratorRef->currentIndex + 1);
+
+        if (entryIndex < mapRef->entryCount)
+        {
+            iteratorRef->currentIndex = entryIndex;
+            return LE_OK;
+        }
+
+        // Leave the iterator past the end so that le_hashmap_PrevNode() finds the last entry.
+        iteratorRef->currentIndex = mapRef->entryCount;
+        iteratorRef->isValueValid = false;
+        return LE_NOT_FOUND;
+    }
+
+    le_dls_List_t* listPtr = &(iteratorRef->theMapPtr->entryList);
     le_dls_Link_t* theLinkPtr = NULL;
 
-    // -1 indicates the iterator is new
-    if (iteratorRef->currentIndex != -1) {
-        // Check if the current entry is at the end of a list
-        theLinkPtr = le_dls_PeekNext(iteratorRef->currentListPtr, iteratorRef->currentLinkPtr);
+    // -1 indicates the iterator is new, and a NULL link at index 1 that it is past the end
+    if (iteratorRef->currentIndex == -1) {
+        theLinkPtr = le_dls_Peek(listPtr);
+    }
+    else if (iteratorRef->currentLinkPtr != NULL) {
+        theLinkPtr = le_dls_PeekNext(listPtr, iteratorRef->currentLinkPtr);
     }
 
     if (NULL == theLinkPtr)
     {
-        // Find the next list head
-        for (
-               iteratorRef->currentIndex = iteratorRef->currentIndex + 1;
-               iteratorRef->currentIndex < iteratorRef->theMapPtr->bucketCount;
-               iteratorRef->currentIndex++ )
-        {
-            le_dls_List_t* listHeadPtr = &(iteratorRef->theMapPtr->bucketsPtr[iteratorRef->currentIndex]);
-            theLinkPtr = le_dls_Peek(listHeadPtr);
-
-            if (NULL != theLinkPtr)
-            {
-                Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-                iteratorRef->currentLinkPtr = theLinkPtr;
-                iteratorRef->currentEntryPtr = currentEntryPtr;
-                iteratorRef->currentListPtr = listHeadPtr;
-
-                HASHMAP_TRACE(
-                    iteratorRef->theMapPtr,
-                    "Found index head match, index is %d",
-                    iteratorRef->currentIndex
-                );
-                return LE_OK;
-            }
-        }
+        // At the end without finding another entry, need to invalidate the iterator.  Leave it
+        // past the end so that le_hashmap_PrevNode() finds the last entry.
+        iteratorRef->currentIndex = 1;
+        iteratorRef->currentLinkPtr = NULL;
+        iteratorRef->isValueValid = false;
+        return LE_NOT_FOUND;
     }
-    else
-    {
-        Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-        iteratorRef->currentLinkPtr = theLinkPtr;
-        iteratorRef->currentEntryPtr = currentEntryPtr;
-        // No change to the current list head pointer as we're in the same list
-
-        HASHMAP_TRACE(
-            iteratorRef->theMapPtr,
-            "Found index list match, index is %d",
-            iteratorRef->currentIndex
-        );
 
-        return LE_OK;
-    }
+    iteratorRef->currentIndex = 0;
+    iteratorRef->currentLinkPtr = theLinkPtr;
+    iteratorRef->currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, iterLink);
 
-    // At the end without finding another entry, need to invalidate the iterator
-    iteratorRef->isValueValid = false;
-    return LE_NOT_FOUND;
+    return LE_OK;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Moves the iterator to the previous key/value pair in the map. Order is dependent
- * on the hash algorithm and the order of inserts, and is not sorted at all.
+ * Moves the iterator to the previous key/value pair in the map. Key/value pairs are visited in the
+ * reverse of the order in which they were added to the map.
  *
  * @return  Returns LE_OK unless you go past the beginning of the map, then returns LE_NOT_FOUND.
  *
@@ -840,55 +1548,54 @@ le_result_t le_hashmap_PrevNode
         return LE_NOT_FOUND;
     }
 
-    le_dls_Link_t* theLinkPtr = le_dls_PeekPrev(iteratorRef->currentListPtr,
-                                                iteratorRef->currentLinkPtr);
-
-    if (NULL == theLinkPtr)
+    if (IsCompact(iteratorRef->theMapPtr))
     {
-        // Find the previous list tail.
-        for (
-               iteratorRef->currentIndex = iteratorRef->currentIndex - 1;
-               iteratorRef->currentIndex >= 0;
-               iteratorRef->currentIndex-- )
+        Hashmap_t* mapRef = iteratorRef->theMapPtr;
+        int32_t entryIndex = iteratorRef->currentIndex;
+
+        if (entryIndex > (int32_t)mapRef->entryCount)
         {
-            le_dls_List_t* listHeadPtr = &(iteratorRef->theMapPtr->bucketsPtr[iteratorRef->currentIndex]);
-            theLinkPtr = le_dls_PeekTail(listHeadPtr);
+            entryIndex = mapRef->entryCount;
+        }
 
-            if (NULL != theLinkPtr)
+        for (entryIndex--; entryIndex >= 0; entryIndex--)
+        {
+            if (mapRef->entriesPtr[entryIndex].keyPtr != REMOVED_KEY_PTR)
             {
-                Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-                iteratorRef->currentLinkPtr = theLinkPtr;
-                iteratorRef->currentEntryPtr = currentEntryPtr;
-                iteratorRef->currentListPtr = listHeadPtr;
-
-                HASHMAP_TRACE(
-                    iteratorRef->theMapPtr,
-                    "Found index head match, index is %d",
-                    iteratorRef->currentIndex
-                );
+                iteratorRef->currentIndex = entryIndex;
                 return LE_OK;
             }
         }
+
+        iteratorRef->currentIndex = -1;
+        iteratorRef->isValueValid = false;
+        return LE_NOT_FOUND;
     }
-    else
-    {
-        Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-        iteratorRef->currentLinkPtr = theLinkPtr;
-        iteratorRef->currentEntryPtr = currentEntryPtr;
-        // No change to the current list head pointer as we're in the same list
 
-        HASHMAP_TRACE(
-            iteratorRef->theMapPtr,
-            "Found index list match, index is %d",
-            iteratorRef->currentIndex
-        );
+    le_dls_List_t* listPtr = &(iteratorRef->theMapPtr->entryList);
+    le_dls_Link_t* theLinkPtr;
 
-        return LE_OK;
+    if (iteratorRef->currentLinkPtr == NULL) {
+        theLinkPtr = le_dls_PeekTail(listPtr);
+    }
+    else {
+        theLinkPtr = le_dls_PeekPrev(listPtr, iteratorRef->currentLinkPtr);
+    }
+
+    if (NULL == theLinkPtr)
+    {
+        // At the beginning, without finding another entry, need to invalidate the iterator.
+        iteratorRef->currentIndex = -1;
+        iteratorRef->currentLinkPtr = NULL;
+        iteratorRef->isValueValid = false;
+        return LE_NOT_FOUND;
     }
 
-    // At the beginning, without finding another entry, need to invalidate the iterator.
-    iteratorRef->isValueValid = false;
-    return LE_NOT_FOUND;
+    iteratorRef->currentIndex = 0;
+    iteratorRef->currentLinkPtr = theLinkPtr;
+    iteratorRef->currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, iterLink);
+
+    return LE_OK;
 }
 
 
@@ -907,6 +1614,11 @@ const void* le_hashmap_GetKey
 {
     if (!iteratorRef->isValueValid || (iteratorRef->currentIndex == -1)) return NULL;
 
+    if (IsCompact(iteratorRef->theMapPtr))
+    {
+        return iteratorRef->theMapPtr->entriesPtr[iteratorRef->currentIndex].keyPtr;
+    }
+
     return iteratorRef->currentEntryPtr->keyPtr;
 }
 
@@ -925,6 +1637,11 @@ void* le_hashmap_GetValue
 {
     if (!iteratorRef->isValueValid || (iteratorRef->currentIndex == -1)) return NULL;
 
+    if (IsCompact(iteratorRef->theMapPtr))
+    {
+        return (void*)iteratorRef->theMapPtr->entriesPtr[iteratorRef->currentIndex].valuePtr;
+    }
+
     // Need to cast away the const
     return (void*)iteratorRef->currentEntryPtr->valuePtr;
 }
@@ -962,23 +1679,23 @@ le_result_t le_hashmap_GetFirstNode
         return LE_BAD_PARAMETER;
     }
 
-    // Find the first list head
-    size_t index = 0;
-    for (
-           ;
-           index < mapRef->bucketCount;
-           index++ )
+    if (IsCompact(mapRef))
     {
-        le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
-        le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
+        CompactEntry_t* entryPtr = &(mapRef->entriesPtr[CompactNextEntry(mapRef, 0)]);
 
-        if (NULL != theLinkPtr)
+        *firstKeyPtr = (void *)entryPtr->keyPtr;
+        if (NULL != firstValuePtr)
         {
-            Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-            *firstKeyPtr = (void *)currentEntryPtr->keyPtr;
-            *firstValuePtr = (void *)currentEntryPtr->valuePtr;
-            break;
+            *firstValuePtr = (void *)entryPtr->valuePtr;
         }
+        return LE_OK;
+    }
+
+    Entry_t* currentEntryPtr = CONTAINER_OF(le_dls_Peek(&(mapRef->entryList)), Entry_t, iterLink);
+    *firstKeyPtr = (void *)currentEntryPtr->keyPtr;
+    if (NULL != firstValuePtr)
+    {
+        *firstValuePtr = (void *)currentEntryPtr->valuePtr;
     }
     return LE_OK;
 };
@@ -1015,84 +1732,53 @@ le_result_t le_hashmap_GetNodeAfter
         return LE_BAD_PARAMETER;
     }
 
-    // Find the node pointed to by the key
-    size_t hash = HashKey(mapRef, keyPtr);
-    size_t index = CalculateIndex(mapRef->bucketCount, hash);
-    HASHMAP_TRACE(
-        mapRef,
-        "Hashmap %s: Generated index of %zu for hash %zu",
-        mapRef->nameStr,
-        index,
-        hash
-    );
+    if (IsCompact(mapRef))
+    {
+        CompactEntry_t* entryPtr = CompactGet(mapRef, keyPtr);
 
-    le_dls_List_t* listHeadPtr = &(mapRef->bucketsPtr[index]);
-    HASHMAP_TRACE(
-        mapRef,
-        "Hashmap %s: Looked up list contains %zu links",
-        mapRef->nameStr,
-        le_dls_NumLinks(listHeadPtr)
-    );
+        if (NULL == entryPtr)
+        {
+            return LE_BAD_PARAMETER;
+        }
 
-    le_dls_Link_t* theLinkPtr = le_dls_Peek(listHeadPtr);
+        size_t entryIndex = CompactNextEntry(mapRef, (entryPtr - mapRef->entriesPtr) + 1);
+        if (entryIndex >= mapRef->entryCount)
+        {
+            return LE_NOT_FOUND;
+        }
 
-    while (theLinkPtr != NULL) {
-        Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-        if (EqualKeys(currentEntryPtr->keyPtr,
-                          currentEntryPtr->hash,
-                          keyPtr,
-                          hash,
-                          mapRef->equalsFuncPtr)
-                          )
+        *nextKeyPtr = (void *)mapRef->entriesPtr[entryIndex].keyPtr;
+        if (NULL != nextValuePtr)
         {
-            HASHMAP_TRACE(
-                mapRef,
-                "Hashmap %s: Found value for key",
-                mapRef->nameStr
-            );
-            // Now find the next node, if there is one
-            theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
-            if (NULL == theLinkPtr)
-            {
-                // Find the next list head
-                for (
-                       index++;
-                       index < mapRef->bucketCount;
-                       index++ )
-                {
-                    listHeadPtr = &(mapRef->bucketsPtr[index]);
-                    theLinkPtr = le_dls_Peek(listHeadPtr);
-
-                    if (NULL != theLinkPtr)
-                    {
-                        Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-                        *nextKeyPtr = (void *)currentEntryPtr->keyPtr;
-                        if (NULL != nextValuePtr)
-                        {
-                            *nextValuePtr = (void *)currentEntryPtr->valuePtr;
-                        }
-                        return LE_OK;
-                    }
-                }
-                // There was no list head - we are off the end of the map
-                return LE_NOT_FOUND;
-            }
-            else
-            {
-                Entry_t* currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, entryListLink);
-                *nextKeyPtr = (void *)currentEntryPtr->keyPtr;
-                if (NULL != nextValuePtr)
-                {
-                    *nextValuePtr = (void *)currentEntryPtr->valuePtr;
-                }
-                return LE_OK;
-            }
+            *nextValuePtr = (void *)mapRef->entriesPtr[entryIndex].valuePtr;
         }
-        theLinkPtr = le_dls_PeekNext(listHeadPtr, theLinkPtr);
+        return LE_OK;
+    }
+
+    // Find the node pointed to by the key
+    Entry_t* currentEntryPtr = FindEntry(mapRef, keyPtr, HashKey(mapRef, keyPtr), NULL, NULL);
+
+    if (NULL == currentEntryPtr)
+    {
+        // The original key was never found
+        return LE_BAD_PARAMETER;
+    }
+
+    // Now find the next node, if there is one
+    le_dls_Link_t* theLinkPtr = le_dls_PeekNext(&(mapRef->entryList), &(currentEntryPtr->iterLink));
+    if (NULL == theLinkPtr)
+    {
+        // We are off the end of the map
+        return LE_NOT_FOUND;
     }
 
-    // The original key was never found
-    return LE_BAD_PARAMETER;
+    currentEntryPtr = CONTAINER_OF(theLinkPtr, Entry_t, iterLink);
+    *nextKeyPtr = (void *)currentEntryPtr->keyPtr;
+    if (NULL != nextValuePtr)
+    {
+        *nextValuePtr = (void *)currentEntryPtr->valuePtr;
+    }
+    return LE_OK;
 }
 
 
@@ -1112,11 +1798,31 @@ size_t le_hashmap_CountCollisions
 )
 {
     size_t i, collCount = 0;
+
+    // In a compact map, count the entries that are not stored in their home slot.
+    if (IsCompact(mapRef))
+    {
+        for (i = 0; i < mapRef->bucketCount; i++)
+        {
+            if ((mapRef->slotsPtr[i].entryNum != 0) && (SlotDistance(mapRef, i) != 0))
+            {
+                collCount++;
+            }
+        }
+        return collCount;
+    }
+
     for (i = 0; i < mapRef->bucketCount; i++) {
         if (mapRef->chainLengthPtr[i] > 1) {
             collCount += mapRef->chainLengthPtr[i] - 1;
         }
     }
+    // Include the buckets that have not been moved yet if the map is being resized.
+    for (i = mapRef->migrateIndex; i < mapRef->oldBucketCount; i++) {
+        if (mapRef->oldChainLengthPtr[i] > 1) {
+            collCount += mapRef->oldChainLengthPtr[i] - 1;
+        }
+    }
     return collCount;
 }
 
@@ -17,11 +17,16 @@ struct Entry {
     const void* keyPtr;
     size_t hash;
     const void* valuePtr;
-    le_dls_Link_t entryListLink;
+    le_dls_Link_t entryListLink;    ///< Link in the entry's bucket.
+    le_dls_Link_t iterLink;         ///< Link in the map's list of entries, in iteration order.
 };
 
 /**
  * A hashmap iterator
+ *
+ * For a chained map, currentIndex is -1 before the first entry, 0 on an entry and 1 past the last
+ * entry, and currentLinkPtr is the current entry's link in the map's entry list.  For a compact
+ * map, currentIndex is the position of the current entry in the entry array.
  */
 typedef struct le_hashmap_It {
     le_hashmap_Ref_t theMapPtr;
@@ -33,8 +38,35 @@ typedef struct le_hashmap_It {
 }
 HashmapIt_t;
 
+/**
+ * An entry of a compact (open addressing) hashmap.  Entries are stored contiguously in insertion
+ * order.  A removed entry is left in place as a hole until the entry array is compacted.
+ */
+typedef struct CompactEntry {
+    const void* keyPtr;
+    const void* valuePtr;
+    size_t hash;
+}
+CompactEntry_t;
+
+/**
+ * A slot in the index of a compact hashmap.  The index is a Robin Hood hash table of entry numbers.
+ */
+typedef struct CompactSlot {
+    uint32_t entryNum;      ///< Position of the entry in the entry array plus one, 0 if empty.
+    uint32_t hashTag;       ///< Low 32 bits of the entry's hash.
+}
+CompactSlot_t;
+
 /**
  *  The hashmap itself
+ *
+ *  Chained maps use bucketsPtr, chainLengthPtr and entryPoolRef.  While a chained map is being
+ *  resized, the entries that have not been moved yet are still in oldBucketsPtr, and the buckets
+ *  of oldBucketsPtr below migrateIndex are empty.
+ *
+ *  Compact maps use slotsPtr and entriesPtr instead, and bucketCount holds the number of slots in
+ *  their index.
  */
 typedef struct le_hashmap {
     size_t bucketCount;
@@ -47,6 +79,18 @@ typedef struct le_hashmap {
     const char* nameStr;
     HashmapIt_t* iteratorPtr;
     le_log_TraceRef_t traceRef;
+    CompactSlot_t* slotsPtr;
+    CompactEntry_t* entriesPtr;
+    size_t entryCount;
+    size_t entryCapacity;
+    le_dls_List_t* oldBucketsPtr;
+    size_t* oldChainLengthPtr;
+    size_t oldBucketCount;
+    size_t migrateIndex;
+    size_t minBucketCount;          ///< Bucket count at creation, the map never shrinks below it.
+    size_t resizeCount;             ///< Number of times the map has started resizing.
+    le_dls_List_t entryList;        ///< Entries of a chained map, in iteration order.
+    le_dls_Link_t mapLink;          ///< Link in the list of all hashmaps.
 }
 Hashmap_t;
 
@@ -62,4 +106,26 @@ void hashmap_Init
     void
 );
 
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exposing the hashmap list; mainly for the Inspect tool.
+ */
+//--------------------------------------------------------------------------------------------------
+le_dls_List_t* hashmap_GetMapList
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Exposing the hashmap list change counter; mainly for the Inspect tool.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t** hashmap_GetMapListChgCntRef
+(
+    void
+);
+
 #endif // _LEGATO_HASHMAP_H_INCLUDE_GUARD
@@ -13,6 +13,10 @@
 /// including the null terminator.
 #define MAX_STRING_BYTES 1024
 
+/// Number of bytes read at a time from file descriptors that can give back what is read past the
+/// end of the document.
+#define READ_CHUNK_BYTES 4096
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -52,9 +56,14 @@ typedef struct le_json_ParsingSession
 
     char buffer[MAX_STRING_BYTES];  ///< Buffer into which characters are copied
     size_t numBytes;                ///< # of bytes of content in the buffer.
+    bool escaped;                   ///< true if the last string character copied was an escape.
     double number;                  ///< Value of last number parsed.
 
-    int fd;                         ///< File descriptor to read the JSON document from.
+    int fd;                         ///< File descriptor to read the JSON document from, or -1 if
+                                    ///  parsing a buffer (see le_json_ParseBuffer()).
+    size_t readSize;                ///< # of bytes to read from the file descriptor at a time.
+    size_t chunkEnd;                ///< Value bytesRead will have at the end of the last chunk
+                                    ///  read from the file descriptor.
     le_fdMonitor_Ref_t fdMonitor;   ///< File Descriptor Monitor used to monitor the fd.
     size_t bytesRead;               ///< # of bytes read from the file descriptor.
     size_t line;                    ///< Line number of the JSON document (starts at 1).
@@ -130,8 +139,26 @@ static void StopParsing
     if (NotStopped(parserPtr))
     {
         parserPtr->next = EXPECT_NOTHING;
-        le_fdMonitor_Delete(parserPtr->fdMonitor);
-        parserPtr->fdMonitor = NULL;
+
+        if (parserPtr->fdMonitor != NULL)
+        {
+            le_fdMonitor_Delete(parserPtr->fdMonitor);
+            parserPtr->fdMonitor = NULL;
+        }
+
+        // Give back whatever was read from the file descriptor past this point, so it can still
+        // be read from there afterwards (even by the handler of the document end event).
+        if (parserPtr->chunkEnd > parserPtr->bytesRead)
+        {
+            size_t unusedBytes = parserPtr->chunkEnd - parserPtr->bytesRead;
+
+            if (lseek(parserPtr->fd, -(off_t)unusedBytes, SEEK_CUR) == -1)
+            {
+                LE_WARN("Failed to seek back over %zu bytes read past the end of parsing (%m).",
+                        unusedBytes);
+            }
+            parserPtr->chunkEnd = parserPtr->bytesRead;
+        }
     }
 }
 
@@ -159,7 +186,10 @@ static void ParserDestructor
         le_mem_Release(CONTAINER_OF(linkPtr, Context_t, link));
     }
 
-    le_thread_RemoveDestructor(parserPtr->threadDestructor);
+    if (parserPtr->threadDestructor != NULL)
+    {
+        le_thread_RemoveDestructor(parserPtr->threadDestructor);
+    }
 }
 
 
@@ -360,9 +390,10 @@ static void PushContext
 
     le_sls_Stack(&parserPtr->contextStack, &contextPtr->link);
 
-    // Clear the value buffer.
-    memset(parserPtr->buffer, 0, sizeof(parserPtr->buffer));
+    // Clear the value buffer.  It is kept null-terminated as bytes are added to it.
+    parserPtr->buffer[0] = '\0';
     parserPtr->numBytes = 0;
+    parserPtr->escaped = false;
 }
 
 
@@ -452,6 +483,33 @@ static void AddToBuffer
     {
         parserPtr->buffer[parserPtr->numBytes] = c;
         parserPtr->numBytes++;
+        parserPtr->buffer[parserPtr->numBytes] = '\0';
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds a run of bytes to the parser's string buffer.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddRunToBuffer
+(
+    Parser_t* parserPtr,
+    const char* runPtr,
+    size_t runLen
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (runLen > (sizeof(parserPtr->buffer) - 1 - parserPtr->numBytes))
+    {
+        Error(parserPtr, LE_JSON_READ_ERROR, "Content item too long to fit in internal buffer.");
+    }
+    else
+    {
+        memcpy(parserPtr->buffer + parserPtr->numBytes, runPtr, runLen);
+        parserPtr->numBytes += runLen;
+        parserPtr->buffer[parserPtr->numBytes] = '\0';
     }
 }
 
@@ -469,7 +527,7 @@ static void ParseValue
 //--------------------------------------------------------------------------------------------------
 {
     // Throw away whitespace until something else comes along.
-    if (!isspace(c))
+    if (!isspace((unsigned char)c))
     {
         if (c == '{')   // Start of an object.
         {
@@ -506,7 +564,7 @@ static void ParseValue
             AddToBuffer(parserPtr, c);
             parserPtr->next = EXPECT_NULL;
         }
-        else if (isdigit(c) || (c == '-'))
+        else if (isdigit((unsigned char)c) || (c == '-'))
         {
             PushContext(parserPtr, LE_JSON_CONTEXT_NUMBER, GetEventHandler(parserPtr));
             AddToBuffer(parserPtr, c);
@@ -609,37 +667,44 @@ static void ParseString
 )
 //--------------------------------------------------------------------------------------------------
 {
+    // An escaped character is copied as is, after its escaping '\\'.  So is a '"' in that case.
+    if (parserPtr->escaped)
+    {
+        parserPtr->escaped = false;
+        AddToBuffer(parserPtr, c);
+    }
+    else if (c == '\\')
+    {
+        parserPtr->escaped = true;
+        AddToBuffer(parserPtr, c);
+    }
     // See if this is a string terminating '"' character.
-    if (c == '"')
+    else if (c == '"')
     {
-        // It's not string terminating if it is escaped.
-        if ((parserPtr->bytesRead == 0) || (parserPtr->buffer[parserPtr->bytesRead - 1] != '\\'))
+        // Make we have a valid UTF-8 string.
+        if (!le_utf8_IsFormatCorrect(parserPtr->buffer))
+        {
+            Error(parserPtr, LE_JSON_SYNTAX_ERROR, "String is not valid UTF-8.");
+        }
+        else
         {
-            // Make we have a valid UTF-8 string.
-            if (!le_utf8_IsFormatCorrect(parserPtr->buffer))
+            // Handling of the end of the string depends on the context.
+            le_json_ContextType_t contextType = GetContext(parserPtr)->type;
+
+            if (contextType == LE_JSON_CONTEXT_STRING)
             {
-                Error(parserPtr, LE_JSON_SYNTAX_ERROR, "String is not valid UTF-8.");
+                Report(parserPtr, LE_JSON_STRING);
+                PopContext(parserPtr);
+            }
+            else if (contextType == LE_JSON_CONTEXT_MEMBER)
+            {
+                Report(parserPtr, LE_JSON_OBJECT_MEMBER);
+                parserPtr->next = EXPECT_COLON;
             }
             else
             {
-                // Handling of the end of the string depends on the context.
-                le_json_ContextType_t contextType = GetContext(parserPtr)->type;
-
-                if (contextType == LE_JSON_CONTEXT_STRING)
-                {
-                    Report(parserPtr, LE_JSON_STRING);
-                    PopContext(parserPtr);
-                }
-                else if (contextType == LE_JSON_CONTEXT_MEMBER)
-                {
-                    Report(parserPtr, LE_JSON_OBJECT_MEMBER);
-                    parserPtr->next = EXPECT_COLON;
-                }
-                else
-                {
-                    LE_FATAL("Unexpected context '%s' for string termination.",
-                             le_json_GetContextName(contextType));
-                }
+                LE_FATAL("Unexpected context '%s' for string termination.",
+                         le_json_GetContextName(contextType));
             }
         }
     }
@@ -679,7 +744,7 @@ static void ProcessChar
                 parserPtr->next = EXPECT_VALUE_OR_ARRAY_END;
                 Report(parserPtr, LE_JSON_ARRAY_START);
             }
-            else if (!isspace(c))
+            else if (!isspace((unsigned char)c))
             {
                 Error(parserPtr, LE_JSON_SYNTAX_ERROR, "Document must start with '{' or '['.");
             }
@@ -698,7 +763,7 @@ static void ProcessChar
                 PushContext(parserPtr, LE_JSON_CONTEXT_MEMBER, GetEventHandler(parserPtr));
                 parserPtr->next = EXPECT_STRING;
             }
-            else if (!isspace(c))
+            else if (!isspace((unsigned char)c))
             {
                 Error(parserPtr,
                       LE_JSON_SYNTAX_ERROR,
@@ -713,7 +778,7 @@ static void ProcessChar
             {
                 parserPtr->next = EXPECT_VALUE;
             }
-            else if (!isspace(c))
+            else if (!isspace((unsigned char)c))
             {
                 Error(parserPtr,
                       LE_JSON_SYNTAX_ERROR,
@@ -738,7 +803,7 @@ static void ProcessChar
             {
                 parserPtr->next = EXPECT_MEMBER;
             }
-            else if (!isspace(c))
+            else if (!isspace((unsigned char)c))
             {
                 Error(parserPtr,
                       LE_JSON_SYNTAX_ERROR,
@@ -754,7 +819,7 @@ static void ProcessChar
                 PushContext(parserPtr, LE_JSON_CONTEXT_MEMBER, GetEventHandler(parserPtr));
                 parserPtr->next = EXPECT_STRING;
             }
-            else if (!isspace(c))
+            else if (!isspace((unsigned char)c))
             {
                 Error(parserPtr,
                       LE_JSON_SYNTAX_ERROR,
@@ -787,7 +852,7 @@ static void ProcessChar
             {
                 parserPtr->next = EXPECT_VALUE;
             }
-            else if (!isspace(c))
+            else if (!isspace((unsigned char)c))
             {
                 Error(parserPtr,
                       LE_JSON_SYNTAX_ERROR,
@@ -802,7 +867,7 @@ static void ProcessChar
 
         case EXPECT_NUMBER:
 
-            if ((c == '.') || isdigit(c))
+            if ((c == '.') || isdigit((unsigned char)c))
             {
                 AddToBuffer(parserPtr, c);
             }
@@ -851,6 +916,105 @@ static void ProcessChar
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Processes a chunk of data from the JSON document.
+ *
+ * Runs of whitespace between tokens, of plain string characters and of number characters are
+ * handled in bulk.  Everything else is passed to ProcessChar() one character at a time.  Stops
+ * early if parsing stops.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ProcessChars
+(
+    Parser_t* parserPtr,
+    const char* dataPtr,
+    size_t dataLen
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t i = 0;
+
+    while ((i < dataLen) && NotStopped(parserPtr))
+    {
+        size_t runLen = 0;
+        bool copyRun = true;
+        char c;
+
+        switch (parserPtr->next)
+        {
+            case EXPECT_STRING:
+
+                // Copy everything up to the next character that needs a closer look.
+                if (!parserPtr->escaped)
+                {
+                    while ((i + runLen < dataLen)
+                           && ((c = dataPtr[i + runLen]) != '"')
+                           && (c != '\\')
+                           && (c != '\n'))
+                    {
+                        runLen++;
+                    }
+                }
+                break;
+
+            case EXPECT_NUMBER:
+
+                while ((i + runLen < dataLen)
+                       && (((c = dataPtr[i + runLen]) == '.') || isdigit((unsigned char)c)))
+                {
+                    runLen++;
+                }
+                break;
+
+            case EXPECT_TRUE:
+            case EXPECT_FALSE:
+            case EXPECT_NULL:
+            case EXPECT_NOTHING:
+
+                break;
+
+            default:
+
+                // Whitespace is thrown away in all other states.
+                copyRun = false;
+                while ((i + runLen < dataLen)
+                       && (((c = dataPtr[i + runLen]) == ' ') || (c == '\t') || (c == '\n')
+                           || (c == '\r')))
+                {
+                    if (c == '\n')
+                    {
+                        parserPtr->line++;
+                    }
+                    runLen++;
+                }
+                break;
+        }
+
+        if (runLen > 0)
+        {
+            parserPtr->bytesRead += runLen;
+            if (copyRun)
+            {
+                AddRunToBuffer(parserPtr, dataPtr + i, runLen);
+            }
+            i += runLen;
+        }
+        else
+        {
+            c = dataPtr[i];
+            i++;
+            parserPtr->bytesRead++;
+            if (c == '\n')
+            {
+                parserPtr->line++;
+            }
+            ProcessChar(parserPtr, c);
+        }
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Read data from the JSON document file descriptor and process it.
@@ -863,13 +1027,14 @@ static void ReadData
 )
 //--------------------------------------------------------------------------------------------------
 {
+    char chunk[READ_CHUNK_BYTES];
+
     while (NotStopped(parserPtr))
     {
-        char c;
         ssize_t bytesRead;
         do
         {
-            bytesRead = read(fd, &c, 1);
+            bytesRead = read(fd, chunk, parserPtr->readSize);
         }
         while ((bytesRead == -1) && (errno == EINTR));
 
@@ -914,12 +1079,9 @@ static void ReadData
         }
         else
         {
-            parserPtr->bytesRead++;
-            if (c == '\n')
-            {
-                parserPtr->line++;
-            }
-            ProcessChar(parserPtr, c);
+            // If parsing stops before the end of the chunk, StopParsing() gives back the rest.
+            parserPtr->chunkEnd = parserPtr->bytesRead + bytesRead;
+            ProcessChars(parserPtr, chunk, bytesRead);
         }
     }
 }
@@ -975,37 +1137,35 @@ static void FdEventHandler
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Parse a JSON document received via a file descriptor.
+ * Creates a Parser object, ready to parse the beginning of a document.
  *
- * @return Reference to the JSON parsing session started by this function call.
+ * @return Pointer to the Parser object.
  */
 //--------------------------------------------------------------------------------------------------
-le_json_ParsingSessionRef_t le_json_Parse
+static Parser_t* CreateParser
 (
-    int fd, ///< File descriptor to read the JSON document from.
+    int fd, ///< File descriptor to read the JSON document from, or -1 if parsing a buffer.
     le_json_EventHandler_t  eventHandler,   ///< Function to call when normal parsing events happen.
     le_json_ErrorHandler_t  errorHandler,   ///< Function to call when errors happen.
     void* opaquePtr   ///< Opaque pointer to be fetched by handlers using le_json_GetOpaquePtr().
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Create a Parser.
     Parser_t* parserPtr = le_mem_ForceAlloc(ParserPool);
 
     parserPtr->next = EXPECT_OBJECT_OR_ARRAY;
     parserPtr->numBytes = 0;
 
     parserPtr->fd = fd;
-    parserPtr->fdMonitor = le_fdMonitor_Create("le_json", fd, FdEventHandler, POLLIN);
-    le_fdMonitor_SetContextPtr(parserPtr->fdMonitor, parserPtr);
+    parserPtr->readSize = 1;
+    parserPtr->chunkEnd = 0;
+    parserPtr->fdMonitor = NULL;
     parserPtr->bytesRead = 0;
     parserPtr->line = 1;
 
     parserPtr->errorHandler = errorHandler;
     parserPtr->opaquePtr = opaquePtr;
-
-    // Register a thread destructor to be called to clean up this parser if the thread dies.
-    parserPtr->threadDestructor = le_thread_AddDestructor(ThreadDeathHandler, parserPtr);
+    parserPtr->threadDestructor = NULL;
 
     parserPtr->contextStack = LE_SLS_LIST_INIT;
 
@@ -1016,6 +1176,79 @@ le_json_ParsingSessionRef_t le_json_Parse
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a JSON document received via a file descriptor.
+ *
+ * @return Reference to the JSON parsing session started by this function call.
+ */
+//--------------------------------------------------------------------------------------------------
+le_json_ParsingSessionRef_t le_json_Parse
+(
+    int fd, ///< File descriptor to read the JSON document from.
+    le_json_EventHandler_t  eventHandler,   ///< Function to call when normal parsing events happen.
+    le_json_ErrorHandler_t  errorHandler,   ///< Function to call when errors happen.
+    void* opaquePtr   ///< Opaque pointer to be fetched by handlers using le_json_GetOpaquePtr().
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Parser_t* parserPtr = CreateParser(fd, eventHandler, errorHandler, opaquePtr);
+
+    // Bytes read past the end of the document can only be given back to regular files, so
+    // anything else has to be read one byte at a time to leave what follows the document unread.
+    struct stat st;
+    if ((fstat(fd, &st) == 0) && S_ISREG(st.st_mode))
+    {
+        parserPtr->readSize = READ_CHUNK_BYTES;
+    }
+
+    parserPtr->fdMonitor = le_fdMonitor_Create("le_json", fd, FdEventHandler, POLLIN);
+    le_fdMonitor_SetContextPtr(parserPtr->fdMonitor, parserPtr);
+
+    // Register a thread destructor to be called to clean up this parser if the thread dies.
+    parserPtr->threadDestructor = le_thread_AddDestructor(ThreadDeathHandler, parserPtr);
+
+    return parserPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a JSON document held in a memory buffer.
+ *
+ * The whole document is parsed before this function returns, so all the event and error handler
+ * calls for it happen inside this function.  If the buffer ends before the document does, the
+ * error handler is called with LE_JSON_READ_ERROR.  Anything in the buffer after the end of the
+ * document is ignored.
+ *
+ * Handlers can call le_json_Cleanup() to stop parsing early.  The session is cleaned up
+ * automatically when this function returns, whether le_json_Cleanup() was called or not.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_json_ParseBuffer
+(
+    const char* bufferPtr,  ///< Buffer holding the JSON document.
+    size_t bufferSize,      ///< Number of bytes in the buffer.
+    le_json_EventHandler_t  eventHandler,   ///< Function to call when normal parsing events happen.
+    le_json_ErrorHandler_t  errorHandler,   ///< Function to call when errors happen.
+    void* opaquePtr   ///< Opaque pointer to be fetched by handlers using le_json_GetOpaquePtr().
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Parser_t* parserPtr = CreateParser(-1, eventHandler, errorHandler, opaquePtr);
+
+    ProcessChars(parserPtr, bufferPtr, bufferSize);
+
+    if (NotStopped(parserPtr))
+    {
+        // The document has been truncated.
+        Error(parserPtr, LE_JSON_READ_ERROR, "Unexpected end of buffer.");
+    }
+
+    le_mem_Release(parserPtr);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Stops parsing and cleans up memory allocated by the parser.
@@ -1031,8 +1264,12 @@ void le_json_Cleanup
 {
     StopParsing(session);
 
-    // Release the client's reference to the parser object.
-    le_mem_Release(session);
+    // Release the client's reference to the parser object.  Buffer parsing sessions are released
+    // by le_json_ParseBuffer() itself.
+    if (session->fd != -1)
+    {
+        le_mem_Release(session);
+    }
 }
 
 
@@ -4,6 +4,19 @@
  * Configuration of log messages is also handled by this module.  Writing traces to the log and
  * enabling traces by keyword is also handled here.
  *
+ * Log messages are normally written to the log by the thread that logs them.  If the process's
+ * flush policy is set to LOG_FLUSH_ASYNC (by the Log Control Daemon, or the LE_LOG_FLUSH
+ * environment variable), formatted messages are put on a ring buffer instead, without locking,
+ * and a flusher thread writes them to the log.  Messages that don't fit on the ring are dropped
+ * and counted, and the flusher logs how many were dropped.
+ *
+ * With the LOG_FLUSH_DEFERRED policy, messages aren't even formatted by the thread that logs them.
+ * Their format string and raw arguments are put on the ring as a binary record, and the flusher
+ * thread formats them.  Arguments are packed in the order the format string consumes them,
+ * so the flusher can unpack them by walking the same format string.  Messages whose format can't
+ * be packed this way, or that don't fit in a record, are formatted right away, as with
+ * LOG_FLUSH_ASYNC.
+ *
  * Copyright (C) Sierra Wireless Inc.
  */
 
@@ -21,6 +34,42 @@
 #define MAX_MSG_SIZE            256
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum length of formatted log lines, including the header in front of the message and the
+ * terminator.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_LINE_SIZE           (MAX_MSG_SIZE + 384)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum size of the packed arguments of a deferred log message.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_RECORD_ARGS_SIZE    (MAX_MSG_SIZE + 128)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum size of the strings and packed arguments of a deferred log message.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_RECORD_DATA_SIZE    (MAX_RECORD_ARGS_SIZE + MAX_MSG_SIZE)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maximum length of a single conversion specification (e.g., "%-08.3lld") in the format string of
+ * a deferred log message, and size of the buffer it's rebuilt in when '*' width and precision are
+ * replaced by their values.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_CONVERSION_SPEC_LEN     20
+#define CONVERSION_SPEC_BUFF_SIZE   (MAX_CONVERSION_SPEC_LEN + 24 + 1)
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Log severity strings.
@@ -150,6 +199,176 @@ static le_log_TraceRef_t TraceRef;
 static pthread_mutex_t Mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Types of the arguments that a conversion specification in a format string consumes.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    ARG_NONE,           ///< No argument (%% and %m).
+    ARG_INT,            ///< int, or a smaller integer promoted to int.
+    ARG_LONG,           ///< long.
+    ARG_LONG_LONG,      ///< long long.
+    ARG_INTMAX,         ///< intmax_t.
+    ARG_SIZE,           ///< size_t.
+    ARG_PTRDIFF,        ///< ptrdiff_t.
+    ARG_DOUBLE,         ///< double, or a float promoted to double.
+    ARG_LONG_DOUBLE,    ///< long double.
+    ARG_STRING,         ///< Null-terminated string.  Packed as a copy of the string.
+    ARG_POINTER         ///< Pointer printed with %p.
+}
+ArgType_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A conversion specification parsed from a format string.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    ArgType_t argType;          ///< Type of the argument being converted.
+    bool hasWidthArg;           ///< true if the width is given by an int argument ('*').
+    bool hasPrecisionArg;       ///< true if the precision is given by an int argument ('*').
+    int precision;              ///< Precision given in the format string, or -1 if none.
+}
+Conversion_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log message put on the ring unformatted, with the LOG_FLUSH_DEFERRED policy.
+ *
+ * The format string and the file and function names are copied into the record's data, followed by
+ * the packed arguments.  They are only literals when logged through the LE_* macros; the Java and
+ * Python bindings free them as soon as _le_log_Send() returns.  The thread name is copied too,
+ * because the thread may be gone when the message is formatted.  The severity string and trace
+ * keyword and the component name live as long as the process, as log sessions and trace keywords
+ * are never deleted.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    const char* levelPtr;                           ///< Severity string or trace keyword.
+    const char* compNamePtr;                        ///< Component name.
+    unsigned int lineNumber;                        ///< Line number in the source file.
+    int savedErrno;                                 ///< errno of the caller, for %m.
+    char threadName[LIMIT_MAX_THREAD_NAME_BYTES];   ///< Thread name.
+    uint8_t data[MAX_RECORD_DATA_SIZE];             ///< User message format, source file base
+                                                    ///  name and function name, each terminated,
+                                                    ///  then the packed arguments.
+}
+Record_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Slot on the log ring buffer.  Holds one formatted log line, or a log message record.
+ *
+ * The slot's sequence number tells what can be done with it.  It can be filled by the thread that
+ * claims ring position N when it's N, and it can be written to the log and emptied when it's N + 1.
+ * Emptying it sets it to N + LE_CONFIG_LOG_RING_SLOTS, the next position that maps to the slot.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t sequence;            ///< Sequence number (see above).
+    le_log_Level_t level;       ///< Severity level of the line, or -1 for a trace.
+    bool isRecord;              ///< true if the slot holds a record rather than a formatted line.
+
+    union
+    {
+        char line[MAX_LINE_SIZE];   ///< The formatted line.
+        Record_t record;            ///< The message record.
+    }
+    content;
+}
+RingSlot_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The log ring buffer.  Allocated the first time the flush policy is set to LOG_FLUSH_ASYNC or
+ * LOG_FLUSH_DEFERRED.
+ */
+//--------------------------------------------------------------------------------------------------
+static RingSlot_t* RingPtr;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ring position that the next line will be put at.  Threads claim positions by advancing it with
+ * a compare-and-swap.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t RingWritePos;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Ring position of the next line to write to the log.  Only used with the FlushMutex locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t RingReadPos;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Counters of the lines dropped because the ring was full, and of the times the ring overflowed.
+ * A run of lines dropped before the flusher next empties the ring counts as one overflow.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t DroppedCount;
+static size_t OverflowCount;
+static bool IsOverflowing;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Value of DroppedCount when dropped lines were last reported in the log.  Only used with the
+ * FlushMutex locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t ReportedDroppedCount;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * The process's flush policy.
+ */
+//--------------------------------------------------------------------------------------------------
+static log_FlushPolicy_t FlushPolicy = LOG_FLUSH_SYNC;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * true once the flusher thread is running.  Only used with the Mutex locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsFlusherRunning;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Mutex held while lines are written from the ring to the log, to keep them in order.  Threads
+ * that write a line straight to the log while lines are still on the ring hold it too.
+ */
+//--------------------------------------------------------------------------------------------------
+static pthread_mutex_t FlushMutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Semaphore the flusher thread waits on when the ring is empty, and flag that it sets before it
+ * does.  The thread that clears the flag posts the semaphore, so that threads putting lines on the
+ * ring only make a system call when the flusher thread is waiting.
+ */
+//--------------------------------------------------------------------------------------------------
+static sem_t FlusherSem;
+static bool IsFlusherIdle;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Lock the mutex.
@@ -326,118 +545,1383 @@ static void EnableTrace
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Disable a trace keyword.
+ * Disable a trace keyword.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DisableTrace
+(
+    const char* componentNamePtr,   // The component that contains the keyword to disable.
+    const char* keywordPtr          // The trace keyword to disable.
+)
+{
+    Lock();
+
+    // Find the session for this component.
+    LogSession_t* sessionPtr = GetSession(componentNamePtr);
+
+    if (sessionPtr)
+    {
+        // Search the keyword list for the keyword.
+        KeywordObj_t* keywordObjPtr = GetKeywordObj(keywordPtr, &(sessionPtr->keywordList));
+
+        if (keywordObjPtr)
+        {
+            // Disable the keyword.
+            keywordObjPtr->isEnabled = false;
+        }
+    }
+
+    Unlock();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set the log level filter for a specific component.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SetLogLevelFilter
+(
+    const char* componentNamePtr,   // The name of the component.
+    int levelFilter                 // The filter level.
+)
+{
+    Lock();
+
+    // Find the session to apply the filter to.
+    LogSession_t* sessionPtr = GetSession(componentNamePtr);
+
+    if (sessionPtr)
+    {
+        // Set this component's level.
+        sessionPtr->level = levelFilter;
+    }
+
+    Unlock();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create a log session.
+ *
+ * @return  Pointer to the new log session object.
+ **/
+//--------------------------------------------------------------------------------------------------
+static LogSession_t* CreateSession
+(
+    const char* componentNamePtr    // A pointer to the component's name.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    LogSession_t* logSessionPtr = le_mem_ForceAlloc(SessionMemPool);
+
+    // Initialize the log session.
+    logSessionPtr->componentNamePtr = componentNamePtr;
+    logSessionPtr->level = DefaultLogSession.level;
+    logSessionPtr->keywordList = LE_SLS_LIST_INIT;
+    logSessionPtr->link = LE_SLS_LINK_INIT;
+
+    Lock();
+
+    // Add it to the list of log sessions.
+    le_sls_Queue(&SessionList, &(logSessionPtr->link));
+
+    Unlock();
+
+    return logSessionPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Loads the default log filter level from the environment, if present.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void ReadLevelFromEnv
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const char* envStrPtr = getenv("LE_LOG_LEVEL");
+
+    if (envStrPtr != NULL)
+    {
+        le_log_Level_t level = log_StrToSeverityLevel(envStrPtr);
+
+        if (level != (le_log_Level_t)-1)
+        {
+            DefaultLogSession.level = level;
+        }
+        else
+        {
+            LE_ERROR("LE_LOG_LEVEL environment variable has invalid value '%s'.", envStrPtr);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Loads the default list of enabled trace keywords from the environment, if present.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void ReadTraceKeywordsFromEnv
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    const char* envStrPtr = getenv("LE_LOG_KEYWORDS");
+
+    if (envStrPtr != NULL)
+    {
+        char componentName[LIMIT_MAX_COMPONENT_NAME_BYTES];
+        char keyword[LIMIT_MAX_LOG_KEYWORD_BYTES];
+
+        const char* subStrPtr = envStrPtr;
+        size_t i = 0;
+
+        while (i < 1024)  // Arbitrary limit.
+        {
+            size_t n;
+
+            // Get the component name sub-string (terminated by '/' separator).
+            if (le_utf8_CopyUpToSubStr(componentName, subStrPtr + i, "/", sizeof(componentName), &n)
+                != LE_OK)
+            {
+                LE_ERROR("Component name too long in LE_LOG_KEYWORDS environment variable.");
+                return;
+            }
+            else if (n == 0)
+            {
+                LE_ERROR("Missing component name in LE_LOG_KEYWORDS environment variable.");
+                return;
+            }
+            else if (subStrPtr[n] != '/')
+            {
+                LE_ERROR("Environment variable LE_LOG_KEYWORDS contains bad keyword specifier"
+                         " (Missing '/' separator).");
+                return;
+            }
+
+            // Skip past the slash.
+            i += n + 1;
+
+            // The keyword is the remainder, up to the end of the string or the next colon.
+            if (le_utf8_CopyUpToSubStr(keyword, envStrPtr + i, ":", sizeof(keyword), &n)
+                != LE_OK)
+            {
+                LE_ERROR("Keyword too long in LE_LOG_KEYWORDS environment variable.");
+                return;
+            }
+            else if (n == 0)
+            {
+                LE_ERROR("Missing keyword after '/' in LE_LOG_KEYWORDS environment variable.");
+                return;
+            }
+
+            // Enable this keyword.
+            LE_INFO("Enabling keyword '%s' for component '%s'.", keyword, componentName);
+            EnableTrace(componentName, keyword);
+
+            // If we haven't reached the end of the string,
+            if (envStrPtr[i + n] == ':')
+            {
+                // Advance to the beginning of the next sub-string.
+                i += n + 1;     // Skip past the colon.
+            }
+            else
+            {
+                // We must have reached the null terminator.
+                return;
+            }
+        }
+
+        LE_ERROR("LE_LOG_KEYWORDS environment variable too long.");
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Converts the legato log levels to the syslog priority levels.
+ *
+ * @return
+ *      Syslog priority level.
+ */
+//--------------------------------------------------------------------------------------------------
+#ifdef LEGATO_EMBEDDED
+
+static int ConvertToSyslogLevel
+(
+    le_log_Level_t legatoLevel
+)
+{
+    switch (legatoLevel)
+    {
+        case LE_LOG_DEBUG:
+            return LOG_DEBUG;
+
+        case LE_LOG_INFO:
+            return LOG_INFO;
+
+        case LE_LOG_WARN:
+            return LOG_WARNING;
+
+        case LE_LOG_ERR:
+            return LOG_ERR;
+
+        case LE_LOG_CRIT:
+            return LOG_CRIT;
+
+        default:
+            return LOG_EMERG;
+    }
+}
+#endif
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Formats a log line.  On a PC, the line starts with a timestamp.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FormatLine
+(
+    char* linePtr,              ///< [OUT] Buffer of MAX_LINE_SIZE bytes to format the line into.
+    const char* formatPtr, ...  ///< [IN] Line format and options.
+)
+{
+    size_t len = 0;
+
+#ifndef LEGATO_EMBEDDED
+
+    time_t now;
+    char timeStamp[26] = "";
+    char* timeStampPtr = timeStamp;
+
+    if ( (time(&now) != ((time_t)-1)) && (ctime_r(&now, timeStamp) != NULL) )
+    {
+        // Tue Jan 14 18:01:56 2014
+        // 0123456789012345678901234
+        timeStampPtr = timeStamp + 4; // Skip day of week.
+        timeStamp[19] = '\0';  // Exclude the year.
+    }
+
+    len = snprintf(linePtr, MAX_LINE_SIZE, "%s : ", timeStampPtr);
+
+#endif
+
+    va_list varParams;
+    va_start(varParams, formatPtr);
+
+    // If the line was truncated, make sure it still ends with a newline.
+    if (vsnprintf(linePtr + len, MAX_LINE_SIZE - len, formatPtr, varParams) >= MAX_LINE_SIZE - len)
+    {
+        linePtr[MAX_LINE_SIZE - 2] = '\n';
+    }
+
+    va_end(varParams);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes a formatted line to the log.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteLine
+(
+    le_log_Level_t level,       ///< [IN] Severity level, or -1 for a trace.
+    const char* linePtr         ///< [IN] Formatted line.
+)
+{
+    // If running on an embedded target, write the line out to the log.
+#ifdef LEGATO_EMBEDDED
+
+    syslog(ConvertToSyslogLevel(level), "%s", linePtr);
+
+    // If running on a PC, write the line to standard error.
+#else
+
+    fputs(linePtr, stderr);
+
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Formats a log message line from its parts.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FormatMsgLine
+(
+    char* linePtr,                  ///< [OUT] Buffer of MAX_LINE_SIZE bytes to format the line into.
+    const char* levelPtr,           ///< [IN] Severity string or trace keyword.
+    const char* compNamePtr,        ///< [IN] Component name.
+    const char* threadNamePtr,      ///< [IN] Thread name.
+    const char* filenamePtr,        ///< [IN] Source file name.
+    const char* functionNamePtr,    ///< [IN] Function name.
+    unsigned int lineNumber,        ///< [IN] Line number in the source file.
+    const char* msgPtr              ///< [IN] User message.
+)
+{
+    // Get the file name.
+    char* baseFileNamePtr = le_path_GetBasenamePtr((char*)filenamePtr, "/");
+
+    // Get the process name.
+    const char* procNamePtr = le_arg_GetProgramName();
+    if (procNamePtr == NULL)
+    {
+        procNamePtr = "n/a";
+    }
+
+    FormatLine(linePtr, "%s | %s[%d]/%s T=%s | %s %s() %d | %s\n",
+               levelPtr, procNamePtr, getpid(), compNamePtr, threadNamePtr, baseFileNamePtr,
+               functionNamePtr, lineNumber, msgPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parses a conversion specification in a format string.
+ *
+ * Positional arguments ("%1$d"), wide characters and strings, and %n are not supported.
+ *
+ * @return
+ *      Pointer to the character that follows the conversion specification.
+ *      NULL if the conversion specification isn't supported.
+ */
+//--------------------------------------------------------------------------------------------------
+static const char* ParseConversion
+(
+    const char* specPtr,        ///< [IN] Conversion specification, starting with the '%'.
+    Conversion_t* convPtr       ///< [OUT] Parsed conversion specification.
+)
+{
+    const char* charPtr = specPtr + 1;
+
+    convPtr->hasWidthArg = false;
+    convPtr->hasPrecisionArg = false;
+    convPtr->precision = -1;
+
+    // Skip the flags.
+    while ((*charPtr != '\0') && (strchr("-+ #0'I", *charPtr) != NULL))
+    {
+        charPtr++;
+    }
+
+    // Get the width.
+    if (*charPtr == '*')
+    {
+        convPtr->hasWidthArg = true;
+        charPtr++;
+
+        if (isdigit((unsigned char)*charPtr))
+        {
+            return NULL;
+        }
+    }
+    else
+    {
+        while (isdigit((unsigned char)*charPtr))
+        {
+            charPtr++;
+        }
+
+        if (*charPtr == '$')
+        {
+            return NULL;
+        }
+    }
+
+    // Get the precision.
+    if (*charPtr == '.')
+    {
+        charPtr++;
+
+        if (*charPtr == '*')
+        {
+            convPtr->hasPrecisionArg = true;
+            charPtr++;
+
+            if (isdigit((unsigned char)*charPtr))
+            {
+                return NULL;
+            }
+        }
+        else
+        {
+            convPtr->precision = 0;
+
+            while (isdigit((unsigned char)*charPtr))
+            {
+                convPtr->precision = (convPtr->precision * 10) + (*charPtr - '0');
+                charPtr++;
+            }
+        }
+    }
+
+    // Get the length modifier.  'H' stands for "hh" and 'q' for "ll".
+    char length = '\0';
+
+    if ((charPtr[0] == 'h') && (charPtr[1] == 'h'))
+    {
+        length = 'H';
+        charPtr += 2;
+    }
+    else if ((charPtr[0] == 'l') && (charPtr[1] == 'l'))
+    {
+        length = 'q';
+        charPtr += 2;
+    }
+    else if ((*charPtr != '\0') && (strchr("hlqjzZtL", *charPtr) != NULL))
+    {
+        length = *charPtr;
+        charPtr++;
+    }
+
+    // Get the argument type from the conversion specifier and the length modifier.
+    switch (*charPtr)
+    {
+        case 'd':
+        case 'i':
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+            switch (length)
+            {
+                case 'l':
+                    convPtr->argType = ARG_LONG;
+                    break;
+
+                case 'q':
+                case 'L':
+                    convPtr->argType = ARG_LONG_LONG;
+                    break;
+
+                case 'j':
+                    convPtr->argType = ARG_INTMAX;
+                    break;
+
+                case 'z':
+                case 'Z':
+                    convPtr->argType = ARG_SIZE;
+                    break;
+
+                case 't':
+                    convPtr->argType = ARG_PTRDIFF;
+                    break;
+
+                default:
+                    convPtr->argType = ARG_INT;
+                    break;
+            }
+            break;
+
+        case 'c':
+            convPtr->argType = ARG_INT;
+            break;
+
+        case 'e':
+        case 'E':
+        case 'f':
+        case 'F':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            convPtr->argType = (length == 'L' ? ARG_LONG_DOUBLE : ARG_DOUBLE);
+            break;
+
+        case 's':
+            if (length == 'l')
+            {
+                return NULL;
+            }
+            convPtr->argType = ARG_STRING;
+            break;
+
+        case 'p':
+            convPtr->argType = ARG_POINTER;
+            break;
+
+        case '%':
+        case 'm':
+            convPtr->argType = ARG_NONE;
+            break;
+
+        default:
+            return NULL;
+    }
+
+    charPtr++;
+
+    if (charPtr - specPtr > MAX_CONVERSION_SPEC_LEN)
+    {
+        return NULL;
+    }
+
+    return charPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Appends a value to a buffer of packed arguments.
+ *
+ * @return
+ *      true if successful.
+ *      false if the buffer is full.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool PackValue
+(
+    uint8_t* bufPtr,            ///< [IN] Buffer of MAX_RECORD_ARGS_SIZE bytes.
+    size_t* usedPtr,            ///< [IN/OUT] Number of bytes used in the buffer.
+    const void* valuePtr,       ///< [IN] Value.
+    size_t valueSize            ///< [IN] Size of the value.
+)
+{
+    if (*usedPtr + valueSize > MAX_RECORD_ARGS_SIZE)
+    {
+        return false;
+    }
+
+    memcpy(bufPtr + *usedPtr, valuePtr, valueSize);
+    *usedPtr += valueSize;
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Takes a value off a buffer of packed arguments.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UnpackValue
+(
+    const uint8_t** bufPtrPtr,  ///< [IN/OUT] Position in the buffer.  Moved past the value.
+    void* valuePtr,             ///< [OUT] Value.
+    size_t valueSize            ///< [IN] Size of the value.
+)
+{
+    memcpy(valuePtr, *bufPtrPtr, valueSize);
+    *bufPtrPtr += valueSize;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Packs the arguments of a log message, in the order that its format string consumes them.
+ * Strings are copied up to their precision, or up to the maximum message length.
+ *
+ * @return
+ *      Number of bytes used in the buffer if successful.
+ *      -1 if the format string isn't supported or the arguments don't fit.
+ */
+//--------------------------------------------------------------------------------------------------
+static ssize_t PackArgs
+(
+    uint8_t* bufPtr,            ///< [OUT] Buffer of MAX_RECORD_ARGS_SIZE bytes.
+    const char* formatPtr,      ///< [IN] Message format.
+    va_list varParams           ///< [IN] Message arguments.
+)
+{
+    size_t used = 0;
+    const char* charPtr = formatPtr;
+
+    while ((charPtr = strchr(charPtr, '%')) != NULL)
+    {
+        Conversion_t conv;
+        bool isPacked = true;
+
+        charPtr = ParseConversion(charPtr, &conv);
+        if (charPtr == NULL)
+        {
+            return -1;
+        }
+
+        if (conv.hasWidthArg)
+        {
+            int width = va_arg(varParams, int);
+            isPacked = PackValue(bufPtr, &used, &width, sizeof(width));
+        }
+
+        if (conv.hasPrecisionArg)
+        {
+            int precision = va_arg(varParams, int);
+            isPacked = isPacked && PackValue(bufPtr, &used, &precision, sizeof(precision));
+
+            conv.precision = (precision < 0 ? -1 : precision);
+        }
+
+        switch (conv.argType)
+        {
+            case ARG_NONE:
+                break;
+
+            case ARG_INT:
+            {
+                int value = va_arg(varParams, int);
+                isPacked = isPacked && PackValue(bufPtr, &used, &value, sizeof(value));
+                break;
+            }
+
+            case ARG_LONG:
+            {
+                long value = va_arg(varParams, long);
+                isPacked = isPacked && PackValue(bufPtr, &used, &value, sizeof(value));
+                break;
+            }
+
+            case ARG_LONG_LONG:
+            {
+                long long value = va_arg(varParams, long long);
+                isPacked = isPacked && PackValue(bufPtr, &used, &value, sizeof(value));
+                break;
+            }
+
+            case ARG_INTMAX:
+            {
+                intmax_t value = va_arg(varParams, intmax_t);
+                isPacked = isPacked && PackValue(bufPtr, &used, &value, sizeof(value));
+                break;
+            }
+
+            case ARG_SIZE:
+            {
+                size_t value = va_arg(varParams, size_t);
+                isPacked = isPacked && PackValue(bufPtr, &used, &value, sizeof(value));
+                break;
+            }
+
+            case ARG_PTRDIFF:
+            {
+                ptrdiff_t value = va_arg(varParams, ptrdiff_t);
+                isPacked = isPacked && PackValue(bufPtr, &used, &value, sizeof(value));
+                break;
+            }
+
+            case ARG_DOUBLE:
+            {
+                double value = va_arg(varParams, double);
+                isPacked = isPacked && PackValue(bufPtr, &used, &value, sizeof(value));
+                break;
+            }
+
+            case ARG_LONG_DOUBLE:
+            {
+                long double value = va_arg(varParams, long double);
+                isPacked = isPacked && PackValue(bufPtr, &used, &value, sizeof(value));
+                break;
+            }
+
+            case ARG_STRING:
+            {
+                const char* strPtr = va_arg(varParams, const char*);
+                size_t maxLen = MAX_MSG_SIZE - 1;
+
+                if (strPtr == NULL)
+                {
+                    strPtr = "(null)";
+                }
+
+                if ((conv.precision >= 0) && ((size_t)conv.precision < maxLen))
+                {
+                    maxLen = conv.precision;
+                }
+
+                size_t len = strnlen(strPtr, maxLen);
+
+                isPacked = (   isPacked
+                            && PackValue(bufPtr, &used, strPtr, len)
+                            && PackValue(bufPtr, &used, "", 1));
+                break;
+            }
+
+            case ARG_POINTER:
+            {
+                void* value = va_arg(varParams, void*);
+                isPacked = isPacked && PackValue(bufPtr, &used, &value, sizeof(value));
+                break;
+            }
+        }
+
+        if (!isPacked)
+        {
+            return -1;
+        }
+    }
+
+    return used;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Formats the user message of a log message record.  Each conversion specification in the format
+ * string is formatted on its own, with the argument taken off the packed arguments.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FormatRecordMsg
+(
+    char* msgPtr,                   ///< [OUT] Buffer of MAX_MSG_SIZE bytes.
+    const Record_t* recordPtr,      ///< [IN] Message record.
+    const char* formatPtr,          ///< [IN] User message format, in the record's data.
+    const uint8_t* argsPtr          ///< [IN] Packed arguments, in the record's data.
+)
+{
+    const char* charPtr = formatPtr;
+    size_t len = 0;
+
+    while ((*charPtr != '\0') && (len < MAX_MSG_SIZE - 1))
+    {
+        // Copy the text up to the next conversion specification.
+        const char* specPtr = strchr(charPtr, '%');
+        size_t textLen = (specPtr != NULL ? (size_t)(specPtr - charPtr) : strlen(charPtr));
+
+        if (textLen > MAX_MSG_SIZE - 1 - len)
+        {
+            textLen = MAX_MSG_SIZE - 1 - len;
+        }
+
+        memcpy(msgPtr + len, charPtr, textLen);
+        len += textLen;
+
+        if ((specPtr == NULL) || (len == MAX_MSG_SIZE - 1))
+        {
+            break;
+        }
+
+        // The format was parsed successfully when the arguments were packed.
+        Conversion_t conv;
+        charPtr = ParseConversion(specPtr, &conv);
+
+        // Rebuild the conversion specification with the '*' width and precision replaced by their
+        // values.
+        char spec[CONVERSION_SPEC_BUFF_SIZE];
+        size_t specLen = 0;
+        const char* specCharPtr;
+
+        for (specCharPtr = specPtr; specCharPtr < charPtr; specCharPtr++)
+        {
+            if (*specCharPtr == '*')
+            {
+                int value;
+                UnpackValue(&argsPtr, &value, sizeof(value));
+                specLen += snprintf(spec + specLen, sizeof(spec) - specLen, "%d", value);
+            }
+            else
+            {
+                spec[specLen++] = *specCharPtr;
+            }
+        }
+        spec[specLen] = '\0';
+
+        char* outPtr = msgPtr + len;
+        size_t outSize = MAX_MSG_SIZE - len;
+        int outLen = 0;
+
+        switch (conv.argType)
+        {
+            case ARG_NONE:
+                // The extra argument isn't used.  It only keeps the format from being mistaken for
+                // an argument-less one.
+                errno = recordPtr->savedErrno;
+                outLen = snprintf(outPtr, outSize, spec, "");
+                break;
+
+            case ARG_INT:
+            {
+                int value;
+                UnpackValue(&argsPtr, &value, sizeof(value));
+                outLen = snprintf(outPtr, outSize, spec, value);
+                break;
+            }
+
+            case ARG_LONG:
+            {
+                long value;
+                UnpackValue(&argsPtr, &value, sizeof(value));
+                outLen = snprintf(outPtr, outSize, spec, value);
+                break;
+            }
+
+            case ARG_LONG_LONG:
+            {
+                long long value;
+                UnpackValue(&argsPtr, &value, sizeof(value));
+                outLen = snprintf(outPtr, outSize, spec, value);
+                break;
+            }
+
+            case ARG_INTMAX:
+            {
+                intmax_t value;
+                UnpackValue(&argsPtr, &value, sizeof(value));
+                outLen = snprintf(outPtr, outSize, spec, value);
+                break;
+            }
+
+            case ARG_SIZE:
+            {
+                size_t value;
+                UnpackValue(&argsPtr, &value, sizeof(value));
+                outLen = snprintf(outPtr, outSize, spec, value);
+                break;
+            }
+
+            case ARG_PTRDIFF:
+            {
+                ptrdiff_t value;
+                UnpackValue(&argsPtr, &value, sizeof(value));
+                outLen = snprintf(outPtr, outSize, spec, value);
+                break;
+            }
+
+            case ARG_DOUBLE:
+            {
+                double value;
+                UnpackValue(&argsPtr, &value, sizeof(value));
+                outLen = snprintf(outPtr, outSize, spec, value);
+                break;
+            }
+
+            case ARG_LONG_DOUBLE:
+            {
+                long double value;
+                UnpackValue(&argsPtr, &value, sizeof(value));
+                outLen = snprintf(outPtr, outSize, spec, value);
+                break;
+            }
+
+            case ARG_STRING:
+            {
+                const char* strPtr = (const char*)argsPtr;
+                argsPtr += strlen(strPtr) + 1;
+                outLen = snprintf(outPtr, outSize, spec, strPtr);
+                break;
+            }
+
+            case ARG_POINTER:
+            {
+                void* value;
+                UnpackValue(&argsPtr, &value, sizeof(value));
+                outLen = snprintf(outPtr, outSize, spec, value);
+                break;
+            }
+        }
+
+        if (outLen > 0)
+        {
+            len += ((size_t)outLen < outSize ? (size_t)outLen : outSize - 1);
+        }
+    }
+
+    msgPtr[len] = '\0';
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Claims the slot at the ring's write position, without locking.  The slot must then be filled and
+ * published with PublishSlot().
+ *
+ * @return
+ *      Pointer to the slot, or NULL if the ring is full.
+ */
+//--------------------------------------------------------------------------------------------------
+static RingSlot_t* ClaimSlot
+(
+    size_t* posPtr              ///< [OUT] Ring position of the slot.
+)
+{
+    size_t pos = __atomic_load_n(&RingWritePos, __ATOMIC_RELAXED);
+
+    // Claim the slot at the write position, unless it still holds a line that hasn't been written
+    // to the log.
+    for (;;)
+    {
+        RingSlot_t* slotPtr = &RingPtr[pos % LE_CONFIG_LOG_RING_SLOTS];
+
+        ssize_t diff = __atomic_load_n(&slotPtr->sequence, __ATOMIC_ACQUIRE) - pos;
+
+        if (diff == 0)
+        {
+            // On failure, pos is updated to the current write position.
+            if (__atomic_compare_exchange_n(&RingWritePos, &pos, pos + 1, false,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                *posPtr = pos;
+                return slotPtr;
+            }
+        }
+        else if (diff < 0)
+        {
+            return NULL;
+        }
+        else
+        {
+            // Another thread claimed this position first.
+            pos = __atomic_load_n(&RingWritePos, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Makes a slot claimed with ClaimSlot() and filled available to the flusher, and wakes the flusher
+ * thread up if it's waiting for it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PublishSlot
+(
+    RingSlot_t* slotPtr,        ///< [IN] Slot.
+    size_t pos                  ///< [IN] Ring position of the slot.
+)
+{
+    __atomic_store_n(&slotPtr->sequence, pos + 1, __ATOMIC_RELEASE);
+
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    if (   __atomic_load_n(&IsFlusherIdle, __ATOMIC_RELAXED)
+        && __atomic_exchange_n(&IsFlusherIdle, false, __ATOMIC_RELAXED))
+    {
+        sem_post(&FlusherSem);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Counts a line dropped because the ring was full.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CountDroppedLine
+(
+    void
+)
+{
+    __atomic_add_fetch(&DroppedCount, 1, __ATOMIC_RELAXED);
+
+    if (!__atomic_exchange_n(&IsOverflowing, true, __ATOMIC_RELAXED))
+    {
+        __atomic_add_fetch(&OverflowCount, 1, __ATOMIC_RELAXED);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Puts a log message on the ring as a record, to be formatted by the flusher thread.  If the ring
+ * is full, the message is dropped.
+ *
+ * @return
+ *      true if the message was put on the ring or dropped.
+ *      false if it can't be deferred, and must be formatted by the caller.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool PushRecord
+(
+    le_log_Level_t level,           ///< [IN] Severity level, or -1 for a trace.
+    const char* levelPtr,           ///< [IN] Severity string or trace keyword.
+    const char* compNamePtr,        ///< [IN] Component name.
+    const char* filenamePtr,        ///< [IN] Source file name.
+    const char* functionNamePtr,    ///< [IN] Function name.
+    unsigned int lineNumber,        ///< [IN] Line number in the source file.
+    int savedErrno,                 ///< [IN] errno of the caller.
+    const char* formatPtr,          ///< [IN] User message format.
+    va_list varParams               ///< [IN] User message arguments.
+)
+{
+    // Pack the arguments on the stack first, as the format may turn out not to be supported.
+    uint8_t args[MAX_RECORD_ARGS_SIZE];
+    ssize_t argsSize = PackArgs(args, formatPtr, varParams);
+
+    if (argsSize < 0)
+    {
+        return false;
+    }
+
+    // The strings are copied, as they may be freed as soon as the caller returns.
+    const char* baseFileNamePtr = le_path_GetBasenamePtr((char*)filenamePtr, "/");
+    size_t formatSize = strlen(formatPtr) + 1;
+    size_t filenameSize = strlen(baseFileNamePtr) + 1;
+    size_t functionNameSize = strlen(functionNamePtr) + 1;
+
+    if (formatSize + filenameSize + functionNameSize + argsSize > MAX_RECORD_DATA_SIZE)
+    {
+        return false;
+    }
+
+    size_t pos;
+    RingSlot_t* slotPtr = ClaimSlot(&pos);
+
+    if (slotPtr == NULL)
+    {
+        CountDroppedLine();
+        return true;
+    }
+
+    Record_t* recordPtr = &slotPtr->content.record;
+    uint8_t* dataPtr = recordPtr->data;
+
+    slotPtr->level = level;
+    slotPtr->isRecord = true;
+    recordPtr->levelPtr = levelPtr;
+    recordPtr->compNamePtr = compNamePtr;
+    recordPtr->lineNumber = lineNumber;
+    recordPtr->savedErrno = savedErrno;
+    le_utf8_Copy(recordPtr->threadName, le_thread_GetMyName(), sizeof(recordPtr->threadName), NULL);
+
+    memcpy(dataPtr, formatPtr, formatSize);
+    dataPtr += formatSize;
+    memcpy(dataPtr, baseFileNamePtr, filenameSize);
+    dataPtr += filenameSize;
+    memcpy(dataPtr, functionNamePtr, functionNameSize);
+    dataPtr += functionNameSize;
+    memcpy(dataPtr, args, argsSize);
+
+    PublishSlot(slotPtr, pos);
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks if the next line on the ring is ready to be written to the log.
+ *
+ * @warning Assumes that the FlushMutex is locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsLineReady
+(
+    void
+)
+{
+    RingSlot_t* slotPtr = &RingPtr[RingReadPos % LE_CONFIG_LOG_RING_SLOTS];
+
+    return (__atomic_load_n(&slotPtr->sequence, __ATOMIC_ACQUIRE) == RingReadPos + 1);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes all the lines that are ready on the ring to the log, in order, and reports any lines that
+ * were dropped since the last time.
+ *
+ * @warning Assumes that the FlushMutex is locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FlushRing
+(
+    void
+)
+{
+    while (IsLineReady())
+    {
+        RingSlot_t* slotPtr = &RingPtr[RingReadPos % LE_CONFIG_LOG_RING_SLOTS];
+
+        if (slotPtr->isRecord)
+        {
+            const Record_t* recordPtr = &slotPtr->content.record;
+            const char* formatPtr = (const char*)recordPtr->data;
+            const char* filenamePtr = formatPtr + strlen(formatPtr) + 1;
+            const char* functionNamePtr = filenamePtr + strlen(filenamePtr) + 1;
+            const uint8_t* argsPtr =
+                (const uint8_t*)(functionNamePtr + strlen(functionNamePtr) + 1);
+            char msg[MAX_MSG_SIZE];
+            char line[MAX_LINE_SIZE];
+
+            FormatRecordMsg(msg, recordPtr, formatPtr, argsPtr);
+            FormatMsgLine(line,
+                          recordPtr->levelPtr,
+                          recordPtr->compNamePtr,
+                          recordPtr->threadName,
+                          filenamePtr,
+                          functionNamePtr,
+                          recordPtr->lineNumber,
+                          msg);
+            WriteLine(slotPtr->level, line);
+        }
+        else
+        {
+            WriteLine(slotPtr->level, slotPtr->content.line);
+        }
+
+        __atomic_store_n(&slotPtr->sequence,
+                         RingReadPos + LE_CONFIG_LOG_RING_SLOTS,
+                         __ATOMIC_RELEASE);
+        RingReadPos++;
+    }
+
+    __atomic_store_n(&IsOverflowing, false, __ATOMIC_RELAXED);
+
+    size_t droppedCount = __atomic_load_n(&DroppedCount, __ATOMIC_RELAXED);
+
+    if (droppedCount != ReportedDroppedCount)
+    {
+        const char* procNamePtr = le_arg_GetProgramName();
+        char line[MAX_LINE_SIZE];
+
+        FormatLine(line,
+                   "%s | %s[%d] | %zu log messages dropped (%zu in %zu log ring overflows)\n",
+                   SeverityStr[LE_LOG_WARN],
+                   (procNamePtr != NULL ? procNamePtr : "n/a"),
+                   getpid(),
+                   droppedCount - ReportedDroppedCount,
+                   droppedCount,
+                   __atomic_load_n(&OverflowCount, __ATOMIC_RELAXED));
+        WriteLine(LE_LOG_WARN, line);
+
+        ReportedDroppedCount = droppedCount;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Flusher thread's main function.  Writes lines from the ring to the log as they are put on it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* FlusherThreadMain
+(
+    void* contextPtr    ///< Not used.
+)
+{
+    for (;;)
+    {
+        LE_ASSERT(pthread_mutex_lock(&FlushMutex) == 0);
+
+        FlushRing();
+
+        // Announce that we are going to wait before checking the ring one last time.  If a line was
+        // put on the ring meanwhile, take the announcement back, unless the thread that put it
+        // there already saw it and is going to post the semaphore.
+        __atomic_store_n(&IsFlusherIdle, true, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+        bool mustWait = (   (!IsLineReady())
+                         || (!__atomic_exchange_n(&IsFlusherIdle, false, __ATOMIC_RELAXED)));
+
+        LE_ASSERT(pthread_mutex_unlock(&FlushMutex) == 0);
+
+        if (mustWait)
+        {
+            while ((sem_wait(&FlusherSem) == -1) && (errno == EINTR))
+            {
+            }
+        }
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Writes the lines still on the ring to the log when the process exits.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FlushRingAtExit
+(
+    void
+)
+{
+    // A child process that forked has no ring.
+    if (RingPtr != NULL)
+    {
+        LE_ASSERT(pthread_mutex_lock(&FlushMutex) == 0);
+        FlushRing();
+        LE_ASSERT(pthread_mutex_unlock(&FlushMutex) == 0);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Locks the FlushMutex before the process forks, so that the child doesn't get a copy of it that
+ * is locked by the flusher thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void LockFlushMutexForFork
+(
+    void
+)
+{
+    LE_ASSERT(pthread_mutex_lock(&FlushMutex) == 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unlocks the FlushMutex in the parent process after it forked.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UnlockFlushMutexInParent
+(
+    void
+)
+{
+    LE_ASSERT(pthread_mutex_unlock(&FlushMutex) == 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Goes back to writing lines to the log synchronously in a child process after a fork.  The child
+ * has no flusher thread, and the lines on the ring are written by the parent.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ResetRingInChild
+(
+    void
+)
+{
+    free(RingPtr);
+    RingPtr = NULL;
+    RingWritePos = 0;
+    RingReadPos = 0;
+    DroppedCount = 0;
+    OverflowCount = 0;
+    IsOverflowing = false;
+    ReportedDroppedCount = 0;
+    FlushPolicy = LOG_FLUSH_SYNC;
+    IsFlusherRunning = false;
+    IsFlusherIdle = false;
+
+    LE_ASSERT(pthread_mutex_unlock(&FlushMutex) == 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates the ring and starts the flusher thread.
+ *
+ * @warning Assumes that the mutex is locked.
+ *
+ * @return
+ *      true if successful.
+ *      false otherwise.
  */
 //--------------------------------------------------------------------------------------------------
-static void DisableTrace
+static bool StartFlusher
 (
-    const char* componentNamePtr,   // The component that contains the keyword to disable.
-    const char* keywordPtr          // The trace keyword to disable.
+    void
 )
 {
-    Lock();
+    static bool isForkHandled = false;
 
-    // Find the session for this component.
-    LogSession_t* sessionPtr = GetSession(componentNamePtr);
-
-    if (sessionPtr)
+    if (RingPtr == NULL)
     {
-        // Search the keyword list for the keyword.
-        KeywordObj_t* keywordObjPtr = GetKeywordObj(keywordPtr, &(sessionPtr->keywordList));
+        RingSlot_t* ringPtr = malloc(LE_CONFIG_LOG_RING_SLOTS * sizeof(RingSlot_t));
+        if (ringPtr == NULL)
+        {
+            LE_ERROR("Not enough memory for the log ring.");
+            return false;
+        }
 
-        if (keywordObjPtr)
+        size_t i;
+        for (i = 0; i < LE_CONFIG_LOG_RING_SLOTS; i++)
         {
-            // Disable the keyword.
-            keywordObjPtr->isEnabled = false;
+            ringPtr[i].sequence = i;
         }
-    }
 
-    Unlock();
-}
+        LE_ASSERT(sem_init(&FlusherSem, 0, 0) == 0);
 
+        __atomic_store_n(&RingPtr, ringPtr, __ATOMIC_RELEASE);
+    }
 
-//--------------------------------------------------------------------------------------------------
-/**
- * Set the log level filter for a specific component.
- */
-//--------------------------------------------------------------------------------------------------
-static void SetLogLevelFilter
-(
-    const char* componentNamePtr,   // The name of the component.
-    int levelFilter                 // The filter level.
-)
-{
-    Lock();
+    if (!isForkHandled)
+    {
+        LE_ASSERT(pthread_atfork(LockFlushMutexForFork,
+                                 UnlockFlushMutexInParent,
+                                 ResetRingInChild) == 0);
+        LE_ASSERT(atexit(FlushRingAtExit) == 0);
+        isForkHandled = true;
+    }
 
-    // Find the session to apply the filter to.
-    LogSession_t* sessionPtr = GetSession(componentNamePtr);
+    // Signals are received by the threads that handle them, so block them all in the flusher
+    // thread.
+    sigset_t allSignals;
+    sigset_t oldSignals;
+    pthread_t thread;
 
-    if (sessionPtr)
+    sigfillset(&allSignals);
+    LE_ASSERT(pthread_sigmask(SIG_SETMASK, &allSignals, &oldSignals) == 0);
+    int result = pthread_create(&thread, NULL, FlusherThreadMain, NULL);
+    LE_ASSERT(pthread_sigmask(SIG_SETMASK, &oldSignals, NULL) == 0);
+
+    if (result != 0)
     {
-        // Set this component's level.
-        sessionPtr->level = levelFilter;
+        LE_ERROR("Failed to start the log flusher thread (%s).", strerror(result));
+        return false;
     }
 
-    Unlock();
+    pthread_detach(thread);
+    IsFlusherRunning = true;
+
+    return true;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Create a log session.
- *
- * @return  Pointer to the new log session object.
- **/
+ * Sets the process's flush policy.
+ */
 //--------------------------------------------------------------------------------------------------
-static LogSession_t* CreateSession
+static void SetFlushPolicy
 (
-    const char* componentNamePtr    // A pointer to the component's name.
+    log_FlushPolicy_t policy    ///< [IN] Flush policy.
 )
-//--------------------------------------------------------------------------------------------------
 {
-    LogSession_t* logSessionPtr = le_mem_ForceAlloc(SessionMemPool);
-
-    // Initialize the log session.
-    logSessionPtr->componentNamePtr = componentNamePtr;
-    logSessionPtr->level = DefaultLogSession.level;
-    logSessionPtr->keywordList = LE_SLS_LIST_INIT;
-    logSessionPtr->link = LE_SLS_LINK_INIT;
-
     Lock();
 
-    // Add it to the list of log sessions.
-    le_sls_Queue(&SessionList, &(logSessionPtr->link));
+    if ((policy != LOG_FLUSH_SYNC) && (!IsFlusherRunning) && (!StartFlusher()))
+    {
+        LE_ERROR("Log messages will be written synchronously.");
+    }
+    else
+    {
+        __atomic_store_n(&FlushPolicy, policy, __ATOMIC_RELEASE);
+    }
 
     Unlock();
-
-    return logSessionPtr;
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Loads the default log filter level from the environment, if present.
+ * Loads the default flush policy from the environment, if present.
  **/
 //--------------------------------------------------------------------------------------------------
-static void ReadLevelFromEnv
+static void ReadFlushPolicyFromEnv
 (
     void
 )
 //--------------------------------------------------------------------------------------------------
 {
-    const char* envStrPtr = getenv("LE_LOG_LEVEL");
+    const char* envStrPtr = getenv("LE_LOG_FLUSH");
 
     if (envStrPtr != NULL)
     {
-        le_log_Level_t level = log_StrToSeverityLevel(envStrPtr);
+        log_FlushPolicy_t policy = log_StrToFlushPolicy(envStrPtr);
 
-        if (level != (le_log_Level_t)-1)
+        if (policy != (log_FlushPolicy_t)-1)
         {
-            DefaultLogSession.level = level;
+            SetFlushPolicy(policy);
         }
         else
         {
-            LE_ERROR("LE_LOG_LEVEL environment variable has invalid value '%s'.", envStrPtr);
+            LE_ERROR("LE_LOG_FLUSH environment variable has invalid value '%s'.", envStrPtr);
         }
     }
 }
@@ -445,82 +1929,50 @@ static void ReadLevelFromEnv
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Loads the default list of enabled trace keywords from the environment, if present.
- **/
+ * Sends a formatted line to the log according to the flush policy.
+ */
 //--------------------------------------------------------------------------------------------------
-static void ReadTraceKeywordsFromEnv
+static void OutputLine
 (
-    void
+    le_log_Level_t level,       ///< [IN] Severity level, or -1 for a trace.
+    const char* linePtr         ///< [IN] Formatted line.
 )
-//--------------------------------------------------------------------------------------------------
 {
-    const char* envStrPtr = getenv("LE_LOG_KEYWORDS");
-
-    if (envStrPtr != NULL)
+    // Critical and emergency messages are written before returning, as the process may be about to
+    // be killed.
+    if (   (__atomic_load_n(&FlushPolicy, __ATOMIC_ACQUIRE) != LOG_FLUSH_SYNC)
+        && (level != LE_LOG_CRIT)
+        && (level != LE_LOG_EMERG) )
     {
-        char componentName[LIMIT_MAX_COMPONENT_NAME_BYTES];
-        char keyword[LIMIT_MAX_LOG_KEYWORD_BYTES];
-
-        const char* subStrPtr = envStrPtr;
-        size_t i = 0;
+        size_t pos;
+        RingSlot_t* slotPtr = ClaimSlot(&pos);
 
-        while (i < 1024)  // Arbitrary limit.
+        if (slotPtr != NULL)
         {
-            size_t n;
-
-            // Get the component name sub-string (terminated by '/' separator).
-            if (le_utf8_CopyUpToSubStr(componentName, subStrPtr + i, "/", sizeof(componentName), &n)
-                != LE_OK)
-            {
-                LE_ERROR("Component name too long in LE_LOG_KEYWORDS environment variable.");
-                return;
-            }
-            else if (n == 0)
-            {
-                LE_ERROR("Missing component name in LE_LOG_KEYWORDS environment variable.");
-                return;
-            }
-            else if (subStrPtr[n] != '/')
-            {
-                LE_ERROR("Environment variable LE_LOG_KEYWORDS contains bad keyword specifier"
-                         " (Missing '/' separator).");
-                return;
-            }
-
-            // Skip past the slash.
-            i += n + 1;
-
-            // The keyword is the remainder, up to the end of the string or the next colon.
-            if (le_utf8_CopyUpToSubStr(keyword, envStrPtr + i, ":", sizeof(keyword), &n)
-                != LE_OK)
-            {
-                LE_ERROR("Keyword too long in LE_LOG_KEYWORDS environment variable.");
-                return;
-            }
-            else if (n == 0)
-            {
-                LE_ERROR("Missing keyword after '/' in LE_LOG_KEYWORDS environment variable.");
-                return;
-            }
-
-            // Enable this keyword.
-            LE_INFO("Enabling keyword '%s' for component '%s'.", keyword, componentName);
-            EnableTrace(componentName, keyword);
+            slotPtr->level = level;
+            slotPtr->isRecord = false;
+            memcpy(slotPtr->content.line, linePtr, strlen(linePtr) + 1);
 
-            // If we haven't reached the end of the string,
-            if (envStrPtr[i + n] == ':')
-            {
-                // Advance to the beginning of the next sub-string.
-                i += n + 1;     // Skip past the colon.
-            }
-            else
-            {
-                // We must have reached the null terminator.
-                return;
-            }
+            PublishSlot(slotPtr, pos);
+        }
+        else
+        {
+            CountDroppedLine();
         }
+    }
+    // Lines still on the ring must be written first.
+    else if (__atomic_load_n(&RingPtr, __ATOMIC_ACQUIRE) != NULL)
+    {
+        LE_ASSERT(pthread_mutex_lock(&FlushMutex) == 0);
 
-        LE_ERROR("LE_LOG_KEYWORDS environment variable too long.");
+        FlushRing();
+        WriteLine(level, linePtr);
+
+        LE_ASSERT(pthread_mutex_unlock(&FlushMutex) == 0);
+    }
+    else
+    {
+        WriteLine(level, linePtr);
     }
 }
 
@@ -661,6 +2113,17 @@ static void ProcessLogCmd
                 DisableTrace(componentName, commandDataPtr);
                 break;
 
+            case LOG_CMD_SET_FLUSH_POLICY:
+            {
+                log_FlushPolicy_t policy = log_StrToFlushPolicy(commandDataPtr);
+
+                if (policy != (log_FlushPolicy_t)-1)
+                {
+                    SetFlushPolicy(policy);
+                }
+                break;
+            }
+
             default:
                 LE_ERROR("Invalid command character '%c'.", command);
                 break;
@@ -771,6 +2234,9 @@ void log_Init
 
     // Set the syslog format.
     openlog("Legato", 0, LOG_USER);
+
+    // Load the default flush policy from the environment.
+    ReadFlushPolicyFromEnv();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -980,41 +2446,63 @@ const char* log_SeverityLevelToStr
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Converts the legato log levels to the syslog priority levels.
+ * Translates a flush policy string to a flush policy value.
  *
  * @return
- *      Syslog priority level.
+ *      The flush policy if successful.
+ *      -1 if the string is an invalid flush policy.
  */
 //--------------------------------------------------------------------------------------------------
-#ifdef LEGATO_EMBEDDED
-
-static int ConvertToSyslogLevel
+log_FlushPolicy_t log_StrToFlushPolicy
 (
-    le_log_Level_t legatoLevel
+    const char* policyStr   ///< [IN] The flush policy string.
 )
 {
-    switch (legatoLevel)
+    if (strcmp(policyStr, LOG_FLUSH_POLICY_SYNC_STR) == 0)
     {
-        case LE_LOG_DEBUG:
-            return LOG_DEBUG;
+        return LOG_FLUSH_SYNC;
+    }
+    else if (strcmp(policyStr, LOG_FLUSH_POLICY_ASYNC_STR) == 0)
+    {
+        return LOG_FLUSH_ASYNC;
+    }
+    else if (strcmp(policyStr, LOG_FLUSH_POLICY_DEFERRED_STR) == 0)
+    {
+        return LOG_FLUSH_DEFERRED;
+    }
 
-        case LE_LOG_INFO:
-            return LOG_INFO;
+    return -1;
+}
 
-        case LE_LOG_WARN:
-            return LOG_WARNING;
 
-        case LE_LOG_ERR:
-            return LOG_ERR;
+//--------------------------------------------------------------------------------------------------
+/**
+ * Translates a flush policy value to a flush policy string.
+ *
+ * @return
+ *      Pointer to a string constant containing the flush policy string.
+ *      NULL if the value is out of range.
+ */
+//--------------------------------------------------------------------------------------------------
+const char* log_FlushPolicyToStr
+(
+    log_FlushPolicy_t policy    ///< [IN] Flush policy.
+)
+{
+    switch (policy)
+    {
+        case LOG_FLUSH_SYNC:
+            return LOG_FLUSH_POLICY_SYNC_STR;
 
-        case LE_LOG_CRIT:
-            return LOG_CRIT;
+        case LOG_FLUSH_ASYNC:
+            return LOG_FLUSH_POLICY_ASYNC_STR;
 
-        default:
-            return LOG_EMERG;
+        case LOG_FLUSH_DEFERRED:
+            return LOG_FLUSH_POLICY_DEFERRED_STR;
     }
+
+    return NULL;
 }
-#endif
 
 
 //--------------------------------------------------------------------------------------------------
@@ -1074,23 +2562,28 @@ void _le_log_Send
     // NOTE: The component name won't change, so it's safe to read this without locking the mutex.
     const char* compNamePtr = logSession->componentNamePtr;
 
-    // Get the file name.
-    char* baseFileNamePtr = le_path_GetBasenamePtr((char*)filenamePtr, "/");
-
-    // Get the thread name.
-    const char* threadNamePtr = le_thread_GetMyName();
+    va_list varParams;
 
-    // Get the process name.
-    const char* procNamePtr = le_arg_GetProgramName();
-    if (procNamePtr == NULL)
+    // With the deferred flush policy, leave the formatting to the flusher thread if possible.
+    // Critical and emergency messages are written right away, like with the asynchronous policy.
+    if (   (__atomic_load_n(&FlushPolicy, __ATOMIC_ACQUIRE) == LOG_FLUSH_DEFERRED)
+        && (level != LE_LOG_CRIT)
+        && (level != LE_LOG_EMERG) )
     {
-        procNamePtr = "n/a";
+        va_start(varParams, formatPtr);
+        bool isDeferred = PushRecord(level, levelPtr, compNamePtr, filenamePtr, functionNamePtr,
+                                     lineNumber, savedErrno, formatPtr, varParams);
+        va_end(varParams);
+
+        if (isDeferred)
+        {
+            return;
+        }
     }
 
     // Get the user message.
     char msg[MAX_MSG_SIZE] = "";
 
-    va_list varParams;
     va_start(varParams, formatPtr);
 
     // Reset the errno to ensure that we report the proper errno value.
@@ -1102,33 +2595,13 @@ void _le_log_Send
 
     va_end(varParams);
 
-    // If running on an embedded target, write the message out to the log.
-#ifdef LEGATO_EMBEDDED
-
-    syslog(ConvertToSyslogLevel(level), "%s | %s[%d]/%s T=%s | %s %s() %d | %s\n",
-           levelPtr, procNamePtr, getpid(), compNamePtr, threadNamePtr, baseFileNamePtr,
-           functionNamePtr, lineNumber, msg);
-
-    // If running on a PC, write the message to standard error with a timestamp added.
-#else
-
-    time_t now;
-    char timeStamp[26] = "";
-    char* timeStampPtr = timeStamp;
-
-    if ( (time(&now) != ((time_t)-1)) && (ctime_r(&now, timeStamp) != NULL) )
-    {
-        // Tue Jan 14 18:01:56 2014
-        // 0123456789012345678901234
-        timeStampPtr = timeStamp + 4; // Skip day of week.
-        timeStamp[19] = '\0';  // Exclude the year.
-    }
+    // Build the log line and send it to the log.
+    char line[MAX_LINE_SIZE];
 
-    fprintf(stderr, "%s : %s | %s[%d]/%s T=%s | %s %s() %d | %s\n",
-            timeStampPtr, levelPtr, procNamePtr, getpid(), compNamePtr, threadNamePtr,
-            baseFileNamePtr, functionNamePtr, lineNumber, msg);
+    FormatMsgLine(line, levelPtr, compNamePtr, le_thread_GetMyName(), filenamePtr,
+                  functionNamePtr, lineNumber, msg);
 
-#endif
+    OutputLine(level, line);
 }
 
 
@@ -1352,30 +2825,11 @@ void log_LogGenericMsg
 )
 {
     // Write the message out to the log.
-#ifdef LEGATO_EMBEDDED
-
-    syslog(ConvertToSyslogLevel(level), "%s | %s[%d] | %s\n",
-           SeverityStr[level], procNamePtr, pid, msgPtr);
+    char line[MAX_LINE_SIZE];
 
-#else
-
-    time_t now;
-    char timeStamp[26] = "";
-    char* timeStampPtr = timeStamp;
-
-    if ( (time(&now) != ((time_t)-1)) && (ctime_r(&now, timeStamp) != NULL) )
-    {
-        // Tue Jan 14 18:01:56 2014
-        // 0123456789012345678901234
-        timeStampPtr = timeStamp + 4; // Skip day of week.
-        timeStamp[19] = '\0';  // Exclude the year.
-    }
-
-    fprintf(stderr, "%s : %s | %s[%d] | %s\n",
-            timeStampPtr, SeverityStr[level], procNamePtr, pid, msgPtr);
-
-#endif
+    FormatLine(line, "%s | %s[%d] | %s\n", SeverityStr[level], procNamePtr, pid, msgPtr);
 
+    OutputLine(level, line);
 }
 
 
@@ -39,12 +39,36 @@
  * that is unlikely to occur in normal data.  Whenever a block is allocated or released, the guard
  * bands are checked for corruption and any corruption is reported.
  *
+ * THREAD CACHES
+ * =============
+ *
+ * When the @ref MEM_THREAD_CACHE KConfig option is enabled, each Legato thread keeps a small
+ * number of free blocks for a few pools in "magazines" of its own, so that most allocations and
+ * releases do not need the module's mutex.  A pool always uses the same magazine in every thread,
+ * chosen from the pool's address.  A thread that runs out of cached blocks for a pool takes half a
+ * magazine's worth from the pool's free list at once, and a thread whose magazine is full gives
+ * half of it back.  A magazine that is needed for a different pool is first emptied back into its
+ * current pool.  Each thread's magazines are protected by a per-thread mutex, which is only ever
+ * contended when another thread is reclaiming blocks (see below).
+ *
+ * Cached blocks are counted as free in the pool statistics.  So that le_mem_TryAlloc() only fails
+ * when all of a pool's free blocks are really in use, any thread that finds a pool's free list
+ * empty, whether or not it has a cache of its own, reclaims the pool's blocks from every other
+ * thread's cache before giving up.  Sub-pool
+ * blocks are never cached, because their blocks must all be on the sub-pool's free list when it is
+ * deleted.  A thread's caches are flushed back into their pools when the thread dies, and blocks
+ * released after that (including by the thread's destructors) go straight back to their pools.
+ *
+ * Reference counts and block-use counters are updated using atomic operations, so that adding and
+ * removing references never needs the mutex, whether or not thread caches are enabled.
+ *
  * Copyright (C) Sierra Wireless Inc.
  *
  */
 #include "legato.h"
 #include "mem.h"
 #include "limit.h"
+#include "thread.h"
 
 #define GUARD_WORD ((uint32_t)0xDEADBEEF)
 #define GUARD_BAND_SIZE (sizeof(GUARD_WORD) * LE_CONFIG_NUM_GUARD_BAND_WORDS)
@@ -135,6 +159,33 @@ static le_mem_PoolRef_t SubPoolsPool;
 static pthread_mutex_t Mutex = PTHREAD_MUTEX_INITIALIZER;
 
 
+#if LE_CONFIG_MEM_THREAD_CACHE
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of blocks moved between a thread's magazine and its pool's free list at a time.
+ */
+//--------------------------------------------------------------------------------------------------
+#define CACHE_BATCH_SIZE    (LE_CONFIG_MEM_THREAD_CACHE_SIZE / 2)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * List of the memory pool records of all threads whose blocks can be cached.  Protected by Mutex.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_dls_List_t CacheList = LE_DLS_LIST_INIT;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * true once the thread system has been initialized, and thread records can be looked up.  Set by
+ * the main thread but read by every thread, so only accessed atomically.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool ThreadCachesReady = false;
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Exposing the memory pool list; mainly for the Inspect tool.
@@ -191,6 +242,392 @@ static inline void Unlock
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Adds to the number of blocks in use in a pool, and updates the pool's high-water mark.
+ *
+ * @note    Can be called with or without the mutex locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AddBlocksInUse
+(
+    MemPool_t*  poolPtr,    ///< [IN] The pool.
+    size_t      numBlocks   ///< [IN] The number of blocks that have been taken into use.
+)
+{
+    size_t numInUse = __atomic_add_fetch(&(poolPtr->numBlocksInUse), numBlocks, __ATOMIC_RELAXED);
+    size_t maxUsed = __atomic_load_n(&(poolPtr->maxNumBlocksUsed), __ATOMIC_RELAXED);
+
+    // On failure, maxUsed is refreshed with the current high-water mark.
+    while ((numInUse > maxUsed) &&
+           !__atomic_compare_exchange_n(&(poolPtr->maxNumBlocksUsed),
+                                        &maxUsed,
+                                        numInUse,
+                                        true,
+                                        __ATOMIC_RELAXED,
+                                        __ATOMIC_RELAXED))
+    {
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Subtracts from the number of blocks in use in a pool.
+ *
+ * @note    Can be called with or without the mutex locked.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline void RemoveBlocksInUse
+(
+    MemPool_t*  poolPtr,    ///< [IN] The pool.
+    size_t      numBlocks   ///< [IN] The number of blocks that are no longer in use.
+)
+{
+    __atomic_sub_fetch(&(poolPtr->numBlocksInUse), numBlocks, __ATOMIC_RELAXED);
+}
+
+
+#if LE_CONFIG_MEM_THREAD_CACHE
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Locks a thread's cache mutex.
+     */
+    //----------------------------------------------------------------------------------------------
+    static inline void LockCache
+    (
+        mem_ThreadRec_t* recPtr     ///< [IN] The thread's memory pool record.
+    )
+    {
+        LE_ASSERT(pthread_mutex_lock(&(recPtr->mutex)) == 0);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Unlocks a thread's cache mutex.
+     */
+    //----------------------------------------------------------------------------------------------
+    static inline void UnlockCache
+    (
+        mem_ThreadRec_t* recPtr     ///< [IN] The thread's memory pool record.
+    )
+    {
+        LE_ASSERT(pthread_mutex_unlock(&(recPtr->mutex)) == 0);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Gets the magazine used for a given pool in a thread's memory pool record.
+     */
+    //----------------------------------------------------------------------------------------------
+    static inline mem_Magazine_t* GetMagazine
+    (
+        mem_ThreadRec_t*    recPtr,     ///< [IN] The thread's memory pool record.
+        MemPool_t*          poolPtr     ///< [IN] The pool.
+    )
+    {
+        // Pools are allocated with malloc, so the low bits of their addresses carry no information.
+        size_t index = ((uintptr_t)poolPtr / sizeof(MemPool_t)) % LE_CONFIG_MEM_THREAD_CACHE_POOLS;
+
+        return &(recPtr->magazines[index]);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Moves up to a given number of blocks from one list of free blocks to another.
+     *
+     * @return  The number of blocks moved.
+     */
+    //----------------------------------------------------------------------------------------------
+    static size_t MoveFreeBlocks
+    (
+        le_sls_List_t*  destListPtr,    ///< [IN] The list to move the blocks to.
+        le_sls_List_t*  srcListPtr,     ///< [IN] The list to get the blocks from.
+        size_t          maxBlocks       ///< [IN] The maximum number of blocks to move.
+    )
+    {
+        size_t numBlocks = 0;
+        le_sls_Link_t* blockLinkPtr;
+
+        while ((numBlocks < maxBlocks) && ((blockLinkPtr = le_sls_Pop(srcListPtr)) != NULL))
+        {
+            le_sls_Stack(destListPtr, blockLinkPtr);
+            numBlocks++;
+        }
+
+        return numBlocks;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Empties a magazine, moving its blocks onto a given list.
+     *
+     * @return  The pool the blocks belong to, or NULL if the magazine was not in use.
+     *
+     * @note    Assumes that the magazine's thread cache mutex is locked.
+     */
+    //----------------------------------------------------------------------------------------------
+    static MemPool_t* EmptyMagazine
+    (
+        mem_Magazine_t* magazinePtr,    ///< [IN] The magazine.
+        le_sls_List_t*  listPtr         ///< [OUT] The list to move the blocks to.
+    )
+    {
+        MemPool_t* poolPtr = magazinePtr->poolPtr;
+
+        MoveFreeBlocks(listPtr, &(magazinePtr->blockList), SIZE_MAX);
+        magazinePtr->poolPtr = NULL;
+        magazinePtr->numBlocks = 0;
+
+        return poolPtr;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Puts a list of blocks back on their pool's free list.
+     *
+     * @note    Assumes that the mutex is NOT locked.
+     */
+    //----------------------------------------------------------------------------------------------
+    static void FlushBlocks
+    (
+        MemPool_t*      poolPtr,    ///< [IN] The pool the blocks belong to (can be NULL if the
+                                    ///       list is empty).
+        le_sls_List_t*  listPtr     ///< [IN] The blocks.
+    )
+    {
+        if (!le_sls_IsEmpty(listPtr))
+        {
+            Lock();
+            MoveFreeBlocks(&(poolPtr->freeList), listPtr, SIZE_MAX);
+            Unlock();
+        }
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Takes a pool's blocks out of every thread's cache and puts them back on the pool's free
+     * list.
+     *
+     * @note    Assumes that the mutex is locked, and that the calling thread does not hold its own
+     *          thread cache mutex.
+     */
+    //----------------------------------------------------------------------------------------------
+    static void ReclaimBlocks
+    (
+        MemPool_t* poolPtr  ///< [IN] The pool.
+    )
+    {
+        le_dls_Link_t* linkPtr = le_dls_Peek(&CacheList);
+
+        while (linkPtr != NULL)
+        {
+            mem_ThreadRec_t* recPtr = CONTAINER_OF(linkPtr, mem_ThreadRec_t, link);
+            mem_Magazine_t* magazinePtr = GetMagazine(recPtr, poolPtr);
+
+            LockCache(recPtr);
+            if (magazinePtr->poolPtr == poolPtr)
+            {
+                EmptyMagazine(magazinePtr, &(poolPtr->freeList));
+            }
+            UnlockCache(recPtr);
+
+            linkPtr = le_dls_PeekNext(&CacheList, linkPtr);
+        }
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Gets the calling thread's memory pool record, if blocks from a given pool can be cached by
+     * the calling thread.
+     *
+     * @return  Pointer to the record, or NULL if the blocks cannot be cached.
+     */
+    //----------------------------------------------------------------------------------------------
+    static mem_ThreadRec_t* GetThreadCache
+    (
+        MemPool_t* poolPtr  ///< [IN] The pool.
+    )
+    {
+        if ((!__atomic_load_n(&ThreadCachesReady, __ATOMIC_ACQUIRE))
+            || (poolPtr->superPoolPtr != NULL))
+        {
+            return NULL;
+        }
+
+        // Only the owning thread changes isActive, so no need to lock here.
+        mem_ThreadRec_t* recPtr = thread_TryGetMemRecPtr();
+        if ((recPtr == NULL) || (!recPtr->isActive))
+        {
+            return NULL;
+        }
+
+        return recPtr;
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Allocates a block using the calling thread's cache, refilling the cache from the pool's
+     * free list if it is empty.
+     *
+     * @return  Pointer to the block, or NULL if the pool has no free blocks.
+     *
+     * @note    Assumes that the mutex is NOT locked.
+     */
+    //----------------------------------------------------------------------------------------------
+    static MemBlock_t* CacheAlloc
+    (
+        mem_ThreadRec_t*    recPtr,     ///< [IN] The calling thread's memory pool record.
+        MemPool_t*          poolPtr     ///< [IN] The pool to allocate from.
+    )
+    {
+        mem_Magazine_t* magazinePtr = GetMagazine(recPtr, poolPtr);
+        le_sls_Link_t* blockLinkPtr = NULL;
+
+        LockCache(recPtr);
+        if (magazinePtr->poolPtr == poolPtr)
+        {
+            blockLinkPtr = le_sls_Pop(&(magazinePtr->blockList));
+            if (blockLinkPtr != NULL)
+            {
+                magazinePtr->numBlocks--;
+            }
+        }
+        UnlockCache(recPtr);
+
+        if (blockLinkPtr != NULL)
+        {
+            return CONTAINER_OF(blockLinkPtr, MemBlock_t, link);
+        }
+
+        // The magazine is empty, so take a batch of blocks from the pool, getting them back from
+        // other threads if there are none left on the free list.
+        le_sls_List_t batch = LE_SLS_LIST_INIT;
+
+        Lock();
+        size_t numBlocks = MoveFreeBlocks(&batch, &(poolPtr->freeList), CACHE_BATCH_SIZE);
+        if (numBlocks == 0)
+        {
+            ReclaimBlocks(poolPtr);
+            numBlocks = MoveFreeBlocks(&batch, &(poolPtr->freeList), CACHE_BATCH_SIZE);
+        }
+        Unlock();
+
+        blockLinkPtr = le_sls_Pop(&batch);
+        if (blockLinkPtr == NULL)
+        {
+            return NULL;
+        }
+        numBlocks--;
+
+        // Keep the rest of the batch in the magazine, first emptying it if it holds another pool's
+        // blocks.
+        le_sls_List_t evictedList = LE_SLS_LIST_INIT;
+        MemPool_t* evictedPoolPtr = NULL;
+
+        LockCache(recPtr);
+        if (magazinePtr->poolPtr != poolPtr)
+        {
+            evictedPoolPtr = EmptyMagazine(magazinePtr, &evictedList);
+            magazinePtr->poolPtr = poolPtr;
+        }
+        magazinePtr->numBlocks += MoveFreeBlocks(&(magazinePtr->blockList), &batch, numBlocks);
+        UnlockCache(recPtr);
+
+        FlushBlocks(evictedPoolPtr, &evictedList);
+
+        return CONTAINER_OF(blockLinkPtr, MemBlock_t, link);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Puts a free block in the calling thread's cache, giving half of the cached blocks back to
+     * the pool if the cache is full.
+     *
+     * @note    Assumes that the mutex is NOT locked.
+     */
+    //----------------------------------------------------------------------------------------------
+    static void CacheFree
+    (
+        mem_ThreadRec_t*    recPtr,     ///< [IN] The calling thread's memory pool record.
+        MemBlock_t*         blockPtr    ///< [IN] The block.
+    )
+    {
+        MemPool_t* poolPtr = blockPtr->poolPtr;
+        mem_Magazine_t* magazinePtr = GetMagazine(recPtr, poolPtr);
+        le_sls_List_t flushList = LE_SLS_LIST_INIT;
+        MemPool_t* flushPoolPtr = NULL;
+
+        LockCache(recPtr);
+        if (magazinePtr->poolPtr != poolPtr)
+        {
+            flushPoolPtr = EmptyMagazine(magazinePtr, &flushList);
+            magazinePtr->poolPtr = poolPtr;
+        }
+        else if (magazinePtr->numBlocks >= LE_CONFIG_MEM_THREAD_CACHE_SIZE)
+        {
+            flushPoolPtr = poolPtr;
+            magazinePtr->numBlocks -= MoveFreeBlocks(&flushList,
+                                                     &(magazinePtr->blockList),
+                                                     CACHE_BATCH_SIZE);
+        }
+        le_sls_Stack(&(magazinePtr->blockList), &(blockPtr->link));
+        magazinePtr->numBlocks++;
+        UnlockCache(recPtr);
+
+        FlushBlocks(flushPoolPtr, &flushList);
+    }
+
+
+    //----------------------------------------------------------------------------------------------
+    /**
+     * Thread destructor that gives the dying thread's cached blocks back to their pools.  Blocks
+     * released by the thread after this are put straight back on their pools' free lists.
+     */
+    //----------------------------------------------------------------------------------------------
+    static void ThreadDeathCleanUp
+    (
+        void* context   ///< [IN] The thread's memory pool record.
+    )
+    {
+        mem_ThreadRec_t* recPtr = context;
+        size_t i;
+
+        Lock();
+
+        le_dls_Remove(&CacheList, &(recPtr->link));
+
+        LockCache(recPtr);
+        for (i = 0; i < LE_CONFIG_MEM_THREAD_CACHE_POOLS; i++)
+        {
+            MemPool_t* poolPtr = recPtr->magazines[i].poolPtr;
+
+            if (poolPtr != NULL)
+            {
+                EmptyMagazine(&(recPtr->magazines[i]), &(poolPtr->freeList));
+            }
+        }
+        recPtr->isActive = false;
+        UnlockCache(recPtr);
+
+        Unlock();
+
+        LE_ASSERT(pthread_mutex_destroy(&(recPtr->mutex)) == 0);
+    }
+
+#endif
+
+
 #if LE_CONFIG_USE_GUARD_BAND
 
     //----------------------------------------------------------------------------------------------
@@ -511,6 +948,46 @@ void mem_Init
 }
 
 
+#if LE_CONFIG_MEM_THREAD_CACHE
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes the calling thread's block caches.  Blocks released by the thread are cached from
+ * then on, until the thread dies.
+ */
+//--------------------------------------------------------------------------------------------------
+void mem_ThreadInit
+(
+    void
+)
+{
+    mem_ThreadRec_t* recPtr = thread_TryGetMemRecPtr();
+    size_t i;
+
+    LE_ASSERT(recPtr != NULL);
+
+    // Register the destructor first, as that allocates from a pool.
+    le_thread_AddDestructor(ThreadDeathCleanUp, recPtr);
+
+    LE_ASSERT(pthread_mutex_init(&(recPtr->mutex), NULL) == 0);
+    for (i = 0; i < LE_CONFIG_MEM_THREAD_CACHE_POOLS; i++)
+    {
+        recPtr->magazines[i].poolPtr = NULL;
+        recPtr->magazines[i].numBlocks = 0;
+        recPtr->magazines[i].blockList = LE_SLS_LIST_INIT;
+    }
+    recPtr->link = LE_DLS_LINK_INIT;
+
+    Lock();
+    le_dls_Queue(&CacheList, &(recPtr->link));
+    recPtr->isActive = true;
+    Unlock();
+
+    // The first thread to get here is the main thread, once the thread system is up.
+    __atomic_store_n(&ThreadCachesReady, true, __ATOMIC_RELEASE);
+}
+#endif
+
+
 #if LE_CONFIG_MEM_TRACE
     //----------------------------------------------------------------------------------------------
     /**
@@ -669,6 +1146,11 @@ le_mem_PoolRef_t le_mem_ExpandPool
         if (pool->superPoolPtr)
         {
             // This is a sub-pool so the memory blocks to create must come from the super-pool.
+            #if LE_CONFIG_MEM_THREAD_CACHE
+                // Count the super-pool's blocks that are sitting in thread caches too.
+                ReclaimBlocks(pool->superPoolPtr);
+            #endif
+
             // Check that there are enough blocks in the superpool.
             ssize_t numBlocksToAdd = numObjects - le_sls_NumLinks(&(pool->superPoolPtr->freeList));
 
@@ -685,12 +1167,7 @@ le_mem_PoolRef_t le_mem_ExpandPool
             pool->totalBlocks = pool->totalBlocks + numObjects;
 
             // Update the super-pool's block use counts.
-            pool->superPoolPtr->numBlocksInUse += numObjects;
-
-            if (pool->superPoolPtr->numBlocksInUse > pool->superPoolPtr->maxNumBlocksUsed)
-            {
-                pool->superPoolPtr->maxNumBlocksUsed = pool->superPoolPtr->numBlocksInUse;
-            }
+            AddBlocksInUse(pool->superPoolPtr, numObjects);
         }
         else
         {
@@ -724,36 +1201,54 @@ void* le_mem_TryAlloc
     MemBlock_t* blockPtr = NULL;
     void* userPtr = NULL;
 
-    Lock();
+    #if LE_CONFIG_MEM_THREAD_CACHE
+        mem_ThreadRec_t* recPtr = GetThreadCache(pool);
 
-    #if LE_CONFIG_MEM_POOLS
-        // Pop a link off the pool.
-        le_sls_Link_t* blockLinkPtr = le_sls_Pop(&(pool->freeList));
-
-        if (blockLinkPtr != NULL)
-        {
-            // Get the block from the block link.
-            blockPtr = CONTAINER_OF(blockLinkPtr, MemBlock_t, link);
-        }
-    #else
-        blockPtr = malloc(pool->blockSize);
-
-        if (blockPtr != NULL)
+        if (recPtr != NULL)
         {
-            InitBlock(pool, blockPtr);
+            blockPtr = CacheAlloc(recPtr, pool);
         }
+        else
     #endif
+    {
+        Lock();
+
+        #if LE_CONFIG_MEM_POOLS
+            // Pop a link off the pool.
+            le_sls_Link_t* blockLinkPtr = le_sls_Pop(&(pool->freeList));
+
+            #if LE_CONFIG_MEM_THREAD_CACHE
+                // This thread has no cache, but other threads may be holding free blocks in
+                // theirs.
+                if ((blockLinkPtr == NULL) && (pool->superPoolPtr == NULL))
+                {
+                    ReclaimBlocks(pool);
+                    blockLinkPtr = le_sls_Pop(&(pool->freeList));
+                }
+            #endif
+
+            if (blockLinkPtr != NULL)
+            {
+                // Get the block from the block link.
+                blockPtr = CONTAINER_OF(blockLinkPtr, MemBlock_t, link);
+            }
+        #else
+            blockPtr = malloc(pool->blockSize);
+
+            if (blockPtr != NULL)
+            {
+                InitBlock(pool, blockPtr);
+            }
+        #endif
+
+        Unlock();
+    }
 
     if (blockPtr != NULL)
     {
         // Update the pool and the block.
-        pool->numAllocations++;
-        pool->numBlocksInUse++;
-
-        if (pool->numBlocksInUse > pool->maxNumBlocksUsed)
-        {
-            pool->maxNumBlocksUsed = pool->numBlocksInUse;
-        }
+        __atomic_add_fetch(&(pool->numAllocations), 1, __ATOMIC_RELAXED);
+        AddBlocksInUse(pool, 1);
 
         blockPtr->refCount = 1;
 
@@ -766,8 +1261,6 @@ void* le_mem_TryAlloc
         #endif
     }
 
-    Unlock();
-
     return userPtr;
 }
 
@@ -903,59 +1396,70 @@ void le_mem_Release
         CheckGuardBands(blockPtr);
     #endif
 
-    Lock();
+    size_t oldRefCount = __atomic_load_n(&(blockPtr->refCount), __ATOMIC_RELAXED);
 
-    switch (blockPtr->refCount)
+    // Check for a free block before decrementing, so that its reference count is never wrapped
+    // around.
+    do
+    {
+        if (oldRefCount == 0)
+        {
+            LE_EMERG("Releasing free block.");
+            LE_FATAL("Free block released from pool %p (%s).",
+                     blockPtr->poolPtr,
+                     blockPtr->poolPtr->name);
+        }
+    }
+    while (!__atomic_compare_exchange_n(&(blockPtr->refCount),
+                                        &oldRefCount,
+                                        oldRefCount - 1,
+                                        true,
+                                        __ATOMIC_ACQ_REL,
+                                        __ATOMIC_RELAXED));
+
+    if (oldRefCount == 1)
     {
-        case 1:
+        // The reference count has reached zero.
+        MemPool_t* poolPtr = blockPtr->poolPtr;
+
+        // Call the destructor, if there is one.  The mutex is not held here, so the destructor
+        // can use the memory pool API itself.
+        le_mem_Destructor_t destructor = poolPtr->destructor;
+        if (destructor)
         {
-            MemPool_t* poolPtr = blockPtr->poolPtr;
+            destructor(objPtr);
+        }
 
-            // The reference count has reached zero.
-            blockPtr->refCount = 0;
+        // Release the memory back into the pool.
+        // Note that we don't do this before calling the destructor because the destructor
+        // still needs to access it, but after it goes back on the free list, it could get
+        // reallocated by another thread (or even the destructor itself) and have its
+        // contents clobbered.
+        #if LE_CONFIG_MEM_THREAD_CACHE
+            mem_ThreadRec_t* recPtr = GetThreadCache(poolPtr);
 
-            // Call the destructor, if there is one.
-            if (poolPtr->destructor)
+            if (recPtr != NULL)
             {
-                // Make sure that the destructor is not called with the mutex locked, because
-                // it is not a recursive mutex and therefore will deadlock if locked again by
-                // the same thread.  Also, fetch the destructor function address before unlocking
-                // the mutex so that we don't touch the pool object while the mutex is unlocked.
-                le_mem_Destructor_t destructor = poolPtr->destructor;
-                Unlock();
-                destructor(objPtr);
-
-                // Re-lock the mutex now so that it is safe to access the pool object again.
-                Lock();
+                RemoveBlocksInUse(poolPtr, 1);
+                CacheFree(recPtr, blockPtr);
+                return;
             }
+        #endif
 
-            #if LE_CONFIG_MEM_POOLS
-                // Release the memory back into the pool.
-                // Note that we don't do this before calling the destructor because the destructor
-                // still needs to access it, but after it goes back on the free list, it could get
-                // reallocated by another thread (or even the destructor itself) and have its
-                // contents clobbered.
-                le_sls_Stack(&(poolPtr->freeList), &(blockPtr->link));
-            #else
-                free(blockPtr);
-            #endif
-
-            poolPtr->numBlocksInUse--;
+        Lock();
 
-            break;
-        }
+        #if LE_CONFIG_MEM_POOLS
+            le_sls_Stack(&(poolPtr->freeList), &(blockPtr->link));
+        #else
+            free(blockPtr);
+        #endif
 
-        case 0:
-            LE_EMERG("Releasing free block.");
-            LE_FATAL("Free block released from pool %p (%s).",
-                     blockPtr->poolPtr,
-                     blockPtr->poolPtr->name);
+        // Sub-pools can only be deleted when none of their blocks are in use, so only count the
+        // block as free once it is back on the free list.
+        RemoveBlocksInUse(poolPtr, 1);
 
-        default:
-            blockPtr->refCount--;
+        Unlock();
     }
-
-    Unlock();
 }
 
 
@@ -983,13 +1487,9 @@ void le_mem_AddRef
         CheckGuardBands(memBlockPtr);
     #endif
 
-    Lock();
-
-    LE_ASSERT(memBlockPtr->refCount != 0);
+    size_t oldRefCount = __atomic_fetch_add(&(memBlockPtr->refCount), 1, __ATOMIC_RELAXED);
 
-    memBlockPtr->refCount++;
-
-    Unlock();
+    LE_ASSERT(oldRefCount != 0);
 }
 
 
@@ -1013,7 +1513,7 @@ size_t le_mem_GetRefCount
     #endif
     MemBlock_t* memBlockPtr = CONTAINER_OF(objPtr, MemBlock_t, data);
 
-    return memBlockPtr->refCount;
+    return __atomic_load_n(&(memBlockPtr->refCount), __ATOMIC_RELAXED);
 }
 
 
@@ -1059,11 +1559,15 @@ void le_mem_GetStats
 
     Lock();
 
-    statsPtr->numAllocs = pool->numAllocations;
+    // The block counters are updated atomically, without necessarily holding the mutex.
+    // Blocks cached by threads count as free.
+    size_t numBlocksInUse = __atomic_load_n(&(pool->numBlocksInUse), __ATOMIC_RELAXED);
+
+    statsPtr->numAllocs = __atomic_load_n(&(pool->numAllocations), __ATOMIC_RELAXED);
     statsPtr->numOverflows = pool->numOverflows;
-    statsPtr->numFree = pool->totalBlocks - pool->numBlocksInUse;
-    statsPtr->numBlocksInUse = pool->numBlocksInUse;
-    statsPtr->maxNumBlocksUsed = pool->maxNumBlocksUsed;
+    statsPtr->numFree = pool->totalBlocks - numBlocksInUse;
+    statsPtr->numBlocksInUse = numBlocksInUse;
+    statsPtr->maxNumBlocksUsed = __atomic_load_n(&(pool->maxNumBlocksUsed), __ATOMIC_RELAXED);
 
     Unlock();
 }
@@ -1085,7 +1589,7 @@ void le_mem_ResetStats
     LE_ASSERT(pool != NULL);
 
     Lock();
-    pool->numAllocations = 0;
+    __atomic_store_n(&(pool->numAllocations), 0, __ATOMIC_RELAXED);
     pool->numOverflows = 0;
     Unlock();
 }
@@ -1349,10 +1853,12 @@ void le_mem_DeleteSubPool
     // Make sure all sub-pool objects are free.
     le_mem_PoolRef_t superPool = subPool->superPoolPtr;
 
-    LE_FATAL_IF(subPool->numBlocksInUse != 0,
+    size_t numBlocksInUse = __atomic_load_n(&(subPool->numBlocksInUse), __ATOMIC_RELAXED);
+
+    LE_FATAL_IF(numBlocksInUse != 0,
                 "Subpool '%s' deleted while %zu blocks remain allocated.",
                 subPool->name,
-                subPool->numBlocksInUse);
+                numBlocksInUse);
 
     size_t numBlocks = subPool->totalBlocks;
 
@@ -1360,7 +1866,7 @@ void le_mem_DeleteSubPool
     MoveBlocks(superPool, subPool, numBlocks);
 
     // Update the superPool's block use count.
-    superPool->numBlocksInUse -= numBlocks;
+    RemoveBlocksInUse(superPool, numBlocks);
 
     // Remove the sub-pool from the list of sub-pools.
     PoolListChangeCount++;
@@ -51,6 +51,38 @@ typedef struct le_mem_Pool
 MemPool_t;
 
 
+#if LE_CONFIG_MEM_THREAD_CACHE
+//--------------------------------------------------------------------------------------------------
+/**
+ * A thread's cache of free blocks from one memory pool.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    MemPool_t* poolPtr;                 ///< The pool the cached blocks belong to (NULL if unused).
+    size_t numBlocks;                   ///< Number of blocks on the block list.
+    le_sls_List_t blockList;            ///< List of cached free blocks.
+}
+mem_Magazine_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread record containing the thread's caches of free memory pool blocks.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    le_dls_Link_t link;                 ///< Link in the list of thread caches.
+    pthread_mutex_t mutex;              ///< Protects the magazines.  Only ever contended when
+                                        ///  another thread is reclaiming blocks from this thread.
+    bool isActive;                      ///< true = blocks can be cached for this thread.
+    mem_Magazine_t magazines[LE_CONFIG_MEM_THREAD_CACHE_POOLS]; ///< Caches, indexed by pool.
+}
+mem_ThreadRec_t;
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initializes the memory pool system.  This function must be called before any other memory pool
@@ -66,6 +98,20 @@ void mem_Init
 );
 
 
+#if LE_CONFIG_MEM_THREAD_CACHE
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes the calling thread's block caches.  Blocks released by the thread are cached from
+ * then on, until the thread dies.
+ */
+//--------------------------------------------------------------------------------------------------
+void mem_ThreadInit
+(
+    void
+);
+#endif
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Exposing the memory pool list; mainly for the Inspect tool.
@@ -53,6 +53,13 @@
  * exhausted and attempts to send a message return EAGAIN or EWOULDBLOCK, the Message object is
  * placed on a queue for that socket (in the Session object) and the messaging system waits for
  * notification from the Event Loop that the socket has become clear-to-send before trying again.
+ * Messages sent while others are waiting on the queue join the queue without trying the socket.
+ * When the socket becomes clear-to-send, the queue is drained with sendmmsg(), up to
+ * LE_CONFIG_MSG_BATCH_SIZE messages per system call.  Likewise, messages waiting at the receiving
+ * socket are received with recvmmsg(), into a batch of Message objects allocated beforehand.  The
+ * size of that batch follows the number of messages found waiting on the previous receive.  File
+ * descriptors travel with their own messages in both cases.  Each Session object counts its
+ * messages and system calls, which the inspect tool reports as messages per system call.
  *
  * Another potential deadlock occurs when two threads are sending messages to each other.
  * If they both send a lot of messages to each other, they can both get blocked waiting for the
@@ -85,6 +92,14 @@
  * side.  For all other types of messages, this is set to 0 (NULL) to indicate that it does
  * not belong to a request-response transaction.
  *
+ * If LE_CONFIG_MSG_SHARED_MEMORY is enabled, sessions of protocols with large enough payloads
+ * don't send their payloads through the socket.  Instead, each side of the session puts the
+ * payloads it sends in the slots of a shared memory ring that it creates the first time it
+ * needs it, and only sends the transaction identifier and a small descriptor naming the slot over
+ * the socket.  The receiver copies the payload out of the slot into its Message object and frees
+ * the slot right away, as the sender could still change what's in it.  If no slot is free, the
+ * payload is sent through the socket as usual.  See messagingSharedMem.c for details.
+ *
  * See also @ref serviceDirectoryProtocol.
  *
  * @warning The code in this subsystem @b must be thread safe and re-entrant.
@@ -19,6 +19,303 @@
 //  PRIVATE FUNCTIONS
 // =======================================
 
+#if LE_CONFIG_MSG_SHARED_MEMORY
+//--------------------------------------------------------------------------------------------------
+/**
+ * What is sent over the socket in place of a message whose payload is in shared memory.  This is
+ * always shorter than a full message, which is how the receiver tells the two apart.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    void*               txnId;  ///< Transaction ID, in the same place as in a full message.
+    msgShm_Descriptor_t desc;   ///< Where to find the payload.
+}
+DescriptorMsg_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Make a message's payload a slot in a shared memory ring.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AttachSlot
+(
+    Message_t* msgPtr,
+    msgShm_RingRef_t ringRef,   ///< [IN] The ring.
+    void* slotPtr               ///< [IN] The slot's payload.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_mem_AddRef(ringRef);
+    msgPtr->ringRef = ringRef;
+    msgPtr->payloadPtr = slotPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Make a message's payload its own payload section again, without freeing the slot it was in.
+ * Used when the slot has been handed over to the other side of the session.
+ */
+//--------------------------------------------------------------------------------------------------
+static void DetachSlot
+(
+    Message_t* msgPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_mem_Release(msgPtr->ringRef);
+    msgPtr->ringRef = NULL;
+    msgPtr->payloadPtr = msgPtr->payload;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Free the shared memory slot holding a message's payload, and make its payload its own payload
+ * section again.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FreeSlot
+(
+    Message_t* msgPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    msgShm_FreeSlot(msgPtr->ringRef, msgPtr->payloadPtr);
+    DetachSlot(msgPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the ring that a session sends payloads through, creating it if this is the first time.
+ *
+ * @return The ring, or NULL if the session does not use shared memory.
+ */
+//--------------------------------------------------------------------------------------------------
+static msgShm_RingRef_t GetTxRing
+(
+    le_msg_SessionRef_t sessionRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if ((sessionRef->txRingRef == NULL) && sessionRef->useSharedMem)
+    {
+        le_msg_ProtocolRef_t protocolRef = le_msg_GetSessionProtocol(sessionRef);
+
+        sessionRef->txRingRef = msgShm_CreateRing(le_msg_GetInterfaceName(sessionRef->interfaceRef),
+                                                  le_msg_GetProtocolMaxMsgSize(protocolRef));
+
+        // Don't try again for every message if the system can't give us shared memory.
+        if (sessionRef->txRingRef == NULL)
+        {
+            sessionRef->useSharedMem = false;
+        }
+    }
+
+    return sessionRef->txRingRef;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a shared memory descriptor.
+ *
+ * @return Same as unixSocket_SendMsg().
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t SendDescriptor
+(
+    int                 socketFd,   ///< [IN] Connected socket's file descriptor.
+    void*               txnId,      ///< [IN] Transaction ID of the message.
+    msgShm_DescType_t   type,       ///< [IN] Kind of descriptor.
+    uint32_t            slot,       ///< [IN] Index of the slot holding the payload.
+    uint32_t            size,       ///< [IN] Number of bytes of the payload used.
+    int                 fd          ///< [IN] File descriptor to send with it (-1 = none).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    DescriptorMsg_t descMsg =
+    {
+        .txnId = txnId,
+        .desc = { .magic = MSGSHM_DESCRIPTOR_MAGIC, .type = type, .slot = slot, .size = size }
+    };
+
+    return unixSocket_SendMsg(socketFd, &descMsg, sizeof(descMsg), fd, false);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a message whose session uses shared memory.  The payload is moved into the session's ring
+ * first if it isn't already there.
+ *
+ * @return
+ * - true if the message was handled, with the result stored at resultPtr.
+ * - false if the payload is back in the message's payload section and the message must be sent
+ *   in full.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool SendShared
+(
+    int         socketFd,   ///< [IN] Connected socket's file descriptor.
+    Message_t*  msgPtr,     ///< [IN] The Message to be sent.
+    le_result_t* resultPtr  ///< [OUT] Result of the send.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_msg_SessionRef_t sessionRef = msgPtr->sessionRef;
+    size_t payloadSize = msgPtr->payloadSize;
+    msgShm_RingRef_t txRingRef = GetTxRing(sessionRef);
+
+    // Move the payload into this side's ring if it is somewhere else.
+    if ((txRingRef == NULL) || (msgPtr->ringRef != txRingRef))
+    {
+        void* slotPtr = (txRingRef != NULL) ? msgShm_AllocSlot(txRingRef) : NULL;
+
+        // If the ring is full, the payload has to go through the socket.
+        if (slotPtr == NULL)
+        {
+            if (msgPtr->ringRef != NULL)
+            {
+                memcpy(msgPtr->payload, msgPtr->payloadPtr, payloadSize);
+                FreeSlot(msgPtr);
+            }
+            return false;
+        }
+
+        memcpy(slotPtr, msgPtr->payloadPtr, payloadSize);
+        if (msgPtr->ringRef != NULL)
+        {
+            FreeSlot(msgPtr);
+        }
+        AttachSlot(msgPtr, txRingRef, slotPtr);
+    }
+
+    // The other side needs the ring before it can find anything in it.  Sockets deliver in order,
+    // so it will have the ring before it gets the first descriptor.
+    if (!msgShm_IsShared(txRingRef))
+    {
+        *resultPtr = SendDescriptor(socketFd,
+                                    NULL,
+                                    MSGSHM_DESC_SETUP,
+                                    0,
+                                    0,
+                                    msgShm_GetFd(txRingRef));
+        if (*resultPtr != LE_OK)
+        {
+            return true;
+        }
+        msgShm_SetShared(txRingRef);
+    }
+
+    uint32_t slot = msgShm_GetSlotIndex(txRingRef, msgPtr->payloadPtr);
+
+    *resultPtr = SendDescriptor(socketFd,
+                                msgPtr->txnId,
+                                MSGSHM_DESC_DATA,
+                                slot,
+                                payloadSize,
+                                msgPtr->fd);
+    if (*resultPtr == LE_OK)
+    {
+        // The slot belongs to the other side now, until it frees it.
+        DetachSlot(msgPtr);
+    }
+
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Act on a shared memory descriptor received into a message's payload section.
+ *
+ * The payload named by a DATA descriptor is copied into the message's payload section, and its
+ * slot is freed right away.  The other side can still write to the slot, so the message must not
+ * be read from it in place: what was checked could change before it is used.
+ *
+ * @return
+ * - LE_OK if the message's payload now holds the payload named by the descriptor.
+ * - LE_DUPLICATE if the descriptor was a SETUP descriptor, so there's no message yet.
+ * - LE_FAULT if the descriptor was invalid.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_result_t ReceiveDescriptor
+(
+    Message_t* msgPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    le_msg_SessionRef_t sessionRef = msgPtr->sessionRef;
+    msgShm_Descriptor_t desc;
+    void* slotPtr = NULL;
+
+    memcpy(&desc, msgPtr->payload, sizeof(desc));
+
+    if (desc.magic != MSGSHM_DESCRIPTOR_MAGIC)
+    {
+        LE_ERROR("Received a message of the wrong size.");
+        return LE_FAULT;
+    }
+
+    switch (desc.type)
+    {
+        case MSGSHM_DESC_SETUP:
+        {
+            if (msgPtr->fd < 0)
+            {
+                break;
+            }
+
+            msgShm_RingRef_t ringRef = msgShm_MapRing(msgPtr->fd, le_msg_GetMaxPayloadSize(msgPtr));
+            msgPtr->fd = -1;
+
+            if (ringRef == NULL)
+            {
+                break;
+            }
+
+            if (sessionRef->rxRingRef != NULL)
+            {
+                le_mem_Release(sessionRef->rxRingRef);
+            }
+            sessionRef->rxRingRef = ringRef;
+
+            return LE_DUPLICATE;
+        }
+
+        case MSGSHM_DESC_DATA:
+            if ((sessionRef->rxRingRef != NULL) && (desc.size <= le_msg_GetMaxPayloadSize(msgPtr)))
+            {
+                slotPtr = msgShm_GetPeerSlot(sessionRef->rxRingRef, desc.slot);
+            }
+            if (slotPtr != NULL)
+            {
+                memcpy(msgPtr->payload, slotPtr, desc.size);
+                msgShm_FreeSlot(sessionRef->rxRingRef, slotPtr);
+                msgPtr->payloadSize = desc.size;
+                return LE_OK;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    LE_ERROR("Invalid shared memory descriptor (type %" PRIu32 ", slot %" PRIu32
+             ", size %" PRIu32 ").",
+             desc.type,
+             desc.slot,
+             desc.size);
+
+    return LE_FAULT;
+}
+#endif // LE_CONFIG_MSG_SHARED_MEMORY
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Destructor function for Message objects.
@@ -62,11 +359,149 @@ static void MessageDestructor
         fd_Close(msgPtr->fd);
     }
 
+#if LE_CONFIG_MSG_SHARED_MEMORY
+    // Give the payload's shared memory slot back to the side that created it.
+    if (msgPtr->ringRef != NULL)
+    {
+        FreeSlot(msgPtr);
+    }
+#endif
+
     // Release the Message object's hold on the Session object.
     le_mem_Release(msgPtr->sessionRef);
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates and initializes a Message object for a given session.  The payload is not cleared.
+ *
+ * @return  Pointer to the Message object.
+ */
+//--------------------------------------------------------------------------------------------------
+static Message_t* CreateMessage
+(
+    le_msg_SessionRef_t sessionRef  ///< [in] Reference to the session.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // Get a reference to the Session's Protocol and ask the Protocol to allocate a Message
+    // object from its Message Pool.
+    le_msg_ProtocolRef_t protocolRef = le_msg_GetSessionProtocol(sessionRef);
+    Message_t* msgPtr = msgProto_AllocMessage(protocolRef);
+
+    // Initialize the Message object's data members.
+    msgPtr->link = LE_DLS_LINK_INIT;
+    msgPtr->sessionRef = sessionRef;
+    le_mem_AddRef(sessionRef);  // Message object holds a reference to the Session object.
+
+    msgInterface_Type_t interfaceType = msgSession_GetInterfaceType(sessionRef);
+    switch (interfaceType)
+    {
+        case LE_MSG_INTERFACE_CLIENT:
+            msgPtr->clientServer.client.completionCallback = NULL;
+            msgPtr->clientServer.client.contextPtr = NULL;
+            break;
+
+        case LE_MSG_INTERFACE_SERVER:
+            msgPtr->clientServer.server.responseFd = -1;
+            break;
+
+        default:
+            LE_FATAL("Unhandled interface type (%d).", interfaceType);
+    }
+
+    msgPtr->fd = -1;
+    msgPtr->payloadPtr = msgPtr->payload;
+#if LE_CONFIG_MSG_SHARED_MEMORY
+    msgPtr->ringRef = NULL;
+#endif
+    msgPtr->payloadSize = le_msg_GetProtocolMaxMsgSize(protocolRef);
+    msgPtr->txnId = 0;
+
+    return msgPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Clear the part of a received message's payload buffer that the message didn't fill, so that
+ * nothing is left there from an earlier message, which may have come from another session.
+ * Full-size messages leave nothing to clear.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ClearUnreceived
+(
+    Message_t* msgPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t maxPayloadSize = le_msg_GetMaxPayloadSize(msgPtr);
+
+    memset((uint8_t*)msgPtr->payloadPtr + msgPtr->payloadSize,
+           0,
+           maxPayloadSize - msgPtr->payloadSize);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the number of bytes to send for a message that goes through the socket in full, starting
+ * with its transaction ID.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetSendSize
+(
+    Message_t* msgPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t payloadSize = msgPtr->payloadSize;
+
+#if LE_CONFIG_MSG_SHARED_MEMORY
+    // The receiver tells descriptors apart from full messages by their size, so full messages of
+    // protocols that may use shared memory must stay longer than a descriptor.
+    if ((payloadSize < sizeof(DescriptorMsg_t))
+        && msgShm_IsEligible(le_msg_GetMaxPayloadSize(msgPtr)))
+    {
+        payloadSize = sizeof(DescriptorMsg_t);
+    }
+#endif
+
+    return sizeof(msgPtr->txnId) + payloadSize;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a message ready to be sent.  For a response message, this puts the fd to send back to the
+ * client where the fd to send is expected.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PrepareToSend
+(
+    Message_t* msgPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    // If this is a response message,
+    if (le_msg_NeedsResponse(msgPtr))
+    {
+        // If there was an fd that was received from the client but not fetched from the message
+        // generate a warning and close that fd.
+        if (msgPtr->fd >= 0)
+        {
+            LE_WARN("File descriptor not retrieved from message received from client.");
+            fd_Close(msgPtr->fd);
+        }
+
+        // Move the responseFd to the normal fd position in the message object.
+        msgPtr->fd = msgPtr->clientServer.server.responseFd;
+        msgPtr->clientServer.server.responseFd = -1;
+    }
+}
+
+
 // =======================================
 //  PROTECTED (INTER-MODULE) FUNCTIONS
 // =======================================
@@ -83,7 +518,9 @@ void msgMessage_Init
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Don't actually need to do anything here.
+#if LE_CONFIG_MSG_SHARED_MEMORY
+    msgShm_Init();
+#endif
 }
 
 
@@ -142,32 +579,98 @@ le_result_t msgMessage_Send
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // If this is a response message,
-    if (le_msg_NeedsResponse(msgPtr))
+    PrepareToSend(msgPtr);
+
+#if LE_CONFIG_MSG_SHARED_MEMORY
+    le_result_t result;
+
+    if (msgPtr->sessionRef->useSharedMem || (msgPtr->ringRef != NULL))
     {
-        // If there was an fd that was received from the client but not fetched from the message
-        // generate a warning and close that fd.
-        if (msgPtr->fd >= 0)
+        if (SendShared(socketFd, msgPtr, &result))
         {
-            LE_WARN("File descriptor not retrieved from message received from client.");
-            fd_Close(msgPtr->fd);
+            return result;
         }
-
-        // Move the responseFd to the normal fd position in the message object.
-        msgPtr->fd = msgPtr->clientServer.server.responseFd;
-        msgPtr->clientServer.server.responseFd = -1;
     }
+#endif
 
     // The first bytes come from our transaction ID and the rest (if any)
     // from our Message object's payload section, which comes right after the transaction ID.
     return unixSocket_SendMsg(  socketFd,
                                 &msgPtr->txnId,
-                                sizeof(msgPtr->txnId) + le_msg_GetMaxPayloadSize(msgPtr),
+                                GetSendSize(msgPtr),
                                 msgPtr->fd,
                                 false   ); // Don't send process credentials.
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a batch of messages over a connected socket, in order, using as few system calls as
+ * possible.  Stops at the first message that can't be sent.
+ *
+ * @return
+ * - LE_OK if at least one message was sent.  Fewer than msgCount may have been sent.
+ * - LE_NO_MEMORY if the socket doesn't have enough send buffer space available right now.
+ * - LE_COMM_ERROR if the localSocketFd is not connected.
+ * - LE_FAULT if failed for some other reason (check your logs).
+ *
+ * @note    Won't return LE_NO_MEMORY if the socket is in blocking mode.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgMessage_SendBatch
+(
+    int                 socketFd,   ///< [IN] Connected socket's file descriptor.
+    le_msg_MessageRef_t msgRefs[],  ///< [IN] The Messages to be sent.
+    size_t              msgCount,   ///< [IN] Number of Messages (at most LE_CONFIG_MSG_BATCH_SIZE).
+    size_t*             sentCountPtr///< [OUT] Number of Messages sent.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    unixSocket_MsgBuff_t buffs[LE_CONFIG_MSG_BATCH_SIZE];
+    size_t i;
+
+    LE_ASSERT((msgCount > 0) && (msgCount <= LE_CONFIG_MSG_BATCH_SIZE));
+
+    *sentCountPtr = 0;
+
+#if LE_CONFIG_MSG_SHARED_MEMORY
+    // Messages that may go through shared memory are sent one at a time, as their payloads can
+    // end up in the socket or in a ring, and their rings may have to be sent first.
+    if (msgRefs[0]->sessionRef->useSharedMem || (msgRefs[0]->ringRef != NULL))
+    {
+        msgCount = 1;
+    }
+#endif
+
+    if (msgCount == 1)
+    {
+        le_result_t result = msgMessage_Send(socketFd, msgRefs[0]);
+
+        if (result == LE_OK)
+        {
+            *sentCountPtr = 1;
+        }
+
+        return result;
+    }
+
+    for (i = 0; i < msgCount; i++)
+    {
+        Message_t* msgPtr = msgRefs[i];
+
+        PrepareToSend(msgPtr);
+
+        // As in msgMessage_Send(), the data starts at the transaction ID and runs into the
+        // payload section.
+        buffs[i].dataPtr = &msgPtr->txnId;
+        buffs[i].dataSize = GetSendSize(msgPtr);
+        buffs[i].fd = msgPtr->fd;
+    }
+
+    return unixSocket_SendMsgBatch(socketFd, buffs, msgCount, sentCountPtr);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Receive a single message from a connected socket.
@@ -186,14 +689,52 @@ le_result_t msgMessage_Receive
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Receive the first bytes into our transaction ID and the rest (if any)
-    // into our Message object's payload section.
-    size_t byteCount = sizeof(msgRef->txnId) + le_msg_GetMaxPayloadSize(msgRef);
-    le_result_t result = unixSocket_ReceiveMsg( socketFd,
-                                                &msgRef->txnId,
-                                                &byteCount,
-                                                &msgRef->fd,
-                                                NULL    );  // Don't receive credentials.
+    size_t payloadSize = le_msg_GetMaxPayloadSize(msgRef);
+    size_t byteCount;
+    le_result_t result;
+
+    for (;;)
+    {
+        // Receive the first bytes into our transaction ID and the rest (if any)
+        // into our Message object's payload section.
+        byteCount = sizeof(msgRef->txnId) + payloadSize;
+        result = unixSocket_ReceiveMsg( socketFd,
+                                        &msgRef->txnId,
+                                        &byteCount,
+                                        &msgRef->fd,
+                                        NULL    );  // Don't receive credentials.
+
+        if (result == LE_OK)
+        {
+            msgRef->payloadSize = (byteCount > sizeof(msgRef->txnId)) ?
+                                      byteCount - sizeof(msgRef->txnId) : 0;
+        }
+
+#if LE_CONFIG_MSG_SHARED_MEMORY
+        // Full messages of protocols that use shared memory are always bigger than a descriptor.
+        if ((result == LE_OK)
+            && (byteCount == sizeof(DescriptorMsg_t))
+            && msgShm_IsEligible(payloadSize))
+        {
+            // Sets the payload size from the descriptor.
+            result = ReceiveDescriptor(msgRef);
+
+            // A SETUP descriptor is followed by the message that needs it.
+            if (result == LE_DUPLICATE)
+            {
+                continue;
+            }
+        }
+#endif
+
+        break;
+    }
+
+    if (result == LE_OK)
+    {
+        ClearUnreceived(msgRef);
+    }
+
     if (msgSession_GetInterfaceType(msgRef->sessionRef) == LE_MSG_INTERFACE_SERVER)
     {
         msgRef->clientServer.server.responseFd = -1;
@@ -203,6 +744,127 @@ le_result_t msgMessage_Receive
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receive a batch of messages from a connected socket using as few system calls as possible.
+ * Doesn't wait for more messages to arrive than are already waiting on the socket.
+ *
+ * The Messages received are moved to the front of msgRefs[], in the order they were received.
+ * Messages that were cut short because they didn't fit are dropped and moved behind them.
+ *
+ * @return
+ * - LE_OK if at least one message was received.  *receivedCountPtr may still be 0 if all of them
+ *         were dropped.
+ * - LE_WOULD_BLOCK if there's nothing there to receive.
+ * - LE_CLOSED if the connection has closed.
+ * - LE_COMM_ERROR if an error was encountered.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgMessage_ReceiveBatch
+(
+    int                 socketFd,       ///< [IN] The socket's file descriptor.
+    le_msg_MessageRef_t msgRefs[],      ///< [IN+OUT] Message objects to store the received
+                                        ///     messages in.
+    size_t              msgCount,       ///< [IN] Number of Message objects (at most
+                                        ///     LE_CONFIG_MSG_BATCH_SIZE).
+    size_t*             receivedCountPtr///< [OUT] Number of Messages received.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    unixSocket_MsgBuff_t buffs[LE_CONFIG_MSG_BATCH_SIZE];
+    size_t payloadSize = le_msg_GetMaxPayloadSize(msgRefs[0]);
+    size_t batchCount;
+    size_t i;
+
+    LE_ASSERT((msgCount > 0) && (msgCount <= LE_CONFIG_MSG_BATCH_SIZE));
+
+    *receivedCountPtr = 0;
+
+#if LE_CONFIG_MSG_SHARED_MEMORY
+    // Descriptors for payloads in shared memory are received one at a time, as a SETUP descriptor
+    // isn't a message by itself.
+    if (msgShm_IsEligible(payloadSize))
+    {
+        le_result_t result = msgMessage_Receive(socketFd, msgRefs[0]);
+
+        if (result == LE_OK)
+        {
+            *receivedCountPtr = 1;
+        }
+
+        return result;
+    }
+#endif
+
+    for (i = 0; i < msgCount; i++)
+    {
+        // Receive the first bytes into the transaction ID and the rest into the payload section.
+        buffs[i].dataPtr = &msgRefs[i]->txnId;
+        buffs[i].dataSize = sizeof(msgRefs[i]->txnId) + payloadSize;
+    }
+
+    le_result_t result = unixSocket_ReceiveMsgBatch(socketFd, buffs, msgCount, &batchCount);
+
+    switch (result)
+    {
+        case LE_OK:
+        case LE_WOULD_BLOCK:
+        case LE_CLOSED:
+            break;
+
+        default:
+            return LE_COMM_ERROR;
+    }
+
+    for (i = 0; i < batchCount; i++)
+    {
+        le_msg_MessageRef_t msgRef = msgRefs[i];
+
+        msgRef->fd = buffs[i].fd;
+
+        if (msgSession_GetInterfaceType(msgRef->sessionRef) == LE_MSG_INTERFACE_SERVER)
+        {
+            msgRef->clientServer.server.responseFd = -1;
+        }
+
+        if (buffs[i].result != LE_OK)
+        {
+            LE_ERROR("Discarding message of more than %zu bytes.", payloadSize);
+            continue;
+        }
+
+        msgRef->payloadSize = (buffs[i].dataSize > sizeof(msgRef->txnId)) ?
+                                  buffs[i].dataSize - sizeof(msgRef->txnId) : 0;
+        ClearUnreceived(msgRef);
+
+        // Keep the received messages together at the front, in order.
+        msgRefs[i] = msgRefs[*receivedCountPtr];
+        msgRefs[*receivedCountPtr] = msgRef;
+        (*receivedCountPtr)++;
+    }
+
+    return result;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a message to receive into.  Unlike le_msg_CreateMsg(), the payload is not cleared here,
+ * as the receive overwrites it; only the part that the received message doesn't fill is cleared.
+ *
+ * @return  The message reference.
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_MessageRef_t msgMessage_CreateForReceive
+(
+    le_msg_SessionRef_t sessionRef  ///< [IN] Reference to the session.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return CreateMessage(sessionRef);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Call the completion callback function for a given message, if it has one.
@@ -245,35 +907,27 @@ le_msg_MessageRef_t le_msg_CreateMsg
 )
 //--------------------------------------------------------------------------------------------------
 {
-    // Get a reference to the Session's Protocol and ask the Protocol to allocate a Message
-    // object from its Message Pool.
-    le_msg_ProtocolRef_t protocolRef = le_msg_GetSessionProtocol(sessionRef);
-    Message_t* msgPtr = msgProto_AllocMessage(protocolRef);
-
-    // Initialize the Message object's data members.
-    msgPtr->link = LE_DLS_LINK_INIT;
-    msgPtr->sessionRef = sessionRef;
-    le_mem_AddRef(sessionRef);  // Message object holds a reference to the Session object.
-
-    msgInterface_Type_t interfaceType = msgSession_GetInterfaceType(sessionRef);
-    switch (interfaceType)
+    Message_t* msgPtr = CreateMessage(sessionRef);
+
+#if LE_CONFIG_MSG_SHARED_MEMORY
+    // Build the payload straight into the session's shared memory ring if there's room, so that
+    // sending it doesn't need any copying.  Only the thread that owns the session can allocate
+    // slots from the ring.
+    if (sessionRef->useSharedMem
+        && (sessionRef->state == LE_MSG_SESSION_STATE_OPEN)
+        && (le_thread_GetCurrent() == sessionRef->threadRef))
     {
-        case LE_MSG_INTERFACE_CLIENT:
-            msgPtr->clientServer.client.completionCallback = NULL;
-            msgPtr->clientServer.client.contextPtr = NULL;
-            break;
-
-        case LE_MSG_INTERFACE_SERVER:
-            msgPtr->clientServer.server.responseFd = -1;
-            break;
+        msgShm_RingRef_t txRingRef = GetTxRing(sessionRef);
+        void* slotPtr = (txRingRef != NULL) ? msgShm_AllocSlot(txRingRef) : NULL;
 
-        default:
-            LE_FATAL("Unhandled interface type (%d).", interfaceType);
+        if (slotPtr != NULL)
+        {
+            AttachSlot(msgPtr, txRingRef, slotPtr);
+        }
     }
+#endif
 
-    msgPtr->fd = -1;
-    msgPtr->txnId = 0;
-    memset(msgPtr->payload, 0, le_msg_GetProtocolMaxMsgSize(protocolRef));
+    memset(msgPtr->payloadPtr, 0, le_msg_GetMaxPayloadSize(msgPtr));
 
     return msgPtr;
 }
@@ -351,7 +1005,7 @@ void* le_msg_GetPayloadPtr
 )
 //--------------------------------------------------------------------------------------------------
 {
-    return msgRef->payload;
+    return msgRef->payloadPtr;
 }
 
 
@@ -372,6 +1026,49 @@ size_t le_msg_GetMaxPayloadSize
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sets the number of bytes of the message payload to send, starting from the beginning of the
+ * payload buffer.  By default, the whole payload buffer is sent.
+ *
+ * @note A size larger than the payload buffer is a fatal error.
+ */
+//--------------------------------------------------------------------------------------------------
+void le_msg_SetPayloadSize
+(
+    le_msg_MessageRef_t msgRef,     ///< [in] Reference to the message.
+    size_t              payloadSize ///< [in] Number of bytes to send.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (payloadSize > le_msg_GetMaxPayloadSize(msgRef))
+    {
+        LE_FATAL("Payload size %zu is larger than the payload buffer (%zu bytes).",
+                 payloadSize,
+                 le_msg_GetMaxPayloadSize(msgRef));
+    }
+
+    msgRef->payloadSize = payloadSize;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the number of bytes of the message payload that were received, or that will be sent.
+ *
+ * @return The size, in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+size_t le_msg_GetPayloadSize
+(
+    le_msg_MessageRef_t msgRef      ///< [in] Reference to the message.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return msgRef->payloadSize;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Sets the file descriptor to be sent with this message.
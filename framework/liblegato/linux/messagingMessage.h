@@ -8,6 +8,8 @@
 #ifndef LEGATO_MESSAGING_MESSAGE_H_INCLUDE_GUARD
 #define LEGATO_MESSAGING_MESSAGE_H_INCLUDE_GUARD
 
+#include "messagingSharedMem.h"
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Represents a message.
@@ -41,6 +43,12 @@ typedef struct le_msg_Message
     clientServer;
 
     int                         fd;         ///< File descriptor to send or received (-1 = no fd)
+    void*                       payloadPtr; ///< Payload buffer: either the payload section below,
+                                            ///  or a slot in a shared memory ring.
+#if LE_CONFIG_MSG_SHARED_MEMORY
+    msgShm_RingRef_t            ringRef;    ///< Ring holding the payload (NULL = payload section).
+#endif
+    size_t                      payloadSize;///< Bytes of payload to send, or that were received.
     void*                       txnId;      ///< Safe reference value used as a transaction ID.
     void*                       payload[0]; ///< Variable-length payload buffer appears at the end.
 }
@@ -90,6 +98,26 @@ le_result_t msgMessage_Send
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a batch of messages over a connected socket, in order, using as few system calls as
+ * possible.  Stops at the first message that can't be sent.
+ *
+ * @return
+ * - LE_OK if at least one message was sent.  Fewer than msgCount may have been sent.
+ * - LE_NO_MEMORY if the socket doesn't have enough send buffer space available right now.
+ * - LE_COMM_ERROR if the socket reported an error on the send operation.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgMessage_SendBatch
+(
+    int                 socketFd,   ///< [IN] Connected socket's file descriptor.
+    le_msg_MessageRef_t msgRefs[],  ///< [IN] The Messages to be sent.
+    size_t              msgCount,   ///< [IN] Number of Messages (at most LE_CONFIG_MSG_BATCH_SIZE).
+    size_t*             sentCountPtr///< [OUT] Number of Messages sent.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Receive a single message from a connected socket.
@@ -108,6 +136,46 @@ le_result_t msgMessage_Receive
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receive a batch of messages from a connected socket using as few system calls as possible.
+ * Doesn't wait for more messages to arrive than are already waiting on the socket.
+ *
+ * The Messages received are moved to the front of msgRefs[], in the order they were received.
+ * Messages that were cut short because they didn't fit are dropped and moved behind them.
+ *
+ * @return
+ * - LE_OK if at least one message was received.  *receivedCountPtr may still be 0 if all of them
+ *         were dropped.
+ * - LE_WOULD_BLOCK if there's nothing there to receive.
+ * - LE_CLOSED if the connection has closed.
+ * - LE_COMM_ERROR if an error was encountered.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t msgMessage_ReceiveBatch
+(
+    int                 socketFd,       ///< [IN] The socket's file descriptor.
+    le_msg_MessageRef_t msgRefs[],      ///< [IN+OUT] Message objects to store the received
+                                        ///     messages in.
+    size_t              msgCount,       ///< [IN] Number of Message objects (at most
+                                        ///     LE_CONFIG_MSG_BATCH_SIZE).
+    size_t*             receivedCountPtr///< [OUT] Number of Messages received.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a message to receive into.  Unlike le_msg_CreateMsg(), the payload is not cleared.
+ *
+ * @return  The message reference.
+ */
+//--------------------------------------------------------------------------------------------------
+le_msg_MessageRef_t msgMessage_CreateForReceive
+(
+    le_msg_SessionRef_t sessionRef  ///< [IN] Reference to the session.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets a pointer to the queue link inside a Message object.
@@ -93,10 +93,12 @@ static void AttemptOpen(msgSession_Session_t* sessionPtr);
 /**
  * Pushes a message onto the tail of the Transmit Queue.
  *
+ * @return true if the queue was empty before.
+ *
  * @note    This is used on both the client side and the server side.
  */
 //--------------------------------------------------------------------------------------------------
-static void PushTransmitQueue
+static bool PushTransmitQueue
 (
     msgSession_Session_t*   sessionPtr,
     le_msg_MessageRef_t     msgRef
@@ -104,10 +106,14 @@ static void PushTransmitQueue
 //--------------------------------------------------------------------------------------------------
 {
     le_dls_Link_t* linkPtr = msgMessage_GetQueueLinkPtr(msgRef);
+    bool wasEmpty;
 
     LOCK
+    wasEmpty = le_dls_IsEmpty(&sessionPtr->transmitQueue);
     le_dls_Queue(&sessionPtr->transmitQueue, linkPtr);
     UNLOCK
+
+    return wasEmpty;
 }
 
 
@@ -450,6 +456,19 @@ static msgSession_Session_t* CreateSession
 
     sessionPtr->interfaceRef = interfaceRef;
 
+    sessionPtr->rxBatchSize = 1;
+    sessionPtr->txMsgCount = 0;
+    sessionPtr->txCallCount = 0;
+    sessionPtr->rxMsgCount = 0;
+    sessionPtr->rxCallCount = 0;
+
+#if LE_CONFIG_MSG_SHARED_MEMORY
+    sessionPtr->useSharedMem =
+        msgShm_IsEligible(le_msg_GetProtocolMaxMsgSize(le_msg_GetInterfaceProtocol(interfaceRef)));
+    sessionPtr->txRingRef = NULL;
+    sessionPtr->rxRingRef = NULL;
+#endif
+
     SessionObjListChangeCount++;
     msgInterface_AddSession(interfaceRef, sessionPtr);
 
@@ -497,6 +516,20 @@ static void CloseSession
     }
     PurgeTransmitQueue(sessionPtr);
     PurgeReceiveQueue(sessionPtr);
+
+#if LE_CONFIG_MSG_SHARED_MEMORY
+    // Messages still using the shared memory rings hold their own references to them.
+    if (sessionPtr->txRingRef != NULL)
+    {
+        le_mem_Release(sessionPtr->txRingRef);
+        sessionPtr->txRingRef = NULL;
+    }
+    if (sessionPtr->rxRingRef != NULL)
+    {
+        le_mem_Release(sessionPtr->rxRingRef);
+        sessionPtr->rxRingRef = NULL;
+    }
+#endif
 }
 
 
@@ -900,9 +933,39 @@ static void ClientSocketError
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the largest number of messages a session can receive with one system call.
+ *
+ * @return The number of messages.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetMaxReceiveBatchSize
+(
+    msgSession_Session_t* sessionPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+#if LE_CONFIG_MSG_SHARED_MEMORY
+    // Descriptors of payloads in shared memory are received one at a time.
+    if (msgShm_IsEligible(le_msg_GetProtocolMaxMsgSize(le_msg_GetSessionProtocol(sessionPtr))))
+    {
+        return 1;
+    }
+#endif
+
+    return LE_CONFIG_MSG_BATCH_SIZE;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Receive messages from the socket and put them on the Receive Queue.
+ *
+ * Messages are received in batches, into Message objects allocated before each receive.  The size
+ * of the batch follows the number of messages that were waiting the last time: it doubles each
+ * time a whole batch is received, up to GetMaxReceiveBatchSize(), and shrinks back to the number
+ * of messages received once the socket has been drained.
  */
 //--------------------------------------------------------------------------------------------------
 static void ReceiveMessages
@@ -911,25 +974,55 @@ static void ReceiveMessages
 )
 //--------------------------------------------------------------------------------------------------
 {
+    le_msg_MessageRef_t msgRefs[LE_CONFIG_MSG_BATCH_SIZE];
+    size_t maxBatchSize = GetMaxReceiveBatchSize(sessionPtr);
+
     for (;;)
     {
-        // Create a Message object.
-        le_msg_MessageRef_t msgRef = le_msg_CreateMsg(sessionPtr);
+        size_t batchSize = sessionPtr->rxBatchSize;
+        size_t receivedCount;
+        size_t i;
 
-        // Receive from the socket into the Message object.
-        le_result_t result = msgMessage_Receive(sessionPtr->socketFd, msgRef);
+        // Create the Message objects.
+        for (i = 0; i < batchSize; i++)
+        {
+            msgRefs[i] = msgMessage_CreateForReceive(sessionPtr);
+        }
 
-        if (result == LE_OK)
+        // Receive from the socket into the Message objects.
+        le_result_t result = msgMessage_ReceiveBatch(sessionPtr->socketFd,
+                                                     msgRefs,
+                                                     batchSize,
+                                                     &receivedCount);
+        sessionPtr->rxCallCount++;
+        sessionPtr->rxMsgCount += receivedCount;
+
+        // Push what was received onto the Receive Queue for later processing, and release the
+        // Message objects that weren't needed.
+        for (i = 0; i < receivedCount; i++)
         {
-            // Received something.  Push it onto the Receive Queue for later processing.
-            PushReceiveQueue(sessionPtr, msgRef);
+            PushReceiveQueue(sessionPtr, msgRefs[i]);
         }
-        else
+        for (; i < batchSize; i++)
+        {
+            le_msg_ReleaseMsg(msgRefs[i]);
+        }
+
+        if (result != LE_OK)
         {
             // Nothing left to receive from the socket.  We are done.
-            le_msg_ReleaseMsg(msgRef);
             break;
         }
+
+        if (receivedCount < batchSize)
+        {
+            // The socket has been drained.  Get the next batch ready for as many messages.
+            sessionPtr->rxBatchSize = (receivedCount > 0) ? receivedCount : 1;
+            break;
+        }
+
+        // There may be more waiting.  Try a bigger batch.
+        sessionPtr->rxBatchSize = (batchSize * 2 < maxBatchSize) ? batchSize * 2 : maxBatchSize;
     }
 }
 
@@ -980,10 +1073,58 @@ static void ServerSocketError
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finish with a message that has been sent.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FinishSentMessage
+(
+    msgSession_Session_t* sessionPtr,
+    le_msg_MessageRef_t msgRef
+)
+//--------------------------------------------------------------------------------------------------
+{
+    switch (sessionPtr->interfaceRef->interfaceType)
+    {
+        // If this is the client side of the session,
+        case LE_MSG_INTERFACE_CLIENT:
+            // If a response is expected from the other side later, then put this
+            // message on the Transaction List.
+            if (msgMessage_GetTxnId(msgRef) != 0)
+            {
+                AddToTxnList(sessionPtr, msgRef);
+            }
+            // Otherwise, release it.
+            else
+            {
+                le_msg_ReleaseMsg(msgRef);
+            }
+
+            break;
+
+        // If this is the server side of the session,
+        case LE_MSG_INTERFACE_SERVER:
+            // Release the message, but first clear out the transaction ID so that
+            // the message knows that it is not being deleted without a reponse message
+            // being sent if one was expected.
+            msgMessage_SetTxnId(msgRef, 0);
+            le_msg_ReleaseMsg(msgRef);
+
+            break;
+
+        default:
+            LE_FATAL("Unhandled interface type (%d)",
+                     sessionPtr->interfaceRef->interfaceType);
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Send messages from a session's Transmit Queue until either the socket becomes full or there
- * are no more messages waiting on the queue.
+ * are no more messages waiting on the queue.  Messages are sent in batches of up to
+ * LE_CONFIG_MSG_BATCH_SIZE per system call.
  */
 //--------------------------------------------------------------------------------------------------
 static void SendFromTransmitQueue
@@ -992,11 +1133,27 @@ static void SendFromTransmitQueue
 )
 //--------------------------------------------------------------------------------------------------
 {
+    le_msg_MessageRef_t msgRefs[LE_CONFIG_MSG_BATCH_SIZE];
+
     for (;;)
     {
-        le_msg_MessageRef_t msgRef = PopTransmitQueue(sessionPtr);
+        size_t msgCount = 0;
+        size_t sentCount;
+        size_t i;
 
-        if (msgRef == NULL)
+        while (msgCount < LE_CONFIG_MSG_BATCH_SIZE)
+        {
+            le_msg_MessageRef_t msgRef = PopTransmitQueue(sessionPtr);
+
+            if (msgRef == NULL)
+            {
+                break;
+            }
+
+            msgRefs[msgCount++] = msgRef;
+        }
+
+        if (msgCount == 0)
         {
             // Since the Transmit Queue is empty, tell the FD Monitor that we don't need to be
             // notified about writeability anymore.
@@ -1004,51 +1161,32 @@ static void SendFromTransmitQueue
             break;
         }
 
-        le_result_t result = msgMessage_Send(sessionPtr->socketFd, msgRef);
+        le_result_t result = msgMessage_SendBatch(sessionPtr->socketFd,
+                                                  msgRefs,
+                                                  msgCount,
+                                                  &sentCount);
+        sessionPtr->txCallCount++;
+        sessionPtr->txMsgCount += sentCount;
+
+        for (i = 0; i < sentCount; i++)
+        {
+            FinishSentMessage(sessionPtr, msgRefs[i]);
+        }
+
+        // Put the messages that weren't sent back on the head of the queue, in order.
+        for (i = msgCount; i > sentCount; i--)
+        {
+            UnPopTransmitQueue(sessionPtr, msgRefs[i - 1]);
+        }
 
         switch (result)
         {
             case LE_OK:
-                switch (sessionPtr->interfaceRef->interfaceType)
-                {
-                    // If this is the client side of the session,
-                    case LE_MSG_INTERFACE_CLIENT:
-                        // If a response is expected from the other side later, then put this
-                        // message on the Transaction List.
-                        if (msgMessage_GetTxnId(msgRef) != 0)
-                        {
-                            AddToTxnList(sessionPtr, msgRef);
-                        }
-                        // Otherwise, release it.
-                        else
-                        {
-                            le_msg_ReleaseMsg(msgRef);
-                        }
-
-                        break;
-
-                    // If this is the server side of the session,
-                    case LE_MSG_INTERFACE_SERVER:
-                        // Release the message, but first clear out the transaction ID so that
-                        // the message knows that it is not being deleted without a reponse message
-                        // being sent if one was expected.
-                        msgMessage_SetTxnId(msgRef, 0);
-                        le_msg_ReleaseMsg(msgRef);
-
-                        break;
-
-                    default:
-                        LE_FATAL("Unhandled interface type (%d)",
-                                 sessionPtr->interfaceRef->interfaceType);
-                }
-
-                break;  // Continue to loop around and send another.
+                break;  // Continue to loop around and send more.
 
             case LE_NO_MEMORY:
-                // Have to wait for the socket to become writeable.  Put the message back on
-                // the head of the queue and ask the FD Monitor to tell us when the socket becomes
-                // writeable again.
-                UnPopTransmitQueue(sessionPtr, msgRef);
+                // Have to wait for the socket to become writeable.  Ask the FD Monitor to tell
+                // us when the socket becomes writeable again.
                 EnableWriteabilityNotification(sessionPtr);
 
                 return;
@@ -1056,10 +1194,8 @@ static void SendFromTransmitQueue
             case LE_COMM_ERROR:
                 // In this case, we expect a handler function to be called by the FD Monitor,
                 // so we don't need to handle this case here.  However, we must stop
-                // trying to transmit now.  Stick the current message back on the Transmit Queue
-                // so it gets cleaned up with the others when the session closes.
-                UnPopTransmitQueue(sessionPtr, msgRef);
-
+                // trying to transmit now.  The messages that weren't sent are back on the
+                // Transmit Queue, so they get cleaned up with the others when the session closes.
                 return;
 
             default:
@@ -1600,12 +1736,11 @@ void msgSession_SendMessage
 
         le_msg_ReleaseMsg(messageRef);
     }
-    else
+    // Put the message on the Transmit Queue.  If other messages were already waiting there for
+    // the socket to become writeable, this one will be sent in the same batch as them.
+    // Otherwise, try to send it now.
+    else if (PushTransmitQueue(sessionRef, messageRef))
     {
-        // Put the message on the Transmit Queue.
-        PushTransmitQueue(sessionRef, messageRef);
-
-        // Try to send something from the Transmit Queue.
         SendFromTransmitQueue(sessionRef);
     }
 }
@@ -1636,11 +1771,13 @@ void msgSession_RequestResponse
     // Create an ID for this transaction.
     CreateTxnId(msgRef);
 
-    // Put the message on the Transmit Queue.
-    PushTransmitQueue(sessionRef, msgRef);
-
-    // Try to send something from the Transmit Queue.
-    SendFromTransmitQueue(sessionRef);
+    // Put the message on the Transmit Queue.  If other messages were already waiting there for
+    // the socket to become writeable, this one will be sent in the same batch as them.
+    // Otherwise, try to send it now.
+    if (PushTransmitQueue(sessionRef, msgRef))
+    {
+        SendFromTransmitQueue(sessionRef);
+    }
 }
 
 
@@ -1672,6 +1809,8 @@ le_msg_MessageRef_t msgSession_DoSyncRequestResponse
 
     // Send the Request Message.
     msgMessage_Send(sessionRef->socketFd, msgRef);
+    sessionRef->txCallCount++;
+    sessionRef->txMsgCount++;
 
     // While we have not yet received the response we are waiting for, keep
     // receiving messages.  Any that we receive that don't match the transaction ID
@@ -1679,9 +1818,10 @@ le_msg_MessageRef_t msgSession_DoSyncRequestResponse
     // function call.
     for (;;)
     {
-        rxMsgRef = le_msg_CreateMsg(sessionRef);
+        rxMsgRef = msgMessage_CreateForReceive(sessionRef);
 
         le_result_t result = msgMessage_Receive(sessionRef->socketFd, rxMsgRef);
+        sessionRef->rxCallCount++;
 
         if (result != LE_OK)
         {
@@ -1692,6 +1832,8 @@ le_msg_MessageRef_t msgSession_DoSyncRequestResponse
             break;
         }
 
+        sessionRef->rxMsgCount++;
+
         if (msgMessage_GetTxnId(rxMsgRef) == msgMessage_GetTxnId(msgRef))
         {
             // Got the synchronous response we were waiting for.
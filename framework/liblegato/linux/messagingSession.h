@@ -11,6 +11,7 @@
 #define LE_MESSAGING_SESSION_H_INCLUDE_GUARD
 
 #include "messagingInterface.h"
+#include "messagingSharedMem.h"
 
 
 //--------------------------------------------------------------------------------------------------
@@ -61,6 +62,20 @@ typedef struct le_msg_Session
     void*                           openContextPtr; ///< Open handler's context pointer.
     le_msg_SessionEventHandler_t    closeHandler;   ///< Close handler function.
     void*                           closeContextPtr;///< Close handler's context pointer.
+
+    size_t                          rxBatchSize;    ///< Number of messages to get ready for the
+                                                    ///  next receive from the socket.
+
+    size_t                          txMsgCount;     ///< Number of messages sent.
+    size_t                          txCallCount;    ///< Number of send system calls made.
+    size_t                          rxMsgCount;     ///< Number of messages received.
+    size_t                          rxCallCount;    ///< Number of receive system calls made.
+
+#if LE_CONFIG_MSG_SHARED_MEMORY
+    bool                            useSharedMem;   ///< true = send payloads through shared memory.
+    msgShm_RingRef_t                txRingRef;      ///< Ring for payloads sent by this side.
+    msgShm_RingRef_t                rxRingRef;      ///< Ring for payloads sent by the other side.
+#endif
 }
 msgSession_Session_t;
 
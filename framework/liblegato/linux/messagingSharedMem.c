@@ -0,0 +1,510 @@
+/** @file messagingSharedMem.c
+ *
+ * @ref c_messaging implementation's "Shared Memory" module implementation.
+ *
+ * Large message payloads can be passed between the two sides of a session through shared memory,
+ * instead of being copied into and out of the session's socket.  Each side that sends such a
+ * payload creates a ring of fixed-size slots in a memfd, and passes the fd to the other side once,
+ * in a SETUP descriptor.  From then on, only small descriptors naming a slot travel over the
+ * socket.
+ *
+ * The ring starts with a header, followed by one state word per slot, followed by the slots
+ * themselves.  Only the side that created the ring allocates slots from it.  A slot's state
+ * word is set to "in use" when it is allocated, and back to "free" by the sender if the message
+ * is released without being sent, or by the receiver once it has copied the payload out.  Slots
+ * can be freed in any order.
+ *
+ * The receiver never uses a payload in place, as the sender can still write to the slot.
+ *
+ * See @ref messaging.c for an overview of the @ref c_messaging implementation.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "messagingSharedMem.h"
+#include "fileDescriptor.h"
+
+#include <sys/mman.h>
+
+//********  Shared memory is enabled.  ***********************************************************//
+#if LE_CONFIG_MSG_SHARED_MEMORY
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Magic number found at the start of every ring.
+ */
+//--------------------------------------------------------------------------------------------------
+#define RING_MAGIC          0x4C655252U
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Alignment of each slot in a ring, in bytes.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SLOT_ALIGNMENT      64
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Largest number of slots accepted in a ring created by the other side.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MAX_PEER_SLOTS      65536
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Slot states, as found in the ring's state words.
+ */
+//--------------------------------------------------------------------------------------------------
+#define SLOT_FREE           0
+#define SLOT_IN_USE         1
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Header at the start of a ring's shared memory.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;             ///< RING_MAGIC.
+    uint32_t slotCount;         ///< Number of slots in the ring.
+    uint64_t slotSize;          ///< Distance between the start of two slots, in bytes.
+    uint64_t slotsOffset;       ///< Offset of the first slot from the start of the ring.
+    uint32_t slotState[];       ///< State of each slot (SLOT_FREE or SLOT_IN_USE).
+}
+RingHeader_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * A ring, as seen by one side of a session.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct msgShm_Ring
+{
+    RingHeader_t*   headerPtr;      ///< Start of the mapping.
+    size_t          mapSize;        ///< Size of the mapping, in bytes.
+    uint8_t*        slotsPtr;       ///< First slot.
+    size_t          slotSize;       ///< Distance between the start of two slots, in bytes.
+    uint32_t        slotCount;      ///< Number of slots.
+    int             fd;             ///< memfd of a ring created by this side (-1 otherwise).
+    bool            isShared;       ///< true once the SETUP descriptor has been sent.
+    uint32_t        nextSlot;       ///< Slot to try first on the next allocation.
+}
+Ring_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pool from which Ring objects are allocated.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_mem_PoolRef_t RingPoolRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Round a size up to a multiple of the slot alignment.
+ *
+ * @return The rounded size.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline size_t AlignSlotSize
+(
+    size_t size
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return (size + SLOT_ALIGNMENT - 1) & ~((size_t)SLOT_ALIGNMENT - 1);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get a pointer to a slot's state word.
+ *
+ * @return The pointer.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline uint32_t* GetSlotStatePtr
+(
+    Ring_t* ringPtr,
+    uint32_t slot
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return &ringPtr->headerPtr->slotState[slot];
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Destructor function for Ring objects.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RingDestructor
+(
+    void* objPtr
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Ring_t* ringPtr = objPtr;
+
+    if (munmap(ringPtr->headerPtr, ringPtr->mapSize) != 0)
+    {
+        LE_ERROR("munmap() failed. Errno = %d (%m).", errno);
+    }
+
+    if (ringPtr->fd >= 0)
+    {
+        fd_Close(ringPtr->fd);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocate a Ring object for a mapping.
+ *
+ * @return The Ring object.
+ */
+//--------------------------------------------------------------------------------------------------
+static Ring_t* CreateRingObj
+(
+    void* mapPtr,           ///< [IN] Start of the mapping.
+    size_t mapSize,         ///< [IN] Size of the mapping, in bytes.
+    int fd                  ///< [IN] memfd to keep open with the ring (-1 = none).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    Ring_t* ringPtr = le_mem_ForceAlloc(RingPoolRef);
+    RingHeader_t* headerPtr = mapPtr;
+
+    memset(ringPtr, 0, sizeof(*ringPtr));
+    ringPtr->headerPtr = headerPtr;
+    ringPtr->mapSize = mapSize;
+    ringPtr->slotsPtr = (uint8_t*)mapPtr + headerPtr->slotsOffset;
+    ringPtr->slotSize = headerPtr->slotSize;
+    ringPtr->slotCount = headerPtr->slotCount;
+    ringPtr->fd = fd;
+
+    return ringPtr;
+}
+
+
+// =======================================
+//  PROTECTED (INTER-MODULE) FUNCTIONS
+// =======================================
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes this module.  This must be called only once at start-up, before any other functions
+ * in this module are called.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgShm_Init
+(
+    void
+)
+//--------------------------------------------------------------------------------------------------
+{
+    RingPoolRef = le_mem_CreatePool("MsgShmRing", sizeof(Ring_t));
+    le_mem_SetDestructor(RingPoolRef, RingDestructor);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether sessions of a protocol pass their payloads through shared memory.
+ *
+ * @return true if they do.
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgShm_IsEligible
+(
+    size_t maxPayloadSize   ///< [IN] Protocol's maximum payload size, in bytes.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return (maxPayloadSize >= LE_CONFIG_MSG_SHARED_MEMORY_THRESHOLD);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a ring to send payloads through.  All of the ring's slots start out free.
+ *
+ * @return The ring, or NULL if the shared memory could not be created.
+ */
+//--------------------------------------------------------------------------------------------------
+msgShm_RingRef_t msgShm_CreateRing
+(
+    const char* name,       ///< [IN] Name of the ring (for debugging).
+    size_t payloadSize      ///< [IN] Size of each slot's payload, in bytes.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint32_t slotCount = LE_CONFIG_MSG_SHARED_MEMORY_SLOTS;
+    size_t slotSize = AlignSlotSize(payloadSize);
+    size_t slotsOffset = AlignSlotSize(sizeof(RingHeader_t) + slotCount * sizeof(uint32_t));
+    size_t mapSize = slotsOffset + slotCount * slotSize;
+
+    int fd = memfd_create(name, MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0)
+    {
+        LE_WARN("memfd_create() failed for '%s'. Errno = %d (%m).", name, errno);
+        return NULL;
+    }
+
+    // Seal the size, so that the other side can't make our accesses fault by truncating it.
+    if ((ftruncate(fd, mapSize) != 0)
+        || (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0))
+    {
+        LE_WARN("Failed to size shared memory for '%s'. Errno = %d (%m).", name, errno);
+        fd_Close(fd);
+        return NULL;
+    }
+
+    void* mapPtr = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapPtr == MAP_FAILED)
+    {
+        LE_WARN("mmap() failed for '%s'. Errno = %d (%m).", name, errno);
+        fd_Close(fd);
+        return NULL;
+    }
+
+    // The memfd starts out zero-filled, so all the slots are already free.
+    RingHeader_t* headerPtr = mapPtr;
+    headerPtr->magic = RING_MAGIC;
+    headerPtr->slotCount = slotCount;
+    headerPtr->slotSize = slotSize;
+    headerPtr->slotsOffset = slotsOffset;
+
+    return CreateRingObj(mapPtr, mapSize, fd);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maps a ring created by the other side of a session, from the fd received in a SETUP descriptor.
+ *
+ * @return The ring, or NULL if the fd is not a valid ring with slots of at least payloadSize bytes.
+ *
+ * @note Closes the fd.
+ */
+//--------------------------------------------------------------------------------------------------
+msgShm_RingRef_t msgShm_MapRing
+(
+    int fd,                 ///< [IN] File descriptor of the ring's shared memory.
+    size_t payloadSize      ///< [IN] Smallest acceptable slot payload size, in bytes.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    struct stat fileStat;
+    void* mapPtr = MAP_FAILED;
+    size_t mapSize = 0;
+
+    // Only accept memory whose size the other side can no longer change.
+    int seals = fcntl(fd, F_GET_SEALS);
+    if ((seals < 0) || ((seals & (F_SEAL_SHRINK | F_SEAL_SEAL)) != (F_SEAL_SHRINK | F_SEAL_SEAL)))
+    {
+        LE_ERROR("Shared memory received without size seals.");
+    }
+    else if ((fstat(fd, &fileStat) != 0) || (fileStat.st_size < (off_t)sizeof(RingHeader_t)))
+    {
+        LE_ERROR("Shared memory received with bad size.");
+    }
+    else
+    {
+        mapSize = fileStat.st_size;
+        mapPtr = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapPtr == MAP_FAILED)
+        {
+            LE_ERROR("mmap() failed. Errno = %d (%m).", errno);
+        }
+    }
+
+    fd_Close(fd);
+
+    if (mapPtr == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    RingHeader_t* headerPtr = mapPtr;
+    uint64_t slotCount = headerPtr->slotCount;
+    uint64_t slotSize = headerPtr->slotSize;
+    uint64_t slotsOffset = headerPtr->slotsOffset;
+
+    if ((headerPtr->magic != RING_MAGIC)
+        || (slotCount == 0)
+        || (slotCount > MAX_PEER_SLOTS)
+        || (slotSize < payloadSize)
+        || (slotsOffset < sizeof(RingHeader_t) + slotCount * sizeof(uint32_t))
+        || (slotsOffset > mapSize)
+        || (slotSize > (mapSize - slotsOffset) / slotCount))
+    {
+        LE_ERROR("Shared memory received with bad ring header.");
+        munmap(mapPtr, mapSize);
+        return NULL;
+    }
+
+    return CreateRingObj(mapPtr, mapSize, -1);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the file descriptor to send to the other side in a SETUP descriptor.
+ *
+ * @return The fd, or -1 if the ring was mapped from a received fd.
+ */
+//--------------------------------------------------------------------------------------------------
+int msgShm_GetFd
+(
+    msgShm_RingRef_t ringRef    ///< [IN] The ring.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return ringRef->fd;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a ring's SETUP descriptor has been sent to the other side.
+ *
+ * @return true if it has.
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgShm_IsShared
+(
+    msgShm_RingRef_t ringRef    ///< [IN] The ring.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    return ringRef->isShared;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Records that a ring's SETUP descriptor has been sent to the other side.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgShm_SetShared
+(
+    msgShm_RingRef_t ringRef    ///< [IN] The ring.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    ringRef->isShared = true;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates a free slot from a ring created by this side.
+ *
+ * @return Pointer to the slot's payload, or NULL if all the slots are in use.
+ *
+ * @note Only the thread that owns the ring's session may call this.
+ */
+//--------------------------------------------------------------------------------------------------
+void* msgShm_AllocSlot
+(
+    msgShm_RingRef_t ringRef    ///< [IN] The ring.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint32_t i;
+
+    for (i = 0; i < ringRef->slotCount; i++)
+    {
+        uint32_t slot = (ringRef->nextSlot + i) % ringRef->slotCount;
+        uint32_t* statePtr = GetSlotStatePtr(ringRef, slot);
+
+        // Acquire pairs with the release in msgShm_FreeSlot(), so that whatever the other side
+        // did with the slot is finished before it is reused.
+        if (__atomic_load_n(statePtr, __ATOMIC_ACQUIRE) == SLOT_FREE)
+        {
+            __atomic_store_n(statePtr, SLOT_IN_USE, __ATOMIC_RELAXED);
+            ringRef->nextSlot = (slot + 1) % ringRef->slotCount;
+
+            return ringRef->slotsPtr + ((size_t)slot * ringRef->slotSize);
+        }
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Frees a slot, so that the side that created the ring can use it again.  Can be used on either
+ * side of the session.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgShm_FreeSlot
+(
+    msgShm_RingRef_t ringRef,   ///< [IN] The ring.
+    void* payloadPtr            ///< [IN] Pointer to the slot's payload.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    uint32_t slot = msgShm_GetSlotIndex(ringRef, payloadPtr);
+
+    __atomic_store_n(GetSlotStatePtr(ringRef, slot), SLOT_FREE, __ATOMIC_RELEASE);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the index of the slot holding a payload, to put in a descriptor.
+ *
+ * @return The index.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t msgShm_GetSlotIndex
+(
+    msgShm_RingRef_t ringRef,   ///< [IN] The ring.
+    void* payloadPtr            ///< [IN] Pointer to the slot's payload.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    size_t offset = (uint8_t*)payloadPtr - ringRef->slotsPtr;
+
+    LE_ASSERT(((uint8_t*)payloadPtr >= ringRef->slotsPtr) && (offset % ringRef->slotSize == 0));
+    LE_ASSERT(offset / ringRef->slotSize < ringRef->slotCount);
+
+    return offset / ringRef->slotSize;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets a slot of a ring created by the other side, named in a DATA descriptor.
+ *
+ * @return Pointer to the slot's payload, or NULL if the index is out of range.
+ */
+//--------------------------------------------------------------------------------------------------
+void* msgShm_GetPeerSlot
+(
+    msgShm_RingRef_t ringRef,   ///< [IN] The ring.
+    uint32_t slot               ///< [IN] Index of the slot.
+)
+//--------------------------------------------------------------------------------------------------
+{
+    if (slot >= ringRef->slotCount)
+    {
+        return NULL;
+    }
+
+    return ringRef->slotsPtr + ((size_t)slot * ringRef->slotSize);
+}
+
+#endif // LE_CONFIG_MSG_SHARED_MEMORY
@@ -0,0 +1,208 @@
+/** @file messagingSharedMem.h
+ *
+ * Inter-module definitions exported by the Shared Memory module of the @ref c_messaging
+ * implementation.
+ *
+ * See @ref messaging.c for an overview of the @ref c_messaging implementation.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#ifndef LE_MESSAGING_SHARED_MEM_H_INCLUDE_GUARD
+#define LE_MESSAGING_SHARED_MEM_H_INCLUDE_GUARD
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Magic number found at the start of every shared memory descriptor.
+ */
+//--------------------------------------------------------------------------------------------------
+#define MSGSHM_DESCRIPTOR_MAGIC     0x4C65534DU
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Kinds of shared memory descriptor.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    MSGSHM_DESC_SETUP,      ///< Carries the fd of the sender's ring.  Not a message by itself.
+    MSGSHM_DESC_DATA,       ///< Payload is in a slot of the sender's ring.
+}
+msgShm_DescType_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Descriptor sent over a session's socket in place of a message payload that is in shared memory.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t magic;         ///< MSGSHM_DESCRIPTOR_MAGIC.
+    uint32_t type;          ///< One of msgShm_DescType_t.
+    uint32_t slot;          ///< Index of the slot holding the payload (DATA only).
+    uint32_t size;          ///< Number of bytes of the payload used (DATA only).
+}
+msgShm_Descriptor_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reference to a shared memory ring.  Rings are reference counted using le_mem_AddRef() and
+ * le_mem_Release(), and are unmapped when the last reference is released.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct msgShm_Ring* msgShm_RingRef_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Initializes this module.  This must be called only once at start-up, before any other functions
+ * in this module are called.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgShm_Init
+(
+    void
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether sessions of a protocol pass their payloads through shared memory.
+ *
+ * @return true if they do.
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgShm_IsEligible
+(
+    size_t maxPayloadSize   ///< [IN] Protocol's maximum payload size, in bytes.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates a ring to send payloads through.  All of the ring's slots start out free.
+ *
+ * @return The ring, or NULL if the shared memory could not be created.
+ */
+//--------------------------------------------------------------------------------------------------
+msgShm_RingRef_t msgShm_CreateRing
+(
+    const char* name,       ///< [IN] Name of the ring (for debugging).
+    size_t payloadSize      ///< [IN] Size of each slot's payload, in bytes.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Maps a ring created by the other side of a session, from the fd received in a SETUP descriptor.
+ *
+ * @return The ring, or NULL if the fd is not a valid ring with slots of at least payloadSize bytes.
+ *
+ * @note Closes the fd.
+ */
+//--------------------------------------------------------------------------------------------------
+msgShm_RingRef_t msgShm_MapRing
+(
+    int fd,                 ///< [IN] File descriptor of the ring's shared memory.
+    size_t payloadSize      ///< [IN] Smallest acceptable slot payload size, in bytes.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the file descriptor to send to the other side in a SETUP descriptor.
+ *
+ * @return The fd, or -1 if the ring was mapped from a received fd.
+ */
+//--------------------------------------------------------------------------------------------------
+int msgShm_GetFd
+(
+    msgShm_RingRef_t ringRef    ///< [IN] The ring.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks whether a ring's SETUP descriptor has been sent to the other side.
+ *
+ * @return true if it has.
+ */
+//--------------------------------------------------------------------------------------------------
+bool msgShm_IsShared
+(
+    msgShm_RingRef_t ringRef    ///< [IN] The ring.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Records that a ring's SETUP descriptor has been sent to the other side.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgShm_SetShared
+(
+    msgShm_RingRef_t ringRef    ///< [IN] The ring.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocates a free slot from a ring created by this side.
+ *
+ * @return Pointer to the slot's payload, or NULL if all the slots are in use.
+ *
+ * @note Only the thread that owns the ring's session may call this.
+ */
+//--------------------------------------------------------------------------------------------------
+void* msgShm_AllocSlot
+(
+    msgShm_RingRef_t ringRef    ///< [IN] The ring.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Frees a slot, so that the side that created the ring can use it again.  Can be used on either
+ * side of the session.
+ */
+//--------------------------------------------------------------------------------------------------
+void msgShm_FreeSlot
+(
+    msgShm_RingRef_t ringRef,   ///< [IN] The ring.
+    void* payloadPtr            ///< [IN] Pointer to the slot's payload.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the index of the slot holding a payload, to put in a descriptor.
+ *
+ * @return The index.
+ */
+//--------------------------------------------------------------------------------------------------
+uint32_t msgShm_GetSlotIndex
+(
+    msgShm_RingRef_t ringRef,   ///< [IN] The ring.
+    void* payloadPtr            ///< [IN] Pointer to the slot's payload.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets a slot of a ring created by the other side, named in a DATA descriptor.
+ *
+ * @return Pointer to the slot's payload, or NULL if the index is out of range.
+ */
+//--------------------------------------------------------------------------------------------------
+void* msgShm_GetPeerSlot
+(
+    msgShm_RingRef_t ringRef,   ///< [IN] The ring.
+    uint32_t slot               ///< [IN] Index of the slot.
+);
+
+
+#endif // LE_MESSAGING_SHARED_MEM_H_INCLUDE_GUARD
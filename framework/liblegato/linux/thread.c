@@ -280,6 +280,11 @@ void thread_InitThread
 
     // Init the thread's timer resources
     timer_InitThread();
+
+#if LE_CONFIG_MEM_THREAD_CACHE
+    // Init the thread's memory pool caches.
+    mem_ThreadInit();
+#endif
 }
 
 
@@ -429,6 +434,9 @@ static thread_Obj_t* CreateThread
     memset(&threadPtr->semaphoreRec, 0, sizeof(threadPtr->semaphoreRec));
     memset(&threadPtr->eventRec, 0, sizeof(threadPtr->eventRec));
     memset(threadPtr->timerRec, 0, TIMER_TYPE_COUNT * sizeof(timer_ThreadRec_t));
+#if LE_CONFIG_MEM_THREAD_CACHE
+    memset(&threadPtr->memRec, 0, sizeof(threadPtr->memRec));
+#endif
 
     // Create a safe reference for this object and put this object on the thread object list (for
     // the Inpsect tool).
@@ -646,6 +654,31 @@ timer_ThreadRec_t* thread_GetTimerRecPtr
 }
 
 
+#if LE_CONFIG_MEM_THREAD_CACHE
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the calling thread's memory pool record.
+ *
+ * @return  Pointer to the record, or NULL if the calling thread is not a Legato thread.
+ */
+//--------------------------------------------------------------------------------------------------
+mem_ThreadRec_t* thread_TryGetMemRecPtr
+(
+    void
+)
+{
+    thread_Obj_t* threadPtr = pthread_getspecific(ThreadLocalDataKey);
+
+    if (threadPtr == NULL)
+    {
+        return NULL;
+    }
+
+    return &(threadPtr->memRec);
+}
+#endif
+
+
 // ===================================
 //  PUBLIC API FUNCTIONS
 // ===================================
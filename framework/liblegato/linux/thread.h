@@ -11,6 +11,7 @@
 #define THREAD_INCLUDE_GUARD
 
 #include "eventLoop.h"
+#include "mem.h"
 #include "mutex.h"
 #include "semaphores.h"
 #include "timer.h"
@@ -59,6 +60,9 @@ typedef struct
     pthread_t               threadHandle;                   ///< The pthreads thread handle.
     le_thread_Ref_t         safeRef;                        ///< Safe reference for this object.
     timer_ThreadRec_t       timerRec[TIMER_TYPE_COUNT];     ///< The thread's timer records.
+#if LE_CONFIG_MEM_THREAD_CACHE
+    mem_ThreadRec_t         memRec;                         ///< The thread's memory pool record.
+#endif
 }
 thread_Obj_t;
 
@@ -166,4 +170,19 @@ timer_ThreadRec_t* thread_GetTimerRecPtr
 );
 
 
+#if LE_CONFIG_MEM_THREAD_CACHE
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the calling thread's memory pool record.
+ *
+ * @return  Pointer to the record, or NULL if the calling thread is not a Legato thread.
+ */
+//--------------------------------------------------------------------------------------------------
+mem_ThreadRec_t* thread_TryGetMemRecPtr
+(
+    void
+);
+#endif
+
+
 #endif  // THREAD_INCLUDE_GUARD
@@ -23,6 +23,11 @@
 #define DEFAULT_REFMAP_NAME "Default Timer SafeRefs"
 #define DEFAULT_REFMAP_MAXSIZE 23
 
+/// Tolerance given to newly created timers.
+#define DEFAULT_TOLERANCE \
+    ((le_clk_Time_t){ LE_CONFIG_TIMER_DEFAULT_TOLERANCE_MS / 1000,       \
+                      (LE_CONFIG_TIMER_DEFAULT_TOLERANCE_MS % 1000) * 1000 })
+
 
 //--------------------------------------------------------------------------------------------------
 /**
@@ -119,9 +124,11 @@ static Timer_t* CreateTimer
     timerPtr->interval = (le_clk_Time_t){0, 0};
     timerPtr->repeatCount = 1;
     timerPtr->contextPtr = NULL;
+    timerPtr->tolerance = DEFAULT_TOLERANCE;
     timerPtr->link = LE_DLS_LINK_INIT;
     timerPtr->isActive = false;
     timerPtr->expiryTime = (le_clk_Time_t){0, 0};
+    timerPtr->latestExpiryTime = (le_clk_Time_t){0, 0};
     timerPtr->expiryCount = 0;
     timerPtr->safeRef = NULL;
     timerPtr->safeRef = le_ref_CreateRef(SafeRefMap, timerPtr);
@@ -131,26 +138,158 @@ static Timer_t* CreateTimer
 }
 
 
+#if LE_CONFIG_TIMER_QUEUE_HEAP
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check if a timer on the heap must expire before another one.  Timers with the same latest expiry
+ * time are ordered by the time they were added, so they expire in the same order as with the list
+ * queue.
+ *
+ * @return true if the first timer should expire first, false otherwise.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool IsHeapEarlier
+(
+    const Timer_t* aPtr,                ///< [IN] First timer.
+    const Timer_t* bPtr                 ///< [IN] Second timer.
+)
+{
+    if (le_clk_Equal(aPtr->latestExpiryTime, bPtr->latestExpiryTime))
+    {
+        return (aPtr->heapSeqNum < bPtr->heapSeqNum);
+    }
+    return le_clk_GreaterThan(bPtr->latestExpiryTime, aPtr->latestExpiryTime);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Meld two pairing heaps together.  Both timers must be heap roots (i.e., have no siblings).
+ *
+ * @return The root of the melded heap.
+ */
+//--------------------------------------------------------------------------------------------------
+static Timer_t* MeldHeap
+(
+    Timer_t* aPtr,                      ///< [IN] Root of the first heap.
+    Timer_t* bPtr                       ///< [IN] Root of the second heap.
+)
+{
+    if (IsHeapEarlier(bPtr, aPtr))
+    {
+        Timer_t* tmpPtr = aPtr;
+        aPtr = bPtr;
+        bPtr = tmpPtr;
+    }
+
+    // Make the later root the leftmost child of the earlier one.
+    bPtr->heapPrevPtr = aPtr;
+    bPtr->heapNextPtr = aPtr->heapChildPtr;
+    if (aPtr->heapChildPtr != NULL)
+    {
+        aPtr->heapChildPtr->heapPrevPtr = bPtr;
+    }
+    aPtr->heapChildPtr = bPtr;
+
+    return aPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Combine a list of sibling sub-heaps into a single heap, using the standard two-pass pairing
+ * (pair up from left to right, then meld the pairs from right to left).
+ *
+ * @return The root of the combined heap, or NULL if the list was empty.
+ */
+//--------------------------------------------------------------------------------------------------
+static Timer_t* MergeHeapPairs
+(
+    Timer_t* firstPtr                   ///< [IN] Leftmost sub-heap in the sibling list.
+)
+{
+    Timer_t* pairsPtr = NULL;
+    Timer_t* rootPtr = NULL;
+
+    // First pass: meld siblings pairwise, pushing each result onto a stack linked by heapNextPtr.
+    while (firstPtr != NULL)
+    {
+        Timer_t* aPtr = firstPtr;
+        Timer_t* bPtr = aPtr->heapNextPtr;
+
+        firstPtr = (bPtr != NULL ? bPtr->heapNextPtr : NULL);
+
+        aPtr->heapNextPtr = NULL;
+        aPtr->heapPrevPtr = NULL;
+        if (bPtr != NULL)
+        {
+            bPtr->heapNextPtr = NULL;
+            bPtr->heapPrevPtr = NULL;
+            aPtr = MeldHeap(aPtr, bPtr);
+        }
+
+        aPtr->heapNextPtr = pairsPtr;
+        pairsPtr = aPtr;
+    }
+
+    // Second pass: meld the pairs together, starting from the rightmost one.
+    while (pairsPtr != NULL)
+    {
+        Timer_t* nextPtr = pairsPtr->heapNextPtr;
+
+        pairsPtr->heapNextPtr = NULL;
+        rootPtr = (rootPtr != NULL ? MeldHeap(rootPtr, pairsPtr) : pairsPtr);
+        pairsPtr = nextPtr;
+    }
+
+    return rootPtr;
+}
+#endif /* end LE_CONFIG_TIMER_QUEUE_HEAP */
+
+
 //--------------------------------------------------------------------------------------------------
 /**
- * Add the timer record to the given list, sorted according to the timer value
+ * Add the timer record to the thread's active timers, sorted according to the latest time at which
+ * the timer may expire
  */
 //--------------------------------------------------------------------------------------------------
 static void AddToTimerList
 (
-    le_dls_List_t* listPtr,               ///< [IN] The list to add to.
+    timer_ThreadRec_t* threadRecPtr,      ///< [IN] The thread timer record to add to.
     Timer_t* newTimerPtr                  ///< [IN] The timer to add
 )
 {
-    Timer_t* timerPtr;
-    le_dls_Link_t* linkPtr;
-
     if ( newTimerPtr->isActive )
     {
         LE_ERROR("Timer '%s' is already active", newTimerPtr->name);
         return;
     }
 
+    TimerListChangeCount++;
+    newTimerPtr->latestExpiryTime = le_clk_Add(newTimerPtr->expiryTime, newTimerPtr->tolerance);
+
+#if LE_CONFIG_TIMER_QUEUE_HEAP
+    // The list only keeps track of the running timers; the heap orders them.
+    le_dls_Queue(&threadRecPtr->activeTimerList, &newTimerPtr->link);
+
+    newTimerPtr->heapChildPtr = NULL;
+    newTimerPtr->heapNextPtr = NULL;
+    newTimerPtr->heapPrevPtr = NULL;
+    newTimerPtr->heapSeqNum = threadRecPtr->heapSeqNum++;
+
+    if (threadRecPtr->heapRootPtr == NULL)
+    {
+        threadRecPtr->heapRootPtr = newTimerPtr;
+    }
+    else
+    {
+        threadRecPtr->heapRootPtr = MeldHeap(threadRecPtr->heapRootPtr, newTimerPtr);
+    }
+#else
+    le_dls_List_t* listPtr = &threadRecPtr->activeTimerList;
+    Timer_t* timerPtr;
+    le_dls_Link_t* linkPtr;
+
     // Get the start of the list
     linkPtr = le_dls_Peek(listPtr);
 
@@ -159,13 +298,12 @@ static void AddToTimerList
     {
         timerPtr = CONTAINER_OF(linkPtr, Timer_t, link);
 
-        if ( le_clk_GreaterThan(timerPtr->expiryTime, newTimerPtr->expiryTime) )
+        if ( le_clk_GreaterThan(timerPtr->latestExpiryTime, newTimerPtr->latestExpiryTime) )
             break;
 
         linkPtr = le_dls_PeekNext(listPtr, linkPtr);
     }
 
-    TimerListChangeCount++;
     if (linkPtr == NULL)
     {
         // The list is either empty, or the new timer has the largest expiry time.
@@ -177,6 +315,7 @@ static void AddToTimerList
         // Found a timer with larger expiry time; insert the new timer before it.
         le_dls_AddBefore(listPtr, linkPtr, &newTimerPtr->link);
     }
+#endif /* end LE_CONFIG_TIMER_QUEUE_HEAP */
 
     // The new timer is now on the active list
     newTimerPtr->isActive = true;
@@ -185,76 +324,105 @@ static void AddToTimerList
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Peek at the first timer from the given timer list
+ * Peek at the first (earliest expiring) timer from the thread's active timers
  *
  * @return:
- *      - pointer to the first timer on the list
- *      - NULL if the list is empty
+ *      - pointer to the first timer
+ *      - NULL if there are no active timers
  */
 //--------------------------------------------------------------------------------------------------
 static Timer_t* PeekFromTimerList
 (
-    le_dls_List_t* listPtr              ///< [IN] The list to look at.
+    timer_ThreadRec_t* threadRecPtr     ///< [IN] The thread timer record to look at.
 )
 {
+#if LE_CONFIG_TIMER_QUEUE_HEAP
+    return threadRecPtr->heapRootPtr;
+#else
     le_dls_Link_t* linkPtr;
 
-    linkPtr = le_dls_Peek(listPtr);
+    linkPtr = le_dls_Peek(&threadRecPtr->activeTimerList);
     if (linkPtr != NULL)
     {
         return ( CONTAINER_OF(linkPtr, Timer_t, link) );
     }
     return NULL;
+#endif
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Pop the first timer from the given timer list
- *
- * @return:
- *      - pointer to the first timer on the list
- *      - NULL if the list is empty
+ * Remove the timer from the thread's active timers
  */
 //--------------------------------------------------------------------------------------------------
-static Timer_t* PopFromTimerList
+static void RemoveFromTimerList
 (
-    le_dls_List_t* listPtr              ///< [IN] The list to look at.
+    timer_ThreadRec_t* threadRecPtr,    ///< [IN] The thread timer record to look at.
+    Timer_t* timerPtr                   ///< [IN] The timer to remove
 )
 {
-    le_dls_Link_t* linkPtr;
-    Timer_t* timerPtr;
+    // Remove the timer from the active list
+    timerPtr->isActive = false;
+    TimerListChangeCount++;
+    le_dls_Remove(&threadRecPtr->activeTimerList, &timerPtr->link);
 
-    linkPtr = le_dls_Pop(listPtr);
-    if (linkPtr != NULL)
+#if LE_CONFIG_TIMER_QUEUE_HEAP
+    Timer_t* subHeapPtr = MergeHeapPairs(timerPtr->heapChildPtr);
+    timerPtr->heapChildPtr = NULL;
+
+    if (timerPtr == threadRecPtr->heapRootPtr)
     {
-        TimerListChangeCount++;
-        timerPtr = CONTAINER_OF(linkPtr, Timer_t, link);
+        threadRecPtr->heapRootPtr = subHeapPtr;
+        return;
+    }
 
-        // The timer is no longer on the active list
-        timerPtr->isActive = false;
+    // Unlink the timer from its siblings, then meld its children back in at the root.
+    if (timerPtr->heapPrevPtr->heapChildPtr == timerPtr)
+    {
+        timerPtr->heapPrevPtr->heapChildPtr = timerPtr->heapNextPtr;
+    }
+    else
+    {
+        timerPtr->heapPrevPtr->heapNextPtr = timerPtr->heapNextPtr;
+    }
+    if (timerPtr->heapNextPtr != NULL)
+    {
+        timerPtr->heapNextPtr->heapPrevPtr = timerPtr->heapPrevPtr;
+    }
+    timerPtr->heapNextPtr = NULL;
+    timerPtr->heapPrevPtr = NULL;
 
-        return timerPtr;
+    if (subHeapPtr != NULL)
+    {
+        threadRecPtr->heapRootPtr = MeldHeap(threadRecPtr->heapRootPtr, subHeapPtr);
     }
-    return NULL;
+#endif /* end LE_CONFIG_TIMER_QUEUE_HEAP */
 }
 
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Remove the timer from the given timer list
+ * Pop the first (earliest expiring) timer from the thread's active timers
+ *
+ * @return:
+ *      - pointer to the first timer
+ *      - NULL if there are no active timers
  */
 //--------------------------------------------------------------------------------------------------
-static void RemoveFromTimerList
+static Timer_t* PopFromTimerList
 (
-    le_dls_List_t* listPtr,             ///< [IN] The list to look at.
-    Timer_t* timerPtr                   ///< [IN] The timer to remove
+    timer_ThreadRec_t* threadRecPtr     ///< [IN] The thread timer record to look at.
 )
 {
-    // Remove the timer from the active list
-    timerPtr->isActive = false;
-    TimerListChangeCount++;
-    le_dls_Remove(listPtr, &timerPtr->link);
+    Timer_t* timerPtr = PeekFromTimerList(threadRecPtr);
+
+    if (timerPtr != NULL)
+    {
+        // The timer is no longer on the active list
+        RemoveFromTimerList(threadRecPtr, timerPtr);
+    }
+    return timerPtr;
 }
 
 
@@ -338,11 +506,12 @@ static void RestartTimerFD
 
     struct itimerspec timerInterval;
 
-    // Set the timer to expire at the expiry time of the given timer
+    // Set the timer to expire at the latest expiry time of the given timer, so that any other
+    // timers that become due in the meantime are handled on the same expiry.
     // There is a small possibility that the time set now will be slightly in the past
     // at this point but it will just cause the timerfd to expire immediately.
-    timerInterval.it_value.tv_sec = timerPtr->expiryTime.sec;
-    timerInterval.it_value.tv_nsec = timerPtr->expiryTime.usec * 1000;
+    timerInterval.it_value.tv_sec = timerPtr->latestExpiryTime.sec;
+    timerInterval.it_value.tv_nsec = timerPtr->latestExpiryTime.usec * 1000;
 
     // The timerFD does not repeat
     timerInterval.it_interval.tv_sec = 0;
@@ -359,6 +528,7 @@ static void RestartTimerFD
 
     // Store the timer for future reference
     threadRecPtr->firstTimerPtr = timerPtr;
+    threadRecPtr->armedTime = timerPtr->latestExpiryTime;
 }
 
 
@@ -394,6 +564,53 @@ static void StopTimerFD
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Make sure the timerFD is set for the first timer on the active list, (re)starting or stopping it
+ * if necessary.
+ *
+ * Nothing is done while expired timers are being processed; the timerFD is updated once they are
+ * all done.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UpdateTimerFD
+(
+    timer_ThreadRec_t* threadRecPtr
+)
+{
+    if (threadRecPtr->isExpiring)
+    {
+        return;
+    }
+
+    Timer_t* firstTimerPtr = PeekFromTimerList(threadRecPtr);
+
+    if (firstTimerPtr == NULL)
+    {
+        if (threadRecPtr->firstTimerPtr != NULL)
+        {
+            StopTimerFD(threadRecPtr);
+        }
+    }
+    else if (threadRecPtr->firstTimerPtr != firstTimerPtr)
+    {
+        // If the timerFD is already set to expire within the tolerance of the new first timer,
+        // there is no need to set it again.
+        if (   (threadRecPtr->firstTimerPtr != NULL)
+            && !le_clk_GreaterThan(firstTimerPtr->expiryTime, threadRecPtr->armedTime)
+            && !le_clk_GreaterThan(threadRecPtr->armedTime, firstTimerPtr->latestExpiryTime) )
+        {
+            TRACE("timer '%s' shares timerFD expiry", firstTimerPtr->name);
+            threadRecPtr->firstTimerPtr = firstTimerPtr;
+        }
+        else
+        {
+            RestartTimerFD(firstTimerPtr);
+        }
+    }
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Run a given timer, by adding it to the Timer List and restarting the Timer FD, if necessary.
@@ -410,21 +627,11 @@ static void RunTimer
 
     timer_ThreadRec_t* threadRecPtr = GetThreadTimerRec(timerPtr);
 
-    Timer_t* firstTimerPtr;
-
-    AddToTimerList(&threadRecPtr->activeTimerList, timerPtr);
+    AddToTimerList(threadRecPtr, timerPtr);
     //PrintTimerList(&threadRecPtr->activeTimerList);
 
-    // Get the first timer from the active list. This is needed to determine whether the timerFD
-    // needs to be restarted, in case the new timer was put at the beginning of the list.
-    firstTimerPtr = PeekFromTimerList(&threadRecPtr->activeTimerList);
-
-    // If the timerFD is not running, or it is running a timer that is no longer at the beginning
-    // of the active list, then (re)start the timerFD.
-    if ( (NULL != firstTimerPtr) && (threadRecPtr->firstTimerPtr != firstTimerPtr) )
-    {
-        RestartTimerFD(firstTimerPtr);
-    }
+    // If the new timer was put at the beginning of the list, the timerFD may need to be restarted.
+    UpdateTimerFD(threadRecPtr);
 }
 
 
@@ -442,24 +649,14 @@ static void StopTimer
 {
     timer_ThreadRec_t* threadRecPtr = GetThreadTimerRec(timerPtr);
 
-    RemoveFromTimerList(&threadRecPtr->activeTimerList, timerPtr);
+    RemoveFromTimerList(threadRecPtr, timerPtr);
 
     // If the timer was at the start of the active list, then restart the timerFD using the next
     // timer on the active list, if any.  Otherwise, stop the timerFD.
     if (timerPtr == threadRecPtr->firstTimerPtr)
     {
         TRACE("Stopping the first active timer");
-        threadRecPtr->firstTimerPtr = NULL;
-
-        Timer_t* firstTimerPtr = PeekFromTimerList(&threadRecPtr->activeTimerList);
-        if (firstTimerPtr != NULL)
-        {
-            RestartTimerFD(firstTimerPtr);
-        }
-        else
-        {
-            StopTimerFD(threadRecPtr);
-        }
+        UpdateTimerFD(threadRecPtr);
     }
 }
 
@@ -497,7 +694,7 @@ static void ProcessExpiredTimer
         expiredTimer->expiryTime = le_clk_Add(expiredTimer->expiryTime, expiredTimer->interval);
 
         // Add the timer back to the timer list
-        AddToTimerList(&threadRecPtr->activeTimerList, expiredTimer);
+        AddToTimerList(threadRecPtr, expiredTimer);
         //PrintTimerList(&threadRecPtr->activeTimerList);
     }
 
@@ -550,51 +747,39 @@ static void TimerFdHandler
     LE_ERROR_IF(expiry != 1,  "On TimerFD read, unexpected expiry=%u", (unsigned int)expiry);
 
     // Pop off the first timer from the active list, and make sure it is the expected timer.
-    firstTimerPtr = PopFromTimerList(&threadRecPtr->activeTimerList);
+    firstTimerPtr = PopFromTimerList(threadRecPtr);
     LE_ASSERT( NULL != firstTimerPtr);
 
     LE_ASSERT( threadRecPtr->firstTimerPtr == firstTimerPtr );
 
-    // Need to reset the expected timer, in case processing the current timer will cause the same
-    // timer to be started again, and put back at the start of the active list. This is necessary
-    // since the timerFD is no longer running, so there is no timer associated with it.
+    // The timerFD is no longer running, so there is no timer associated with it.  Hold off
+    // re-arming it until all the expired timers have been processed, so that timers started or
+    // stopped by the expiry handlers don't each cost a timerfd_settime() call.
     threadRecPtr->firstTimerPtr = NULL;
+    threadRecPtr->isExpiring = true;
 
     // It is the expected timer so process it.
     ProcessExpiredTimer(firstTimerPtr);
 
-    // Check if there are any other timers that have since expired, pop them off the
-    // list and process them.
-    firstTimerPtr = PeekFromTimerList(&threadRecPtr->activeTimerList);
+    // Check if there are any other timers that have since reached their expiry time, pop them off
+    // the list and process them.  Because timers are ordered by the latest time they may expire,
+    // this also handles timers whose tolerance allows them to share this expiry.
+    firstTimerPtr = PeekFromTimerList(threadRecPtr);
     while ( firstTimerPtr != NULL &&
             le_clk_GreaterThan(clk_GetRelativeTime(firstTimerPtr->isWakeupEnabled),
                                firstTimerPtr->expiryTime) )
     {
         // Pop off the timer and process it
-        firstTimerPtr = PopFromTimerList(&threadRecPtr->activeTimerList);
+        firstTimerPtr = PopFromTimerList(threadRecPtr);
         ProcessExpiredTimer(firstTimerPtr);
 
         // Try the next timer on the list
-        firstTimerPtr = PeekFromTimerList(&threadRecPtr->activeTimerList);
-    }
-
-    // While processing expired timers in the above loop, it is possible that a timer was started,
-    // put in the active list, and expired before the loop completed. If the active list is empty,
-    // but the timerFD is still running, then we need to stop it.
-    if ( (firstTimerPtr == NULL) && ( threadRecPtr->firstTimerPtr != NULL ) )
-    {
-        StopTimerFD(threadRecPtr);
+        firstTimerPtr = PeekFromTimerList(threadRecPtr);
     }
 
-    // If the next timer on the active list exists, then if the timerFD is not running, or it is
-    // running a timer that is no longer at the beginning of the active list, then (re)start the
-    // timerFD.  The timerFD could be running here, if the expiry handler started a new timer,
-    // although it might no longer be at the beginning of the list, if we had multiple timers
-    // expire, and one of them is a repetitive timer.
-    if ( (firstTimerPtr != NULL) && ( threadRecPtr->firstTimerPtr != firstTimerPtr ) )
-    {
-        RestartTimerFD(firstTimerPtr);
-    }
+    // Now (re)start the timerFD for the next timer on the active list, if there is one.
+    threadRecPtr->isExpiring = false;
+    UpdateTimerFD(threadRecPtr);
 }
 
 // =============================================
@@ -697,6 +882,12 @@ void timer_InitThread
         recPtr->timerFD = -1;
         recPtr->activeTimerList = LE_DLS_LIST_INIT;
         recPtr->firstTimerPtr = NULL;
+        recPtr->armedTime = (le_clk_Time_t){0, 0};
+        recPtr->isExpiring = false;
+#if LE_CONFIG_TIMER_QUEUE_HEAP
+        recPtr->heapRootPtr = NULL;
+        recPtr->heapSeqNum = 0;
+#endif
     }
 }
 
@@ -1042,6 +1233,65 @@ le_result_t le_timer_SetWakeup
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set how late the timer is allowed to expire.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_BUSY if the timer is currently running
+ *
+ * @note
+ *      If an invalid timer object is given, the process exits.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_timer_SetTolerance
+(
+    le_timer_Ref_t timerRef,     ///< [IN] Set tolerance for this timer object.
+    le_clk_Time_t tolerance      ///< [IN] Maximum expiry delay.
+)
+{
+    Timer_t* timerPtr = le_ref_Lookup(SafeRefMap, timerRef);
+    LE_FATAL_IF(NULL == timerPtr, "Invalid timer reference %p.", timerRef);
+
+    if ( timerPtr->isActive )
+    {
+        return LE_BUSY;
+    }
+
+    timerPtr->tolerance = tolerance;
+
+    return LE_OK;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Set how late the timer is allowed to expire, in milliseconds.
+ *
+ * @return
+ *      - LE_OK on success
+ *      - LE_BUSY if the timer is currently running
+ *
+ * @note
+ *      If an invalid timer object is given, the process exits.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t le_timer_SetMsTolerance
+(
+    le_timer_Ref_t timerRef,     ///< [IN] Set tolerance for this timer object.
+    uint32_t tolerance           ///< [IN] Maximum expiry delay in milliseconds.
+)
+{
+    time_t seconds = tolerance / 1000;
+    le_clk_Time_t timeStruct;
+    timeStruct.sec = seconds;
+    timeStruct.usec = (tolerance - (seconds * 1000)) * 1000;
+
+    return le_timer_SetTolerance(timerRef, timeStruct);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Set context pointer for the timer
@@ -31,7 +31,7 @@ timer_Type_t;
  * Timer object.  Created by le_timer_Create().
  */
 //--------------------------------------------------------------------------------------------------
-typedef struct
+typedef struct Timer
 {
     // Settable attributes
     char name[LIMIT_MAX_TIMER_NAME_BYTES];   ///< The timer name
@@ -39,11 +39,21 @@ typedef struct
     le_clk_Time_t interval;                  ///< Interval
     uint32_t repeatCount;                    ///< Number of times the timer will repeat
     void* contextPtr;                        ///< Context for timer expiry
+    le_clk_Time_t tolerance;                 ///< How late the timer may expire
 
     // Internal State
     le_dls_Link_t link;                      ///< For adding to the timer list
+#if LE_CONFIG_TIMER_QUEUE_HEAP
+    struct Timer* heapChildPtr;              ///< Leftmost child in the timer heap
+    struct Timer* heapNextPtr;               ///< Next sibling in the timer heap
+    struct Timer* heapPrevPtr;               ///< Previous sibling, or parent if leftmost child
+    uint64_t heapSeqNum;                     ///< Insertion order, to break expiry time ties
+#endif
     bool isActive;                           ///< Is the timer active/running?
     le_clk_Time_t expiryTime;                ///< Time at which the timer should expire
+    le_clk_Time_t latestExpiryTime;          ///< Time by which the timer must have expired
+                                             ///  (expiryTime + tolerance).  Active timers are
+                                             ///  ordered on this.
     uint32_t expiryCount;                    ///< Number of times the counter has expired
     le_timer_Ref_t safeRef;                  ///< For the API user to refer to this timer by
     bool isWakeupEnabled;                    ///< Will system be woken up from suspended timer.
@@ -67,10 +77,18 @@ typedef struct
 {
     int timerFD;                        ///< System timer used by the thread.
     le_dls_List_t activeTimerList;      ///< Linked list of running legato timers for this thread
+                                        ///  (only sorted by expiry time with the list queue).
+#if LE_CONFIG_TIMER_QUEUE_HEAP
+    Timer_t* heapRootPtr;               ///< Root (earliest expiry) of the running timer heap.
+    uint64_t heapSeqNum;                ///< Sequence number for the next timer added to the heap.
+#endif
     Timer_t* firstTimerPtr;             ///< Pointer to the timer on the active list that is
                                         ///  associated with the currently running timerFD,
                                         ///  or NULL if there are no timers on the active list.
                                         ///  This is normally the first timer on the list.
+    le_clk_Time_t armedTime;            ///< Time the timerFD is currently set to expire at.
+    bool isExpiring;                    ///< true while expired timers are being processed; the
+                                        ///  timerFD is only re-armed once they are all done.
 
 }
 timer_ThreadRec_t;
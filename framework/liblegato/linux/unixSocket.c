@@ -539,6 +539,123 @@ le_result_t unixSocket_SendDataMsg
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends a batch of messages, each with an optional file descriptor, through a connected Unix domain
+ * datagram or sequenced-packet socket, using a single system call.  Messages are sent in order.
+ *
+ * Fewer messages than requested may be sent, for example when the socket's send buffer fills up.
+ * Send the rest with another call.
+ *
+ * @return
+ * - LE_OK if at least one message was sent.
+ * - LE_COMM_ERROR if the localSocketFd is not connected.
+ * - LE_FAULT if failed for some other reason (check your logs).
+ * - LE_NO_MEMORY if the send socket is set to non-blocking and it doesn't have enough buffer
+ *                  space to send right now. Wait for the "writeable" event on the file descriptor.
+ *
+ * @warning DO NOT SEND DIRECTORY FILE DESCRIPTORS.  That can be exploited to break out of chroot()
+ *          jails.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t unixSocket_SendMsgBatch
+(
+    int localSocketFd,              ///< [IN] fd of the local socket that will be used to send.
+    unixSocket_MsgBuff_t* msgArray, ///< [IN] Messages to send (result field not used).
+    size_t msgCount,                ///< [IN] Number of messages in msgArray.
+    size_t* sentCountPtr            ///< [OUT] Number of messages sent (0 unless LE_OK).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    struct mmsghdr msgHeaders[UNIXSOCKET_MAX_BATCH_SIZE];
+    struct iovec ioVectors[UNIXSOCKET_MAX_BATCH_SIZE];
+    char cmsgBuffers[UNIXSOCKET_MAX_BATCH_SIZE][CMSG_SPACE(sizeof(int))];
+    size_t i;
+
+    *sentCountPtr = 0;
+
+    if (msgCount > UNIXSOCKET_MAX_BATCH_SIZE)
+    {
+        msgCount = UNIXSOCKET_MAX_BATCH_SIZE;
+    }
+
+    memset(msgHeaders, 0, msgCount * sizeof(msgHeaders[0]));
+
+    for (i = 0; i < msgCount; i++)
+    {
+        struct msghdr* msgHeaderPtr = &msgHeaders[i].msg_hdr;
+
+        if ((msgArray[i].dataPtr != NULL) && (msgArray[i].dataSize > 0))
+        {
+            ioVectors[i].iov_base = msgArray[i].dataPtr;
+            ioVectors[i].iov_len = msgArray[i].dataSize;
+            msgHeaderPtr->msg_iov = &ioVectors[i];
+            msgHeaderPtr->msg_iovlen = 1;
+        }
+
+        // Attach an SCM_RIGHTS control message to each message that has a file descriptor, so
+        // that it arrives with that message.
+        if (msgArray[i].fd >= 0)
+        {
+            msgHeaderPtr->msg_control = cmsgBuffers[i];
+            msgHeaderPtr->msg_controllen = sizeof(cmsgBuffers[i]);
+
+            struct cmsghdr* cmsgHeaderPtr = CMSG_FIRSTHDR(msgHeaderPtr);
+            cmsgHeaderPtr->cmsg_level = SOL_SOCKET;
+            cmsgHeaderPtr->cmsg_type = SCM_RIGHTS;
+            cmsgHeaderPtr->cmsg_len = CMSG_LEN(sizeof(int));
+            memcpy(CMSG_DATA(cmsgHeaderPtr), &msgArray[i].fd, sizeof(int));
+
+            msgHeaderPtr->msg_controllen = cmsgHeaderPtr->cmsg_len;
+
+            LE_DEBUG("Sending fd %d.", msgArray[i].fd);
+        }
+    }
+
+    // Now send the messages (retry if interrupted by a signal).
+    int msgsSent;
+    do
+    {
+        msgsSent = sendmmsg(localSocketFd, msgHeaders, msgCount, 0);
+    }
+    while ((msgsSent < 0) && (errno == EINTR));
+
+    if (msgsSent < 0)
+    {
+        switch (errno)
+        {
+            case EAGAIN:  // Same as EWOULDBLOCK
+                return LE_NO_MEMORY;
+
+            case ENOTCONN:
+            case ECONNRESET:
+            case EPIPE:
+                LE_WARN("sendmmsg() failed with errno %d (%m).", errno);
+                return LE_COMM_ERROR;
+
+            default:
+                LE_ERROR("sendmmsg() failed with errno %d (%m).", errno);
+                return LE_FAULT;
+        }
+    }
+
+    for (i = 0; i < (size_t)msgsSent; i++)
+    {
+        if ((msgArray[i].dataPtr != NULL) && (msgHeaders[i].msg_len < msgArray[i].dataSize))
+        {
+            LE_ERROR("The last %zu data bytes (of %zu total) were discarded by sendmmsg()!",
+                     msgArray[i].dataSize - msgHeaders[i].msg_len,
+                     msgArray[i].dataSize);
+            return LE_FAULT;
+        }
+    }
+
+    *sentCountPtr = msgsSent;
+
+    return LE_OK;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Receives through a connected Unix domain socket a message containing any combination of
@@ -725,6 +842,124 @@ le_result_t unixSocket_ReceiveDataMsg
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receives a batch of messages, each with an optional file descriptor, through a connected Unix
+ * domain datagram or sequenced-packet socket, using a single system call.  Never blocks, even if
+ * the socket is in blocking mode.  Any credentials received are discarded.
+ *
+ * Receives as many of the messages waiting on the socket as there are buffers for.  Each buffer's
+ * dataSize, fd and result fields are updated for the messages received.
+ *
+ * @return
+ * - LE_OK if at least one message was received.
+ * - LE_WOULD_BLOCK if there is nothing to be received.
+ * - LE_CLOSED if the connection closed.
+ * - LE_FAULT if failed for some other reason (check your logs).
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t unixSocket_ReceiveMsgBatch
+(
+    int localSocketFd,              ///< [IN] fd of local socket that will be used to receive.
+    unixSocket_MsgBuff_t* msgArray, ///< [IN+OUT] Buffers to receive into.
+    size_t msgCount,                ///< [IN] Number of buffers in msgArray.
+    size_t* receivedCountPtr        ///< [OUT] Number of messages received (0 unless LE_OK).
+)
+//--------------------------------------------------------------------------------------------------
+{
+    struct mmsghdr msgHeaders[UNIXSOCKET_MAX_BATCH_SIZE];
+    struct iovec ioVectors[UNIXSOCKET_MAX_BATCH_SIZE];
+    char cmsgBuffers[UNIXSOCKET_MAX_BATCH_SIZE][CMSG_BUFF_SIZE];
+    size_t i;
+
+    *receivedCountPtr = 0;
+
+    if (msgCount > UNIXSOCKET_MAX_BATCH_SIZE)
+    {
+        msgCount = UNIXSOCKET_MAX_BATCH_SIZE;
+    }
+
+    memset(msgHeaders, 0, msgCount * sizeof(msgHeaders[0]));
+
+    for (i = 0; i < msgCount; i++)
+    {
+        struct msghdr* msgHeaderPtr = &msgHeaders[i].msg_hdr;
+
+        ioVectors[i].iov_base = msgArray[i].dataPtr;
+        ioVectors[i].iov_len = msgArray[i].dataSize;
+        msgHeaderPtr->msg_iov = &ioVectors[i];
+        msgHeaderPtr->msg_iovlen = 1;
+
+        msgHeaderPtr->msg_control = cmsgBuffers[i];
+        msgHeaderPtr->msg_controllen = sizeof(cmsgBuffers[i]);
+    }
+
+    // Keep trying to receive until we don't get interrupted by a signal.  Don't wait for the
+    // whole batch to arrive if the socket is in blocking mode.
+    int msgsReceived;
+    do
+    {
+        msgsReceived = recvmmsg(localSocketFd, msgHeaders, msgCount, MSG_DONTWAIT, NULL);
+    }
+    while ((msgsReceived < 0) && (errno == EINTR));
+
+    if (msgsReceived < 0)
+    {
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+        {
+            return LE_WOULD_BLOCK;
+        }
+        else if (errno == ECONNRESET)
+        {
+            return LE_CLOSED;
+        }
+        else
+        {
+            LE_ERROR("recvmmsg() failed with errno %d (%m).", errno);
+            return LE_FAULT;
+        }
+    }
+
+    for (i = 0; i < (size_t)msgsReceived; i++)
+    {
+        struct msghdr* msgHeaderPtr = &msgHeaders[i].msg_hdr;
+
+        msgArray[i].fd = -1;
+
+        // If we received any ancillary data messages (control messages), extract what we want
+        // from them.
+        if (msgHeaderPtr->msg_controllen > 0)
+        {
+            ExtractAncillaryData(msgHeaderPtr, &msgArray[i].fd, NULL);
+        }
+        // If we didn't receive any ancillary data, and the message is empty, then the socket
+        // closed after the messages before it were sent.
+        else if (msgHeaders[i].msg_len == 0)
+        {
+            break;
+        }
+
+        // Check if ancillary data was discarded.
+        if ((msgHeaderPtr->msg_flags & MSG_CTRUNC) != 0)
+        {
+            LE_WARN("Ancillary data was discarded because it couldn't fit in our buffer.");
+        }
+
+        msgArray[i].dataSize = msgHeaders[i].msg_len;
+        msgArray[i].result = ((msgHeaderPtr->msg_flags & MSG_TRUNC) != 0) ? LE_NO_MEMORY : LE_OK;
+    }
+
+    if (i == 0)
+    {
+        return LE_CLOSED;
+    }
+
+    *receivedCountPtr = i;
+
+    return LE_OK;
+}
+
+
 
 //--------------------------------------------------------------------------------------------------
 /**
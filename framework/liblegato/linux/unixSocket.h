@@ -447,6 +447,62 @@ le_result_t unixSocket_SendDataMsg
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Largest number of messages sent or received by one call to unixSocket_SendMsgBatch() or
+ * unixSocket_ReceiveMsgBatch().  Bigger batches are cut short.
+ */
+//--------------------------------------------------------------------------------------------------
+#define UNIXSOCKET_MAX_BATCH_SIZE   32
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * One message in a batch sent by unixSocket_SendMsgBatch() or received by
+ * unixSocket_ReceiveMsgBatch().
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    void*       dataPtr;    ///< Data payload to send, or buffer to receive it into.
+    size_t      dataSize;   ///< [IN+OUT] Number of bytes to send, or that fit in the buffer.
+                            ///     Updated to the number of bytes received.
+    int         fd;         ///< [IN+OUT] File descriptor to send (-1 if none).  Updated to the
+                            ///     file descriptor received (-1 if none).
+    le_result_t result;     ///< [OUT] LE_OK if received, LE_NO_MEMORY if the data didn't fit in
+                            ///     the buffer and the rest of it was lost.
+}
+unixSocket_MsgBuff_t;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Sends a batch of messages, each with an optional file descriptor, through a connected Unix domain
+ * datagram or sequenced-packet socket, using a single system call.  Messages are sent in order.
+ *
+ * Fewer messages than requested may be sent, for example when the socket's send buffer fills up.
+ * Send the rest with another call.
+ *
+ * @return
+ * - LE_OK if at least one message was sent.
+ * - LE_COMM_ERROR if the localSocketFd is not connected.
+ * - LE_FAULT if failed for some other reason (check your logs).
+ * - LE_NO_MEMORY if the send socket is set to non-blocking and it doesn't have enough buffer
+ *                  space to send right now. Wait for the "writeable" event on the file descriptor.
+ *
+ * @warning DO NOT SEND DIRECTORY FILE DESCRIPTORS.  That can be exploited to break out of chroot()
+ *          jails.
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t unixSocket_SendMsgBatch
+(
+    int localSocketFd,              ///< [IN] fd of the local socket that will be used to send.
+    unixSocket_MsgBuff_t* msgArray, ///< [IN] Messages to send (result field not used).
+    size_t msgCount,                ///< [IN] Number of messages in msgArray.
+    size_t* sentCountPtr            ///< [OUT] Number of messages sent (0 unless LE_OK).
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Receives through a connected Unix domain socket a message containing any combination of
@@ -518,6 +574,31 @@ le_result_t unixSocket_ReceiveDataMsg
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Receives a batch of messages, each with an optional file descriptor, through a connected Unix
+ * domain datagram or sequenced-packet socket, using a single system call.  Never blocks, even if
+ * the socket is in blocking mode.  Any credentials received are discarded.
+ *
+ * Receives as many of the messages waiting on the socket as there are buffers for.  Each buffer's
+ * dataSize, fd and result fields are updated for the messages received.
+ *
+ * @return
+ * - LE_OK if at least one message was received.
+ * - LE_WOULD_BLOCK if there is nothing to be received.
+ * - LE_CLOSED if the connection closed.
+ * - LE_FAULT if failed for some other reason (check your logs).
+ */
+//--------------------------------------------------------------------------------------------------
+le_result_t unixSocket_ReceiveMsgBatch
+(
+    int localSocketFd,              ///< [IN] fd of local socket that will be used to receive.
+    unixSocket_MsgBuff_t* msgArray, ///< [IN+OUT] Buffers to receive into.
+    size_t msgCount,                ///< [IN] Number of buffers in msgArray.
+    size_t* receivedCountPtr        ///< [OUT] Number of messages received (0 unless LE_OK).
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Fetches the socket error state code (SO_ERROR).
@@ -44,6 +44,24 @@
 #define LOG_DEFAULT_LOG_FILTER      LE_LOG_INFO
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log flush policies.  These control how a process's log messages get to the log.
+ **/
+//--------------------------------------------------------------------------------------------------
+typedef enum
+{
+    LOG_FLUSH_SYNC,     ///< Messages are written to the log by the thread that logs them.
+    LOG_FLUSH_ASYNC,    ///< Messages are put on a ring buffer and written to the log by a
+                        ///  background thread.  Critical and emergency messages are still written
+                        ///  by the thread that logs them, after the ring buffer.
+    LOG_FLUSH_DEFERRED  ///< Like LOG_FLUSH_ASYNC, but messages are put on the ring buffer as binary
+                        ///  records (format string pointer and raw arguments), and the background
+                        ///  thread formats them.
+}
+log_FlushPolicy_t;
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Initialize the logging system.  This must be called VERY early in the process initialization.
@@ -140,6 +158,36 @@ const char* log_SeverityLevelToStr
 );
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Translates a flush policy string to a flush policy value.
+ *
+ * @return
+ *      The flush policy if successful.
+ *      -1 if the string is an invalid flush policy.
+ */
+//--------------------------------------------------------------------------------------------------
+log_FlushPolicy_t log_StrToFlushPolicy
+(
+    const char* policyStr   ///< [IN] The flush policy string.
+);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Translates a flush policy value to a flush policy string.
+ *
+ * @return
+ *      Pointer to a string constant containing the flush policy string.
+ *      NULL if the value is out of range.
+ */
+//--------------------------------------------------------------------------------------------------
+const char* log_FlushPolicyToStr
+(
+    log_FlushPolicy_t policy    ///< [IN] Flush policy.
+);
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Log messages from the framework.  Used for testing only.
@@ -0,0 +1,479 @@
+/**
+ * Lookup latency benchmark for the Config Tree.
+ *
+ * Builds a tree of over 10000 nodes under BASE_PATH, laid out like the system configuration: a
+ * stem with hundreds of apps, each with processes and a small asset model.  Then reports the
+ * latency of quick gets of values deep in the first app, the last app and random apps, and checks
+ * the values that come back.  Then reports the latency of quick sets, each committed on its own,
+ * which the Config Tree appends to its journal rather than rewriting the whole tree.  Then reports
+ * the latency of commits made while a read transaction is open, and of read transactions created
+ * in between, and checks that the open read transaction still reads the tree as it was.  Also changes
+ * the tree in a write transaction (deleting, re-creating and setting nodes), and checks the
+ * changes can be read both in the transaction and once it is committed.  Finally, exports the
+ * tree as the files of two new trees, one in the text format and one a snapshot, and reports how
+ * long the first read of each tree takes.  That read makes the Config Tree load the tree the way
+ * it does at start-up, mapping a snapshot and only reading the nodes that are used.  (The size of
+ * each file and the time spent loading it are in the Config Tree's log.)
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+
+
+// Where the test tree is built.
+#define BASE_PATH           "/configTreePerf"
+
+// Number of apps in the test tree.
+#define APP_COUNT           400
+
+// Number of apps written per write transaction while building the tree.
+#define APPS_PER_TXN        50
+
+// Number of arguments each app's process has.
+#define ARG_COUNT           10
+
+// Number of assets each app has.
+#define ASSET_COUNT         8
+
+// Number of nodes each app adds to the tree.
+#define NODES_PER_APP       (5 + ARG_COUNT + (2 * ASSET_COUNT))
+
+// Number of quick gets per measurement.
+#define GET_COUNT           2000
+
+// Number of quick sets.
+#define SET_COUNT           200
+
+// Number of commits made while a read transaction is open.  Each one changes a different app.
+#define VERSION_COUNT       100
+
+// Apps changed by the write transaction.
+#define DELETED_APP         (APP_COUNT / 2)
+#define RECREATED_APP       (APP_COUNT / 3)
+#define CHANGED_APP         (APP_COUNT - 2)
+
+// Trees the test tree is exported to, and loaded from.
+#define TEXT_TREE           "configTreePerfText"
+#define SNAPSHOT_TREE       "configTreePerfSnap"
+
+// Where the Config Tree keeps the first revision of a tree.
+#define TREE_FILE(tree)     "/legato/systems/current/config/" tree ".paper"
+
+// Number of tests.
+#define NUM_TESTS           11
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time elapsed since a given start time, in nanoseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetElapsedNs
+(
+    le_clk_Time_t startTime
+)
+{
+    le_clk_Time_t diffTime = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    return ((uint64_t)diffTime.sec * 1000000000) + ((uint64_t)diffTime.usec * 1000);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Value stored in an app's asset.
+ */
+//--------------------------------------------------------------------------------------------------
+static int32_t AssetValue
+(
+    uint32_t app,
+    uint32_t asset
+)
+{
+    return (int32_t)((app * 100) + asset);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Write one app's nodes, relative to the iterator's apps node.
+ */
+//--------------------------------------------------------------------------------------------------
+static void WriteApp
+(
+    le_cfg_IteratorRef_t iterRef,
+    uint32_t app,
+    int32_t valueOffset
+)
+{
+    char path[LE_CFG_STR_LEN_BYTES];
+    uint32_t i;
+
+    snprintf(path, sizeof(path), "app%" PRIu32 "/version", app);
+    le_cfg_SetString(iterRef, path, "1.0");
+
+    snprintf(path, sizeof(path), "app%" PRIu32 "/procs/main/executable", app);
+    le_cfg_SetString(iterRef, path, "/bin/main");
+
+    for (i = 0; i < ARG_COUNT; i++)
+    {
+        snprintf(path, sizeof(path), "app%" PRIu32 "/procs/main/args/%" PRIu32, app, i);
+        le_cfg_SetString(iterRef, path, "--arg");
+    }
+
+    for (i = 0; i < ASSET_COUNT; i++)
+    {
+        snprintf(path, sizeof(path), "app%" PRIu32 "/assets/%" PRIu32 "/value", app, i);
+        le_cfg_SetInt(iterRef, path, AssetValue(app, i) + valueOffset);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Build the test tree.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BuildTree
+(
+    void
+)
+{
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+    uint32_t app;
+
+    le_cfg_QuickDeleteNode(BASE_PATH);
+
+    for (app = 0; app < APP_COUNT; app += APPS_PER_TXN)
+    {
+        le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn(BASE_PATH "/apps");
+        uint32_t i;
+
+        for (i = app; (i < app + APPS_PER_TXN) && (i < APP_COUNT); i++)
+        {
+            WriteApp(iterRef, i, 0);
+        }
+
+        le_cfg_CommitTxn(iterRef);
+    }
+
+    LE_TEST_INFO("built %d nodes in %" PRIu64 " ms",
+                 APP_COUNT * NODES_PER_APP,
+                 GetElapsedNs(startTime) / 1000000);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Quick get the assets of apps picked by a given function, and report the average latency.
+ *
+ * @return true if every value was right.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool MeasureGets
+(
+    const char* label,
+    uint32_t (*pickApp)(uint32_t)
+)
+{
+    char path[LE_CFG_STR_LEN_BYTES];
+    bool ok = true;
+    uint32_t i;
+
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+
+    for (i = 0; i < GET_COUNT; i++)
+    {
+        uint32_t app = pickApp(i);
+        uint32_t asset = i % ASSET_COUNT;
+
+        snprintf(path, sizeof(path),
+                 BASE_PATH "/apps/app%" PRIu32 "/assets/%" PRIu32 "/value", app, asset);
+
+        ok = ok && (le_cfg_QuickGetInt(path, -1) == AssetValue(app, asset));
+    }
+
+    LE_TEST_INFO("%-12s %8.1f us/get", label, (double)GetElapsedNs(startTime) / GET_COUNT / 1000);
+
+    return ok;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * App pickers for MeasureGets().
+ */
+//--------------------------------------------------------------------------------------------------
+static uint32_t FirstApp(uint32_t i) { return 0; }
+static uint32_t LastApp(uint32_t i) { return APP_COUNT - 1; }
+static uint32_t RandomApp(uint32_t i) { return (uint32_t)(rand() % APP_COUNT); }
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Quick set the first asset of random apps to a new value and back, and report the average
+ * latency.
+ *
+ * @return true if the new values could be read back.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool MeasureSets
+(
+    void
+)
+{
+    char path[LE_CFG_STR_LEN_BYTES];
+    bool ok = true;
+    uint32_t i;
+
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+
+    for (i = 0; i < SET_COUNT; i++)
+    {
+        uint32_t app = RandomApp(i);
+
+        snprintf(path, sizeof(path), BASE_PATH "/apps/app%" PRIu32 "/assets/0/value", app);
+
+        le_cfg_QuickSetInt(path, -2);
+        ok = ok && (le_cfg_QuickGetInt(path, -1) == -2);
+        le_cfg_QuickSetInt(path, AssetValue(app, 0));
+    }
+
+    LE_TEST_INFO("%-12s %8.1f us/set",
+                 "quick sets:",
+                 (double)GetElapsedNs(startTime) / (2 * SET_COUNT) / 1000);
+
+    return ok;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Commit changes to the tree while a read transaction is open, which the Config Tree does without
+ * waiting for the read transaction to end.  Each read transaction is kept open across the next
+ * commit, so that each commit has a read transaction on the tree.  Reports the average latency of
+ * the commits, and of the read transactions created in between.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MeasureVersionedReads
+(
+    void
+)
+{
+    char path[LE_CFG_STR_LEN_BYTES];
+    bool oldOk = true;
+    bool newOk = true;
+    uint64_t commitNs = 0;
+    uint64_t readNs = 0;
+    uint32_t app;
+
+    le_cfg_IteratorRef_t readIterRef = le_cfg_CreateReadTxn(BASE_PATH "/apps");
+
+    for (app = 0; app < VERSION_COUNT; app++)
+    {
+        snprintf(path, sizeof(path), "app%" PRIu32 "/assets/0/value", app);
+
+        le_clk_Time_t startTime = le_clk_GetRelativeTime();
+        le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn(BASE_PATH "/apps");
+
+        le_cfg_SetInt(iterRef, path, -2);
+        le_cfg_CommitTxn(iterRef);
+
+        commitNs += GetElapsedNs(startTime);
+
+        // The open read transaction was created before the commit.
+        oldOk = oldOk && (le_cfg_GetInt(readIterRef, path, -1) == AssetValue(app, 0));
+        le_cfg_CancelTxn(readIterRef);
+
+        startTime = le_clk_GetRelativeTime();
+        readIterRef = le_cfg_CreateReadTxn(BASE_PATH "/apps");
+
+        newOk = newOk && (le_cfg_GetInt(readIterRef, path, -1) == -2);
+
+        readNs += GetElapsedNs(startTime);
+    }
+
+    le_cfg_CancelTxn(readIterRef);
+
+    LE_TEST_INFO("%-12s %8.1f us/commit", "vers commits:", (double)commitNs / VERSION_COUNT / 1000);
+    LE_TEST_INFO("%-12s %8.1f us/read", "vers reads:", (double)readNs / VERSION_COUNT / 1000);
+
+    LE_TEST_OK(oldOk, "read transactions read the tree as it was before later commits");
+    LE_TEST_OK(newOk, "read transactions read earlier commits");
+
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn(BASE_PATH "/apps");
+
+    for (app = 0; app < VERSION_COUNT; app++)
+    {
+        snprintf(path, sizeof(path), "app%" PRIu32 "/assets/0/value", app);
+        le_cfg_SetInt(iterRef, path, AssetValue(app, 0));
+    }
+
+    le_cfg_CommitTxn(iterRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Export the test tree as the file of a tree that isn't loaded, then read the last app's values
+ * from that tree and report how long the first read took.  The tree is deleted afterwards.
+ *
+ * @return true if the values were right.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool MeasureLoad
+(
+    const char* label,
+    const char* treeName,
+    const char* filePath,
+    le_result_t (*exportTree)(le_cfg_IteratorRef_t, const char*, const char*)
+)
+{
+    char path[LE_CFG_STR_LEN_BYTES];
+    uint32_t i;
+
+    // Clear out anything left by an earlier run, so that the first read has to load the tree.
+    le_cfgAdmin_DeleteTree(treeName);
+
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(BASE_PATH "/apps");
+    bool ok = (exportTree(iterRef, filePath, "") == LE_OK);
+
+    le_cfg_CancelTxn(iterRef);
+
+    snprintf(path, sizeof(path), "%s:/app%d/assets/0/value", treeName, APP_COUNT - 1);
+
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+
+    ok = ok && (le_cfg_QuickGetInt(path, -1) == AssetValue(APP_COUNT - 1, 0));
+
+    LE_TEST_INFO("%-12s %8.1f ms", label, (double)GetElapsedNs(startTime) / 1000000);
+
+    for (i = 1; i < ASSET_COUNT; i++)
+    {
+        snprintf(path, sizeof(path),
+                 "%s:/app%d/assets/%" PRIu32 "/value", treeName, APP_COUNT - 1, i);
+        ok = ok && (le_cfg_QuickGetInt(path, -1) == AssetValue(APP_COUNT - 1, i));
+    }
+
+    le_cfgAdmin_DeleteTree(treeName);
+
+    return ok;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure how long the test tree takes to load from a file in the text format and from a
+ * snapshot.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MeasureLoads
+(
+    void
+)
+{
+    LE_TEST_OK(MeasureLoad("text load:", TEXT_TREE, TREE_FILE(TEXT_TREE), le_cfgAdmin_ExportTree),
+               "load the tree from a text file");
+    LE_TEST_OK(MeasureLoad("snap load:",
+                           SNAPSHOT_TREE,
+                           TREE_FILE(SNAPSHOT_TREE),
+                           le_cfgAdmin_ExportTreeSnapshot),
+               "load the tree from a snapshot");
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that the changes made by ChangeTree() can be read through an iterator.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CheckChanges
+(
+    le_cfg_IteratorRef_t iterRef
+)
+{
+    char path[LE_CFG_STR_LEN_BYTES];
+    bool ok;
+
+    snprintf(path, sizeof(path), "app%d", DELETED_APP);
+    ok = !le_cfg_NodeExists(iterRef, path);
+
+    snprintf(path, sizeof(path), "app%d/assets/1/value", RECREATED_APP);
+    ok = ok && (le_cfg_GetInt(iterRef, path, -1) == AssetValue(RECREATED_APP, 1) + 1);
+
+    snprintf(path, sizeof(path), "app%d/assets/0/value", CHANGED_APP);
+    ok = ok && (le_cfg_GetInt(iterRef, path, -1) == 0);
+
+    snprintf(path, sizeof(path), "app%d/assets/1/value", CHANGED_APP);
+    ok = ok && (le_cfg_GetInt(iterRef, path, -1) == AssetValue(CHANGED_APP, 1));
+
+    snprintf(path, sizeof(path), "app%d/assets/0/value", APP_COUNT);
+    ok = ok && (le_cfg_GetInt(iterRef, path, -1) == AssetValue(APP_COUNT, 0));
+
+    return ok;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Change the test tree in a write transaction, so that the lookups go through the shadow tree,
+ * and then through the tree the changes were merged into.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ChangeTree
+(
+    void
+)
+{
+    char path[LE_CFG_STR_LEN_BYTES];
+
+    le_cfg_IteratorRef_t iterRef = le_cfg_CreateWriteTxn(BASE_PATH "/apps");
+
+    snprintf(path, sizeof(path), "app%d", DELETED_APP);
+    le_cfg_DeleteNode(iterRef, path);
+
+    snprintf(path, sizeof(path), "app%d", RECREATED_APP);
+    le_cfg_DeleteNode(iterRef, path);
+    WriteApp(iterRef, RECREATED_APP, 1);
+
+    snprintf(path, sizeof(path), "app%d/assets/0/value", CHANGED_APP);
+    le_cfg_SetInt(iterRef, path, 0);
+
+    WriteApp(iterRef, APP_COUNT, 0);
+
+    LE_TEST_OK(CheckChanges(iterRef), "changes read in the write transaction");
+
+    le_cfg_CommitTxn(iterRef);
+
+    iterRef = le_cfg_CreateReadTxn(BASE_PATH "/apps");
+    LE_TEST_OK(CheckChanges(iterRef), "changes read once committed");
+    le_cfg_CancelTxn(iterRef);
+}
+
+
+COMPONENT_INIT
+{
+    LE_TEST_PLAN(NUM_TESTS);
+    LE_TEST_INFO("====  Performance test for the Config Tree. ====");
+
+    BuildTree();
+
+    LE_TEST_OK(MeasureGets("first app:", FirstApp), "get values from the first app");
+    LE_TEST_OK(MeasureGets("last app:", LastApp), "get values from the last app");
+    LE_TEST_OK(MeasureGets("random apps:", RandomApp), "get values from random apps");
+    LE_TEST_OK(MeasureSets(), "set values in random apps");
+
+    MeasureVersionedReads();
+
+    MeasureLoads();
+
+    ChangeTree();
+
+    le_cfg_QuickDeleteNode(BASE_PATH);
+    LE_TEST_OK(le_cfg_QuickGetInt(BASE_PATH "/apps/app0/assets/0/value", -1) == -1,
+               "test tree deleted");
+
+    LE_TEST_EXIT;
+}
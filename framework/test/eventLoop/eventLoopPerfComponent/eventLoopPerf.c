@@ -0,0 +1,382 @@
+/**
+ * Throughput and latency benchmark for cross-thread queued functions.
+ *
+ * Runs increasing numbers of producer threads that each queue a burst of functions to the main
+ * thread using le_event_QueueFunctionToThread(), and reports how fast the main thread's event loop
+ * gets through them.  Then bounces a queued function back and forth between the main thread and
+ * an echo thread to measure the round-trip latency.  Finally, queues a large backlog of functions
+ * with different report budgets, and checks how long urgent functions and fd handlers wait
+ * behind it.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+
+
+// Number of producer threads used for each throughput run.
+static const size_t ProducerCounts[] = { 1, 2, 4, 8 };
+#define MAX_PRODUCER_COUNT  8
+
+// Number of functions queued by each producer thread.
+#define FUNCS_PER_PRODUCER  100000
+
+// Number of round trips between the main thread and the echo thread.
+#define ROUND_TRIPS         20000
+
+// Report budgets used for each backlog run (0 = no budget).
+static const size_t Budgets[] = { 0, 64 };
+
+// Number of functions queued for each backlog run.
+#define BACKLOG_SIZE        10000
+
+// One test per throughput run, the latency test, one test per backlog run for the urgent function
+// and one per budgeted backlog run for the fd handler.
+#define NUM_TESTS           (NUM_ARRAY_MEMBERS(ProducerCounts) + 1 + \
+                             NUM_ARRAY_MEMBERS(Budgets) + NUM_ARRAY_MEMBERS(Budgets) - 1)
+
+
+static le_thread_Ref_t MainThread;
+static le_thread_Ref_t EchoThread;
+
+static size_t RunIndex;
+static size_t ExpectedCount;
+static size_t ReceivedCount;
+static size_t OutOfOrderCount;
+static size_t NextSequence[MAX_PRODUCER_COUNT];
+static le_clk_Time_t StartTime;
+
+static int PipeFds[2];
+static size_t BacklogCount;
+static size_t FdHandlerBacklogCount;
+static bool FdHandlerCalled;
+
+
+static void StartThroughputRun(void);
+static void StartLatencyTest(void);
+static void StartBacklogRun(void);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time elapsed since a given start time, in nanoseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetElapsedNs
+(
+    le_clk_Time_t startTime
+)
+{
+    le_clk_Time_t diffTime = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    return ((uint64_t)diffTime.sec * 1000000000) + ((uint64_t)diffTime.usec * 1000);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function queued to the main thread by the producers.  Checks that each producer's functions
+ * run in the order they were queued.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CountFunc
+(
+    void* param1Ptr,    ///< Producer index.
+    void* param2Ptr     ///< Sequence number within the producer's burst.
+)
+{
+    size_t producer = (size_t)param1Ptr;
+    size_t sequence = (size_t)param2Ptr;
+
+    if (sequence != NextSequence[producer])
+    {
+        OutOfOrderCount++;
+    }
+    NextSequence[producer] = sequence + 1;
+
+    if (++ReceivedCount == ExpectedCount)
+    {
+        uint64_t elapsedNs = GetElapsedNs(StartTime);
+        size_t producerCount = ProducerCounts[RunIndex];
+
+        LE_TEST_INFO("%zu producer(s): %8.1f ns/function, %8.2f Mfunctions/s",
+                     producerCount,
+                     (double)elapsedNs / ExpectedCount,
+                     (double)ExpectedCount * 1000 / elapsedNs);
+        LE_TEST_OK(OutOfOrderCount == 0,
+                   "%zu functions from %zu producer(s) run in order",
+                   ExpectedCount, producerCount);
+
+        if (++RunIndex < NUM_ARRAY_MEMBERS(ProducerCounts))
+        {
+            StartThroughputRun();
+        }
+        else
+        {
+            StartLatencyTest();
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Producer thread main function.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* ProducerThread
+(
+    void* contextPtr    ///< Producer index.
+)
+{
+    size_t i;
+
+    for (i = 0; i < FUNCS_PER_PRODUCER; i++)
+    {
+        le_event_QueueFunctionToThread(MainThread, CountFunc, contextPtr, (void*)i);
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the next throughput run.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartThroughputRun
+(
+    void
+)
+{
+    size_t producerCount = ProducerCounts[RunIndex];
+    size_t i;
+
+    ExpectedCount = producerCount * FUNCS_PER_PRODUCER;
+    ReceivedCount = 0;
+    OutOfOrderCount = 0;
+    memset(NextSequence, 0, sizeof(NextSequence));
+
+    StartTime = le_clk_GetRelativeTime();
+
+    for (i = 0; i < producerCount; i++)
+    {
+        char name[32];
+
+        snprintf(name, sizeof(name), "producer%zu", i);
+        le_thread_Start(le_thread_Create(name, ProducerThread, (void*)i));
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function bounced between the main thread and the echo thread.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PingFunc
+(
+    void* param1Ptr,    ///< Number of round trips completed.
+    void* param2Ptr     ///< Not used.
+)
+{
+    size_t roundTrips = (size_t)param1Ptr;
+
+    if (le_thread_GetCurrent() == EchoThread)
+    {
+        le_event_QueueFunctionToThread(MainThread, PingFunc, param1Ptr, NULL);
+        return;
+    }
+
+    roundTrips++;
+
+    if (roundTrips < ROUND_TRIPS)
+    {
+        le_event_QueueFunctionToThread(EchoThread, PingFunc, (void*)roundTrips, NULL);
+        return;
+    }
+
+    uint64_t elapsedNs = GetElapsedNs(StartTime);
+
+    LE_TEST_INFO("round trip: %8.1f ns", (double)elapsedNs / ROUND_TRIPS);
+    LE_TEST_OK(roundTrips == ROUND_TRIPS, "%zu round trips", roundTrips);
+
+    RunIndex = 0;
+    StartBacklogRun();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Echo thread main function.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* EchoThreadMain
+(
+    void* contextPtr
+)
+{
+    // Functions can only be queued to this thread once its event loop is initialized, which it
+    // now is, so start the test.
+    le_event_QueueFunctionToThread(MainThread, PingFunc, (void*)0, NULL);
+
+    le_event_RunLoop();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start measuring the round-trip latency.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartLatencyTest
+(
+    void
+)
+{
+    EchoThread = le_thread_Create("echo", EchoThreadMain, NULL);
+
+    // The echo thread starts the test by sending the first ping back.
+    StartTime = le_clk_GetRelativeTime();
+    le_thread_Start(EchoThread);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check the results of a backlog run once both the backlog and the fd handler have run, and start
+ * the next run.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CheckBacklogRun
+(
+    void
+)
+{
+    size_t budget = Budgets[RunIndex];
+
+    if ((BacklogCount < BACKLOG_SIZE) || !FdHandlerCalled)
+    {
+        return;
+    }
+
+    LE_TEST_INFO("budget %zu: fd handler ran after %zu of %d queued functions",
+                 budget, FdHandlerBacklogCount, BACKLOG_SIZE);
+    if (budget != 0)
+    {
+        LE_TEST_OK(FdHandlerBacklogCount <= budget,
+                   "fd handler not held up by more than budget of %zu", budget);
+    }
+
+    if (++RunIndex < NUM_ARRAY_MEMBERS(Budgets))
+    {
+        StartBacklogRun();
+    }
+    else
+    {
+        LE_TEST_EXIT;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function queued as part of the backlog.  The first one makes the pipe readable.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BacklogFunc
+(
+    void* param1Ptr,    ///< Not used.
+    void* param2Ptr     ///< Not used.
+)
+{
+    if (BacklogCount++ == 0)
+    {
+        char byte = 0;
+        LE_ASSERT(write(PipeFds[1], &byte, 1) == 1);
+    }
+
+    CheckBacklogRun();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function queued to the urgent queue after the backlog.
+ */
+//--------------------------------------------------------------------------------------------------
+static void UrgentFunc
+(
+    void* param1Ptr,    ///< Not used.
+    void* param2Ptr     ///< Not used.
+)
+{
+    LE_TEST_OK(BacklogCount == 0,
+               "urgent function ran ahead of %d queued functions (budget %zu)",
+               BACKLOG_SIZE, Budgets[RunIndex]);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler for the read end of the pipe.
+ */
+//--------------------------------------------------------------------------------------------------
+static void PipeHandler
+(
+    int fd,             ///< Read end of the pipe.
+    short events        ///< Poll events.
+)
+{
+    char byte;
+
+    LE_ASSERT(read(fd, &byte, 1) == 1);
+
+    FdHandlerBacklogCount = BacklogCount;
+    FdHandlerCalled = true;
+
+    CheckBacklogRun();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start the next backlog run.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartBacklogRun
+(
+    void
+)
+{
+    size_t i;
+
+    if (RunIndex == 0)
+    {
+        LE_ASSERT(pipe(PipeFds) == 0);
+        le_fdMonitor_Create("backlog", PipeFds[0], PipeHandler, POLLIN);
+    }
+
+    BacklogCount = 0;
+    FdHandlerCalled = false;
+    le_event_SetReportBudget(Budgets[RunIndex]);
+
+    for (i = 0; i < BACKLOG_SIZE; i++)
+    {
+        le_event_QueueFunction(BacklogFunc, NULL, NULL);
+    }
+    le_event_QueueFunctionUrgent(UrgentFunc, NULL, NULL);
+}
+
+
+COMPONENT_INIT
+{
+    LE_TEST_PLAN((int)NUM_TESTS);
+    LE_TEST_INFO("====  Performance test for cross-thread queued functions. ====");
+
+    MainThread = le_thread_GetCurrent();
+
+    RunIndex = 0;
+    StartThroughputRun();
+}
@@ -0,0 +1,155 @@
+/**
+ * Micro-benchmark for the le_hashmap module.
+ *
+ * Fills chained (le_hashmap_Create) and compact (le_hashmap_CreateCompact) maps with increasing
+ * numbers of entries and reports the average latency of Put, Get, iteration and Remove for each.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+
+
+// Number of entries used for each measurement run.
+static const size_t EntryCounts[] = { 1000, 10000, 100000, 1000000 };
+#define MAX_ENTRY_COUNT 1000000
+
+// Multiplying by an odd constant spreads consecutive numbers over the key space without creating
+// duplicate keys.
+#define KEY_MULTIPLIER  2654435761u
+
+// One test per map type per run.
+#define TESTS_PER_RUN   2
+
+static uint32_t* KeysPtr;
+static uint32_t* ValuesPtr;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time elapsed since a given start time, in nanoseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetElapsedNs
+(
+    le_clk_Time_t startTime
+)
+{
+    le_clk_Time_t diffTime = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    return ((uint64_t)diffTime.sec * 1000000000) + ((uint64_t)diffTime.usec * 1000);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log the average latency of an operation.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportLatency
+(
+    const char* mapType,
+    const char* opName,
+    size_t count,
+    uint64_t elapsedNs
+)
+{
+    LE_TEST_INFO("%-8s %-8s %8zu entries: %8.1f ns/op",
+                 mapType, opName, count, (double)elapsedNs / count);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure Put, Get, iteration and Remove latency for a given map, which must be empty.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MeasureLatency
+(
+    le_hashmap_Ref_t mapRef,
+    const char* mapType,
+    size_t count
+)
+{
+    le_clk_Time_t startTime;
+    le_hashmap_It_Ref_t iteratorRef;
+    size_t foundCount = 0;
+    size_t iteratedCount = 0;
+    size_t i;
+
+    startTime = le_clk_GetRelativeTime();
+    for (i = 0; i < count; i++)
+    {
+        le_hashmap_Put(mapRef, &KeysPtr[i], &ValuesPtr[i]);
+    }
+    ReportLatency(mapType, "put", count, GetElapsedNs(startTime));
+
+    startTime = le_clk_GetRelativeTime();
+    for (i = 0; i < count; i++)
+    {
+        if (le_hashmap_Get(mapRef, &KeysPtr[i]) == &ValuesPtr[i])
+        {
+            foundCount++;
+        }
+    }
+    ReportLatency(mapType, "get", count, GetElapsedNs(startTime));
+
+    startTime = le_clk_GetRelativeTime();
+    iteratorRef = le_hashmap_GetIterator(mapRef);
+    while (le_hashmap_NextNode(iteratorRef) == LE_OK)
+    {
+        if (le_hashmap_GetValue(iteratorRef) != NULL)
+        {
+            iteratedCount++;
+        }
+    }
+    ReportLatency(mapType, "iterate", count, GetElapsedNs(startTime));
+
+    startTime = le_clk_GetRelativeTime();
+    for (i = 0; i < count; i++)
+    {
+        le_hashmap_Remove(mapRef, &KeysPtr[i]);
+    }
+    ReportLatency(mapType, "remove", count, GetElapsedNs(startTime));
+
+    LE_TEST_OK((foundCount == count) && (iteratedCount == count) && le_hashmap_isEmpty(mapRef),
+               "%s map with %zu entries", mapType, count);
+}
+
+
+COMPONENT_INIT
+{
+    size_t i;
+
+    LE_TEST_PLAN((int)NUM_ARRAY_MEMBERS(EntryCounts) * TESTS_PER_RUN);
+    LE_TEST_INFO("====  Performance test for le_hashmap module. ====");
+
+    KeysPtr = malloc(MAX_ENTRY_COUNT * sizeof(uint32_t));
+    ValuesPtr = malloc(MAX_ENTRY_COUNT * sizeof(uint32_t));
+    LE_ASSERT(KeysPtr && ValuesPtr);
+
+    for (i = 0; i < MAX_ENTRY_COUNT; i++)
+    {
+        KeysPtr[i] = (uint32_t)i * KEY_MULTIPLIER;
+        ValuesPtr[i] = i;
+    }
+
+    // Maps cannot be deleted, so each run uses new ones.  Both types of map start small and grow
+    // as needed, so the put latency includes the cost of resizing.
+    for (i = 0; i < NUM_ARRAY_MEMBERS(EntryCounts); i++)
+    {
+        MeasureLatency(le_hashmap_Create("perfChained", 0,
+                                         le_hashmap_HashUInt32, le_hashmap_EqualsUInt32),
+                       "chained",
+                       EntryCounts[i]);
+        MeasureLatency(le_hashmap_CreateCompact("perfCompact", 0,
+                                                le_hashmap_HashUInt32, le_hashmap_EqualsUInt32),
+                       "compact",
+                       EntryCounts[i]);
+    }
+
+    free(KeysPtr);
+    free(ValuesPtr);
+
+    LE_TEST_EXIT;
+}
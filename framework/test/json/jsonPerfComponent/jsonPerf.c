@@ -0,0 +1,406 @@
+/**
+ * Throughput benchmark for the le_json parser.
+ *
+ * Generates a JSON document of a few megabytes, followed by some trailing bytes, and parses it
+ * from a memory buffer with le_json_ParseBuffer() and from a regular file with le_json_Parse().
+ * Reports the throughput of each and checks that every value was reported, including strings
+ * holding escaped quotes.  Also checks that the trailing bytes can still be read from the file
+ * descriptor when the document end is reported, both for a regular file (read in chunks) and for
+ * a pipe (read one byte at a time), and that a truncated buffer is reported as a read error.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+
+
+// Number of items in the array making up the document, for the buffer and file runs.
+#define ITEM_COUNT          50000
+
+// Number of items in the document written to the pipe.  The whole document must fit in the pipe.
+#define PIPE_ITEM_COUNT     200
+
+// Number of times the buffer is parsed.
+#define BUFFER_RUNS         5
+
+// Bytes following the document.
+#define TRAILER             "TRAILER"
+
+// Number of tests.
+#define NUM_TESTS           6
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * What the event handler saw of a document.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    size_t objects;         ///< Number of objects ended.
+    size_t numbers;         ///< Number of numbers.
+    size_t strings;         ///< Number of strings.
+    size_t badNames;        ///< Number of "name" strings that didn't match the item's "id".
+    size_t errors;          ///< Number of errors reported.
+    uint32_t lastId;        ///< Last "id" number seen.
+    int fd;                 ///< File descriptor the document is read from, or -1.
+    bool trailerFound;      ///< true if TRAILER could be read from the fd at the document end.
+    bool done;              ///< true if the document end was reported.
+    le_clk_Time_t startTime;
+    uint64_t elapsedNs;     ///< Time between the start of parsing and the document end.
+}
+Counts_t;
+
+static char* DocPtr;
+static size_t DocSize;
+
+static Counts_t FileCounts;
+static Counts_t PipeCounts;
+static le_json_ParsingSessionRef_t Session;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time elapsed since a given start time, in nanoseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetElapsedNs
+(
+    le_clk_Time_t startTime
+)
+{
+    le_clk_Time_t diffTime = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    return ((uint64_t)diffTime.sec * 1000000000) + ((uint64_t)diffTime.usec * 1000);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Generate a document holding an array of items, followed by TRAILER.
+ *
+ * @return The size of the document, not including TRAILER.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GenerateDocument
+(
+    size_t itemCount
+)
+{
+    size_t maxSize = (itemCount * 128) + 64;
+    size_t size = 0;
+    size_t i;
+
+    DocPtr = realloc(DocPtr, maxSize);
+    LE_ASSERT(DocPtr != NULL);
+
+    size += snprintf(DocPtr + size, maxSize - size, "[\n");
+    for (i = 0; i < itemCount; i++)
+    {
+        size += snprintf(DocPtr + size,
+                         maxSize - size,
+                         "%s  { \"id\": %zu, \"name\": \"item \\\"%zu\\\"\", \"value\": %zu.25,"
+                         " \"ok\": true, \"tags\": [ \"a\", \"b\" ], \"none\": null }",
+                         (i == 0) ? "" : ",\n",
+                         i,
+                         i,
+                         i);
+    }
+    size += snprintf(DocPtr + size, maxSize - size, "\n]");
+    snprintf(DocPtr + size, maxSize - size, TRAILER);
+
+    return size;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that the counts match a document of a given number of items.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool CheckCounts
+(
+    const Counts_t* countsPtr,
+    size_t itemCount
+)
+{
+    return (countsPtr->done
+            && (countsPtr->errors == 0)
+            && (countsPtr->badNames == 0)
+            && (countsPtr->objects == itemCount)
+            && (countsPtr->numbers == itemCount * 2)
+            && (countsPtr->strings == itemCount * 3));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event handler.  Counts the values reported, and reads TRAILER from the file descriptor at the
+ * document end.
+ */
+//--------------------------------------------------------------------------------------------------
+static void EventHandler
+(
+    le_json_Event_t event
+)
+{
+    Counts_t* countsPtr = le_json_GetOpaquePtr();
+
+    switch (event)
+    {
+        case LE_JSON_OBJECT_END:
+
+            countsPtr->objects++;
+            break;
+
+        case LE_JSON_NUMBER:
+
+            if (countsPtr->numbers % 2 == 0)
+            {
+                countsPtr->lastId = (uint32_t)le_json_GetNumber();
+            }
+            countsPtr->numbers++;
+            break;
+
+        case LE_JSON_STRING:
+        {
+            const char* stringPtr = le_json_GetString();
+
+            if (stringPtr[0] == 'i')
+            {
+                char expected[32];
+
+                snprintf(expected, sizeof(expected), "item \\\"%" PRIu32 "\\\"", countsPtr->lastId);
+                if (strcmp(stringPtr, expected) != 0)
+                {
+                    countsPtr->badNames++;
+                }
+            }
+            countsPtr->strings++;
+            break;
+        }
+
+        case LE_JSON_DOC_END:
+
+            countsPtr->elapsedNs = GetElapsedNs(countsPtr->startTime);
+            countsPtr->done = true;
+
+            if (countsPtr->fd != -1)
+            {
+                char trailer[sizeof(TRAILER)] = "";
+
+                countsPtr->trailerFound = (read(countsPtr->fd, trailer, sizeof(trailer))
+                                           == sizeof(TRAILER) - 1)
+                                          && (strcmp(trailer, TRAILER) == 0);
+            }
+            break;
+
+        default:
+
+            break;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Error handler.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ErrorHandler
+(
+    le_json_Error_t error,
+    const char* msg
+)
+{
+    Counts_t* countsPtr = le_json_GetOpaquePtr();
+
+    LE_TEST_INFO("Parsing error after %zu bytes: %s",
+                 le_json_GetBytesRead(le_json_GetSession()),
+                 msg);
+    countsPtr->errors++;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse the document from a memory buffer a few times, and then a truncated copy of it.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestBuffer
+(
+    void
+)
+{
+    Counts_t counts;
+    uint64_t totalNs = 0;
+    bool ok = true;
+    int i;
+
+    for (i = 0; i < BUFFER_RUNS; i++)
+    {
+        memset(&counts, 0, sizeof(counts));
+        counts.fd = -1;
+        counts.startTime = le_clk_GetRelativeTime();
+
+        le_json_ParseBuffer(DocPtr, DocSize, EventHandler, ErrorHandler, &counts);
+
+        totalNs += counts.elapsedNs;
+        ok = ok && CheckCounts(&counts, ITEM_COUNT);
+    }
+
+    LE_TEST_INFO("buffer: %zu bytes, %8.1f MB/s",
+                 DocSize,
+                 (double)DocSize * BUFFER_RUNS * 1000 / totalNs);
+    LE_TEST_OK(ok, "parse %d items from a buffer", ITEM_COUNT);
+
+    memset(&counts, 0, sizeof(counts));
+    counts.fd = -1;
+
+    le_json_ParseBuffer(DocPtr, DocSize / 2, EventHandler, ErrorHandler, &counts);
+
+    LE_TEST_OK(!counts.done && (counts.errors == 1), "truncated buffer reported");
+}
+
+
+static void FinishFdParse(void* param1Ptr, void* param2Ptr);
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Error handler for file descriptor parses.  Queues the check of the results.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FdErrorHandler
+(
+    le_json_Error_t error,
+    const char* msg
+)
+{
+    ErrorHandler(error, msg);
+    le_event_QueueFunction(FinishFdParse, le_json_GetOpaquePtr(), NULL);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Event handler for file descriptor parses.  Queues the check of the results at the document end.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FdEventHandler
+(
+    le_json_Event_t event
+)
+{
+    EventHandler(event);
+
+    if (event == LE_JSON_DOC_END)
+    {
+        le_event_QueueFunction(FinishFdParse, le_json_GetOpaquePtr(), NULL);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start parsing a document from a file descriptor.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartFdParse
+(
+    Counts_t* countsPtr,
+    int fd
+)
+{
+    memset(countsPtr, 0, sizeof(*countsPtr));
+    countsPtr->fd = fd;
+    countsPtr->startTime = le_clk_GetRelativeTime();
+
+    Session = le_json_Parse(fd, FdEventHandler, FdErrorHandler, countsPtr);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Parse a small document written to a pipe.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestPipe
+(
+    void
+)
+{
+    int fds[2];
+
+    size_t size = GenerateDocument(PIPE_ITEM_COUNT) + sizeof(TRAILER) - 1;
+
+    LE_ASSERT(pipe(fds) == 0);
+    LE_ASSERT(write(fds[1], DocPtr, size) == (ssize_t)size);
+    close(fds[1]);
+
+    StartFdParse(&PipeCounts, fds[0]);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Checks the results of a file descriptor parse once parsing has stopped, and moves on to the
+ * next one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void FinishFdParse
+(
+    void* param1Ptr,
+    void* param2Ptr
+)
+{
+    Counts_t* countsPtr = param1Ptr;
+
+    le_json_Cleanup(Session);
+    close(countsPtr->fd);
+
+    if (countsPtr == &FileCounts)
+    {
+        LE_TEST_INFO("file:   %zu bytes, %8.1f MB/s",
+                     DocSize,
+                     (double)DocSize * 1000 / countsPtr->elapsedNs);
+        LE_TEST_OK(CheckCounts(countsPtr, ITEM_COUNT), "parse %d items from a file", ITEM_COUNT);
+        LE_TEST_OK(countsPtr->trailerFound, "bytes after the document left in the file");
+
+        TestPipe();
+    }
+    else
+    {
+        LE_TEST_OK(CheckCounts(countsPtr, PIPE_ITEM_COUNT),
+                   "parse %d items from a pipe",
+                   PIPE_ITEM_COUNT);
+        LE_TEST_OK(countsPtr->trailerFound, "bytes after the document left in the pipe");
+
+        free(DocPtr);
+        LE_TEST_EXIT;
+    }
+}
+
+
+COMPONENT_INIT
+{
+    char path[] = "/tmp/jsonPerfXXXXXX";
+
+    LE_TEST_PLAN(NUM_TESTS);
+    LE_TEST_INFO("====  Performance test for le_json module. ====");
+
+    DocSize = GenerateDocument(ITEM_COUNT);
+
+    TestBuffer();
+
+    // Write the document and trailer to a file, and parse it back from the start of the file.
+    int fd = mkstemp(path);
+    LE_ASSERT(fd >= 0);
+    unlink(path);
+
+    size_t size = DocSize + sizeof(TRAILER) - 1;
+    LE_ASSERT(write(fd, DocPtr, size) == (ssize_t)size);
+    LE_ASSERT(lseek(fd, 0, SEEK_SET) == 0);
+
+    StartFdParse(&FileCounts, fd);
+}
@@ -0,0 +1,241 @@
+/**
+ * Benchmark for the le_log module.
+ *
+ * Logs bursts of messages from increasing numbers of threads and reports the average time spent
+ * in each LE_INFO() call, then does the same with LE_TRACE() calls that have more arguments, and
+ * logs a flood of messages from one thread.  The app runs it in three processes, with the SYNC,
+ * ASYNC and DEFERRED log flush policies, set through the LE_LOG_FLUSH environment variable.  The
+ * bursts are smaller than the log ring buffer and are separated by pauses, so that with the ASYNC
+ * and DEFERRED policies they measure the cost of putting messages on the ring rather than of
+ * dropping them.  The flood doesn't pause, so with those policies most of its messages are
+ * dropped, and the number dropped is reported in the log.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+
+
+// Number of threads used for each measurement run.
+static const size_t ThreadCounts[] = { 1, 2, 4 };
+#define MAX_THREAD_COUNT    4
+
+// Number of bursts logged by each thread, number of messages in each burst, and pause between
+// bursts.
+#define BURST_COUNT         100
+#define BURST_SIZE          8
+#define BURST_PAUSE_US      5000
+
+// Number of messages in the flood.
+#define FLOOD_SIZE          2000
+
+// One test per run, plus the trace and flood tests.
+#define NUM_TESTS           (NUM_ARRAY_MEMBERS(ThreadCounts) + 2)
+
+
+static const char* PolicyStr;
+static uint64_t ThreadElapsedNs[MAX_THREAD_COUNT];
+static size_t LoggedCount;
+static le_sem_Ref_t StartSem;
+static le_sem_Ref_t ReadySem;
+static le_log_TraceRef_t TraceRef;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time elapsed since a given start time, in nanoseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetElapsedNs
+(
+    le_clk_Time_t startTime
+)
+{
+    le_clk_Time_t diffTime = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    return ((uint64_t)diffTime.sec * 1000000000) + ((uint64_t)diffTime.usec * 1000);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread that logs bursts of messages, and records the time it spent logging them.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* LogThread
+(
+    void* contextPtr
+)
+{
+    size_t threadIndex = (size_t)contextPtr;
+    uint64_t elapsedNs = 0;
+    size_t burst;
+    size_t i;
+
+    le_sem_Post(ReadySem);
+    le_sem_Wait(StartSem);
+
+    for (burst = 0; burst < BURST_COUNT; burst++)
+    {
+        le_clk_Time_t startTime = le_clk_GetRelativeTime();
+
+        for (i = 0; i < BURST_SIZE; i++)
+        {
+            LE_INFO("Thread %zu burst %zu message %zu.", threadIndex, burst, i);
+        }
+
+        elapsedNs += GetElapsedNs(startTime);
+        __atomic_add_fetch(&LoggedCount, BURST_SIZE, __ATOMIC_RELAXED);
+
+        usleep(BURST_PAUSE_US);
+    }
+
+    ThreadElapsedNs[threadIndex] = elapsedNs;
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a given number of logging threads at the same time, and report the average time spent in
+ * each LE_INFO() call.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MeasureBursts
+(
+    size_t threadCount
+)
+{
+    le_thread_Ref_t threads[MAX_THREAD_COUNT];
+    uint64_t elapsedNs = 0;
+    size_t i;
+
+    LoggedCount = 0;
+
+    for (i = 0; i < threadCount; i++)
+    {
+        char name[32];
+
+        snprintf(name, sizeof(name), "log%zu", i);
+        threads[i] = le_thread_Create(name, LogThread, (void*)i);
+        le_thread_SetJoinable(threads[i]);
+        le_thread_Start(threads[i]);
+        le_sem_Wait(ReadySem);
+    }
+
+    for (i = 0; i < threadCount; i++)
+    {
+        le_sem_Post(StartSem);
+    }
+    for (i = 0; i < threadCount; i++)
+    {
+        void* unused;
+        LE_ASSERT(le_thread_Join(threads[i], &unused) == LE_OK);
+        elapsedNs += ThreadElapsedNs[i];
+    }
+
+    LE_TEST_INFO("%-8s %zu thread(s): %8.1f ns/message",
+                 PolicyStr,
+                 threadCount,
+                 (double)elapsedNs / (threadCount * BURST_COUNT * BURST_SIZE));
+
+    LE_TEST_OK(LoggedCount == threadCount * BURST_COUNT * BURST_SIZE,
+               "%s: logged %zu messages from %zu thread(s)", PolicyStr, LoggedCount, threadCount);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log bursts of trace messages from one thread, and report the average time spent in each
+ * LE_TRACE() call.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MeasureTraces
+(
+    void
+)
+{
+    uint64_t elapsedNs = 0;
+    size_t burst;
+    size_t i;
+
+    for (burst = 0; burst < BURST_COUNT; burst++)
+    {
+        le_clk_Time_t startTime = le_clk_GetRelativeTime();
+
+        for (i = 0; i < BURST_SIZE; i++)
+        {
+            LE_TRACE(TraceRef, "Burst %zu message %zu: state %s, value %d (0x%08x), ratio %.3f.",
+                     burst, i, "running", (int)(burst * i), (unsigned int)(burst ^ i),
+                     (double)i / BURST_SIZE);
+        }
+
+        elapsedNs += GetElapsedNs(startTime);
+
+        usleep(BURST_PAUSE_US);
+    }
+
+    LE_TEST_INFO("%-8s traces:      %8.1f ns/message",
+                 PolicyStr,
+                 (double)elapsedNs / (BURST_COUNT * BURST_SIZE));
+
+    LE_TEST_OK(burst == BURST_COUNT, "%s: logged %d traces", PolicyStr, BURST_COUNT * BURST_SIZE);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log a flood of messages from one thread without pausing, and report the average time spent in
+ * each LE_INFO() call.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MeasureFlood
+(
+    void
+)
+{
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+    size_t i;
+
+    for (i = 0; i < FLOOD_SIZE; i++)
+    {
+        LE_INFO("Flood message %zu.", i);
+    }
+
+    uint64_t elapsedNs = GetElapsedNs(startTime);
+
+    LE_TEST_INFO("%-8s flood:       %8.1f ns/message", PolicyStr, (double)elapsedNs / FLOOD_SIZE);
+
+    LE_TEST_OK(i == FLOOD_SIZE, "%s: logged a flood of %d messages", PolicyStr, FLOOD_SIZE);
+}
+
+
+COMPONENT_INIT
+{
+    size_t i;
+
+    PolicyStr = getenv("LE_LOG_FLUSH");
+    if (PolicyStr == NULL)
+    {
+        PolicyStr = "SYNC";
+    }
+
+    LE_TEST_PLAN((int)NUM_TESTS);
+    LE_TEST_INFO("====  Benchmark for le_log module with %s flush policy. ====", PolicyStr);
+
+    StartSem = le_sem_Create("start", 0);
+    ReadySem = le_sem_Create("ready", 0);
+    TraceRef = le_log_GetTraceRef("perf");
+    le_log_EnableTrace(TraceRef);
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(ThreadCounts); i++)
+    {
+        MeasureBursts(ThreadCounts[i]);
+    }
+
+    MeasureTraces();
+    MeasureFlood();
+
+    LE_TEST_EXIT;
+}
@@ -0,0 +1,321 @@
+/**
+ * Contention benchmark for the le_mem module.
+ *
+ * Runs increasing numbers of threads that all allocate, reference and release objects from the
+ * same pool, and reports the average latency of each operation.  Checks that the pool statistics
+ * are still accurate afterwards, and that every free block of a pool can be allocated even while
+ * some of them are cached by another thread, both by a Legato thread and by a thread that has no
+ * cache of its own.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+
+
+// Number of threads used for each measurement run.
+static const size_t ThreadCounts[] = { 1, 2, 4, 8 };
+#define MAX_THREAD_COUNT    8
+
+// Number of rounds run by each thread.
+#define ROUNDS              100000
+
+// Number of objects held by a thread at a time in each round.
+#define OBJS_PER_ROUND      4
+
+// Operations per object: allocation, AddRef, Release of the extra reference and final Release.
+#define OPS_PER_OBJ         4
+
+// Number of blocks in the pool used to check that TryAlloc can get all free blocks.
+#define RECLAIM_POOL_SIZE   32
+
+// One test per run, plus the reclaim tests.
+#define NUM_TESTS           (NUM_ARRAY_MEMBERS(ThreadCounts) + 2)
+
+
+typedef struct
+{
+    uint32_t value[8];
+}
+PerfObj_t;
+
+// Blocks allocated by a reclaim test.
+typedef struct
+{
+    le_mem_PoolRef_t pool;
+    void* objPtrs[RECLAIM_POOL_SIZE];
+    size_t numAllocated;
+    bool isPoolEmpty;
+}
+Reclaim_t;
+
+static le_mem_PoolRef_t PerfPool;
+static le_sem_Ref_t StartSem;
+static le_sem_Ref_t ReadySem;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time elapsed since a given start time, in nanoseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetElapsedNs
+(
+    le_clk_Time_t startTime
+)
+{
+    le_clk_Time_t diffTime = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    return ((uint64_t)diffTime.sec * 1000000000) + ((uint64_t)diffTime.usec * 1000);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread that hammers the performance test pool.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* HammerThread
+(
+    void* contextPtr
+)
+{
+    PerfObj_t* objPtrs[OBJS_PER_ROUND];
+    size_t round;
+    size_t i;
+
+    le_sem_Post(ReadySem);
+    le_sem_Wait(StartSem);
+
+    for (round = 0; round < ROUNDS; round++)
+    {
+        for (i = 0; i < OBJS_PER_ROUND; i++)
+        {
+            objPtrs[i] = le_mem_ForceAlloc(PerfPool);
+            objPtrs[i]->value[0] = round;
+            le_mem_AddRef(objPtrs[i]);
+        }
+
+        for (i = 0; i < OBJS_PER_ROUND; i++)
+        {
+            le_mem_Release(objPtrs[i]);
+            le_mem_Release(objPtrs[i]);
+        }
+    }
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run a given number of threads against the performance test pool at the same time, and check
+ * the pool statistics once they have all finished.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MeasureContention
+(
+    size_t threadCount
+)
+{
+    le_thread_Ref_t threads[MAX_THREAD_COUNT];
+    le_mem_PoolStats_t stats;
+    le_clk_Time_t startTime;
+    uint64_t elapsedNs;
+    size_t i;
+
+    le_mem_ResetStats(PerfPool);
+
+    for (i = 0; i < threadCount; i++)
+    {
+        char name[32];
+
+        snprintf(name, sizeof(name), "hammer%zu", i);
+        threads[i] = le_thread_Create(name, HammerThread, NULL);
+        le_thread_SetJoinable(threads[i]);
+        le_thread_Start(threads[i]);
+        le_sem_Wait(ReadySem);
+    }
+
+    startTime = le_clk_GetRelativeTime();
+    for (i = 0; i < threadCount; i++)
+    {
+        le_sem_Post(StartSem);
+    }
+    for (i = 0; i < threadCount; i++)
+    {
+        void* unused;
+        LE_ASSERT(le_thread_Join(threads[i], &unused) == LE_OK);
+    }
+    elapsedNs = GetElapsedNs(startTime);
+
+    uint64_t numOps = (uint64_t)threadCount * ROUNDS * OBJS_PER_ROUND * OPS_PER_OBJ;
+    LE_TEST_INFO("%zu thread(s): %8.1f ns/op per thread, %8.1f Mops/s total",
+                 threadCount,
+                 (double)elapsedNs * threadCount / numOps,
+                 (double)numOps * 1000 / elapsedNs);
+
+    le_mem_GetStats(PerfPool, &stats);
+    LE_TEST_INFO("pool: %" PRIu64 " allocs, %zu in use, %zu free, max %zu used, %zu overflows",
+                 stats.numAllocs, stats.numBlocksInUse, stats.numFree, stats.maxNumBlocksUsed,
+                 stats.numOverflows);
+
+    LE_TEST_OK((stats.numAllocs == (uint64_t)threadCount * ROUNDS * OBJS_PER_ROUND) &&
+               (stats.numBlocksInUse == 0) &&
+               (stats.numFree == le_mem_GetObjectCount(PerfPool)) &&
+               (stats.maxNumBlocksUsed <= le_mem_GetObjectCount(PerfPool)),
+               "pool statistics after %zu thread(s)", threadCount);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Thread that allocates and releases all the blocks of a pool, then holds on to its thread until
+ * told to exit.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* CachingThread
+(
+    void* contextPtr
+)
+{
+    le_mem_PoolRef_t pool = contextPtr;
+    void* objPtrs[RECLAIM_POOL_SIZE];
+    size_t i;
+
+    for (i = 0; i < RECLAIM_POOL_SIZE; i++)
+    {
+        objPtrs[i] = le_mem_AssertAlloc(pool);
+    }
+    for (i = 0; i < RECLAIM_POOL_SIZE; i++)
+    {
+        le_mem_Release(objPtrs[i]);
+    }
+
+    le_sem_Post(ReadySem);
+    le_sem_Wait(StartSem);
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Allocate all the free blocks of a pool.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AllocAll
+(
+    Reclaim_t* reclaimPtr
+)
+{
+    void* extraPtr;
+
+    reclaimPtr->numAllocated = 0;
+
+    while ((reclaimPtr->numAllocated < RECLAIM_POOL_SIZE) &&
+           ((reclaimPtr->objPtrs[reclaimPtr->numAllocated] = le_mem_TryAlloc(reclaimPtr->pool))
+                != NULL))
+    {
+        reclaimPtr->numAllocated++;
+    }
+
+    extraPtr = le_mem_TryAlloc(reclaimPtr->pool);
+    reclaimPtr->isPoolEmpty = (extraPtr == NULL);
+    if (extraPtr != NULL)
+    {
+        le_mem_Release(extraPtr);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Main function of a plain (non-Legato) thread, which has no cache of its own, allocating all the
+ * free blocks of a pool.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* PlainThread
+(
+    void* contextPtr
+)
+{
+    AllocAll(contextPtr);
+
+    return NULL;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that all the free blocks of a pool can be allocated, even if another live thread has
+ * released them last.
+ */
+//--------------------------------------------------------------------------------------------------
+static void TestReclaim
+(
+    bool isPlainThread  ///< true to allocate from a thread that has no cache.
+)
+{
+    Reclaim_t reclaim;
+    void* unused;
+
+    reclaim.pool = le_mem_CreatePool(isPlainThread ? "reclaimPlain" : "reclaim",
+                                     sizeof(PerfObj_t));
+    le_mem_ExpandPool(reclaim.pool, RECLAIM_POOL_SIZE);
+
+    le_thread_Ref_t thread = le_thread_Create("caching", CachingThread, reclaim.pool);
+    le_thread_SetJoinable(thread);
+    le_thread_Start(thread);
+    le_sem_Wait(ReadySem);
+
+    if (isPlainThread)
+    {
+        pthread_t plainThread;
+
+        LE_ASSERT(pthread_create(&plainThread, NULL, PlainThread, &reclaim) == 0);
+        LE_ASSERT(pthread_join(plainThread, NULL) == 0);
+    }
+    else
+    {
+        AllocAll(&reclaim);
+    }
+
+    LE_TEST_OK((reclaim.numAllocated == RECLAIM_POOL_SIZE) && reclaim.isPoolEmpty,
+               "allocated %zu of %d free blocks%s", reclaim.numAllocated, RECLAIM_POOL_SIZE,
+               isPlainThread ? " from a thread without a cache" : "");
+
+    le_sem_Post(StartSem);
+    LE_ASSERT(le_thread_Join(thread, &unused) == LE_OK);
+
+    while (reclaim.numAllocated > 0)
+    {
+        le_mem_Release(reclaim.objPtrs[--reclaim.numAllocated]);
+    }
+}
+
+
+COMPONENT_INIT
+{
+    size_t i;
+
+    LE_TEST_PLAN((int)NUM_TESTS);
+    LE_TEST_INFO("====  Contention test for le_mem module. ====");
+
+    StartSem = le_sem_Create("start", 0);
+    ReadySem = le_sem_Create("ready", 0);
+
+    PerfPool = le_mem_CreatePool("perf", sizeof(PerfObj_t));
+    le_mem_ExpandPool(PerfPool, MAX_THREAD_COUNT * OBJS_PER_ROUND);
+    le_mem_SetNumObjsToForce(PerfPool, OBJS_PER_ROUND);
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(ThreadCounts); i++)
+    {
+        MeasureContention(ThreadCounts[i]);
+    }
+
+    TestReclaim(false);
+    TestReclaim(true);
+
+    LE_TEST_EXIT;
+}
@@ -0,0 +1,356 @@
+/**
+ * Throughput benchmark for large message payloads.
+ *
+ * Runs a server thread offering one service per payload size, from 4 KB to 1 MB, and does
+ * synchronous request-response transactions with each of them from the main thread, filling the
+ * whole request payload each time.  Reports the payload throughput for each size and checks that
+ * every request and response arrived intact.
+ *
+ * Build with LE_CONFIG_MSG_SHARED_MEMORY enabled and disabled to compare payloads passed through
+ * shared memory with payloads copied through the sockets.  Payloads bigger than the socket
+ * buffers can only be passed through shared memory, so those sizes are skipped when it is
+ * disabled.
+ *
+ * Then sends a burst of small asynchronous requests, some of them carrying file descriptors, and
+ * reports the request rate.  The requests pile up in the session's transmit queue, so this
+ * measures how well the messages are batched into socket system calls.  Checks that the requests
+ * and responses arrive in order and that every file descriptor arrives with its request.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+
+
+// Payload sizes to measure, and the service offering each of them.
+static const struct
+{
+    size_t size;
+    const char* serviceName;
+}
+PayloadSizes[] =
+{
+    {    4 * 1024, "MsgPerf4K" },
+    {   16 * 1024, "MsgPerf16K" },
+    {   64 * 1024, "MsgPerf64K" },
+    {  256 * 1024, "MsgPerf256K" },
+    { 1024 * 1024, "MsgPerf1M" },
+};
+
+// Largest payload that can be copied through a socket with the default socket buffer sizes.
+#define MAX_SOCKET_PAYLOAD  (64 * 1024)
+
+// Number of payload bytes sent in requests for each size.
+#define BYTES_PER_RUN       (64 * 1024 * 1024)
+
+// Service and payload size used for the burst of small requests.
+#define BURST_SERVICE_NAME  "MsgPerfBurst"
+#define BURST_PAYLOAD_SIZE  32
+
+// Number of requests in the burst.
+#define BURST_COUNT         20000
+
+// One request out of this many in the burst carries a file descriptor.
+#define BURST_FD_INTERVAL   8
+
+// One test per payload size, plus the burst.
+#define NUM_TESTS           (NUM_ARRAY_MEMBERS(PayloadSizes) + 1)
+
+
+static le_sem_Ref_t ServerReadySem;
+
+// Sequence number of the next burst request expected by the server, and the number of burst
+// requests that arrived out of order or without their file descriptor.
+static uint32_t ServerBurstSeq;
+static size_t ServerBurstErrors;
+
+// Sequence number of the next burst response expected by the client, and the number of burst
+// responses that arrived out of order.
+static uint32_t ClientBurstSeq;
+static size_t ClientBurstErrors;
+
+static le_clk_Time_t BurstStartTime;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time elapsed since a given start time, in nanoseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetElapsedNs
+(
+    le_clk_Time_t startTime
+)
+{
+    le_clk_Time_t diffTime = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    return ((uint64_t)diffTime.sec * 1000000000) + ((uint64_t)diffTime.usec * 1000);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the protocol for a payload size.
+ */
+//--------------------------------------------------------------------------------------------------
+static le_msg_ProtocolRef_t GetProtocol
+(
+    size_t payloadSize
+)
+{
+    char protocolId[32];
+
+    snprintf(protocolId, sizeof(protocolId), "MsgPerf%zu", payloadSize);
+
+    return le_msg_GetProtocolRef(protocolId, payloadSize);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server receive handler.  Checks that the request payload is intact and responds by flipping the
+ * bits of its first and last bytes in place.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ServerRecvHandler
+(
+    le_msg_MessageRef_t msgRef,     ///< Request message.
+    void* contextPtr                ///< Payload size.
+)
+{
+    size_t payloadSize = (size_t)contextPtr;
+    uint8_t* payloadPtr = le_msg_GetPayloadPtr(msgRef);
+
+    if ((payloadPtr[0] != payloadPtr[payloadSize / 2]) ||
+        (payloadPtr[0] != payloadPtr[payloadSize - 1]))
+    {
+        LE_TEST_INFO("Corrupted request payload of %zu bytes", payloadSize);
+        payloadPtr[0] = payloadPtr[payloadSize - 1] + 1;
+    }
+
+    payloadPtr[0] = ~payloadPtr[0];
+    payloadPtr[payloadSize - 1] = ~payloadPtr[payloadSize - 1];
+
+    le_msg_Respond(msgRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server receive handler for the burst of small requests.  Checks that the requests arrive in
+ * order with their file descriptors, and responds with the request's payload.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ServerBurstRecvHandler
+(
+    le_msg_MessageRef_t msgRef,     ///< Request message.
+    void* contextPtr                ///< Not used.
+)
+{
+    uint32_t seq;
+    memcpy(&seq, le_msg_GetPayloadPtr(msgRef), sizeof(seq));
+
+    int fd = le_msg_GetFd(msgRef);
+    bool expectFd = ((seq % BURST_FD_INTERVAL) == 0);
+
+    if ((seq != ServerBurstSeq) || ((fd >= 0) != expectFd))
+    {
+        ServerBurstErrors++;
+    }
+    ServerBurstSeq = seq + 1;
+
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+
+    le_msg_Respond(msgRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server thread main function.  Offers one service per payload size, and one for the burst.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* ServerThreadMain
+(
+    void* contextPtr
+)
+{
+    size_t i;
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(PayloadSizes); i++)
+    {
+        size_t payloadSize = PayloadSizes[i].size;
+        le_msg_ServiceRef_t serviceRef = le_msg_CreateService(GetProtocol(payloadSize),
+                                                              PayloadSizes[i].serviceName);
+
+        le_msg_SetServiceRecvHandler(serviceRef, ServerRecvHandler, (void*)payloadSize);
+        le_msg_AdvertiseService(serviceRef);
+    }
+
+    le_msg_ServiceRef_t burstServiceRef = le_msg_CreateService(GetProtocol(BURST_PAYLOAD_SIZE),
+                                                               BURST_SERVICE_NAME);
+    le_msg_SetServiceRecvHandler(burstServiceRef, ServerBurstRecvHandler, NULL);
+    le_msg_AdvertiseService(burstServiceRef);
+
+    le_sem_Post(ServerReadySem);
+
+    le_event_RunLoop();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure the request-response throughput for one payload size.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MeasureThroughput
+(
+    size_t index
+)
+{
+    size_t payloadSize = PayloadSizes[index].size;
+    size_t numRequests = BYTES_PER_RUN / payloadSize;
+    size_t numErrors = 0;
+    size_t i;
+
+    le_msg_SessionRef_t sessionRef = le_msg_CreateSession(GetProtocol(payloadSize),
+                                                          PayloadSizes[index].serviceName);
+    le_msg_OpenSessionSync(sessionRef);
+
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+
+    for (i = 0; i < numRequests; i++)
+    {
+        le_msg_MessageRef_t msgRef = le_msg_CreateMsg(sessionRef);
+        uint8_t* payloadPtr = le_msg_GetPayloadPtr(msgRef);
+        uint8_t fill = (uint8_t)i;
+
+        memset(payloadPtr, fill, payloadSize);
+
+        msgRef = le_msg_RequestSyncResponse(msgRef);
+        if (msgRef == NULL)
+        {
+            numErrors++;
+            break;
+        }
+
+        payloadPtr = le_msg_GetPayloadPtr(msgRef);
+        if ((payloadPtr[0] != (uint8_t)~fill) || (payloadPtr[payloadSize - 1] != (uint8_t)~fill))
+        {
+            numErrors++;
+        }
+
+        le_msg_ReleaseMsg(msgRef);
+    }
+
+    uint64_t elapsedNs = GetElapsedNs(startTime);
+
+    LE_TEST_INFO("%7zu byte payloads: %8.1f us/request, %8.1f MB/s",
+                 payloadSize,
+                 (double)elapsedNs / numRequests / 1000,
+                 (double)numRequests * payloadSize * 1000 / elapsedNs);
+    LE_TEST_OK(numErrors == 0, "%zu requests of %zu bytes", numRequests, payloadSize);
+
+    le_msg_DeleteSession(sessionRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Completion callback for the burst of small requests.  Checks that the responses arrive in order,
+ * and finishes the test after the last one.
+ */
+//--------------------------------------------------------------------------------------------------
+static void BurstResponseHandler
+(
+    le_msg_MessageRef_t msgRef,     ///< Response message.
+    void* contextPtr                ///< Not used.
+)
+{
+    uint32_t seq;
+    memcpy(&seq, le_msg_GetPayloadPtr(msgRef), sizeof(seq));
+
+    if (seq != ClientBurstSeq)
+    {
+        ClientBurstErrors++;
+    }
+    ClientBurstSeq = seq + 1;
+
+    le_msg_ReleaseMsg(msgRef);
+
+    if (seq == BURST_COUNT - 1)
+    {
+        uint64_t elapsedNs = GetElapsedNs(BurstStartTime);
+
+        LE_TEST_INFO("%7d byte burst:    %8.1f us/request, %8.1f requests/ms",
+                     BURST_PAYLOAD_SIZE,
+                     (double)elapsedNs / BURST_COUNT / 1000,
+                     (double)BURST_COUNT * 1000000 / elapsedNs);
+        LE_TEST_OK((ClientBurstErrors == 0) && (ServerBurstErrors == 0),
+                   "%d requests in a burst", BURST_COUNT);
+
+        LE_TEST_EXIT;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Send a burst of small asynchronous requests.  The responses are handled by
+ * BurstResponseHandler().
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartBurst
+(
+    void
+)
+{
+    le_msg_SessionRef_t sessionRef = le_msg_CreateSession(GetProtocol(BURST_PAYLOAD_SIZE),
+                                                          BURST_SERVICE_NAME);
+    le_msg_OpenSessionSync(sessionRef);
+
+    BurstStartTime = le_clk_GetRelativeTime();
+
+    uint32_t seq;
+    for (seq = 0; seq < BURST_COUNT; seq++)
+    {
+        le_msg_MessageRef_t msgRef = le_msg_CreateMsg(sessionRef);
+
+        memcpy(le_msg_GetPayloadPtr(msgRef), &seq, sizeof(seq));
+
+        if ((seq % BURST_FD_INTERVAL) == 0)
+        {
+            le_msg_SetFd(msgRef, open("/dev/null", O_RDONLY));
+        }
+
+        le_msg_RequestResponse(msgRef, BurstResponseHandler, NULL);
+    }
+}
+
+
+COMPONENT_INIT
+{
+    size_t i;
+
+    LE_TEST_PLAN((int)NUM_TESTS);
+    LE_TEST_INFO("====  Throughput test for large message payloads. ====");
+    LE_TEST_INFO("Shared memory payloads %s",
+                 LE_CONFIG_MSG_SHARED_MEMORY ? "enabled" : "disabled");
+
+    ServerReadySem = le_sem_Create("serverReady", 0);
+    le_thread_Start(le_thread_Create("MsgPerfServer", ServerThreadMain, NULL));
+    le_sem_Wait(ServerReadySem);
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(PayloadSizes); i++)
+    {
+        LE_TEST_BEGIN_SKIP(!LE_CONFIG_MSG_SHARED_MEMORY &&
+                           (PayloadSizes[i].size > MAX_SOCKET_PAYLOAD), 1);
+        MeasureThroughput(i);
+        LE_TEST_END_SKIP();
+    }
+
+    StartBurst();
+}
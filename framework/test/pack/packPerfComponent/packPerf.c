@@ -0,0 +1,648 @@
+/**
+ * Micro-benchmark for the le_pack module.
+ *
+ * Packs and unpacks the kinds of values found in .api files, the way the code generated by ifgen
+ * does: arrays of integers and doubles, arrays of structures made of scalars, and strings.  Arrays
+ * are packed both element by element (LE_PACK_PACKARRAY) and with a single copy
+ * (LE_PACK_PACKSIMPLEARRAY), and structures both member by member and as a block
+ * (le_pack_PackBlock).  Reports the average latency of each and checks that both ways produce the
+ * same message and unpack the same values.
+ *
+ * Also packs a typical message in the default and in the compact wire format, and reports the
+ * bytes each one packs, their worst-case size, and their latency.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+
+
+// Number of times each value is packed and unpacked.
+#define ITERATIONS      100000
+
+// Size of the message buffer.
+#define BUFFER_SIZE     4096
+
+// Number of elements in the arrays.
+#define UINT8_COUNT     1024
+#define INT32_COUNT     256
+#define DOUBLE_COUNT    128
+#define POINT_COUNT     64
+
+// Maximum and actual length of the string.
+#define STRING_MAX      256
+#define STRING_LENGTH   200
+
+// Length of the string in the message packed in both wire formats.
+#define NAME_LENGTH     20
+
+// One test per array type, plus one for structures, one for strings and one for wire formats.
+#define NUM_TESTS       6
+
+
+// Structure made only of scalars, without padding, like ifgen generates for an .api STRUCT.
+typedef struct
+{
+    int32_t x;
+    int32_t y;
+    double z;
+}
+Point_t;
+
+// Message packed in both wire formats: small integers and a short string, as most API calls send.
+typedef struct
+{
+    le_result_t result;
+    uint32_t id;
+    int32_t values[INT32_COUNT];
+    size_t valueCount;
+    Point_t points[POINT_COUNT];
+    size_t pointCount;
+    char name[STRING_MAX + 1];
+}
+Message_t;
+
+// Message buffers for each way of packing.
+static uint8_t ElementBuffer[BUFFER_SIZE];
+static uint8_t BulkBuffer[BUFFER_SIZE];
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time elapsed since a given start time, in nanoseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetElapsedNs
+(
+    le_clk_Time_t startTime
+)
+{
+    le_clk_Time_t diffTime = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    return ((uint64_t)diffTime.sec * 1000000000) + ((uint64_t)diffTime.usec * 1000);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report the latencies of both ways of packing and unpacking a value.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportLatency
+(
+    const char* name,
+    uint64_t elementNs,
+    uint64_t bulkNs
+)
+{
+    LE_TEST_INFO("%-16s %8.1f ns/op element by element, %8.1f ns/op in bulk (%.1fx)",
+                 name,
+                 (double)elementNs / ITERATIONS,
+                 (double)bulkNs / ITERATIONS,
+                 (double)elementNs / bulkNs);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Define a function that measures packing and unpacking an array of a simple type both ways.
+ */
+//--------------------------------------------------------------------------------------------------
+#define DEFINE_MEASURE_ARRAY(funcName, type, count, packFunc, unpackFunc)                       \
+    static void funcName                                                                        \
+    (                                                                                           \
+        void                                                                                    \
+    )                                                                                           \
+    {                                                                                           \
+        static type array[count];                                                               \
+        static type elementOut[count];                                                          \
+        static type bulkOut[count];                                                             \
+        size_t elementCount = 0;                                                                \
+        size_t bulkCount = 0;                                                                   \
+        uint8_t* bufferPtr;                                                                     \
+        size_t size;                                                                            \
+        bool result = true;                                                                     \
+        bool subResult;                                                                         \
+        size_t i;                                                                               \
+                                                                                                \
+        for (i = 0; i < (count); i++)                                                           \
+        {                                                                                       \
+            array[i] = (type)(i * 7 + 3);                                                       \
+        }                                                                                       \
+                                                                                                \
+        le_clk_Time_t startTime = le_clk_GetRelativeTime();                                     \
+        for (i = 0; i < ITERATIONS; i++)                                                        \
+        {                                                                                       \
+            bufferPtr = ElementBuffer;                                                          \
+            size = sizeof(ElementBuffer);                                                       \
+            LE_PACK_PACKARRAY(&bufferPtr, &size, array, (count), (count), packFunc, &subResult);\
+            result = result && subResult;                                                       \
+            bufferPtr = ElementBuffer;                                                          \
+            size = sizeof(ElementBuffer);                                                       \
+            LE_PACK_UNPACKARRAY(&bufferPtr, &size, elementOut, &elementCount, (count),          \
+                                unpackFunc, &subResult);                                        \
+            result = result && subResult;                                                       \
+        }                                                                                       \
+        uint64_t elementNs = GetElapsedNs(startTime);                                           \
+                                                                                                \
+        startTime = le_clk_GetRelativeTime();                                                   \
+        for (i = 0; i < ITERATIONS; i++)                                                        \
+        {                                                                                       \
+            bufferPtr = BulkBuffer;                                                             \
+            size = sizeof(BulkBuffer);                                                          \
+            LE_PACK_PACKSIMPLEARRAY(&bufferPtr, &size, array, (count), (count), &subResult);    \
+            result = result && subResult;                                                       \
+            bufferPtr = BulkBuffer;                                                             \
+            size = sizeof(BulkBuffer);                                                          \
+            LE_PACK_UNPACKSIMPLEARRAY(&bufferPtr, &size, bulkOut, &bulkCount, (count),          \
+                                      &subResult);                                              \
+            result = result && subResult;                                                       \
+        }                                                                                       \
+        uint64_t bulkNs = GetElapsedNs(startTime);                                              \
+                                                                                                \
+        ReportLatency(#type "[" STRINGIZE(count) "]", elementNs, bulkNs);                       \
+        LE_TEST_OK(result                                                                       \
+                   && (memcmp(ElementBuffer, BulkBuffer, sizeof(type) * (count) + 4) == 0)      \
+                   && (elementCount == (count)) && (bulkCount == (count))                       \
+                   && (memcmp(elementOut, array, sizeof(array)) == 0)                           \
+                   && (memcmp(bulkOut, array, sizeof(array)) == 0),                             \
+                   "pack and unpack " #type " arrays");                                         \
+    }
+
+DEFINE_MEASURE_ARRAY(MeasureUint8Array, uint8_t, UINT8_COUNT,
+                     le_pack_PackUint8, le_pack_UnpackUint8)
+DEFINE_MEASURE_ARRAY(MeasureInt32Array, int32_t, INT32_COUNT,
+                     le_pack_PackInt32, le_pack_UnpackInt32)
+DEFINE_MEASURE_ARRAY(MeasureDoubleArray, double, DOUBLE_COUNT,
+                     le_pack_PackDouble, le_pack_UnpackDouble)
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack a Point_t member by member.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool PackPointMembers
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    const Point_t* valuePtr
+)
+{
+    return le_pack_PackInt32(bufferPtr, sizePtr, valuePtr->x)
+           && le_pack_PackInt32(bufferPtr, sizePtr, valuePtr->y)
+           && le_pack_PackDouble(bufferPtr, sizePtr, valuePtr->z);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack a Point_t member by member.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool UnpackPointMembers
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    Point_t* valuePtr
+)
+{
+    return le_pack_UnpackInt32(bufferPtr, sizePtr, &valuePtr->x)
+           && le_pack_UnpackInt32(bufferPtr, sizePtr, &valuePtr->y)
+           && le_pack_UnpackDouble(bufferPtr, sizePtr, &valuePtr->z);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack a Point_t as a block.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool PackPointBlock
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    const Point_t* valuePtr
+)
+{
+    return le_pack_PackBlock(bufferPtr, sizePtr, valuePtr, sizeof(*valuePtr));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack a Point_t as a block.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool UnpackPointBlock
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    Point_t* valuePtr
+)
+{
+    return le_pack_UnpackBlock(bufferPtr, sizePtr, valuePtr, sizeof(*valuePtr));
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure packing and unpacking an array of structures both ways.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MeasureStructArray
+(
+    void
+)
+{
+    static Point_t array[POINT_COUNT];
+    static Point_t elementOut[POINT_COUNT];
+    static Point_t bulkOut[POINT_COUNT];
+    size_t elementCount = 0;
+    size_t bulkCount = 0;
+    uint8_t* bufferPtr;
+    size_t size;
+    bool result = true;
+    bool subResult;
+    size_t i;
+
+    for (i = 0; i < POINT_COUNT; i++)
+    {
+        array[i].x = i;
+        array[i].y = -(int32_t)i;
+        array[i].z = i * 0.5;
+    }
+
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+    for (i = 0; i < ITERATIONS; i++)
+    {
+        bufferPtr = ElementBuffer;
+        size = sizeof(ElementBuffer);
+        LE_PACK_PACKSTRUCTARRAY(&bufferPtr, &size, array, POINT_COUNT, POINT_COUNT,
+                                PackPointMembers, &subResult);
+        result = result && subResult;
+        bufferPtr = ElementBuffer;
+        size = sizeof(ElementBuffer);
+        LE_PACK_UNPACKSTRUCTARRAY(&bufferPtr, &size, elementOut, &elementCount, POINT_COUNT,
+                                  UnpackPointMembers, &subResult);
+        result = result && subResult;
+    }
+    uint64_t elementNs = GetElapsedNs(startTime);
+
+    startTime = le_clk_GetRelativeTime();
+    for (i = 0; i < ITERATIONS; i++)
+    {
+        bufferPtr = BulkBuffer;
+        size = sizeof(BulkBuffer);
+        LE_PACK_PACKSTRUCTARRAY(&bufferPtr, &size, array, POINT_COUNT, POINT_COUNT,
+                                PackPointBlock, &subResult);
+        result = result && subResult;
+        bufferPtr = BulkBuffer;
+        size = sizeof(BulkBuffer);
+        LE_PACK_UNPACKSTRUCTARRAY(&bufferPtr, &size, bulkOut, &bulkCount, POINT_COUNT,
+                                  UnpackPointBlock, &subResult);
+        result = result && subResult;
+    }
+    uint64_t bulkNs = GetElapsedNs(startTime);
+
+    ReportLatency("Point_t[" STRINGIZE(POINT_COUNT) "]", elementNs, bulkNs);
+    LE_TEST_OK(result
+               && (memcmp(ElementBuffer, BulkBuffer, sizeof(array) + 4) == 0)
+               && (elementCount == POINT_COUNT) && (bulkCount == POINT_COUNT)
+               && (memcmp(elementOut, array, sizeof(array)) == 0)
+               && (memcmp(bulkOut, array, sizeof(array)) == 0),
+               "pack and unpack struct arrays");
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure packing and unpacking a string.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MeasureString
+(
+    void
+)
+{
+    char string[STRING_MAX + 1];
+    char stringOut[STRING_MAX + 1];
+    uint8_t* bufferPtr;
+    size_t size;
+    bool result = true;
+    size_t i;
+
+    memset(string, 'a', STRING_LENGTH);
+    string[STRING_LENGTH] = '\0';
+
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+    for (i = 0; i < ITERATIONS; i++)
+    {
+        bufferPtr = BulkBuffer;
+        size = sizeof(BulkBuffer);
+        result = result && le_pack_PackString(&bufferPtr, &size, string, STRING_MAX);
+        bufferPtr = BulkBuffer;
+        size = sizeof(BulkBuffer);
+        result = result && le_pack_UnpackString(&bufferPtr, &size, stringOut, sizeof(stringOut),
+                                                STRING_MAX);
+    }
+    uint64_t elapsedNs = GetElapsedNs(startTime);
+
+    LE_TEST_INFO("%-16s %8.1f ns/op",
+                 "string[" STRINGIZE(STRING_MAX) "]",
+                 (double)elapsedNs / ITERATIONS);
+    LE_TEST_OK(result && (strcmp(string, stringOut) == 0), "pack and unpack strings");
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack a Point_t member by member in the compact wire format.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool PackPointCompact
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    const Point_t* valuePtr
+)
+{
+    return le_pack_PackCompactInt32(bufferPtr, sizePtr, valuePtr->x)
+           && le_pack_PackCompactInt32(bufferPtr, sizePtr, valuePtr->y)
+           && le_pack_PackDouble(bufferPtr, sizePtr, valuePtr->z);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack a Point_t member by member in the compact wire format.
+ */
+//--------------------------------------------------------------------------------------------------
+static inline bool UnpackPointCompact
+(
+    uint8_t** bufferPtr,
+    size_t* sizePtr,
+    Point_t* valuePtr
+)
+{
+    return le_pack_UnpackCompactInt32(bufferPtr, sizePtr, &valuePtr->x)
+           && le_pack_UnpackCompactInt32(bufferPtr, sizePtr, &valuePtr->y)
+           && le_pack_UnpackDouble(bufferPtr, sizePtr, &valuePtr->z);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack a message in the default wire format, the way ifgen generated code does.
+ *
+ * @return The number of bytes used, or 0 on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t PackMessage
+(
+    uint8_t* bufferPtr,
+    const Message_t* msgPtr
+)
+{
+    uint8_t* ptr = bufferPtr;
+    size_t size = BUFFER_SIZE;
+    bool result;
+
+    if (!le_pack_PackResult(&ptr, &size, msgPtr->result) ||
+        !le_pack_PackUint32(&ptr, &size, msgPtr->id))
+    {
+        return 0;
+    }
+    LE_PACK_PACKSIMPLEARRAY(&ptr, &size, msgPtr->values, msgPtr->valueCount, INT32_COUNT,
+                            &result);
+    if (!result)
+    {
+        return 0;
+    }
+    LE_PACK_PACKSTRUCTARRAY(&ptr, &size, msgPtr->points, msgPtr->pointCount, POINT_COUNT,
+                            PackPointBlock, &result);
+    if (!result || !le_pack_PackString(&ptr, &size, msgPtr->name, STRING_MAX))
+    {
+        return 0;
+    }
+
+    return ptr - bufferPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack a message in the default wire format.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool UnpackMessage
+(
+    uint8_t* bufferPtr,
+    Message_t* msgPtr
+)
+{
+    size_t size = BUFFER_SIZE;
+    bool result;
+
+    if (!le_pack_UnpackResult(&bufferPtr, &size, &msgPtr->result) ||
+        !le_pack_UnpackUint32(&bufferPtr, &size, &msgPtr->id))
+    {
+        return false;
+    }
+    LE_PACK_UNPACKSIMPLEARRAY(&bufferPtr, &size, msgPtr->values, &msgPtr->valueCount,
+                              INT32_COUNT, &result);
+    if (!result)
+    {
+        return false;
+    }
+    LE_PACK_UNPACKSTRUCTARRAY(&bufferPtr, &size, msgPtr->points, &msgPtr->pointCount,
+                              POINT_COUNT, UnpackPointBlock, &result);
+
+    return result && le_pack_UnpackString(&bufferPtr, &size, msgPtr->name, sizeof(msgPtr->name),
+                                          STRING_MAX);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pack a message in the compact wire format, the way code generated by ifgen --compact-wire does.
+ *
+ * @return The number of bytes used, or 0 on failure.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t PackCompactMessage
+(
+    uint8_t* bufferPtr,
+    const Message_t* msgPtr
+)
+{
+    uint8_t* ptr = bufferPtr;
+    size_t size = BUFFER_SIZE;
+    bool result;
+
+    if (!le_pack_PackCompactResult(&ptr, &size, msgPtr->result) ||
+        !le_pack_PackCompactUint32(&ptr, &size, msgPtr->id))
+    {
+        return 0;
+    }
+    LE_PACK_PACKCOMPACTARRAY(&ptr, &size, msgPtr->values, msgPtr->valueCount, INT32_COUNT,
+                             le_pack_PackCompactInt32, &result);
+    if (!result)
+    {
+        return 0;
+    }
+    LE_PACK_PACKCOMPACTSTRUCTARRAY(&ptr, &size, msgPtr->points, msgPtr->pointCount, POINT_COUNT,
+                                   PackPointCompact, &result);
+    if (!result || !le_pack_PackCompactString(&ptr, &size, msgPtr->name, STRING_MAX))
+    {
+        return 0;
+    }
+
+    return ptr - bufferPtr;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Unpack a message in the compact wire format.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool UnpackCompactMessage
+(
+    uint8_t* bufferPtr,
+    Message_t* msgPtr
+)
+{
+    size_t size = BUFFER_SIZE;
+    bool result;
+
+    if (!le_pack_UnpackCompactResult(&bufferPtr, &size, &msgPtr->result) ||
+        !le_pack_UnpackCompactUint32(&bufferPtr, &size, &msgPtr->id))
+    {
+        return false;
+    }
+    LE_PACK_UNPACKCOMPACTARRAY(&bufferPtr, &size, msgPtr->values, &msgPtr->valueCount,
+                               INT32_COUNT, le_pack_UnpackCompactInt32, &result);
+    if (!result)
+    {
+        return false;
+    }
+    LE_PACK_UNPACKCOMPACTSTRUCTARRAY(&bufferPtr, &size, msgPtr->points, &msgPtr->pointCount,
+                                     POINT_COUNT, UnpackPointCompact, &result);
+
+    return result && le_pack_UnpackCompactString(&bufferPtr, &size, msgPtr->name,
+                                                 sizeof(msgPtr->name), STRING_MAX);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Check that two messages hold the same values.
+ */
+//--------------------------------------------------------------------------------------------------
+static bool IsSameMessage
+(
+    const Message_t* msgPtr,
+    const Message_t* otherPtr
+)
+{
+    return (msgPtr->result == otherPtr->result)
+           && (msgPtr->id == otherPtr->id)
+           && (msgPtr->valueCount == otherPtr->valueCount)
+           && (memcmp(msgPtr->values, otherPtr->values,
+                      msgPtr->valueCount * sizeof(msgPtr->values[0])) == 0)
+           && (msgPtr->pointCount == otherPtr->pointCount)
+           && (memcmp(msgPtr->points, otherPtr->points,
+                      msgPtr->pointCount * sizeof(msgPtr->points[0])) == 0)
+           && (strcmp(msgPtr->name, otherPtr->name) == 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure packing and unpacking a message in both wire formats, and compare the bytes sent.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MeasureWireFormats
+(
+    void
+)
+{
+    static Message_t msg;
+    static Message_t defaultOut;
+    static Message_t compactOut;
+    size_t defaultBytes = 0;
+    size_t compactBytes = 0;
+    bool result = true;
+    size_t i;
+
+    msg.result = LE_NOT_FOUND;
+    msg.id = 1234;
+    msg.valueCount = INT32_COUNT / 2;
+    for (i = 0; i < msg.valueCount; i++)
+    {
+        msg.values[i] = (int32_t)i - 16;
+    }
+    msg.pointCount = POINT_COUNT / 2;
+    for (i = 0; i < msg.pointCount; i++)
+    {
+        msg.points[i].x = i;
+        msg.points[i].y = -(int32_t)i;
+        msg.points[i].z = i * 0.5;
+    }
+    memset(msg.name, 'n', NAME_LENGTH);
+    msg.name[NAME_LENGTH] = '\0';
+
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+    for (i = 0; i < ITERATIONS; i++)
+    {
+        defaultBytes = PackMessage(ElementBuffer, &msg);
+        result = result && (defaultBytes > 0) && UnpackMessage(ElementBuffer, &defaultOut);
+    }
+    uint64_t defaultNs = GetElapsedNs(startTime);
+
+    startTime = le_clk_GetRelativeTime();
+    for (i = 0; i < ITERATIONS; i++)
+    {
+        compactBytes = PackCompactMessage(BulkBuffer, &msg);
+        result = result && (compactBytes > 0) && UnpackCompactMessage(BulkBuffer, &compactOut);
+    }
+    uint64_t compactNs = GetElapsedNs(startTime);
+
+    // Worst case, as ifgen computes the message size: every array and string full, and every
+    // integer taking its largest varint.
+    size_t defaultMax = sizeof(uint32_t) * 2 + sizeof(uint32_t) + INT32_COUNT * sizeof(int32_t) +
+                        sizeof(uint32_t) + POINT_COUNT * sizeof(Point_t) +
+                        sizeof(uint32_t) + STRING_MAX;
+    size_t compactMax = 5 * 2 + 2 + INT32_COUNT * 5 +
+                        1 + POINT_COUNT * (5 * 2 + sizeof(double)) +
+                        2 + STRING_MAX;
+
+    // Messages in the default wire format are always sent whole, so they send their maximum size.
+    // Messages in the compact wire format only send the bytes packed.
+    LE_TEST_INFO("default wire format: %5zu bytes packed, %5zu bytes max, %8.1f ns/op",
+                 defaultBytes, defaultMax, (double)defaultNs / ITERATIONS);
+    LE_TEST_INFO("compact wire format: %5zu bytes packed, %5zu bytes max, %8.1f ns/op",
+                 compactBytes, compactMax, (double)compactNs / ITERATIONS);
+    LE_TEST_OK(result
+               && IsSameMessage(&msg, &defaultOut)
+               && IsSameMessage(&msg, &compactOut)
+               && (compactBytes < defaultBytes),
+               "pack and unpack messages in both wire formats");
+}
+
+
+COMPONENT_INIT
+{
+    LE_TEST_PLAN(NUM_TESTS);
+    LE_TEST_INFO("====  Performance test for le_pack module. ====");
+
+    MeasureUint8Array();
+    MeasureInt32Array();
+    MeasureDoubleArray();
+    MeasureStructArray();
+    MeasureString();
+    MeasureWireFormats();
+
+    LE_TEST_EXIT;
+}
@@ -0,0 +1,245 @@
+/**
+ * Benchmark for binding client sessions to services in the Service Directory.
+ *
+ * Opens a number of client sessions to each of a set of services before a server thread
+ * advertises them, so the Service Directory queues the sessions on their bindings.  Then has the
+ * server advertise all of the services and reports the time until every session is open.  Then
+ * deletes the sessions and opens them again with the services already advertised, and reports
+ * that time too.
+ *
+ * The more apps and bindings the target has, the more the Service Directory has to search for
+ * each session and service, so run it on a loaded system as well as on an empty one.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+
+
+// Number of services.  Their names are SdirPerf0, SdirPerf1, ...; each one needs a binding in the
+// .adef.
+#define NUM_SERVICES            32
+
+// Number of client sessions opened to each service.
+#define SESSIONS_PER_SERVICE    8
+
+#define NUM_SESSIONS            (NUM_SERVICES * SESSIONS_PER_SERVICE)
+
+// Size of a buffer big enough for any of the service names.
+#define SERVICE_NAME_BYTES      16
+
+// Maximum size of the messages (not that any are sent).
+#define MAX_MSG_SIZE            64
+
+// How long to let the session requests reach the Service Directory before advertising.
+#define ADVERTISE_DELAY_MS      500
+
+// One test for the sessions waiting on the services to be advertised, one for the services
+// already advertised.
+#define NUM_TESTS               2
+
+
+static le_msg_ProtocolRef_t ProtocolRef;
+
+static le_msg_SessionRef_t Sessions[NUM_SESSIONS];
+
+static le_sem_Ref_t AdvertiseSem;
+static le_sem_Ref_t ServerReadySem;
+
+// Number of sessions open so far in the current round, and when the round started.
+static size_t NumOpen;
+static le_clk_Time_t StartTime;
+
+// true while the sessions are waiting for the services to be advertised.
+static bool IsFirstRound;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time elapsed since a given start time, in nanoseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetElapsedNs
+(
+    le_clk_Time_t startTime
+)
+{
+    le_clk_Time_t diffTime = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    return ((uint64_t)diffTime.sec * 1000000000) + ((uint64_t)diffTime.usec * 1000);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the name of a service.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetServiceName
+(
+    size_t index,
+    char* nameBuffPtr,
+    size_t nameBuffSize
+)
+{
+    snprintf(nameBuffPtr, nameBuffSize, "SdirPerf%zu", index);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Server thread main function.  Creates the services, and advertises them all when told to.
+ */
+//--------------------------------------------------------------------------------------------------
+static void* ServerThreadMain
+(
+    void* contextPtr
+)
+{
+    le_msg_ServiceRef_t services[NUM_SERVICES];
+    char serviceName[SERVICE_NAME_BYTES];
+    size_t i;
+
+    for (i = 0; i < NUM_SERVICES; i++)
+    {
+        GetServiceName(i, serviceName, sizeof(serviceName));
+        services[i] = le_msg_CreateService(ProtocolRef, serviceName);
+    }
+
+    le_sem_Post(ServerReadySem);
+    le_sem_Wait(AdvertiseSem);
+
+    StartTime = le_clk_GetRelativeTime();
+
+    for (i = 0; i < NUM_SERVICES; i++)
+    {
+        le_msg_AdvertiseService(services[i]);
+    }
+
+    le_event_RunLoop();
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Create the client sessions and start opening them.
+ */
+//--------------------------------------------------------------------------------------------------
+static void OpenSessions
+(
+    le_msg_SessionEventHandler_t openHandler    ///< Called when each session opens.
+)
+{
+    char serviceName[SERVICE_NAME_BYTES];
+    size_t i;
+
+    NumOpen = 0;
+
+    for (i = 0; i < NUM_SESSIONS; i++)
+    {
+        GetServiceName(i % NUM_SERVICES, serviceName, sizeof(serviceName));
+        Sessions[i] = le_msg_CreateSession(ProtocolRef, serviceName);
+        le_msg_OpenSession(Sessions[i], openHandler, NULL);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Report the time taken to open all of the sessions in a round.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportRound
+(
+    const char* description
+)
+{
+    uint64_t elapsedNs = GetElapsedNs(StartTime);
+
+    LE_TEST_INFO("%d sessions to %d services, %s: %8.1f ms, %8.1f us/session",
+                 NUM_SESSIONS,
+                 NUM_SERVICES,
+                 description,
+                 (double)elapsedNs / 1000000,
+                 (double)elapsedNs / NUM_SESSIONS / 1000);
+    LE_TEST_OK(NumOpen == NUM_SESSIONS, "%d sessions bound %s", NUM_SESSIONS, description);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Called when a session opens.  After the last one of a round, reports the round, and then starts
+ * the second round or finishes the test.
+ */
+//--------------------------------------------------------------------------------------------------
+static void SessionOpenHandler
+(
+    le_msg_SessionRef_t sessionRef,     ///< Session that opened.
+    void* contextPtr                    ///< Not used.
+)
+{
+    size_t i;
+
+    NumOpen++;
+
+    if (NumOpen < NUM_SESSIONS)
+    {
+        return;
+    }
+
+    if (IsFirstRound)
+    {
+        ReportRound("waiting for the services");
+
+        for (i = 0; i < NUM_SESSIONS; i++)
+        {
+            le_msg_DeleteSession(Sessions[i]);
+        }
+
+        IsFirstRound = false;
+        StartTime = le_clk_GetRelativeTime();
+        OpenSessions(SessionOpenHandler);
+    }
+    else
+    {
+        ReportRound("services advertised");
+
+        LE_TEST_EXIT;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Advertise timer expiry handler.  Tells the server thread to advertise the services.
+ */
+//--------------------------------------------------------------------------------------------------
+static void AdvertiseTimerHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    le_sem_Post(AdvertiseSem);
+}
+
+
+COMPONENT_INIT
+{
+    LE_TEST_PLAN(NUM_TESTS);
+    LE_TEST_INFO("====  Service Directory binding benchmark. ====");
+
+    ProtocolRef = le_msg_GetProtocolRef("SdirPerf", MAX_MSG_SIZE);
+
+    AdvertiseSem = le_sem_Create("advertise", 0);
+    ServerReadySem = le_sem_Create("serverReady", 0);
+    le_thread_Start(le_thread_Create("SdirPerfServer", ServerThreadMain, NULL));
+    le_sem_Wait(ServerReadySem);
+
+    IsFirstRound = true;
+    OpenSessions(SessionOpenHandler);
+
+    le_timer_Ref_t timerRef = le_timer_Create("advertise");
+    le_timer_SetMsInterval(timerRef, ADVERTISE_DELAY_MS);
+    le_timer_SetHandler(timerRef, AdvertiseTimerHandler);
+    le_timer_Start(timerRef);
+}
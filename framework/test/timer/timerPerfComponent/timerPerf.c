@@ -0,0 +1,292 @@
+/**
+ * Micro-benchmark for the le_timer module.
+ *
+ * Starts, restarts and stops large numbers of timers in one thread and reports the average
+ * latency of each operation.  Afterwards a batch of short timers is left to expire to check that
+ * they are delivered in expiry order, and a batch of timers with a tolerance is left to expire to
+ * check that their expiries are coalesced.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+
+
+// Number of timers used for each latency measurement run.
+static const size_t TimerCounts[] = { 10000, 50000, 100000 };
+#define MAX_TIMER_COUNT 100000
+
+// Intervals used by the latency runs.  These are long enough that no timer expires while the
+// run is being measured.
+#define LATENCY_MIN_INTERVAL_MS     60000
+#define LATENCY_MAX_INTERVAL_MS     3600000
+
+// Number of timers and range of intervals used for the expiry order check.
+#define EXPIRY_TIMER_COUNT          10000
+#define EXPIRY_MIN_INTERVAL_MS      10
+#define EXPIRY_MAX_INTERVAL_MS      500
+
+// Number of timers, spacing of their intervals and tolerance used for the coalescing check.  All
+// the timers' tolerance windows overlap, so they should all be handled on a single wake-up.
+#define COALESCE_TIMER_COUNT        100
+#define COALESCE_BASE_INTERVAL_MS   100
+#define COALESCE_TOLERANCE_MS       200
+
+// Expiries further apart than this are counted as separate wake-ups.
+static const le_clk_Time_t WakeupGap = { 0, 5000 };
+
+// Timers are started one after the other, so the expected expiry time recorded by the test may be
+// slightly later than the one computed by the timer module.
+static const le_clk_Time_t OrderTolerance = { 0, 1000 };
+
+// One test per latency run, plus the expiry tests.
+#define TESTS_PER_RUN   1
+#define EXPIRY_TESTS    1
+#define COALESCE_TESTS  2
+
+static le_timer_Ref_t Timers[MAX_TIMER_COUNT];
+static uint32_t Intervals[MAX_TIMER_COUNT];
+static le_clk_Time_t ExpectedExpiry[EXPIRY_TIMER_COUNT];
+
+static size_t ExpiredCount;
+static size_t OrderErrorCount;
+static le_clk_Time_t LastExpiry;
+
+static le_clk_Time_t CoalesceExpectedExpiry[COALESCE_TIMER_COUNT];
+static size_t CoalescedCount;
+static size_t EarlyCount;
+static size_t WakeupCount;
+static le_clk_Time_t LastWakeup;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the time elapsed since a given start time, in nanoseconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static uint64_t GetElapsedNs
+(
+    le_clk_Time_t startTime
+)
+{
+    le_clk_Time_t diffTime = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+
+    return ((uint64_t)diffTime.sec * 1000000000) + ((uint64_t)diffTime.usec * 1000);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Log the average latency of an operation.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ReportLatency
+(
+    const char* opName,
+    size_t count,
+    uint64_t elapsedNs
+)
+{
+    LE_TEST_INFO("%-8s %7zu timers: %10.1f ns/op", opName, count, (double)elapsedNs / count);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Measure create, start, restart, stop and delete latency for a given number of timers.
+ */
+//--------------------------------------------------------------------------------------------------
+static void MeasureLatency
+(
+    size_t count
+)
+{
+    le_clk_Time_t startTime;
+    size_t failCount = 0;
+    size_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        Intervals[i] = le_rand_GetNumBetween(LATENCY_MIN_INTERVAL_MS, LATENCY_MAX_INTERVAL_MS);
+    }
+
+    startTime = le_clk_GetRelativeTime();
+    for (i = 0; i < count; i++)
+    {
+        Timers[i] = le_timer_Create("perf");
+        le_timer_SetMsInterval(Timers[i], Intervals[i]);
+    }
+    ReportLatency("create", count, GetElapsedNs(startTime));
+
+    startTime = le_clk_GetRelativeTime();
+    for (i = 0; i < count; i++)
+    {
+        if (le_timer_Start(Timers[i]) != LE_OK)
+        {
+            failCount++;
+        }
+    }
+    ReportLatency("start", count, GetElapsedNs(startTime));
+
+    startTime = le_clk_GetRelativeTime();
+    for (i = 0; i < count; i++)
+    {
+        le_timer_Restart(Timers[i]);
+    }
+    ReportLatency("restart", count, GetElapsedNs(startTime));
+
+    startTime = le_clk_GetRelativeTime();
+    for (i = 0; i < count; i++)
+    {
+        if (le_timer_Stop(Timers[i]) != LE_OK)
+        {
+            failCount++;
+        }
+    }
+    ReportLatency("stop", count, GetElapsedNs(startTime));
+
+    startTime = le_clk_GetRelativeTime();
+    for (i = 0; i < count; i++)
+    {
+        le_timer_Delete(Timers[i]);
+    }
+    ReportLatency("delete", count, GetElapsedNs(startTime));
+
+    LE_TEST_OK(failCount == 0, "%zu timers started and stopped", count);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Expiry handler for the coalescing check.
+ */
+//--------------------------------------------------------------------------------------------------
+static void CoalescedExpiryHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    le_clk_Time_t now = le_clk_GetRelativeTime();
+    le_clk_Time_t expiry = *(le_clk_Time_t*)le_timer_GetContextPtr(timerRef);
+
+    if (le_clk_GreaterThan(expiry, le_clk_Add(now, OrderTolerance)))
+    {
+        EarlyCount++;
+    }
+    if ((WakeupCount == 0) || le_clk_GreaterThan(le_clk_Sub(now, LastWakeup), WakeupGap))
+    {
+        WakeupCount++;
+    }
+    LastWakeup = now;
+
+    le_timer_Delete(timerRef);
+
+    if (++CoalescedCount == COALESCE_TIMER_COUNT)
+    {
+        LE_TEST_OK(EarlyCount == 0, "no coalesced timer expired early (%zu early)", EarlyCount);
+        LE_TEST_OK(WakeupCount == 1, "coalesced timers expired together (%zu wake-ups)",
+                   WakeupCount);
+        LE_TEST_EXIT;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a batch of timers with staggered intervals and overlapping tolerance windows.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartCoalescedTimers
+(
+    void
+)
+{
+    size_t i;
+
+    for (i = 0; i < COALESCE_TIMER_COUNT; i++)
+    {
+        le_timer_Ref_t timerRef = le_timer_Create("coalesce");
+
+        le_timer_SetMsInterval(timerRef, COALESCE_BASE_INTERVAL_MS + i);
+        LE_ASSERT(le_timer_SetMsTolerance(timerRef, COALESCE_TOLERANCE_MS) == LE_OK);
+        le_timer_SetHandler(timerRef, CoalescedExpiryHandler);
+        le_timer_SetContextPtr(timerRef, &CoalesceExpectedExpiry[i]);
+
+        CoalesceExpectedExpiry[i] = le_clk_Add(le_clk_GetRelativeTime(),
+                                               le_timer_GetInterval(timerRef));
+        le_timer_Start(timerRef);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Expiry handler for the expiry order check.
+ */
+//--------------------------------------------------------------------------------------------------
+static void ExpiryHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    le_clk_Time_t expiry = *(le_clk_Time_t*)le_timer_GetContextPtr(timerRef);
+
+    if (le_clk_GreaterThan(LastExpiry, le_clk_Add(expiry, OrderTolerance)))
+    {
+        OrderErrorCount++;
+    }
+    LastExpiry = expiry;
+
+    le_timer_Delete(timerRef);
+
+    if (++ExpiredCount == EXPIRY_TIMER_COUNT)
+    {
+        LE_TEST_OK(OrderErrorCount == 0, "timers expired in order (%zu out of order)",
+                   OrderErrorCount);
+        StartCoalescedTimers();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a batch of short timers with random intervals.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartExpiryTimers
+(
+    void
+)
+{
+    size_t i;
+
+    for (i = 0; i < EXPIRY_TIMER_COUNT; i++)
+    {
+        le_timer_Ref_t timerRef = le_timer_Create("expiry");
+
+        le_timer_SetMsInterval(timerRef,
+                               le_rand_GetNumBetween(EXPIRY_MIN_INTERVAL_MS, EXPIRY_MAX_INTERVAL_MS));
+        le_timer_SetHandler(timerRef, ExpiryHandler);
+        le_timer_SetContextPtr(timerRef, &ExpectedExpiry[i]);
+
+        le_timer_Start(timerRef);
+        ExpectedExpiry[i] = le_clk_Add(le_clk_GetRelativeTime(), le_timer_GetInterval(timerRef));
+    }
+}
+
+
+COMPONENT_INIT
+{
+    size_t i;
+
+    LE_TEST_PLAN((int)NUM_ARRAY_MEMBERS(TimerCounts) * TESTS_PER_RUN + EXPIRY_TESTS +
+                 COALESCE_TESTS);
+    LE_TEST_INFO("====  Performance test for le_timer module. ====");
+
+    for (i = 0; i < NUM_ARRAY_MEMBERS(TimerCounts); i++)
+    {
+        MeasureLatency(TimerCounts[i]);
+    }
+
+    StartExpiryTimers();
+}
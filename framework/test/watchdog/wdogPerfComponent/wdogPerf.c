@@ -0,0 +1,293 @@
+/**
+ * Benchmark for the watchdog daemon with many processes kicking their watchdogs.
+ *
+ * Starts a number of kicking processes (given as the first argument, default 1000), which each
+ * kick their watchdog every KICK_INTERVAL_MS, and reports the CPU time used by the watchdog
+ * daemon while they kick.  Runs once with the processes kicking through le_wdog_Kick() messages,
+ * and once with them kicking through their shared memory heartbeat.
+ *
+ * The kicking processes are this executable run again, with WDOG_PERF_MODE set in their
+ * environment.
+ *
+ * Copyright (C) Sierra Wireless Inc.
+ */
+
+#include "legato.h"
+#include "interfaces.h"
+#include "wdogHeartbeat.h"
+#include <sys/prctl.h>
+
+
+// Default number of kicking processes.
+#define DEFAULT_NUM_KICKERS     1000
+
+// How often each kicking process kicks its watchdog.
+#define KICK_INTERVAL_MS        10
+
+// How long to let the kicking processes start before measuring.
+#define STARTUP_MS              10000
+
+// How long to measure for.
+#define MEASURE_MS              10000
+
+// Environment variable telling a kicking process how to kick.
+#define MODE_ENV_VAR            "WDOG_PERF_MODE"
+
+// Name of the watchdog daemon process.
+#define WDOG_PROC_NAME          "watchdog"
+
+// One test for finding the watchdog daemon, and one per kick mode.
+#define NUM_TESTS               3
+
+
+static wdogHeartbeat_Slot_t* HeartbeatPtr;
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Kick timer expiry handler for kicking processes.
+ */
+//--------------------------------------------------------------------------------------------------
+static void KickTimerHandler
+(
+    le_timer_Ref_t timerRef
+)
+{
+    if (HeartbeatPtr != NULL)
+    {
+        LE_FATAL_IF(!wdogHeartbeat_Kick(HeartbeatPtr), "Heartbeat no longer watched.");
+    }
+    else
+    {
+        le_wdog_Kick();
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start kicking the watchdog, in the given mode.
+ */
+//--------------------------------------------------------------------------------------------------
+static void StartKicking
+(
+    const char* mode
+)
+{
+    if (strcmp(mode, "heartbeat") == 0)
+    {
+        int heartbeatFd;
+
+        LE_FATAL_IF(le_wdog_GetHeartbeat(&heartbeatFd) != LE_OK, "Can't get a heartbeat.");
+        HeartbeatPtr = wdogHeartbeat_Map(heartbeatFd);
+        LE_FATAL_IF(HeartbeatPtr == NULL, "Can't map the heartbeat.");
+    }
+
+    le_timer_Ref_t timerRef = le_timer_Create("kick");
+    le_timer_SetMsInterval(timerRef, KICK_INTERVAL_MS);
+    le_timer_SetRepeat(timerRef, 0);
+    le_timer_SetHandler(timerRef, KickTimerHandler);
+    le_timer_Start(timerRef);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Find the PID of the watchdog daemon.
+ *
+ * @return The PID, or -1 if it isn't running.
+ */
+//--------------------------------------------------------------------------------------------------
+static pid_t FindWatchdogPid
+(
+    void
+)
+{
+    DIR* dirPtr = opendir("/proc");
+    struct dirent* entryPtr;
+    pid_t pid = -1;
+
+    LE_ASSERT(dirPtr != NULL);
+
+    while ((pid < 0) && ((entryPtr = readdir(dirPtr)) != NULL))
+    {
+        char path[PATH_MAX];
+        char name[32] = "";
+
+        if ((entryPtr->d_name[0] < '0') || (entryPtr->d_name[0] > '9'))
+        {
+            continue;
+        }
+
+        snprintf(path, sizeof(path), "/proc/%s/comm", entryPtr->d_name);
+
+        FILE* filePtr = fopen(path, "r");
+        if (filePtr == NULL)
+        {
+            continue;
+        }
+
+        if ((fgets(name, sizeof(name), filePtr) != NULL)
+            && (strcmp(name, WDOG_PROC_NAME "\n") == 0))
+        {
+            pid = atoi(entryPtr->d_name);
+        }
+
+        fclose(filePtr);
+    }
+
+    closedir(dirPtr);
+
+    return pid;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Get the CPU time (user and system) used by a process so far, in seconds.
+ */
+//--------------------------------------------------------------------------------------------------
+static double GetCpuSeconds
+(
+    pid_t pid
+)
+{
+    char path[PATH_MAX];
+    char line[1024];
+    unsigned long utime = 0;
+    unsigned long stime = 0;
+
+    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+
+    FILE* filePtr = fopen(path, "r");
+    LE_ASSERT(filePtr != NULL);
+    LE_ASSERT(fgets(line, sizeof(line), filePtr) != NULL);
+    fclose(filePtr);
+
+    // utime and stime are the 12th and 13th fields after the parenthesised process name.
+    char* fieldsPtr = strrchr(line, ')');
+    LE_ASSERT(fieldsPtr != NULL);
+    LE_ASSERT(sscanf(fieldsPtr + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu",
+                     &utime, &stime) == 2);
+
+    return (double)(utime + stime) / sysconf(_SC_CLK_TCK);
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Start a kicking process.
+ */
+//--------------------------------------------------------------------------------------------------
+static pid_t StartKicker
+(
+    const char* mode
+)
+{
+    pid_t pid = fork();
+    LE_FATAL_IF(pid < 0, "fork() failed. %m");
+
+    if (pid == 0)
+    {
+        char* argv[] = { (char*)le_arg_GetProgramName(), NULL };
+
+        prctl(PR_SET_PDEATHSIG, SIGKILL);
+        setenv(MODE_ENV_VAR, mode, 1);
+        execv("/proc/self/exe", argv);
+        _exit(EXIT_FAILURE);
+    }
+
+    return pid;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Run one round: start the kicking processes, measure the watchdog daemon's CPU use while they
+ * kick, then stop them.
+ */
+//--------------------------------------------------------------------------------------------------
+static void RunRound
+(
+    pid_t wdogPid,
+    size_t numKickers,
+    const char* mode
+)
+{
+    pid_t* pids = calloc(numKickers, sizeof(pid_t));
+    size_t numAlive = 0;
+    size_t i;
+
+    LE_ASSERT(pids != NULL);
+
+    for (i = 0; i < numKickers; i++)
+    {
+        pids[i] = StartKicker(mode);
+    }
+
+    usleep(STARTUP_MS * 1000);
+
+    le_clk_Time_t startTime = le_clk_GetRelativeTime();
+    double startCpu = GetCpuSeconds(wdogPid);
+
+    usleep(MEASURE_MS * 1000);
+
+    double cpu = GetCpuSeconds(wdogPid) - startCpu;
+    le_clk_Time_t diffTime = le_clk_Sub(le_clk_GetRelativeTime(), startTime);
+    double seconds = diffTime.sec + (diffTime.usec / 1000000.0);
+
+    for (i = 0; i < numKickers; i++)
+    {
+        if (waitpid(pids[i], NULL, WNOHANG) == 0)
+        {
+            numAlive++;
+        }
+        kill(pids[i], SIGTERM);
+    }
+
+    for (i = 0; i < numKickers; i++)
+    {
+        waitpid(pids[i], NULL, 0);
+    }
+
+    LE_TEST_INFO("%zu processes kicking every %d ms, %-9s: watchdog daemon CPU %5.1f%%",
+                 numKickers,
+                 KICK_INTERVAL_MS,
+                 mode,
+                 cpu / seconds * 100);
+    LE_TEST_OK(numAlive == numKickers, "%zu of %zu processes kicked through %s",
+               numAlive, numKickers, mode);
+
+    free(pids);
+}
+
+
+COMPONENT_INIT
+{
+    const char* mode = getenv(MODE_ENV_VAR);
+
+    if (mode != NULL)
+    {
+        StartKicking(mode);
+        return;
+    }
+
+    size_t numKickers = DEFAULT_NUM_KICKERS;
+    const char* numKickersStr = le_arg_GetArg(0);
+
+    if (numKickersStr != NULL)
+    {
+        numKickers = strtoul(numKickersStr, NULL, 10);
+    }
+
+    LE_TEST_PLAN(NUM_TESTS);
+    LE_TEST_INFO("====  Watchdog daemon benchmark. ====");
+
+    pid_t wdogPid = FindWatchdogPid();
+    LE_TEST_ASSERT(wdogPid > 0, "watchdog daemon is running");
+
+    RunRound(wdogPid, numKickers, "messages");
+    RunRound(wdogPid, numKickers, "heartbeat");
+
+    LE_TEST_EXIT;
+}
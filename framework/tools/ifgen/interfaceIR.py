@@ -14,6 +14,17 @@ DIR_IN  = 1
 DIR_OUT = 2
 DIR_INOUT = (DIR_IN | DIR_OUT)
 
+#---------------------------------------------------------------------------------------------------
+# Compact wire format sizes
+#---------------------------------------------------------------------------------------------------
+def VarintSize(value):
+    """Number of bytes a value takes as a varint in the compact wire format."""
+    size = 1
+    while value >= 0x80:
+        value >>= 7
+        size += 1
+    return size
+
 #---------------------------------------------------------------------------------------------------
 # Named values
 #---------------------------------------------------------------------------------------------------
@@ -36,6 +47,15 @@ class Type(object):
         self.size = size
         self.comment = ""
 
+    def CompactSize(self):
+        """
+        Largest size of this type in the compact wire format, where integers wider than 8 bits are
+        packed as varints.
+        """
+        if self.size <= 1:
+            return self.size
+        return VarintSize((1 << (self.size * 8)) - 1)
+
     def __str__(self):
         return "Type<%d> %s" % (self.size, self.name)
 
@@ -47,6 +67,12 @@ class BasicType(Type):
     def __init__(self, name, size):
         super(BasicType, self).__init__(name, size)
 
+    def CompactSize(self):
+        # Doubles are packed as they are in memory in both wire formats.
+        if self.name == 'double':
+            return self.size
+        return super(BasicType, self).CompactSize()
+
     def __str__(self):
         return "BasicType<%d> %s" % (self.size, self.name)
 
@@ -162,6 +188,10 @@ class HandlerType(Type):
         if any([isinstance(parameter.apiType, HandlerType) for parameter in self.parameters]):
             raise Exception("Handlers cannot have handler parameters")
 
+    def CompactSize(self):
+        # Handler parameters are passed as a context reference, which isn't compacted.
+        return self.size
+
     def __str__(self):
         return "Handler %s(%s)" \
             % (self.name,
@@ -190,6 +220,9 @@ class StructMember(object):
     def MaxSize(self):
         return self.apiType.size
 
+    def CompactMaxSize(self):
+        return self.apiType.CompactSize()
+
     def __string__(self):
         return "{} {}".format(apiType, name)
 
@@ -201,6 +234,9 @@ class StructStringMember(StructMember):
     def MaxSize(self):
         return self.maxCount * self.apiType.size
 
+    def CompactMaxSize(self):
+        return VarintSize(self.maxCount) + self.maxCount
+
     def __str__(self):
         return "{} {}[{}]".format(self.apiType, self.name, self.maxCount)
 
@@ -212,6 +248,9 @@ class StructArrayMember(StructMember):
     def MaxSize(self):
         return self.maxCount * self.apiType.size
 
+    def CompactMaxSize(self):
+        return VarintSize(self.maxCount) + self.maxCount * self.apiType.CompactSize()
+
     def __str__(self):
         return "{} {}[{}]".format(self.apiType, self.name, self.maxCount)
 
@@ -228,6 +267,9 @@ class StructType(Type):
         super(StructType, self).__init__(name, size)
         self.members = list(members)
 
+    def CompactSize(self):
+        return sum([member.CompactMaxSize() for member in self.members])
+
     def __str__(self):
         return "Struct {} { {} }".format(self.name,
                                          ["{};".format(member)
@@ -285,6 +327,9 @@ class Parameter(object):
     def GetMaxSize(self):
         return self.apiType.size
 
+    def GetCompactMaxSize(self):
+        return self.apiType.CompactSize()
+
     def __str__(self):
         result = "%s %s " % (self.apiType.name, self.name)
         if self.direction & DIR_IN:
@@ -305,6 +350,11 @@ class ArrayParameter(Parameter):
     def GetMaxSize(self):
         return UINT32_TYPE.size + self.apiType.size * self.maxCount
 
+    def GetCompactMaxSize(self):
+        # Requests give the size of output-only arrays as a uint32.
+        return max(UINT32_TYPE.size,
+                   VarintSize(self.maxCount) + self.apiType.CompactSize() * self.maxCount)
+
     def __str__(self):
         result = "%s %s[%d] " % (self.apiType.name, self.name, self.maxCount)
         if self.direction & DIR_IN:
@@ -325,6 +375,10 @@ class StringParameter(Parameter):
         # Size of a string element is always 1.
         return UINT32_TYPE.size + self.maxCount
 
+    def GetCompactMaxSize(self):
+        # Requests give the size of output-only strings as a uint32.
+        return max(UINT32_TYPE.size, VarintSize(self.maxCount) + self.maxCount)
+
     def __str__(self):
         result = "%s %s[%d] " % (self.apiType.name, self.name, self.maxCount)
         if self.direction & DIR_IN:
@@ -590,19 +644,28 @@ class Interface(object):
         else:
             raise Exception("Unknown declaration object type")
 
-    def getMessageSize(self):
+    def getMessageSize(self, compact=False):
         """
         Get size of largest possible message to a function or handler.
 
         A message is 4-bytes for message ID, optional 4
         bytes for required output parameters, and a variable number of bytes to pack
         the return value (if the function has one), and all input and output parameters.
+
+        If compact is True, the sizes are for the compact wire format.
         """
+        if compact:
+            typeSize = lambda apiType: apiType.CompactSize()
+            parameterSize = lambda parameter: parameter.GetCompactMaxSize()
+        else:
+            typeSize = lambda apiType: apiType.size
+            parameterSize = lambda parameter: parameter.GetMaxSize()
+
         return 8 + max([1] +
-                       [sum([function.returnType.size if function.returnType else 0] +
-                            [parameter.GetMaxSize() for parameter in function.parameters])
+                       [sum([typeSize(function.returnType) if function.returnType else 0] +
+                            [parameterSize(parameter) for parameter in function.parameters])
                         for function in self.functions.values()] +
-                       [sum([parameter.GetMaxSize() for parameter in handler.parameters])
+                       [sum([parameterSize(parameter) for parameter in handler.parameters])
                         for handler in self.types.values() if isinstance(handler, HandlerType)])
 
     def __str__(self):
@@ -12,6 +12,14 @@ def AddLangArgumentGroup(parser):
                         action='store_true',
                         default=False,
                         help='generate asynchronous-style server functions')
+    parser.add_argument('--async-client',
+                        dest="asyncClient",
+                        action='store_true',
+                        default=False,
+                        help='also generate asynchronous-style client functions')
+
+def SetCompactWire():
+    codeGenHelpers.SetCompactWire()
 
 # Custom filters needed for C templates
 Filters = { 'DecorateName':        codeGenHelpers.DecorateName,
@@ -27,10 +35,14 @@ Filters = { 'DecorateName':        codeGenHelpers.DecorateName,
             'GetParameterCountPtr': codeGenHelpers.GetParameterCountPtr,
             'PackFunction':        codeGenHelpers.GetPackFunction,
             'UnpackFunction':      codeGenHelpers.GetUnpackFunction,
-            'CAPIParameters':      codeGenHelpers.IterCAPIParameters }
+            'CAPIParameters':      codeGenHelpers.IterCAPIParameters,
+            'AsyncCAPIParameters': codeGenHelpers.IterAsyncCAPIParameters,
+            'OutBufferParameters': codeGenHelpers.IterOutBufferParameters }
 
 
-Tests = { 'SizeParameter':         codeGenHelpers.IsSizeParameter }
+Tests = { 'SizeParameter':         codeGenHelpers.IsSizeParameter,
+          'SimpleType':            codeGenHelpers.IsSimpleType,
+          'SimpleStructType':      codeGenHelpers.IsSimpleStructType }
 
 Globals = { 'Labeler':             codeGenHelpers.Labeler }
 
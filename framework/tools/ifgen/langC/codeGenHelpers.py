@@ -306,38 +306,101 @@ _PackFunctionMapping = {
     interfaceIR.ONOFF_TYPE:  "le_pack_%sOnOff",
 }
 
-def GetPackFunction(apiType):
+# Types which are packed differently in the compact wire format.
+_CompactPackFunctionMapping = {
+    interfaceIR.UINT16_TYPE: "le_pack_%sCompactUint16",
+    interfaceIR.UINT32_TYPE: "le_pack_%sCompactUint32",
+    interfaceIR.UINT64_TYPE: "le_pack_%sCompactUint64",
+    interfaceIR.INT16_TYPE:  "le_pack_%sCompactInt16",
+    interfaceIR.INT32_TYPE:  "le_pack_%sCompactInt32",
+    interfaceIR.INT64_TYPE:  "le_pack_%sCompactInt64",
+    interfaceIR.SIZE_TYPE:   "le_pack_%sCompactSize",
+    interfaceIR.STRING_TYPE: "le_pack_%sCompactString",
+    interfaceIR.RESULT_TYPE: "le_pack_%sCompactResult",
+    interfaceIR.ONOFF_TYPE:  "le_pack_%sCompactOnOff",
+}
+
+# True when generating code for the compact wire format.  See SetCompactWire().
+_CompactWire = False
+
+def _GetPackFunction(apiType, direction):
     if isinstance(apiType, interfaceIR.ReferenceType):
-        return "le_pack_PackReference"
+        if _CompactWire:
+            return "le_pack_%sCompactReference" % (direction, )
+        return "le_pack_%sReference" % (direction, )
     elif isinstance(apiType, interfaceIR.BitmaskType) or \
          isinstance(apiType, interfaceIR.EnumType) or \
          isinstance(apiType, interfaceIR.StructType):
-        return "{}_Pack{}".format(apiType.iface.name, apiType.name)
+        return "{}_{}{}".format(apiType.iface.name, direction, apiType.name)
+    elif _CompactWire and apiType in _CompactPackFunctionMapping:
+        return _CompactPackFunctionMapping[apiType] % (direction, )
     else:
-        return _PackFunctionMapping[apiType] % ("Pack", )
+        return _PackFunctionMapping[apiType] % (direction, )
+
+def GetPackFunction(apiType):
+    return _GetPackFunction(apiType, "Pack")
 
 def GetUnpackFunction(apiType):
-    if isinstance(apiType, interfaceIR.ReferenceType):
-        return "le_pack_UnpackReference"
-    elif isinstance(apiType, interfaceIR.BitmaskType) or \
-         isinstance(apiType, interfaceIR.EnumType) or \
-         isinstance(apiType, interfaceIR.StructType):
-        return "{}_Unpack{}".format(apiType.iface.name, apiType.name)
-    else:
-        return _PackFunctionMapping[apiType] % ("Unpack", )
+    return _GetPackFunction(apiType, "Unpack")
 
 def EscapeString(string):
     return string.encode('string_escape').replace('"', '\\"')
 
+# Types which are packed as they are in memory, so arrays of them can be packed with a single copy.
+_SimpleTypes = frozenset([
+    interfaceIR.UINT8_TYPE,
+    interfaceIR.UINT16_TYPE,
+    interfaceIR.UINT32_TYPE,
+    interfaceIR.UINT64_TYPE,
+    interfaceIR.INT8_TYPE,
+    interfaceIR.INT16_TYPE,
+    interfaceIR.INT32_TYPE,
+    interfaceIR.INT64_TYPE,
+    interfaceIR.CHAR_TYPE,
+    interfaceIR.DOUBLE_TYPE,
+    interfaceIR.RESULT_TYPE,
+    interfaceIR.ONOFF_TYPE,
+])
+
+# Types which are packed as they are in memory in the compact wire format.
+_CompactSimpleTypes = frozenset([
+    interfaceIR.UINT8_TYPE,
+    interfaceIR.INT8_TYPE,
+    interfaceIR.CHAR_TYPE,
+    interfaceIR.DOUBLE_TYPE,
+])
+
 #---------------------------------------------------------------------------------------------------
 # Test functions
 #---------------------------------------------------------------------------------------------------
 def IsSizeParameter(parameter):
     return isinstance(parameter, SizeParameter)
 
+def IsSimpleType(apiType):
+    if _CompactWire:
+        return apiType in _CompactSimpleTypes
+    return apiType in _SimpleTypes
+
+def IsSimpleStructType(apiType):
+    """
+    Structures made only of simple type scalars are packed as they are in memory, unless the
+    compiler pads them.
+    """
+    return isinstance(apiType, interfaceIR.StructType) and \
+           all(type(member) is interfaceIR.StructMember and IsSimpleType(member.apiType)
+               for member in apiType.members)
+
 #---------------------------------------------------------------------------------------------------
 # Global functions
 #---------------------------------------------------------------------------------------------------
+def SetCompactWire():
+    """
+    Generate code for the compact wire format: the filters and tests above pick the compact pack
+    functions and simple types from now on.
+    """
+    global _CompactWire
+    _CompactWire = True
+
 class SizeParameter(interfaceIR.Parameter):
     """
     C adds size parameters to the API for some string and array parameters.  Define a class for
@@ -382,6 +445,33 @@ def IterCAPIParameters(function):
     if isinstance(function, interfaceIR.HandlerType):
         yield interfaceIR.Parameter(_CONTEXT_TYPE, 'contextPtr')
 
+def IterAsyncCAPIParameters(function):
+    """
+    Given a function, yield the parameters of its asynchronous client variant which are present in
+    the C API.
+
+    These are the input parameters of the C API, without the buffer sizes of the output strings
+    and arrays: the response handler is given the outputs in buffers of the maximum size instead.
+    """
+    for parameter in IterCAPIParameters(function):
+        if isinstance(parameter, SizeParameter):
+            if parameter.relatedParameter.direction == interfaceIR.DIR_IN:
+                yield parameter
+        elif (parameter.direction & interfaceIR.DIR_IN) == interfaceIR.DIR_IN:
+            yield parameter
+
+def IterOutBufferParameters(function):
+    """
+    Given a function, yield its output strings and arrays.
+
+    These are the parameters of the asynchronous client variant that need buffers of their own to
+    be given to the response handler.
+    """
+    for parameter in function.parameters:
+        if (isinstance(parameter, (interfaceIR.StringParameter, interfaceIR.ArrayParameter)) and
+            (parameter.direction & interfaceIR.DIR_OUT) == interfaceIR.DIR_OUT):
+            yield parameter
+
 class Labeler(object):
     def __init__(self, label):
         self.label = label
@@ -75,6 +75,33 @@ _ClientThreadData_t;
  */
 //--------------------------------------------------------------------------------------------------
 static le_mem_PoolRef_t _ClientThreadDataPool;
+{%- if args.asyncClient %}
+{%- for function in functions if function is not EventFunction and
+                                 function is not HasCallbackFunction and
+                                 function|OutBufferParameters|list %}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Buffers for the "out" strings and arrays of {{apiName}}_{{function.name}}_Async() responses,
+ * and the memory pool they are allocated from.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef struct
+{
+    {%- for parameter in function|OutBufferParameters %}
+    {%- if parameter is StringParameter %}
+    char {{parameter.name}}[{{parameter.maxCount + 1}}];
+    {%- else %}
+    {{parameter.apiType|FormatType}} {{parameter.name}}[{{parameter.maxCount}}];
+    {%- endif %}
+    {%- endfor %}
+}
+_{{function.name}}OutBuffers_t;
+
+static le_mem_PoolRef_t _{{function.name}}OutBufferPool;
+{%- endfor %}
+{%- endif %}
 
 
 //--------------------------------------------------------------------------------------------------
@@ -310,6 +337,16 @@ static void InitCommonData(void)
     // Allocate the client thread pool
     _ClientThreadDataPool = le_mem_CreatePool("{{apiName}}_ClientThreadData",
                                               {#- #} sizeof(_ClientThreadData_t));
+    {%- if args.asyncClient %}
+    {%- for function in functions if function is not EventFunction and
+                                     function is not HasCallbackFunction and
+                                     function|OutBufferParameters|list %}
+
+    // Allocate the pool for the "out" buffers of {{function.name}}_Async() responses
+    _{{function.name}}OutBufferPool = le_mem_CreatePool("{{apiName}}_{{function.name}}Out",
+                                      {#- #} sizeof(_{{function.name}}OutBuffers_t));
+    {%- endfor %}
+    {%- endif %}
 
     // Create the thread-local data key to be used to store a pointer to each thread object.
     LE_ASSERT(pthread_key_create(&_ThreadDataKey, NULL) == 0);
@@ -573,7 +610,7 @@ static void _Handle_{{apiName}}_{{function.name}}
     le_msg_MessageRef_t _msgRef = _reportPtr;
     _Message_t* _msgPtr = le_msg_GetPayloadPtr(_msgRef);
     uint8_t* _msgBufPtr = _msgPtr->buffer;
-    size_t _msgBufSize = _MAX_MSG_SIZE;
+    size_t _msgBufSize = _GetReceivedBufSize(_msgRef);
 
     // The clientContextPtr always exists and is always first. It is a safe reference to the client
     // data object, but we already get the pointer to the client data object through the _dataPtr
@@ -723,6 +760,7 @@ error_unpack:
     {%- else %}
     {{- pack.PackInputs(function.parameters) }}
     {%- endif %}
+    {{- pack.SetPayloadSize() }}
 
     // Send a request to the server and get the response.
     TRACE("Sending message to server and waiting for response : %ti bytes sent",
@@ -739,7 +777,7 @@ error_unpack:
     // Process the result and/or output parameters, if there are any.
     _msgPtr = le_msg_GetPayloadPtr(_responseMsgRef);
     _msgBufPtr = _msgPtr->buffer;
-    _msgBufSize = _MAX_MSG_SIZE;
+    _msgBufSize = _GetReceivedBufSize(_responseMsgRef);
     {%- if function.returnType %}
 
     // Unpack the result first
@@ -788,6 +826,194 @@ error_unpack:
     {%- endif %}
     {%- endwith %}
 }
+{%- if args.asyncClient and function is not EventFunction and function is not HasCallbackFunction %}
+
+
+// This function is called when the response to an asynchronous request arrives.  It parses the
+// response message, and then calls the response handler, which is stored in a client data object.
+static void _HandleAsync_{{apiName}}_{{function.name}}
+(
+    le_msg_MessageRef_t _responseMsgRef,
+    void* _dataPtr
+)
+{
+    {%- with error_unpack_label=Labeler("error_unpack") %}
+    _ClientData_t* _clientDataPtr = _dataPtr;
+    {{apiName}}_{{function.name}}RespFunc_t _respHandlerPtr =
+        ({{apiName}}_{{function.name}}RespFunc_t)_clientDataPtr->handlerPtr;
+    void* contextPtr = _clientDataPtr->contextPtr;
+
+    // The client data is only needed for this one response.
+    le_mem_Release(_clientDataPtr);
+
+    // The response never arrives if the session is closed first.
+    if (_responseMsgRef == NULL)
+    {
+        LE_DEBUG("No response to {{apiName}}_{{function.name}}_Async(); session closed");
+        return;
+    }
+
+    // Will not be used if no data is received from server.
+    __attribute__((unused)) _Message_t* _msgPtr = le_msg_GetPayloadPtr(_responseMsgRef);
+    __attribute__((unused)) uint8_t* _msgBufPtr = _msgPtr->buffer;
+    __attribute__((unused)) size_t _msgBufSize = _GetReceivedBufSize(_responseMsgRef);
+    {%- if function.returnType %}
+
+    // Unpack the result first
+    {{function.returnType|FormatType}} _result;
+    if (!{{function.returnType|UnpackFunction}}( &_msgBufPtr, &_msgBufSize, &_result ))
+    {
+        goto {{error_unpack_label}};
+    }
+    {%- endif %}
+
+    // Storage for the "out" parameters, all of which were requested.  Strings and arrays can be
+    // large, so they are kept in a pool block rather than on the stack.
+    {%- if function|OutBufferParameters|list %}
+    _{{function.name}}OutBuffers_t* _outBuffersPtr =
+        {#- #} le_mem_ForceAlloc(_{{function.name}}OutBufferPool);
+    {%- endif %}
+    {%- for parameter in function.parameters if parameter is OutParameter %}
+    {%- if parameter is StringParameter %}
+    char* {{parameter|FormatParameterName}} = _outBuffersPtr->{{parameter.name}};
+    size_t {{parameter.name}}Size = sizeof(_outBuffersPtr->{{parameter.name}});
+    {%- elif parameter is ArrayParameter %}
+    {{parameter.apiType|FormatType}}* {{parameter|FormatParameterName}} =
+        {#- #} _outBuffersPtr->{{parameter.name}};
+    size_t {{parameter.name}}Size = {{parameter.maxCount}};
+    size_t* {{parameter.name}}SizePtr = &{{parameter.name}}Size;
+    {%- else %}
+    {{parameter.apiType|FormatType}} {{parameter.name|DecorateName}};
+    {{parameter.apiType|FormatType}}* {{parameter|FormatParameterName}} =
+        {#- #} &{{parameter.name|DecorateName}};
+    {%- endif %}
+    {%- endfor %}
+
+    // Unpack any "out" parameters
+    {%- call pack.UnpackOutputs(function.parameters) %}
+        goto {{error_unpack_label}};
+    {%- endcall %}
+
+    // Release the message object, now that all results/output has been copied.
+    le_msg_ReleaseMsg(_responseMsgRef);
+
+    if (_respHandlerPtr != NULL)
+    {
+        _respHandlerPtr(
+            {%- if function.returnType %}_result, {% endif %}
+            {%- for parameter in function|CAPIParameters if parameter is OutParameter %}
+            {{- parameter|FormatParameterName(forceInput=True)}}, {% endfor -%}
+            contextPtr);
+    }
+    {%- if function|OutBufferParameters|list %}
+
+    le_mem_Release(_outBuffersPtr);
+    {%- endif %}
+
+    return;
+    {%- if error_unpack_label.IsUsed() %}
+
+error_unpack:
+    LE_FATAL("Unexpected response from server.");
+    {%- endif %}
+    {%- endwith %}
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Asynchronous variant of {{apiName}}_{{function.name}}().
+ *
+ * Sends the request and returns without waiting for the response, so that many requests can be in
+ * flight on the same session.  The response handler is called from the calling thread's event
+ * loop when the response arrives.  If the session is closed before then, the response handler is
+ * not called.
+ *
+ * This function is created automatically.
+ */
+//--------------------------------------------------------------------------------------------------
+void {{apiName}}_{{function.name}}_Async
+(
+    {%- for parameter in function|AsyncCAPIParameters %}
+    {{parameter|FormatParameter}},
+        ///< [{{parameter.direction|FormatDirection}}]
+             {{-parameter.comments|join("\n///<")|indent(8)}}
+    {%-endfor%}
+    {{apiName}}_{{function.name}}RespFunc_t respHandlerPtr,
+        ///< [IN] Handler called with the response.
+    void* contextPtr
+        ///< [IN] Context pointer passed to the response handler.
+)
+{
+    le_msg_MessageRef_t _msgRef;
+    _Message_t* _msgPtr;
+
+    // Will not be used if no data is sent to server.
+    __attribute__((unused)) uint8_t* _msgBufPtr;
+    __attribute__((unused)) size_t _msgBufSize;
+
+    // Range check values, if appropriate
+    {%- for parameter in function.parameters if parameter is InParameter %}
+    {%- if parameter is StringParameter %}
+    if ( {{parameter|GetParameterCount}} > {{parameter.maxCount}} )
+    {
+        LE_FATAL("{{parameter|GetParameterCount}} > {{parameter.maxCount}}");
+    }
+    {%- elif parameter is ArrayParameter %}
+    if ( (NULL == {{parameter|FormatParameterName}}) &&
+         (0 != {{parameter|GetParameterCount}}) )
+    {
+        LE_FATAL("If {{parameter|FormatParameterName}} is NULL "
+                 "{{parameter|GetParameterCount}} must be zero");
+    }
+    if ( {{parameter|GetParameterCount}} > {{parameter.maxCount}} )
+    {
+        LE_FATAL("{{parameter|GetParameterCount}} > {{parameter.maxCount}}");
+    }
+    {%- endif %}
+    {%- endfor %}
+
+
+    // Create a new message object and get the message buffer
+    _msgRef = le_msg_CreateMsg(GetCurrentSessionRef());
+    _msgPtr = le_msg_GetPayloadPtr(_msgRef);
+    _msgPtr->id = _MSGID_{{apiName}}_{{function.name}};
+    _msgBufPtr = _msgPtr->buffer;
+    _msgBufSize = _MAX_MSG_SIZE;
+
+    // Pack a list of outputs requested by the client.  The response handler gets all of them.
+    {%- if any(function.parameters, "OutParameter") %}
+    uint32_t _requiredOutputs = 0;
+    {%- for output in function.parameters if output is OutParameter %}
+    _requiredOutputs |= (1 << {{loop.index0}});
+    {%- endfor %}
+    LE_ASSERT(le_pack_PackUint32(&_msgBufPtr, &_msgBufSize, _requiredOutputs));
+    {%- endif %}
+
+    // Pack the input parameters, and the maximum size of the "out" strings and arrays
+    {%- for parameter in function.parameters %}
+    {%- if parameter is not InParameter and
+           (parameter is StringParameter or parameter is ArrayParameter) %}
+    LE_ASSERT(le_pack_PackSize( &_msgBufPtr, &_msgBufSize, {{parameter.maxCount}} ));
+    {%- elif parameter is InParameter %}
+    {{- pack.PackInputs([parameter]) }}
+    {%- endif %}
+    {%- endfor %}
+    {{- pack.SetPayloadSize() }}
+
+    // Keep the response handler in a client data object until the response arrives.
+    _ClientData_t* _clientDataPtr = le_mem_ForceAlloc(_ClientDataPool);
+    _clientDataPtr->handlerPtr = (le_event_HandlerFunc_t)respHandlerPtr;
+    _clientDataPtr->contextPtr = contextPtr;
+    _clientDataPtr->handlerRef = NULL;
+    _clientDataPtr->callersThreadRef = le_thread_GetCurrent();
+
+    // Send the request to the server without waiting for the response.
+    TRACE("Sending message to server : %ti bytes sent", _msgBufPtr-_msgPtr->buffer);
+
+    le_msg_RequestResponse(_msgRef, _HandleAsync_{{apiName}}_{{function.name}}, _clientDataPtr);
+}
+{%- endif %}
 {%- endfor %}
 
 
@@ -800,7 +1026,7 @@ static void ClientIndicationRecvHandler
     // Get the message payload
     _Message_t* msgPtr = le_msg_GetPayloadPtr(msgRef);
     uint8_t* _msgBufPtr = msgPtr->buffer;
-    size_t _msgBufSize = _MAX_MSG_SIZE;
+    size_t _msgBufSize = _GetReceivedBufSize(msgRef);
 
     // Have to partially unpack the received message in order to know which thread
     // the queued function should actually go to.
@@ -99,3 +99,52 @@ void {{apiName}}_DisconnectService
     void
 );
 {%- endblock %}
+{% block FunctionDeclaration %}
+{{- super() }}
+{%- if args.asyncClient and function is not EventFunction and function is not HasCallbackFunction %}
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Handler for the response to {{apiName}}_{{function.name}}_Async().
+ *
+ * Receives the result and "out" parameters of {{apiName}}_{{function.name}}().  Strings and arrays
+ * are only valid until the handler returns.
+ */
+//--------------------------------------------------------------------------------------------------
+typedef void (*{{apiName}}_{{function.name}}RespFunc_t)
+(
+    {%- if function.returnType %}
+    {{function.returnType|FormatType}} _result,
+    {%- endif %}
+    {%- for parameter in function|CAPIParameters if parameter is OutParameter %}
+    {{parameter|FormatParameter(forceInput=True)}},
+    {%- endfor %}
+    void* contextPtr
+);
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Asynchronous variant of {{apiName}}_{{function.name}}().
+ *
+ * Sends the request and returns without waiting for the response, so that many requests can be in
+ * flight on the same session.  The response handler is called from the calling thread's event
+ * loop when the response arrives.  If the session is closed before then, the response handler is
+ * not called.
+ *
+ * This function is created automatically.
+ */
+//--------------------------------------------------------------------------------------------------
+void {{apiName}}_{{function.name}}_Async
+(
+    {%- for parameter in function|AsyncCAPIParameters %}
+    {{parameter|FormatParameter}},
+        ///< [{{parameter.direction|FormatDirection}}]
+             {{-parameter.comments|join("\n///<")|indent(8)}}
+    {%-endfor%}
+    {{apiName}}_{{function.name}}RespFunc_t respHandlerPtr,
+        ///< [IN] Handler called with the response.
+    void* contextPtr
+        ///< [IN] Context pointer passed to the response handler.
+);
+{%- endif %}
+{%- endblock %}
@@ -43,6 +43,20 @@ typedef struct __attribute__((packed))
     uint8_t buffer[_MAX_MSG_SIZE];
 }
 _Message_t;
+
+// Get the number of bytes received in a message's buffer, after its ID.  Received messages are
+// only unpacked up to there, so a message that was cut short fails to unpack instead of being
+// unpacked from whatever the rest of the buffer held before.
+static inline size_t _GetReceivedBufSize
+(
+    le_msg_MessageRef_t msgRef
+)
+{
+    size_t payloadSize = le_msg_GetPayloadSize(msgRef);
+
+    return (payloadSize > offsetof(_Message_t, buffer)) ?
+               payloadSize - offsetof(_Message_t, buffer) : 0;
+}
 {% for function in functions %}
 #define _MSGID_{{apiName}}_{{function.name}} {{loop.index0}}
 {%- endfor %}
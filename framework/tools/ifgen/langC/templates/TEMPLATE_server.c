@@ -397,6 +397,7 @@ static void AsyncResponse_{{apiName}}_{{function.name}}
 
     // Pack the input parameters
     {{ pack.PackInputs(handler.apiType.parameters) }}
+    {{- pack.SetPayloadSize() }}
 
     // Send the async response to the client
     TRACE("Sending message to client session %p : %ti bytes sent",
@@ -471,6 +472,7 @@ void {{apiName}}_{{function.name}}Respond
 
     // Pack any "out" parameters
     {{- pack.PackOutputs(function.parameters) }}
+    {{- pack.SetPayloadSize() }}
 
     // Return the response
     TRACE("Sending response to client session %p", le_msg_GetSession(_msgRef));
@@ -495,7 +497,7 @@ static void Handle_{{apiName}}_{{function.name}}
     // Get the message buffer pointer
     __attribute__((unused)) uint8_t* _msgBufPtr =
         ((_Message_t*)le_msg_GetPayloadPtr(_msgRef))->buffer;
-    __attribute__((unused)) size_t _msgBufSize = _MAX_MSG_SIZE;
+    __attribute__((unused)) size_t _msgBufSize = _GetReceivedBufSize(_msgRef);
 
     // Unpack which outputs are needed.
     _serverCmdPtr->requiredOutputs = 0;
@@ -543,7 +545,7 @@ static void Handle_{{apiName}}_{{function.name}}
     // Get the message buffer pointer
     __attribute__((unused)) uint8_t* _msgBufPtr =
         ((_Message_t*)le_msg_GetPayloadPtr(_msgRef))->buffer;
-    __attribute__((unused)) size_t _msgBufSize = _MAX_MSG_SIZE;
+    __attribute__((unused)) size_t _msgBufSize = _GetReceivedBufSize(_msgRef);
 
     // Needed if we are returning a result or output values
     uint8_t* _msgBufStartPtr = _msgBufPtr;
@@ -676,6 +678,7 @@ static void Handle_{{apiName}}_{{function.name}}
 
     // Pack any "out" parameters
     {{- pack.PackOutputs(function.parameters) }}
+    {{- pack.SetPayloadSize() }}
 
     // Return the response
     TRACE("Sending response to client session %p : %ti bytes sent",
@@ -711,6 +714,14 @@ static void ServerMsgRecvHandler
     // the session ref may be different for each message, hence it has to be queried each time.
     _ClientSessionRef = le_msg_GetSession(msgRef);
 
+    // A message too short to hold an ID can't be dispatched.
+    if (le_msg_GetPayloadSize(msgRef) < offsetof(_Message_t, buffer))
+    {
+        LE_KILL_CLIENT("Received a message of %zu bytes", le_msg_GetPayloadSize(msgRef));
+        _ClientSessionRef = 0;
+        return;
+    }
+
     // Dispatch to appropriate message handler and get response
     switch (msgPtr->id)
     {
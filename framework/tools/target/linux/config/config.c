@@ -83,6 +83,11 @@ static bool UseJson = false;
 
 
 
+/// true = do export as a binary snapshot.
+static bool UseSnapshot = false;
+
+
+
 /// If true, delete the original node after a copy, false leave the original alone.
 static bool DeleteAfterCopy = false;
 
@@ -118,9 +123,9 @@ static void PrintHelpAndExit
            "To clear or create a new, empty node:\n"
            "\t%s clear <tree path>\n\n"
            "To import config data:\n"
-           "\t%s import <tree path> <file path> [--format=json]\n\n"
+           "\t%s import <tree path> <file path> [--format=json|binary]\n\n"
            "To export config data:\n"
-           "\t%s export <tree path> <file path> [--format=json]\n\n"
+           "\t%s export <tree path> <file path> [--format=json|binary]\n\n"
            "To list all config trees:\n"
            "\t%s list\n\n"
            "To delete a tree:\n"
@@ -138,6 +143,10 @@ static void PrintHelpAndExit
            "\texpected.  If it is specified for exports, then the data will be generated as well.\n"
            "\tIt is also possible to specify JSON for the get sub-command.\n"
            "\n"
+           "\tIf --format=binary is specified for exports, then the data will be written as a\n"
+           "\tbinary snapshot.  Imports without --format=json accept both the native format and\n"
+           "\tbinary snapshots, so a file can be converted by importing and then exporting it.\n"
+           "\n"
            "\tA tree path is specified similarly to a *nix path.  With the beginning slash\n"
            "\tbeing optional.\n"
            "\n"
@@ -1194,7 +1203,8 @@ static int HandleImport
 
 // -------------------------------------------------------------------------------------------------
 /**
- *  Export data from the config tree, either in JSON or in the configTree's native format.
+ *  Export data from the config tree, either in JSON, in the configTree's native format or as a
+ *  binary snapshot.
  *
  *  @return EXIT_SUCCESS if the command completes properly.  EXIT_FAILURE otherwise.
  */
@@ -1215,7 +1225,16 @@ static int HandleExport
     else
     {
         le_cfg_IteratorRef_t iterRef = le_cfg_CreateReadTxn(NodePath);
-        result = le_cfgAdmin_ExportTree(iterRef, FilePath, "");
+
+        if (UseSnapshot)
+        {
+            result = le_cfgAdmin_ExportTreeSnapshot(iterRef, FilePath, "");
+        }
+        else
+        {
+            result = le_cfgAdmin_ExportTree(iterRef, FilePath, "");
+        }
+
         le_cfg_CancelTxn(iterRef);
     }
 
@@ -1361,6 +1380,12 @@ static void FormatArgHandler
     {
         UseJson = true;
     }
+    else if (   (strcmp(format, "binary") == 0)
+             && (CommandHandler != HandleGet))
+    {
+        // Imports detect snapshots by themselves, so this only changes what exports write.
+        UseSnapshot = true;
+    }
     else
     {
         fprintf(stderr, "Bad format specifier, '%s'.\n", format);
@@ -25,12 +25,13 @@
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Objects of these types are used to refer to lists of memory pools, thread objects, timers,
- * mutexes, semaphores, and service objects. They can be used to iterate over those lists in a
- * remote process.
+ * Objects of these types are used to refer to lists of memory pools, hashmaps, thread objects,
+ * timers, mutexes, semaphores, and service objects. They can be used to iterate over those lists in
+ * a remote process.
  */
 //--------------------------------------------------------------------------------------------------
 typedef struct MemPoolIter*         MemPoolIter_Ref_t;
+typedef struct HashmapIter*         HashmapIter_Ref_t;
 typedef struct ThreadObjIter*       ThreadObjIter_Ref_t;
 typedef struct TimerIter*           TimerIter_Ref_t;
 typedef struct MutexIter*           MutexIter_Ref_t;
@@ -50,6 +51,7 @@ typedef struct InterfaceObjIter*    InterfaceObjIter_Ref_t;
 typedef enum
 {
     INSPECT_INSP_TYPE_MEM_POOL,
+    INSPECT_INSP_TYPE_HASHMAP,
     INSPECT_INSP_TYPE_THREAD_OBJ,
     INSPECT_INSP_TYPE_TIMER,
     INSPECT_INSP_TYPE_MUTEX,
@@ -85,6 +87,8 @@ typedef struct
 {
     le_dls_List_t* bucketsPtr;  ///< Array of buckets in the hashmap in the remote process.
     size_t bucketCount;         ///< Size of the array of buckets.
+    le_dls_List_t* oldBucketsPtr; ///< Buckets not yet moved, if the hashmap is being resized.
+    size_t oldBucketCount;      ///< Size of the array of old buckets.
     size_t* mapChgCntRef;       ///< Change counter for the remote map.
 }
 RemoteHashmapAccess_t;
@@ -92,8 +96,8 @@ RemoteHashmapAccess_t;
 
 //--------------------------------------------------------------------------------------------------
 /**
- * Iterator objects for stepping through the list of memory pools, thread objects, timers, mutexes,
- * and semaphores in a remote process.
+ * Iterator objects for stepping through the list of memory pools, hashmaps, thread objects,
+ * timers, mutexes, and semaphores in a remote process.
  */
 //--------------------------------------------------------------------------------------------------
 typedef struct MemPoolIter
@@ -103,6 +107,13 @@ typedef struct MemPoolIter
 }
 MemPoolIter_t;
 
+typedef struct HashmapIter
+{
+    RemoteListAccess_t hashmapList; ///< Hashmap list in the remote process.
+    Hashmap_t currHashmap;          ///< Current hashmap from the list.
+}
+HashmapIter_t;
+
 typedef struct ThreadObjIter
 {
     RemoteListAccess_t threadObjList; ///< Thread object list in the remote process.
@@ -479,6 +490,49 @@ static MemPoolIter_Ref_t CreateMemPoolIter
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Creates an iterator that can be used to iterate over the list of hashmaps for a specific
+ * process. See the comment block for CreateMemPoolIter for additional detail.
+ *
+ * @return
+ *      An iterator to the list of hashmaps for the specified process.
+ */
+//--------------------------------------------------------------------------------------------------
+static HashmapIter_Ref_t CreateHashmapIter
+(
+    void
+)
+{
+    // Get the address offset of the hashmap list for the process to inspect.
+    off_t listAddrOffset = GetRemoteAddress(PidToInspect, hashmap_GetMapList());
+
+    // Get the address offset of the hashmap list change counter for the process to inspect.
+    off_t listChgCntAddrOffset = GetRemoteAddress(PidToInspect, hashmap_GetMapListChgCntRef());
+
+    // Create the iterator.
+    HashmapIter_t* iteratorPtr = le_mem_ForceAlloc(IteratorPool);
+    InitRemoteListAccessObj(&iteratorPtr->hashmapList);
+
+    // Get the List for the process-under-inspection.
+    if (fd_ReadFromOffset(FdProcMem, listAddrOffset, &(iteratorPtr->hashmapList.List),
+                             sizeof(iteratorPtr->hashmapList.List)) != LE_OK)
+    {
+        INTERNAL_ERR(REMOTE_READ_ERR("hashmap list"));
+    }
+
+    // Get the ListChgCntRef for the process-under-inspection.
+    if (fd_ReadFromOffset(FdProcMem, listChgCntAddrOffset,
+                          &(iteratorPtr->hashmapList.ListChgCntRef),
+                          sizeof(iteratorPtr->hashmapList.ListChgCntRef)) != LE_OK)
+    {
+        INTERNAL_ERR(REMOTE_READ_ERR("hashmap list change counter ref"));
+    }
+
+    return iteratorPtr;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Creates an iterator that can be used to iterate over the list of thread objects for a specific
@@ -711,6 +765,12 @@ static InterfaceObjIter_Ref_t CreateInterfaceObjIter
     iteratorPtr->interfaceObjMap.bucketsPtr = map.bucketsPtr;
     iteratorPtr->interfaceObjMap.bucketCount = map.bucketCount;
 
+    // Entries that have not been moved yet are still in the old buckets if the map is being
+    // resized.  The old buckets are walked after the current ones; those that have already been
+    // moved are empty.
+    iteratorPtr->interfaceObjMap.oldBucketsPtr = map.oldBucketsPtr;
+    iteratorPtr->interfaceObjMap.oldBucketCount = map.oldBucketCount;
+
     // Get the mapChgCntRef for the process-under-inspection.
     if (fd_ReadFromOffset(FdProcMem, mapChgCntAddrOffset,
                           &(iteratorPtr->interfaceObjMap.mapChgCntRef),
@@ -837,6 +897,30 @@ static size_t GetMemPoolListChgCnt
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the hashmap list change counter from the specified iterator.
+ *
+ * @return
+ *      List change counter.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetHashmapListChgCnt
+(
+    HashmapIter_Ref_t iterator ///< [IN] The iterator to get the list change counter from.
+)
+{
+    size_t hashmapListChgCnt;
+    if (fd_ReadFromOffset(FdProcMem, (ssize_t)(iterator->hashmapList.ListChgCntRef),
+                          &hashmapListChgCnt, sizeof(hashmapListChgCnt)) != LE_OK)
+    {
+        INTERNAL_ERR(REMOTE_READ_ERR("hashmap list change counter"));
+    }
+
+    return hashmapListChgCnt;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets the thread object list change counter from the specified iterator.
@@ -1054,6 +1138,41 @@ static MemPool_t* GetNextMemPool
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Gets the next hashmap from the specified iterator. For other detail see GetNextMemPool.
+ *
+ * @return
+ *      A hashmap from the iterator's list of hashmaps.
+ */
+//--------------------------------------------------------------------------------------------------
+static Hashmap_t* GetNextHashmap
+(
+    HashmapIter_Ref_t hashmapIterRef ///< [IN] The iterator to get the next hashmap from.
+)
+{
+    le_dls_Link_t* linkPtr = GetNextLink(&(hashmapIterRef->hashmapList),
+                                         &(hashmapIterRef->currHashmap.mapLink));
+
+    if (linkPtr == NULL)
+    {
+        return NULL;
+    }
+
+    // Get the address of the map.
+    Hashmap_t* mapPtr = CONTAINER_OF(linkPtr, Hashmap_t, mapLink);
+
+    // Read the map into our own memory.
+    if (fd_ReadFromOffset(FdProcMem, (ssize_t)mapPtr, &(hashmapIterRef->currHashmap),
+                          sizeof(hashmapIterRef->currHashmap)) != LE_OK)
+    {
+        INTERNAL_ERR(REMOTE_READ_ERR("hashmap object"));
+    }
+
+    return &(hashmapIterRef->currHashmap);
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Gets the next thread object from the specified iterator. For other detail see GetNextMemPool.
@@ -1366,8 +1485,10 @@ static void* GetNextInterfaceObjPtr
     // Get the link from the updated list.
     while (remEntryNextLinkPtr == NULL)
     {
-        // Increment the bucket index. Return null if we run out of buckets.
-        if (iterator->currIndex < (iterator->interfaceObjMap.bucketCount - 1))
+        // Increment the bucket index. Return null if we run out of buckets.  Indices past the end
+        // of the current buckets refer to the old buckets of a map being resized.
+        RemoteHashmapAccess_t* mapPtr = &(iterator->interfaceObjMap);
+        if (iterator->currIndex < (mapPtr->bucketCount + mapPtr->oldBucketCount - 1))
         {
             iterator->currIndex++;
         }
@@ -1376,9 +1497,19 @@ static void* GetNextInterfaceObjPtr
             return NULL;
         }
 
+        le_dls_List_t* bucketPtr;
+        if (iterator->currIndex < mapPtr->bucketCount)
+        {
+            bucketPtr = mapPtr->bucketsPtr + iterator->currIndex;
+        }
+        else
+        {
+            bucketPtr = mapPtr->oldBucketsPtr + (iterator->currIndex - mapPtr->bucketCount);
+        }
+
         // So we haven't run out of buckets yet. Then update our interface object list.
         if (fd_ReadFromOffset(FdProcMem,
-                              (ssize_t)(iterator->interfaceObjMap.bucketsPtr + iterator->currIndex),
+                              (ssize_t)bucketPtr,
                               &(iterator->interfaceObjList.List),
                               sizeof(iterator->interfaceObjList.List)) != LE_OK)
         {
@@ -1555,11 +1686,13 @@ static void PrintHelp
         "              Legato process.\n"
         "\n"
         "SYNOPSIS:\n"
-        "    inspect <pools|threads|timers|mutexes|semaphores> [OPTIONS] PID\n"
+        "    inspect <pools|hashmaps|threads|timers|mutexes|semaphores> [OPTIONS] PID\n"
         "    inspect ipc <servers|clients [sessions]> [OPTIONS] PID\n"
         "\n"
         "DESCRIPTION:\n"
         "    inspect pools              Prints the memory pools usage for the specified process.\n"
+        "    inspect hashmaps           Prints the load statistics of hashmaps for the specified"
+                                        " process.\n"
         "    inspect threads            Prints the info of threads for the specified process.\n"
         "    inspect timers             Prints the info of timers in all threads for the"
                                         " specified process.\n"
@@ -1663,6 +1796,19 @@ static ColumnInfo_t MemPoolTableInfo[] =
 };
 static size_t MemPoolTableInfoSize = NUM_ARRAY_MEMBERS(MemPoolTableInfo);
 
+static ColumnInfo_t HashmapTableInfo[] =
+{
+    {"ENTRIES",     "%*s",  NULL, "%*zu", sizeof(size_t), false, 0, true},
+    {"BUCKETS",     "%*s",  NULL, "%*zu", sizeof(size_t), false, 0, true},
+    {"LOAD FACTOR", "%*s",  NULL, "%*f",  sizeof(double), false, 0, true},
+    {"MAX CHAIN",   "%*s",  NULL, "%*zu", sizeof(size_t), false, 0, true},
+    {"RESIZES",     "%*s",  NULL, "%*zu", sizeof(size_t), false, 0, true},
+    {"REHASHING",   "%*s",  NULL, "%*u",  sizeof(bool),   false, 0, true},
+    {"COMPACT",     "%*s",  NULL, "%*u",  sizeof(bool),   false, 0, false},
+    {"HASHMAP",     "%-*s", NULL, "%-*s", LIMIT_MAX_MEM_POOL_NAME_LEN, true, 0, true}
+};
+static size_t HashmapTableInfoSize = NUM_ARRAY_MEMBERS(HashmapTableInfo);
+
 static ColumnInfo_t ThreadObjTableInfo[] =
 {
     {"NAME",             "%*s", NULL, "%*s",  MAX_THREAD_NAME_SIZE, true,  0, true},
@@ -1675,7 +1821,12 @@ static ColumnInfo_t ThreadObjTableInfo[] =
     {"CONTENTION SCOPE", "%*s", NULL, "%*s",  0,                    true,  0, true},
     {"GUARD SIZE",       "%*s", NULL, "%*zu", sizeof(size_t),       false, 0, true},
     {"STACK ADDR",       "%*s", NULL, "%*X",  sizeof(uint64_t),     false, 0, true},
-    {"STACK SIZE",       "%*s", NULL, "%*zu", sizeof(size_t),       false, 0, true}
+    {"STACK SIZE",       "%*s", NULL, "%*zu", sizeof(size_t),       false, 0, true},
+    {"EVENT BUDGET",     "%*s", NULL, "%*zu", sizeof(size_t),       false, 0, false},
+    {"WAKEUPS",          "%*s", NULL, "%*"PRIu64"", sizeof(uint64_t), false, 0, false},
+    {"REPORTS",          "%*s", NULL, "%*"PRIu64"", sizeof(uint64_t), false, 0, false},
+    {"MAX REPORTS",      "%*s", NULL, "%*zu", sizeof(size_t),       false, 0, false},
+    {"BUDGET HITS",      "%*s", NULL, "%*"PRIu64"", sizeof(uint64_t), false, 0, false}
 };
 static size_t ThreadObjTableInfoSize = NUM_ARRAY_MEMBERS(ThreadObjTableInfo);
 
@@ -1727,10 +1878,12 @@ static size_t ClientObjTableInfoSize = NUM_ARRAY_MEMBERS(ClientObjTableInfo);
 
 static ColumnInfo_t SessionObjTableInfo[] =
 {
-    {"INTERFACE NAME", "%*s", NULL, "%*s", LIMIT_MAX_IPC_INTERFACE_NAME_BYTES, true,  0, true},
-    {"STATE",          "%*s", NULL, "%*s", 0,                                  true,  0, true},
-    {"THREAD NAME",    "%*s", NULL, "%*s", MAX_THREAD_NAME_SIZE,               true,  0, true},
-    {"FD",             "%*s", NULL, "%*d", sizeof(int),                        false, 0, false}
+    {"INTERFACE NAME", "%*s", NULL, "%*s",   LIMIT_MAX_IPC_INTERFACE_NAME_BYTES, true,  0, true},
+    {"STATE",          "%*s", NULL, "%*s",   0,                                  true,  0, true},
+    {"THREAD NAME",    "%*s", NULL, "%*s",   MAX_THREAD_NAME_SIZE,               true,  0, true},
+    {"FD",             "%*s", NULL, "%*d",   sizeof(int),                        false, 0, false},
+    {"TX MSGS/CALL",   "%*s", NULL, "%*.2f", sizeof(float),                      false, 0, false},
+    {"RX MSGS/CALL",   "%*s", NULL, "%*.2f", sizeof(float),                      false, 0, false}
 };
 static size_t SessionObjTableInfoSize = NUM_ARRAY_MEMBERS(SessionObjTableInfo);
 
@@ -2038,6 +2191,10 @@ static void InitDisplay
             InitDisplayTable(MemPoolTableInfo, MemPoolTableInfoSize);
             break;
 
+        case INSPECT_INSP_TYPE_HASHMAP:
+            InitDisplayTable(HashmapTableInfo, HashmapTableInfoSize);
+            break;
+
         case INSPECT_INSP_TYPE_THREAD_OBJ:
             InitDisplayTable(ThreadObjTableInfo, ThreadObjTableInfoSize);
             break;
@@ -2225,6 +2382,12 @@ static int PrintInspectHeader
             tableSize = MemPoolTableInfoSize;
             break;
 
+        case INSPECT_INSP_TYPE_HASHMAP:
+            strncpy(inspectTypeString, "Hashmaps", inspectTypeStringSize);
+            table = HashmapTableInfo;
+            tableSize = HashmapTableInfoSize;
+            break;
+
         case INSPECT_INSP_TYPE_THREAD_OBJ:
             strncpy(inspectTypeString, "Thread Objects", inspectTypeStringSize);
             table = ThreadObjTableInfo;
@@ -2810,6 +2973,229 @@ static int PrintMemPoolInfo
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Number of array elements read at a time from the remote process when scanning the buckets of a
+ * hashmap.
+ */
+//--------------------------------------------------------------------------------------------------
+#define HASHMAP_SCAN_CHUNK  256
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds the longest chain in an array of chain lengths in the remote process.
+ *
+ * @return
+ *      The length of the longest chain.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetMaxChainLength
+(
+    size_t* remChainLengthPtr,  ///< [IN] Array of chain lengths in the remote process.
+    size_t count                ///< [IN] Number of elements in the array.
+)
+{
+    size_t chainLengths[HASHMAP_SCAN_CHUNK];
+    size_t maxLength = 0;
+    size_t i, j;
+
+    for (i = 0; i < count; i += HASHMAP_SCAN_CHUNK)
+    {
+        size_t chunkSize = ((count - i) < HASHMAP_SCAN_CHUNK) ? (count - i) : HASHMAP_SCAN_CHUNK;
+
+        if (fd_ReadFromOffset(FdProcMem, (ssize_t)(remChainLengthPtr + i),
+                              chainLengths, chunkSize * sizeof(size_t)) != LE_OK)
+        {
+            INTERNAL_ERR(REMOTE_READ_ERR("hashmap chain lengths"));
+        }
+
+        for (j = 0; j < chunkSize; j++)
+        {
+            if (chainLengths[j] > maxLength)
+            {
+                maxLength = chainLengths[j];
+            }
+        }
+    }
+
+    return maxLength;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Finds the longest probe sequence in the index of a compact hashmap in the remote process.
+ *
+ * @return
+ *      The number of slots examined by the longest lookup of a stored key.
+ */
+//--------------------------------------------------------------------------------------------------
+static size_t GetMaxProbeLength
+(
+    Hashmap_t* mapPtr   ///< [IN] Local copy of the remote hashmap.
+)
+{
+    CompactSlot_t slots[HASHMAP_SCAN_CHUNK];
+    size_t maxLength = 0;
+    size_t i, j;
+
+    for (i = 0; i < mapPtr->bucketCount; i += HASHMAP_SCAN_CHUNK)
+    {
+        size_t chunkSize = ((mapPtr->bucketCount - i) < HASHMAP_SCAN_CHUNK) ?
+                           (mapPtr->bucketCount - i) : HASHMAP_SCAN_CHUNK;
+
+        if (fd_ReadFromOffset(FdProcMem, (ssize_t)(mapPtr->slotsPtr + i),
+                              slots, chunkSize * sizeof(CompactSlot_t)) != LE_OK)
+        {
+            INTERNAL_ERR(REMOTE_READ_ERR("hashmap slots"));
+        }
+
+        for (j = 0; j < chunkSize; j++)
+        {
+            // The probe length is the distance of the slot from the entry's home slot, plus one.
+            size_t length = ((i + j - slots[j].hashTag) & (mapPtr->bucketCount - 1)) + 1;
+
+            if ((slots[j].entryNum != 0) && (length > maxLength))
+            {
+                maxLength = length;
+            }
+        }
+    }
+
+    return maxLength;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Reads the name of a hashmap from the remote process.  The name is read one byte at a time, as
+ * it may be located at the very end of a mapping.
+ */
+//--------------------------------------------------------------------------------------------------
+static void GetHashmapName
+(
+    Hashmap_t* mapPtr,  ///< [IN] Local copy of the remote hashmap.
+    char* namePtr,      ///< [OUT] Buffer to store the name in.
+    size_t nameSize     ///< [IN] Size of the buffer.
+)
+{
+    size_t i;
+
+    for (i = 0; i < (nameSize - 1); i++)
+    {
+        if (fd_ReadFromOffset(FdProcMem, (ssize_t)(mapPtr->nameStr + i),
+                              &namePtr[i], 1) != LE_OK)
+        {
+            INTERNAL_ERR(REMOTE_READ_ERR("hashmap name"));
+        }
+
+        if (namePtr[i] == '\0')
+        {
+            return;
+        }
+    }
+
+    namePtr[i] = '\0';
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Print hashmap information to stdout.
+ */
+//--------------------------------------------------------------------------------------------------
+static int PrintHashmapInfo
+(
+    Hashmap_t* mapPtr   ///< [IN] Local copy of the remote hashmap to be printed.
+)
+{
+    int lineCount = 0;
+
+    bool isCompact = (mapPtr->slotsPtr != NULL);
+    bool isRehashing = (mapPtr->oldBucketsPtr != NULL);
+
+    // Entries that have not been moved yet count against the old buckets, so the load factor is
+    // that of the new buckets only once the resize is over.
+    double loadFactor = (double)mapPtr->size / mapPtr->bucketCount;
+
+    size_t maxChain;
+    if (isCompact)
+    {
+        maxChain = GetMaxProbeLength(mapPtr);
+    }
+    else
+    {
+        maxChain = GetMaxChainLength(mapPtr->chainLengthPtr, mapPtr->bucketCount);
+
+        if (isRehashing)
+        {
+            size_t oldMaxChain = GetMaxChainLength(mapPtr->oldChainLengthPtr + mapPtr->migrateIndex,
+                                                   mapPtr->oldBucketCount - mapPtr->migrateIndex);
+            maxChain = (oldMaxChain > maxChain) ? oldMaxChain : maxChain;
+        }
+    }
+
+    char name[LIMIT_MAX_MEM_POOL_NAME_BYTES];
+    GetHashmapName(mapPtr, name, sizeof(name));
+
+    // Output hashmap info
+    int index = 0;
+
+    if (!IsOutputJson)
+    {
+        FillSizeTColField (mapPtr->size,        HashmapTableInfo, HashmapTableInfoSize, &index);
+        FillSizeTColField (mapPtr->bucketCount, HashmapTableInfo, HashmapTableInfoSize, &index);
+        FillDoubleColField(loadFactor,          HashmapTableInfo, HashmapTableInfoSize, &index);
+        FillSizeTColField (maxChain,            HashmapTableInfo, HashmapTableInfoSize, &index);
+        FillSizeTColField (mapPtr->resizeCount, HashmapTableInfo, HashmapTableInfoSize, &index);
+        FillBoolColField  (isRehashing,         HashmapTableInfo, HashmapTableInfoSize, &index);
+        FillBoolColField  (isCompact,           HashmapTableInfo, HashmapTableInfoSize, &index);
+        FillStrColField   (name,                HashmapTableInfo, HashmapTableInfoSize, &index);
+
+        PrintInfo(HashmapTableInfo, HashmapTableInfoSize);
+        lineCount++;
+    }
+    else
+    {
+        // If it's not the first time, print a comma.
+        if (!IsPrintedNodeFirst)
+        {
+            printf(",");
+        }
+        else
+        {
+            IsPrintedNodeFirst = false;
+        }
+
+        bool printed = false;
+
+        printf("[");
+
+        ExportSizeTToJson (mapPtr->size,        HashmapTableInfo, HashmapTableInfoSize, &index,
+                                                &printed);
+        ExportSizeTToJson (mapPtr->bucketCount, HashmapTableInfo, HashmapTableInfoSize, &index,
+                                                &printed);
+        ExportDoubleToJson(loadFactor,          HashmapTableInfo, HashmapTableInfoSize, &index,
+                                                &printed);
+        ExportSizeTToJson (maxChain,            HashmapTableInfo, HashmapTableInfoSize, &index,
+                                                &printed);
+        ExportSizeTToJson (mapPtr->resizeCount, HashmapTableInfo, HashmapTableInfoSize, &index,
+                                                &printed);
+        ExportBoolToJson  (isRehashing,         HashmapTableInfo, HashmapTableInfoSize, &index,
+                                                &printed);
+        ExportBoolToJson  (isCompact,           HashmapTableInfo, HashmapTableInfoSize, &index,
+                                                &printed);
+        ExportStrToJson   (name,                HashmapTableInfo, HashmapTableInfoSize, &index,
+                                                &printed);
+
+        printf("]");
+    }
+
+    return lineCount;
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Print thread obj information to stdout.
@@ -2899,6 +3285,16 @@ static int PrintThreadObjInfo
                                                                     ThreadObjTableInfoSize, &index);
         FillSizeTColField (stackSize,                               ThreadObjTableInfo,
                                                                     ThreadObjTableInfoSize, &index);
+        FillSizeTColField (threadObjRef->eventRec.reportBudget,     ThreadObjTableInfo,
+                                                                    ThreadObjTableInfoSize, &index);
+        FillUint64ColField(threadObjRef->eventRec.wakeupCount,      ThreadObjTableInfo,
+                                                                    ThreadObjTableInfoSize, &index);
+        FillUint64ColField(threadObjRef->eventRec.reportCount,      ThreadObjTableInfo,
+                                                                    ThreadObjTableInfoSize, &index);
+        FillSizeTColField (threadObjRef->eventRec.maxReportsPerWakeup, ThreadObjTableInfo,
+                                                                    ThreadObjTableInfoSize, &index);
+        FillUint64ColField(threadObjRef->eventRec.budgetHitCount,   ThreadObjTableInfo,
+                                                                    ThreadObjTableInfoSize, &index);
 
         PrintInfo(ThreadObjTableInfo, ThreadObjTableInfoSize);
         lineCount++;
@@ -2941,6 +3337,16 @@ static int PrintThreadObjInfo
                                                           ThreadObjTableInfoSize, &index, &printed);
         ExportSizeTToJson (stackSize,                     ThreadObjTableInfo,
                                                           ThreadObjTableInfoSize, &index, &printed);
+        ExportSizeTToJson (threadObjRef->eventRec.reportBudget, ThreadObjTableInfo,
+                                                          ThreadObjTableInfoSize, &index, &printed);
+        ExportUint64ToJson(threadObjRef->eventRec.wakeupCount, ThreadObjTableInfo,
+                                                          ThreadObjTableInfoSize, &index, &printed);
+        ExportUint64ToJson(threadObjRef->eventRec.reportCount, ThreadObjTableInfo,
+                                                          ThreadObjTableInfoSize, &index, &printed);
+        ExportSizeTToJson (threadObjRef->eventRec.maxReportsPerWakeup, ThreadObjTableInfo,
+                                                          ThreadObjTableInfoSize, &index, &printed);
+        ExportUint64ToJson(threadObjRef->eventRec.budgetHitCount, ThreadObjTableInfo,
+                                                          ThreadObjTableInfoSize, &index, &printed);
 
         printf("]");
     }
@@ -3611,6 +4017,12 @@ static int PrintSessionObjInfo
     char threadName[MAX_THREAD_NAME_SIZE] = {0};
     LookupThreadName((size_t)sessionObjRef->threadRef, threadName, MAX_THREAD_NAME_SIZE);
 
+    // Average number of messages moved by each socket system call.
+    double txMsgsPerCall = (sessionObjRef->txCallCount == 0) ? 0 :
+                           (double)sessionObjRef->txMsgCount / sessionObjRef->txCallCount;
+    double rxMsgsPerCall = (sessionObjRef->rxCallCount == 0) ? 0 :
+                           (double)sessionObjRef->rxMsgCount / sessionObjRef->rxCallCount;
+
     // Output session object info
     int index = 0;
 
@@ -3624,6 +4036,10 @@ static int PrintSessionObjInfo
                                                  SessionObjTableInfoSize, &index);
         FillIntColField(sessionObjRef->socketFd, SessionObjTableInfo,
                                                  SessionObjTableInfoSize, &index);
+        FillDoubleColField(txMsgsPerCall,        SessionObjTableInfo,
+                                                 SessionObjTableInfoSize, &index);
+        FillDoubleColField(rxMsgsPerCall,        SessionObjTableInfo,
+                                                 SessionObjTableInfoSize, &index);
 
         PrintInfo(SessionObjTableInfo, SessionObjTableInfoSize);
         lineCount++;
@@ -3652,6 +4068,10 @@ static int PrintSessionObjInfo
                                                  SessionObjTableInfoSize, &index, &printed);
         ExportIntToJson(sessionObjRef->socketFd, SessionObjTableInfo,
                                                  SessionObjTableInfoSize, &index, &printed);
+        ExportDoubleToJson(txMsgsPerCall,        SessionObjTableInfo,
+                                                 SessionObjTableInfoSize, &index, &printed);
+        ExportDoubleToJson(rxMsgsPerCall,        SessionObjTableInfo,
+                                                 SessionObjTableInfoSize, &index, &printed);
 
         printf("]");
     }
@@ -3791,6 +4211,13 @@ static void InspectFunc
             printNodeInfoFunc = (PrintNodeInfoFunc_t) PrintMemPoolInfo;
             break;
 
+        case INSPECT_INSP_TYPE_HASHMAP:
+            createIterFunc    = (CreateIterFunc_t)    CreateHashmapIter;
+            getListChgCntFunc = (GetListChgCntFunc_t) GetHashmapListChgCnt;
+            getNextNodeFunc   = (GetNextNodeFunc_t)   GetNextHashmap;
+            printNodeInfoFunc = (PrintNodeInfoFunc_t) PrintHashmapInfo;
+            break;
+
         case INSPECT_INSP_TYPE_THREAD_OBJ:
             createIterFunc    = (CreateIterFunc_t)    CreateThreadObjIter;
             getListChgCntFunc = (GetListChgCntFunc_t) GetThreadObjListChgCnt;
@@ -4022,6 +4449,10 @@ static void CommandArgHandler
     {
         InspectType = INSPECT_INSP_TYPE_MEM_POOL;
     }
+    else if (strcmp(command, "hashmaps") == 0)
+    {
+        InspectType = INSPECT_INSP_TYPE_HASHMAP;
+    }
     else if (strcmp(command, "threads") == 0)
     {
         InspectType = INSPECT_INSP_TYPE_THREAD_OBJ;
@@ -4121,6 +4552,10 @@ static void InitIteratorPool
             size = sizeof(MemPoolIter_t);
             break;
 
+        case INSPECT_INSP_TYPE_HASHMAP:
+            size = sizeof(HashmapIter_t);
+            break;
+
         case INSPECT_INSP_TYPE_THREAD_OBJ:
             size = sizeof(ThreadObjIter_t);
             break;
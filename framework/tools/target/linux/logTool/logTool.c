@@ -26,6 +26,11 @@ $ log trace keyword processName/componentName
  * To disable a trace:
  * @verbatim
 $ log stoptrace keyword processName/componentName
+@endverbatim
+ *
+ * To make a process write its log messages from a background thread:
+ * @verbatim
+$ log flush ASYNC processName
 @endverbatim
  *
  *
@@ -77,7 +82,7 @@ static char Command;
 //--------------------------------------------------------------------------------------------------
 /**
  * Pointer to the "command parameter" string.  If used, this is a log level, trace keyword,
- * or process identifier.
+ * flush policy or process identifier.
  **/
 //--------------------------------------------------------------------------------------------------
 static const char* CommandParamPtr = NULL;
@@ -91,6 +96,14 @@ static const char* CommandParamPtr = NULL;
 static const char* SessionIdPtr = DEFAULT_SESSION_ID;
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Pointer to the process identifier (process name or PID) of a "flush" command.
+ **/
+//--------------------------------------------------------------------------------------------------
+static const char* FlushProcessIdPtr = "*";
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * True if an error response was received from the Log Control Daemon.
@@ -118,6 +131,7 @@ static void PrintHelpAndExit
         "    log level FILTER_STR [DESTINATION]\n"
         "    log trace KEYWORD_STR [DESTINATION]\n"
         "    log stoptrace KEYWORD_STR [DESTINATION]\n"
+        "    log flush POLICY_STR [PROCESS]\n"
         "    log forget PROCESS_NAME\n"
         "\n"
         "DESCRIPTION:\n"
@@ -142,6 +156,19 @@ static void PrintHelpAndExit
         "                        keyword is not logged.  The KEYWORD_STR is a trace\n"
         "                        keyword.\n"
         "\n"
+        "    log flush           Sets how a process writes its log messages.\n"
+        "                        The POLICY_STR must be one of the following:\n"
+        "                            SYNC   Messages are written by the thread\n"
+        "                                   that logs them (default).\n"
+        "                            ASYNC  Messages are buffered and written\n"
+        "                                   by a background thread.  Messages\n"
+        "                                   are dropped if the buffer is full.\n"
+        "                            DEFERRED  Like ASYNC, but messages are\n"
+        "                                   formatted by the background thread\n"
+        "                                   too.\n"
+        "                        The [PROCESS] is a process name or a PID, or '*'\n"
+        "                        for all processes (default).\n"
+        "\n"
         "    log forget          Forgets all settings for processes with a given name.\n"
         "                        Future processes with that name will have default\n"
         "                        settings.\n"
@@ -464,6 +491,61 @@ static void TraceKeywordArgHandler
 }
 
 
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function that gets called by le_arg_Scan() when the optional process identifier argument (either
+ * a process name or a PID) for a "flush" command is found on the command line.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void FlushProcessIdArgHandler
+(
+    const char* processId
+)
+{
+    // Flush policies apply to whole processes.
+    if (strchr(processId, '/') != NULL)
+    {
+        ExitWithErrorMsg("Invalid process.");
+    }
+
+    FlushProcessIdPtr = processId;
+}
+
+
+//--------------------------------------------------------------------------------------------------
+/**
+ * Function that gets called by le_arg_Scan() when a flush policy argument is seen on the command
+ * line.
+ **/
+//--------------------------------------------------------------------------------------------------
+static void FlushPolicyArgHandler
+(
+    const char* policy
+)
+{
+    if (strcasecmp(policy, LOG_FLUSH_POLICY_SYNC_STR) == 0)
+    {
+        CommandParamPtr = LOG_FLUSH_POLICY_SYNC_STR;
+    }
+    else if (strcasecmp(policy, LOG_FLUSH_POLICY_ASYNC_STR) == 0)
+    {
+        CommandParamPtr = LOG_FLUSH_POLICY_ASYNC_STR;
+    }
+    else if (strcasecmp(policy, LOG_FLUSH_POLICY_DEFERRED_STR) == 0)
+    {
+        CommandParamPtr = LOG_FLUSH_POLICY_DEFERRED_STR;
+    }
+    else
+    {
+        ExitWithErrorMsg("Invalid flush policy.");
+    }
+
+    // Wait for an optional process identifier next.
+    le_arg_AddPositionalCallback(FlushProcessIdArgHandler);
+    le_arg_AllowLessPositionalArgsThanCallbacks();
+}
+
+
 //--------------------------------------------------------------------------------------------------
 /**
  * Function that gets called by le_arg_Scan() when the process identifier argument (either a process
@@ -516,6 +598,13 @@ static void CommandArgHandler
         // Expect a trace keyword next.
         le_arg_AddPositionalCallback(TraceKeywordArgHandler);
     }
+    else if (strcmp(command, "flush") == 0)
+    {
+        Command = LOG_CMD_SET_FLUSH_POLICY;
+
+        // Expect a flush policy next.
+        le_arg_AddPositionalCallback(FlushPolicyArgHandler);
+    }
     else if (strcmp(command, "list") == 0)
     {
         Command = LOG_CMD_LIST_COMPONENTS;
@@ -573,6 +662,15 @@ COMPONENT_INIT
 
             break;
 
+        case LOG_CMD_SET_FLUSH_POLICY:
+
+            // Flush policies apply to all the components of a process.
+            AppendToCommand(msgRef, FlushProcessIdPtr);
+            AppendToCommand(msgRef, "/*/");
+            AppendToCommand(msgRef, CommandParamPtr);
+
+            break;
+
         case LOG_CMD_LIST_COMPONENTS:
 
             // This one has no arguments.